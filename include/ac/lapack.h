@@ -176,6 +176,19 @@ __FC_DECL__(dgemm)(const char *const TRANSA,
                    const doublereal *const BETA,
                    doublereal *const C,
                    const integer *const LDC);
+
+/* Subroutine */ extern int
+__FC_DECL__(dgemv)(const char *const TRANS,
+                   const integer *const M,
+                   const integer *const N,
+                   const doublereal *const ALPHA,
+                   const doublereal *const A,
+                   const integer *const LDA,
+                   const doublereal *const X,
+                   const integer *const INCX,
+                   const doublereal *const BETA,
+                   doublereal *const Y,
+                   const integer *const INCY);
 #endif /* !HAVE_CBLAS */
 #endif /* HAVE_BLAS */
 
@@ -233,6 +246,31 @@ __FC_DECL__(dggevx)(
 	logical *BWORK,
 	integer *INFO);
 
+/*
+NAME
+       ZGEEV - computes for an N-by-N complex nonsymmetric matrix A,
+       the eigenvalues and, optionally, the left and/or right eigenvectors
+
+SYNOPSIS
+       SUBROUTINE ZGEEV(JOBVL,JOBVR,N,A,LDA,W,VL,LDVL,VR,LDVR,WORK,LWORK,RWORK,INFO)
+*/
+/* Subroutine */ extern int
+__FC_DECL__(zgeev)(
+	const char *JOBVL,
+	const char *JOBVR,
+	const integer *N,
+	doublecomplex *A,
+	const integer *LDA,
+	doublecomplex *W,
+	doublecomplex *VL,
+	const integer *LDVL,
+	doublecomplex *VR,
+	const integer *LDVR,
+	doublecomplex *WORK,
+	const integer *LWORK,
+	doublereal *RWORK,
+	integer *INFO);
+
 /* NOTE: according to lapack's documentation, dgegv() is deprecated
  * in favour of dggev()... */
 /* Subroutine */ extern int
@@ -61,6 +61,7 @@
 
 #include "mbc.h"
 #include "sock.h"
+#include "shm.h"
 
 
 /* private flags for internal use */
@@ -351,6 +352,63 @@ mbc_unix_init(mbc_t *mbc, const char *path)
 }
 #endif /* _WIN32 */
 
+/* initialize communication using shared memory
+ *
+ * mbc must be a pointer to a valid mbc_t structure
+ * name must be defined
+ */
+int
+mbc_shm_init(mbc_t *mbc, const char *name)
+{
+#ifdef MBDYN_SHM_SUPPORTED
+	unsigned long timeout = mbc->timeout*1000000;
+	unsigned long useconds = 100000;
+
+	if (name == NULL) {
+		fprintf(stderr, "name must be defined\n");
+		return -1;
+	}
+
+	for ( ; ; ) {
+		int save_errno;
+
+		mbc->sock = mbdyn_shm_open(name, &save_errno);
+		if (mbc->sock != -1) {
+			if (mbc->verbose) {
+				fprintf(stdout, "Shared memory attach succeeded\n");
+			}
+			break;
+		}
+
+		switch (save_errno) {
+		case ENOENT:
+		case EAGAIN:
+			/* Channel does not exist yet; retry */
+			if (mbc->timeout < 0 || (mbc->timeout > 0 && timeout >= useconds)) {
+				usleep(useconds);
+				if (mbc->timeout > 0) {
+					timeout -= useconds;
+				}
+				continue;
+			}
+			break;
+		}
+
+		fprintf(stderr, "unable to attach to shared memory \"%s\" (%ld: %s)\n",
+			name, (long)save_errno, strerror(save_errno));
+		mbc->sock = INVALID_SOCKET;
+		return -1;
+	}
+
+	mbc->sock_flags = MBC_SF_VALID;
+
+	return 0;
+#else /* ! MBDYN_SHM_SUPPORTED */
+	fprintf(stderr, "shared memory is not supported on this platform\n");
+	return -1;
+#endif /* ! MBDYN_SHM_SUPPORTED */
+}
+
 /* destroy communication
  *
  * does NOT free the mbc structure
@@ -365,8 +423,13 @@ mbc_destroy(mbc_t *mbc)
 		closesocket(mbc->sock);
 		WSACleanup();
 #else
+		if (mbdyn_shm_is_channel(mbc->sock)) {
+			mbdyn_shm_close(mbc->sock);
+
+		} else {
         /*shutdown(mbc->sock, SHUT_RDWR); */
-		close(mbc->sock);
+			close(mbc->sock);
+		}
 #endif /* _WIN23 */
         	mbc->sock = INVALID_SOCKET;
 	}
@@ -209,6 +209,22 @@ mbc_inet_init(mbc_t *mbc, const char *host, short unsigned port);
 extern int
 mbc_unix_init(mbc_t *mbc, const char *path);
 
+/** \brief Initialize communication using shared memory.
+ *
+ * \param [in,out] mbc a pointer to a valid mbc_t structure
+ * \param [in] name name of the shared memory channel, as in the
+ * "shared memory" option of the peer's socket (e.g. "/mbdyn")
+ *
+ * Attaches to the shared memory channel created by the peer;
+ * the protocol is the same of the "inet" and "unix" sockets,
+ * but data does not go through the kernel.  If the channel
+ * does not exist yet, the behavior depends on mbc_t::timeout.
+ *
+ * @return 0 on success, !0 on failure.
+ */
+extern int
+mbc_shm_init(mbc_t *mbc, const char *name);
+
 /**
  * \brief Reference node (AKA "rigid") stuff (partially opaque).
  *
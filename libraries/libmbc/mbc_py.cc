@@ -121,7 +121,12 @@ mbc_py_nodal_initialize(const char *const path,
 		}
 	}
 
-	if (path && path[0]) {
+	if (path && strncmp(path, "shm:", sizeof("shm:") - 1) == 0) {
+		if (mbc_shm_init((mbc_t *)&mbc, &path[sizeof("shm:") - 1])) {
+			return -1;
+		}
+
+	} else if (path && path[0]) {
 		if (mbc_unix_init((mbc_t *)&mbc, path)) {
 			return -1;
 		}
@@ -335,7 +340,12 @@ mbc_py_modal_initialize(const char *const path,
 		}
 	}
 
-	if (path && path[0]) {
+	if (path && strncmp(path, "shm:", sizeof("shm:") - 1) == 0) {
+		if (mbc_shm_init((mbc_t *)&mbc, &path[sizeof("shm:") - 1])) {
+			return -1;
+		}
+
+	} else if (path && path[0]) {
 		if (mbc_unix_init((mbc_t *)&mbc, path)) {
 			return -1;
 		}
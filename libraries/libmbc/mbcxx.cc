@@ -143,6 +143,18 @@ MBCBase::Init(const char *const host, short unsigned port)
 	return rc;
 }
 
+int
+MBCBase::InitShm(const char *const name)
+{
+	int rc = -1;
+#ifndef _WIN32
+	if (GetStatus() != INITIALIZED) return -1;
+	rc = mbc_shm_init(GetBasePtr(), name);
+	if (rc == 0) SetStatus(SOCKET_READY);
+#endif /* ! _WIN32 */
+	return rc;
+}
+
 int
 MBCBase::GetCmd(void) const
 {
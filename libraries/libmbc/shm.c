@@ -0,0 +1,694 @@
+/* $Header$ */
+/*
+ * MBDyn (C) is a multibody analysis code.
+ * http://www.mbdyn.org
+ *
+ * Copyright (C) 1996-2023
+ *
+ * Pierangelo Masarati	<pierangelo.masarati@polimi.it>
+ * Paolo Mantegazza	<paolo.mantegazza@polimi.it>
+ *
+ * Dipartimento di Ingegneria Aerospaziale - Politecnico di Milano
+ * via La Masa, 34 - 20156 Milano, Italy
+ * http://www.aero.polimi.it
+ *
+ * Changing this copyright notice is forbidden.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation (version 2 of the License).
+ *
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "mbconfig.h"           /* This goes first in every *.c,*.cc file */
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include "shm.h"
+
+#ifdef MBDYN_SHM_SUPPORTED
+
+#include <stdint.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif /* __linux__ */
+
+#define MBDYN_SHM_MAGIC		0x4d425348U	/* "MBSH" */
+#define MBDYN_SHM_VERSION	1U
+#define MBDYN_SHM_CACHELINE	64
+#define MBDYN_SHM_SPIN		4096
+#define MBDYN_SHM_WAIT_NS	100000000L	/* 100 ms */
+#define MBDYN_SHM_MAX_CHANNELS	64
+
+/* ring control block; producer and consumer fields
+ * live in separate cache lines to avoid false sharing */
+struct mbdyn_shm_ring {
+	/* written by the producer */
+	uint64_t head;
+	uint32_t data_seq;	/* futex word, bumped when data is added */
+	uint32_t data_waiters;
+	char pad0[MBDYN_SHM_CACHELINE - 16];
+
+	/* written by the consumer */
+	uint64_t tail;
+	uint32_t space_seq;	/* futex word, bumped when space is freed */
+	uint32_t space_waiters;
+	char pad1[MBDYN_SHM_CACHELINE - 16];
+};
+
+/* side 0 is the creator, side 1 the peer;
+ * side s writes ring[s] and reads ring[1 - s] */
+struct mbdyn_shm_header {
+	uint32_t magic;
+	uint32_t version;
+	uint64_t size;
+	int32_t pid[2];
+	uint32_t closed[2];
+	char pad[MBDYN_SHM_CACHELINE - 32];
+
+	struct mbdyn_shm_ring ring[2];
+};
+
+struct mbdyn_shm {
+	int fd;
+	int side;
+	char *name;
+	void *base;
+	size_t len;
+	uint64_t size;
+	struct mbdyn_shm_header *hdr;
+	struct mbdyn_shm_ring *out;
+	struct mbdyn_shm_ring *in;
+	char *out_data;
+	char *in_data;
+};
+
+/* channels are registered when created/opened and looked up
+ * by descriptor in recvn()/sendn(); registration is not thread-safe */
+static struct mbdyn_shm *shm_chan[MBDYN_SHM_MAX_CHANNELS];
+static int shm_nchan;
+
+static struct mbdyn_shm *
+shm_lookup(int fd)
+{
+	int i;
+
+	for (i = 0; i < shm_nchan; i++) {
+		if (shm_chan[i]->fd == fd) {
+			return shm_chan[i];
+		}
+	}
+
+	return NULL;
+}
+
+static size_t
+shm_map_len(uint64_t size)
+{
+	return sizeof(struct mbdyn_shm_header) + 2*size;
+}
+
+static int
+shm_register(int fd, int side, const char *name, void *base, size_t len)
+{
+	struct mbdyn_shm *ch;
+
+	if (shm_nchan == MBDYN_SHM_MAX_CHANNELS) {
+		errno = EMFILE;
+		return -1;
+	}
+
+	ch = (struct mbdyn_shm *)malloc(sizeof(struct mbdyn_shm));
+	if (ch == NULL) {
+		errno = ENOMEM;
+		return -1;
+	}
+
+	ch->fd = fd;
+	ch->side = side;
+	ch->name = NULL;
+	if (side == 0) {
+		ch->name = strdup(name);
+	}
+	ch->base = base;
+	ch->len = len;
+	ch->hdr = (struct mbdyn_shm_header *)base;
+	ch->size = ch->hdr->size;
+	ch->out = &ch->hdr->ring[side];
+	ch->in = &ch->hdr->ring[1 - side];
+	ch->out_data = (char *)base + sizeof(struct mbdyn_shm_header) + side*ch->size;
+	ch->in_data = (char *)base + sizeof(struct mbdyn_shm_header) + (1 - side)*ch->size;
+
+	shm_chan[shm_nchan++] = ch;
+
+	return 0;
+}
+
+static void
+shm_futex_wait(uint32_t *addr, uint32_t val)
+{
+#ifdef __linux__
+	struct timespec ts = { 0, MBDYN_SHM_WAIT_NS };
+
+	/* not FUTEX_PRIVATE_FLAG: the word is shared among processes */
+	(void)syscall(SYS_futex, addr, FUTEX_WAIT, val, &ts, NULL, 0);
+#else /* ! __linux__ */
+	struct timespec ts = { 0, 100000L };
+
+	(void)addr;
+	(void)val;
+	nanosleep(&ts, NULL);
+#endif /* ! __linux__ */
+}
+
+static void
+shm_futex_wake(uint32_t *addr)
+{
+#ifdef __linux__
+	(void)syscall(SYS_futex, addr, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+#else /* ! __linux__ */
+	(void)addr;
+#endif /* ! __linux__ */
+}
+
+static void
+shm_signal(uint32_t *seq, uint32_t *waiters)
+{
+	__atomic_add_fetch(seq, 1, __ATOMIC_SEQ_CST);
+	if (__atomic_load_n(waiters, __ATOMIC_SEQ_CST) != 0) {
+		shm_futex_wake(seq);
+	}
+}
+
+/* returns 1 if the peer closed the channel */
+static int
+shm_peer_closed(const struct mbdyn_shm *ch)
+{
+	return __atomic_load_n(&ch->hdr->closed[1 - ch->side], __ATOMIC_ACQUIRE) != 0;
+}
+
+/* returns 1 if the peer closed the channel or died;
+ * involves a system call, so it is only used when idle */
+static int
+shm_peer_gone(const struct mbdyn_shm *ch)
+{
+	pid_t pid;
+
+	if (shm_peer_closed(ch)) {
+		return 1;
+	}
+
+	pid = __atomic_load_n(&ch->hdr->pid[1 - ch->side], __ATOMIC_ACQUIRE);
+	if (pid != 0 && kill(pid, 0) == -1 && errno == ESRCH) {
+		return 1;
+	}
+
+	return 0;
+}
+
+static uint64_t
+shm_avail_data(const struct mbdyn_shm *ch)
+{
+	return __atomic_load_n(&ch->in->head, __ATOMIC_ACQUIRE)
+		- __atomic_load_n(&ch->in->tail, __ATOMIC_RELAXED);
+}
+
+static uint64_t
+shm_avail_space(const struct mbdyn_shm *ch)
+{
+	return ch->size - (__atomic_load_n(&ch->out->head, __ATOMIC_RELAXED)
+		- __atomic_load_n(&ch->out->tail, __ATOMIC_ACQUIRE));
+}
+
+/* waits until avail(ch) != 0; spins first, then sleeps on the futex.
+ * returns -1 if the peer is gone */
+static int
+shm_wait(struct mbdyn_shm *ch, uint64_t (*avail)(const struct mbdyn_shm *),
+	uint32_t *seq, uint32_t *waiters)
+{
+	/* spinning only pays off when the peer can run concurrently;
+	 * on a single CPU it just burns the peer's time slice */
+	static int spin = -1;
+	int i;
+
+	if (spin == -1) {
+		spin = sysconf(_SC_NPROCESSORS_ONLN) > 1 ? MBDYN_SHM_SPIN : 0;
+	}
+
+	for (i = 0; i < spin; i++) {
+		if (avail(ch) != 0) {
+			return 0;
+		}
+#if defined(__x86_64__) || defined(__i386__)
+		__builtin_ia32_pause();
+#endif /* __x86_64__ || __i386__ */
+	}
+
+	for (;;) {
+		uint32_t s;
+
+		__atomic_add_fetch(waiters, 1, __ATOMIC_SEQ_CST);
+		s = __atomic_load_n(seq, __ATOMIC_SEQ_CST);
+		if (avail(ch) == 0 && !shm_peer_closed(ch)) {
+			shm_futex_wait(seq, s);
+		}
+		__atomic_sub_fetch(waiters, 1, __ATOMIC_SEQ_CST);
+
+		if (avail(ch) != 0) {
+			return 0;
+		}
+
+		if (shm_peer_gone(ch)) {
+			return -1;
+		}
+	}
+}
+
+/* returns 1 if the existing object is stale, i.e. its creator is gone,
+ * 0 if it is in use (or still being initialized) and -1 on error */
+static int
+shm_stale(const char *name)
+{
+	struct mbdyn_shm_header *hdr;
+	struct stat st;
+	pid_t pid = 0;
+	void *base;
+	int fd;
+
+	fd = shm_open(name, O_RDONLY, 0);
+	if (fd == -1) {
+		/* removed in the meanwhile */
+		return errno == ENOENT ? 1 : -1;
+	}
+
+	if (fstat(fd, &st) == -1) {
+		int save_errno = errno;
+		close(fd);
+		errno = save_errno;
+		return -1;
+	}
+
+	if ((size_t)st.st_size >= sizeof(struct mbdyn_shm_header)) {
+		base = mmap(NULL, sizeof(struct mbdyn_shm_header), PROT_READ, MAP_SHARED, fd, 0);
+		if (base != MAP_FAILED) {
+			hdr = (struct mbdyn_shm_header *)base;
+			if (__atomic_load_n(&hdr->magic, __ATOMIC_ACQUIRE) == MBDYN_SHM_MAGIC) {
+				pid = hdr->pid[0];
+			}
+			munmap(base, sizeof(struct mbdyn_shm_header));
+		}
+	}
+	close(fd);
+
+	return pid != 0 && kill(pid, 0) == -1 && errno == ESRCH;
+}
+
+int
+mbdyn_shm_create(const char *name, size_t size, int *perrno)
+{
+	struct mbdyn_shm_header *hdr;
+	uint64_t rsize;
+	size_t len;
+	void *base;
+	int fd;
+
+	if (name == NULL || name[0] == '\0') {
+		errno = EINVAL;
+		goto fail;
+	}
+
+	if (size == 0) {
+		size = MBDYN_SHM_DEFAULT_SIZE;
+	}
+
+	/* power of 2, so that offsets are computed by masking */
+	for (rsize = 4096; rsize < size; rsize <<= 1)
+		;
+
+	fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+	if (fd == -1 && errno == EEXIST) {
+		/* only remove an object left by a crashed run */
+		switch (shm_stale(name)) {
+		case 1:
+			(void)shm_unlink(name);
+			fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+			break;
+
+		case 0:
+			errno = EEXIST;
+			break;
+		}
+	}
+	if (fd == -1) {
+		goto fail;
+	}
+
+	len = shm_map_len(rsize);
+	if (ftruncate(fd, len) == -1) {
+		goto fail_unlink;
+	}
+
+	base = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (base == MAP_FAILED) {
+		goto fail_unlink;
+	}
+
+	/* ftruncate() zero-filled the object */
+	hdr = (struct mbdyn_shm_header *)base;
+	hdr->version = MBDYN_SHM_VERSION;
+	hdr->size = rsize;
+	hdr->pid[0] = getpid();
+	__atomic_store_n(&hdr->magic, MBDYN_SHM_MAGIC, __ATOMIC_RELEASE);
+
+	if (shm_register(fd, 0, name, base, len) == -1) {
+		int save_errno = errno;
+		munmap(base, len);
+		errno = save_errno;
+		goto fail_unlink;
+	}
+
+	return fd;
+
+fail_unlink:;
+	{
+		int save_errno = errno;
+		close(fd);
+		(void)shm_unlink(name);
+		errno = save_errno;
+	}
+
+fail:;
+	if (perrno) {
+		*perrno = errno;
+	}
+
+	return -1;
+}
+
+int
+mbdyn_shm_open(const char *name, int *perrno)
+{
+	struct mbdyn_shm_header *hdr;
+	struct stat st;
+	void *base;
+	size_t len;
+	int fd;
+
+	if (name == NULL || name[0] == '\0') {
+		errno = EINVAL;
+		goto fail;
+	}
+
+	fd = shm_open(name, O_RDWR, 0);
+	if (fd == -1) {
+		goto fail;
+	}
+
+	if (fstat(fd, &st) == -1) {
+		goto fail_close;
+	}
+
+	if ((size_t)st.st_size < sizeof(struct mbdyn_shm_header)) {
+		/* not initialized yet */
+		errno = EAGAIN;
+		goto fail_close;
+	}
+
+	len = st.st_size;
+	base = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (base == MAP_FAILED) {
+		goto fail_close;
+	}
+
+	hdr = (struct mbdyn_shm_header *)base;
+	if (__atomic_load_n(&hdr->magic, __ATOMIC_ACQUIRE) != MBDYN_SHM_MAGIC) {
+		errno = EAGAIN;
+		goto fail_unmap;
+	}
+
+	if (hdr->version != MBDYN_SHM_VERSION || shm_map_len(hdr->size) != len) {
+		errno = EPROTO;
+		goto fail_unmap;
+	}
+
+	{
+		int32_t pid = 0;
+
+		/* concurrent peers: only one claims the channel */
+		if (!__atomic_compare_exchange_n(&hdr->pid[1], &pid, (int32_t)getpid(),
+			0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+		{
+			errno = EBUSY;
+			goto fail_unmap;
+		}
+	}
+
+	if (shm_register(fd, 1, name, base, len) == -1) {
+		__atomic_store_n(&hdr->pid[1], 0, __ATOMIC_RELEASE);
+		goto fail_unmap;
+	}
+
+	return fd;
+
+fail_unmap:;
+	{
+		int save_errno = errno;
+		munmap(base, len);
+		errno = save_errno;
+	}
+
+fail_close:;
+	{
+		int save_errno = errno;
+		close(fd);
+		errno = save_errno;
+	}
+
+fail:;
+	if (perrno) {
+		*perrno = errno;
+	}
+
+	return -1;
+}
+
+int
+mbdyn_shm_close(int fd)
+{
+	struct mbdyn_shm *ch = NULL;
+	int i;
+
+	for (i = 0; i < shm_nchan; i++) {
+		if (shm_chan[i]->fd == fd) {
+			ch = shm_chan[i];
+			shm_chan[i] = shm_chan[--shm_nchan];
+			break;
+		}
+	}
+
+	if (ch == NULL) {
+		errno = EBADF;
+		return -1;
+	}
+
+	/* wake up the peer, if waiting, so that it detects the closure */
+	__atomic_store_n(&ch->hdr->closed[ch->side], 1U, __ATOMIC_RELEASE);
+	shm_signal(&ch->out->data_seq, &ch->out->data_waiters);
+	shm_signal(&ch->in->space_seq, &ch->in->space_waiters);
+
+	munmap(ch->base, ch->len);
+	close(ch->fd);
+	if (ch->name != NULL) {
+		(void)shm_unlink(ch->name);
+		free(ch->name);
+	}
+	free(ch);
+
+	return 0;
+}
+
+int
+mbdyn_shm_is_channel(int fd)
+{
+	return shm_nchan > 0 && shm_lookup(fd) != NULL;
+}
+
+ssize_t
+mbdyn_shm_recvn(int fd, char *vptr, size_t n, int flags)
+{
+	struct mbdyn_shm *ch = shm_lookup(fd);
+	uint64_t mask, tail;
+	size_t nleft = n;
+
+	if (ch == NULL) {
+		errno = EBADF;
+		return -1;
+	}
+
+	mask = ch->size - 1;
+	tail = __atomic_load_n(&ch->in->tail, __ATOMIC_RELAXED);
+
+#ifdef MSG_DONTWAIT
+	if ((flags & MSG_DONTWAIT) && n > 0 && shm_avail_data(ch) == 0) {
+		errno = EAGAIN;
+		return -1;
+	}
+#endif /* MSG_DONTWAIT */
+
+	while (nleft > 0) {
+		uint64_t avail = shm_avail_data(ch);
+		size_t chunk, off, first;
+
+		if (avail == 0) {
+			if (shm_wait(ch, shm_avail_data, &ch->in->data_seq, &ch->in->data_waiters) == -1) {
+				/* end of file */
+				break;
+			}
+			continue;
+		}
+
+		chunk = (avail < nleft) ? avail : nleft;
+		off = tail & mask;
+		first = ch->size - off;
+		if (first > chunk) {
+			first = chunk;
+		}
+		memcpy(vptr, ch->in_data + off, first);
+		memcpy(vptr + first, ch->in_data, chunk - first);
+
+		tail += chunk;
+		__atomic_store_n(&ch->in->tail, tail, __ATOMIC_RELEASE);
+		shm_signal(&ch->in->space_seq, &ch->in->space_waiters);
+
+		vptr += chunk;
+		nleft -= chunk;
+	}
+
+	return n - nleft;
+}
+
+ssize_t
+mbdyn_shm_sendn(int fd, const char *vptr, size_t n, int flags)
+{
+	struct mbdyn_shm *ch = shm_lookup(fd);
+	uint64_t mask, head;
+	size_t nleft = n;
+
+	(void)flags;
+
+	if (ch == NULL) {
+		errno = EBADF;
+		return -1;
+	}
+
+	mask = ch->size - 1;
+	head = __atomic_load_n(&ch->out->head, __ATOMIC_RELAXED);
+
+	while (nleft > 0) {
+		uint64_t avail;
+		size_t chunk, off, first;
+
+		if (shm_peer_closed(ch)) {
+			errno = EPIPE;
+			return -1;
+		}
+
+		avail = shm_avail_space(ch);
+		if (avail == 0) {
+			if (shm_wait(ch, shm_avail_space, &ch->out->space_seq, &ch->out->space_waiters) == -1) {
+				errno = EPIPE;
+				return -1;
+			}
+			continue;
+		}
+
+		chunk = (avail < nleft) ? avail : nleft;
+		off = head & mask;
+		first = ch->size - off;
+		if (first > chunk) {
+			first = chunk;
+		}
+		memcpy(ch->out_data + off, vptr, first);
+		memcpy(ch->out_data, vptr + first, chunk - first);
+
+		head += chunk;
+		__atomic_store_n(&ch->out->head, head, __ATOMIC_RELEASE);
+		shm_signal(&ch->out->data_seq, &ch->out->data_waiters);
+
+		vptr += chunk;
+		nleft -= chunk;
+	}
+
+	return n;
+}
+
+#else /* ! MBDYN_SHM_SUPPORTED */
+
+int
+mbdyn_shm_create(const char *name, size_t size, int *perrno)
+{
+	errno = ENOSYS;
+	if (perrno) {
+		*perrno = errno;
+	}
+	return -1;
+}
+
+int
+mbdyn_shm_open(const char *name, int *perrno)
+{
+	errno = ENOSYS;
+	if (perrno) {
+		*perrno = errno;
+	}
+	return -1;
+}
+
+int
+mbdyn_shm_close(int fd)
+{
+	errno = EBADF;
+	return -1;
+}
+
+int
+mbdyn_shm_is_channel(int fd)
+{
+	return 0;
+}
+
+ssize_t
+mbdyn_shm_recvn(int fd, char *vptr, size_t n, int flags)
+{
+	errno = EBADF;
+	return -1;
+}
+
+ssize_t
+mbdyn_shm_sendn(int fd, const char *vptr, size_t n, int flags)
+{
+	errno = EBADF;
+	return -1;
+}
+
+#endif /* ! MBDYN_SHM_SUPPORTED */
@@ -0,0 +1,115 @@
+/* $Header$ */
+/*
+ * MBDyn (C) is a multibody analysis code.
+ * http://www.mbdyn.org
+ *
+ * Copyright (C) 1996-2023
+ *
+ * Pierangelo Masarati	<pierangelo.masarati@polimi.it>
+ * Paolo Mantegazza	<paolo.mantegazza@polimi.it>
+ *
+ * Dipartimento di Ingegneria Aerospaziale - Politecnico di Milano
+ * via La Masa, 34 - 20156 Milano, Italy
+ * http://www.aero.polimi.it
+ *
+ * Changing this copyright notice is forbidden.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation (version 2 of the License).
+ *
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Shared memory channels: a pair of single-producer, single-consumer
+ * byte rings in a POSIX shared memory object, one per direction,
+ * used as a drop-in replacement of a stream socket between
+ * two processes on the same host.
+ *
+ * A channel is identified by the descriptor of the shared memory object;
+ * recvn() and sendn() (see sock.h) recognize it and move the data
+ * through the rings, so the protocol on top of it is unchanged.
+ * The fast path involves no system calls: the receiver spins for a while,
+ * then sleeps on a futex (Linux) until the sender signals new data.
+ */
+
+#ifndef SHM_H
+#define SHM_H
+
+#include "mbconfig.h"
+
+#ifndef _WIN32
+#include <unistd.h>
+#if defined(_POSIX_SHARED_MEMORY_OBJECTS) && (_POSIX_SHARED_MEMORY_OBJECTS > 0)
+#define MBDYN_SHM_SUPPORTED 1
+#endif /* _POSIX_SHARED_MEMORY_OBJECTS */
+#endif /* ! _WIN32 */
+
+#include <sys/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* default size of each ring, in bytes */
+#define MBDYN_SHM_DEFAULT_SIZE	(1024*1024)
+
+/** Creates a shared memory channel
+ *
+ *  param name Input name of the POSIX shared memory object (e.g. "/mbdyn");
+ *    an object with the same name is removed only if its creator
+ *    no longer exists, otherwise the call fails with EEXIST
+ *  param size Input size of each ring, in bytes; rounded up to a power of 2
+ *  param perrno Output errno in case of failure (may be NULL)
+ *
+ *  returns the descriptor of the channel, or -1 in case of failure;
+ *  the peer may attach any time after the call returns
+ */
+extern int
+mbdyn_shm_create(const char *name, size_t size, int *perrno);
+
+/** Attaches to a shared memory channel created by the peer
+ *
+ *  param name Input name of the POSIX shared memory object
+ *  param perrno Output errno in case of failure (may be NULL);
+ *    ENOENT or EAGAIN mean that the channel is not ready yet,
+ *    EBUSY that another peer is already attached
+ *
+ *  returns the descriptor of the channel, or -1 in case of failure
+ */
+extern int
+mbdyn_shm_open(const char *name, int *perrno);
+
+/** Detaches from a shared memory channel
+ *
+ *  Pending readers on the peer side get end-of-file;
+ *  the creator also removes the shared memory object.
+ */
+extern int
+mbdyn_shm_close(int fd);
+
+/** Returns 1 if fd is the descriptor of a shared memory channel */
+extern int
+mbdyn_shm_is_channel(int fd);
+
+/* same semantics of recvn() and sendn();
+ * MSG_DONTWAIT is honored when no data is available at all */
+extern ssize_t
+mbdyn_shm_recvn(int fd, char *vptr, size_t n, int flags);
+extern ssize_t
+mbdyn_shm_sendn(int fd, const char *vptr, size_t n, int flags);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* SHM_H */
@@ -63,6 +63,7 @@
 #endif
 
 #include "sock.h"
+#include "shm.h"
 
 
 ssize_t recvn(int fd, char *vptr, size_t n, int flags) {
@@ -70,6 +71,12 @@ ssize_t recvn(int fd, char *vptr, size_t n, int flags) {
     ssize_t nread;
     char   *ptr;
 
+#ifdef MBDYN_SHM_SUPPORTED
+    if (mbdyn_shm_is_channel(fd)) {
+	return mbdyn_shm_recvn(fd, vptr, n, flags);
+    }
+#endif /* MBDYN_SHM_SUPPORTED */
+
     ptr = vptr;
     nleft = n;
     while (nleft > 0) {
@@ -90,6 +97,13 @@ ssize_t sendn(int fd, const char* vptr, size_t n, int flags) {
     size_t nleft;
     ssize_t nwritten;
     const char* ptr;
+
+#ifdef MBDYN_SHM_SUPPORTED
+    if (mbdyn_shm_is_channel(fd)) {
+	return mbdyn_shm_sendn(fd, vptr, n, flags);
+    }
+#endif /* MBDYN_SHM_SUPPORTED */
+
     ptr = vptr;
     nleft = n;
     while(nleft > 0) {
@@ -0,0 +1,288 @@
+/* $Header$ */
+/*
+ * MBDyn (C) is a multibody analysis code.
+ * http://www.mbdyn.org
+ *
+ * Copyright (C) 1996-2023
+ *
+ * Pierangelo Masarati	<pierangelo.masarati@polimi.it>
+ * Paolo Mantegazza	<paolo.mantegazza@polimi.it>
+ *
+ * Dipartimento di Ingegneria Aerospaziale - Politecnico di Milano
+ * via La Masa, 34 - 20156 Milano, Italy
+ * http://www.aero.polimi.it
+ *
+ * Changing this copyright notice is forbidden.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation (version 2 of the License).
+ *
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "mbconfig.h"           /* This goes first in every *.c,*.cc file */
+
+#include <algorithm>
+#include <limits>
+#ifdef HAVE_THREADS
+#include <thread>
+#endif // HAVE_THREADS
+
+#include "csrmat.h"
+#include "spmapmh.h"
+#include "vh.h"
+
+/* per il debugging */
+#include "myassert.h"
+#include "mynewmem.h"
+#include "except.h"
+
+/* CSRMatrix - begin */
+
+CSRMatrix::CSRMatrix(void)
+: iNumRows(0), iNumCols(0), uThreads(0)
+{
+	H.iNumRows = 0;
+	HT.iNumRows = 0;
+}
+
+CSRMatrix::CSRMatrix(const SpMapMatrixHandler& M, unsigned uThreads)
+: iNumRows(0), iNumCols(0), uThreads(uThreads)
+{
+	const integer nz = M.Nz();
+	if (nz > std::numeric_limits<int32_t>::max()) {
+		silent_cerr("CSRMatrix: too many nonzeros (" << nz << ")" << std::endl);
+		throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+	}
+
+	std::vector<int32_t> Ap(M.iGetNumRows() + 1), Ai(nz);
+	std::vector<doublereal> Ax(nz);
+
+	if (nz > 0) {
+		M.MakeCompressedRowForm(&Ax[0], &Ai[0], &Ap[0]);
+
+	} else {
+		std::fill(Ap.begin(), Ap.end(), 0);
+	}
+
+	Set(M.iGetNumRows(), M.iGetNumCols(), Ap, Ai, Ax);
+}
+
+CSRMatrix::~CSRMatrix(void)
+{
+	NO_OP;
+}
+
+void
+CSRMatrix::Set(integer iNumRows, integer iNumCols,
+	std::vector<int32_t>& Ap,
+	std::vector<int32_t>& Ai,
+	std::vector<doublereal>& Ax)
+{
+	ASSERT(Ap.size() == size_t(iNumRows) + 1);
+	ASSERT(Ai.size() == Ax.size());
+	ASSERT(Ap[0] == 0);
+	ASSERT(size_t(Ap[iNumRows]) == Ai.size());
+
+	this->iNumRows = iNumRows;
+	this->iNumCols = iNumCols;
+
+	H.iNumRows = iNumRows;
+	H.Ap.swap(Ap);
+	H.Ai.swap(Ai);
+	H.Ax.swap(Ax);
+
+	/* transpose by counting sort on the column index */
+	const int32_t nz = H.Ax.size();
+
+	HT.iNumRows = iNumCols;
+	HT.Ap.assign(iNumCols + 1, 0);
+	HT.Ai.resize(nz);
+	HT.Ax.resize(nz);
+
+	for (int32_t k = 0; k < nz; k++) {
+		ASSERT(H.Ai[k] >= 0 && H.Ai[k] < iNumCols);
+		HT.Ap[H.Ai[k] + 1]++;
+	}
+
+	for (integer c = 0; c < iNumCols; c++) {
+		HT.Ap[c + 1] += HT.Ap[c];
+	}
+
+	std::vector<int32_t> Next(HT.Ap.begin(), HT.Ap.end() - 1);
+	for (integer r = 0; r < iNumRows; r++) {
+		for (int32_t k = H.Ap[r]; k < H.Ap[r + 1]; k++) {
+			const int32_t iSlot = Next[H.Ai[k]]++;
+			HT.Ai[iSlot] = r;
+			HT.Ax[iSlot] = H.Ax[k];
+		}
+	}
+
+	SetThreads(uThreads);
+}
+
+void
+CSRMatrix::SetThreads(unsigned uThreads)
+{
+	this->uThreads = uThreads;
+
+	unsigned n = uThreads;
+#ifdef HAVE_THREADS
+	if (n == 0) {
+		n = std::max(1U, std::thread::hardware_concurrency());
+		n = std::min<size_t>(n, std::max<size_t>(1, H.Ax.size()/MIN_NZ_PER_THREAD));
+	}
+#else // !HAVE_THREADS
+	n = 1;
+#endif // !HAVE_THREADS
+
+	H.Partition(n);
+	HT.Partition(n);
+
+	/* started by the first product */
+	Pool.SetWorkers(std::max(H.Part.size(), HT.Part.size()) - 2);
+}
+
+unsigned
+CSRMatrix::uGetThreads(void) const
+{
+	return H.Part.size() - 1;
+}
+
+void
+CSRMatrix::Form::Partition(unsigned uThreads)
+{
+	ASSERT(uThreads > 0);
+
+	const int32_t nz = Ax.size();
+	uThreads = std::min<integer>(uThreads, std::max<integer>(iNumRows, 1));
+
+	Part.resize(uThreads + 1);
+	Part[0] = 0;
+	for (unsigned t = 1; t < uThreads; t++) {
+		/* first row whose nonzeros start past t/uThreads of the total */
+		const int32_t iTarget = int32_t((int64_t(nz)*t)/uThreads);
+		Part[t] = std::lower_bound(Ap.begin() + Part[t - 1], Ap.end() - 1, iTarget) - Ap.begin();
+	}
+	Part[uThreads] = iNumRows;
+}
+
+void
+CSRMatrix::Form::Mul(integer iFirst, integer iLast,
+	doublereal *const *ppOut,
+	const doublereal *const *ppIn, unsigned nVec) const
+{
+	const int32_t *const pAp = &Ap[0];
+	const int32_t *const pAi = Ai.empty() ? 0 : &Ai[0];
+	const doublereal *const pAx = Ax.empty() ? 0 : &Ax[0];
+
+	if (nVec == 1) {
+		const doublereal *const pIn = ppIn[0];
+		doublereal *const pOut = ppOut[0];
+
+		for (integer r = iFirst; r < iLast; r++) {
+			doublereal d = 0.;
+			for (int32_t k = pAp[r]; k < pAp[r + 1]; k++) {
+				d += pAx[k]*pIn[pAi[k]];
+			}
+			pOut[r] = d;
+		}
+
+		return;
+	}
+
+	ASSERT(nVec <= MAX_VEC);
+
+	for (integer r = iFirst; r < iLast; r++) {
+		doublereal d[MAX_VEC] = { 0. };
+		for (int32_t k = pAp[r]; k < pAp[r + 1]; k++) {
+			const doublereal a = pAx[k];
+			const int32_t c = pAi[k];
+			for (unsigned v = 0; v < nVec; v++) {
+				d[v] += a*ppIn[v][c];
+			}
+		}
+
+		for (unsigned v = 0; v < nVec; v++) {
+			ppOut[v][r] = d[v];
+		}
+	}
+}
+
+void
+CSRMatrix::Mul(const Form& F, doublereal *const *ppOut,
+	const doublereal *const *ppIn, unsigned nVec) const
+{
+	for (unsigned v0 = 0; v0 < nVec; v0 += MAX_VEC) {
+		const unsigned n = std::min<unsigned>(nVec - v0, MAX_VEC);
+		const unsigned uParts = F.Part.size() - 1;
+
+		if (uParts > 1) {
+			/* the transpose may have fewer chunks than workers */
+			Pool.Run(uParts, [&F, ppOut, ppIn, v0, n] (unsigned c) {
+				F.Mul(F.Part[c], F.Part[c + 1], ppOut + v0, ppIn + v0, n);
+			});
+
+			continue;
+		}
+
+		F.Mul(0, F.iNumRows, ppOut + v0, ppIn + v0, n);
+	}
+}
+
+void
+CSRMatrix::MatVecMul(doublereal *const *ppOut,
+	const doublereal *const *ppIn, unsigned nVec) const
+{
+	Mul(H, ppOut, ppIn, nVec);
+}
+
+void
+CSRMatrix::MatTVecMul(doublereal *const *ppOut,
+	const doublereal *const *ppIn, unsigned nVec) const
+{
+	Mul(HT, ppOut, ppIn, nVec);
+}
+
+VectorHandler&
+CSRMatrix::MatVecMul(VectorHandler& out, const VectorHandler& in) const
+{
+	ASSERT(out.iGetSize() == iNumRows);
+	ASSERT(in.iGetSize() == iNumCols);
+
+	doublereal *pOut = out.pdGetVec();
+	const doublereal *pIn = in.pdGetVec();
+	ASSERT(pOut != 0 || iNumRows == 0);
+	ASSERT(pIn != 0 || iNumCols == 0);
+
+	Mul(H, &pOut, &pIn, 1);
+
+	return out;
+}
+
+VectorHandler&
+CSRMatrix::MatTVecMul(VectorHandler& out, const VectorHandler& in) const
+{
+	ASSERT(out.iGetSize() == iNumCols);
+	ASSERT(in.iGetSize() == iNumRows);
+
+	doublereal *pOut = out.pdGetVec();
+	const doublereal *pIn = in.pdGetVec();
+	ASSERT(pOut != 0 || iNumCols == 0);
+	ASSERT(pIn != 0 || iNumRows == 0);
+
+	Mul(HT, &pOut, &pIn, 1);
+
+	return out;
+}
+
+/* CSRMatrix - end */
@@ -0,0 +1,141 @@
+/* $Header$ */
+/*
+ * MBDyn (C) is a multibody analysis code.
+ * http://www.mbdyn.org
+ *
+ * Copyright (C) 1996-2023
+ *
+ * Pierangelo Masarati	<pierangelo.masarati@polimi.it>
+ * Paolo Mantegazza	<paolo.mantegazza@polimi.it>
+ *
+ * Dipartimento di Ingegneria Aerospaziale - Politecnico di Milano
+ * via La Masa, 34 - 20156 Milano, Italy
+ * http://www.aero.polimi.it
+ *
+ * Changing this copyright notice is forbidden.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation (version 2 of the License).
+ *
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Read-only sparse matrix in compressed row (CSR) form, meant for
+ * operators that are assembled once and applied many times
+ * (e.g. the interpolation matrices of the external mapping elements).
+ *
+ * The transpose is stored in compressed row form as well, so that both
+ * the product and the transposed product are computed by gathering
+ * along rows; rows are split among threads in chunks with about
+ * the same number of nonzeros, and each thread writes its own rows only.
+ * The worker threads are started once, by the first product after
+ * the number of threads is set, and wait for the next products,
+ * so a product costs no thread creation.
+ * Several vectors can be multiplied in a single pass over the matrix.
+ */
+
+#ifndef CSRMAT_H
+#define CSRMAT_H
+
+#include <vector>
+#include <stdint.h>
+
+#include "ac/f2c.h"
+#include "workerpool.h"
+
+class VectorHandler;
+class SpMapMatrixHandler;
+
+/* CSRMatrix - begin */
+
+class CSRMatrix {
+public:
+	/* max number of vectors processed in a single pass */
+	enum { MAX_VEC = 4 };
+
+	/* minimum number of nonzeros per thread
+	 * when the number of threads is computed automatically */
+	enum { MIN_NZ_PER_THREAD = 1 << 15 };
+
+private:
+	struct Form {
+		integer iNumRows;
+		std::vector<int32_t> Ap;
+		std::vector<int32_t> Ai;
+		std::vector<doublereal> Ax;
+
+		/* first row of each thread's chunk, plus iNumRows */
+		std::vector<integer> Part;
+
+		void Partition(unsigned uThreads);
+		void Mul(integer iFirst, integer iLast,
+			doublereal *const *ppOut,
+			const doublereal *const *ppIn, unsigned nVec) const;
+	};
+
+	integer iNumRows;
+	integer iNumCols;
+	unsigned uThreads;
+
+	/* the matrix and its transpose */
+	Form H, HT;
+
+	/* chunk c of a product is computed by worker c - 1,
+	 * chunk 0 by the caller */
+	mutable WorkerPool Pool;
+
+	void Mul(const Form& F, doublereal *const *ppOut,
+		const doublereal *const *ppIn, unsigned nVec) const;
+
+public:
+	CSRMatrix(void);
+	CSRMatrix(const SpMapMatrixHandler& M, unsigned uThreads = 0);
+	~CSRMatrix(void);
+
+	CSRMatrix(const CSRMatrix&) = delete;
+	CSRMatrix& operator = (const CSRMatrix&) = delete;
+
+	/* takes the contents of the vectors (0-based, sorted or not) */
+	void Set(integer iNumRows, integer iNumCols,
+		std::vector<int32_t>& Ap,
+		std::vector<int32_t>& Ai,
+		std::vector<doublereal>& Ax);
+
+	/* 0: as many as useful, up to the available hardware threads */
+	void SetThreads(unsigned uThreads);
+	unsigned uGetThreads(void) const;
+
+	integer iGetNumRows(void) const { return iNumRows; };
+	integer iGetNumCols(void) const { return iNumCols; };
+	integer Nz(void) const { return H.Ax.size(); };
+
+	const std::vector<int32_t>& GetRowPtr(void) const { return H.Ap; };
+	const std::vector<int32_t>& GetColIdx(void) const { return H.Ai; };
+	const std::vector<doublereal>& GetValues(void) const { return H.Ax; };
+
+	/* ppOut[v] = H * ppIn[v], v = 0, ..., nVec - 1 */
+	void MatVecMul(doublereal *const *ppOut,
+		const doublereal *const *ppIn, unsigned nVec = 1) const;
+
+	/* ppOut[v] = H^T * ppIn[v], v = 0, ..., nVec - 1 */
+	void MatTVecMul(doublereal *const *ppOut,
+		const doublereal *const *ppIn, unsigned nVec = 1) const;
+
+	/* vector handlers must provide contiguous storage */
+	VectorHandler& MatVecMul(VectorHandler& out, const VectorHandler& in) const;
+	VectorHandler& MatTVecMul(VectorHandler& out, const VectorHandler& in) const;
+};
+
+/* CSRMatrix - end */
+
+#endif /* CSRMAT_H */
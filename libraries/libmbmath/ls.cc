@@ -37,6 +37,7 @@
 
 #include <iostream>
 #include <iomanip>
+#include <algorithm>
 
 #include "solman.h"
 #include "ls.h"
@@ -44,7 +45,8 @@
 /* LinearSolver - begin */
 
 LinearSolver::LinearSolver(SolutionManager *psm)
-: pSM(psm), bHasBeenReset(true), pdRhs(0), pdSol(0)
+: pSM(psm), bHasBeenReset(true), pdRhs(0), pdSol(0),
+iNumSymbolicFact(0), iNumNumericFact(0)
 {
 	NO_OP;
 }
@@ -134,5 +136,25 @@ bool LinearSolver::bGetConditionNumber(doublereal& dCond)
 	return false; // true means that the condition number was returned in dCond
 }
 
+bool
+LinearSolver::bPatternChanged(const integer *Ai, const integer *Ap,
+	integer iNumCols, integer iNonZeroes) const
+{
+	/* a linear scan of the indices is negligible with respect
+	 * to the symbolic analysis it allows to skip */
+	if (SymbolicAp.size() == size_t(iNumCols + 1)
+		&& SymbolicAi.size() == size_t(iNonZeroes)
+		&& std::equal(Ap, Ap + iNumCols + 1, SymbolicAp.begin())
+		&& std::equal(Ai, Ai + iNonZeroes, SymbolicAi.begin()))
+	{
+		return false;
+	}
+
+	SymbolicAp.assign(Ap, Ap + iNumCols + 1);
+	SymbolicAi.assign(Ai, Ai + iNonZeroes);
+
+	return true;
+}
+
 /* LinearSolver - end */
 
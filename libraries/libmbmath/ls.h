@@ -74,6 +74,20 @@ protected:
 	doublereal *pdRhs;
 	doublereal *pdSol;
 
+	/* factorization counters */
+	mutable integer iNumSymbolicFact;
+	mutable integer iNumNumericFact;
+
+	/* sparsity pattern used by the last symbolic factorization */
+	mutable std::vector<integer> SymbolicAi;
+	mutable std::vector<integer> SymbolicAp;
+
+	/* true if the compressed column pattern differs from the one
+	 * used by the last symbolic factorization; the stored copy
+	 * is updated accordingly */
+	bool bPatternChanged(const integer *Ai, const integer *Ap,
+		integer iNumCols, integer iNonZeroes) const;
+
 public:
 	LinearSolver(SolutionManager *pSM = NULL);
 	virtual ~LinearSolver(void);
@@ -101,6 +115,14 @@ public:
 	
 	/* returns true if the condition number is available, and sets dCond */
 	virtual bool bGetConditionNumber(doublereal& dCond);
+
+	/* symbolic (ordering, analysis) and numeric factorizations
+	 * performed so far */
+	integer iGetNumSymbolicFact(void) const { return iNumSymbolicFact; };
+	integer iGetNumNumericFact(void) const { return iNumNumericFact; };
+
+	/* used by solution managers that compute the ordering themselves */
+	void IncNumSymbolicFact(void) const { iNumSymbolicFact++; };
 };
 
 /* LinearSolver - end */
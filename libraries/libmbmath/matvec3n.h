@@ -298,6 +298,20 @@ class Mat3xN: public sp_grad::SpConstMatElemAdapter<Mat3xN>
    inline doublereal & operator () (integer i, integer j);
    inline const doublereal & operator () (integer i, integer j) const;
 
+   /*
+    Dirty job: restituisce il puntatore alla riga i (1-based);
+    gli elementi di una riga sono contigui
+    */
+   const doublereal* pGetRow(int i) const {
+      ASSERT(i > 0 && i <= 3);
+      return pdRows[i - 1];
+   };
+
+   doublereal* pGetRow(int i) {
+      ASSERT(i > 0 && i <= 3);
+      return pdRows[i - 1];
+   };
+
      static constexpr sp_grad::index_type iNumRowsStatic = 3;
      static constexpr sp_grad::index_type iNumColsStatic = sp_grad::SpMatrixSize::DYNAMIC;
      inline sp_grad::index_type iGetRowOffset() const noexcept { return iGetNumCols(); }
@@ -192,6 +192,9 @@ public:
 
    	/* return true if the condition number is available */
    	virtual bool bGetConditionNumber(doublereal& dCond) const;
+
+	/* Rende disponibile il solutore lineare (factorization counters) */
+	const LinearSolver* pGetLinearSolver(void) const { return pLS; };
 };
 
 class QrSolutionManager: public SolutionManager {
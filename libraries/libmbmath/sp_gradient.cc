@@ -41,11 +41,13 @@
 #include "mbconfig.h"           /* This goes first in every *.c,*.cc file */
 
 #include <cstdlib>
+#include <cstring>
 #include <algorithm>
 
 #include "sp_gradient.h"
 #include "sp_matrix_base.h"
 #include "sp_gradient_op.h"
+#include "except.h"
 
 #ifdef SP_GRAD_DEBUG
 #include <cmath>
@@ -55,14 +57,52 @@
 namespace sp_grad {
      SpDerivData SpGradient::oNullData{0., 0, 0, SpDerivData::DER_UNIQUE | SpDerivData::DER_SORTED, 1, nullptr};
 
-     SpDerivData* SpGradient::pAllocMem(SpDerivData* ptr, index_type iSize) {
-          ptr = reinterpret_cast<SpDerivData*>(std::realloc(ptr, uGetAllocSize(iSize)));
+     void util::SpDenseDofMapSizeError(index_type iDof, index_type iMaxSize) {
+          silent_cerr("SpDenseDofMap: dof " << iDof
+                      << " exceeds the maximum number of dofs (" << iMaxSize
+                      << ") of a dense gradient" << std::endl);
+          throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+     }
+
+     void util::SpDenseDofMapNotActive() {
+          silent_cerr("SpDenseDofMap: no dof map is active for a dense gradient" << std::endl);
+          throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+     }
+
+     SpDerivData* SpGradient::pAllocMem(SpDerivData* ptr, index_type iSize, bool& bArena) {
+          const size_t uSize = uGetAllocSize(iSize);
+
+          if (ptr && !(ptr->uFlags & SpDerivData::DER_ARENA)) {
+               // blocks on the heap keep growing on the heap
+               bArena = false;
 
-          if (!ptr) {
-               throw std::bad_alloc();
+               ptr = reinterpret_cast<SpDerivData*>(std::realloc(ptr, uSize));
+
+               if (!ptr) {
+                    throw std::bad_alloc();
+               }
+
+               return ptr;
           }
 
-          return ptr;
+          void* pMem = SpGradientArena::pAllocate(uSize);
+
+          bArena = pMem != nullptr;
+
+          if (!bArena) {
+               pMem = std::malloc(uSize);
+
+               if (!pMem) {
+                    throw std::bad_alloc();
+               }
+          }
+
+          if (ptr) {
+               std::memcpy(pMem, ptr, uGetAllocSize(ptr->iSizeRes));
+               SpGradientArena::Free(ptr);
+          }
+
+          return reinterpret_cast<SpDerivData*>(pMem);
      }
 
      void SpGradient::Allocate(index_type iSizeRes, index_type iSizeInit, unsigned uFlags) {
@@ -74,12 +114,13 @@ namespace sp_grad {
           const doublereal dVal = pData->dVal;
 
           SpDerivData* pMem;
+          bool bArena;
 
           const bool bNeedToGrow = iSizeRes > pData->iSizeRes;
           const bool bCannotReuse = pData->iRefCnt > 1 || (pData->pOwner && (bNeedToGrow || !pData->pOwner->bIsOwnerOf(this)));
 
           if (bCannotReuse) {
-               pMem = pAllocMem(nullptr, iSizeRes);
+               pMem = pAllocMem(nullptr, iSizeRes, bArena);
                index_type iSizeCopy = std::min(pData->iSizeCurr, iSizeInit);
                std::uninitialized_copy(pData->rgDer,
                                        pData->rgDer + iSizeCopy,
@@ -89,15 +130,21 @@ namespace sp_grad {
                SP_GRAD_ASSERT(!pData->pOwner);
                SP_GRAD_ASSERT(pData != pGetNullData());
 
-               pMem = pAllocMem(pData, iSizeRes);
+               pMem = pAllocMem(pData, iSizeRes, bArena);
           } else {
                SP_GRAD_ASSERT(((pData->pOwner && pData->pOwner->bIsOwnerOf(this))) ? (pData->iSizeRes == 0 || pData->iSizeRes >= iSizeRes) : true);
                SP_GRAD_ASSERT(pData != pGetNullData());
                pData->iSizeCurr = iSizeInit;
-               pData->uFlags = uFlags;
+               pData->uFlags = (uFlags & ~SpDerivData::DER_ARENA) | (pData->uFlags & SpDerivData::DER_ARENA);
                return;
           }
 
+          uFlags &= ~SpDerivData::DER_ARENA;
+
+          if (bArena) {
+               uFlags |= SpDerivData::DER_ARENA;
+          }
+
           pData = new(pMem) SpDerivData(dVal, iSizeRes, iSizeInit, uFlags, 1, nullptr);
      }
 
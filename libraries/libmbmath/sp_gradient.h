@@ -44,6 +44,7 @@
 #include <algorithm>
 
 #include "sp_gradient_base.h"
+#include "sp_gradient_arena.h"
 #include "sp_exp_dof_map.h"
 #include "sp_gradient_fwd.h"
 #include "sp_gradient_util.h"
@@ -828,7 +829,11 @@ namespace sp_grad {
           if (pData->pOwner) {
                pData->pOwner->Detach(this);
           } else if (!iRefCntCurr && pData != &oNullData) {
-               std::free(pData);
+               if (pData->uFlags & SpDerivData::DER_ARENA) {
+                    SpGradientArena::Free(pData);
+               } else {
+                    std::free(pData);
+               }
           }
      }
 
@@ -1043,7 +1048,7 @@ namespace sp_grad {
 
           g.InsertDeriv(r, df_dv);
 
-          r.pData->uFlags = 0u;
+          r.pData->uFlags &= SpDerivData::DER_ARENA;
 
           *this = std::move(r);
 
@@ -1331,5 +1336,188 @@ namespace sp_grad {
           return std::isfinite(dVal) && std::isfinite(dDer);
      }
 #endif
+
+     template <index_type N_SIZE>
+     SP_GRAD_THREAD_LOCAL SpDenseDofMap<N_SIZE>* SpDenseDofMap<N_SIZE>::pActive = nullptr;
+
+     template <index_type N_SIZE>
+     SpDenseDofMap<N_SIZE>::SpDenseDofMap()
+          :iSize(0), pPrev(pActive) {
+          pActive = this;
+     }
+
+     template <index_type N_SIZE>
+     SpDenseDofMap<N_SIZE>::~SpDenseDofMap() {
+          SP_GRAD_ASSERT(pActive == this);
+          pActive = pPrev;
+     }
+
+     template <index_type N_SIZE>
+     index_type SpDenseDofMap<N_SIZE>::iGetLocalDof(index_type iDof) {
+          // Only a few dofs per element, and nodes are seeding
+          // their dofs in a row: a linear search is good enough.
+          for (index_type i = iSize - 1; i >= 0; --i) {
+               if (rgGlobalDof[i] == iDof) {
+                    return i;
+               }
+          }
+
+          if (iSize >= N_SIZE) {
+               util::SpDenseDofMapSizeError(iDof, N_SIZE);
+          }
+
+          rgGlobalDof[iSize] = iDof;
+
+          return iSize++;
+     }
+
+     template <index_type N_SIZE>
+     SpDenseDofMap<N_SIZE>& SpDenseDofMap<N_SIZE>::GetActive() {
+          if (!pActive) {
+               util::SpDenseDofMapNotActive();
+          }
+
+          return *pActive;
+     }
+
+     template <index_type N_SIZE>
+     SpDenseGradient<N_SIZE>::SpDenseGradient(doublereal dVal, doublereal dCoefU, const SpDenseGradient& u)
+          :dVal(dVal) {
+          for (index_type i = 0; i < N_SIZE; ++i) {
+               rgDer[i] = dCoefU * u.rgDer[i];
+          }
+     }
+
+     template <index_type N_SIZE>
+     SpDenseGradient<N_SIZE>::SpDenseGradient(doublereal dVal, doublereal dCoefU, const SpDenseGradient& u, doublereal dCoefV, const SpDenseGradient& v)
+          :dVal(dVal) {
+          for (index_type i = 0; i < N_SIZE; ++i) {
+               rgDer[i] = dCoefU * u.rgDer[i] + dCoefV * v.rgDer[i];
+          }
+     }
+
+     template <index_type N_SIZE>
+     void SpDenseGradient<N_SIZE>::Reset(doublereal dNewVal, index_type iDof, doublereal dDer) {
+          dVal = dNewVal;
+          ZeroDeriv();
+          rgDer[SpDenseDofMap<N_SIZE>::GetActive().iGetLocalDof(iDof)] = dDer;
+     }
+
+     template <index_type N_SIZE>
+     void SpDenseGradient<N_SIZE>::Reset(const SpGradient& g) {
+          dVal = g.dGetValue();
+          ZeroDeriv();
+
+          SpDenseDofMap<N_SIZE>& oDofMap = SpDenseDofMap<N_SIZE>::GetActive();
+
+          for (const auto& r: g) {
+               rgDer[oDofMap.iGetLocalDof(r.iDof)] += r.dDer;
+          }
+     }
+
+     template <index_type N_SIZE>
+     void SpDenseGradient<N_SIZE>::Rescale(doublereal dNewVal, doublereal dCoef) {
+          dVal = dNewVal;
+
+          for (index_type i = 0; i < N_SIZE; ++i) {
+               rgDer[i] *= dCoef;
+          }
+     }
+
+     template <index_type N_SIZE>
+     void SpDenseGradient<N_SIZE>::ZeroDeriv() {
+          for (index_type i = 0; i < N_SIZE; ++i) {
+               rgDer[i] = 0.;
+          }
+     }
+
+     template <index_type N_SIZE>
+     SpDenseGradient<N_SIZE>& SpDenseGradient<N_SIZE>::operator+=(const SpDenseGradient& oExpr) {
+          return AssignOper<SpGradBinPlus>(oExpr);
+     }
+
+     template <index_type N_SIZE>
+     SpDenseGradient<N_SIZE>& SpDenseGradient<N_SIZE>::operator-=(const SpDenseGradient& oExpr) {
+          return AssignOper<SpGradBinMinus>(oExpr);
+     }
+
+     template <index_type N_SIZE>
+     SpDenseGradient<N_SIZE>& SpDenseGradient<N_SIZE>::operator*=(const SpDenseGradient& oExpr) {
+          return AssignOper<SpGradBinMult>(oExpr);
+     }
+
+     template <index_type N_SIZE>
+     SpDenseGradient<N_SIZE>& SpDenseGradient<N_SIZE>::operator/=(const SpDenseGradient& oExpr) {
+          return AssignOper<SpGradBinDiv>(oExpr);
+     }
+
+     template <index_type N_SIZE>
+     void SpDenseGradient<N_SIZE>::InsertDeriv(SpDenseGradient& g, doublereal dCoef) const {
+          for (index_type i = 0; i < N_SIZE; ++i) {
+               g.rgDer[i] += rgDer[i] * dCoef;
+          }
+     }
+
+     template <index_type N_SIZE>
+     template <typename BinFunc>
+     SpDenseGradient<N_SIZE>& SpDenseGradient<N_SIZE>::AssignOper(const SpDenseGradient& oExpr) {
+          const doublereal uv = dGetValue();
+          const doublereal vv = oExpr.dGetValue();
+          const doublereal df_du = BinFunc::df_du(uv, vv);
+          const doublereal df_dv = BinFunc::df_dv(uv, vv);
+
+          dVal = BinFunc::f(uv, vv);
+
+          for (index_type i = 0; i < N_SIZE; ++i) {
+               rgDer[i] = df_du * rgDer[i] + df_dv * oExpr.rgDer[i];
+          }
+
+          return *this;
+     }
+
+     template <index_type N_SIZE>
+     template <typename AITER, typename BITER>
+     void SpDenseGradient<N_SIZE>::MapInnerProduct(AITER pAFirst, AITER pALast, index_type iAOffset, BITER pBFirst, BITER pBLast, index_type iBOffset) {
+          SP_GRAD_ASSERT((pBLast - pBFirst) / iBOffset == (pALast - pAFirst) / iAOffset);
+          SP_GRAD_ASSERT((pALast - pAFirst) % iAOffset == 0);
+          SP_GRAD_ASSERT((pBLast - pBFirst) % iBOffset == 0);
+
+          Reset();
+
+          while (pAFirst < pALast) {
+               const auto& ai = *pAFirst;
+               const auto& bi = *pBFirst;
+               const doublereal aiv = dGetValue(ai);
+               const doublereal biv = dGetValue(bi);
+
+               dVal += aiv * biv;
+
+               InnerProductAddDer(ai, biv);
+               InnerProductAddDer(bi, aiv);
+
+               pAFirst += iAOffset;
+               pBFirst += iBOffset;
+          }
+     }
+
+     template <index_type N_SIZE>
+     void SpDenseGradient<N_SIZE>::InnerProductAddDer(const SpDenseGradient& g, const doublereal dCoef) {
+          for (index_type i = 0; i < N_SIZE; ++i) {
+               rgDer[i] += dCoef * g.rgDer[i];
+          }
+     }
+
+#ifdef SP_GRAD_DEBUG
+     template <index_type N_SIZE>
+     bool SpDenseGradient<N_SIZE>::bValid() const {
+          for (index_type i = 0; i < N_SIZE; ++i) {
+               if (!std::isfinite(rgDer[i])) {
+                    return false;
+               }
+          }
+
+          return std::isfinite(dVal);
+     }
+#endif
 }
 #endif
@@ -0,0 +1,164 @@
+/*
+ * MBDyn (C) is a multibody analysis code.
+ * http://www.mbdyn.org
+ *
+ * Copyright (C) 1996-2023
+ *
+ * Pierangelo Masarati	<pierangelo.masarati@polimi.it>
+ * Paolo Mantegazza	<paolo.mantegazza@polimi.it>
+ *
+ * Dipartimento di Ingegneria Aerospaziale - Politecnico di Milano
+ * via La Masa, 34 - 20156 Milano, Italy
+ * http://www.aero.polimi.it
+ *
+ * Changing this copyright notice is forbidden.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation (version 2 of the License).
+ *
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "mbconfig.h"           /* This goes first in every *.c,*.cc file */
+
+#include <cstdlib>
+#include <new>
+
+#include "sp_gradient_arena.h"
+
+namespace sp_grad {
+     namespace {
+          constexpr size_t uAlign = 16;
+          constexpr size_t uChunkSize = size_t(1) << 18;
+          // larger blocks go to the heap in order to keep the chunks dense
+          constexpr size_t uMaxBlockSize = uChunkSize / 16;
+
+          constexpr size_t uRoundUp(size_t uSize) {
+               return (uSize + uAlign - 1) & ~(uAlign - 1);
+          }
+
+          // each block is preceded by a pointer to its chunk
+          constexpr size_t uHeaderSize = uRoundUp(sizeof(void*));
+     }
+
+     struct SpGradientArena::Chunk {
+          // one reference held by the owning thread plus one per live block
+#ifdef SP_GRAD_THREAD_SAFE
+          std::atomic<long> iRefCnt;
+#else
+          long iRefCnt;
+#endif
+     };
+
+     SP_GRAD_THREAD_LOCAL SpGradientArena::State SpGradientArena::oState = {nullptr, 0, 0, 0, 0};
+
+     SpGradientArena::State::~State()
+     {
+          if (pChunk) {
+               Release(pChunk);
+          }
+     }
+
+     void* SpGradientArena::pAllocate(size_t uSize)
+     {
+          State& s = oState;
+
+          if (!s.uDepth) {
+               return nullptr;
+          }
+
+          const size_t uBlockSize = uHeaderSize + uRoundUp(uSize);
+
+          if (uBlockSize > uMaxBlockSize) {
+               return nullptr;
+          }
+
+          if (!s.pChunk) {
+               NewChunk(s);
+          } else if (s.uOffset + uBlockSize > uChunkSize) {
+               if (s.pChunk->iRefCnt == 1) {
+                    s.uOffset = uRoundUp(sizeof(Chunk));
+               } else {
+                    NewChunk(s);
+               }
+          }
+
+          char* pBlock = reinterpret_cast<char*>(s.pChunk) + s.uOffset;
+
+          *reinterpret_cast<Chunk**>(pBlock) = s.pChunk;
+          ++s.pChunk->iRefCnt;
+
+          s.uOffset += uBlockSize;
+          s.uUsed += uBlockSize;
+
+          return pBlock + uHeaderSize;
+     }
+
+     void SpGradientArena::Free(void* p)
+     {
+          SP_GRAD_ASSERT(p != nullptr);
+
+          Release(*reinterpret_cast<Chunk**>(reinterpret_cast<char*>(p) - uHeaderSize));
+     }
+
+     void SpGradientArena::Enter()
+     {
+          State& s = oState;
+
+          if (s.uDepth++ == 0) {
+               // nobody else can take a reference to our chunk,
+               // so it is safe to rewind it if we hold the last one
+               if (s.pChunk && s.pChunk->iRefCnt == 1) {
+                    s.uOffset = uRoundUp(sizeof(Chunk));
+               }
+
+               s.uUsed = 0;
+          }
+     }
+
+     void SpGradientArena::Leave()
+     {
+          State& s = oState;
+
+          SP_GRAD_ASSERT(s.uDepth > 0);
+
+          if (--s.uDepth == 0 && s.uUsed > s.uPeak) {
+               s.uPeak = s.uUsed;
+          }
+     }
+
+     void SpGradientArena::NewChunk(State& s)
+     {
+          void* pMem = std::malloc(uChunkSize);
+
+          if (!pMem) {
+               throw std::bad_alloc();
+          }
+
+          if (s.pChunk) {
+               Release(s.pChunk);
+          }
+
+          s.pChunk = new(pMem) Chunk;
+          s.pChunk->iRefCnt = 1;
+          s.uOffset = uRoundUp(sizeof(Chunk));
+     }
+
+     void SpGradientArena::Release(Chunk* pChunk)
+     {
+          SP_GRAD_ASSERT(pChunk->iRefCnt > 0);
+
+          if (--pChunk->iRefCnt == 0) {
+               std::free(pChunk);
+          }
+     }
+}
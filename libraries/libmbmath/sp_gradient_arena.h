@@ -0,0 +1,98 @@
+/*
+ * MBDyn (C) is a multibody analysis code.
+ * http://www.mbdyn.org
+ *
+ * Copyright (C) 1996-2023
+ *
+ * Pierangelo Masarati	<pierangelo.masarati@polimi.it>
+ * Paolo Mantegazza	<paolo.mantegazza@polimi.it>
+ *
+ * Dipartimento di Ingegneria Aerospaziale - Politecnico di Milano
+ * via La Masa, 34 - 20156 Milano, Italy
+ * http://www.aero.polimi.it
+ *
+ * Changing this copyright notice is forbidden.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation (version 2 of the License).
+ *
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef ___SP_GRADIENT_ARENA_H__INCLUDED___
+#define ___SP_GRADIENT_ARENA_H__INCLUDED___
+
+#include <cstddef>
+
+#include "sp_gradient_base.h"
+
+namespace sp_grad {
+     /*
+      * Per-thread bump allocator for the derivative storage of the
+      * temporary SpGradient objects created while an element
+      * contributes to the Jacobian matrix.
+      *
+      * Memory is taken from the arena only while a Scope is alive
+      * in the current thread; otherwise, and for large blocks,
+      * SpGradient falls back to the heap.  Each block keeps a reference
+      * to its chunk, so gradients which outlive the scope
+      * (e.g. those stored in the work matrix) remain valid and may
+      * be released by any thread.  When the outermost scope is entered
+      * and no block of the current chunk is alive any more, the chunk
+      * is rewound; otherwise it is retired as soon as it is full,
+      * and freed when its last block is released.
+      */
+     class SpGradientArena {
+     public:
+          class Scope {
+          public:
+               Scope() { Enter(); }
+               ~Scope() { Leave(); }
+
+               Scope(const Scope&) = delete;
+               Scope& operator=(const Scope&) = delete;
+          };
+
+          static bool bIsActive() { return oState.uDepth > 0; }
+
+          // returns nullptr if the block must be allocated on the heap
+          static void* pAllocate(size_t uSize);
+          static void Free(void* p);
+
+          // peak number of bytes taken from the arena by a single
+          // outermost scope of the current thread since the last reset
+          static size_t uGetPeak() { return oState.uPeak; }
+          static void ResetPeak() { oState.uPeak = 0; }
+
+     private:
+          struct Chunk;
+
+          struct State {
+               Chunk* pChunk;
+               size_t uOffset;
+               size_t uUsed;
+               size_t uPeak;
+               unsigned uDepth;
+
+               ~State();
+          };
+
+          static void Enter();
+          static void Leave();
+          static void NewChunk(State& s);
+          static void Release(Chunk* pChunk);
+
+          static SP_GRAD_THREAD_LOCAL State oState;
+     };
+}
+
+#endif
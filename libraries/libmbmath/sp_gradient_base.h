@@ -108,6 +108,9 @@ namespace sp_grad {
      class SpGradient;
      class GpGradProd;
 
+     template <index_type N_SIZE>
+     class SpDenseGradient;
+
      template <typename ValueType>
      class SpMatrixData;
 
@@ -144,6 +147,28 @@ namespace sp_grad {
 
           template <>
           struct ResultType<doublereal, GpGradProd>: ResultType<GpGradProd, GpGradProd> {};
+
+          template <index_type N_SIZE>
+          struct ResultType<SpDenseGradient<N_SIZE>, SpDenseGradient<N_SIZE> > {
+               typedef SpDenseGradient<N_SIZE> Type;
+          };
+
+          template <index_type N_SIZE>
+          struct ResultType<SpDenseGradient<N_SIZE>, doublereal>: ResultType<SpDenseGradient<N_SIZE>, SpDenseGradient<N_SIZE> > {};
+
+          template <index_type N_SIZE>
+          struct ResultType<doublereal, SpDenseGradient<N_SIZE> >: ResultType<SpDenseGradient<N_SIZE>, SpDenseGradient<N_SIZE> > {};
+
+          // Data types which carry their derivatives by value
+          // and are evaluated without any dof map (forward mode)
+          template <typename T>
+          struct IsForwardMode: std::false_type {};
+
+          template <>
+          struct IsForwardMode<GpGradProd>: std::true_type {};
+
+          template <index_type N_SIZE>
+          struct IsForwardMode<SpDenseGradient<N_SIZE> >: std::true_type {};
      }
 
      struct SpDerivRec {
@@ -183,7 +208,8 @@ namespace sp_grad {
           enum Flags: unsigned {
                DER_GENERAL = 0x0u,
                DER_SORTED = 0x1u,
-               DER_UNIQUE = 0x2u
+               DER_UNIQUE = 0x2u,
+               DER_ARENA = 0x4u // memory owned by SpGradientArena
           };
      private:
           doublereal dVal;
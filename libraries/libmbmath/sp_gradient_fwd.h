@@ -143,6 +143,12 @@ namespace sp_grad {
           static inline index_type iGetLocalSize() { return 1; }
      };
 
+     template <index_type N_SIZE>
+     class SpGradExpDofMapHelper<SpDenseGradient<N_SIZE> >: public util::SpGradExpDofMapHelperGeneric<SpDenseGradient<N_SIZE>, SpGradExpDofMapHelper<doublereal> >  {
+     public:
+          static inline index_type iGetLocalSize() { return N_SIZE; }
+     };
+
      template <>
      class SpGradExpDofMapHelper<SpGradient>: public SpGradExpDofMapHelper<doublereal> {
      public:
@@ -280,6 +286,28 @@ namespace sp_grad {
           inline static void ZeroInit(GpGradProd&) {}
      };
 
+     template <index_type N_SIZE>
+     struct SpGradientTraits<SpDenseGradient<N_SIZE> > {
+          static inline doublereal
+          dGetValue(const SpDenseGradient<N_SIZE>& a) { return a.dGetValue(); }
+
+          static inline index_type
+          iGetSize(const SpDenseGradient<N_SIZE>& a) { return N_SIZE; }
+
+          static inline void InsertDeriv(const SpDenseGradient<N_SIZE>& f, SpDenseGradient<N_SIZE>& g, doublereal dCoef) { f.InsertDeriv(g, dCoef); }
+          static inline void InsertDeriv(const doublereal& f, SpDenseGradient<N_SIZE>& g, doublereal dCoef) noexcept {}
+          static inline void ResizeReset(SpDenseGradient<N_SIZE>& g, doublereal dVal, index_type) { g.Reset(dVal); }
+
+          template <typename Expr, index_type NumRows, index_type NumCols>
+          static constexpr inline bool bHaveRefTo(const SpMatrixBase<Expr, NumRows, NumCols>& A) { return false; }
+
+          template <index_type NumRows, index_type NumCols>
+          static inline bool bHaveRefTo(const SpDenseGradient<N_SIZE>& g, const SpMatrixBase<SpDenseGradient<N_SIZE>, NumRows, NumCols>& A) { return false; }
+
+          inline static bool bIsUnique(const SpDenseGradient<N_SIZE>& g) { return true; }
+          inline static void ZeroInit(SpDenseGradient<N_SIZE>&) {}
+     };
+
      class SpGradient: public SpGradBase<SpGradient> {
      public:
           friend util::SpMatrixDataTraits<SpGradient>;
@@ -452,7 +480,7 @@ namespace sp_grad {
 
           inline static size_t uGetAllocSize(index_type iSizeRes);
 
-          inline static SpDerivData* pAllocMem(SpDerivData* ptr, index_type iSize);
+          inline static SpDerivData* pAllocMem(SpDerivData* ptr, index_type iSize, bool& bArena);
 
           void Allocate(index_type iSizeRes, index_type iSizeInit, unsigned uFlags);
 
@@ -610,5 +638,164 @@ namespace sp_grad {
           doublereal dVal;
           doublereal dDer;
      };
+
+     namespace util {
+          [[noreturn]] void SpDenseDofMapSizeError(index_type iDof, index_type iMaxSize);
+          [[noreturn]] void SpDenseDofMapNotActive();
+     }
+
+     // Maps the global dof indices seen by SpDenseGradient<N_SIZE> to local slots.
+     // Slots are assigned in the order in which the dofs are seeded.
+     // The innermost map constructed by the current thread is active
+     // until it goes out of scope.
+     template <index_type N_SIZE>
+     class SpDenseDofMap {
+     public:
+          inline SpDenseDofMap();
+          inline ~SpDenseDofMap();
+
+          SpDenseDofMap(const SpDenseDofMap&) = delete;
+          SpDenseDofMap& operator=(const SpDenseDofMap&) = delete;
+
+          inline index_type iGetLocalDof(index_type iDof);
+          index_type iGetGlobalDof(index_type iLocalDof) const {
+               SP_GRAD_ASSERT(iLocalDof >= 0 && iLocalDof < iSize);
+               return rgGlobalDof[iLocalDof];
+          }
+          index_type iGetSize() const { return iSize; }
+
+          static inline SpDenseDofMap& GetActive();
+
+     private:
+          index_type rgGlobalDof[N_SIZE];
+          index_type iSize;
+          SpDenseDofMap* const pPrev;
+          static SP_GRAD_THREAD_LOCAL SpDenseDofMap* pActive;
+     };
+
+     // Dense forward mode gradient with a fixed number of derivatives.
+     // Intended for elements with a number of dofs known at compile time;
+     // no heap memory is used and no dof indices must be merged.
+     // Global dofs are mapped to local slots by the active SpDenseDofMap<N_SIZE>.
+     template <index_type N_SIZE>
+     class SpDenseGradient {
+     public:
+          static_assert(N_SIZE > 0, "invalid number of derivatives");
+
+          static constexpr SpGradCommon::ExprEvalFlags eExprEvalFlags = SpGradCommon::ExprEvalDuplicate;
+          static constexpr index_type iNumDerivStatic = N_SIZE;
+
+          explicit SpDenseGradient(doublereal dVal = 0.)
+               :dVal(dVal) {
+               ZeroDeriv();
+          }
+
+          SpDenseGradient(doublereal dVal, index_type iDof, doublereal dDer) {
+               Reset(dVal, iDof, dDer);
+          }
+
+          // f = dVal, df = dCoefU * du
+          inline SpDenseGradient(doublereal dVal, doublereal dCoefU, const SpDenseGradient& u);
+
+          // f = dVal, df = dCoefU * du + dCoefV * dv
+          inline SpDenseGradient(doublereal dVal, doublereal dCoefU, const SpDenseGradient& u, doublereal dCoefV, const SpDenseGradient& v);
+
+          void Reset(doublereal dNewVal = 0.) {
+               dVal = dNewVal;
+               ZeroDeriv();
+          }
+
+          inline void Reset(doublereal dNewVal, index_type iDof, doublereal dDer);
+
+          // f = g, df = dg with the dofs of g mapped by the active SpDenseDofMap
+          inline void Reset(const SpGradient& g);
+
+          // f = dNewVal, df = dCoef * df
+          inline void Rescale(doublereal dNewVal, doublereal dCoef);
+
+          template <typename AITER, typename BITER>
+          inline void
+          MapInnerProduct(AITER pAFirst,
+                          AITER pALast,
+                          index_type iAOffset,
+                          BITER pBFirst,
+                          BITER pBLast,
+                          index_type iBOffset);
+
+          doublereal dGetValue() const {
+               return dVal;
+          }
+
+          static inline constexpr doublereal dGetValue(doublereal dVal) {
+               return dVal;
+          }
+
+          static inline doublereal dGetValue(const SpDenseGradient& g) {
+               return g.dGetValue();
+          }
+
+          // derivative with respect to the local slot iLocalDof (zero based)
+          doublereal dGetDerivLocal(index_type iLocalDof) const {
+               SP_GRAD_ASSERT(iLocalDof >= 0 && iLocalDof < N_SIZE);
+               return rgDer[iLocalDof];
+          }
+
+          SpDenseGradient& operator+=(doublereal dCoef) {
+               dVal += dCoef;
+
+               return *this;
+          }
+
+          SpDenseGradient& operator-=(doublereal dCoef) {
+               dVal -= dCoef;
+
+               return *this;
+          }
+
+          SpDenseGradient& operator*=(doublereal dCoef) {
+               Rescale(dVal * dCoef, dCoef);
+
+               return *this;
+          }
+
+          SpDenseGradient& operator/=(doublereal dCoef) {
+               Rescale(dVal / dCoef, 1. / dCoef);
+
+               return *this;
+          }
+
+          inline SpDenseGradient& operator+=(const SpDenseGradient& oExpr);
+
+          inline SpDenseGradient& operator-=(const SpDenseGradient& oExpr);
+
+          inline SpDenseGradient& operator*=(const SpDenseGradient& oExpr);
+
+          inline SpDenseGradient& operator/=(const SpDenseGradient& oExpr);
+
+          static constexpr bool bIsScalarConst = false;
+
+          inline void InsertDeriv(SpDenseGradient& g, doublereal dCoef) const;
+
+          template <index_type NumRows, index_type NumCols>
+          static inline bool bHaveRefTo(const SpMatrixBase<SpDenseGradient, NumRows, NumCols>& A) {
+               return false;
+          }
+
+          template <typename BinFunc>
+          inline SpDenseGradient& AssignOper(const SpDenseGradient& oExpr);
+
+#ifdef SP_GRAD_DEBUG
+          inline bool bValid() const;
+#endif
+     private:
+          inline void ZeroDeriv();
+
+          inline void InnerProductAddDer(const SpDenseGradient& g, const doublereal dCoef);
+
+          inline void InnerProductAddDer(doublereal, doublereal) {}
+
+          doublereal dVal;
+          doublereal rgDer[N_SIZE];
+     };
 }
 #endif
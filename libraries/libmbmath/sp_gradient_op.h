@@ -232,5 +232,112 @@ namespace sp_grad {
 #ifdef SP_GRAD_DEBUG
      std::ostream& operator<<(std::ostream& os, const GpGradProd& g);
 #endif
+
+     template <index_type N_SIZE>
+     constexpr inline const SpDenseGradient<N_SIZE>&
+     EvalUnique(const SpDenseGradient<N_SIZE>& g) noexcept {
+          return g;
+     }
+
+#define GRAD_DENSE_DEFINE_BINARY_OPERATOR_CONST_ARG_RHS(SP_GRAD_OP_FUNC, SP_GRAD_OP_CLASS, SP_CONST_ARG_TYPE) \
+     template <index_type N_SIZE>                                       \
+     inline SpDenseGradient<N_SIZE>                                     \
+     SP_GRAD_OP_FUNC(const SpDenseGradient<N_SIZE>& u, SP_CONST_ARG_TYPE v) noexcept { \
+          return SpDenseGradient<N_SIZE>(SP_GRAD_OP_CLASS::f(u.dGetValue(), v), SP_GRAD_OP_CLASS::df_du(u.dGetValue(), v), u); \
+     }
+
+#define GRAD_DENSE_DEFINE_BINARY_OPERATOR_CONST_ARG_LHS(SP_GRAD_OP_FUNC, SP_GRAD_OP_CLASS, SP_CONST_ARG_TYPE) \
+     template <index_type N_SIZE>                                       \
+     inline SpDenseGradient<N_SIZE>                                     \
+     SP_GRAD_OP_FUNC(SP_CONST_ARG_TYPE u, const SpDenseGradient<N_SIZE>& v) noexcept { \
+          return SpDenseGradient<N_SIZE>(SP_GRAD_OP_CLASS::f(u, v.dGetValue()), SP_GRAD_OP_CLASS::df_dv(u, v.dGetValue()), v); \
+     }
+
+#define GRAD_DENSE_DEFINE_BINARY_OPERATOR(SP_GRAD_OP_FUNC, SP_GRAD_OP_CLASS) \
+     GRAD_DENSE_DEFINE_BINARY_OPERATOR_CONST_ARG_LHS(SP_GRAD_OP_FUNC, SP_GRAD_OP_CLASS, doublereal) \
+     GRAD_DENSE_DEFINE_BINARY_OPERATOR_CONST_ARG_RHS(SP_GRAD_OP_FUNC, SP_GRAD_OP_CLASS, doublereal) \
+                                                                        \
+     template <index_type N_SIZE>                                       \
+     inline SpDenseGradient<N_SIZE>                                     \
+     SP_GRAD_OP_FUNC(const SpDenseGradient<N_SIZE>& u, const SpDenseGradient<N_SIZE>& v) noexcept { \
+          return SpDenseGradient<N_SIZE>(SP_GRAD_OP_CLASS::f(u.dGetValue(), v.dGetValue()), SP_GRAD_OP_CLASS::df_du(u.dGetValue(), v.dGetValue()), u, SP_GRAD_OP_CLASS::df_dv(u.dGetValue(), v.dGetValue()), v); \
+     }
+
+#define GRAD_DENSE_DEFINE_UNARY_OPERATOR(SP_GRAD_OP_FUNC, SP_GRAD_OP_CLASS) \
+     template <index_type N_SIZE>                                       \
+     inline SpDenseGradient<N_SIZE>                                     \
+     SP_GRAD_OP_FUNC(const SpDenseGradient<N_SIZE>& u) noexcept {      \
+          return SpDenseGradient<N_SIZE>(SP_GRAD_OP_CLASS::f(u.dGetValue()), SP_GRAD_OP_CLASS::df_du(u.dGetValue()), u); \
+     }
+
+#define GRAD_DENSE_DEFINE_BOOL_BINARY_OPERATOR(SP_GRAD_OP_FUNC, SP_GRAD_OP_CLASS) \
+     template <index_type N_SIZE>                                       \
+     inline bool                                                        \
+     SP_GRAD_OP_FUNC(doublereal u, const SpDenseGradient<N_SIZE>& v) noexcept { \
+          return SP_GRAD_OP_CLASS::f(u, v.dGetValue());                \
+     }                                                                  \
+                                                                        \
+     template <index_type N_SIZE>                                       \
+     inline bool                                                        \
+     SP_GRAD_OP_FUNC(const SpDenseGradient<N_SIZE>& u, doublereal v) noexcept { \
+          return SP_GRAD_OP_CLASS::f(u.dGetValue(), v);                \
+     }                                                                  \
+                                                                        \
+     template <index_type N_SIZE>                                       \
+     inline bool                                                        \
+     SP_GRAD_OP_FUNC(const SpDenseGradient<N_SIZE>& u, const SpDenseGradient<N_SIZE>& v) noexcept { \
+          return SP_GRAD_OP_CLASS::f(u.dGetValue(), v.dGetValue());    \
+     }
+
+     GRAD_DENSE_DEFINE_BINARY_OPERATOR(operator +, SpGradBinPlus)
+     GRAD_DENSE_DEFINE_BINARY_OPERATOR(operator -, SpGradBinMinus)
+     GRAD_DENSE_DEFINE_BINARY_OPERATOR(operator *, SpGradBinMult)
+     GRAD_DENSE_DEFINE_BINARY_OPERATOR(operator /, SpGradBinDiv)
+     GRAD_DENSE_DEFINE_BINARY_OPERATOR(pow, SpGradBinPow)
+     GRAD_DENSE_DEFINE_BINARY_OPERATOR(atan2, SpGradBinAtan2)
+     GRAD_DENSE_DEFINE_BINARY_OPERATOR(copysign, SpGradBinCopysign)
+     GRAD_DENSE_DEFINE_BINARY_OPERATOR(fmod, SpGradBinFmod)
+     GRAD_DENSE_DEFINE_BINARY_OPERATOR(min, SpGradBinMin)
+     GRAD_DENSE_DEFINE_BINARY_OPERATOR(max, SpGradBinMax)
+
+     GRAD_DENSE_DEFINE_BINARY_OPERATOR_CONST_ARG_RHS(pow, SpGradBinPowInt, integer)
+
+     GRAD_DENSE_DEFINE_BOOL_BINARY_OPERATOR(operator <, SpGradBoolLessThan)
+     GRAD_DENSE_DEFINE_BOOL_BINARY_OPERATOR(operator <=, SpGradBoolLessEqual)
+     GRAD_DENSE_DEFINE_BOOL_BINARY_OPERATOR(operator >, SpGradBoolGreaterThan)
+     GRAD_DENSE_DEFINE_BOOL_BINARY_OPERATOR(operator >=, SpGradBoolGreaterEqual)
+     GRAD_DENSE_DEFINE_BOOL_BINARY_OPERATOR(operator ==, SpGradBoolEqualTo)
+     GRAD_DENSE_DEFINE_BOOL_BINARY_OPERATOR(operator !=, SpGradBoolNotEqualTo)
+
+     GRAD_DENSE_DEFINE_UNARY_OPERATOR(operator-, SpGradUnaryMinus)
+     GRAD_DENSE_DEFINE_UNARY_OPERATOR(fabs, SpGradFabs)
+     GRAD_DENSE_DEFINE_UNARY_OPERATOR(sqrt, SpGradSqrt)
+     GRAD_DENSE_DEFINE_UNARY_OPERATOR(exp, SpGradExp)
+     GRAD_DENSE_DEFINE_UNARY_OPERATOR(log, SpGradLog)
+     GRAD_DENSE_DEFINE_UNARY_OPERATOR(sin, SpGradSin)
+     GRAD_DENSE_DEFINE_UNARY_OPERATOR(cos, SpGradCos)
+     GRAD_DENSE_DEFINE_UNARY_OPERATOR(tan, SpGradTan)
+     GRAD_DENSE_DEFINE_UNARY_OPERATOR(sinh, SpGradSinh)
+     GRAD_DENSE_DEFINE_UNARY_OPERATOR(cosh, SpGradCosh)
+     GRAD_DENSE_DEFINE_UNARY_OPERATOR(tanh, SpGradTanh)
+     GRAD_DENSE_DEFINE_UNARY_OPERATOR(asin, SpGradAsin)
+     GRAD_DENSE_DEFINE_UNARY_OPERATOR(acos, SpGradAcos)
+     GRAD_DENSE_DEFINE_UNARY_OPERATOR(atan, SpGradAtan)
+     GRAD_DENSE_DEFINE_UNARY_OPERATOR(asinh, SpGradAsinh)
+     GRAD_DENSE_DEFINE_UNARY_OPERATOR(acosh, SpGradAcosh)
+     GRAD_DENSE_DEFINE_UNARY_OPERATOR(atanh, SpGradAtanh)
+
+#ifdef SP_GRAD_DEBUG
+     template <index_type N_SIZE>
+     std::ostream& operator<<(std::ostream& os, const SpDenseGradient<N_SIZE>& g) {
+          os << "f=(" << g.dGetValue() << ") df=(";
+
+          for (index_type i = 0; i < N_SIZE; ++i) {
+               os << (i ? " " : "") << g.dGetDerivLocal(i);
+          }
+
+          return os << ")";
+     }
+#endif
 }
 #endif
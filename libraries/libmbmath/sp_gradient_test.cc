@@ -46,6 +46,7 @@
 #endif // HAVE_FENV_H
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <chrono>
 #include <cmath>
@@ -56,8 +57,12 @@
 #include <memory>
 #include <random>
 #include <string>
+#ifdef USE_MULTITHREAD
+#include <thread>
+#endif
 #include <vector>
 
+#include "except.h"
 #include "submat.h"
 #include "matvec3.h"
 #include "matvec6.h"
@@ -149,6 +154,37 @@ namespace sp_grad_test {
           }
      }
 
+     template <index_type N_SIZE>
+     void sp_grad_dense_copy(const SpGradient& g, SpDenseGradient<N_SIZE>& d) {
+          d.Reset(g.dGetValue());
+
+          for (const auto& r: g) {
+               d += SpDenseGradient<N_SIZE>(0., r.iDof, r.dDer);
+          }
+     }
+
+     template <index_type N_SIZE>
+     void sp_grad_assert_equal(const SpDenseGradient<N_SIZE>& u, const SpGradient& v, const SpDenseDofMap<N_SIZE>& oDofMap, doublereal dTol) {
+          sp_grad_assert_equal(u.dGetValue(), v.dGetValue(), dTol);
+
+          for (index_type i = 0; i < N_SIZE; ++i) {
+               const doublereal vi = i < oDofMap.iGetSize() ? v.dGetDeriv(oDofMap.iGetGlobalDof(i)) : 0.;
+
+               sp_grad_assert_equal(u.dGetDerivLocal(i), vi, dTol);
+          }
+
+          // a dof which has not been mapped must not have a derivative
+          for (const auto& r: v) {
+               index_type i = 0;
+
+               while (i < oDofMap.iGetSize() && oDofMap.iGetGlobalDof(i) != r.iDof) {
+                    ++i;
+               }
+
+               assert(i < oDofMap.iGetSize() || r.dDer == 0.);
+          }
+     }
+
      void testx() {
           SpMatrix<doublereal> A(3, 3, 0);
           SpMatrix<doublereal, 3, 3> B(3, 3, 0);
@@ -4316,6 +4352,349 @@ namespace sp_grad_test {
           sp_grad_assert_equal(f45, fref, dTol);
           sp_grad_assert_equal(f46, fref, dTol);
      }
+
+     template <typename T>
+     void func_scalar_dense(const T& u, const T& v, const T& w, T& f) {
+          using std::exp;
+          using std::log;
+          using std::sqrt;
+          using std::atan;
+          using std::fabs;
+          using std::pow;
+          using std::fmod;
+
+          f = exp(u) * log(1. + fabs(v)) + sqrt(1. + w * w) - atan(u * v) + pow(fabs(w) + 1., u) - fmod(u, 0.3);
+          f -= u;
+          f *= v - w;
+          f /= 2. + v * v;
+          f = -f;
+     }
+
+     void test20(index_type inumloops, index_type inumnz, index_type inumdof)
+     {
+          using namespace std;
+
+          cerr << __PRETTY_FUNCTION__ << ":\n";
+
+          constexpr index_type N = iNumDerivDense;
+
+          random_device rd;
+          mt19937 gen(rd());
+          uniform_real_distribution<doublereal> randval(-0.5, 0.5);
+          // not more than N different dofs are used by u, v and w
+          uniform_int_distribution<index_type> randdof(max(inumdof, N) - N + 1, max(inumdof, N));
+          uniform_int_distribution<index_type> randnz(0, inumnz - 1);
+
+          gen.seed(0);
+
+          SpGradient u, v, w, f;
+          SpDenseGradient<N> ud, vd, wd, fd;
+
+          const doublereal e = randval(gen);
+          const doublereal dTol = sqrt(std::numeric_limits<doublereal>::epsilon());
+
+          for (index_type iloop = 0; iloop < inumloops; ++iloop) {
+               sp_grad_rand_gen(u, randnz, randdof, randval, gen);
+               sp_grad_rand_gen(v, randnz, randdof, randval, gen);
+               sp_grad_rand_gen(w, randnz, randdof, randval, gen);
+
+               SpDenseDofMap<N> oDofMap;
+
+               sp_grad_dense_copy(u, ud);
+               sp_grad_dense_copy(v, vd);
+               sp_grad_dense_copy(w, wd);
+
+               func_scalar1(u, v, w, e, f);
+               func_scalar1(ud, vd, wd, e, fd);
+
+               sp_grad_assert_equal(fd, f, oDofMap, dTol);
+
+               func_scalar2(u, v, w, e, f);
+               func_scalar2(ud, vd, wd, e, fd);
+
+               sp_grad_assert_equal(fd, f, oDofMap, dTol);
+
+               func_scalar3(u, v, w, e, f);
+               func_scalar3(ud, vd, wd, e, fd);
+
+               sp_grad_assert_equal(fd, f, oDofMap, dTol);
+
+               func_scalar_dense(u, v, w, f);
+               func_scalar_dense(ud, vd, wd, fd);
+
+               sp_grad_assert_equal(fd, f, oDofMap, dTol);
+          }
+
+          cerr << "test20: test passed with tolerance "
+               << scientific << setprecision(6)
+               << dTol
+               << endl;
+     }
+
+     void test20b()
+     {
+          using namespace std;
+
+          cerr << __PRETTY_FUNCTION__ << ":\n";
+
+          constexpr index_type N = 3;
+
+          bool bThrown = false;
+
+          try {
+               SpDenseGradient<N> a(1., 7, 1.);
+          } catch (const ErrGeneric&) {
+               bThrown = true;
+          }
+
+          // no map is active
+          assert(bThrown);
+
+          {
+               SpDenseDofMap<N> oOuter;
+
+               SpDenseGradient<N> a(1., 10, 2.), b(2., 5, 3.);
+
+               // slots are assigned in the order of seeding
+               assert(oOuter.iGetSize() == 2);
+               assert(oOuter.iGetGlobalDof(0) == 10);
+               assert(oOuter.iGetGlobalDof(1) == 5);
+               assert(a.dGetDerivLocal(0) == 2. && a.dGetDerivLocal(1) == 0.);
+               assert(b.dGetDerivLocal(0) == 0. && b.dGetDerivLocal(1) == 3.);
+
+               {
+                    SpDenseDofMap<N> oInner;
+
+                    assert(&SpDenseDofMap<N>::GetActive() == &oInner);
+
+                    SpDenseGradient<N> c(3., 5, 4.);
+
+                    assert(oInner.iGetSize() == 1);
+                    assert(oInner.iGetGlobalDof(0) == 5);
+                    assert(c.dGetDerivLocal(0) == 4.);
+               }
+
+               assert(&SpDenseDofMap<N>::GetActive() == &oOuter);
+
+               SpDenseGradient<N> d(4., 5, 1.), e(5., 11, 1.);
+
+               assert(oOuter.iGetSize() == 3);
+               assert(d.dGetDerivLocal(1) == 1.);
+               assert(e.dGetDerivLocal(2) == 1.);
+
+               bThrown = false;
+
+               try {
+                    SpDenseGradient<N> f(6., 12, 1.);
+               } catch (const ErrGeneric&) {
+                    bThrown = true;
+               }
+
+               // more than N dofs
+               assert(bThrown);
+               assert(oOuter.iGetSize() == N);
+
+#ifdef USE_MULTITHREAD
+               bool bActive = true;
+
+               std::thread oThread([&bActive]() {
+                    try {
+                         SpDenseDofMap<N>::GetActive();
+                    } catch (const ErrGeneric&) {
+                         bActive = false;
+                    }
+               });
+
+               oThread.join();
+
+               // the active map is local to the thread which created it
+               assert(!bActive);
+#endif
+          }
+
+          bThrown = false;
+
+          try {
+               SpDenseDofMap<N>::GetActive();
+          } catch (const ErrGeneric&) {
+               bThrown = true;
+          }
+
+          assert(bThrown);
+     }
+
+     void test20c(index_type inumloops, index_type inumnz, index_type inumdof)
+     {
+          using namespace std;
+
+          cerr << __PRETTY_FUNCTION__ << ":\n";
+
+          constexpr index_type N = iNumDerivDense;
+
+          random_device rd;
+          mt19937 gen(rd());
+          uniform_real_distribution<doublereal> randval(-1., 1.);
+          uniform_int_distribution<index_type> randdof(max(inumdof, N) - N + 1, max(inumdof, N));
+          uniform_int_distribution<index_type> randnz(0, inumnz - 1);
+
+          gen.seed(0);
+
+          const doublereal dTol = sqrt(std::numeric_limits<doublereal>::epsilon());
+
+          for (index_type iloop = 0; iloop < inumloops; ++iloop) {
+               SpMatrix<SpGradient, 3, 3> A(3, 3, 0);
+               SpColVector<SpGradient, 3> x(3, 0);
+
+               for (auto& aij: A) {
+                    sp_grad_rand_gen(aij, randnz, randdof, randval, gen);
+               }
+
+               for (auto& xi: x) {
+                    sp_grad_rand_gen(xi, randnz, randdof, randval, gen);
+               }
+
+               SpDenseDofMap<N> oDofMap;
+
+               SpMatrix<SpDenseGradient<N>, 3, 3> Ad(3, 3, 0);
+               SpColVector<SpDenseGradient<N>, 3> xd(3, 0);
+
+               for (index_type i = 1; i <= 3; ++i) {
+                    for (index_type j = 1; j <= 3; ++j) {
+                         sp_grad_dense_copy(A(i, j), Ad(i, j));
+                    }
+
+                    sp_grad_dense_copy(x(i), xd(i));
+               }
+
+               const SpColVector<SpGradient, 3> y = A * x;
+               const SpColVector<SpDenseGradient<N>, 3> yd = Ad * xd;
+               const SpColVector<SpGradient, 3> z = Transpose(A) * x * 2. - x / 3.;
+               const SpColVector<SpDenseGradient<N>, 3> zd = Transpose(Ad) * xd * 2. - xd / 3.;
+               const SpMatrix<SpGradient, 3, 3> B = A * Transpose(A) + 2. * A;
+               const SpMatrix<SpDenseGradient<N>, 3, 3> Bd = Ad * Transpose(Ad) + 2. * Ad;
+               const SpGradient s = Dot(x, y) + Norm(x);
+               const SpDenseGradient<N> sd = Dot(xd, yd) + Norm(xd);
+
+               for (index_type i = 1; i <= 3; ++i) {
+                    sp_grad_assert_equal(yd(i), y(i), oDofMap, dTol);
+                    sp_grad_assert_equal(zd(i), z(i), oDofMap, dTol);
+
+                    for (index_type j = 1; j <= 3; ++j) {
+                         sp_grad_assert_equal(Bd(i, j), B(i, j), oDofMap, dTol);
+                    }
+               }
+
+               sp_grad_assert_equal(sd, s, oDofMap, dTol);
+          }
+
+          cerr << "test20c: test passed with tolerance "
+               << scientific << setprecision(6)
+               << dTol
+               << endl;
+     }
+
+     // Nonlinear residual which reads its dofs in the same way as the elements
+     template <index_type N_DOF>
+     class SpDenseTestElem {
+     public:
+          SpDenseTestElem(const std::array<index_type, N_DOF>& rgIndex, const SpMatrix<doublereal, N_DOF, N_DOF>& A)
+               :rgIndex(rgIndex), A(A) {
+          }
+
+          template <typename T>
+          void AssRes(SpGradientAssVec<T>& WorkVec,
+                      doublereal dCoef,
+                      const SpGradientVectorHandler<T>& XCurr,
+                      const SpGradientVectorHandler<T>& XPrimeCurr,
+                      SpFunctionCall func) {
+               SpColVector<T, N_DOF> x(N_DOF, 1), xP(N_DOF, 1);
+
+               for (index_type i = 1; i <= N_DOF; ++i) {
+                    XCurr.dGetCoef(rgIndex[i - 1], x(i), dCoef);
+                    XPrimeCurr.dGetCoef(rgIndex[i - 1], xP(i), 1.);
+               }
+
+               for (index_type i = 1; i <= N_DOF; ++i) {
+                    T ri = x(i) * x(i) - xP(i);
+
+                    for (index_type j = 1; j <= N_DOF; ++j) {
+                         ri += A(i, j) * sin(x(j)) * xP(j);
+                    }
+
+                    WorkVec.AddItem(rgIndex[i - 1], ri);
+               }
+          }
+
+     private:
+          const std::array<index_type, N_DOF> rgIndex;
+          const SpMatrix<doublereal, N_DOF, N_DOF> A;
+     };
+
+     template <index_type N_SIZE>
+     void test20d(index_type inumloops)
+     {
+          using namespace std;
+
+          cerr << __PRETTY_FUNCTION__ << ":\n";
+
+          constexpr index_type N_DOF = 6;
+          constexpr index_type iNumRows = 24;
+
+          random_device rd;
+          mt19937 gen(rd());
+          uniform_real_distribution<doublereal> randval(-1., 1.);
+
+          gen.seed(0);
+
+          const doublereal dTol = pow(std::numeric_limits<doublereal>::epsilon(), 0.9);
+          const std::array<index_type, N_DOF> rgIndex{21, 3, 15, 7, 8, 22};
+
+          MyVectorHandler X(iNumRows), XP(iNumRows);
+          FullMatrixHandler oJacRef(iNumRows, iNumRows), oJacDense(iNumRows, iNumRows);
+          SpGradientSubMatrixHandler oSubMatRef(N_DOF);
+          VariableSubMatrixHandlerNonAd oSubMatDense(N_DOF, N_SIZE);
+
+          for (index_type iloop = 0; iloop < inumloops; ++iloop) {
+               SpMatrix<doublereal, N_DOF, N_DOF> A(N_DOF, N_DOF, 0);
+
+               for (auto& aij: A) {
+                    aij = randval(gen);
+               }
+
+               for (integer i = 1; i <= iNumRows; ++i) {
+                    X(i) = randval(gen);
+                    XP(i) = randval(gen);
+               }
+
+               const doublereal dCoef = 0.5 * (randval(gen) + 1.);
+
+               SpDenseTestElem<N_DOF> oElem(rgIndex, A);
+
+               SpGradientAssVec<SpGradient>::AssJac(&oElem, oSubMatRef, dCoef, X, XP, REGULAR_JAC);
+               SpGradientAssVec<SpDenseGradient<N_SIZE> >::AssJac(&oElem, oSubMatDense, dCoef, X, XP, REGULAR_JAC);
+
+               assert(oSubMatDense.bIsFull());
+               assert(oSubMatDense.GetFull().iGetNumRows() == N_DOF);
+               assert(oSubMatDense.GetFull().iGetNumCols() == N_DOF);
+
+               oJacRef.Reset();
+               oJacDense.Reset();
+
+               oJacRef += oSubMatRef;
+               oJacDense += oSubMatDense;
+
+               for (integer i = 1; i <= iNumRows; ++i) {
+                    for (integer j = 1; j <= iNumRows; ++j) {
+                         sp_grad_assert_equal(oJacDense.dGetCoef(i, j), oJacRef.dGetCoef(i, j), dTol);
+                    }
+               }
+          }
+
+          cerr << "test20d: test passed with tolerance "
+               << scientific << setprecision(6)
+               << dTol
+               << endl;
+     }
 }
 
 int main(int argc, char* argv[])
@@ -4452,6 +4831,11 @@ int main(int argc, char* argv[])
           if (SP_GRAD_RUN_TEST(19.1)) test19();
           if (SP_GRAD_RUN_TEST(19.2)) test19b();
           if (SP_GRAD_RUN_TEST(19.3)) test19c();
+          if (SP_GRAD_RUN_TEST(20.1)) test20(inumloops, inumnz, inumdof);
+          if (SP_GRAD_RUN_TEST(20.2)) test20b();
+          if (SP_GRAD_RUN_TEST(20.3)) test20c(inumloops, inumnz, inumdof);
+          if (SP_GRAD_RUN_TEST(20.4)) test20d<6>(inumloops);
+          if (SP_GRAD_RUN_TEST(20.4)) test20d<iNumDerivDense>(inumloops);
 
           cerr << "All tests passed\n"
                << "\n\tloops performed: " << inumloops
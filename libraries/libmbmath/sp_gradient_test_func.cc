@@ -58,6 +58,9 @@ namespace sp_grad_test {
      template
      void func_scalar1<GpGradProd>(const GpGradProd& u, const GpGradProd& v, const GpGradProd& w, doublereal e, GpGradProd& f);
 
+     template
+     void func_scalar1<SpDenseGradient<iNumDerivDense> >(const SpDenseGradient<iNumDerivDense>& u, const SpDenseGradient<iNumDerivDense>& v, const SpDenseGradient<iNumDerivDense>& w, doublereal e, SpDenseGradient<iNumDerivDense>& f);
+
      template <typename T>
      void func_scalar1_compressed(const T& u, const T& v, const T& w, doublereal e, T& f) {
           f = EvalUnique(((((3 * u + 2 * v) * (u - v) / (1 - w) * pow(fabs(u/w), v - 1) * sin(v) * cos(w) * (1 - tan(-w + v))) * e + 1. - 11. + 4.5 - 1.) * 3.5 / 2.8 + u - v) * w / u);
@@ -101,6 +104,9 @@ namespace sp_grad_test {
      template
      void func_scalar2<GpGradProd>(const GpGradProd& u, const GpGradProd& v, const GpGradProd& w, doublereal e, GpGradProd& f);
 
+     template
+     void func_scalar2<SpDenseGradient<iNumDerivDense> >(const SpDenseGradient<iNumDerivDense>& u, const SpDenseGradient<iNumDerivDense>& v, const SpDenseGradient<iNumDerivDense>& w, doublereal e, SpDenseGradient<iNumDerivDense>& f);
+
      template <typename U, typename V, typename W>
      bool func_bool1(const U& u, const V& v, const W& w, doublereal e) {
           return u + v >= e * (v - w);
@@ -122,6 +128,9 @@ namespace sp_grad_test {
      template
      void func_scalar3<GpGradProd>(const GpGradProd& u, const GpGradProd& v, const GpGradProd& w, doublereal e, GpGradProd& f);
 
+     template
+     void func_scalar3<SpDenseGradient<iNumDerivDense> >(const SpDenseGradient<iNumDerivDense>& u, const SpDenseGradient<iNumDerivDense>& v, const SpDenseGradient<iNumDerivDense>& w, doublereal e, SpDenseGradient<iNumDerivDense>& f);
+
      template <typename T>
      void func_scalar3_compressed(const T& u, const T& v, const T& w, doublereal e, T& f) {
           using namespace std;
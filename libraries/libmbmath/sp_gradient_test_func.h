@@ -178,6 +178,8 @@ namespace sp_grad_test {
 
      static constexpr index_type iNumRowsStatic1 = 10, iNumColsStatic1 = 8, iNumRowsStatic2 = 7, iNumColsStatic2 = 9;
 
+     static constexpr index_type iNumDerivDense = 12;
+
      template <typename TA, typename TB, typename TC, index_type NumRows, index_type NumCols>
      void func_mat_add7(const SpMatrixBase<TA, NumRows, NumCols>& A,
                         const SpMatrixBase<TB, NumRows, NumCols>& B,
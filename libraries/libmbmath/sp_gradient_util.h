@@ -125,6 +125,23 @@ namespace sp_grad {
                                       iBOffset);
                }
 
+               template <index_type N_SIZE, typename AITER, typename BITER>
+               static void
+               MapEval(SpDenseGradient<N_SIZE>& g,
+                       AITER pAFirst,
+                       AITER pALast,
+                       index_type iAOffset,
+                       BITER pBFirst,
+                       BITER pBLast,
+                       index_type iBOffset) {
+                    g.MapInnerProduct(pAFirst,
+                                      pALast,
+                                      iAOffset,
+                                      pBFirst,
+                                      pBLast,
+                                      iBOffset);
+               }
+
                template <typename AITER, typename BITER>
                static void
                MapEval(SpGradient& g,
@@ -180,6 +197,24 @@ namespace sp_grad {
                                       pBLast,
                                       iBOffset);
                }
+
+               template <index_type N_SIZE, typename AITER, typename BITER>
+               static void
+               MapEval(SpDenseGradient<N_SIZE>& g,
+                       AITER pAFirst,
+                       AITER pALast,
+                       index_type iAOffset,
+                       BITER pBFirst,
+                       BITER pBLast,
+                       index_type iBOffset,
+                       const SpGradExpDofMapHelper<SpDenseGradient<N_SIZE> >& oDofMap) {
+                    g.MapInnerProduct(pAFirst,
+                                      pALast,
+                                      iAOffset,
+                                      pBFirst,
+                                      pBLast,
+                                      iBOffset);
+               }
                
                template <typename AITER, typename BITER>
                static void
@@ -214,6 +249,23 @@ namespace sp_grad {
                                       pBLast,
                                       iBOffset);
                }
+
+               template <index_type N_SIZE, typename AITER, typename BITER>
+               static void
+               Eval(SpDenseGradient<N_SIZE>& g,
+                    AITER pAFirst,
+                    AITER pALast,
+                    index_type iAOffset,
+                    BITER pBFirst,
+                    BITER pBLast,
+                    index_type iBOffset) {
+                    g.MapInnerProduct(pAFirst,
+                                      pALast,
+                                      iAOffset,
+                                      pBFirst,
+                                      pBLast,
+                                      iBOffset);
+               }
           };
 
           template <>
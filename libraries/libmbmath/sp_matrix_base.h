@@ -126,6 +126,12 @@ namespace sp_grad {
                static const SpGradCommon::ExprEvalFlags eExprEvalFlags = SpGradCommon::ExprEvalDuplicate;
           };
 
+          template <index_type N_SIZE, SpGradCommon::ExprEvalFlags eCompr>
+          struct ComprEvalHelper<SpDenseGradient<N_SIZE>, eCompr> {
+               // Dense gradients do not need any dof map
+               static const SpGradCommon::ExprEvalFlags eExprEvalFlags = SpGradCommon::ExprEvalDuplicate;
+          };
+
           template <typename Expr, bool bUseTempExpr>
           struct TempExprHelper;
 
@@ -2096,11 +2102,15 @@ namespace sp_grad {
           inline SpMatrixBase& operator*=(const SpGradBase<Expr>& b);
           inline SpMatrixBase& operator*=(const SpGradient& b);
           inline SpMatrixBase& operator*=(const GpGradProd& b);
+          template <index_type N_SIZE>
+          inline SpMatrixBase& operator*=(const SpDenseGradient<N_SIZE>& b);
           inline SpMatrixBase& operator*=(doublereal b);
           template <typename Expr>
           inline SpMatrixBase& operator/=(const SpGradBase<Expr>& b);
           inline SpMatrixBase& operator/=(const SpGradient& b);
           inline SpMatrixBase& operator/=(const GpGradProd& b);
+          template <index_type N_SIZE>
+          inline SpMatrixBase& operator/=(const SpDenseGradient<N_SIZE>& b);
           inline SpMatrixBase& operator/=(const doublereal b);
           template <typename ValueTypeExpr, typename Expr>
           inline SpMatrixBase& operator+=(const SpMatElemExprBase<ValueTypeExpr, Expr>& b);
@@ -2184,6 +2194,8 @@ namespace sp_grad {
           bool bValid() const;
           static bool bValid(const SpGradient& g);
           static bool bValid(const GpGradProd& g);
+          template <index_type N_SIZE>
+          static bool bValid(const SpDenseGradient<N_SIZE>& g);
           static bool bValid(doublereal d);
 #endif
      private:
@@ -3007,7 +3019,7 @@ namespace sp_grad {
           void MatEvalHelperCompr<SpGradCommon::ExprEvalDuplicate>::ElemEval(const Expr& oExpr, SpMatrixBase<ValueType, NumRows, NumCols>& A, const SpGradExpDofMapHelper<ValueType>&) {
                static_assert(eExprEvalFlags == SpGradCommon::ExprEvalDuplicate, "invalid expression flags");
 
-               constexpr bool bIsGradProd = std::is_same<ValueType, GpGradProd>::value;
+               constexpr bool bIsGradProd = util::IsForwardMode<ValueType>::value;
                constexpr bool bIsDouble = std::is_same<ValueType, doublereal>::value;
                constexpr bool bIsSpGradient = std::is_same<ValueType, SpGradient>::value;
 
@@ -3406,6 +3418,99 @@ namespace sp_grad {
                }
           };
 
+          template <index_type N_SIZE>
+          struct ElemAssignHelper<SpDenseGradient<N_SIZE>, SpDenseGradient<N_SIZE> > {
+               template <MatTranspEvalFlag eTransp, typename Func, typename ExprB, index_type NumRowsA, index_type NumColsA>
+               static inline void ElemAssignUncompr(SpMatrixBase<SpDenseGradient<N_SIZE>, NumRowsA, NumColsA>& A, const SpMatElemExprBase<SpDenseGradient<N_SIZE>, ExprB>& B) {
+                    typedef typename remove_all<ExprB>::type ExprTypeB;
+                    constexpr index_type iNumRowsStatic = ExprTypeB::iNumRowsStatic;
+                    constexpr index_type iNumColsStatic = ExprTypeB::iNumColsStatic;
+
+                    const index_type iNumRows = A.iGetNumRows();
+                    const index_type iNumCols = A.iGetNumCols();
+
+                    static_assert(NumRowsA == iNumRowsStatic, "Number of rows does not match");
+                    static_assert(NumColsA == iNumColsStatic, "Number of columns does not match");
+
+                    SP_GRAD_ASSERT(B.iGetNumRows() == iNumRows || B.iGetNumRows() == SpMatrixSize::DYNAMIC);
+                    SP_GRAD_ASSERT(B.iGetNumCols() == iNumCols || B.iGetNumCols() == SpMatrixSize::DYNAMIC);
+
+                    SP_GRAD_ASSERT(!B.bHaveRefTo(A));
+                    SP_GRAD_ASSERT(A.bValid());
+
+                    for (index_type j = 1; j <= iNumCols; ++j) {
+                         for (index_type i = 1; i <= iNumRows; ++i) {
+                              SpDenseGradient<N_SIZE>& Aij = A.GetElem(i, j);
+
+                              const doublereal uij = Aij.dGetValue();
+                              const doublereal vij = B.dGetValue(i, j);
+                              const doublereal fij = Func::f(uij, vij);
+                              const doublereal dfij_du = Func::df_du(uij, vij);
+                              const doublereal dfij_dv = Func::df_dv(uij, vij);
+
+                              Aij.Rescale(fij, dfij_du);
+                              B.InsertDeriv(Aij, dfij_dv, i, j);
+                         }
+                    }
+
+                    SP_GRAD_ASSERT(A.bValid());
+               }
+
+               template <MatTranspEvalFlag eTransp, typename Func, typename ExprB, index_type NumRowsA, index_type NumColsA>
+               static inline void ElemAssignCompr(SpMatrixBase<SpDenseGradient<N_SIZE>, NumRowsA, NumColsA>& A, const SpMatElemExprBase<SpDenseGradient<N_SIZE>, ExprB>& B) {
+                    ElemAssignHelper<SpDenseGradient<N_SIZE>, SpDenseGradient<N_SIZE> >::template ElemAssignUncompr<eTransp, Func>(A, B);
+               }
+
+               template <MatTranspEvalFlag eTransp, typename Func, typename ExprB, index_type NumRowsA, index_type NumColsA>
+               static inline void ElemAssignCompr(SpMatrixBase<SpDenseGradient<N_SIZE>, NumRowsA, NumColsA>& A, const SpMatElemExprBase<SpDenseGradient<N_SIZE>, ExprB>& B, const SpGradExpDofMapHelper<SpDenseGradient<N_SIZE> >&) {
+                    ElemAssignHelper<SpDenseGradient<N_SIZE>, SpDenseGradient<N_SIZE> >::template ElemAssignUncompr<eTransp, Func>(A, B);
+               }
+          };
+
+          template <index_type N_SIZE>
+          struct ElemAssignHelper<SpDenseGradient<N_SIZE>, doublereal> {
+               template <MatTranspEvalFlag eTransp, typename Func, typename ExprB, index_type NumRowsA, index_type NumColsA>
+               static inline void ElemAssignUncompr(SpMatrixBase<SpDenseGradient<N_SIZE>, NumRowsA, NumColsA>& A, const SpMatElemExprBase<doublereal, ExprB>& B) {
+                    typedef typename remove_all<ExprB>::type ExprTypeB;
+                    constexpr index_type iNumRowsStatic = ExprTypeB::iNumRowsStatic;
+                    constexpr index_type iNumColsStatic = ExprTypeB::iNumColsStatic;
+
+                    const index_type iNumRows = A.iGetNumRows();
+                    const index_type iNumCols = A.iGetNumCols();
+
+                    static_assert(NumRowsA == iNumRowsStatic, "Number of rows does not match");
+                    static_assert(NumColsA == iNumColsStatic, "Number of columns does not match");
+
+                    SP_GRAD_ASSERT(B.iGetNumRows() == iNumRows || B.iGetNumRows() == SpMatrixSize::DYNAMIC);
+                    SP_GRAD_ASSERT(B.iGetNumCols() == iNumCols || B.iGetNumCols() == SpMatrixSize::DYNAMIC);
+                    SP_GRAD_ASSERT(!B.bHaveRefTo(A));
+                    SP_GRAD_ASSERT(A.bValid());
+
+                    for (index_type j = 1; j <= iNumCols; ++j) {
+                         for (index_type i = 1; i <= iNumRows; ++i) {
+                              SpDenseGradient<N_SIZE>& Aij = A.GetElem(i, j);
+
+                              const doublereal uij = Aij.dGetValue();
+                              const doublereal vij = B.dGetValue(i, j);
+
+                              Aij.Rescale(Func::f(uij, vij), Func::df_du(uij, vij));
+                         }
+                    }
+
+                    SP_GRAD_ASSERT(A.bValid());
+               }
+
+               template <MatTranspEvalFlag eTransp, typename Func, typename ExprB, index_type NumRowsA, index_type NumColsA>
+               static inline void ElemAssignCompr(SpMatrixBase<SpDenseGradient<N_SIZE>, NumRowsA, NumColsA>& A, const SpMatElemExprBase<doublereal, ExprB>& B) {
+                    ElemAssignHelper<SpDenseGradient<N_SIZE>, doublereal>::template ElemAssignUncompr<eTransp, Func>(A, B);
+               }
+
+               template <MatTranspEvalFlag eTransp, typename Func, typename ExprB, index_type NumRowsA, index_type NumColsA>
+               static inline void ElemAssignCompr(SpMatrixBase<SpDenseGradient<N_SIZE>, NumRowsA, NumColsA>& A, const SpMatElemExprBase<doublereal, ExprB>& B, const SpGradExpDofMapHelper<SpDenseGradient<N_SIZE> >&) {
+                    ElemAssignHelper<SpDenseGradient<N_SIZE>, doublereal>::template ElemAssignUncompr<eTransp, Func>(A, B);
+               }
+          };
+
           template <SpGradCommon::ExprEvalFlags eFlags>
           struct ElemAssignHelperCompr {
                template <MatTranspEvalFlag eTransp, typename Func, typename ValueA, typename ValueB, typename ExprB, index_type NumRowsA, index_type NumColsA>
@@ -4108,8 +4213,8 @@ namespace sp_grad {
 
           constexpr bool bIsGradientLhs = std::is_same<SpGradient, LhsValue>::value;
           constexpr bool bIsGradientRhs = std::is_same<SpGradient, RhsValue>::value;
-          constexpr bool bIsGradProdLhs = std::is_same<GpGradProd, LhsValue>::value;
-          constexpr bool bIsGradProdRhs = std::is_same<GpGradProd, RhsValue>::value;
+          constexpr bool bIsGradProdLhs = util::IsForwardMode<LhsValue>::value;
+          constexpr bool bIsGradProdRhs = util::IsForwardMode<RhsValue>::value;
           constexpr bool bIsGradOrGradProdLhs = bIsGradientLhs || bIsGradProdLhs;
           constexpr bool bIsGradOrGradProdRhs = bIsGradientRhs || bIsGradProdRhs;
           constexpr bool bIsSparseRep = !(bIsGradProdLhs || bIsGradProdRhs);
@@ -4176,8 +4281,8 @@ namespace sp_grad {
 
           constexpr bool bIsGradientLhs = std::is_same<SpGradient, LhsValue>::value;
           constexpr bool bIsGradientRhs = std::is_same<SpGradient, RhsValue>::value;
-          constexpr bool bIsGradProdLhs = std::is_same<GpGradProd, LhsValue>::value;
-          constexpr bool bIsGradProdRhs = std::is_same<GpGradProd, RhsValue>::value;
+          constexpr bool bIsGradProdLhs = util::IsForwardMode<LhsValue>::value;
+          constexpr bool bIsGradProdRhs = util::IsForwardMode<RhsValue>::value;
 
           static_assert(!(bIsGradientRhs && bIsGradProdLhs), "cannot mix forward mode and sparse mode in a single expression");
           static_assert(!(bIsGradProdRhs && bIsGradientLhs), "cannot mix forward mode and sparse mode in a single expression");
@@ -4227,10 +4332,10 @@ namespace sp_grad {
      template <typename ValueTypeExpr, typename Expr>
      SpMatrixBase<ValueType, NumRows, NumCols>::SpMatrixBase(const SpMatElemExprBase<ValueTypeExpr, Expr>& oExpr) {
           constexpr bool bThisIsGradient = std::is_same<ValueType, SpGradient>::value;
-          constexpr bool bThisIsGradProd = std::is_same<ValueType, GpGradProd>::value;
+          constexpr bool bThisIsGradProd = util::IsForwardMode<ValueType>::value;
           constexpr bool bThisIsDouble = std::is_same<ValueType, doublereal>::value;
           constexpr bool bExprIsGradient = std::is_same<ValueTypeExpr, SpGradient>::value;
-          constexpr bool bExprIsGradProd = std::is_same<ValueTypeExpr, GpGradProd>::value;
+          constexpr bool bExprIsGradProd = util::IsForwardMode<ValueTypeExpr>::value;
           constexpr bool bExprIsDouble = std::is_same<ValueTypeExpr, doublereal>::value;
           static_assert(bThisIsGradient || bThisIsGradProd || bThisIsDouble, "data type not supported");
           static_assert(bExprIsGradient || bExprIsGradProd || bExprIsDouble, "data type not supported");
@@ -4254,10 +4359,10 @@ namespace sp_grad {
      SpMatrixBase<ValueType, NumRows, NumCols>::SpMatrixBase(const SpMatElemExprBase<ValueTypeExpr, Expr>& oExpr,
                                                              const SpGradExpDofMapHelper<ValueType>& oDofMap) {
           constexpr bool bThisIsGradient = std::is_same<ValueType, SpGradient>::value;
-          constexpr bool bThisIsGradProd = std::is_same<ValueType, GpGradProd>::value;
+          constexpr bool bThisIsGradProd = util::IsForwardMode<ValueType>::value;
           constexpr bool bThisIsDouble = std::is_same<ValueType, doublereal>::value;
           constexpr bool bExprIsGradient = std::is_same<ValueTypeExpr, SpGradient>::value;
-          constexpr bool bExprIsGradProd = std::is_same<ValueTypeExpr, GpGradProd>::value;
+          constexpr bool bExprIsGradProd = util::IsForwardMode<ValueTypeExpr>::value;
           constexpr bool bExprIsDouble = std::is_same<ValueTypeExpr, doublereal>::value;
           constexpr SpGradCommon::ExprEvalFlags eExprEvalFlags = bThisIsGradient ? SpGradCommon::ExprEvalUnique : SpGradCommon::ExprEvalDuplicate;
           static_assert(bThisIsGradient || bThisIsGradProd || bThisIsDouble, "invalid data type");
@@ -4295,10 +4400,10 @@ namespace sp_grad {
                                                           const SpGradExpDofMapHelper<ValueType>& oDofMap)
      {
           constexpr bool bThisIsGradient = std::is_same<ValueType, SpGradient>::value;
-          constexpr bool bThisIsGradProd = std::is_same<ValueType, GpGradProd>::value;
+          constexpr bool bThisIsGradProd = util::IsForwardMode<ValueType>::value;
           constexpr bool bThisIsDouble = std::is_same<ValueType, doublereal>::value;
           constexpr bool bExprIsGradient = std::is_same<ValueTypeExpr, SpGradient>::value;
-          constexpr bool bExprIsGradProd = std::is_same<ValueTypeExpr, GpGradProd>::value;
+          constexpr bool bExprIsGradProd = util::IsForwardMode<ValueTypeExpr>::value;
           constexpr bool bExprIsDouble = std::is_same<ValueTypeExpr, doublereal>::value;
           constexpr SpGradCommon::ExprEvalFlags eExprEvalFlags = bThisIsGradient ? SpGradCommon::ExprEvalUnique : SpGradCommon::ExprEvalDuplicate;
           static_assert(bThisIsGradient || bThisIsGradProd || bThisIsDouble, "invalid data type");
@@ -4424,10 +4529,10 @@ namespace sp_grad {
           SP_GRAD_ASSERT(bValid());
 
           constexpr bool bThisIsGradient = std::is_same<ValueType, SpGradient>::value;
-          constexpr bool bThisIsGradProd = std::is_same<ValueType, GpGradProd>::value;
+          constexpr bool bThisIsGradProd = util::IsForwardMode<ValueType>::value;
           constexpr bool bThisIsDouble = std::is_same<ValueType, doublereal>::value;
           constexpr bool bExprIsGradient = std::is_same<ValueTypeExpr, SpGradient>::value;
-          constexpr bool bExprIsGradProd = std::is_same<ValueTypeExpr, GpGradProd>::value;
+          constexpr bool bExprIsGradProd = util::IsForwardMode<ValueTypeExpr>::value;
           constexpr bool bExprIsDouble = std::is_same<ValueTypeExpr, doublereal>::value;
           static_assert(bThisIsGradient || bThisIsGradProd || bThisIsDouble, "data type not supported");
           static_assert(bExprIsGradient || bExprIsGradProd || bExprIsDouble, "data type not supported");
@@ -4505,6 +4610,25 @@ namespace sp_grad {
           return *this;
      }
 
+     template <typename ValueType, index_type NumRows, index_type NumCols>
+     template <index_type N_SIZE>
+     SpMatrixBase<ValueType, NumRows, NumCols>& SpMatrixBase<ValueType, NumRows, NumCols>::operator*=(const SpDenseGradient<N_SIZE>& b) {
+          SP_GRAD_ASSERT(bValid());
+
+          constexpr SpGradCommon::ExprEvalFlags eEvalFlags = SpDenseGradient<N_SIZE>::eExprEvalFlags;
+          constexpr bool bThisIsGradient = std::is_same<ValueType, SpDenseGradient<N_SIZE> >::value;
+
+          static_assert(bThisIsGradient, "Cannot convert SpDenseGradient to doublereal");
+
+          const SpMatElemScalarExpr<SpDenseGradient<N_SIZE>, const SpDenseGradient<N_SIZE>&, NumRows, NumCols> btmp{b};
+
+          btmp.template AssignEval<util::MatTranspEvalFlag::DIRECT, eEvalFlags, SpGradBinMult>(*this);
+
+          SP_GRAD_ASSERT(bValid());
+
+          return *this;
+     }
+
      template <typename ValueType, index_type NumRows, index_type NumCols>
      SpMatrixBase<ValueType, NumRows, NumCols>& SpMatrixBase<ValueType, NumRows, NumCols>::operator*=(doublereal b) {
           SP_GRAD_ASSERT(bValid());
@@ -4572,6 +4696,24 @@ namespace sp_grad {
           return *this;
      }
 
+     template <typename ValueType, index_type NumRows, index_type NumCols>
+     template <index_type N_SIZE>
+     SpMatrixBase<ValueType, NumRows, NumCols>& SpMatrixBase<ValueType, NumRows, NumCols>::operator/=(const SpDenseGradient<N_SIZE>& b) {
+          SP_GRAD_ASSERT(bValid());
+
+          constexpr SpGradCommon::ExprEvalFlags eEvalFlags = SpDenseGradient<N_SIZE>::eExprEvalFlags;
+          constexpr bool bThisIsGradient = std::is_same<ValueType, SpDenseGradient<N_SIZE> >::value;
+          static_assert(bThisIsGradient, "Cannot convert SpDenseGradient to doublereal");
+
+          const SpMatElemScalarExpr<SpDenseGradient<N_SIZE>, const SpDenseGradient<N_SIZE>&, NumRows, NumCols> btmp{b};
+
+          btmp.template AssignEval<util::MatTranspEvalFlag::DIRECT, eEvalFlags, SpGradBinDiv>(*this);
+
+          SP_GRAD_ASSERT(bValid());
+
+          return *this;
+     }
+
      template <typename ValueType, index_type NumRows, index_type NumCols>
      SpMatrixBase<ValueType, NumRows, NumCols>& SpMatrixBase<ValueType, NumRows, NumCols>::operator/=(doublereal b) {
           SP_GRAD_ASSERT(bValid());
@@ -4593,10 +4735,10 @@ namespace sp_grad {
 
           constexpr SpGradCommon::ExprEvalFlags eEvalFlags = util::remove_all<Expr>::type::eExprEvalFlags;
           constexpr bool bThisIsGradient = std::is_same<ValueType, SpGradient>::value;
-          constexpr bool bThisIsGradProd = std::is_same<ValueType, GpGradProd>::value;
+          constexpr bool bThisIsGradProd = util::IsForwardMode<ValueType>::value;
           constexpr bool bThisIsDouble = std::is_same<ValueType, doublereal>::value;
           constexpr bool bExprIsGradient = std::is_same<ValueTypeExpr, SpGradient>::value;
-          constexpr bool bExprIsGradProd = std::is_same<ValueTypeExpr, GpGradProd>::value;
+          constexpr bool bExprIsGradProd = util::IsForwardMode<ValueTypeExpr>::value;
           constexpr bool bExprIsDouble = std::is_same<ValueTypeExpr, doublereal>::value;
 
           static_assert(!(bThisIsGradProd && bExprIsGradient), "cannot mix forward mode and sparse mode within the same expression");
@@ -4625,10 +4767,10 @@ namespace sp_grad {
           SP_GRAD_ASSERT(bValid());
 
           constexpr bool bThisIsGradient = std::is_same<ValueType, SpGradient>::value;
-          constexpr bool bThisIsGradProd = std::is_same<ValueType, GpGradProd>::value;
+          constexpr bool bThisIsGradProd = util::IsForwardMode<ValueType>::value;
           constexpr bool bThisIsDouble = std::is_same<ValueType, doublereal>::value;
           constexpr bool bExprIsGradient = std::is_same<ValueTypeExpr, SpGradient>::value;
-          constexpr bool bExprIsGradProd = std::is_same<ValueTypeExpr, GpGradProd>::value;
+          constexpr bool bExprIsGradProd = util::IsForwardMode<ValueTypeExpr>::value;
           constexpr bool bExprIsDouble = std::is_same<ValueTypeExpr, doublereal>::value;
 
           static_assert(!(bThisIsGradProd && bExprIsGradient), "cannot mix forward mode and sparse mode within the same expression");
@@ -4657,10 +4799,10 @@ namespace sp_grad {
           SP_GRAD_ASSERT(bValid());
 
           constexpr bool bThisIsGradient = std::is_same<ValueType, SpGradient>::value;
-          constexpr bool bThisIsGradProd = std::is_same<ValueType, GpGradProd>::value;
+          constexpr bool bThisIsGradProd = util::IsForwardMode<ValueType>::value;
           constexpr bool bThisIsDouble = std::is_same<ValueType, doublereal>::value;
           constexpr bool bExprIsGradient = std::is_same<ValueTypeExpr, SpGradient>::value;
-          constexpr bool bExprIsGradProd = std::is_same<ValueTypeExpr, GpGradProd>::value;
+          constexpr bool bExprIsGradProd = util::IsForwardMode<ValueTypeExpr>::value;
           constexpr bool bExprIsDouble = std::is_same<ValueTypeExpr, doublereal>::value;
 
           static_assert(!(bThisIsGradProd && bExprIsGradient), "cannot mix forward mode and sparse mode");
@@ -4690,10 +4832,10 @@ namespace sp_grad {
 
           constexpr SpGradCommon::ExprEvalFlags eEvalFlags = util::remove_all<Expr>::type::eExprEvalFlags;
           constexpr bool bThisIsGradient = std::is_same<ValueType, SpGradient>::value;
-          constexpr bool bThisIsGradProd = std::is_same<ValueType, GpGradProd>::value;
+          constexpr bool bThisIsGradProd = util::IsForwardMode<ValueType>::value;
           constexpr bool bThisIsDouble = std::is_same<ValueType, doublereal>::value;
           constexpr bool bExprIsGradient = std::is_same<ValueTypeExpr, SpGradient>::value;
-          constexpr bool bExprIsGradProd = std::is_same<ValueTypeExpr, GpGradProd>::value;
+          constexpr bool bExprIsGradProd = util::IsForwardMode<ValueTypeExpr>::value;
           constexpr bool bExprIsDouble = std::is_same<ValueTypeExpr, doublereal>::value;
 
           static_assert(!(bThisIsGradProd && bExprIsGradient), "cannot mix forward mode and sparse mode in the same expression");
@@ -4807,6 +4949,12 @@ namespace sp_grad {
           return g.bValid();
      }
 
+     template <typename ValueType, index_type NumRows, index_type NumCols>
+     template <index_type N_SIZE>
+     bool SpMatrixBase<ValueType, NumRows, NumCols>::bValid(const SpDenseGradient<N_SIZE>& g) {
+          return g.bValid();
+     }
+
      template <typename ValueType, index_type NumRows, index_type NumCols>
      bool SpMatrixBase<ValueType, NumRows, NumCols>::bValid(doublereal d) {
           return std::isfinite(d);
@@ -5246,6 +5394,17 @@ namespace sp_grad {
           return decltype(operator*(A, b)){A, SpMatElemScalarExpr<GpGradProd, const GpGradProd&>{b}};
      }
 
+     template <typename LhsValue, typename LhsExpr, index_type N_SIZE>
+     inline constexpr
+     SpMatElemBinExpr<typename util::ResultType<LhsValue, SpDenseGradient<N_SIZE> >::Type,
+                      SpGradBinMult,
+                      const SpMatElemExprBase<LhsValue, LhsExpr>&,
+                      const SpMatElemScalarExpr<SpDenseGradient<N_SIZE>, const SpDenseGradient<N_SIZE>&> >
+     operator*(const SpMatElemExprBase<LhsValue, LhsExpr>& A,
+               const SpDenseGradient<N_SIZE>& b) noexcept {
+          return decltype(operator*(A, b)){A, SpMatElemScalarExpr<SpDenseGradient<N_SIZE>, const SpDenseGradient<N_SIZE>&>{b}};
+     }
+
      template <typename LhsValue, typename LhsExpr, typename RhsExpr>
      inline constexpr
      SpMatElemBinExpr<typename util::ResultType<LhsValue, SpGradient>::Type,
@@ -5325,6 +5484,17 @@ namespace sp_grad {
           return decltype(operator/(A, b)){A, SpMatElemScalarExpr<GpGradProd, const GpGradProd&>{b}};
      }
 
+     template <typename LhsValue, typename LhsExpr, index_type N_SIZE>
+     inline constexpr
+     SpMatElemBinExpr<typename util::ResultType<LhsValue, SpDenseGradient<N_SIZE> >::Type,
+                      SpGradBinDiv,
+                      const SpMatElemExprBase<LhsValue, LhsExpr>&,
+                      const SpMatElemScalarExpr<SpDenseGradient<N_SIZE>, const SpDenseGradient<N_SIZE>&> >
+     operator/(const SpMatElemExprBase<LhsValue, LhsExpr>& A,
+               const SpDenseGradient<N_SIZE>& b) noexcept {
+          return decltype(operator/(A, b)){A, SpMatElemScalarExpr<SpDenseGradient<N_SIZE>, const SpDenseGradient<N_SIZE>&>{b}};
+     }
+
      template <typename LhsValue, typename LhsExpr, typename RhsExpr>
      inline constexpr
      SpMatElemBinExpr<typename util::ResultType<LhsValue, SpGradient>::Type,
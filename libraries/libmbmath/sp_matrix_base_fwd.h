@@ -381,7 +381,7 @@ namespace sp_grad {
      {
           static_assert(std::is_same<VALUE, doublereal>::value ||
                         std::is_same<VALUE, SpGradient>::value ||
-                        std::is_same<VALUE, GpGradProd>::value, "data type not supported");
+                        util::IsForwardMode<VALUE>::value, "data type not supported");
 
      protected:
           constexpr SpMatElemExprBase() noexcept {}
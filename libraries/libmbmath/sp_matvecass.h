@@ -120,6 +120,28 @@ namespace sp_grad {
           const VectorHandler& Y;
      };
      
+     template <index_type N_SIZE>
+     class SpGradientVectorHandler<SpDenseGradient<N_SIZE> > {
+     public:
+          SpGradientVectorHandler(const VectorHandler& vh)
+               :vh(vh) {
+
+          }
+
+          void dGetCoef(integer iRow, SpDenseGradient<N_SIZE>& gVal, doublereal dCoef) const {
+               gVal.Reset(vh.dGetCoef(iRow), iRow, -dCoef);
+          }
+
+          template <index_type N_rows>
+          void GetVec(integer iRow, SpColVector<SpDenseGradient<N_SIZE>, N_rows>& v, doublereal dCoef) const {
+               for (integer i = 0; i < v.iGetNumRows(); ++i) {
+                    v(i + 1).Reset(vh.dGetCoef(iRow + i), iRow + i, -dCoef);
+               }
+          }
+     private:
+          const VectorHandler& vh;
+     };
+
      class SpGradientAssVecBase {
      public:
           enum SpAssMode { RESET, APPEND };
@@ -241,6 +263,9 @@ namespace sp_grad {
 
                SpGradientAssVec WorkMat_grad(WorkMat, mode);
 
+               // temporary gradients are taken from the arena of this thread
+               SpGradientArena::Scope oArenaScope;
+
                pElem->AssRes(WorkMat_grad, dCoef, XCurr_grad, XPrimeCurr_grad, func);
           }
 
@@ -255,6 +280,8 @@ namespace sp_grad {
 
                SpGradientAssVec WorkMat_grad(WorkMat, mode);
 
+               SpGradientArena::Scope oArenaScope;
+
                pElem->InitialAssRes(WorkMat_grad, XCurr_grad, func);
           }
 
@@ -314,6 +341,74 @@ namespace sp_grad {
      private:
           VectorHandler& Jac;
      };
+
+     // Assembles a dense gradient with up to N_SIZE dofs into a full submatrix;
+     // column indices are known only after all the dofs have been seeded.
+     template <index_type N_SIZE>
+     class SpGradientAssVec<SpDenseGradient<N_SIZE> >: public SpGradientAssVecBase {
+     public:
+          explicit SpGradientAssVec(FullSubMatrixHandler& WorkMat)
+               :WorkMat(WorkMat), iSubRow(0) {
+          }
+
+          template <typename T>
+          static void AssJac(T* pElem,
+                             VariableSubMatrixHandler& WorkMat,
+                             doublereal dCoef,
+                             const VectorHandler& XCurr,
+                             const VectorHandler& XPrimeCurr,
+                             SpFunctionCall func) {
+
+               const SpGradientVectorHandler<SpDenseGradient<N_SIZE> > XCurr_grad(XCurr);
+               const SpGradientVectorHandler<SpDenseGradient<N_SIZE> > XPrimeCurr_grad(XPrimeCurr);
+
+               SpDenseDofMap<N_SIZE> oDofMap;
+
+               SpGradientAssVec WorkMat_grad(WorkMat.SetFull());
+
+               pElem->AssRes(WorkMat_grad, dCoef, XCurr_grad, XPrimeCurr_grad, func);
+
+               if (!WorkMat_grad.bAssDone(oDofMap)) {
+                    WorkMat.SetNullMatrix();
+               }
+          }
+
+          void AddItem(integer iRow, const SpDenseGradient<N_SIZE>& oGrad) {
+               WorkMat.Resize(++iSubRow, N_SIZE);
+               WorkMat.PutRowIndex(iSubRow, iRow);
+
+               for (index_type j = 0; j < N_SIZE; ++j) {
+                    WorkMat.PutCoef(iSubRow, j + 1, oGrad.dGetDerivLocal(j));
+               }
+          }
+
+          template <index_type N_rows>
+          void AddItem(integer iFirstRow, const SpColVector<SpDenseGradient<N_SIZE>, N_rows>& v) {
+               // zero based index according to VectorHandler::Put(integer iRow, const Vec3& v)
+
+               for (integer i = 0; i < v.iGetNumRows(); ++i) {
+                    AddItem(iFirstRow + i, v(i + 1));
+               }
+          }
+
+     private:
+          bool bAssDone(const SpDenseDofMap<N_SIZE>& oDofMap) {
+               if (iSubRow == 0 || oDofMap.iGetSize() == 0) {
+                    return false;
+               }
+
+               WorkMat.Resize(iSubRow, oDofMap.iGetSize());
+
+               for (index_type j = 1; j <= oDofMap.iGetSize(); ++j) {
+                    WorkMat.PutColIndex(j, oDofMap.iGetGlobalDof(j - 1));
+               }
+
+               return true;
+          }
+
+          FullSubMatrixHandler& WorkMat;
+          integer iSubRow;
+     };
      
 } // namespace
 
@@ -458,10 +458,17 @@ SpMapMatrixHandler::const_iterator::reset(bool is_end)
 		elem.iCol = m.NCols;
 
 	} else {
-		i = m.col_indices[0].begin();
-		elem.iRow = i->first;
-		elem.iCol = 0;
-		elem.dCoef = i->second;
+		/* skip the leading empty columns */
+		for (elem.iCol = 0; elem.iCol < m.NCols; elem.iCol++) {
+			i = m.col_indices[elem.iCol].begin();
+			if (i != m.col_indices[elem.iCol].end()) {
+				elem.iRow = i->first;
+				elem.dCoef = i->second;
+				return;
+			}
+		}
+
+		elem.iRow = m.NRows;
 	}
 }
 
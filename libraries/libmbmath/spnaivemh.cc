@@ -0,0 +1,437 @@
+/* $Header$ */
+/*
+ * MBDyn (C) is a multibody analysis code.
+ * http://www.mbdyn.org
+ *
+ * Copyright (C) 1996-2023
+ *
+ * Pierangelo Masarati	<pierangelo.masarati@polimi.it>
+ * Paolo Mantegazza	<paolo.mantegazza@polimi.it>
+ *
+ * Dipartimento di Ingegneria Aerospaziale - Politecnico di Milano
+ * via La Masa, 34 - 20156 Milano, Italy
+ * http://www.aero.polimi.it
+ *
+ * Changing this copyright notice is forbidden.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation (version 2 of the License).
+ *
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "mbconfig.h"           /* This goes first in every *.c,*.cc file */
+
+#include "myassert.h"
+#include "mh.h"
+#include "submat.h"
+#include "spnaivemh.h"
+
+/* SpNaiveMatrixHandler begin */
+
+SpNaiveMatrixHandler::SpNaiveMatrixHandler(const integer n,
+        const std::vector<integer> *pPerm,
+        const std::vector<integer> *pInvPerm)
+: iSize(n), pPerm(pPerm), pInvPerm(pInvPerm), m_end(*this, true)
+{
+        ASSERT(iSize > 0);
+        ASSERT((pPerm == 0) == (pInvPerm == 0));
+
+        int rc = spnaiv_init(&m, iSize);
+        if (rc) {
+                silent_cerr("Error allocating memory for sparse Naive matrix handler "
+                        "of size " << iSize << "x" << iSize << std::endl);
+                throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+        }
+
+#ifdef DEBUG
+        IsValid();
+#endif
+}
+
+SpNaiveMatrixHandler::~SpNaiveMatrixHandler(void)
+{
+        spnaiv_destroy(&m);
+}
+
+#ifdef DEBUG
+void
+SpNaiveMatrixHandler::IsValid(void) const
+{
+        ASSERT(m.neq == iSize);
+
+        if (pPerm) {
+                ASSERT(pPerm->size() == static_cast<size_t>(iSize));
+                ASSERT(pInvPerm->size() >= static_cast<size_t>(iSize)); // Required for MakeCCStructure
+
+                for (integer i = 0; i < iSize; ++i) {
+                        ASSERT((*pPerm)[i] >= 0 && (*pPerm)[i] < iSize);
+                        ASSERT((*pInvPerm)[(*pPerm)[i]] == i);
+                }
+        }
+}
+#endif /* DEBUG */
+
+size_t
+SpNaiveMatrixHandler::GetMemorySize(void) const
+{
+        return sizeof(*this) + spnaiv_size(&m);
+}
+
+void
+SpNaiveMatrixHandler::Reset(void)
+{
+        spnaiv_reset(&m);
+}
+
+/* Overload di += usato per l'assemblaggio delle matrici */
+MatrixHandler&
+SpNaiveMatrixHandler::operator += (const SubMatrixHandler& SubMH)
+{
+        integer nr = SubMH.iGetNumRows();
+        integer nc = SubMH.iGetNumCols();
+
+        for (integer ir = 1; ir <= nr; ir++) {
+                integer iRow = SubMH.iGetRowIndex(ir);
+
+                for (integer ic = 1; ic <= nc; ic++) {
+                        operator()(iRow, SubMH.iGetColIndex(ic)) += SubMH(ir, ic);
+                }
+        }
+
+        return *this;
+}
+
+/* Overload di -= usato per l'assemblaggio delle matrici */
+MatrixHandler&
+SpNaiveMatrixHandler::operator -= (const SubMatrixHandler& SubMH)
+{
+        integer nr = SubMH.iGetNumRows();
+        integer nc = SubMH.iGetNumCols();
+
+        for (integer ir = 1; ir <= nr; ir++) {
+                integer iRow = SubMH.iGetRowIndex(ir);
+
+                for (integer ic = 1; ic <= nc; ic++) {
+                        operator()(iRow, SubMH.iGetColIndex(ic)) -= SubMH(ir, ic);
+                }
+        }
+
+        return *this;
+}
+
+MatrixHandler&
+SpNaiveMatrixHandler::operator += (const VariableSubMatrixHandler& SubMH)
+{
+        switch (SubMH.GetStatus()) {
+        case VariableSubMatrixHandler::FULL:
+        {
+                const FullSubMatrixHandler& SMH = SubMH.GetFull();
+                /* see NaiveMatrixHandler for the 0/1-based indexing */
+                integer *pirm1 = SMH.piRowm1;
+                integer *pic = SMH.piColm1 + 1;
+                doublereal **ppd = SMH.ppdCols;
+
+                integer nr = SMH.iGetNumRows();
+                integer nc = SMH.iGetNumCols();
+                for (integer iR = 1; iR <= nr; iR++) {
+                        integer iRow = pirm1[iR];
+
+                        for (integer ic = 0; ic < nc; ic++) {
+                                operator()(iRow, pic[ic]) += ppd[ic][iR];
+                        }
+                }
+                break;
+        }
+
+        case VariableSubMatrixHandler::SPARSE:
+        {
+                const SparseSubMatrixHandler& SMH = SubMH.GetSparse();
+
+                for (integer i = 1; i <= SMH.iNumItems; i++) {
+                        operator()(SMH.piRowm1[i], SMH.piColm1[i]) += SMH.pdMatm1[i];
+                }
+                break;
+        }
+
+        case VariableSubMatrixHandler::NULLMATRIX:
+                break;
+
+        default:
+                SubMH.AddTo(*this);
+        }
+
+        return *this;
+}
+
+MatrixHandler&
+SpNaiveMatrixHandler::operator -= (const VariableSubMatrixHandler& SubMH)
+{
+        switch (SubMH.GetStatus()) {
+        case VariableSubMatrixHandler::FULL:
+        {
+                const FullSubMatrixHandler& SMH = SubMH.GetFull();
+                integer *pirm1 = SMH.piRowm1;
+                integer *pic = SMH.piColm1 + 1;
+                doublereal **ppd = SMH.ppdCols;
+
+                integer nr = SMH.iGetNumRows();
+                integer nc = SMH.iGetNumCols();
+                for (integer iR = 1; iR <= nr; iR++) {
+                        integer iRow = pirm1[iR];
+
+                        for (integer ic = 0; ic < nc; ic++) {
+                                operator()(iRow, pic[ic]) -= ppd[ic][iR];
+                        }
+                }
+                break;
+        }
+
+        case VariableSubMatrixHandler::SPARSE:
+        {
+                const SparseSubMatrixHandler& SMH = SubMH.GetSparse();
+
+                for (integer i = 1; i <= SMH.iNumItems; i++) {
+                        operator()(SMH.piRowm1[i], SMH.piColm1[i]) -= SMH.pdMatm1[i];
+                }
+                break;
+        }
+
+        case VariableSubMatrixHandler::NULLMATRIX:
+                break;
+
+        default:
+                SubMH.SubFrom(*this);
+        }
+
+        return *this;
+}
+
+void
+SpNaiveMatrixHandler::MakeCCStructure(std::vector<integer>& Ai,
+                                      std::vector<integer>& Ap)
+{
+        integer nnz = 0;
+        for (integer i = 0; i < iSize; i++) {
+                nnz += m.col[i].nzr;
+        }
+
+        Ai.resize(nnz);
+        Ap.resize(iSize + 1);
+
+        integer x_ptr = 0;
+        for (integer col = 0; col < iSize; col++) {
+                Ap[col] = x_ptr;
+                integer nzr = m.col[col].nzr;
+                for (integer row = 0; row < nzr; row++) {
+                        Ai[x_ptr] = m.col[col].ri[row];
+                        x_ptr++;
+                }
+        }
+        Ap[iSize] = nnz;
+}
+
+void
+SpNaiveMatrixHandler::Scale(const std::vector<doublereal>& oRowScale, const std::vector<doublereal>& oColScale)
+{
+        IteratorScale(*this, oRowScale, oColScale);
+}
+
+void
+SpNaiveMatrixHandler::EnumerateNz(const std::function<EnumerateNzCallback>& func) const
+{
+        for (const auto& d: *this) {
+                func(d.iRow + 1, d.iCol + 1, d.dCoef);
+        }
+}
+
+/* Matrix Matrix product */
+MatrixHandler&
+SpNaiveMatrixHandler::MatMatMul_base(
+        void (MatrixHandler::*op)(integer iRow, integer iCol, const doublereal& dCoef),
+        MatrixHandler& out, const MatrixHandler& in) const
+{
+        ASSERT(in.iGetNumRows() == iSize);
+        ASSERT(out.iGetNumRows() == iSize);
+        ASSERT(out.iGetNumCols() == in.iGetNumCols());
+
+        integer in_ncols = in.iGetNumCols();
+
+        for (integer ir = 0; ir < iSize; ir++) {
+                const spnaiv_row& row = m.row[ir];
+                for (integer idx = 0; idx < row.nzc; idx++) {
+                        integer ic = row.ci[idx];
+                        doublereal d = *spnaiv_get(&m, ir, ic);
+                        for (integer ik = 1; ik <= in_ncols; ik++) {
+                                (out.*op)(ir + 1, ik, d*in(iGetInvCol(ic) + 1, ik));
+                        }
+                }
+        }
+
+        return out;
+}
+
+MatrixHandler&
+SpNaiveMatrixHandler::MatTMatMul_base(
+        void (MatrixHandler::*op)(integer iRow, integer iCol, const doublereal& dCoef),
+        MatrixHandler& out, const MatrixHandler& in) const
+{
+        ASSERT(in.iGetNumRows() == iSize);
+        ASSERT(out.iGetNumRows() == iSize);
+        ASSERT(out.iGetNumCols() == in.iGetNumCols());
+
+        integer in_ncols = in.iGetNumCols();
+
+        for (integer ic = 0; ic < iSize; ic++) {
+                const spnaiv_col& col = m.col[ic];
+                for (integer idx = 0; idx < col.nzr; idx++) {
+                        integer ir = col.ri[idx];
+                        doublereal d = *spnaiv_get(&m, ir, ic);
+                        for (integer ik = 1; ik <= in_ncols; ik++) {
+                                (out.*op)(iGetInvCol(ic) + 1, ik, d*in(ir + 1, ik));
+                        }
+                }
+        }
+
+        return out;
+}
+
+/* Matrix Vector product */
+VectorHandler&
+SpNaiveMatrixHandler::MatVecMul_base(
+        void (VectorHandler::*op)(integer iRow, const doublereal& dCoef),
+        VectorHandler& out, const VectorHandler& in) const
+{
+        ASSERT(in.iGetSize() == iSize);
+        ASSERT(out.iGetSize() == iSize);
+
+        for (integer ir = 0; ir < iSize; ir++) {
+                const spnaiv_row& row = m.row[ir];
+                for (integer idx = 0; idx < row.nzc; idx++) {
+                        integer ic = row.ci[idx];
+                        (out.*op)(ir + 1, *spnaiv_get(&m, ir, ic)*in(iGetInvCol(ic) + 1));
+                }
+        }
+
+        return out;
+}
+
+VectorHandler&
+SpNaiveMatrixHandler::MatTVecMul_base(
+        void (VectorHandler::*op)(integer iRow, const doublereal& dCoef),
+        VectorHandler& out, const VectorHandler& in) const
+{
+        ASSERT(in.iGetSize() == iSize);
+        ASSERT(out.iGetSize() == iSize);
+
+        for (integer ic = 0; ic < iSize; ic++) {
+                const spnaiv_col& col = m.col[ic];
+                for (integer idx = 0; idx < col.nzr; idx++) {
+                        integer ir = col.ri[idx];
+                        (out.*op)(iGetInvCol(ic) + 1, *spnaiv_get(&m, ir, ic)*in(ir + 1));
+                }
+        }
+
+        return out;
+}
+
+/* iterates over logical columns; with a permutation, elem.iCol
+ * is the unpermuted column, as in NaivePermMatrixHandler */
+void
+SpNaiveMatrixHandler::const_iterator::reset(bool is_end)
+{
+        if (is_end) {
+                elem.iRow = m.iSize;
+                elem.iCol = m.iSize;
+
+        } else {
+                i_row = 0;
+                elem.iCol = 0;
+
+                while (m.m.col[m.iGetCol(elem.iCol)].nzr == 0) {
+                        if (++elem.iCol == m.iSize) {
+                                elem.iRow = m.iSize;
+                                return;
+                        }
+                }
+
+                integer ic = m.iGetCol(elem.iCol);
+                elem.iRow = m.m.col[ic].ri[i_row];
+                elem.dCoef = *spnaiv_get(&m.m, elem.iRow, ic);
+        }
+}
+
+SpNaiveMatrixHandler::const_iterator::const_iterator(const SpNaiveMatrixHandler& m, bool is_end)
+: m(m)
+{
+        reset(is_end);
+}
+
+SpNaiveMatrixHandler::const_iterator::~const_iterator(void)
+{
+        NO_OP;
+}
+
+const SpNaiveMatrixHandler::const_iterator&
+SpNaiveMatrixHandler::const_iterator::operator ++ (void) const
+{
+        i_row++;
+        while (i_row == m.m.col[m.iGetCol(elem.iCol)].nzr) {
+                if (++elem.iCol == m.iSize) {
+                        elem.iRow = m.iSize;
+                        return *this;
+                }
+
+                i_row = 0;
+        }
+
+        integer ic = m.iGetCol(elem.iCol);
+        elem.iRow = m.m.col[ic].ri[i_row];
+        elem.dCoef = *spnaiv_get(&m.m, elem.iRow, ic);
+
+        return *this;
+}
+
+const SparseMatrixHandler::SparseMatrixElement *
+SpNaiveMatrixHandler::const_iterator::operator -> (void) const
+{
+        return &elem;
+}
+
+const SparseMatrixHandler::SparseMatrixElement&
+SpNaiveMatrixHandler::const_iterator::operator * (void) const
+{
+        return elem;
+}
+
+bool
+SpNaiveMatrixHandler::const_iterator::operator == (const SpNaiveMatrixHandler::const_iterator& op) const
+{
+        return elem == op.elem;
+}
+
+bool
+SpNaiveMatrixHandler::const_iterator::operator != (const SpNaiveMatrixHandler::const_iterator& op) const
+{
+        return elem != op.elem;
+}
+
+SpNaiveMatrixHandler* SpNaiveMatrixHandler::Copy() const
+{
+     SpNaiveMatrixHandler* pMH = nullptr;
+
+     SAFENEWWITHCONSTRUCTOR(pMH, SpNaiveMatrixHandler, SpNaiveMatrixHandler(iGetNumRows(), pPerm, pInvPerm));
+
+     return pMH;
+}
+
+/* SpNaiveMatrixHandler end */
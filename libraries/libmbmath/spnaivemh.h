@@ -0,0 +1,228 @@
+/* $Header$ */
+/*
+ * MBDyn (C) is a multibody analysis code.
+ * http://www.mbdyn.org
+ *
+ * Copyright (C) 1996-2023
+ *
+ * Pierangelo Masarati	<pierangelo.masarati@polimi.it>
+ * Paolo Mantegazza	<paolo.mantegazza@polimi.it>
+ *
+ * Dipartimento di Ingegneria Aerospaziale - Politecnico di Milano
+ * via La Masa, 34 - 20156 Milano, Italy
+ * http://www.aero.polimi.it
+ *
+ * Changing this copyright notice is forbidden.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation (version 2 of the License).
+ *
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SPNAIVEMH_H
+#define SPNAIVEMH_H
+
+#include <vector>
+#include <new>
+
+#include "myassert.h"
+#include "solman.h"
+#include "spmh.h"
+#include "spmthrdslv.h"
+
+class SpNaiveSolver;
+class MultiThreadDataManager;
+
+/*
+ * Sparse Matrix with the same access pattern as NaiveMatrixHandler,
+ * but with storage proportional to the number of nonzeros
+ * (see spnaiv_mat in spmthrdslv.h).
+ *
+ * The column permutation of NaivePermMatrixHandler is optional,
+ * so that the same class can be used with and without reordering.
+ */
+class SpNaiveMatrixHandler : public MatrixHandler {
+        friend class SpNaiveSolver;
+        friend class MultiThreadDataManager;
+
+private:
+        // don't allow copy constructor!
+        SpNaiveMatrixHandler(const SpNaiveMatrixHandler&);
+
+protected:
+        integer iSize;
+        spnaiv_mat m;
+        const std::vector<integer> *pPerm;
+        const std::vector<integer> *pInvPerm;
+
+        integer iGetCol(integer iCol) const {
+                return pPerm ? (*pPerm)[iCol] : iCol;
+        };
+
+        integer iGetInvCol(integer iCol) const {
+                return pInvPerm ? (*pInvPerm)[iCol] : iCol;
+        };
+
+public:
+#ifdef DEBUG
+        virtual void IsValid(void) const override;
+#endif /* DEBUG */
+	using MatrixHandler::operator=;
+        class const_iterator {
+                friend class SpNaiveMatrixHandler;
+
+        private:
+                const SpNaiveMatrixHandler& m;
+                mutable integer i_row;
+                mutable SparseMatrixHandler::SparseMatrixElement elem;
+
+        protected:
+                void reset(bool is_end = false);
+
+        public:
+                const_iterator(const SpNaiveMatrixHandler& m, bool is_end = false);
+                ~const_iterator(void);
+                const SpNaiveMatrixHandler::const_iterator& operator ++ (void) const;
+                const SparseMatrixHandler::SparseMatrixElement* operator -> (void) const;
+                const SparseMatrixHandler::SparseMatrixElement& operator * (void) const;
+                bool operator == (const SpNaiveMatrixHandler::const_iterator& op) const;
+                bool operator != (const SpNaiveMatrixHandler::const_iterator& op) const;
+        };
+
+protected:
+        const_iterator m_end;
+
+public:
+        SpNaiveMatrixHandler::const_iterator begin(void) const {
+                return const_iterator(*this);
+        };
+
+        const SpNaiveMatrixHandler::const_iterator& end(void) const {
+                return m_end;
+        };
+
+public:
+        /* always square; perm/invperm, if any, as in NaivePermMatrixHandler */
+        SpNaiveMatrixHandler(const integer n,
+                const std::vector<integer> *pPerm = 0,
+                const std::vector<integer> *pInvPerm = 0);
+
+        virtual ~SpNaiveMatrixHandler(void);
+
+        integer iGetNumRows(void) const override {
+                return iSize;
+        };
+
+        integer iGetNumCols(void) const override {
+                return iSize;
+        };
+
+        const std::vector<integer> *pGetPerm(void) const {
+                return pPerm;
+        };
+
+        const std::vector<integer> *pGetInvPerm(void) const {
+                return pInvPerm;
+        };
+
+        /* bytes currently allocated for the matrix (fill-in included) */
+        size_t GetMemorySize(void) const;
+
+        void Reset(void) override;
+
+        /* Ridimensiona la matrice */
+        virtual void Resize(integer, integer) override {
+                throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+        };
+
+        virtual inline const doublereal&
+        operator () (integer iRow, integer iCol) const override;
+
+        virtual inline doublereal&
+        operator () (integer iRow, integer iCol) override;
+
+        /* Overload di += usato per l'assemblaggio delle matrici */
+        virtual MatrixHandler& operator += (const SubMatrixHandler& SubMH) override;
+
+        /* Overload di -= usato per l'assemblaggio delle matrici */
+        virtual MatrixHandler& operator -= (const SubMatrixHandler& SubMH) override;
+
+        virtual MatrixHandler&
+        operator += (const VariableSubMatrixHandler& SubMH) override;
+        virtual MatrixHandler&
+        operator -= (const VariableSubMatrixHandler& SubMH) override;
+
+        /* structure of the stored (i.e. permuted) matrix */
+        void MakeCCStructure(std::vector<integer>& Ai,
+                std::vector<integer>& Ap);
+
+        virtual
+        void Scale(const std::vector<doublereal>& oRowScale, const std::vector<doublereal>& oColScale) override;
+
+        virtual void EnumerateNz(const std::function<EnumerateNzCallback>& func) const override;
+protected:
+        /* Matrix Matrix product */
+        virtual MatrixHandler&
+        MatMatMul_base(void (MatrixHandler::*op)(integer iRow, integer iCol,
+                                const doublereal& dCoef),
+                        MatrixHandler& out, const MatrixHandler& in) const override;
+        virtual MatrixHandler&
+        MatTMatMul_base(void (MatrixHandler::*op)(integer iRow, integer iCol,
+                                const doublereal& dCoef),
+                        MatrixHandler& out, const MatrixHandler& in) const override;
+
+        /* Matrix Vector product */
+        virtual VectorHandler&
+        MatVecMul_base(void (VectorHandler::*op)(integer iRow,
+                                const doublereal& dCoef),
+                        VectorHandler& out, const VectorHandler& in) const override;
+        virtual VectorHandler&
+        MatTVecMul_base(void (VectorHandler::*op)(integer iRow,
+                                const doublereal& dCoef),
+                        VectorHandler& out, const VectorHandler& in) const override;
+        virtual SpNaiveMatrixHandler* Copy() const override;
+};
+
+
+const doublereal&
+SpNaiveMatrixHandler::operator () (integer iRow, integer iCol) const
+{
+        ASSERT(iRow > 0);
+        ASSERT(iRow <= iGetNumRows());
+        ASSERT(iCol > 0);
+        ASSERT(iCol <= iGetNumCols());
+
+        const doublereal *pd = spnaiv_get(&m, iRow - 1, iGetCol(iCol - 1));
+        if (pd) {
+                return *pd;
+        }
+        return ::Zero1;
+}
+
+doublereal&
+SpNaiveMatrixHandler::operator () (integer iRow, integer iCol)
+{
+        ASSERT(iRow > 0);
+        ASSERT(iRow <= iGetNumRows());
+        ASSERT(iCol > 0);
+        ASSERT(iCol <= iGetNumCols());
+
+        doublereal *pd = spnaiv_ref(&m, iRow - 1, iGetCol(iCol - 1));
+        if (pd == 0) {
+                throw std::bad_alloc();
+        }
+
+        return *pd;
+}
+
+#endif /* SPNAIVEMH_H */
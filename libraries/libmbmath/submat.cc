@@ -1828,6 +1828,17 @@ integer SpGradientSubMatrixHandler::iGetNumCols() const
      return 0;
 }
 
+integer SpGradientSubMatrixHandler::iGetNumItems() const
+{
+     integer iNumItems = 0;
+
+     for (const auto& oItem: oVec) {
+          iNumItems += oItem.oResidual.iGetSize();
+     }
+
+     return iNumItems;
+}
+
 void SpGradientSubMatrixHandler::PutRowIndex(integer iSubIt, integer iRow)
 {
      throw ErrNotImplementedYet(MBDYN_EXCEPT_ARGS);
@@ -192,6 +192,7 @@ class FullSubMatrixHandler :
 
      friend class NaiveMatrixHandler;
      friend class NaivePermMatrixHandler;
+     friend class SpNaiveMatrixHandler;
 
 protected:
      /* Dimensione totale del vettore di incidenza */
@@ -773,6 +774,7 @@ class SparseSubMatrixHandler : public SubMatrixHandler {
      friend class FullMatrixHandler;
      friend class NaiveMatrixHandler;
      friend class NaivePermMatrixHandler;
+     friend class SpNaiveMatrixHandler;
 
 public:
      /* Errori */
@@ -1153,6 +1155,7 @@ public:
      virtual const doublereal& operator()(integer iRow, integer iCol) const override;
      virtual integer iGetNumRows() const override;
      virtual integer iGetNumCols() const override;
+     integer iGetNumItems() const;
      virtual void PutRowIndex(integer iSubIt, integer iRow) override;
      virtual void PutColIndex(integer iSubIt, integer iRow) override;
      virtual integer iGetRowIndex(integer) const override;
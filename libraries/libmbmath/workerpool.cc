@@ -0,0 +1,183 @@
+/* $Header$ */
+/*
+ * MBDyn (C) is a multibody analysis code.
+ * http://www.mbdyn.org
+ *
+ * Copyright (C) 1996-2023
+ *
+ * Pierangelo Masarati	<pierangelo.masarati@polimi.it>
+ * Paolo Mantegazza	<paolo.mantegazza@polimi.it>
+ *
+ * Dipartimento di Ingegneria Aerospaziale - Politecnico di Milano
+ * via La Masa, 34 - 20156 Milano, Italy
+ * http://www.aero.polimi.it
+ *
+ * Changing this copyright notice is forbidden.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation (version 2 of the License).
+ *
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "mbconfig.h"           /* This goes first in every *.c,*.cc file */
+
+#include "workerpool.h"
+
+/* per il debugging */
+#include "myassert.h"
+
+/* WorkerPool - begin */
+
+WorkerPool::WorkerPool(void)
+#ifdef HAVE_THREADS
+: nWorkers(0), pFunc(0), nChunks(0), uJob(0), uPending(0), bStop(false)
+#endif // HAVE_THREADS
+{
+	NO_OP;
+}
+
+WorkerPool::~WorkerPool(void)
+{
+#ifdef HAVE_THREADS
+	Stop();
+#endif // HAVE_THREADS
+}
+
+void
+WorkerPool::SetWorkers(unsigned n)
+{
+#ifdef HAVE_THREADS
+	if (n == nWorkers) {
+		return;
+	}
+
+	/* the new workers are started by the next job */
+	std::lock_guard<std::mutex> lockJob(mtxJob);
+	Stop();
+	nWorkers = n;
+#endif // HAVE_THREADS
+}
+
+unsigned
+WorkerPool::uGetWorkers(void) const
+{
+#ifdef HAVE_THREADS
+	return nWorkers;
+#else // ! HAVE_THREADS
+	return 0;
+#endif // ! HAVE_THREADS
+}
+
+#ifdef HAVE_THREADS
+void
+WorkerPool::Start(void)
+{
+	ASSERT(Workers.empty());
+
+	bStop = false;
+	Workers.reserve(nWorkers);
+	for (unsigned t = 0; t < nWorkers; t++) {
+		Workers.emplace_back(&WorkerPool::WorkerFunc, this, t, uJob);
+	}
+}
+
+void
+WorkerPool::Stop(void)
+{
+	if (Workers.empty()) {
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		bStop = true;
+	}
+	condStart.notify_all();
+
+	for (std::vector<std::thread>::iterator i = Workers.begin();
+		i != Workers.end(); ++i)
+	{
+		i->join();
+	}
+
+	Workers.clear();
+}
+
+void
+WorkerPool::WorkerFunc(unsigned t, unsigned long uLastJob)
+{
+	/* uLastJob is the last job before the worker was started:
+	 * jobs posted before the thread runs are not missed */
+	std::unique_lock<std::mutex> lock(mtx);
+
+	while (true) {
+		condStart.wait(lock, [this, uLastJob] { return bStop || uJob != uLastJob; });
+		if (bStop) {
+			break;
+		}
+
+		uLastJob = uJob;
+		const ChunkFunc *pf = pFunc;
+		const unsigned c = t + 1;
+		const bool bRun = (c < nChunks);
+		lock.unlock();
+
+		if (bRun) {
+			(*pf)(c);
+		}
+
+		lock.lock();
+		if (--uPending == 0) {
+			condDone.notify_one();
+		}
+	}
+}
+#endif // HAVE_THREADS
+
+void
+WorkerPool::Run(unsigned nChunks, const ChunkFunc& f)
+{
+	ASSERT(nChunks <= uGetWorkers() + 1);
+
+#ifdef HAVE_THREADS
+	if (nChunks > 1) {
+		std::lock_guard<std::mutex> lockJob(mtxJob);
+
+		if (Workers.size() != nWorkers) {
+			Start();
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(mtx);
+			pFunc = &f;
+			this->nChunks = nChunks;
+			uPending = Workers.size();
+			uJob++;
+		}
+		condStart.notify_all();
+
+		f(0);
+
+		std::unique_lock<std::mutex> lock(mtx);
+		condDone.wait(lock, [this] { return uPending == 0; });
+
+		return;
+	}
+#endif // HAVE_THREADS
+
+	if (nChunks > 0) {
+		f(0);
+	}
+}
+
+/* WorkerPool - end */
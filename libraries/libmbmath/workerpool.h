@@ -0,0 +1,99 @@
+/* $Header$ */
+/*
+ * MBDyn (C) is a multibody analysis code.
+ * http://www.mbdyn.org
+ *
+ * Copyright (C) 1996-2023
+ *
+ * Pierangelo Masarati	<pierangelo.masarati@polimi.it>
+ * Paolo Mantegazza	<paolo.mantegazza@polimi.it>
+ *
+ * Dipartimento di Ingegneria Aerospaziale - Politecnico di Milano
+ * via La Masa, 34 - 20156 Milano, Italy
+ * http://www.aero.polimi.it
+ *
+ * Changing this copyright notice is forbidden.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation (version 2 of the License).
+ *
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Persistent pool of worker threads that run chunks of a job
+ * on behalf of a caller: worker t runs chunk t + 1 of the current job,
+ * the caller runs chunk 0 and waits for the others.
+ * The workers are started by the first job after their number is set
+ * and then wait for the next ones, so a job costs no thread creation,
+ * and setting the number several times before the first job is cheap.
+ */
+
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+
+#include <functional>
+#ifdef HAVE_THREADS
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#endif // HAVE_THREADS
+
+/* WorkerPool - begin */
+
+class WorkerPool {
+public:
+	/* called with the index of the chunk, 0 <= c < nChunks */
+	typedef std::function<void (unsigned)> ChunkFunc;
+
+private:
+#ifdef HAVE_THREADS
+	std::vector<std::thread> Workers;
+	unsigned nWorkers;
+	/* serializes concurrent jobs */
+	std::mutex mtxJob;
+	std::mutex mtx;
+	std::condition_variable condStart;
+	std::condition_variable condDone;
+	const ChunkFunc *pFunc;
+	unsigned nChunks;
+	unsigned long uJob;
+	unsigned uPending;
+	bool bStop;
+
+	void WorkerFunc(unsigned t, unsigned long uLastJob);
+	void Start(void);
+	void Stop(void);
+#endif // HAVE_THREADS
+
+public:
+	WorkerPool(void);
+	~WorkerPool(void);
+
+	WorkerPool(const WorkerPool&) = delete;
+	WorkerPool& operator = (const WorkerPool&) = delete;
+
+	/* sets the number of workers; running workers are stopped
+	 * if it changes.  Without threads, it is a no-op */
+	void SetWorkers(unsigned n);
+
+	unsigned uGetWorkers(void) const;
+
+	/* runs f(0), ..., f(nChunks - 1); chunks past the number
+	 * of workers plus one are not run, so nChunks must not exceed it */
+	void Run(unsigned nChunks, const ChunkFunc& f);
+};
+
+/* WorkerPool - end */
+
+#endif // WORKERPOOL_H
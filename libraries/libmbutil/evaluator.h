@@ -39,14 +39,19 @@
 
 #include "mathtyp.h"
 
+// see "evaluator_bc.h"
+class EECompiler;
+struct EEOperand;
+
 class ExpressionElement {
 public:
 	enum EEFlags {
 		EE_NONE = 0x0U,
 
 		EE_CONSTIFY = 0x1U,
+		EE_BYTECODE = 0x2U,
 
-		EE_OPTIMIZE = EE_CONSTIFY
+		EE_OPTIMIZE = (EE_CONSTIFY | EE_BYTECODE)
 	};
 
 protected:
@@ -60,6 +65,10 @@ public:
 	virtual TypedValue Eval(void) const = 0;
 	virtual std::ostream& Output(std::ostream& out) const = 0;
 
+	// compiles the expression into bytecode; returns false
+	// if not supported, and then Eval() must be used
+	virtual bool Compile(EECompiler& c, EEOperand& dst) const { return false; };
+
 	static unsigned GetFlags(void) { return m_uEEFlags; };
 	static void SetFlag(EEFlags f) { m_uEEFlags |= unsigned(f); };
 	static void ClearFlag(EEFlags f) { m_uEEFlags &= !unsigned(f); };
@@ -0,0 +1,524 @@
+/* $Header$ */
+/* 
+ * MBDyn (C) is a multibody analysis code. 
+ * http://www.mbdyn.org
+ *
+ * Copyright (C) 1996-2023
+ *
+ * Pierangelo Masarati	<pierangelo.masarati@polimi.it>
+ * Paolo Mantegazza	<paolo.mantegazza@polimi.it>
+ *
+ * Dipartimento di Ingegneria Aerospaziale - Politecnico di Milano
+ * via La Masa, 34 - 20156 Milano, Italy
+ * http://www.aero.polimi.it
+ *
+ * Changing this copyright notice is forbidden.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation (version 2 of the License).
+ * 
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "mbconfig.h"           /* This goes first in every *.c,*.cc file */
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <typeinfo>
+
+#include "mathp.h"
+
+#ifndef DO_NOT_USE_EE
+
+#include "evaluator_impl.h"
+
+/* EE_Bytecode - begin */
+
+EE_Bytecode::EE_Bytecode(void)
+: iNumRegs(0), iResult(0)
+{
+	NO_OP;
+}
+
+EE_Bytecode::~EE_Bytecode(void)
+{
+	NO_OP;
+}
+
+EE_Bytecode *
+EE_Bytecode::Compile(const ExpressionElement *ee)
+{
+	if (ee == 0 || !ExpressionElement::IsFlag(ExpressionElement::EE_BYTECODE)) {
+		return 0;
+	}
+
+	EE_Bytecode *pBC = new EE_Bytecode;
+	EECompiler c(pBC);
+	EEOperand res;
+
+	if (!ee->Compile(c, res) || !c.ToReg(res, pBC->iResult)) {
+		delete pBC;
+		return 0;
+	}
+
+	return pBC;
+}
+
+void
+EE_Bytecode::DoCall(const Call& c, Real *r, Real& dst) const
+{
+	MathParser::MathFunc_t *f = c.pFunc;
+
+	// same as EE_Func::Eval()
+	for (unsigned i = 0, j = 0, k = 0; i < c.RegArgs.size() + c.TreeArgs.size(); i++) {
+		if (j < c.RegArgs.size() && (k == c.TreeArgs.size() || c.RegArgs[j].first < c.TreeArgs[k])) {
+			(*static_cast<MathParser::MathArgReal_t *>(f->args[c.RegArgs[j].first]))() = r[c.RegArgs[j].second];
+			j++;
+
+		} else {
+			f->args[c.TreeArgs[k]]->Eval();
+			k++;
+		}
+	}
+
+	if (f->t != 0) {
+		if (f->t(f->args)) {
+			DEBUGCERR("error in function "
+				<< f->ns->sGetName() << "::" << f->fname
+				<< " " "(msg: " << f->errmsg << ")"
+				<< " in EE_Bytecode()" << std::endl);
+			throw MathParser::ErrGeneric(c.pParser, MBDYN_EXCEPT_ARGS,
+				f->fname + ": error " + f->errmsg);
+		}
+	}
+
+	// same as MathParser::StaticNameSpace::EvalFunc()
+	f->f(f->args);
+
+	switch (f->args[0]->Type()) {
+	case MathParser::AT_BOOL:
+		dst = TypedValue((*static_cast<MathParser::MathArgBool_t *>(f->args[0]))()).GetReal();
+		break;
+
+	case MathParser::AT_INT:
+		dst = TypedValue((*static_cast<MathParser::MathArgInt_t *>(f->args[0]))()).GetReal();
+		break;
+
+	case MathParser::AT_REAL:
+		dst = (*static_cast<MathParser::MathArgReal_t *>(f->args[0]))();
+		break;
+
+	default:
+		// not compiled
+		ASSERT(0);
+		throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+	}
+}
+
+bool
+EE_Bytecode::Eval(Real& d) const
+{
+	// registers: constants, variables, temporaries
+	Real aBuf[64];
+	std::vector<Real> Buf;
+	Real *r = aBuf;
+	if (iNumRegs > sizeof(aBuf)/sizeof(aBuf[0])) {
+		Buf.resize(iNumRegs);
+		r = &Buf[0];
+	}
+
+	for (std::vector<std::pair<unsigned, Real> >::const_iterator i = Consts.begin(); i != Consts.end(); ++i) {
+		r[i->first] = i->second;
+	}
+
+	for (std::vector<VarLoad>::const_iterator i = Vars.begin(); i != Vars.end(); ++i) {
+		TypedValue v(i->pVar->GetVal());
+		if (v.GetType() != i->type) {
+			return false;
+		}
+		r[i->iReg] = v.GetReal();
+	}
+
+	for (std::vector<Instr>::const_iterator i = Code.begin(); i != Code.end(); ++i) {
+		switch (i->op) {
+		case EEBC_ADD:
+			r[i->iDst] = r[i->iA] + r[i->iB];
+			break;
+
+		case EEBC_SUB:
+			r[i->iDst] = r[i->iA] - r[i->iB];
+			break;
+
+		case EEBC_MUL:
+			r[i->iDst] = r[i->iA]*r[i->iB];
+			break;
+
+		case EEBC_DIV:
+			// same as EE_Divide::Eval()
+			if (i->bCheck && std::abs(r[i->iB]) < std::numeric_limits<double>::epsilon()) {
+				std::cout << "denominator cannot be zero" << std::endl;
+			}
+			r[i->iDst] = r[i->iA]/r[i->iB];
+			break;
+
+		case EEBC_POW:
+			r[i->iDst] = std::pow(r[i->iA], r[i->iB]);
+			break;
+
+		case EEBC_NEG:
+			r[i->iDst] = -r[i->iA];
+			break;
+
+		case EEBC_GT:
+			r[i->iDst] = (r[i->iA] > r[i->iB]);
+			break;
+
+		case EEBC_GE:
+			r[i->iDst] = (r[i->iA] >= r[i->iB]);
+			break;
+
+		case EEBC_EQ:
+			r[i->iDst] = (r[i->iA] == r[i->iB]);
+			break;
+
+		case EEBC_LE:
+			r[i->iDst] = (r[i->iA] <= r[i->iB]);
+			break;
+
+		case EEBC_LT:
+			r[i->iDst] = (r[i->iA] < r[i->iB]);
+			break;
+
+		case EEBC_NE:
+			r[i->iDst] = (r[i->iA] != r[i->iB]);
+			break;
+
+		case EEBC_AND:
+			r[i->iDst] = (r[i->iA] && r[i->iB]);
+			break;
+
+		case EEBC_OR:
+			r[i->iDst] = (r[i->iA] || r[i->iB]);
+			break;
+
+		case EEBC_XOR:
+			r[i->iDst] = ((!(r[i->iA] && r[i->iB])) && (r[i->iA] || r[i->iB]));
+			break;
+
+		case EEBC_NOT:
+			r[i->iDst] = (!r[i->iA]);
+			break;
+
+		case EEBC_CALL:
+			DoCall(Calls[i->iB], r, r[i->iDst]);
+			break;
+
+		default:
+			ASSERT(0);
+			throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+		}
+	}
+
+	d = r[iResult];
+
+	return true;
+}
+
+/* EE_Bytecode - end */
+
+/* EECompiler - begin */
+
+EECompiler::EECompiler(EE_Bytecode *pBC)
+: m_pBC(pBC)
+{
+	NO_OP;
+}
+
+EECompiler::~EECompiler(void)
+{
+	NO_OP;
+}
+
+bool
+EECompiler::bIsNumeric(TypedValue::Type t)
+{
+	return t == TypedValue::VAR_BOOL || t == TypedValue::VAR_INT || t == TypedValue::VAR_REAL;
+}
+
+bool
+EECompiler::bIsIntegral(TypedValue::Type t)
+{
+	return t == TypedValue::VAR_BOOL || t == TypedValue::VAR_INT;
+}
+
+unsigned
+EECompiler::NewReg(void)
+{
+	return m_pBC->iNumRegs++;
+}
+
+// constants are moved to registers only when used
+// along with non-constant operands
+bool
+EECompiler::ToReg(const EEOperand& a, unsigned& iReg)
+{
+	if (!bIsNumeric(a.type)) {
+		return false;
+	}
+
+	if (!a.bConst) {
+		iReg = a.iReg;
+		return true;
+	}
+
+	const Real d = a.Val.GetReal();
+	for (std::vector<std::pair<unsigned, Real> >::const_iterator i = m_pBC->Consts.begin(); i != m_pBC->Consts.end(); ++i) {
+		// NOTE: compare bit patterns, to tell -0. from 0.
+		if (std::memcmp(&i->second, &d, sizeof(d)) == 0) {
+			iReg = i->first;
+			return true;
+		}
+	}
+
+	iReg = NewReg();
+	m_pBC->Consts.push_back(std::pair<unsigned, Real>(iReg, d));
+
+	return true;
+}
+
+bool
+EECompiler::Const(const TypedValue& v, EEOperand& dst)
+{
+	if (!bIsNumeric(v.GetType())) {
+		return false;
+	}
+
+	dst.bConst = true;
+	dst.Val = v;
+	dst.type = v.GetType();
+
+	return true;
+}
+
+bool
+EECompiler::Var(const NamedValue *v, EEOperand& dst)
+{
+	TypedValue::Type type = v->GetType();
+	if (!bIsNumeric(type)) {
+		return false;
+	}
+
+	// each variable is loaded once
+	for (std::vector<EE_Bytecode::VarLoad>::const_iterator i = m_pBC->Vars.begin(); i != m_pBC->Vars.end(); ++i) {
+		if (i->pVar == v) {
+			dst.bConst = false;
+			dst.iReg = i->iReg;
+			dst.type = i->type;
+			return true;
+		}
+	}
+
+	EE_Bytecode::VarLoad l;
+	l.pVar = v;
+	l.type = type;
+	l.iReg = NewReg();
+	m_pBC->Vars.push_back(l);
+
+	dst.bConst = false;
+	dst.iReg = l.iReg;
+	dst.type = type;
+
+	return true;
+}
+
+// fold by evaluating the subexpression with the tree walker
+static bool
+EEFold(EECompiler& c, const ExpressionElement *ee, EEOperand& dst)
+{
+	TypedValue v;
+
+	try {
+		v = ee->Eval();
+
+	} catch (...) {
+		// leave the error to the tree walker, at run time
+		return false;
+	}
+
+	return c.Const(v, dst);
+}
+
+bool
+EECompiler::Unary(const ExpressionElement *ee, EE_Bytecode::Op op,
+	const EEOperand& a, EEOperand& dst)
+{
+	if (a.bConst) {
+		return EEFold(*this, ee, dst);
+	}
+
+	TypedValue::Type type;
+	switch (op) {
+	case EE_Bytecode::EEBC_NEG:
+		// integer negation would be needed
+		if (a.type != TypedValue::VAR_REAL) {
+			return false;
+		}
+		type = TypedValue::VAR_REAL;
+		break;
+
+	case EE_Bytecode::EEBC_NOT:
+		type = TypedValue::VAR_BOOL;
+		break;
+
+	default:
+		return false;
+	}
+
+	EE_Bytecode::Instr i;
+	i.op = op;
+	i.iA = i.iB = a.iReg;
+	i.bCheck = false;
+	i.iDst = NewReg();
+	m_pBC->Code.push_back(i);
+
+	dst.bConst = false;
+	dst.iReg = i.iDst;
+	dst.type = type;
+
+	return true;
+}
+
+bool
+EECompiler::Binary(const ExpressionElement *ee, EE_Bytecode::Op op,
+	const EEOperand& a, const EEOperand& b, EEOperand& dst)
+{
+	if (a.bConst && b.bConst) {
+		return EEFold(*this, ee, dst);
+	}
+
+	TypedValue::Type type;
+	switch (op) {
+	case EE_Bytecode::EEBC_ADD:
+	case EE_Bytecode::EEBC_SUB:
+	case EE_Bytecode::EEBC_MUL:
+	case EE_Bytecode::EEBC_DIV:
+	case EE_Bytecode::EEBC_POW:
+		// integer arithmetic would be needed
+		if (bIsIntegral(a.type) && bIsIntegral(b.type)) {
+			return false;
+		}
+		type = TypedValue::VAR_REAL;
+		break;
+
+	case EE_Bytecode::EEBC_GT:
+	case EE_Bytecode::EEBC_GE:
+	case EE_Bytecode::EEBC_EQ:
+	case EE_Bytecode::EEBC_LE:
+	case EE_Bytecode::EEBC_LT:
+	case EE_Bytecode::EEBC_NE:
+	case EE_Bytecode::EEBC_AND:
+	case EE_Bytecode::EEBC_OR:
+	case EE_Bytecode::EEBC_XOR:
+		type = TypedValue::VAR_BOOL;
+		break;
+
+	default:
+		return false;
+	}
+
+	EE_Bytecode::Instr i;
+	if (!ToReg(a, i.iA) || !ToReg(b, i.iB)) {
+		return false;
+	}
+	i.op = op;
+	i.bCheck = (op == EE_Bytecode::EEBC_DIV && b.type == TypedValue::VAR_REAL);
+	i.iDst = NewReg();
+	m_pBC->Code.push_back(i);
+
+	dst.bConst = false;
+	dst.iReg = i.iDst;
+	dst.type = type;
+
+	return true;
+}
+
+bool
+EECompiler::Call(MathParser *p, MathParser::MathFunc_t *f, EEOperand& dst)
+{
+	// only functions whose result type is known in advance
+	if (f->ns == 0 || typeid(*f->ns) != typeid(MathParser::StaticNameSpace) || f->f == 0) {
+		return false;
+	}
+
+	switch (f->args[0]->Type()) {
+	case MathParser::AT_BOOL:
+		dst.type = TypedValue::VAR_BOOL;
+		break;
+
+	case MathParser::AT_INT:
+		dst.type = TypedValue::VAR_INT;
+		break;
+
+	case MathParser::AT_REAL:
+		dst.type = TypedValue::VAR_REAL;
+		break;
+
+	default:
+		return false;
+	}
+
+	EE_Bytecode::Call call;
+	call.pParser = p;
+	call.pFunc = f;
+
+	for (unsigned i = 1; i < f->args.size(); i++) {
+		const ExpressionElement *ee = f->args[i]->GetExpr();
+		if (ee == 0) {
+			continue;
+		}
+
+		EEOperand a;
+		if (!ee->Compile(*this, a)) {
+			return false;
+		}
+
+		if (a.bConst) {
+			// let the argument evaluate its constant expression
+			call.TreeArgs.push_back(i);
+
+		} else if (f->args[i]->Type() == MathParser::AT_REAL) {
+			call.RegArgs.push_back(std::pair<unsigned, unsigned>(i, a.iReg));
+
+		} else {
+			return false;
+		}
+	}
+
+	EE_Bytecode::Instr i;
+	i.op = EE_Bytecode::EEBC_CALL;
+	i.iA = 0;
+	i.iB = m_pBC->Calls.size();
+	i.bCheck = false;
+	i.iDst = NewReg();
+	m_pBC->Code.push_back(i);
+	m_pBC->Calls.push_back(call);
+
+	dst.bConst = false;
+	dst.iReg = i.iDst;
+
+	return true;
+}
+
+/* EECompiler - end */
+
+#endif // DO_NOT_USE_EE
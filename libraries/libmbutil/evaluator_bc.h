@@ -0,0 +1,165 @@
+/* $Header$ */
+/* 
+ * MBDyn (C) is a multibody analysis code. 
+ * http://www.mbdyn.org
+ *
+ * Copyright (C) 1996-2023
+ *
+ * Pierangelo Masarati	<pierangelo.masarati@polimi.it>
+ * Paolo Mantegazza	<paolo.mantegazza@polimi.it>
+ *
+ * Dipartimento di Ingegneria Aerospaziale - Politecnico di Milano
+ * via La Masa, 34 - 20156 Milano, Italy
+ * http://www.aero.polimi.it
+ *
+ * Changing this copyright notice is forbidden.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation (version 2 of the License).
+ * 
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Register-based bytecode for real-valued expressions.
+ *
+ * The expression tree is compiled once into a flat sequence
+ * of instructions operating on an array of Real registers;
+ * subexpressions whose operands are constant are folded
+ * by evaluating them with the tree walker.  Only expressions
+ * whose non-constant subexpressions are known to be real
+ * (or boolean, in logical and relational contexts) are compiled;
+ * the tree walker remains the reference implementation
+ * and the results are identical.
+ */
+
+#ifndef EVALUATOR_BC_H
+#define EVALUATOR_BC_H
+
+#include <vector>
+
+#include "mathp.h"
+
+/* result of the compilation of a subexpression */
+struct EEOperand {
+	bool bConst;
+	TypedValue Val;		/* if bConst */
+	unsigned iReg;		/* otherwise */
+	TypedValue::Type type;
+
+	EEOperand(void) : bConst(false), iReg(0), type(TypedValue::VAR_UNKNOWN) {};
+};
+
+class EE_Bytecode {
+	friend class EECompiler;
+
+public:
+	enum Op {
+		EEBC_ADD,
+		EEBC_SUB,
+		EEBC_MUL,
+		EEBC_DIV,
+		EEBC_POW,
+		EEBC_NEG,
+
+		EEBC_GT,
+		EEBC_GE,
+		EEBC_EQ,
+		EEBC_LE,
+		EEBC_LT,
+		EEBC_NE,
+
+		EEBC_AND,
+		EEBC_OR,
+		EEBC_XOR,
+		EEBC_NOT,
+
+		EEBC_CALL,
+
+		EEBC_LAST
+	};
+
+protected:
+	struct Instr {
+		Op op;
+		unsigned iDst;
+		unsigned iA;
+		unsigned iB;		/* or index of call, if EEBC_CALL */
+		bool bCheck;		/* EEBC_DIV: check for zero denominator */
+	};
+
+	/* variables, loaded once when evaluation starts */
+	struct VarLoad {
+		const NamedValue *pVar;
+		TypedValue::Type type;
+		unsigned iReg;
+	};
+
+	/* function calls */
+	struct Call {
+		MathParser *pParser;
+		MathParser::MathFunc_t *pFunc;
+		/* arguments set from registers (MathArgReal_t only) */
+		std::vector<std::pair<unsigned, unsigned> > RegArgs;
+		/* arguments evaluated by the tree walker (constant) */
+		std::vector<unsigned> TreeArgs;
+	};
+
+	std::vector<std::pair<unsigned, Real> > Consts;	/* register, value */
+	std::vector<VarLoad> Vars;
+	std::vector<Instr> Code;
+	std::vector<Call> Calls;
+	unsigned iNumRegs;
+	unsigned iResult;
+
+	EE_Bytecode(void);
+
+	void DoCall(const Call& c, Real *r, Real& dst) const;
+
+public:
+	~EE_Bytecode(void);
+
+	/* returns 0 if the expression cannot be compiled */
+	static EE_Bytecode *Compile(const ExpressionElement *ee);
+
+	/* returns false if any variable changed type since compilation;
+	 * in that case, nothing was evaluated and Eval() must be used */
+	bool Eval(Real& d) const;
+
+	unsigned iGetNumInstr(void) const { return Code.size(); };
+};
+
+class EECompiler {
+protected:
+	EE_Bytecode *m_pBC;
+
+	unsigned NewReg(void);
+	static bool bIsNumeric(TypedValue::Type t);
+	static bool bIsIntegral(TypedValue::Type t);
+
+public:
+	EECompiler(EE_Bytecode *pBC);
+	~EECompiler(void);
+
+	bool ToReg(const EEOperand& a, unsigned& iReg);
+	bool Const(const TypedValue& v, EEOperand& dst);
+	bool Var(const NamedValue *v, EEOperand& dst);
+
+	/* ee is used to fold constant operands */
+	bool Unary(const ExpressionElement *ee, EE_Bytecode::Op op,
+		const EEOperand& a, EEOperand& dst);
+	bool Binary(const ExpressionElement *ee, EE_Bytecode::Op op,
+		const EEOperand& a, const EEOperand& b, EEOperand& dst);
+	bool Call(MathParser *p, MathParser::MathFunc_t *f, EEOperand& dst);
+};
+
+#endif // EVALUATOR_BC_H
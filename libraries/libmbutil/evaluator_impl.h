@@ -43,6 +43,7 @@
 #include <limits>
 
 // "evaluator.h" must be explicitly included
+#include "evaluator_bc.h"
 
 // for storing constant values like "1","1.23"
 class EE_Value : public ExpressionElement {
@@ -65,6 +66,12 @@ public:
 	{
 		return out << m_Val;
 	};
+
+	bool
+	Compile(EECompiler& c, EEOperand& dst) const
+	{
+		return c.Const(m_Val, dst);
+	};
 };
 
 // for storing non const variable like "a", "b"
@@ -97,6 +104,12 @@ public:
 
 		return out << m_Var->GetName();
 	};
+
+	virtual bool
+	Compile(EECompiler& c, EEOperand& dst) const
+	{
+		return c.Var(m_Var, dst);
+	};
 };
 
 class EE_Plus : public ExpressionElement {
@@ -119,6 +132,14 @@ public:
 	{
 		return out << "(", m_pEE1->Output(out) << " + ", m_pEE2->Output(out) << ")";
 	};
+
+	bool
+	Compile(EECompiler& c, EEOperand& dst) const
+	{
+		EEOperand a, b;
+		return m_pEE1->Compile(c, a) && m_pEE2->Compile(c, b)
+			&& c.Binary(this, EE_Bytecode::EEBC_ADD, a, b, dst);
+	};
 };
 
 class EE_Minus : public ExpressionElement {
@@ -141,6 +162,14 @@ public:
 	{
 		return out << "(", m_pEE1->Output(out) << " - ", m_pEE2->Output(out) << ")";
 	};
+
+	bool
+	Compile(EECompiler& c, EEOperand& dst) const
+	{
+		EEOperand a, b;
+		return m_pEE1->Compile(c, a) && m_pEE2->Compile(c, b)
+			&& c.Binary(this, EE_Bytecode::EEBC_SUB, a, b, dst);
+	};
 };
 
 class EE_Modulus : public ExpressionElement {
@@ -197,6 +226,15 @@ public:
 	{
 		return out << "(", m_pEE1->Output(out) << " % ", m_pEE2->Output(out) << ")";
 	};
+
+	bool
+	Compile(EECompiler& c, EEOperand& dst) const
+	{
+		// integer only: folded when constant, never compiled
+		EEOperand a, b;
+		return m_pEE1->Compile(c, a) && m_pEE2->Compile(c, b)
+			&& c.Binary(this, EE_Bytecode::EEBC_LAST, a, b, dst);
+	};
 };
 
 class EE_Multiply : public ExpressionElement {
@@ -218,6 +256,14 @@ public:
 	{
 		return out << "(", m_pEE1->Output(out) << " * ", m_pEE2->Output(out) << ")";
 	};
+
+	bool
+	Compile(EECompiler& c, EEOperand& dst) const
+	{
+		EEOperand a, b;
+		return m_pEE1->Compile(c, a) && m_pEE2->Compile(c, b)
+			&& c.Binary(this, EE_Bytecode::EEBC_MUL, a, b, dst);
+	};
 };
 
 class EE_Divide : public ExpressionElement {
@@ -255,6 +301,14 @@ public:
 	{
 		return out << "(", m_pEE1->Output(out) << " / ", m_pEE2->Output(out) << ")";
 	};
+
+	bool
+	Compile(EECompiler& c, EEOperand& dst) const
+	{
+		EEOperand a, b;
+		return m_pEE1->Compile(c, a) && m_pEE2->Compile(c, b)
+			&& c.Binary(this, EE_Bytecode::EEBC_DIV, a, b, dst);
+	};
 };
 
 class EE_Unary_minus : public ExpressionElement {
@@ -276,6 +330,13 @@ public:
 	{
 		return out << "(-", m_pEE1->Output(out) << ")";
 	};
+
+	bool
+	Compile(EECompiler& c, EEOperand& dst) const
+	{
+		EEOperand a;
+		return m_pEE1->Compile(c, a) && c.Unary(this, EE_Bytecode::EEBC_NEG, a, dst);
+	};
 };
 
 class EE_AND : public ExpressionElement {
@@ -297,6 +358,14 @@ public:
 	{
 		return out << "(", m_pEE1->Output(out) << " && ", m_pEE2->Output(out) << ")";
 	};
+
+	bool
+	Compile(EECompiler& c, EEOperand& dst) const
+	{
+		EEOperand a, b;
+		return m_pEE1->Compile(c, a) && m_pEE2->Compile(c, b)
+			&& c.Binary(this, EE_Bytecode::EEBC_AND, a, b, dst);
+	};
 };
 
 class EE_OR : public ExpressionElement {
@@ -318,6 +387,14 @@ public:
 	{
 		return out << "(", m_pEE1->Output(out) << " || ", m_pEE2->Output(out) << ")";
 	};
+
+	bool
+	Compile(EECompiler& c, EEOperand& dst) const
+	{
+		EEOperand a, b;
+		return m_pEE1->Compile(c, a) && m_pEE2->Compile(c, b)
+			&& c.Binary(this, EE_Bytecode::EEBC_OR, a, b, dst);
+	};
 };
 
 class EE_NOT : public ExpressionElement {
@@ -339,6 +416,13 @@ public:
 	{
 		return out << "(!", m_pEE1->Output(out) << ")";
 	};
+
+	bool
+	Compile(EECompiler& c, EEOperand& dst) const
+	{
+		EEOperand a;
+		return m_pEE1->Compile(c, a) && c.Unary(this, EE_Bytecode::EEBC_NOT, a, dst);
+	};
 };
 
 // need to implement ~= as overloaded operator in mathp.cc
@@ -363,6 +447,14 @@ public:
 	{
 		return out << "(", m_pEE1->Output(out) << " ~| ", m_pEE2->Output(out) << ")";
 	};
+
+	bool
+	Compile(EECompiler& c, EEOperand& dst) const
+	{
+		EEOperand a, b;
+		return m_pEE1->Compile(c, a) && m_pEE2->Compile(c, b)
+			&& c.Binary(this, EE_Bytecode::EEBC_XOR, a, b, dst);
+	};
 };
 
 class EE_Greater : public ExpressionElement {
@@ -384,6 +476,14 @@ public:
 	{
 		return out << "(", m_pEE1->Output(out) << " > ", m_pEE2->Output(out) << ")";
 	};
+
+	bool
+	Compile(EECompiler& c, EEOperand& dst) const
+	{
+		EEOperand a, b;
+		return m_pEE1->Compile(c, a) && m_pEE2->Compile(c, b)
+			&& c.Binary(this, EE_Bytecode::EEBC_GT, a, b, dst);
+	};
 };
 
 class EE_Greater_Equal : public ExpressionElement {
@@ -405,6 +505,14 @@ public:
 	{
 		return out << "(", m_pEE1->Output(out) << " >= ", m_pEE2->Output(out) << ")";
 	};
+
+	bool
+	Compile(EECompiler& c, EEOperand& dst) const
+	{
+		EEOperand a, b;
+		return m_pEE1->Compile(c, a) && m_pEE2->Compile(c, b)
+			&& c.Binary(this, EE_Bytecode::EEBC_GE, a, b, dst);
+	};
 };
 
 class EE_Lesser : public ExpressionElement {
@@ -426,6 +534,14 @@ public:
 	{
 		return out << "(", m_pEE1->Output(out) << " < ", m_pEE2->Output(out) << ")";
 	};
+
+	bool
+	Compile(EECompiler& c, EEOperand& dst) const
+	{
+		EEOperand a, b;
+		return m_pEE1->Compile(c, a) && m_pEE2->Compile(c, b)
+			&& c.Binary(this, EE_Bytecode::EEBC_LT, a, b, dst);
+	};
 };
 
 class EE_Lesser_Equal : public ExpressionElement {
@@ -447,6 +563,14 @@ public:
 	{
 		return out << "(", m_pEE1->Output(out) << " <= ", m_pEE2->Output(out) << ")";
 	};
+
+	bool
+	Compile(EECompiler& c, EEOperand& dst) const
+	{
+		EEOperand a, b;
+		return m_pEE1->Compile(c, a) && m_pEE2->Compile(c, b)
+			&& c.Binary(this, EE_Bytecode::EEBC_LE, a, b, dst);
+	};
 };
 
 class EE_Equal_Equal : public ExpressionElement {
@@ -468,6 +592,14 @@ public:
 	{
 		return out << "(", m_pEE1->Output(out) << " == ", m_pEE2->Output(out) << ")";
 	};
+
+	bool
+	Compile(EECompiler& c, EEOperand& dst) const
+	{
+		EEOperand a, b;
+		return m_pEE1->Compile(c, a) && m_pEE2->Compile(c, b)
+			&& c.Binary(this, EE_Bytecode::EEBC_EQ, a, b, dst);
+	};
 };
 
 class EE_Not_Equal : public ExpressionElement {
@@ -489,6 +621,14 @@ public:
 	{
 		return out << "(", m_pEE1->Output(out) << " != ", m_pEE2->Output(out) << ")";
 	};
+
+	bool
+	Compile(EECompiler& c, EEOperand& dst) const
+	{
+		EEOperand a, b;
+		return m_pEE1->Compile(c, a) && m_pEE2->Compile(c, b)
+			&& c.Binary(this, EE_Bytecode::EEBC_NE, a, b, dst);
+	};
 };
 
 class EE_Power : public ExpressionElement {
@@ -528,6 +668,14 @@ public:
 	{
 		return out << "(", m_pEE1->Output(out) << " ^ ", m_pEE2->Output(out) << ")";
 	};
+
+	bool
+	Compile(EECompiler& c, EEOperand& dst) const
+	{
+		EEOperand a, b;
+		return m_pEE1->Compile(c, a) && m_pEE2->Compile(c, b)
+			&& c.Binary(this, EE_Bytecode::EEBC_POW, a, b, dst);
+	};
 };
 
 #if 1
@@ -713,6 +861,12 @@ public:
 
 		return out;
 	};
+
+	bool
+	Compile(EECompiler& c, EEOperand& dst) const
+	{
+		return c.Call(m_p, m_f, dst);
+	};
 };
 
 // unary operator construction helper with optimization
@@ -0,0 +1,253 @@
+/* $Header$ */
+/*
+ * This library comes with MBDyn (C), a multibody analysis code.
+ * http://www.mbdyn.org
+ *
+ * Copyright (C) 1996-2023
+ *
+ * Pierangelo Masarati  <pierangelo.masarati@polimi.it>
+ *
+ * Dipartimento di Ingegneria Aerospaziale - Politecnico di Milano
+ * via La Masa, 34 - 20156 Milano, Italy
+ * http://www.aero.polimi.it
+ *
+ * Changing this copyright notice is forbidden.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation (version 2 of the License).
+ *
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Compares the bytecode of real-valued expressions with the tree walker,
+ * which is the reference: results must be identical bit by bit,
+ * and either both or none must throw.
+ *
+ * usage: evaluatortest [-v] ["expression" ...]
+ */
+
+#include "mbconfig.h"
+
+#ifndef DO_NOT_USE_EE
+
+#include <cstring>
+#include <stdlib.h>
+#include <unistd.h>
+#include "ac/getopt.h"
+
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <string>
+
+#include "mathp.h"
+#include "evaluator_bc.h"
+
+/* typical string drive expressions */
+static const char *exprs[] = {
+	"Time",
+	"-Time",
+	"2.*Time + 1.",
+	"Var^2 - 3.*Var + 0.5",
+	"Time^0.5",
+	"1./(1. + Time^2)",
+	"Time/Var",
+	"sin(2.*pi*Time)",
+	"exp(-Time)*cos(10.*Time)",
+	"sqrt(abs(Var))",
+	"atan2(Var, Time)",
+	"tanh(Time) - tan(Var)",
+	"log(1. + Time^2)",
+	"(Time > 1.)*(Time - 1.)",
+	"(Time >= Var) + (Time == 0.) + (Time != Var) + (Time <= 0.5) + (Var < 0.)",
+	"(Time > 0.5) && (Var > 0.) || !(Time > 1.)",
+	"(Time > 0.5) ~| (Var > 0.)",
+	"3.*(2. + 1.)*Time",
+	"Time*(Time*(Time*0.1 + 0.2) + 0.3) + 0.4",
+	0
+};
+
+static const Real times[] = { -2.5, -1., -0.25, 0., 1e-12, 0.1, 0.5, 1., 1.75, 3., 100. };
+static const Real vars[] = { -3., -1e-3, 0., 0.3, 1., 2.5, 1e6 };
+
+static bool verbose = false;
+
+static void
+usage(int rc)
+{
+	std::cerr << "usage: evaluatortest [-v] [\"expression\" ...]" << std::endl;
+	exit(rc);
+}
+
+/* returns the number of failures */
+static int
+check(MathParser& mp, Var *pTime, Var *pVar, const std::string& s)
+{
+	std::istringstream in(s);
+	InputStream In(in);
+	ExpressionElement *ee = 0;
+
+	try {
+		ee = mp.GetExpr(In);
+
+	} catch (MBDynErrBase& e) {
+		std::cerr << "\"" << s << "\": parse error (" << e.what() << ")" << std::endl;
+		return 1;
+	}
+
+	pTime->SetVal(Real(0.));
+	pVar->SetVal(Real(0.));
+
+	EE_Bytecode *bc = EE_Bytecode::Compile(ee);
+	if (bc == 0) {
+		std::cout << "\"" << s << "\": not compiled (tree only)" << std::endl;
+		delete ee;
+		return 0;
+	}
+
+	int iFail = 0;
+	unsigned iCount = 0;
+
+	for (unsigned t = 0; t < sizeof(times)/sizeof(times[0]); t++) {
+		for (unsigned v = 0; v < sizeof(vars)/sizeof(vars[0]); v++) {
+			pTime->SetVal(times[t]);
+			pVar->SetVal(vars[v]);
+
+			Real dTree = 0., dBC = 0.;
+			bool bTreeThrew = false, bBCThrew = false, bBCEval = true;
+
+			try {
+				dTree = ee->Eval().GetReal();
+			} catch (MBDynErrBase& e) {
+				bTreeThrew = true;
+			}
+
+			try {
+				bBCEval = bc->Eval(dBC);
+			} catch (MBDynErrBase& e) {
+				bBCThrew = true;
+			}
+
+			iCount++;
+
+			if (!bBCEval) {
+				std::cerr << "\"" << s << "\": bytecode refused to evaluate "
+					"at Time=" << times[t] << ", Var=" << vars[v] << std::endl;
+				iFail++;
+
+			} else if (bTreeThrew != bBCThrew) {
+				std::cerr << "\"" << s << "\": "
+					<< (bTreeThrew ? "tree" : "bytecode") << " only threw "
+					"at Time=" << times[t] << ", Var=" << vars[v] << std::endl;
+				iFail++;
+
+			} else if (!bTreeThrew && std::memcmp(&dTree, &dBC, sizeof(Real)) != 0) {
+				std::cerr.precision(17);
+				std::cerr << "\"" << s << "\": tree=" << dTree << " bytecode=" << dBC
+					<< " at Time=" << times[t] << ", Var=" << vars[v] << std::endl;
+				iFail++;
+			}
+		}
+	}
+
+	/* a variable that changed type must make the bytecode fall back */
+	pVar->SetVal(TypedValue(Int(1)));
+	Real d;
+	bool bGuard = true;
+	try {
+		bGuard = !bc->Eval(d);
+	} catch (MBDynErrBase& e) {
+		bGuard = false;
+	}
+	pVar->SetVal(TypedValue(Real(0.)));
+
+	if (!bGuard && s.find("Var") != std::string::npos) {
+		std::cerr << "\"" << s << "\": type change of \"Var\" not detected" << std::endl;
+		iFail++;
+	}
+
+	if (verbose || iFail) {
+		std::cout << "\"" << s << "\": " << bc->iGetNumInstr() << " instructions, "
+			<< iCount << " points, " << iFail << " failures" << std::endl;
+	}
+
+	delete bc;
+	delete ee;
+
+	return iFail;
+}
+
+int
+main(int argc, char *argv[])
+{
+	while (1) {
+		int opt = getopt(argc, argv, "hv");
+
+		if (opt == EOF) {
+			break;
+		}
+
+		switch (opt) {
+		case 'v':
+			verbose = true;
+			break;
+
+		case 'h':
+			usage(EXIT_SUCCESS);
+
+		default:
+			usage(EXIT_FAILURE);
+		}
+	}
+
+	Table T(true);
+	MathParser mp(T);
+
+	Var *pTime = T.Put("Time", Real(0.));
+	Var *pVar = T.Put("Var", Real(0.));
+
+	std::vector<std::string> v;
+	if (optind < argc) {
+		for (int i = optind; i < argc; i++) {
+			v.push_back(argv[i]);
+		}
+
+	} else {
+		for (unsigned i = 0; exprs[i] != 0; i++) {
+			v.push_back(exprs[i]);
+		}
+	}
+
+	int iFail = 0;
+	for (std::vector<std::string>::const_iterator i = v.begin(); i != v.end(); ++i) {
+		iFail += check(mp, pTime, pVar, *i);
+	}
+
+	std::cout << v.size() << " expressions, " << iFail << " failures" << std::endl;
+
+	return iFail ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+#else // DO_NOT_USE_EE
+
+#include <iostream>
+#include <stdlib.h>
+
+int
+main(void)
+{
+	std::cerr << "evaluatortest: expression evaluator not available" << std::endl;
+	return EXIT_SUCCESS;
+}
+
+#endif // DO_NOT_USE_EE
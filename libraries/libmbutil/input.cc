@@ -33,6 +33,14 @@
 
 #include "mbconfig.h"           /* This goes first in every *.c,*.cc file */
 
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif /* HAVE_SYS_MMAN_H */
+
 #include "input.h"
 
 /* InputStream - begin */
@@ -113,3 +121,198 @@ InputStream& operator >> (InputStream& in, long double& i)
 
 /* InputStream - end */
 
+
+/* InputFileBuf - begin */
+
+InputFileBuf::InputFileBuf(void)
+: pMap(0), uMapSize(0), bOpen(false)
+{
+	NO_OP;
+}
+
+InputFileBuf::~InputFileBuf(void)
+{
+	(void)close();
+}
+
+bool
+InputFileBuf::open(const char *sFileName)
+{
+	if (bOpen) {
+		return false;
+	}
+
+#ifdef HAVE_SYS_MMAN_H
+	int fd = ::open(sFileName, O_RDONLY);
+	if (fd == -1) {
+		return false;
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) == -1 || !S_ISREG(st.st_mode)) {
+		(void)::close(fd);
+		return false;
+	}
+
+	if (st.st_size > 0) {
+		/* private mapping: changes (none, actually) are not written back */
+		void *p = mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (p == MAP_FAILED) {
+			(void)::close(fd);
+			return false;
+		}
+
+#ifdef MADV_SEQUENTIAL
+		(void)madvise(p, st.st_size, MADV_SEQUENTIAL);
+#endif /* MADV_SEQUENTIAL */
+
+		pMap = (char *)p;
+		uMapSize = st.st_size;
+	}
+
+	(void)::close(fd);
+
+	/* the whole file is the get area */
+	setg(pMap, pMap, pMap + uMapSize);
+	bOpen = true;
+
+	return true;
+#else /* ! HAVE_SYS_MMAN_H */
+	return false;
+#endif /* ! HAVE_SYS_MMAN_H */
+}
+
+bool
+InputFileBuf::is_open(void) const
+{
+	return bOpen;
+}
+
+bool
+InputFileBuf::close(void)
+{
+	if (!bOpen) {
+		return false;
+	}
+
+#ifdef HAVE_SYS_MMAN_H
+	if (pMap != 0) {
+		(void)munmap(pMap, uMapSize);
+	}
+#endif /* HAVE_SYS_MMAN_H */
+
+	pMap = 0;
+	uMapSize = 0;
+	setg(0, 0, 0);
+	bOpen = false;
+
+	return true;
+}
+
+InputFileBuf::pos_type
+InputFileBuf::seekoff(off_type off, std::ios::seekdir dir,
+	std::ios::openmode which)
+{
+	off_type pos;
+
+	switch (dir) {
+	case std::ios::beg:
+		pos = off;
+		break;
+
+	case std::ios::cur:
+		pos = (gptr() - eback()) + off;
+		break;
+
+	case std::ios::end:
+		pos = uMapSize + off;
+		break;
+
+	default:
+		return pos_type(off_type(-1));
+	}
+
+	return seekpos(pos_type(pos), which);
+}
+
+InputFileBuf::pos_type
+InputFileBuf::seekpos(pos_type pos, std::ios::openmode which)
+{
+	if (!bOpen || !(which & std::ios::in)
+		|| off_type(pos) < 0 || off_type(pos) > off_type(uMapSize))
+	{
+		return pos_type(off_type(-1));
+	}
+
+	setg(pMap, pMap + off_type(pos), pMap + uMapSize);
+
+	return pos;
+}
+
+/* InputFileBuf - end */
+
+
+/* InputFileStream - begin */
+
+InputFileStream::InputFileStream(void)
+: std::istream(0)
+{
+	rdbuf(&fb);
+}
+
+InputFileStream::InputFileStream(const char *sFileName, std::ios::openmode mode)
+: std::istream(0)
+{
+	rdbuf(&fb);
+	open(sFileName, mode);
+}
+
+InputFileStream::~InputFileStream(void)
+{
+	NO_OP;
+}
+
+void
+InputFileStream::open(const char *sFileName, std::ios::openmode mode)
+{
+	if (is_open()) {
+		setstate(std::ios::failbit);
+		return;
+	}
+
+	if (mb.open(sFileName)) {
+		rdbuf(&mb);
+
+	} else if (fb.open(sFileName, mode | std::ios::in) != 0) {
+		/* e.g. a pipe, or no mmap(2) */
+		rdbuf(&fb);
+
+	} else {
+		setstate(std::ios::failbit);
+	}
+}
+
+bool
+InputFileStream::is_open(void) const
+{
+	return mb.is_open() || fb.is_open();
+}
+
+void
+InputFileStream::close(void)
+{
+	bool bClosed = false;
+
+	if (mb.is_open()) {
+		bClosed = mb.close();
+
+	} else if (fb.is_open()) {
+		bClosed = (fb.close() != 0);
+	}
+
+	if (!bClosed) {
+		setstate(std::ios::failbit);
+	}
+}
+
+/* InputFileStream - end */
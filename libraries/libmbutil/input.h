@@ -35,9 +35,14 @@
 #define INPUT_H
 
 #include <iostream>
+#include <fstream>
 #include <myassert.h>
 
-/* Filtro per la classe istream che conta il numero di righe. */
+/* Filtro per la classe istream che conta il numero di righe.
+ *
+ * I caratteri sono letti direttamente dallo streambuf, senza passare
+ * per le sentry di std::istream::get(); lo stato dell'istream
+ * viene comunque aggiornato come farebbero get() e putback(). */
 
 /* InputStream - begin */
 
@@ -98,29 +103,61 @@ extern InputStream& operator >> (InputStream& in, double& i);
 inline char
 InputStream::get(void)
 {
-	char ch = iStrm.get();
-	if (ch == '\n') {
-		uLineNumber++;
+	std::istream::int_type c = std::istream::traits_type::eof();
+
+	if (iStrm.good()) {
+		c = iStrm.rdbuf()->sbumpc();
+		if (c == std::istream::traits_type::eof()) {
+			iStrm.setstate(std::ios::eofbit | std::ios::failbit);
+
+		} else if (c == '\n') {
+			uLineNumber++;
+		}
+
+	} else {
+		iStrm.setstate(std::ios::failbit);
 	}
-	return ch;
+
+	return std::istream::traits_type::to_char_type(c);
 }
    
 /* Legge un carattere; se e' un fine-riga, aggiorna il contatore */
 inline std::istream&
 InputStream::get(char& ch) 
 {
-	std::istream& i = iStrm.get(ch);
-	if (ch == '\n') {
-		uLineNumber++;
+	if (iStrm.good()) {
+		std::istream::int_type c = iStrm.rdbuf()->sbumpc();
+		if (c == std::istream::traits_type::eof()) {
+			iStrm.setstate(std::ios::eofbit | std::ios::failbit);
+
+		} else {
+			ch = std::istream::traits_type::to_char_type(c);
+			if (ch == '\n') {
+				uLineNumber++;
+			}
+		}
+
+	} else {
+		iStrm.setstate(std::ios::failbit);
 	}
-	return i;
+
+	return iStrm;
 }
 
 /* Esegue il putback di un carattere */
 inline InputStream&
 InputStream::putback(char ch)
 {
-	iStrm.putback(ch);
+	iStrm.clear(iStrm.rdstate() & ~std::ios::eofbit);
+	if (iStrm.good()) {
+		if (iStrm.rdbuf()->sputbackc(ch) == std::istream::traits_type::eof()) {
+			iStrm.setstate(std::ios::badbit);
+		}
+
+	} else {
+		iStrm.setstate(std::ios::failbit);
+	}
+
 	if (ch == '\n') {
 		uLineNumber--;
 	}
@@ -156,5 +193,59 @@ InputStream::GetStream(void)
 
 /* InputStream - end */
 
+
+/* InputFileBuf - begin */
+
+/* streambuf che mappa in memoria l'intero file, in sola lettura;
+ * il putback e' quindi possibile fino all'inizio del file */
+
+class InputFileBuf : public std::streambuf {
+private:
+	char *pMap;
+	size_t uMapSize;
+	bool bOpen;
+
+protected:
+	virtual pos_type seekoff(off_type off, std::ios::seekdir dir,
+		std::ios::openmode which = std::ios::in);
+	virtual pos_type seekpos(pos_type pos,
+		std::ios::openmode which = std::ios::in);
+
+public:
+	InputFileBuf(void);
+	virtual ~InputFileBuf(void);
+
+	/* false se il file non puo' essere mappato (ad esempio una pipe) */
+	bool open(const char *sFileName);
+	bool is_open(void) const;
+	bool close(void);
+};
+
+/* InputFileBuf - end */
+
+
+/* InputFileStream - begin */
+
+/* Sostituisce std::ifstream per i file in ingresso al parser;
+ * se il file non puo' essere mappato in memoria usa un std::filebuf */
+
+class InputFileStream : public std::istream {
+private:
+	InputFileBuf mb;
+	std::filebuf fb;
+
+public:
+	InputFileStream(void);
+	explicit InputFileStream(const char *sFileName,
+		std::ios::openmode mode = std::ios::in);
+	virtual ~InputFileStream(void);
+
+	void open(const char *sFileName, std::ios::openmode mode = std::ios::in);
+	bool is_open(void) const;
+	void close(void);
+};
+
+/* InputFileStream - end */
+
 #endif /* INPUT_H */
 
@@ -1996,6 +1996,20 @@ MathParser::GetLineNumber(void) const
 	return in->GetLineNumber();
 }
 
+void
+MathParser::SetChangeList(ChangeList *pCL)
+{
+	pChangeList = pCL;
+}
+
+void
+MathParser::Changed(Table *pT, NamedValue *pNV)
+{
+	if (pChangeList != 0) {
+		pChangeList->push_back(ChangeList::value_type(pT, pNV));
+	}
+}
+
 void
 MathParser::TokenPush(Token t)
 {
@@ -4096,6 +4110,7 @@ MathParser::stmt(void)
 					 * const'ness from d */
 					newvar.Cast(d);
 					v = currTable->Put(varname.c_str(), newvar);
+					Changed(currTable, v);
 
 					if (isIfndef) {
 						silent_cerr("warning, ifndef variable " << v->GetTypeName() << " \"" << name
@@ -4123,6 +4138,7 @@ MathParser::stmt(void)
 
 					if (!isIfndef) {
 						dynamic_cast<Var *>(v)->SetVal(d);
+						Changed(currTable, v);
 
 					} else {
 						if (v->GetType() != type) {
@@ -4162,6 +4178,7 @@ MathParser::stmt(void)
 					 * di inserirla comunque, cosi'
 					 * table da' errore */
 					v = currTable->Put(namebuf, TypedValue(type));
+					Changed(currTable, v);
 				}
 
 				return v->GetVal();
@@ -4244,6 +4261,7 @@ MathParser::stmt(void)
 						std::string("cannot assign non-var named value \"") + name + "\"");
 				}
 				dynamic_cast<Var *>(v)->Cast(d);
+				Changed(currTable, v);
 				return v->GetVal();
 
 			} else {
@@ -4434,6 +4452,7 @@ last_arg:
 		SAFENEWWITHCONSTRUCTOR(v, PlugInVar,
 				PlugInVar(varname, pgin));
 		table.Put(v);
+		Changed(&table, v);
 
 		/*
 		 * pulizia ...
@@ -4472,6 +4491,7 @@ table(t),
 bRedefineVars(bRedefineVars),
 in(const_cast<InputStream*>(&strm)),
 defaultNameSpace(0),
+pChangeList(0),
 value(),
 currtoken(UNKNOWNTOKEN)
 {
@@ -4496,6 +4516,7 @@ table(t),
 bRedefineVars(bRedefineVars),
 in(0),
 defaultNameSpace(0),
+pChangeList(0),
 value(),
 currtoken(UNKNOWNTOKEN)
 {
@@ -5418,6 +5439,7 @@ MathParser::stmt(void)
 					newvar.Cast(d);
 
 					v = currTable->Put(varname.c_str(), newvar);
+					Changed(currTable, v);
 
 					if (bIsIfndef) {
 						silent_cerr("warning, ifndef variable " << v->GetTypeName() << " \"" << name
@@ -5445,6 +5467,7 @@ MathParser::stmt(void)
 
 					if (!bIsIfndef) {
 						dynamic_cast<Var *>(v)->SetVal(e->Eval());
+						Changed(currTable, v);
 
 					} else {
 						if (v->GetType() != type) {
@@ -5492,6 +5515,7 @@ MathParser::stmt(void)
 					 * di inserirla comunque, cosi'
 					 * table da' errore */
 					v = currTable->Put(namebuf, TypedValue(type));
+					Changed(currTable, v);
 				}
 
 				return new EE_Var(v, currNameSpace);
@@ -5572,6 +5596,7 @@ MathParser::stmt(void)
 
 					// FIXME: we need to define a EE_Assign that does the operation below
 					dynamic_cast<Var *>(v)->Cast(e->Eval());
+					Changed(currTable, v);
 					delete e;
 					return new EE_Var(v, currNameSpace);
 
@@ -5794,6 +5819,7 @@ last_arg:
 	SAFENEWWITHCONSTRUCTOR(v, PlugInVar,
 			PlugInVar(varname, pgin));
 	table.Put(v);
+	Changed(&table, v);
 
 	/*
 	 * pulizia ...
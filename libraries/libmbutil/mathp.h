@@ -295,6 +295,11 @@ public:
 	InputStream* in;     /* stream in ingresso */
 	int GetLineNumber(void) const;
 
+	/* symbols defined or assigned by the statements, on request
+	 * (used by the compiled model cache) */
+	typedef std::vector<std::pair<Table *, NamedValue *> > ChangeList;
+	void SetChangeList(ChangeList *pCL);
+
 public:
 
 	/* i token che il lex riconosce */
@@ -357,6 +362,10 @@ protected:
 	/* buffer statico reallocabile per leggere nomi */
 	std::string namebuf;
 
+	/* symbols changed by the statements, if requested */
+	ChangeList *pChangeList;
+	void Changed(Table *pT, NamedValue *pNV);
+
 	/* valore numerico dotato di tipo */
 	TypedValue value;
 
@@ -0,0 +1,658 @@
+/* $Header$ */
+/*
+ * MBDyn (C) is a multibody analysis code.
+ * http://www.mbdyn.org
+ *
+ * Copyright (C) 1996-2023
+ *
+ * Pierangelo Masarati	<pierangelo.masarati@polimi.it>
+ * Paolo Mantegazza	<paolo.mantegazza@polimi.it>
+ *
+ * Dipartimento di Ingegneria Aerospaziale - Politecnico di Milano
+ * via La Masa, 34 - 20156 Milano, Italy
+ * http://www.aero.polimi.it
+ *
+ * Changing this copyright notice is forbidden.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation (version 2 of the License).
+ *
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* compiled model cache */
+
+#include "mbconfig.h"           /* This goes first in every *.c,*.cc file */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <climits>
+#include <cstring>
+#include <algorithm>
+#include <fstream>
+
+#include "myassert.h"
+#include "parscache.h"
+
+#ifndef PATH_MAX
+#define PATH_MAX 4096
+#endif // !PATH_MAX
+
+/* bump whenever the layout or the meaning of the events changes */
+static const char sMagic[] = "MBDynMC";
+static const uint32_t uFormatVersion = 1;
+
+/* 64 bit FNV-1a */
+static const uint64_t FNV_INIT = 0xcbf29ce484222325ULL;
+static const uint64_t FNV_PRIME = 0x100000001b3ULL;
+
+static uint64_t
+fnv1a(uint64_t h, const void *p, size_t n)
+{
+	const unsigned char *c = static_cast<const unsigned char *>(p);
+
+	for (size_t i = 0; i < n; i++) {
+		h ^= c[i];
+		h *= FNV_PRIME;
+	}
+
+	return h;
+}
+
+static uint64_t
+fnv1a(uint64_t h, const std::string& s)
+{
+	/* the terminator separates consecutive strings */
+	return fnv1a(h, s.c_str(), s.size() + 1);
+}
+
+static bool
+hash_file(const std::string& sPath, uint64_t& uSize, uint64_t& uHash)
+{
+	std::ifstream in(sPath.c_str(), std::ios::in | std::ios::binary);
+	if (!in) {
+		return false;
+	}
+
+	char buf[65536];
+
+	uSize = 0;
+	uHash = FNV_INIT;
+	while (in) {
+		in.read(buf, sizeof(buf));
+		std::streamsize n = in.gcount();
+		uHash = fnv1a(uHash, buf, n);
+		uSize += n;
+	}
+
+	return in.eof();
+}
+
+static bool
+abs_path(const std::string& sFileName, std::string& sPath)
+{
+#ifdef _WIN32
+	char buf[PATH_MAX];
+	if (_fullpath(buf, sFileName.c_str(), sizeof(buf)) == 0) {
+		return false;
+	}
+	sPath = buf;
+#else // ! _WIN32
+	char *p = realpath(sFileName.c_str(), 0);
+	if (p == 0) {
+		return false;
+	}
+	sPath = p;
+	free(p);
+#endif // ! _WIN32
+
+	return true;
+}
+
+/* variables and constants are sorted by name, so that the hash
+ * does not depend on the order of the hashed symbol table */
+static uint64_t
+hash_table(const Table& T)
+{
+	std::vector<const NamedValue *> v;
+	for (Table::VM::const_iterator i = T.begin(); i != T.end(); ++i) {
+		v.push_back(i->second);
+	}
+
+	std::sort(v.begin(), v.end(), [](const NamedValue *p1, const NamedValue *p2) {
+		return strcmp(p1->GetName(), p2->GetName()) < 0;
+	});
+
+	uint64_t h = FNV_INIT;
+	for (std::vector<const NamedValue *>::const_iterator i = v.begin(); i != v.end(); ++i) {
+		const NamedValue *p = *i;
+		int32_t iType = p->GetType();
+		uint8_t cConst = p->Const();
+
+		h = fnv1a(h, std::string(p->GetName()));
+		h = fnv1a(h, &iType, sizeof(iType));
+		h = fnv1a(h, &cConst, sizeof(cConst));
+
+		if (!p->IsVar()) {
+			continue;
+		}
+
+		TypedValue val(p->GetVal());
+		switch (val.GetType()) {
+		case TypedValue::VAR_BOOL:
+		case TypedValue::VAR_INT: {
+			int32_t i = val.GetInt();
+			h = fnv1a(h, &i, sizeof(i));
+			} break;
+
+		case TypedValue::VAR_REAL: {
+			Real r = val.GetReal();
+			h = fnv1a(h, &r, sizeof(r));
+			} break;
+
+		case TypedValue::VAR_STRING:
+			h = fnv1a(h, val.GetString());
+			break;
+
+		default:
+			break;
+		}
+	}
+
+	return h;
+}
+
+/* binary I/O; the cache is meant to be read on the machine that wrote it */
+
+template <class T>
+static void
+put(std::ostream& out, const T& t)
+{
+	out.write(reinterpret_cast<const char *>(&t), sizeof(t));
+}
+
+static void
+put(std::ostream& out, const std::string& s)
+{
+	put(out, uint32_t(s.size()));
+	out.write(s.data(), s.size());
+}
+
+static void
+put(std::ostream& out, const TypedValue& v)
+{
+	put(out, int32_t(v.GetType()));
+
+	switch (v.GetType()) {
+	case TypedValue::VAR_BOOL:
+	case TypedValue::VAR_INT:
+		put(out, int32_t(v.GetInt()));
+		break;
+
+	case TypedValue::VAR_REAL:
+		put(out, v.GetReal());
+		break;
+
+	case TypedValue::VAR_STRING:
+		put(out, v.GetString());
+		break;
+
+	default:
+		break;
+	}
+}
+
+template <class T>
+static bool
+get(std::istream& in, T& t)
+{
+	return bool(in.read(reinterpret_cast<char *>(&t), sizeof(t)));
+}
+
+static bool
+get(std::istream& in, std::string& s)
+{
+	uint32_t l;
+	if (!get(in, l) || l > (1U << 30)) {
+		return false;
+	}
+
+	s.resize(l);
+	return l == 0 || bool(in.read(&s[0], l));
+}
+
+static bool
+get(std::istream& in, TypedValue& v)
+{
+	int32_t iType;
+	if (!get(in, iType)) {
+		return false;
+	}
+
+	switch (iType) {
+	case TypedValue::VAR_BOOL: {
+		int32_t i;
+		if (!get(in, i)) {
+			return false;
+		}
+		v = TypedValue(i != 0);
+		} break;
+
+	case TypedValue::VAR_INT: {
+		int32_t i;
+		if (!get(in, i)) {
+			return false;
+		}
+		v = TypedValue(Int(i));
+		} break;
+
+	case TypedValue::VAR_REAL: {
+		Real r;
+		if (!get(in, r)) {
+			return false;
+		}
+		v = TypedValue(r);
+		} break;
+
+	case TypedValue::VAR_STRING: {
+		std::string s;
+		if (!get(in, s)) {
+			return false;
+		}
+		v = TypedValue(s);
+		} break;
+
+	case TypedValue::VAR_UNKNOWN:
+		break;
+
+	default:
+		return false;
+	}
+
+	return true;
+}
+
+/* ParserCache - begin */
+
+ParserCache::ParserCache(const std::string& sCacheFile,
+	const std::string& sInputFile, const Table& T)
+: sCacheFile(sCacheFile),
+uTableHash(hash_table(T)),
+bReplay(false),
+bFailed(false),
+uCurrSource(0),
+uCurrEvent(0),
+uCurrLine(0)
+{
+	std::string sPath;
+	if (!abs_path(sInputFile, sPath)) {
+		Fail("unable to resolve the input file name");
+		return;
+	}
+
+	if (Load()) {
+		if (!sources.empty() && sources[0].sPath == sPath) {
+			silent_cout("reading the model from cache \"" << sCacheFile << "\"" << std::endl);
+			bReplay = true;
+			uCurrSource = 1;
+			return;
+		}
+	}
+
+	sources.clear();
+	events.clear();
+
+	AddSource(sPath);
+	if (!bFailed) {
+		silent_cout("recording the model into cache \"" << sCacheFile << "\"" << std::endl);
+	}
+}
+
+ParserCache::~ParserCache(void)
+{
+	NO_OP;
+}
+
+bool
+ParserCache::Load(void)
+{
+	std::ifstream in(sCacheFile.c_str(), std::ios::in | std::ios::binary);
+	if (!in) {
+		return false;
+	}
+
+	char buf[sizeof(sMagic)];
+	uint32_t uVersion, uSizeofReal;
+	std::string sMBDynVersion;
+	uint64_t uHash;
+
+	if (!in.read(buf, sizeof(buf)) || memcmp(buf, sMagic, sizeof(sMagic)) != 0
+		|| !get(in, uVersion) || uVersion != uFormatVersion
+		|| !get(in, sMBDynVersion) || sMBDynVersion != VERSION
+		|| !get(in, uSizeofReal) || uSizeofReal != sizeof(Real))
+	{
+		silent_cout("model cache \"" << sCacheFile << "\" has a different format; ignored" << std::endl);
+		return false;
+	}
+
+	if (!get(in, uHash) || uHash != uTableHash) {
+		silent_cout("model cache \"" << sCacheFile << "\" was recorded with a different symbol table; ignored" << std::endl);
+		return false;
+	}
+
+	uint32_t uNumSources;
+	if (!get(in, uNumSources)) {
+		return false;
+	}
+
+	for (uint32_t i = 0; i < uNumSources; i++) {
+		Source src;
+		if (!get(in, src.sPath) || !get(in, src.uSize) || !get(in, src.uHash)) {
+			return false;
+		}
+
+		uint64_t uSize, uHash;
+		if (!hash_file(src.sPath, uSize, uHash) || uSize != src.uSize || uHash != src.uHash) {
+			silent_cout("model cache \"" << sCacheFile << "\": file \"" << src.sPath << "\" changed; ignored" << std::endl);
+			return false;
+		}
+
+		sources.push_back(src);
+	}
+
+	uint32_t uNumEvents;
+	if (!get(in, uNumEvents)) {
+		return false;
+	}
+
+	events.resize(uNumEvents);
+	for (std::vector<Event>::iterator e = events.begin(); e != events.end(); ++e) {
+		uint8_t cType;
+		uint32_t uLine;
+		if (!get(in, cType) || cType >= LASTEVENT || !get(in, uLine)) {
+			return false;
+		}
+
+		e->type = EventType(cType);
+		e->uLine = uLine;
+
+		int32_t iStatus = 0;
+		uint8_t cEof = 0;
+		bool bOK = true;
+
+		switch (e->type) {
+		case TOKEN:
+			bOK = get(in, iStatus) && get(in, cEof) && get(in, e->dNumber) && get(in, e->s);
+			break;
+
+		case WORD:
+		case STRING:
+		case DELIMSTRING:
+			bOK = get(in, iStatus) && get(in, e->s);
+			break;
+
+		case DELIM:
+			bOK = get(in, iStatus);
+			break;
+
+		case VALUE: {
+			uint32_t uNumChanges;
+			bOK = get(in, e->v) && get(in, uNumChanges);
+			if (bOK) {
+				e->changes.resize(uNumChanges);
+				for (std::vector<Change>::iterator c = e->changes.begin(); bOK && c != e->changes.end(); ++c) {
+					bOK = get(in, c->sNameSpace) && get(in, c->sName) && get(in, c->v) && get(in, cEof);
+					c->bConst = cEof;
+				}
+				cEof = 0;
+			}
+			} break;
+
+		default:
+			break;
+		}
+
+		if (!bOK) {
+			silent_cout("model cache \"" << sCacheFile << "\" is truncated; ignored" << std::endl);
+			return false;
+		}
+
+		e->iStatus = iStatus;
+		e->bEof = cEof;
+	}
+
+	return true;
+}
+
+void
+ParserCache::Save(void) const
+{
+	std::string sTmpFile(sCacheFile + ".tmp");
+
+	{
+		std::ofstream out(sTmpFile.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+
+		out.write(sMagic, sizeof(sMagic));
+		put(out, uFormatVersion);
+		put(out, std::string(VERSION));
+		put(out, uint32_t(sizeof(Real)));
+		put(out, uint64_t(uTableHash));
+
+		put(out, uint32_t(sources.size()));
+		for (std::vector<Source>::const_iterator i = sources.begin(); i != sources.end(); ++i) {
+			put(out, i->sPath);
+			put(out, uint64_t(i->uSize));
+			put(out, uint64_t(i->uHash));
+		}
+
+		put(out, uint32_t(events.size()));
+		for (std::vector<Event>::const_iterator e = events.begin(); e != events.end(); ++e) {
+			put(out, uint8_t(e->type));
+			put(out, uint32_t(e->uLine));
+
+			switch (e->type) {
+			case TOKEN:
+				put(out, int32_t(e->iStatus));
+				put(out, uint8_t(e->bEof));
+				put(out, e->dNumber);
+				put(out, e->s);
+				break;
+
+			case WORD:
+			case STRING:
+			case DELIMSTRING:
+				put(out, int32_t(e->iStatus));
+				put(out, e->s);
+				break;
+
+			case DELIM:
+				put(out, int32_t(e->iStatus));
+				break;
+
+			case VALUE:
+				put(out, e->v);
+				put(out, uint32_t(e->changes.size()));
+				for (std::vector<Change>::const_iterator c = e->changes.begin(); c != e->changes.end(); ++c) {
+					put(out, c->sNameSpace);
+					put(out, c->sName);
+					put(out, c->v);
+					put(out, uint8_t(c->bConst));
+				}
+				break;
+
+			default:
+				break;
+			}
+		}
+
+		out.close();
+		if (!out) {
+			silent_cerr("warning, unable to write model cache \"" << sTmpFile << "\"" << std::endl);
+			std::remove(sTmpFile.c_str());
+			return;
+		}
+	}
+
+	if (std::rename(sTmpFile.c_str(), sCacheFile.c_str()) != 0) {
+		silent_cerr("warning, unable to rename \"" << sTmpFile << "\" "
+			"to \"" << sCacheFile << "\"" << std::endl);
+		std::remove(sTmpFile.c_str());
+	}
+}
+
+void
+ParserCache::AddSource(const std::string& sPath)
+{
+	Source src;
+	uint64_t uSize, uHash;
+
+	if (!hash_file(sPath, uSize, uHash)) {
+		Fail("unable to read an input file");
+		return;
+	}
+
+	src.sPath = sPath;
+	src.uSize = uSize;
+	src.uHash = uHash;
+	sources.push_back(src);
+}
+
+bool
+ParserCache::bIsReplaying(void) const
+{
+	return bReplay;
+}
+
+bool
+ParserCache::bIsRecording(void) const
+{
+	return !bReplay && !bFailed;
+}
+
+void
+ParserCache::Fail(const char *sReason)
+{
+	ASSERT(!bReplay);
+
+	if (!bFailed) {
+		silent_cerr("warning, model cache \"" << sCacheFile << "\" "
+			"not recorded: " << sReason << std::endl);
+		bFailed = true;
+		sources.clear();
+		events.clear();
+	}
+}
+
+void
+ParserCache::Include(const char *sFileName)
+{
+	if (!bReplay && bFailed) {
+		return;
+	}
+
+	std::string sPath;
+	if (!abs_path(sFileName, sPath)) {
+		if (bReplay) {
+			OutOfSync(std::string("unable to resolve included file \"") + sFileName + "\"");
+		}
+
+		Fail("unable to resolve an included file name");
+		return;
+	}
+
+	if (bReplay) {
+		/* the file name may depend on the environment */
+		if (uCurrSource >= sources.size() || sources[uCurrSource].sPath != sPath) {
+			OutOfSync(std::string("included file \"") + sPath + "\" was not recorded");
+		}
+
+		uCurrSource++;
+		return;
+	}
+
+	AddSource(sPath);
+}
+
+void
+ParserCache::Close(void)
+{
+	if (bReplay) {
+		if (uCurrEvent != events.size() || uCurrSource != sources.size()) {
+			std::remove(sCacheFile.c_str());
+			silent_cerr("warning, model cache \"" << sCacheFile << "\" "
+				"was not used up; cache removed" << std::endl);
+		}
+
+		return;
+	}
+
+	if (!bFailed) {
+		Save();
+	}
+}
+
+void
+ParserCache::Put(const Event& e)
+{
+	ASSERT(!bReplay);
+
+	if (!bFailed) {
+		events.push_back(e);
+	}
+}
+
+const ParserCache::Event&
+ParserCache::Get(EventType type)
+{
+	ASSERT(bReplay);
+
+	if (uCurrEvent < events.size()) {
+		const Event& e = events[uCurrEvent];
+		if (e.type == type || e.type == ENDOFFILE) {
+			uCurrEvent++;
+			uCurrLine = e.uLine;
+
+			if (e.type == ENDOFFILE) {
+				throw EndOfFile(MBDYN_EXCEPT_ARGS);
+			}
+
+			return e;
+		}
+	}
+
+	OutOfSync("unexpected input operation");
+}
+
+void
+ParserCache::OutOfSync(const std::string& sWhat)
+{
+	std::remove(sCacheFile.c_str());
+	silent_cerr("model cache \"" << sCacheFile << "\" does not match the input "
+		"after line " << uCurrLine << " (" << sWhat << "); "
+		"cache removed, please run again" << std::endl);
+	throw ErrOutOfSync(MBDYN_EXCEPT_ARGS);
+}
+
+unsigned
+ParserCache::GetLineNumber(void) const
+{
+	return uCurrLine;
+}
+
+const std::string&
+ParserCache::sGetFileName(void) const
+{
+	return sCacheFile;
+}
+
+/* ParserCache - end */
@@ -0,0 +1,160 @@
+/* $Header$ */
+/*
+ * MBDyn (C) is a multibody analysis code.
+ * http://www.mbdyn.org
+ *
+ * Copyright (C) 1996-2023
+ *
+ * Pierangelo Masarati	<pierangelo.masarati@polimi.it>
+ * Paolo Mantegazza	<paolo.mantegazza@polimi.it>
+ *
+ * Dipartimento di Ingegneria Aerospaziale - Politecnico di Milano
+ * via La Masa, 34 - 20156 Milano, Italy
+ * http://www.aero.polimi.it
+ *
+ * Changing this copyright notice is forbidden.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation (version 2 of the License).
+ *
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* Compiled model cache for the parser.
+ *
+ * The first run records the results of the elementary input operations
+ * of the HighParser (tokens, words, strings, values of expressions
+ * and the symbols they changed) in the order they are performed;
+ * the following runs replay them without scanning the input
+ * and without evaluating the expressions.
+ *
+ * The cache is keyed by a hash of the input file, of all the included
+ * files and of the initial symbol table; if any of them changed,
+ * the cache is recorded again.  Files that are read by the elements
+ * themselves (C81 data, FEM data, file drives, ...) are read as usual
+ * and are not part of the key.
+ */
+
+#ifndef PARSCACHE_H
+#define PARSCACHE_H
+
+#include <string>
+#include <vector>
+
+#include "except.h"
+#include "mathtyp.h"
+#include "table.h"
+
+/* ParserCache - begin */
+
+class ParserCache {
+public:
+	class ErrOutOfSync : public MBDynErrBase {
+	public:
+		ErrOutOfSync(MBDYN_EXCEPT_ARGS_DECL) : MBDynErrBase(MBDYN_EXCEPT_ARGS_PASSTHRU) { NO_OP; };
+	};
+
+	enum EventType {
+		TOKEN,		/* LowParser::GetToken() */
+		WORD,		/* HighParser::ParseWord() */
+		VALUE,		/* MathParser::Get() */
+		STRING,		/* HighParser::GetString() */
+		DELIM,		/* HighParser::IsStringWithDelims() */
+		DELIMSTRING,	/* HighParser::GetStringWithDelims() */
+		ENDOFFILE,	/* EndOfFile thrown by any of the above */
+
+		LASTEVENT
+	};
+
+	/* symbol defined or changed by an expression;
+	 * an empty namespace means the main symbol table */
+	struct Change {
+		std::string sNameSpace;
+		std::string sName;
+		TypedValue v;
+		/* TypedValue does not preserve const'ness when copied */
+		bool bConst;
+	};
+
+	struct Event {
+		EventType type;
+		unsigned uLine;
+		int iStatus;
+		bool bEof;
+		Real dNumber;
+		std::string s;
+		TypedValue v;
+		std::vector<Change> changes;
+
+		Event(EventType t = LASTEVENT, unsigned l = 0)
+		: type(t), uLine(l), iStatus(0), bEof(false), dNumber(0.) {};
+	};
+
+private:
+	struct Source {
+		std::string sPath;
+		unsigned long long uSize;
+		unsigned long long uHash;
+	};
+
+	std::string sCacheFile;
+	unsigned long long uTableHash;
+	std::vector<Source> sources;
+	std::vector<Event> events;
+
+	bool bReplay;
+	bool bFailed;
+	unsigned uCurrSource;
+	unsigned uCurrEvent;
+	unsigned uCurrLine;
+
+	bool Load(void);
+	void Save(void) const;
+	void AddSource(const std::string& sPath);
+
+public:
+	/* sInputFile must be valid from the current working directory */
+	ParserCache(const std::string& sCacheFile,
+		const std::string& sInputFile, const Table& T);
+	~ParserCache(void);
+
+	/* true if the model is read from the cache */
+	bool bIsReplaying(void) const;
+	/* true if recording (and not given up) */
+	bool bIsRecording(void) const;
+
+	/* stops recording; nothing will be saved */
+	void Fail(const char *sReason);
+
+	/* an included file, as seen from the current working directory */
+	void Include(const char *sFileName);
+
+	/* record: saves the cache; replay: checks it was used up */
+	void Close(void);
+
+	/* record */
+	void Put(const Event& e);
+	/* replay; throws EndOfFile if it was recorded in place of e */
+	const Event& Get(EventType type);
+
+	/* replay: the input does not match the cache; removes it and throws */
+	[[noreturn]] void OutOfSync(const std::string& sWhat);
+
+	/* line of the last replayed event */
+	unsigned GetLineNumber(void) const;
+
+	const std::string& sGetFileName(void) const;
+};
+
+/* ParserCache - end */
+
+#endif /* PARSCACHE_H */
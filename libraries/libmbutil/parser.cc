@@ -37,9 +37,11 @@
 #include <stdlib.h>
 #include <stack>
 #include <map>
+#include <set>
 
 #include "mathtyp.h"
 #include "parser.h"
+#include "parscache.h"
 #include "filename.h"
 #include "Rot.hh"
 
@@ -189,6 +191,25 @@ end_of_word:;
         In.putback(cIn);
 }
 
+void
+LowParser::SetWord(const std::string& s)
+{
+        if (s.size() >= iBufSize) {
+                unsigned i = iBufSize;
+                while (s.size() >= i) {
+                        i *= 2;
+                }
+
+                char *sBuf = NULL;
+                SAFENEWARR(sBuf, char, i);
+                SAFEDELETEARR(sCurrWordBuf);
+                sCurrWordBuf = sBuf;
+                iBufSize = i;
+        }
+
+        memcpy(sCurrWordBuf, s.c_str(), s.size() + 1);
+}
+
 
 LowParser::Token
 LowParser::GetToken(InputStream& In)
@@ -640,7 +661,8 @@ LowP(*this),
 pIn(&streamIn),
 pf(NULL),
 MathP(MP),
-KeyT(0)
+KeyT(0),
+pCache(0)
 {
         DEBUGCOUTFNAME("HighParser::HighParser");
         CurrToken = HighParser::DESCRIPTION;
@@ -654,6 +676,8 @@ KeyT(0)
 HighParser::~HighParser(void)
 {
         DEBUGCOUTFNAME("HighParser::~HighParser");
+        /* the model cache is saved only by an explicit Close() */
+        pCache = 0;
         Close();
         ASSERT(pHP.top() == this);
         pHP.pop();
@@ -665,7 +689,17 @@ HighParser::~HighParser(void)
 void
 HighParser::Close(void)
 {
-        NO_OP;
+        if (pCache != 0) {
+                ParserCache *p = pCache;
+                pCache = 0;
+                p->Close();
+        }
+}
+
+void
+HighParser::SetCache(ParserCache* p)
+{
+        pCache = p;
 }
 
 
@@ -688,6 +722,10 @@ HighParser::GetMathParser(void)
 int
 HighParser::GetLineNumber(void) const
 {
+        if (pCache != 0 && pCache->bIsReplaying()) {
+                return pCache->GetLineNumber();
+        }
+
         return const_cast<InputStream *>(pIn)->GetLineNumber();
 }
 
@@ -754,9 +792,10 @@ HighParser::GetDescription(void)
 
 restart_parsing:;
 
-        CurrLowToken = LowP.GetToken(*pIn);
+        bool bEof;
+        CurrLowToken = GetLowToken(&bEof);
         if (CurrLowToken != LowParser::WORD) {
-                if (pIn->eof()) {
+                if (bEof) {
                         Eof();
                         goto restart_parsing;
                 }
@@ -781,7 +820,7 @@ restart_parsing:;
 HighParser::Token
 HighParser::FirstToken(void)
 {
-        CurrLowToken = LowP.GetToken(*pIn);
+        CurrLowToken = GetLowToken();
 
         switch (CurrLowToken) {
         case LowParser::COLON:
@@ -827,6 +866,11 @@ HighParser::IsArg(void)
 void
 HighParser::PutBackSemicolon(void)
 {
+        if (pCache != 0 && pCache->bIsReplaying()) {
+                /* the next token is replayed as well */
+                return;
+        }
+
         if (CurrLowToken == LowParser::SEMICOLON) {
                 pIn->putback(';');
         }
@@ -836,7 +880,7 @@ HighParser::PutBackSemicolon(void)
 void
 HighParser::NextToken(const char* sFuncName)
 {
-        CurrLowToken = LowP.GetToken(*pIn);
+        CurrLowToken = GetLowToken();
         switch (CurrLowToken) {
         case LowParser::COMMA:
                 CurrToken = HighParser::ARG;
@@ -854,8 +898,321 @@ HighParser::NextToken(const char* sFuncName)
         }
 }
 
+/*
+ * Elementary input operations.
+ *
+ * Without a model cache they just read the input; when recording,
+ * their results are stored in the cache, together with the line
+ * number and with the symbols changed by the expressions;
+ * when replaying, the input is not read at all.
+ */
+
+void
+HighParser::RecordException(void)
+{
+        try {
+                throw;
+        }
+        catch (EndOfFile& e) {
+                /* the callers may rely on it */
+                pCache->Put(ParserCache::Event(ParserCache::ENDOFFILE, GetLineNumber()));
+        }
+        catch (...) {
+                pCache->Fail("error while parsing");
+        }
+}
+
+LowParser::Token
+HighParser::GetLowToken(bool *pbEof)
+{
+        if (pCache != 0 && pCache->bIsReplaying()) {
+                const ParserCache::Event& e = pCache->Get(ParserCache::TOKEN);
+                LowP.CurrToken = LowParser::Token(e.iStatus);
+                if (LowP.CurrToken == LowParser::WORD) {
+                        LowP.SetWord(e.s);
+
+                } else if (LowP.CurrToken == LowParser::NUMBER) {
+                        LowP.dCurrNumber = e.dNumber;
+                }
+
+                if (pbEof != 0) {
+                        *pbEof = e.bEof;
+                }
+
+                return LowP.CurrToken;
+        }
+
+        LowParser::Token t;
+        try {
+                t = LowP.GetToken(*pIn);
+        }
+        catch (...) {
+                if (pCache != 0) {
+                        RecordException();
+                }
+                throw;
+        }
+
+        if (pbEof != 0) {
+                *pbEof = pIn->eof();
+        }
+
+        if (pCache != 0) {
+                ParserCache::Event e(ParserCache::TOKEN, GetLineNumber());
+                e.iStatus = t;
+                e.bEof = pIn->eof();
+                if (t == LowParser::WORD) {
+                        e.s = LowP.sGetWord();
+
+                } else if (t == LowParser::NUMBER) {
+                        e.dNumber = LowP.dGetReal();
+                }
+                pCache->Put(e);
+        }
+
+        return t;
+}
+
+int
+HighParser::ReadString(unsigned flags)
+{
+        if (pCache == 0) {
+                return ReadString_int(flags);
+        }
+
+        if (pCache->bIsReplaying()) {
+                const ParserCache::Event& e = pCache->Get(ParserCache::STRING);
+                if (e.iStatus != 0) {
+                        CurrToken = HighParser::ENDOFFILE;
+                }
+                strcpy(sStringBuf, e.s.c_str());
+
+                return e.iStatus;
+        }
+
+        int rc;
+        try {
+                rc = ReadString_int(flags);
+        }
+        catch (...) {
+                RecordException();
+                throw;
+        }
+
+        ParserCache::Event e(ParserCache::STRING, GetLineNumber());
+        e.iStatus = rc;
+        if (rc != 1) {
+                e.s = sStringBuf;
+        }
+        pCache->Put(e);
+
+        return rc;
+}
+
+bool
+HighParser::IsDelim(char cDelim)
+{
+        if (pCache != 0 && pCache->bIsReplaying()) {
+                return pCache->Get(ParserCache::DELIM).iStatus != 0;
+        }
+
+        bool b = false;
+        char cIn;
+        try {
+                if (skip_remarks(*this, *pIn, cIn) == 0) {
+                        /* put back the first non-remark char */
+                        pIn->putback(cIn);
+
+                        /* if the delimiter is found, true */
+                        b = (cIn == cDelim);
+                }
+        }
+        catch (...) {
+                if (pCache != 0) {
+                        RecordException();
+                }
+                throw;
+        }
+
+        if (pCache != 0) {
+                ParserCache::Event e(ParserCache::DELIM, GetLineNumber());
+                e.iStatus = b;
+                pCache->Put(e);
+        }
+
+        return b;
+}
+
+int
+HighParser::ReadStringWithDelims(enum Delims Del, bool escape)
+{
+        if (pCache == 0) {
+                return ReadStringWithDelims_int(Del, escape);
+        }
+
+        if (pCache->bIsReplaying()) {
+                const ParserCache::Event& e = pCache->Get(ParserCache::DELIMSTRING);
+                if (e.iStatus == 0) {
+                        strcpy(sStringBuf, e.s.c_str());
+                }
+
+                return e.iStatus;
+        }
+
+        int rc;
+        try {
+                rc = ReadStringWithDelims_int(Del, escape);
+        }
+        catch (...) {
+                RecordException();
+                throw;
+        }
+
+        ParserCache::Event e(ParserCache::DELIMSTRING, GetLineNumber());
+        e.iStatus = rc;
+        if (rc == 0) {
+                e.s = sStringBuf;
+        }
+        pCache->Put(e);
+
+        return rc;
+}
+
+TypedValue
+HighParser::ReadValue(const TypedValue& vDefVal)
+{
+        if (pCache == 0) {
+                return MathP.Get(*pIn, vDefVal);
+        }
+
+        if (pCache->bIsReplaying()) {
+                const ParserCache::Event& e = pCache->Get(ParserCache::VALUE);
+
+                for (std::vector<ParserCache::Change>::const_iterator c = e.changes.begin(); c != e.changes.end(); ++c) {
+                        Table *pT = &MathP.GetSymbolTable();
+                        if (!c->sNameSpace.empty()) {
+                                MathParser::NameSpace *pNS = MathP.GetNameSpace(c->sNameSpace);
+                                pT = (pNS != 0) ? pNS->GetTable() : 0;
+                                if (pT == 0) {
+                                        pCache->OutOfSync("namespace \"" + c->sNameSpace + "\" not found");
+                                }
+                        }
+
+                        NamedValue *pNV = pT->Get(c->sName);
+                        if (pNV == 0) {
+                                TypedValue v(c->v);
+                                v.SetConst(c->bConst, true);
+                                pT->Put(c->sName, v);
+
+                        } else if (pNV->IsVar()) {
+                                dynamic_cast<Var *>(pNV)->SetVal(c->v);
+
+                        } else {
+                                pCache->OutOfSync("symbol \"" + c->sName + "\" is not a variable");
+                        }
+                }
+
+                return e.v;
+        }
+
+        MathParser::ChangeList changes;
+        MathP.SetChangeList(&changes);
+
+        TypedValue v;
+        try {
+                v = MathP.Get(*pIn, vDefVal);
+        }
+        catch (...) {
+                MathP.SetChangeList(0);
+                RecordException();
+                throw;
+        }
+
+        MathP.SetChangeList(0);
+
+        ParserCache::Event e(ParserCache::VALUE, GetLineNumber());
+        e.v = v;
+
+        std::set<const NamedValue *> done;
+        for (MathParser::ChangeList::const_iterator i = changes.begin(); i != changes.end(); ++i) {
+                if (!done.insert(i->second).second) {
+                        continue;
+                }
+
+                if (!i->second->IsVar()) {
+                        pCache->Fail("plugin variables cannot be cached");
+                        break;
+                }
+
+                ParserCache::Change c;
+                if (i->first != &MathP.GetSymbolTable()) {
+                        const MathParser::NameSpaceMap& ns = MathP.GetNameSpaceMap();
+                        MathParser::NameSpaceMap::const_iterator n;
+                        for (n = ns.begin(); n != ns.end(); ++n) {
+                                if (n->second->GetTable() == i->first) {
+                                        break;
+                                }
+                        }
+
+                        if (n == ns.end()) {
+                                pCache->Fail("unknown symbol table");
+                                break;
+                        }
+
+                        c.sNameSpace = n->first;
+                }
+
+                c.sName = i->second->GetName();
+                c.v = i->second->GetVal();
+                c.bConst = i->second->Const();
+                e.changes.push_back(c);
+        }
+
+        pCache->Put(e);
+
+        return v;
+}
+
 int
 HighParser::ParseWord(unsigned flags)
+{
+        if (pCache == 0) {
+                return ParseWord_int(flags);
+        }
+
+        if (pCache->bIsReplaying()) {
+                const ParserCache::Event& e = pCache->Get(ParserCache::WORD);
+                if (e.iStatus == 0) {
+                        strcpy(sStringBuf, e.s.c_str());
+
+                } else if (e.iStatus == HighParser::ENDOFFILE) {
+                        CurrToken = HighParser::ENDOFFILE;
+                }
+
+                return e.iStatus;
+        }
+
+        int rc;
+        try {
+                rc = ParseWord_int(flags);
+        }
+        catch (...) {
+                RecordException();
+                throw;
+        }
+
+        ParserCache::Event e(ParserCache::WORD, GetLineNumber());
+        e.iStatus = rc;
+        if (rc == 0) {
+                e.s = sStringBuf;
+        }
+        pCache->Put(e);
+
+        return rc;
+}
+
+int
+HighParser::ParseWord_int(unsigned flags)
 {
         char* sBuf = sStringBuf;
         char* sBufWithSpaces = sStringBufWithSpaces;
@@ -913,6 +1270,11 @@ HighParser::ParseWord(unsigned flags)
 void
 HighParser::PutbackWord(void)
 {
+        if (pCache != 0 && pCache->bIsReplaying()) {
+                /* the word is replayed again by the next ParseWord() */
+                return;
+        }
+
         char* sBufWithSpaces = sStringBufWithSpaces + strlen(sStringBufWithSpaces);
 
 
@@ -1106,7 +1468,7 @@ HighParser::GetWord(void)
                 throw HighParser::ErrKeyWordExpected(MBDYN_EXCEPT_ARGS);
         }
 
-        CurrLowToken = LowP.GetToken(*pIn);
+        CurrLowToken = GetLowToken();
         if (CurrLowToken != LowParser::WORD) {
                 silent_cerr("Parser error in "
                         << sFuncName << ", keyword expected at line "
@@ -1139,6 +1501,27 @@ HighParser::GetString(unsigned flags)
                 throw HighParser::ErrStringExpected(MBDYN_EXCEPT_ARGS);
         }
 
+        switch (ReadString(flags)) {
+        case 1:
+                return NULL;
+
+        case 2:
+                return sStringBuf;
+
+        default:
+                break;
+        }
+
+        NextToken(sFuncName);
+
+        return sStringBuf;
+}
+
+/* legge la stringa fino al separatore, escluso;
+ * ritorna 1 se trova subito la fine del file, 2 se la trova dopo */
+int
+HighParser::ReadString_int(unsigned flags)
+{
         char* s = sStringBuf;
         char* sTmp = s;
 
@@ -1150,7 +1533,7 @@ HighParser::GetString(unsigned flags)
 
         if (pIn->eof()) {
                 CurrToken = HighParser::ENDOFFILE;
-                return NULL;
+                return 1;
         }
 
         pIn->putback(cIn);
@@ -1160,7 +1543,7 @@ HighParser::GetString(unsigned flags)
                 if (pIn->eof()) {
                         CurrToken = HighParser::ENDOFFILE;
                         *sTmp = '\0';
-                        return s;
+                        return 2;
 
                 } else if (sTmp < s + iDefaultBufSize - 1) {
                         if (!(flags & HighParser::EATSPACES) || !isspace(cIn)) {
@@ -1179,9 +1562,7 @@ HighParser::GetString(unsigned flags)
         pIn->putback(cIn);
         *sTmp = '\0';
 
-        NextToken(sFuncName);
-
-        return s;
+        return 0;
 }
 
 void
@@ -1227,16 +1608,7 @@ HighParser::IsStringWithDelims(enum Delims Del)
         char cLdelim, cRdelim;
         SetDelims(Del, cLdelim, cRdelim);
 
-        char cIn;
-        if (skip_remarks(*this, *pIn, cIn)) {
-                return false;
-        }
-
-        /* put back the first non-remark char */
-        pIn->putback(cIn);
-
-        /* if the left delimiter is found, true */
-        return (cIn == cLdelim);
+        return IsDelim(cLdelim);
 }
 
 const char*
@@ -1251,6 +1623,21 @@ HighParser::GetStringWithDelims(enum Delims Del, bool escape)
                 throw HighParser::ErrStringExpected(MBDYN_EXCEPT_ARGS);
         }
 
+        if (ReadStringWithDelims(Del, escape) < 0) {
+                return NULL;
+        }
+
+        NextToken(sFuncName);
+        return sStringBuf;
+}
+
+/* ritorna -1 alla fine del file, 0 se legge la stringa,
+ * 1 se trova un separatore (sStringBuf non viene toccato) */
+int
+HighParser::ReadStringWithDelims_int(enum Delims Del, bool escape)
+{
+        const char sFuncName[] = "HighParser::GetStringWithDelims()";
+
         char* s = sStringBuf;
         char* sTmp = s;
 
@@ -1259,7 +1646,7 @@ HighParser::GetStringWithDelims(enum Delims Del, bool escape)
 
         char cIn;
         if (skip_remarks(*this, *pIn, cIn)) {
-                return NULL;
+                return -1;
         }
 
         /* Se trova il delimitatore sinistro, legge la stringa */
@@ -1365,7 +1752,7 @@ escaped_generic:;
                  * occuparsi della gestione del valore di default */
         } else if (cIn == ',' || cIn == ';') {
                 pIn->putback(cIn);
-                goto nullstring;
+                return 1;
 
                 /* Altrimenti c'e' qualcosa senza delimitatore. Adesso da' errore,
                  * forse e' piu' corretto fargli ritornare lo stream intatto */
@@ -1381,9 +1768,7 @@ escaped_generic:;
         /* Mette zero al termine della stringa */
         *sTmp = '\0';
 
-nullstring:;
-        NextToken(sFuncName);
-        return s;
+        return 0;
 }
 
 /* Returns the current input stream */
@@ -128,6 +128,7 @@
 class LowParser;
 class KeyTable;
 class HighParser;
+class ParserCache;
 
 
 const unsigned int iDefaultBufSize =
@@ -166,6 +167,7 @@ private:
         doublereal dCurrNumber;
 
         void PackWords(InputStream& In);
+        void SetWord(const std::string& s);
 
 public:
         LowParser(HighParser& hp);
@@ -418,7 +420,7 @@ protected:
 
         /* Stream in ingresso */
         InputStream* pIn;
-        std::ifstream* pf;
+        InputFileStream* pf;
 
         /* Buffer per le stringhe */
         char sStringBuf[iDefaultBufSize];
@@ -435,6 +437,18 @@ protected:
         LowParser::Token CurrLowToken;
         Token CurrToken;
 
+        /* compiled model cache, if any (not owned) */
+        ParserCache* pCache;
+
+        /* elementary input operations; they are recorded
+         * or replayed when the model cache is in use */
+        LowParser::Token GetLowToken(bool *pbEof = 0);
+        int ReadString(unsigned flags);
+        bool IsDelim(char cDelim);
+        int ReadStringWithDelims(enum Delims Del, bool escape);
+        TypedValue ReadValue(const TypedValue& vDefVal);
+        void RecordException(void);
+
         virtual HighParser::Token FirstToken(void);
         virtual void NextToken(const char* sFuncName);
 
@@ -445,7 +459,10 @@ protected:
         SetDelims(enum Delims Del, char &cLdelim, char &cRdelim) const;
 
         int ParseWord(unsigned flags = HighParser::NONE);
+        int ParseWord_int(unsigned flags);
         void PutbackWord(void);
+        int ReadString_int(unsigned flags);
+        int ReadStringWithDelims_int(enum Delims Del, bool escape);
 
 public:
         HighParser(MathParser& MP, InputStream& streamIn);
@@ -460,6 +477,8 @@ public:
         virtual MathParser& GetMathParser(void);
         /* "Chiude" i flussi */
         virtual void Close(void);
+        /* Attacca la cache del modello; Close() la salva */
+        void SetCache(ParserCache* p);
         /* verifica se il token successivo e' una description (ambiguo ...) */
         bool IsDescription(void) const;
         /* ha appena trovato una description */
@@ -598,7 +617,7 @@ HighParser::GetValue(const TypedValue& vDefVal, Range range)
         TypedValue v(vDefVal);
 
         try {
-                v = MathP.Get(*pIn, v);
+                v = ReadValue(v);
         }
         catch (TypedValue::ErrWrongType& e) {
                 silent_cerr(sFuncName << ": " << e.what() << " at line "
@@ -43,6 +43,7 @@
 #include <errno.h>
 
 #include "parsinc.h"
+#include "parscache.h"
 #include "filename.h"
 
 #ifndef PATH_MAX
@@ -148,6 +149,8 @@ sCurrFile(NULL)
 
 IncludeParser::~IncludeParser(void)
 {   
+	/* the model cache is saved only by an explicit Close() */
+	pCache = 0;
    	IncludeParser::Close();
 }
  
@@ -219,6 +222,8 @@ void IncludeParser::Close(void)
       		sCurrFile = NULL;
    	}
 #endif /* USE_INCLUDE_PARSER */
+
+	HighParser::Close();
 }
 
 flag 
@@ -290,7 +295,13 @@ IncludeParser::Include_int()
    
    	const char* sfname = GetFileName();
 
-	if (sfname != 0) {
+	/* when replaying, the included file is not read */
+	const bool bReplay = (pCache != 0 && pCache->bIsReplaying());
+
+	if (sfname != 0 && bReplay) {
+		pCache->Include(sfname);
+
+	} else if (sfname != 0) {
 		struct stat	s;
 
 		if (stat(sfname, &s)) {
@@ -317,12 +328,17 @@ IncludeParser::Include_int()
 				"no read permissions?" << std::endl);
 			throw ErrFile(MBDYN_EXCEPT_ARGS);
 		}
+
+		if (pCache != 0) {
+			pCache->Include(sfname);
+		}
+
 	} else {
 		silent_cerr("File name expected at line " << GetLineData() << std::endl);
 		throw ErrFile(MBDYN_EXCEPT_ARGS);
 	}
 
-	std::ifstream *pf_old = pf;
+	InputFileStream *pf_old = pf;
 	InputStream *pIn_old = pIn;
 	char *sOldPath = sCurrPath;
 	char *sOldFile = sCurrFile;
@@ -330,32 +346,37 @@ IncludeParser::Include_int()
    	pf = NULL;
    	pIn = NULL;
 
+	if (bReplay) {
+		SAFENEW(pf, InputFileStream);
+
+	} else {
 #ifdef _WIN32
-	// open the file in non translated mode in order not to break seek operations
-   	SAFENEWWITHCONSTRUCTOR(pf, std::ifstream, std::ifstream(sfname, std::ios::binary));
+		// open the file in non translated mode in order not to break seek operations
+		SAFENEWWITHCONSTRUCTOR(pf, InputFileStream, InputFileStream(sfname, std::ios::binary));
 #else
-   	SAFENEWWITHCONSTRUCTOR(pf, std::ifstream, std::ifstream(sfname));
+		SAFENEWWITHCONSTRUCTOR(pf, InputFileStream, InputFileStream(sfname));
 #endif
-   	if (!(*pf)) {
+		if (!(*pf)) {
 #ifdef DEBUG
-		char *buf = getcwd(NULL, 0);
-		if (buf != NULL) {
-			DEBUGCERR("Current directory \"" << buf << "\"" 
-					<< std::endl);
-			free(buf);
-		}
+			char *buf = getcwd(NULL, 0);
+			if (buf != NULL) {
+				DEBUGCERR("Current directory \"" << buf << "\"" 
+						<< std::endl);
+				free(buf);
+			}
 #endif /* DEBUG */
 
-		/* restore */
-		pf = pf_old;
-		pIn = pIn_old;
-		sCurrPath = sOldPath;
-		sCurrFile = sOldFile;
-   
-		silent_cerr("Invalid file <" << sfname << "> "
-			"at line " << GetLineData() << std::endl);
-      		throw ErrFile(MBDYN_EXCEPT_ARGS);
-   	}
+			/* restore */
+			pf = pf_old;
+			pIn = pIn_old;
+			sCurrPath = sOldPath;
+			sCurrFile = sOldFile;
+
+			silent_cerr("Invalid file <" << sfname << "> "
+				"at line " << GetLineData() << std::endl);
+			throw ErrFile(MBDYN_EXCEPT_ARGS);
+		}
+	}
    
    	SAFENEWWITHCONSTRUCTOR(pIn, InputStream, InputStream(*pf));
 
@@ -119,21 +119,21 @@ protected:
 	 * ATTENZIONE: non impedisce l'inclusione ricorsiva, e quindi il loop
 	 */
 	struct MyInput {
-		std::ifstream* pfile;
+		InputFileStream* pfile;
 		InputStream* pis;
 
 #ifdef USE_INCLUDE_PARSER
 		char* sPath;
 		char* sFile;
 
-		MyInput(std::ifstream* pf = NULL, InputStream* pi = NULL,
+		MyInput(InputFileStream* pf = NULL, InputStream* pi = NULL,
 			char* sp = NULL, char* sfile = NULL)
 		: pfile(pf), pis(pi), sPath(sp), sFile(sfile) {
 			NO_OP;
 		};
 
 #else /* !USE_INCLUDE_PARSER */
-		MyInput(std::ifstream* pf = NULL, InputStream* pi = NULL)
+		MyInput(InputFileStream* pf = NULL, InputStream* pi = NULL)
 		: pfile(pf), pis(pi) {
 			NO_OP;
 		};
@@ -35,6 +35,8 @@
 #include <string>
 #include <cmath>
 #include <limits>
+#include <vector>
+#include <algorithm>
 
 #include "myassert.h"
 #include "mynewmem.h"
@@ -156,19 +158,31 @@ Table::Get(const std::string& name) const
 	return i->second;
 }
 
+static bool
+NamedValueLess(const NamedValue *p1, const NamedValue *p2)
+{
+	return strcmp(p1->GetName(), p2->GetName()) < 0;
+}
+
 std::ostream&
 operator << (std::ostream& out, const Table& T)
 {
+	std::vector<const NamedValue *> v;
+	v.reserve(T.vm.size());
 	for (Table::VM::const_iterator i = T.vm.begin(); i != T.vm.end(); ++i) {
+		v.push_back(i->second);
+	}
+	std::sort(v.begin(), v.end(), NamedValueLess);
+
+	for (std::vector<const NamedValue *>::const_iterator i = v.begin(); i != v.end(); ++i) {
 		out << "  ";
-		if (i->second->Const()) {
+		if ((*i)->Const()) {
 			out << "const ";
 		}
-		out << i->second->GetTypeName()
-			<< " " << i->second->GetName()
-			<< " = " << i->second->GetVal() << std::endl;
+		out << (*i)->GetTypeName()
+			<< " " << (*i)->GetName()
+			<< " = " << (*i)->GetVal() << std::endl;
 	}
 
 	return out;
 }
-
@@ -35,7 +35,8 @@
 #define TABLE_H
 
 #include <cstring>
-#include <map>
+#include <string>
+#include <unordered_map>
 
 #include "except.h"
 #include "mathtyp.h"
@@ -50,7 +51,8 @@ public:
 			: MBDynErrBase(MBDYN_EXCEPT_ARGS_PASSTHRU) {};
 	};
 
-	typedef std::map<std::string, NamedValue *> VM;
+	/* hashed; the symbols are printed sorted by name */
+	typedef std::unordered_map<std::string, NamedValue *> VM;
 
 private:
 	VM vm;
@@ -37,6 +37,8 @@
 
 #ifdef USE_MULTITHREAD
 #include <signal.h>
+#include <atomic>
+#include <vector>
 #include "ac/spinlock.h"
 #endif /* USE_MULTITHREAD */
 
@@ -65,7 +67,8 @@ protected:
 
 public:
 	VecIter(void) : pStart(0), pCount(0), iSize(0) { NO_OP; };
-	VecIter(const T* p, unsigned i) : pStart(p), pCount(p), iSize(i)
+	VecIter(const T* p, unsigned i)
+	: pStart(const_cast<T *>(p)), pCount(const_cast<T *>(p)), iSize(i)
 	{
 		ASSERT(pStart != 0);
 		ASSERT(iSize > 0);
@@ -252,6 +255,239 @@ public:
 	};
 };
 
+/*
+ * Cost-weighted partition of a vector into contiguous chunks.
+ * The partition is computed once, and shared by the MT_PartVecIter
+ * of all threads; each thread owns a contiguous range of chunks,
+ * which is claimed chunk by chunk with a single atomic increment.
+ * When its own range is exhausted, a thread may steal the chunks
+ * that have not been claimed yet by the other threads.
+ * Reset() must be called once, and not concurrently, before each pass.
+ */
+class MT_VecPartition {
+public:
+	/* chunks per thread, to leave room for stealing */
+	enum { CHUNKS_PER_THREAD = 4 };
+
+protected:
+	struct ThreadRange {
+		/* on its own cache line, to avoid false sharing */
+		alignas(64) std::atomic<unsigned> iNext;
+		unsigned iFirst;
+		unsigned iLast;
+
+		ThreadRange(void) : iNext(0), iFirst(0), iLast(0) { NO_OP; };
+	};
+
+	/* chunk c spans items [Chunks[c], Chunks[c + 1]) */
+	std::vector<unsigned> Chunks;
+	mutable std::vector<ThreadRange> Threads;
+	bool bSteal;
+
+	inline bool
+	bClaim(ThreadRange& r, unsigned& iChunk) const
+	{
+		if (r.iNext.load(std::memory_order_relaxed) >= r.iLast) {
+			return false;
+		}
+
+		iChunk = r.iNext.fetch_add(1, std::memory_order_relaxed);
+
+		return (iChunk < r.iLast);
+	};
+
+public:
+	MT_VecPartition(unsigned nThreads, bool bSteal = true)
+	: Threads(nThreads), bSteal(bSteal)
+	{
+		ASSERT(nThreads > 0);
+	};
+
+	/*
+	 * Weights are the (estimated) costs of the items;
+	 * null weights are accounted for as unit weights.
+	 */
+	void
+	Partition(const std::vector<unsigned>& Weights)
+	{
+		const unsigned nThreads = Threads.size();
+		const unsigned nItems = Weights.size();
+		unsigned nChunks = nThreads*CHUNKS_PER_THREAD;
+		if (nChunks > nItems) {
+			nChunks = nItems;
+		}
+
+		double dTotal = 0.;
+		for (unsigned i = 0; i < nItems; i++) {
+			dTotal += Weights[i] ? Weights[i] : 1;
+		}
+
+		/* greedy cut at multiples of the average chunk weight,
+		 * making sure no chunk is empty */
+		Chunks.clear();
+		Chunks.reserve(nChunks + 1);
+		Chunks.push_back(0);
+
+		double dCurr = 0.;
+		for (unsigned i = 0; i < nItems && Chunks.size() < nChunks; i++) {
+			dCurr += Weights[i] ? Weights[i] : 1;
+			unsigned c = Chunks.size();
+			if (dCurr >= (dTotal*c)/nChunks
+				&& nItems - (i + 1) >= nChunks - c)
+			{
+				Chunks.push_back(i + 1);
+			}
+		}
+		if (Chunks.back() != nItems) {
+			Chunks.push_back(nItems);
+		}
+		nChunks = Chunks.size() - 1;
+
+		/* chunks have (roughly) the same weight,
+		 * so each thread gets the same number of chunks */
+		for (unsigned t = 0; t < nThreads; t++) {
+			Threads[t].iFirst = (nChunks*t)/nThreads;
+			Threads[t].iLast = (nChunks*(t + 1))/nThreads;
+		}
+
+		Reset();
+	};
+
+	void
+	Reset(void)
+	{
+		for (unsigned t = 0; t < Threads.size(); t++) {
+			Threads[t].iNext.store(Threads[t].iFirst,
+				std::memory_order_relaxed);
+		}
+		std::atomic_thread_fence(std::memory_order_release);
+	};
+
+	void SetSteal(bool b) { bSteal = b; };
+	bool bGetSteal(void) const { return bSteal; };
+	unsigned iGetNumThreads(void) const { return Threads.size(); };
+	unsigned iGetNumChunks(void) const { return Chunks.empty() ? 0 : Chunks.size() - 1; };
+
+	/* claims the next chunk for thread iThread;
+	 * returns false when no chunks are left */
+	inline bool
+	bGetChunk(unsigned iThread, unsigned& iBegin, unsigned& iEnd) const
+	{
+		ASSERT(iThread < Threads.size());
+
+		unsigned iChunk;
+		bool bGot = bClaim(Threads[iThread], iChunk);
+
+		for (unsigned t = 1; !bGot && bSteal && t < Threads.size(); t++) {
+			bGot = bClaim(Threads[(iThread + t) % Threads.size()], iChunk);
+		}
+
+		if (bGot) {
+			iBegin = Chunks[iChunk];
+			iEnd = Chunks[iChunk + 1];
+		}
+
+		return bGot;
+	};
+};
+
+/*
+ * Iterates over the chunks of a shared MT_VecPartition
+ * claimed by thread iThread; no per-item synchronization is needed,
+ * so items need not inherit from InUse.
+ */
+template<class T>
+class MT_PartVecIter : public VecIter<T> {
+protected:
+	MT_VecPartition *pPart;
+	unsigned iThread;
+	mutable T* pChunkEnd;
+
+	inline bool
+	bNextChunk(void) const
+	{
+		unsigned iBegin, iEnd;
+
+		if (!pPart->bGetChunk(iThread, iBegin, iEnd)) {
+			VecIter<T>::pCount = pChunkEnd = VecIter<T>::pStart + VecIter<T>::iSize;
+			return false;
+		}
+
+		VecIter<T>::pCount = VecIter<T>::pStart + iBegin;
+		pChunkEnd = VecIter<T>::pStart + iEnd;
+
+		return true;
+	};
+
+public:
+	MT_PartVecIter(void) : VecIter<T>(), pPart(0), iThread(0), pChunkEnd(0) { NO_OP; };
+
+	virtual ~MT_PartVecIter(void)
+	{
+		NO_OP;
+	};
+
+	void Init(const T* p, unsigned i, MT_VecPartition *pP, unsigned iT)
+	{
+		ASSERT(pP != 0);
+		ASSERT(iT < pP->iGetNumThreads());
+
+		VecIter<T>::Init(p, i);
+		pPart = pP;
+		iThread = iT;
+		pChunkEnd = VecIter<T>::pStart;
+	};
+
+	/* NOTE: it must be called only once, before each pass */
+	void ResetAccessData(void)
+	{
+		ASSERT(pPart != 0);
+
+		pPart->Reset();
+	};
+
+	inline bool bGetFirst(T& TReturn) const
+	{
+		ASSERT(VecIter<T>::pStart != NULL);
+		ASSERT(pPart != 0);
+
+		if (!bNextChunk()) {
+			return false;
+		}
+
+		TReturn = *VecIter<T>::pCount;
+
+		return true;
+	};
+
+	inline bool bGetCurr(T& TReturn) const
+	{
+		ASSERT(VecIter<T>::pStart != NULL);
+
+		if (VecIter<T>::pCount == VecIter<T>::pStart + VecIter<T>::iSize) {
+			return false;
+		}
+
+		TReturn = *VecIter<T>::pCount;
+
+		return true;
+	};
+
+	inline bool bGetNext(T& TReturn) const
+	{
+		ASSERT(VecIter<T>::pStart != NULL);
+		ASSERT(VecIter<T>::pCount < pChunkEnd);
+
+		if (++VecIter<T>::pCount == pChunkEnd && !bNextChunk()) {
+			return false;
+		}
+
+		TReturn = *VecIter<T>::pCount;
+
+		return true;
+	};
+};
+
 #endif /* USE_MULTITHREAD */
 
 #endif /* VECITER_H */
@@ -85,8 +85,7 @@ Axp(0),
 Aip(0),
 App(0),
 Symbolic(0),
-Numeric(0),
-iNumNonZeros(-1)
+Numeric(0)
 {
 	klu_defaults(&Control);
 
@@ -227,6 +226,8 @@ KLUSolver::Factor(void)
 
 		throw ErrGeneric(MBDYN_EXCEPT_ARGS);
 	}
+
+	iNumNumericFact++;
 }
 
 void
@@ -242,13 +243,15 @@ KLUSolver::MakeCompactForm(SparseMatrixHandler& mh,
 	
 	mh.MakeCompressedColumnForm(Ax, Ai, Ap, 0);
 
-        if (iNumNonZeros != mh.Nz()) {
-                ResetSymbolic();
-        }
-        
 	Axp = &(Ax[0]);
 	Aip = &(Ai[0]);
 	App = &(Ap[0]);
+
+	/* keep the symbolic factorization as long as the pattern
+	 * is unchanged; only klu_factor() is called in that case */
+	if (bPatternChanged(Aip, App, iSize, App[iSize])) {
+		ResetSymbolic();
+	}
 }
 
 bool 
@@ -267,6 +270,8 @@ KLUSolver::bPrepareSymbolic(void)
 		return false;
 	}
 
+	iNumSymbolicFact++;
+
 	return true;
 }
 
@@ -98,7 +98,6 @@ private:
         mutable klu_symbolic *Symbolic;
 	mutable klu_common Control;
 	mutable klu_numeric *Numeric;
-        mutable integer iNumNonZeros;
 
 	bool bPrepareSymbolic(void);
 	
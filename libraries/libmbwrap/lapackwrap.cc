@@ -121,6 +121,8 @@ LapackSolver::Factor(void)
 	integer	iINFO = 0;
 
 	__FC_DECL__(dgetrf)(&iSize, &iSize, pA, &iSize, piIPIV, &iINFO);
+
+	iNumNumericFact++;
 }
 
 /* LapackSolver - end */
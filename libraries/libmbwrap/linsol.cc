@@ -48,6 +48,7 @@
 #include "lapackwrap.h"
 #include "taucswrap.h"
 #include "naivewrap.h"
+#include "spnaivewrap.h"
 #include "parnaivewrap.h"
 #include "pardisowrap.h"
 #include "pastixwrap.h"
@@ -96,6 +97,13 @@ const LinSol::solver_t solver[] = {
 			0,
 		LinSol::SOLVER_FLAGS_NONE,
 		1.e-5, -1. },
+	{ "Sparse" "naive", NULL,
+		LinSol::SPNAIVE_SOLVER,
+		LinSol::SOLVER_FLAGS_ALLOWS_COLAMD |
+			LinSol::SOLVER_FLAGS_ALLOWS_MT_ASS |
+			0,
+		LinSol::SOLVER_FLAGS_NONE,
+		1.e-5, -1. },
 	{ "SuperLU", NULL, 
 		LinSol::SUPERLU_SOLVER,
 		LinSol::SOLVER_FLAGS_ALLOWS_COLAMD |
@@ -379,6 +387,10 @@ LinSol::SetSolver(LinSol::SolverType t, unsigned f)
 		currSolver = t;
 		return true;
 
+	case LinSol::SPNAIVE_SOLVER:
+		currSolver = t;
+		return true;
+
 	case LinSol::EMPTY_SOLVER:
 		currSolver = t;
 		return true;
@@ -569,6 +581,7 @@ LinSol::SetScale(const SolutionManager::ScaleOpt& s)
 {
 	switch (currSolver) {
 	case LinSol::NAIVE_SOLVER:
+	case LinSol::SPNAIVE_SOLVER:
 	case LinSol::UMFPACK_SOLVER:
 	case LinSol::KLU_SOLVER:
         case LinSol::PASTIX_SOLVER:
@@ -1266,6 +1279,19 @@ LinSol::GetSolutionManager(integer iNLD,
 		}
 		break;
 
+	case LinSol::SPNAIVE_SOLVER:
+		if (perm == LinSol::SOLVER_FLAGS_ALLOWS_COLAMD) {
+			SAFENEWWITHCONSTRUCTOR(pCurrSM,
+				SpNaiveSparsePermSolutionManager,
+				SpNaiveSparsePermSolutionManager(iNLD, dPivotFactor, scale));
+
+		} else {
+			SAFENEWWITHCONSTRUCTOR(pCurrSM,
+				SpNaiveSparseSolutionManager,
+				SpNaiveSparseSolutionManager(iNLD, dPivotFactor, scale));
+		}
+		break;
+
 	case LinSol::EMPTY_SOLVER:
 		break;
 		
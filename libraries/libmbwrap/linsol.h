@@ -47,6 +47,7 @@ public:
 		HARWELL_SOLVER,
 		LAPACK_SOLVER,
 		NAIVE_SOLVER,
+		SPNAIVE_SOLVER,
 		SUPERLU_SOLVER,
 		TAUCS_SOLVER,
                 UMFPACK_SOLVER,
@@ -148,6 +148,8 @@ NaiveSolver::Factor(void)
 
                 throw ErrGeneric(MBDYN_EXCEPT_ARGS);
         }
+
+        iNumNumericFact++;
 }
 
 /* NaiveSolver - end */
@@ -427,6 +429,7 @@ NaiveSparsePermSolutionManager<T>::Solve(void)
                 A->IsValid();
 #endif
                 ComputePermutation();
+                pLS->IncNumSymbolicFact();
 #ifdef DEBUG
                 A->IsValid();
 #endif
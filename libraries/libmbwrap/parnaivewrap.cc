@@ -369,6 +369,7 @@ ParNaiveSolver::Factor(void)
         }
         pthread_mutex_unlock(&thread_mutex);
 
+        iNumNumericFact++;
 }
 
 /* Risolve */
@@ -657,6 +658,7 @@ ParNaiveSparsePermSolutionManager::Solve(void)
 #endif
         if (ePermState == PERM_NO) {
                 ComputePermutation();
+                pLS->IncNumSymbolicFact();
 
         } else {
                 pLS->pdSetSolVec(VH.pdGetVec());
@@ -0,0 +1,421 @@
+/* $Header$ */
+/*
+ * MBDyn (C) is a multibody analysis code.
+ * http://www.mbdyn.org
+ *
+ * Copyright (C) 1996-2023
+ *
+ * Pierangelo Masarati	<pierangelo.masarati@polimi.it>
+ * Paolo Mantegazza	<paolo.mantegazza@polimi.it>
+ *
+ * Dipartimento di Ingegneria Aerospaziale - Politecnico di Milano
+ * via La Masa, 34 - 20156 Milano, Italy
+ * http://www.aero.polimi.it
+ *
+ * Changing this copyright notice is forbidden.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation (version 2 of the License).
+ *
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "mbconfig.h"           /* This goes first in every *.c,*.cc file */
+
+#include "spnaivewrap.h"
+#include "spmthrdslv.h"
+#include "dgeequ.h"
+
+/* SpNaiveSolver - begin */
+
+SpNaiveSolver::SpNaiveSolver(const integer &size, const doublereal& dMP,
+                SpNaiveMatrixHandler *const a)
+: LinearSolver(0),
+iSize(size),
+dMinPiv(dMP < 0 ? 0 : dMP),
+piv(size),
+A(a),
+iMemSize(0)
+{
+        NO_OP;
+}
+
+SpNaiveSolver::~SpNaiveSolver(void)
+{
+        NO_OP;
+}
+
+void
+SpNaiveSolver::SetMat(SpNaiveMatrixHandler *const a)
+{
+        A = a;
+}
+
+void
+SpNaiveSolver::Reset(void)
+{
+        bHasBeenReset = true;
+}
+
+void
+SpNaiveSolver::Solve(void) const
+{
+        if (bHasBeenReset) {
+                const_cast<SpNaiveSolver *>(this)->Factor();
+                bHasBeenReset = false;
+        }
+
+        integer rc = spnaivslv(&A->m,
+                        LinearSolver::pdRhs, LinearSolver::pdSol, &piv[0]);
+        integer err = (rc & NAIVE_MASK);
+        if (err) {
+                switch (err) {
+                case NAIVE_ERANGE:
+                        silent_cerr("SpNaiveSolver: ERANGE"
+                                << std::endl);
+                        break;
+
+                case NAIVE_ENOMEM:
+                        silent_cerr("SpNaiveSolver: ENOMEM"
+                                << std::endl);
+                        break;
+
+                default:
+                        silent_cerr("SpNaiveSolver: (" << rc << ")"
+                                << std::endl);
+                        break;
+                }
+
+                throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+        }
+}
+
+void
+SpNaiveSolver::Factor(void)
+/*throw(LinearSolver::ErrFactor)*/
+{
+        integer rc = spnaivfct(&A->m, &piv[0], dMinPiv);
+
+        integer err = (rc & NAIVE_MASK);
+        if (err) {
+                integer idx = (rc & NAIVE_MAX);
+                switch (err) {
+                case NAIVE_ENULCOL:
+                        silent_cerr("SpNaiveSolver: ENULCOL(" << idx << ")"
+                                << std::endl);
+                        throw LinearSolver::ErrNullColumn(idx, MBDYN_EXCEPT_ARGS);
+
+                case NAIVE_ENOPIV:
+                        silent_cerr("SpNaiveSolver: ENOPIV(" << idx << ")"
+                                << std::endl);
+                        throw LinearSolver::ErrNoPivot(idx + 1, MBDYN_EXCEPT_ARGS);
+
+                case NAIVE_ERANGE:
+                        silent_cerr("SpNaiveSolver: ERANGE"
+                                << std::endl);
+                        break;
+
+                case NAIVE_ENOMEM:
+                        silent_cerr("SpNaiveSolver: ENOMEM while eliminating column " << idx
+                                << "; consider a column reordering (e.g. colamd)"
+                                << std::endl);
+                        break;
+
+                default:
+                        silent_cerr("SpNaiveSolver: (" << rc << ")"
+                                << std::endl);
+                        break;
+                }
+
+                throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+        }
+
+        /* the fill-in only grows; report when it does */
+        size_t iCurrSize = A->GetMemorySize();
+        if (iCurrSize > iMemSize) {
+                iMemSize = iCurrSize;
+                pedantic_cout("SpNaiveSolver: " << iSize << "x" << iSize
+                        << " matrix uses " << iMemSize << " bytes"
+                        " (" << spnaiv_nblk(&A->m) << " blocks)" << std::endl);
+        }
+
+        iNumNumericFact++;
+}
+
+/* SpNaiveSolver - end */
+
+/* SpNaiveSparseSolutionManager - begin */
+
+SpNaiveSparseSolutionManager::SpNaiveSparseSolutionManager(const integer Dim,
+        const doublereal dMP, const ScaleOpt& s)
+: A(0),
+VH(Dim),
+scale(s),
+pMatScale(0)
+{
+        switch (scale.algorithm) {
+        case SCALEA_NONE:
+        case SCALEA_UNDEF:
+                scale.when = SCALEW_NEVER; // Default scaling is not supported for this solver
+                break;
+
+        default:
+                // Allocate MatrixScale<T> on demand
+                ;
+        }
+
+        SAFENEWWITHCONSTRUCTOR(A, SpNaiveMatrixHandler, SpNaiveMatrixHandler(Dim));
+        SAFENEWWITHCONSTRUCTOR(pLS, SpNaiveSolver, SpNaiveSolver(Dim, dMP, A));
+
+        pLS->pdSetResVec(VH.pdGetVec());
+        pLS->pdSetSolVec(VH.pdGetVec());
+
+        pLS->SetSolutionManager(this);
+
+#ifdef DEBUG
+        IsValid();
+#endif
+}
+
+#ifdef DEBUG
+void SpNaiveSparseSolutionManager::IsValid(void) const
+{
+        A->IsValid();
+}
+#endif /* DEBUG */
+
+SpNaiveSparseSolutionManager::~SpNaiveSparseSolutionManager(void)
+{
+        if (A != 0) {
+                SAFEDELETE(A);
+                A = 0;
+        }
+
+        if (pMatScale != 0) {
+                SAFEDELETE(pMatScale);
+        }
+}
+
+void
+SpNaiveSparseSolutionManager::MatrReset()
+{
+        pLS->Reset();
+}
+
+void
+SpNaiveSparseSolutionManager::ScaleMatrixAndRightHandSide(SpNaiveMatrixHandler& mh)
+{
+        if (scale.when != SCALEW_NEVER) {
+                if (pMatScale == 0) {
+                        pMatScale = MatrixScale<SpNaiveMatrixHandler>::Allocate(scale);
+                }
+
+                MatrixScale<SpNaiveMatrixHandler>& rMatScale
+                        = dynamic_cast<MatrixScale<SpNaiveMatrixHandler>&>(*pMatScale);
+
+                if (pLS->bReset()) {
+                        if (!rMatScale.bGetInitialized()
+                                || scale.when == SolutionManager::SCALEW_ALWAYS) {
+                                // (re)compute
+                                rMatScale.ComputeScaleFactors(mh);
+                        }
+                        // in any case scale matrix and right-hand-side
+                        rMatScale.ScaleMatrix(mh);
+
+                        if (silent_err) {
+                                rMatScale.Report(std::cerr);
+                        }
+                }
+
+                rMatScale.ScaleRightHandSide(VH);
+        }
+}
+
+void
+SpNaiveSparseSolutionManager::ScaleSolution(void)
+{
+        if (scale.when != SCALEW_NEVER) {
+                ASSERT(pMatScale != 0);
+                // scale solution
+                pMatScale->ScaleSolution(VH);
+        }
+}
+
+/* Risolve il sistema  Fattorizzazione + Backward Substitution */
+void
+SpNaiveSparseSolutionManager::Solve(void)
+{
+        ScaleMatrixAndRightHandSide(*A);
+
+        pLS->Solve();
+
+        ScaleSolution();
+}
+
+/* Rende disponibile l'handler per la matrice */
+MatrixHandler*
+SpNaiveSparseSolutionManager::pMatHdl(void) const
+{
+        return A;
+}
+
+/* Rende disponibile l'handler per il termine noto */
+MyVectorHandler*
+SpNaiveSparseSolutionManager::pResHdl(void) const
+{
+        return &VH;
+}
+
+/* Rende disponibile l'handler per la soluzione */
+MyVectorHandler*
+SpNaiveSparseSolutionManager::pSolHdl(void) const
+{
+        return &VH;
+}
+
+/* SpNaiveSparseSolutionManager - end */
+
+/* SpNaiveSparsePermSolutionManager - begin */
+
+SpNaiveSparsePermSolutionManager::SpNaiveSparsePermSolutionManager(
+        const integer Dim,
+        const doublereal dMP,
+        const ScaleOpt& scale)
+: SpNaiveSparseSolutionManager(Dim, dMP, scale),
+TmpH(Dim),
+ePermState(PERM_NO)
+{
+        perm.reserve(Dim);
+
+        for (integer i = 0; i < Dim; ++i) {
+                perm.push_back(i);
+        }
+
+        invperm.reserve(Dim + 1); // Dim + 1 required by SpNaiveMatrixHandler::MakeCCStructure, avoid reallocation
+
+        for (integer i = 0; i < Dim; ++i) {
+                invperm.push_back(i);
+        }
+
+        invperm.push_back(-1);
+
+        // replace matrix handler
+        SAFEDELETE(A);
+        A = 0;
+        SAFENEWWITHCONSTRUCTOR(A, SpNaiveMatrixHandler,
+                               SpNaiveMatrixHandler(Dim, &perm, &invperm));
+
+        dynamic_cast<SpNaiveSolver *>(pLS)->SetMat(A);
+
+        MatrInitialize();
+}
+
+SpNaiveSparsePermSolutionManager::~SpNaiveSparsePermSolutionManager(void)
+{
+        NO_OP;
+}
+
+void
+SpNaiveSparsePermSolutionManager::MatrReset(void)
+{
+        if (ePermState == PERM_INTERMEDIATE) {
+                ePermState = PERM_READY;
+        }
+
+        SpNaiveSparseSolutionManager::MatrReset();
+}
+
+void
+SpNaiveSparsePermSolutionManager::BackPerm(void)
+{
+        /* NOTE: use whatever is stored in pLS - someone could
+         * trick us into using its memory */
+        doublereal *pd = pLS->pdGetResVec();
+
+        ASSERT(pd != TmpH.pdGetVec());
+
+        for (integer i = 0; i < A->iGetNumCols(); i++) {
+                pd[invperm[i]] = TmpH(i + 1);
+        }
+}
+
+/* Risolve il sistema: Fattorizzazione + Backward Substitution */
+void
+SpNaiveSparsePermSolutionManager::Solve(void)
+{
+        doublereal *pd = 0;
+
+        ScaleMatrixAndRightHandSide(*A);
+
+        if (ePermState == PERM_NO) {
+                ComputePermutation();
+                pLS->IncNumSymbolicFact();
+
+        } else if (ePermState == PERM_READY) {
+                /* We need to use local storage to allow BackPerm();
+                 * save and restore original pointer */
+                pd = pLS->pdSetSolVec(TmpH.pdGetVec());
+        }
+
+        pLS->Solve();
+
+        if (ePermState == PERM_READY) {
+                BackPerm();
+
+                ASSERT(pd != 0);
+                pLS->pdSetSolVec(pd);
+        }
+
+        ScaleSolution();
+}
+
+/* Inizializzatore "speciale" */
+void
+SpNaiveSparsePermSolutionManager::MatrInitialize()
+{
+        ePermState = PERM_NO;
+        for (integer i = 0; i < A->iGetNumRows(); i++) {
+                perm[i] = i;
+                invperm[i] = i;
+        }
+
+        MatrReset();
+}
+
+extern "C" {
+#include "colamd.h"
+}
+
+void
+SpNaiveSparsePermSolutionManager::ComputePermutation(void)
+{
+        std::vector<integer> Ai;
+        A->MakeCCStructure(Ai, invperm);
+        doublereal knobs[COLAMD_KNOBS];
+        integer stats[COLAMD_STATS];
+        integer Alen = mbdyn_colamd_recommended(Ai.size(), A->iGetNumRows(),
+                        A->iGetNumCols());
+        Ai.resize(Alen);
+        mbdyn_colamd_set_defaults(knobs);
+        if (!mbdyn_colamd(A->iGetNumRows(), A->iGetNumCols(), Alen,
+                &Ai[0], &invperm[0], knobs, stats))
+        {
+                silent_cerr("colamd permutation failed" << std::endl);
+                throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+        }
+        for (integer i = 0; i < A->iGetNumRows(); i++) {
+                perm[invperm[i]] = i;
+        }
+        ePermState = PERM_INTERMEDIATE;
+}
+
+/* SpNaiveSparsePermSolutionManager - end */
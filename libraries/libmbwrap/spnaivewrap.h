@@ -0,0 +1,152 @@
+/* $Header$ */
+/*
+ * MBDyn (C) is a multibody analysis code.
+ * http://www.mbdyn.org
+ *
+ * Copyright (C) 1996-2023
+ *
+ * Pierangelo Masarati	<pierangelo.masarati@polimi.it>
+ * Paolo Mantegazza	<paolo.mantegazza@polimi.it>
+ *
+ * Dipartimento di Ingegneria Aerospaziale - Politecnico di Milano
+ * via La Masa, 34 - 20156 Milano, Italy
+ * http://www.aero.polimi.it
+ *
+ * Changing this copyright notice is forbidden.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation (version 2 of the License).
+ *
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Sparse-storage variant of the Naive Solver (see naivewrap.h)
+ */
+
+#ifndef SpNaiveSolutionManager_hh
+#define SpNaiveSolutionManager_hh
+
+#include <iostream>
+#include <vector>
+
+#include "myassert.h"
+#include "mynewmem.h"
+#include "ls.h"
+#include "solman.h"
+#include "spnaivemh.h"
+#include "dgeequ.h"
+
+/* SpNaiveSolver - begin */
+
+class SpNaiveSolver: public LinearSolver {
+private:
+        integer iSize;
+        doublereal dMinPiv;
+        mutable std::vector<integer> piv;
+        SpNaiveMatrixHandler *A;
+        size_t iMemSize;
+
+        void Factor(void) /*throw(LinearSolver::ErrFactor)*/;
+
+public:
+        SpNaiveSolver(const integer &size, const doublereal &dMP,
+                        SpNaiveMatrixHandler *const a = 0);
+        ~SpNaiveSolver(void);
+
+        void SetMat(SpNaiveMatrixHandler *const a);
+        void Reset(void);
+        void Solve(void) const;
+};
+
+/* SpNaiveSolver - end */
+
+/* SpNaiveSparseSolutionManager - begin */
+
+class SpNaiveSparseSolutionManager: public SolutionManager {
+protected:
+        mutable SpNaiveMatrixHandler *A;
+        mutable MyVectorHandler VH;
+
+        ScaleOpt scale;
+        MatrixScaleBase* pMatScale;
+
+        void ScaleMatrixAndRightHandSide(SpNaiveMatrixHandler& mh);
+
+        void ScaleSolution(void);
+
+public:
+        SpNaiveSparseSolutionManager(const integer Dim,
+                                     const doublereal dMP = 1.e-9,
+                                     const ScaleOpt& scale = ScaleOpt());
+        virtual ~SpNaiveSparseSolutionManager(void);
+#ifdef DEBUG
+        virtual void IsValid(void) const;
+#endif /* DEBUG */
+
+        /* Inizializzatore generico */
+        virtual void MatrReset(void);
+
+        /* Risolve il sistema Backward Substitution; fattorizza se necessario */
+        virtual void Solve(void);
+
+        /* Rende disponibile l'handler per la matrice */
+        virtual MatrixHandler* pMatHdl(void) const;
+
+        /* Rende disponibile l'handler per il termine noto */
+        virtual MyVectorHandler* pResHdl(void) const;
+
+        /* Rende disponibile l'handler per la soluzione */
+        virtual MyVectorHandler* pSolHdl(void) const;
+};
+
+/* SpNaiveSparseSolutionManager - end */
+
+/* SpNaiveSparsePermSolutionManager - begin */
+
+/* colamd column reordering, computed at the first factorization
+ * (see NaiveSparsePermSolutionManager<Colamd_ordering>) */
+class SpNaiveSparsePermSolutionManager: public SpNaiveSparseSolutionManager {
+private:
+        mutable MyVectorHandler TmpH;
+
+        void ComputePermutation(void);
+        void BackPerm(void);
+
+protected:
+        enum {
+                PERM_NO,
+                PERM_INTERMEDIATE,
+                PERM_READY
+        } ePermState;
+
+        mutable std::vector<integer> perm;
+        mutable std::vector<integer> invperm;
+
+        virtual void MatrReset(void);
+
+public:
+        SpNaiveSparsePermSolutionManager(const integer Dim,
+                                         const doublereal dMP = 1.e-9,
+                                         const ScaleOpt& scale = ScaleOpt());
+        virtual ~SpNaiveSparsePermSolutionManager(void);
+
+        /* Risolve il sistema Backward Substitution; fattorizza se necessario */
+        virtual void Solve(void);
+
+        /* Inizializzatore "speciale" */
+        virtual void MatrInitialize(void);
+};
+
+/* SpNaiveSparsePermSolutionManager - end */
+
+#endif /* SpNaiveSolutionManager_hh */
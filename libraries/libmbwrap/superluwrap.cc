@@ -195,9 +195,20 @@ SuperLUSolver::Factor(void)
 		int	*pc = &(sld->perm_c[0]);
 		get_perm_c(sld->options.ColPerm, &sld->A, pc);
 
+		iNumSymbolicFact++;
+
 		bRegenerateMatrix = false;
 	} else {
+		/* same pattern: reuse column permutation and elimination tree */
 		sld->options.Fact = SamePattern;
+		NCformat *Astore = (NCformat *) sld->A.Store;
+
+		ASSERT(Astore);
+
+		Astore->nzval = Axp;
+		Astore->rowind = Aip;
+		Astore->colptr = App;
+
 		Destroy_CompCol_Permuted(&sld->AC);
 		Destroy_SuperNode_Matrix(&sld->L);
 		Destroy_CompCol_Matrix(&sld->U);
@@ -213,6 +224,8 @@ SuperLUSolver::Factor(void)
 	dgstrf(&sld->options, &sld->AC, drop_tol, relax, panel_size, et, work, lwork, pc, pr, 
 		&sld->L, &sld->U, &sld->Gstat, &info);
 
+	iNumNumericFact++;
+
 }
 
 /* Risolve */
@@ -260,8 +273,10 @@ SuperLUSolver::MakeCompactForm(SparseMatrixHandler& mh,
 	Aip = &Ar[0];
 	App = &Ap[0];
 
-	/* rebuild matrix ... (CC is broken) */
-	bRegenerateMatrix = true;
+	/* rebuild matrix only if the pattern changed (CC is broken) */
+	if (bPatternChanged(Aip, App, iN, iNonZeroes)) {
+		bRegenerateMatrix = true;
+	}
 
 #if 0
 	Destroy_CompCol_Matrix(&sld->A);
@@ -132,7 +132,6 @@ iSize(size),
 Axp(nullptr),
 Aip(nullptr),
 App(nullptr),
-iNumNonZeros(-1),
 Symbolic(nullptr),
 Numeric(nullptr),
 bHaveCond(false)
@@ -318,6 +317,8 @@ UmfpackSolver::Factor(void)
 	} else {
 		bHaveCond = true;
 	}
+
+	iNumNumericFact++;
 		
         UMFPACKWRAP_report_numeric (Numeric, Control);
 	UMFPACKWRAP_report_info(Control, Info);
@@ -345,11 +346,11 @@ UmfpackSolver::MakeCompactForm(SparseMatrixHandler& mh,
 	Aip = &(Ai[0]);
 	App = &(Ap[0]);
 
-        if (mh.Nz() != iNumNonZeros) {
-                ResetSymbolic();
-        }
-
-        iNumNonZeros = mh.Nz();
+	/* keep the symbolic factorization as long as the pattern
+	 * is unchanged; only the numeric one is recomputed */
+	if (bPatternChanged(Aip, App, iSize, App[iSize])) {
+		ResetSymbolic();
+	}
 }
 
 bool 
@@ -371,6 +372,8 @@ UmfpackSolver::bPrepareSymbolic(void)
 		return false;
 	}
 
+	iNumSymbolicFact++;
+
 	return true;
 }
 
@@ -102,7 +102,6 @@ private:
 	mutable doublereal *Axp;
 	mutable integer *Aip;
 	mutable integer *App;
-        mutable integer iNumNonZeros;
 	mutable void *Symbolic;
 	mutable doublereal Control[UMFPACK_CONTROL];
 	mutable doublereal Info[UMFPACK_INFO];
@@ -199,6 +199,9 @@ Y12Solver::Factor(void)
 		throw Y12Solver::ErrFactorization(iIFAIL, MBDYN_EXCEPT_ARGS);
 	}
 
+	/* y12 alters the index arrays, so the analysis cannot be reused */
+	iNumSymbolicFact++;
+
 	/* actual factorization */
 	y12factor(&iN, &iNonZeroes, pdMat,
 			    pic, &iCurSize,
@@ -215,6 +218,8 @@ Y12Solver::Factor(void)
 		throw Y12Solver::ErrFactorization(iIFAIL, MBDYN_EXCEPT_ARGS);
 	}
 
+	iNumNumericFact++;
+
 	if (dAFLAG[7] < 1.e-12) {
 		silent_cerr("Y12Solver (y12factor):"
 			" warning, possible bad conditioning of matrix" 
@@ -0,0 +1,424 @@
+/* 
+ * MBDyn (C) is a multibody analysis code. 
+ * http://www.mbdyn.org
+ *
+ * Copyright (C) 2004-2023
+ *
+ * Pierangelo Masarati	<pierangelo.masarati@polimi.it>
+ * Paolo Mantegazza	<paolo.mantegazza@polimi.it>
+ *
+ * Dipartimento di Ingegneria Aerospaziale - Politecnico di Milano
+ * via La Masa, 34 - 20156 Milano, Italy
+ * http://www.aero.polimi.it
+ *
+ * Changing this copyright notice is forbidden.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation (version 2 of the License).
+ * 
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Sparse-storage variant of naivfct/naivslv; see spmthrdslv.h
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "mbconfig.h"           /* This goes first in every *.c,*.cc file */
+
+#include <math.h>
+#include "ac/f2c.h"
+
+#else /* !HAVE_CONFIG_H */
+/* to ease compilation outside of MBDyn...
+ * replace long and double with the preferred types */
+#include <math.h>
+typedef long int integer;
+typedef double doublereal;
+#endif /* !HAVE_CONFIG_H */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "spmthrdslv.h"
+
+#define MINPIV   1.0e-5
+
+/* initial size of the row and column index lists */
+#define SPNAIVE_MINIDX	(8)
+
+int
+spnaiv_init(spnaiv_mat *m, integer neq)
+{
+	m->neq = 0;
+	m->row = NULL;
+	m->col = NULL;
+
+	if (neq <= 0 || (unsigned long)neq > NAIVE_MAX) {
+		return NAIVE_ERANGE;
+	}
+
+	m->row = calloc(neq, sizeof(spnaiv_row));
+	m->col = calloc(neq, sizeof(spnaiv_col));
+	if (m->row == NULL || m->col == NULL) {
+		free(m->row);
+		free(m->col);
+		m->row = NULL;
+		m->col = NULL;
+		return NAIVE_ENOMEM;
+	}
+
+	m->neq = neq;
+
+	return 0;
+}
+
+void
+spnaiv_destroy(spnaiv_mat *m)
+{
+	integer i, b;
+
+	for (i = 0; i < m->neq; i++) {
+		spnaiv_row *pr = &m->row[i];
+
+		for (b = 0; b < pr->nb; b++) {
+			free(pr->blk[b]);
+		}
+		free(pr->blk);
+		free(pr->ci);
+		free(m->col[i].ri);
+	}
+
+	free(m->row);
+	free(m->col);
+	m->row = NULL;
+	m->col = NULL;
+	m->neq = 0;
+}
+
+void
+spnaiv_reset(spnaiv_mat *m)
+{
+	integer i, k;
+
+	for (i = 0; i < m->neq; i++) {
+		spnaiv_row *pr = &m->row[i];
+
+		for (k = 0; k < pr->nzc; k++) {
+			pr->blk[(pr->ci[k] >> SPNAIVE_BLKBITS) - pr->lo]->nz = 0U;
+		}
+		pr->nzc = 0;
+		m->col[i].nzr = 0;
+	}
+}
+
+size_t
+spnaiv_nblk(const spnaiv_mat *m)
+{
+	size_t n = 0;
+	integer i, b;
+
+	for (i = 0; i < m->neq; i++) {
+		const spnaiv_row *pr = &m->row[i];
+
+		for (b = 0; b < pr->nb; b++) {
+			if (pr->blk[b] != NULL) {
+				n++;
+			}
+		}
+	}
+
+	return n;
+}
+
+size_t
+spnaiv_size(const spnaiv_mat *m)
+{
+	size_t n = m->neq*(sizeof(spnaiv_row) + sizeof(spnaiv_col));
+	integer i;
+
+	for (i = 0; i < m->neq; i++) {
+		n += m->row[i].nb*sizeof(spnaiv_blk *)
+			+ (m->row[i].maxc + m->col[i].maxr)*sizeof(integer);
+	}
+
+	return n + spnaiv_nblk(m)*sizeof(spnaiv_blk);
+}
+
+static int
+spnaiv_growidx(integer **pidx, integer *pmax, integer neq)
+{
+	integer n = *pmax ? 2*(*pmax) : SPNAIVE_MINIDX;
+	integer *idx;
+
+	if (n > neq) {
+		n = neq;
+	}
+
+	idx = realloc(*pidx, n*sizeof(integer));
+	if (idx == NULL) {
+		return -1;
+	}
+
+	*pidx = idx;
+	*pmax = n;
+
+	return 0;
+}
+
+/* extend the block directory of a row to include block b;
+ * when growing, some slack is added on the same side
+ * to amortize the cost of further extensions */
+static int
+spnaiv_growdir(const spnaiv_mat *m, spnaiv_row *pr, integer b)
+{
+	integer nblk = ((m->neq - 1) >> SPNAIVE_BLKBITS) + 1;
+	integer lo = b, hi = b;
+	spnaiv_blk **blk;
+
+	if (pr->nb > 0) {
+		integer slack = pr->nb/2 + 1;
+
+		lo = pr->lo;
+		hi = pr->lo + pr->nb - 1;
+		if (b < lo) {
+			lo = b - slack;
+			if (lo < 0) {
+				lo = 0;
+			}
+
+		} else {
+			hi = b + slack;
+			if (hi >= nblk) {
+				hi = nblk - 1;
+			}
+		}
+	}
+
+	blk = calloc(hi - lo + 1, sizeof(spnaiv_blk *));
+	if (blk == NULL) {
+		return -1;
+	}
+
+	if (pr->nb > 0) {
+		memcpy(&blk[pr->lo - lo], pr->blk, pr->nb*sizeof(spnaiv_blk *));
+		free(pr->blk);
+	}
+
+	pr->blk = blk;
+	pr->lo = lo;
+	pr->nb = hi - lo + 1;
+
+	return 0;
+}
+
+doublereal *
+spnaiv_rowins(spnaiv_mat *m, integer r, integer c)
+{
+	spnaiv_row *pr = &m->row[r];
+	integer b = c >> SPNAIVE_BLKBITS;
+	spnaiv_blk *pb;
+
+	if (b < pr->lo || b >= pr->lo + pr->nb) {
+		if (spnaiv_growdir(m, pr, b)) {
+			return NULL;
+		}
+	}
+
+	pb = pr->blk[b - pr->lo];
+	if (pb == NULL) {
+		pb = calloc(1, sizeof(spnaiv_blk));
+		if (pb == NULL) {
+			return NULL;
+		}
+		pr->blk[b - pr->lo] = pb;
+	}
+
+	if (pr->nzc == pr->maxc) {
+		if (spnaiv_growidx(&pr->ci, &pr->maxc, m->neq)) {
+			return NULL;
+		}
+	}
+
+	pr->ci[pr->nzc++] = c;
+	pb->nz |= 1U << (c & SPNAIVE_BLKMASK);
+	pb->v[c & SPNAIVE_BLKMASK] = 0.;
+
+	return &pb->v[c & SPNAIVE_BLKMASK];
+}
+
+int
+spnaiv_colins(spnaiv_mat *m, integer c, integer r)
+{
+	spnaiv_col *pc = &m->col[c];
+
+	if (pc->nzr == pc->maxr) {
+		if (spnaiv_growidx(&pc->ri, &pc->maxr, m->neq)) {
+			return -1;
+		}
+	}
+
+	pc->ri[pc->nzr++] = r;
+
+	return 0;
+}
+
+int
+spnaivfct(spnaiv_mat *m, integer *piv, doublereal minpiv)
+{
+	integer neq = m->neq;
+	char *todo = NULL;
+	integer *uc = NULL;
+	doublereal *uv = NULL;
+	integer i, j, k, pvr, pvc, nr, nc, nu, r;
+	integer *pri, *pci;
+	doublereal den, mul, mulpiv, fari;
+	doublereal *par;
+	int rc = 0;
+
+	if (neq <= 0 || (unsigned long)neq > NAIVE_MAX) {
+		return NAIVE_ERANGE;
+	}
+
+	if (!minpiv) {
+		minpiv = MINPIV;
+	}
+
+	/* the part of the pivot row right of the diagonal is gathered
+	 * in uc/uv, so that each elimination only looks up the target row */
+	todo = malloc(neq*sizeof(char));
+	uc = malloc(neq*sizeof(integer));
+	uv = malloc(neq*sizeof(doublereal));
+	if (todo == NULL || uc == NULL || uv == NULL) {
+		rc = NAIVE_ENOMEM;
+		goto done;
+	}
+
+	for (pvr = 0; pvr < neq; pvr++) {
+		todo[pvr] = 1;
+	}
+	for (i = 0; i < neq; i++) {
+		nr = m->col[i].nzr;
+		if (!nr) { rc = NAIVE_ENULCOL + i; goto done; }
+		nc = neq + 1;
+		mul = 0.0;
+		pri = m->col[i].ri;
+		pvr = pri[0];
+		for (k = 0; k < nr; k++) {
+			r = pri[k];
+			if (todo[r]) {
+				fari = fabs(*spnaiv_get(m, r, i));
+				if (fari > mul) {
+					mul = fari;
+				}
+			}
+		}
+		mulpiv = mul*minpiv;
+		for (k = 0; k < nr; k++) {
+			r = pri[k];
+			if (todo[r]) {
+				fari = fabs(*spnaiv_get(m, r, i));
+				if (fari >= mulpiv && m->row[r].nzc < nc) {
+					nc = m->row[pvr = r].nzc;
+				}
+			}
+		}
+		if (nc == neq + 1) { rc = NAIVE_ENOPIV + i; goto done; }
+		if (mulpiv == 0.)  { rc = NAIVE_ENOPIV + i; goto done; }
+
+		piv[i] = pvr;
+		todo[pvr] = 0;
+		par = spnaiv_get(m, pvr, i);
+		den = *par = 1.0/(*par);
+
+		pci = m->row[pvr].ci;
+		for (j = 0, nu = 0; j < nc; j++) {
+			if ((pvc = pci[j]) <= i) { continue; }
+			uc[nu] = pvc;
+			uv[nu] = *spnaiv_get(m, pvr, pvc);
+			nu++;
+		}
+
+		/* fill-in only touches columns > i, so pri is not reallocated */
+		for (k = 0; k < nr; k++) {
+			if (!todo[r = pri[k]]) { continue; }
+			par = spnaiv_get(m, r, i);
+			mul = *par = *par*den;
+			for (j = 0; j < nu; j++) {
+				doublereal *p = spnaiv_ref(m, r, uc[j]);
+				if (p == NULL) { rc = NAIVE_ENOMEM + i; goto done; }
+				*p -= mul*uv[j];
+			}
+		}
+	}
+
+done:;
+	free(todo);
+	free(uc);
+	free(uv);
+
+	return rc;
+}
+
+int
+spnaivslv(const spnaiv_mat *m, doublereal *rhs, doublereal *sol,
+		const integer *piv)
+{
+	integer neq = m->neq;
+	doublereal *fwd;
+
+	integer i, k, nc, r, c;
+	const integer *pci;
+	doublereal s;
+
+	if (neq <= 0 || (unsigned long)neq > NAIVE_MAX) {
+		return NAIVE_ERANGE;
+	}
+
+	fwd = malloc(neq*sizeof(doublereal));
+	if (fwd == NULL) {
+		return NAIVE_ENOMEM;
+	}
+
+	fwd[0] = rhs[piv[0]];
+	for (i = 1; i < neq; i++) {
+		r = piv[i];
+		nc = m->row[r].nzc;
+		pci = m->row[r].ci;
+		s = rhs[r];
+		for (k = 0; k < nc; k++) {
+			if ((c = pci[k]) < i) {
+				s -= *spnaiv_get(m, r, c)*fwd[c];
+			}
+		}
+		fwd[i] = s;
+	}
+
+	r = piv[--neq];
+	sol[neq] = fwd[neq]*(*spnaiv_get(m, r, neq));
+	for (i = neq - 1; i >= 0; i--) {
+		r = piv[i];
+		nc = m->row[r].nzc;
+		pci = m->row[r].ci;
+		s = fwd[i];
+		for (k = 0; k < nc; k++) {
+			if ((c = pci[k]) > i) {
+				s -= *spnaiv_get(m, r, c)*sol[c];
+			}
+		}
+		sol[i] = s*(*spnaiv_get(m, r, i));
+	}
+
+	free(fwd);
+
+	return 0;
+}
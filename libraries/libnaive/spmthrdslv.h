@@ -0,0 +1,158 @@
+/* 
+ * MBDyn (C) is a multibody analysis code. 
+ * http://www.mbdyn.org
+ *
+ * Copyright (C) 2004-2023
+ *
+ * Pierangelo Masarati	<pierangelo.masarati@polimi.it>
+ * Paolo Mantegazza	<paolo.mantegazza@polimi.it>
+ *
+ * Dipartimento di Ingegneria Aerospaziale - Politecnico di Milano
+ * via La Masa, 34 - 20156 Milano, Italy
+ * http://www.aero.polimi.it
+ *
+ * Changing this copyright notice is forbidden.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation (version 2 of the License).
+ * 
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Sparse-storage variant of the naive solver.
+ *
+ * The algorithm is the same as naivfct/naivslv (see mthrdslv.h):
+ * scatter-add assembly with O(1) access to any coefficient, and
+ * LU factorization with sparse partial pivoting that creates the fill-in
+ * while eliminating.  Storage, however, is proportional to the number
+ * of nonzeros (including fill-in) instead of neq x neq:
+ *
+ * - each row owns a directory of pointers to blocks of SPNAIVE_BLKSIZE
+ *   consecutive columns; the directory only spans the range of blocks
+ *   that actually contain nonzeros, and blocks are allocated on first
+ *   access;
+ * - each block stores the values and a bitmask of the coefficients that
+ *   belong to the pattern (the equivalent of nz[row][col]);
+ * - the row (resp. column) lists of nonzero column (row) indices,
+ *   ci[row] (ri[col]) in naivfct, are growable arrays.
+ *
+ * Since pivoting makes the pattern of the factors depend on the values,
+ * it cannot be predicted symbolically; the structure simply grows as
+ * needed, and after the first factorization all the blocks are reused
+ * (spnaiv_reset() only clears the pattern).
+ */
+
+#ifndef spmthrdslv_h
+#define spmthrdslv_h
+
+#include "mthrdslv.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#define SPNAIVE_BLKBITS		(4)
+#define SPNAIVE_BLKSIZE		(1 << SPNAIVE_BLKBITS)
+#define SPNAIVE_BLKMASK		(SPNAIVE_BLKSIZE - 1)
+
+/* returned, possibly added to the column index, when memory is exhausted;
+ * not a single bit because the sign bit of a 32 bit integer is not usable */
+#define NAIVE_ENOMEM	(0x70000000U)
+
+typedef struct spnaiv_blk {
+	doublereal v[SPNAIVE_BLKSIZE];
+	unsigned nz;
+} spnaiv_blk;
+
+typedef struct spnaiv_row {
+	/* blk[b - lo] is block b, for lo <= b < lo + nb; may be NULL */
+	spnaiv_blk **blk;
+	integer lo, nb;
+	/* column indices of the nonzeros, not ordered */
+	integer *ci;
+	integer nzc, maxc;
+} spnaiv_row;
+
+typedef struct spnaiv_col {
+	/* row indices of the nonzeros, not ordered */
+	integer *ri;
+	integer nzr, maxr;
+} spnaiv_col;
+
+typedef struct spnaiv_mat {
+	integer neq;
+	spnaiv_row *row;
+	spnaiv_col *col;
+} spnaiv_mat;
+
+extern int spnaiv_init(spnaiv_mat *m, integer neq);
+extern void spnaiv_destroy(spnaiv_mat *m);
+extern void spnaiv_reset(spnaiv_mat *m);
+
+/* number of allocated blocks and bytes (pattern, values and indices) */
+extern size_t spnaiv_nblk(const spnaiv_mat *m);
+extern size_t spnaiv_size(const spnaiv_mat *m);
+
+/*
+ * Adds (r, c) to the pattern of row r only, setting it to zero;
+ * the caller must also call spnaiv_colins(m, c, r).
+ * This split allows to update rows and columns under different locks.
+ * Returns NULL if memory is exhausted.
+ */
+extern doublereal *spnaiv_rowins(spnaiv_mat *m, integer r, integer c);
+extern int spnaiv_colins(spnaiv_mat *m, integer c, integer r);
+
+/* returns the coefficient (r, c), or NULL if not in the pattern */
+static inline doublereal *
+spnaiv_get(const spnaiv_mat *m, integer r, integer c)
+{
+	const spnaiv_row *pr = &m->row[r];
+	unsigned long b = (unsigned long)((c >> SPNAIVE_BLKBITS) - pr->lo);
+	spnaiv_blk *pb;
+
+	if (b < (unsigned long)pr->nb && (pb = pr->blk[b]) != NULL
+		&& (pb->nz & (1U << (c & SPNAIVE_BLKMASK))))
+	{
+		return &pb->v[c & SPNAIVE_BLKMASK];
+	}
+
+	return NULL;
+}
+
+/* returns the coefficient (r, c), adding it to the pattern if needed;
+ * returns NULL if memory is exhausted */
+static inline doublereal *
+spnaiv_ref(spnaiv_mat *m, integer r, integer c)
+{
+	doublereal *p = spnaiv_get(m, r, c);
+
+	if (p == NULL) {
+		p = spnaiv_rowins(m, r, c);
+		if (p != NULL && spnaiv_colins(m, c, r)) {
+			p = NULL;
+		}
+	}
+
+	return p;
+}
+
+extern int spnaivfct(spnaiv_mat *m, integer *piv, doublereal minpiv);
+
+extern int spnaivslv(const spnaiv_mat *m, doublereal *rhs, doublereal *sol,
+		const integer *piv);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* spmthrdslv_h */
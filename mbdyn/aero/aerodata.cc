@@ -168,6 +168,32 @@ AeroMemory::GetNumPoints(void) const
 	return iPoints;
 }
 
+std::ostream&
+AeroMemory::Checkpoint(std::ostream& out) const
+{
+	int s = StorageSize();
+
+	CheckpointPut(out, numUpdates);
+	if (s > 0) {
+		out.write((const char *)a, 2*s*iPoints*sizeof(doublereal));
+	}
+
+	return out;
+}
+
+std::istream&
+AeroMemory::Resume(std::istream& in)
+{
+	int s = StorageSize();
+
+	CheckpointGet(in, numUpdates);
+	if (s > 0) {
+		in.read((char *)a, 2*s*iPoints*sizeof(doublereal));
+	}
+
+	return in;
+}
+
 /* AeroMemory - end */
 
 /* C81Data - begin */
@@ -391,6 +417,19 @@ AeroData::GetForcesJac(int i, const doublereal* W, doublereal* TNG, Mat6x6& J, o
 	throw ErrGeneric(MBDYN_EXCEPT_ARGS);
 }
 
+int
+AeroData::QueueForces(int i, const doublereal* W, doublereal* TNG, outa_t& OUTA)
+{
+	// no batching by default: evaluate right away
+	return GetForces(i, W, TNG, OUTA);
+}
+
+int
+AeroData::FlushForces(void)
+{
+	return 0;
+}
+
 void
 AeroData::AssRes(SubVectorHandler& WorkVec,
 	doublereal dCoef,
@@ -77,6 +77,10 @@ public:
 	void Update(int i);
 	void SetNumPoints(int i);
 	int GetNumPoints(void) const;
+
+	/* binary dump/restore of the angle of attack history */
+	virtual std::ostream& Checkpoint(std::ostream& out) const;
+	virtual std::istream& Resume(std::istream& in);
 };
 
 /* Memory - end */
@@ -143,6 +147,14 @@ public:
 	virtual int
 	GetForcesJac(int i, const doublereal* W, doublereal* TNG, Mat6x6& J, outa_t& OUTA);
 
+	// batched evaluation: QueueForces() may defer the evaluation
+	// of the forces at point i until FlushForces() is called;
+	// W, TNG and OUTA must stay valid and untouched in between
+	virtual int
+	QueueForces(int i, const doublereal* W, doublereal* TNG, outa_t& OUTA);
+	virtual int
+	FlushForces(void);
+
 	// aerodynamic models with internal states
 	virtual unsigned int iGetNumDof(void) const;
 	virtual DofOrder::Order GetDofType(unsigned int i) const;
@@ -39,6 +39,7 @@
 #include "aerod2.h"
 #endif // USE_AEROD2_F
 #include "c81data.h"
+#include "simentity.h"
 
 #ifdef USE_AEROD2_F
 
@@ -109,6 +110,89 @@ STAHRAeroData::GetForcesJac(int i, const doublereal* W, doublereal* TNG, Mat6x6&
 
 #endif // USE_AEROD2_F
 
+/* C81AeroDataHolder - begin */
+
+C81AeroDataHolder::C81AeroDataHolder(int i_p, int i_dim,
+	AeroData::UnsteadyModel u, DriveCaller *ptime)
+: AeroData(i_p, i_dim, u, ptime),
+hints(i_p*i_dim)
+{
+	for (std::vector<c81_hint>::iterator h = hints.begin(); h != hints.end(); ++h) {
+		c81_hint_init(&*h);
+	}
+
+	if (unsteadyflag == AeroData::STEADY) {
+		queue.reserve(hints.size());
+		queue_data.reserve(hints.size());
+	}
+}
+
+C81AeroDataHolder::~C81AeroDataHolder(void)
+{
+	NO_OP;
+}
+
+c81_hint *
+C81AeroDataHolder::GetHint(int i)
+{
+	ASSERT(i >= 0);
+	ASSERT(unsigned(i) < hints.size());
+
+	return &hints[i];
+}
+
+int
+C81AeroDataHolder::QueueForces(int i, const doublereal* W, doublereal* TNG, outa_t& OUTA)
+{
+	// unsteady corrections need the memory of each point
+	// to be predicted right before the lookup
+	if (unsteadyflag != AeroData::STEADY) {
+		return GetForces(i, W, TNG, OUTA);
+	}
+
+	c81_point p;
+	p.W = W;
+	p.VAM = VAM;
+	p.TNG = TNG;
+	p.OUTA = &OUTA;
+	p.hint = GetHint(i);
+
+	queue.push_back(p);
+	queue_data.push_back(GetCurData(i));
+
+	return 0;
+}
+
+int
+C81AeroDataHolder::FlushForces(void)
+{
+	int rc = 0;
+
+	// consecutive points that share the same table are evaluated
+	// in a single batch
+	std::vector<c81_point>::size_type n = queue.size();
+	for (std::vector<c81_point>::size_type b = 0; b < n; ) {
+		std::vector<c81_point>::size_type e = b + 1;
+		while (e < n && queue_data[e] == queue_data[b]) {
+			e++;
+		}
+
+		int rcb = c81_aerod2_u_batch(e - b, &queue[b], queue_data[b], unsteadyflag);
+		if (rc == 0) {
+			rc = rcb;
+		}
+
+		b = e;
+	}
+
+	queue.clear();
+	queue_data.clear();
+
+	return rc;
+}
+
+/* C81AeroDataHolder - end */
+
 /* C81AeroData - begin */
 
 C81AeroData::C81AeroData(int i_p, int i_dim,
@@ -146,8 +230,8 @@ C81AeroData::GetForces(int i, const doublereal* W, doublereal* TNG, outa_t& OUTA
 		break;
 	}
 
-	return c81_aerod2_u(W, &VAM, TNG, &OUTA,
-		data, unsteadyflag);
+	return c81_aerod2_u_hint(W, &VAM, TNG, &OUTA,
+		data, unsteadyflag, GetHint(i));
 }
 
 int
@@ -233,8 +317,8 @@ C81MultipleAeroData::GetForces(int i, const doublereal* W, doublereal* TNG, outa
 	ASSERT(i >= 0);
 	ASSERT(unsigned(i) < data.size());
 
-	return c81_aerod2_u(W, &VAM, TNG, &OUTA,
-		data[curr_data], unsteadyflag);
+	return c81_aerod2_u_hint(W, &VAM, TNG, &OUTA,
+		data[curr_data], unsteadyflag, GetHint(i));
 }
 
 int
@@ -347,8 +431,8 @@ C81InterpolatedAeroData::GetForces(int i, const doublereal* W, doublereal* TNG,
 		break;
 	}
 
-	return c81_aerod2_u(W, &VAM, TNG, &OUTA,
-		&i_data[i], unsteadyflag);
+	return c81_aerod2_u_hint(W, &VAM, TNG, &OUTA,
+		&i_data[i], unsteadyflag, GetHint(i));
 }
 
 int
@@ -937,4 +1021,31 @@ TheodorsenAeroData::AfterConvergence(int i,
 	prev_time = pTime->dGet();
 }
 
+std::ostream&
+TheodorsenAeroData::Checkpoint(std::ostream& out) const
+{
+	AeroData::Checkpoint(out);
+
+	/* previous step values used by the finite differences */
+	int n = GetNumPoints();
+	out.write((const char *)prev_alpha_pivot, n*sizeof(doublereal));
+	out.write((const char *)prev_dot_alpha, n*sizeof(doublereal));
+	CheckpointPut(out, prev_time);
+
+	return out;
+}
+
+std::istream&
+TheodorsenAeroData::Resume(std::istream& in)
+{
+	AeroData::Resume(in);
+
+	int n = GetNumPoints();
+	in.read((char *)prev_alpha_pivot, n*sizeof(doublereal));
+	in.read((char *)prev_dot_alpha, n*sizeof(doublereal));
+	CheckpointGet(in, prev_time);
+
+	return in;
+}
+
 /* TheodorsenAeroData - end */
@@ -58,11 +58,24 @@ public:
 /* C81AeroData - begin */
 
 class C81AeroDataHolder : public AeroData {
+protected:
+	// table brackets of the last lookup, one set per point
+	std::vector<c81_hint> hints;
+
+	// points queued by QueueForces(), evaluated by FlushForces()
+	std::vector<c81_point> queue;
+	std::vector<const c81_data *> queue_data;
+
+	c81_hint *GetHint(int i);
+
 public:
 	C81AeroDataHolder(int i_p, int i_dim,
-		AeroData::UnsteadyModel u, DriveCaller *ptime) : AeroData(i_p, i_dim, u, ptime) {};
-	virtual ~C81AeroDataHolder() {};
+		AeroData::UnsteadyModel u, DriveCaller *ptime);
+	virtual ~C81AeroDataHolder(void);
 	virtual const c81_data* GetCurData(const int i) const = 0;
+
+	virtual int QueueForces(int i, const doublereal* W, doublereal* TNG, outa_t& OUTA);
+	virtual int FlushForces(void);
 };
 
 class C81AeroData : public C81AeroDataHolder {
@@ -216,6 +229,9 @@ public:
 		int i, const doublereal* W, doublereal* TNG, Mat6x6& J, outa_t& OUTA);
 	virtual void
 	AfterConvergence( int i, const VectorHandler& X, const VectorHandler& XP );
+
+	virtual std::ostream& Checkpoint(std::ostream& out) const;
+	virtual std::istream& Resume(std::istream& in);
 };
 
 /* TheodorsenAeroData - end */
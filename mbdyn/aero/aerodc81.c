@@ -70,13 +70,57 @@ C 3 direzione lungo l'apertura,
 C DM*W da' la velocita' nel punto a 3/4 della corda      
 */
 
+/*
+ * bracket of a point in a c81 table: the coefficient is interpolated
+ * between the mach columns at offsets clo, chi (weight d) and between
+ * the alpha rows alo, ahi (weight da); out of the tables, the two
+ * columns (rows) coincide and the weight is zero
+ */
+typedef struct c81_interp {
+	int clo, chi;
+	doublereal d;
+	int alo, ahi;
+	doublereal da;
+} c81_interp;
+
+/* kinematics of a section */
+typedef struct c81_kin {
+	doublereal v[3];
+	doublereal vp, vp2;
+	doublereal alpha, cosgam, mach;
+} c81_kin;
+
+static int
+c81_search(doublereal* v, doublereal val, int n, int *hint);
+
+static void
+get_interp(int nm, doublereal* m, int na, doublereal* a,
+		doublereal alpha, doublereal mach,
+		c81_interp *ip, c81_interp *ip0, int *hint);
+
+static doublereal
+interp(const doublereal* a, const c81_interp *ip);
+
 static int
 get_coef(int nm, doublereal* m, int na, doublereal* a,
 		doublereal alpha, doublereal mach,
-		doublereal* c, doublereal* c0);
+		doublereal* c, doublereal* c0, int *hint);
 
 static doublereal
-get_dcla(int nm, doublereal* m, doublereal* s, doublereal mach);
+get_dcla(int nm, doublereal* m, doublereal* s, doublereal mach, int *hint);
+
+static int
+c81_kinematics(const doublereal* W, const vam_t *VAM, doublereal* TNG,
+		outa_t* OUTA, c81_kin *kin);
+
+static void
+c81_steady_cl(const c81_kin *kin, doublereal *cl, doublereal cl0,
+		doublereal *dcla);
+
+static void
+c81_forces(const vam_t *VAM, const c81_kin *kin,
+		doublereal cl, doublereal cd, doublereal cd0, doublereal cm,
+		doublereal dcla, doublereal* TNG, outa_t* OUTA);
 
 #ifdef USE_GET_STALL
 static int
@@ -91,11 +135,23 @@ c81_data_get_coef(int nm, doublereal* m, int na, doublereal* a, doublereal alpha
 {
 	doublereal c;
 	
-	get_coef(nm, m, na, a, alpha, mach, &c, NULL);
+	get_coef(nm, m, na, a, alpha, mach, &c, NULL, NULL);
 
 	return c;
 }
 
+void
+c81_hint_init(c81_hint *hint)
+{
+	int i;
+
+	for (i = 0; i < 3; i++) {
+		hint->lift[i] = -1;
+		hint->drag[i] = -1;
+		hint->moment[i] = -1;
+	}
+}
+
 int 
 c81_aerod2(doublereal* W, const vam_t *VAM, doublereal* TNG, outa_t* OUTA, c81_data* data)
 {
@@ -182,13 +238,13 @@ c81_aerod2(doublereal* W, const vam_t *VAM, doublereal* TNG, outa_t* OUTA, c81_d
 	 * Note: all angles in c81 files MUST be in degrees
 	 */
 	get_coef(data->NML, data->ml, data->NAL, data->al,
-			OUTA->alpha, mach, &cl, &cl0);
+			OUTA->alpha, mach, &cl, &cl0, NULL);
 	get_coef(data->NMD, data->md, data->NAD, data->ad,
-			OUTA->alpha, mach, &cd, &cd0);
+			OUTA->alpha, mach, &cd, &cd0, NULL);
 	get_coef(data->NMM, data->mm, data->NAM, data->am,
-			OUTA->alpha, mach, &cm, NULL);
+			OUTA->alpha, mach, &cm, NULL, NULL);
 
-	dcla = get_dcla(data->NML, data->ml, data->stall, mach);
+	dcla = get_dcla(data->NML, data->ml, data->stall, mach, NULL);
 	
 /*
  * da COE0 (aerod2.f):
@@ -243,20 +299,21 @@ int
 c81_aerod2_u(const doublereal* W, const vam_t *VAM, doublereal* TNG, outa_t* OUTA, 
 		const c81_data* data, long unsteadyflag)
 {
-   	/* 
-	 * velocita' del punto in cui sono calcolate le condizioni al contorno
-	 */
-   	doublereal v[3];
-   	doublereal vp, vp2, vtot;
-	doublereal rho = VAM->density;
+	return c81_aerod2_u_hint(W, VAM, TNG, OUTA, data, unsteadyflag, NULL);
+}
+
+/*
+ * porta la velocita' al punto di calcolo delle boundary conditions
+ * e calcola angoli e numero di Mach; restituisce 1 (con forze nulle)
+ * se la velocita' e' trascurabile
+ */
+static int
+c81_kinematics(const doublereal* W, const vam_t *VAM, doublereal* TNG,
+		outa_t* OUTA, c81_kin *kin)
+{
+	doublereal *v = kin->v;
+	doublereal vtot, gamma;
 	doublereal cs = VAM->sound_celerity;
-	doublereal chord = VAM->chord;
-	
-	doublereal cl = 0., cl0 = 0., cd = 0., cd0 = 0., cm = 0.;
-	doublereal alpha, gamma, cosgam, mach, q;
-	doublereal dcla = 0.;
-	
-	doublereal ca = VAM->force_position;
 	doublereal c34 = VAM->bc_position;
 
 	const doublereal RAD2DEG = 180.*M_1_PI;
@@ -271,17 +328,17 @@ c81_aerod2_u(const doublereal* W, const vam_t *VAM, doublereal* TNG, outa_t* OUT
 	v[V_Y] = W[V_Y] + c34*W[W_Z];
 	v[V_Z] = W[V_Z] - c34*W[W_Y];
 	
-	vp2 = v[V_X]*v[V_X] + v[V_Y]*v[V_Y];
-	vp = sqrt(vp2);
+	kin->vp2 = v[V_X]*v[V_X] + v[V_Y]*v[V_Y];
+	kin->vp = sqrt(kin->vp2);
 	
-	vtot = sqrt(vp2 + v[V_Z]*v[V_Z]);
+	vtot = sqrt(kin->vp2 + v[V_Z]*v[V_Z]);
 	
 	/*
 	 * non considera velocita' al di sotto di 1.e-6
 	 * FIXME: rendere parametrico?
 	 */
 
-	if (vp/cs < 1.e-6) {
+	if (kin->vp/cs < 1.e-6) {
 		TNG[V_X] = 0.;
 		TNG[V_Y] = 0.;
 		TNG[V_Z] = 0.;
@@ -297,7 +354,7 @@ c81_aerod2_u(const doublereal* W, const vam_t *VAM, doublereal* TNG, outa_t* OUT
 		OUTA->cm = 0.;
 		OUTA->clalpha = 0.;
 		
-		return 0;
+		return 1;
 	}
 	
 	/*
@@ -308,8 +365,8 @@ c81_aerod2_u(const doublereal* W, const vam_t *VAM, doublereal* TNG, outa_t* OUT
 	 * oltre quell'angolo prendere la correzione per flusso trasverso
 	 * in un certo modo, altrimenti in un altro ?!?
 	 */
-	alpha = atan2(-v[V_Y], v[V_X]);
-	OUTA->alpha = alpha*RAD2DEG;  
+	kin->alpha = atan2(-v[V_Y], v[V_X]);
+	OUTA->alpha = kin->alpha*RAD2DEG;  
 	gamma = atan2(-v[V_Z], fabs(v[V_X]));	/* come in COE0 (aerod2.f) */
 	/* gamma = atan2(-v[V_Z], vp); */		/* secondo me (?!?) */
 	OUTA->gamma = gamma*RAD2DEG;
@@ -319,35 +376,20 @@ c81_aerod2_u(const doublereal* W, const vam_t *VAM, doublereal* TNG, outa_t* OUT
 		gamma = M_PI_3;
 	}
 	
-	cosgam = cos(gamma);
-	mach = (vtot*sqrt(cosgam))/cs;
-	OUTA->mach = mach;
+	kin->cosgam = cos(gamma);
+	kin->mach = (vtot*sqrt(kin->cosgam))/cs;
+	OUTA->mach = kin->mach;
 
 	/*
 	 * mach cannot be more than .99 (see aerod.f)
 	 */
-	if (mach > .99) {
-		mach = .99;
+	if (kin->mach > .99) {
+		kin->mach = .99;
 	}
 
-	/*
-	 * Compute cl, cd, cm based on selected theory
-	 */
-	switch (unsteadyflag) {
-	case 0: 
-
-		/*
-		 * Note: all angles in c81 files MUST be in degrees
-		 */
-		get_coef(data->NML, data->ml, data->NAL, data->al, 
-				OUTA->alpha, mach, &cl, &cl0);
-		get_coef(data->NMD, data->md, data->NAD, data->ad, 
-				OUTA->alpha, mach, &cd, &cd0);
-		get_coef(data->NMM, data->mm, data->NAM, data->am, 
-				OUTA->alpha, mach, &cm, NULL);
+	return 0;
+}
 
-		dcla = get_dcla(data->NML, data->ml, data->stall, mach);
-	
 /*
  * da COE0 (aerod2.f):
  * 
@@ -357,23 +399,113 @@ c81_aerod2_u(const doublereal* W, const vam_t *VAM, doublereal* TNG, outa_t* OUT
 	IF(ASLRF.GT.ASLOP0) ASLRF = ASLOP0
      10 CLIFT = ASLRF*ALFA
  *
+ * in soldoni: se si e' oltre il tratto lineare, prende la
+ * secante con l'angolo corretto per la freccia (fino a 60 
+ * gradi) e poi ricalcola il cl con l'angolo vero; in questo
+ * modo il cl viene piu' grande di circa 1/cos(gamma) ma solo
+ * fuori del tratto lineare.
  */
+static void
+c81_steady_cl(const c81_kin *kin, doublereal *cl, doublereal cl0,
+		doublereal *dcla)
+{
+	const doublereal RAD2DEG = 180.*M_1_PI;
+
+	*dcla *= RAD2DEG;
+	if (fabs(kin->alpha) > 1.e-6) {
+		doublereal dclatmp = (*cl - cl0)/(kin->alpha*kin->cosgam);
+		if (dclatmp < *dcla) {
+			*dcla = dclatmp;
+			*cl = cl0 + *dcla*kin->alpha;
+		}
+	}
+}
+
+static void
+c81_forces(const vam_t *VAM, const c81_kin *kin,
+		doublereal cl, doublereal cd, doublereal cd0, doublereal cm,
+		doublereal dcla, doublereal* TNG, outa_t* OUTA)
+{
+	const doublereal *v = kin->v;
+	doublereal vp = kin->vp;
+	doublereal chord = VAM->chord;
+	doublereal ca = VAM->force_position;
+	doublereal q;
+
+	enum { V_X = 0, V_Y = 1, V_Z = 2, W_X = 3, W_Y = 4, W_Z = 5 };
+
+	/*
+	 * Save cl, cd, cm for output purposes
+	 */
+	OUTA->cl = cl;
+	OUTA->cd = cd;
+	OUTA->cm = cm;
+	OUTA->clalpha = dcla;
+
+	/*
+	 * Local dynamic pressure
+	 */
+	q = .5*VAM->density*chord*kin->vp2;
+
+	/*
+	 * airfoil forces and moments in the airfoil frame
+	 */
+	TNG[V_X] = -q*(cl*v[V_Y] + cd*v[V_X])/vp;
+	TNG[V_Y] = q*(cl*v[V_X] - cd*v[V_Y])/vp;
+	TNG[V_Z] = -q*cd0*v[V_Z]/vp;
+	TNG[W_X] = 0.;
+	TNG[W_Y] = -ca*TNG[V_Z];
+	TNG[W_Z] = q*chord*cm + ca*TNG[V_Y];
+	
+	/* 
+	 * Radial drag (TNG[V_Z]) consistent with Harris, JAHS 1970
+	 * and with CAMRAD strip theory section forces 
+	 */
+}
+
+int 
+c81_aerod2_u_hint(const doublereal* W, const vam_t *VAM, doublereal* TNG, outa_t* OUTA, 
+		const c81_data* data, long unsteadyflag, c81_hint *hint)
+{
+	c81_kin kin;
+	const doublereal *v = kin.v;
+	doublereal chord = VAM->chord;
+	doublereal cl = 0., cl0 = 0., cd = 0., cd0 = 0., cm = 0.;
+	doublereal alpha, cosgam, mach, vp, vp2;
+	doublereal dcla = 0.;
+
+	const doublereal RAD2DEG = 180.*M_1_PI;
+
+	enum { V_X = 0, V_Y = 1 };
+
+	if (c81_kinematics(W, VAM, TNG, OUTA, &kin)) {
+		return 0;
+	}
+
+	alpha = kin.alpha;
+	cosgam = kin.cosgam;
+	mach = kin.mach;
+	vp = kin.vp;
+	vp2 = kin.vp2;
+
+	/*
+	 * Compute cl, cd, cm based on selected theory
+	 */
+	switch (unsteadyflag) {
+	case 0: 
 
 		/*
-		 * in soldoni: se si e' oltre il tratto lineare, prende la
-		 * secante con l'angolo corretto per la freccia (fino a 60 
-		 * gradi) e poi ricalcola il cl con l'angolo vero; in questo
-		 * modo il cl viene piu' grande di circa 1/cos(gamma) ma solo
-		 * fuori del tratto lineare.
+		 * Note: all angles in c81 files MUST be in degrees
 		 */
-		dcla *= RAD2DEG;
-		if (fabs(alpha) > 1.e-6) {
-			doublereal dclatmp = (cl - cl0)/(alpha*cosgam);
-			if (dclatmp < dcla) {
-				dcla = dclatmp;
-				cl = cl0 + dcla*alpha;
-			}
-		}
+		get_coef(data->NML, data->ml, data->NAL, data->al, 
+				OUTA->alpha, mach, &cl, &cl0, hint ? hint->lift : NULL);
+		get_coef(data->NMD, data->md, data->NAD, data->ad, 
+				OUTA->alpha, mach, &cd, &cd0, hint ? hint->drag : NULL);
+		get_coef(data->NMM, data->mm, data->NAM, data->am, 
+				OUTA->alpha, mach, &cm, NULL, hint ? hint->moment : NULL);
+
+		dcla = get_dcla(data->NML, data->ml, data->stall, mach, hint ? hint->lift : NULL);
+		c81_steady_cl(&kin, &cl, cl0, &dcla);
 		break;
 
 	case 1:
@@ -555,16 +687,16 @@ c81_aerod2_u(const doublereal* W, const vam_t *VAM, doublereal* TNG, outa_t* OUT
 
 		alphaN = (alpha - DAN)*RAD2DEG;
 		get_coef(data->NML, data->ml, data->NAL, data->al, 
-				alphaN, mach, &cl, &cl0);
+				alphaN, mach, &cl, &cl0, hint ? hint->lift : NULL);
 		get_coef(data->NMD, data->md, data->NAD, data->ad, 
-				alphaN, mach, &cd, &cd0);
+				alphaN, mach, &cd, &cd0, hint ? hint->drag : NULL);
 
 		alphaM = (alpha - DAM)*RAD2DEG;
 		get_coef(data->NMM, data->mm, data->NAM, data->am, 
-				alphaM, mach, &cm, NULL);
+				alphaM, mach, &cm, NULL, hint ? hint->moment : NULL);
 
-		dcla = get_dcla(data->NML, data->ml, data->stall, mach);
-		dcma = get_dcla(data->NMM, data->mm, data->mstall, mach);
+		dcla = get_dcla(data->NML, data->ml, data->stall, mach, hint ? hint->lift : NULL);
+		dcma = get_dcla(data->NMM, data->mm, data->mstall, mach, hint ? hint->moment : NULL);
 
 		/* note: cl/alpha in 1/deg */
 		dclatan = dcla;
@@ -594,49 +726,163 @@ c81_aerod2_u(const doublereal* W, const vam_t *VAM, doublereal* TNG, outa_t* OUT
 	}
 	}
 
-	/*
-	 * Save cl, cd, cm for output purposes
-	 */
-	OUTA->cl = cl;
-	OUTA->cd = cd;
-	OUTA->cm = cm;
-	OUTA->clalpha = dcla;
+	c81_forces(VAM, &kin, cl, cd, cd0, cm, dcla, TNG, OUTA);
 
-	/*
-	 * Local dynamic pressure
-	 */
-	q = .5*rho*chord*vp2;
+	return 0;
+}
 
-	/*
-	 * airfoil forces and moments in the airfoil frame
-	 */
-	TNG[V_X] = -q*(cl*v[V_Y] + cd*v[V_X])/vp;
-	TNG[V_Y] = q*(cl*v[V_X] - cd*v[V_Y])/vp;
-	TNG[V_Z] = -q*cd0*v[V_Z]/vp;
-	TNG[W_X] = 0.;
-	TNG[W_Y] = -ca*TNG[V_Z];
-	TNG[W_Z] = q*chord*cm + ca*TNG[V_Y];
-	
-	/* 
-	 * Radial drag (TNG[V_Z]) consistent with Harris, JAHS 1970
-	 * and with CAMRAD strip theory section forces 
-	 */
+/*
+ * Batched evaluation of the steady model: the sections are processed
+ * in blocks of C81_BATCH, one phase at a time (kinematics, search
+ * of the brackets, interpolation of the coefficients, forces),
+ * so that the interpolation runs as a branch-free loop over the sections
+ * of the block; the unsteady models are evaluated section by section
+ */
+#define C81_BATCH	(16)
+
+int
+c81_aerod2_u_batch(int n, c81_point *p, const c81_data* data, long unsteadyflag)
+{
+	c81_kin kin[C81_BATCH];
+	c81_interp il[C81_BATCH], il0[C81_BATCH], id[C81_BATCH], id0[C81_BATCH], im[C81_BATCH];
+	doublereal cl[C81_BATCH], cl0[C81_BATCH], cd[C81_BATCH], cd0[C81_BATCH], cm[C81_BATCH];
+	int idx[C81_BATCH];
+	int i0;
+
+	if (unsteadyflag != 0) {
+		int i;
+
+		for (i = 0; i < n; i++) {
+			int rc = c81_aerod2_u_hint(p[i].W, &p[i].VAM, p[i].TNG,
+				p[i].OUTA, data, unsteadyflag, p[i].hint);
+			if (rc != 0) {
+				return rc;
+			}
+		}
+
+		return 0;
+	}
+
+	for (i0 = 0; i0 < n; i0 += C81_BATCH) {
+		int nb = n - i0 < C81_BATCH ? n - i0 : C81_BATCH;
+		int nk = 0;
+		int k;
+
+		/* kinematics; sections with negligible velocity are done */
+		for (k = 0; k < nb; k++) {
+			c81_point *pp = &p[i0 + k];
+
+			if (c81_kinematics(pp->W, &pp->VAM, pp->TNG, pp->OUTA, &kin[nk])) {
+				continue;
+			}
+
+			idx[nk] = i0 + k;
+			nk++;
+		}
+
+		/* brackets (note: all angles in c81 files MUST be in degrees) */
+		for (k = 0; k < nk; k++) {
+			c81_hint *h = p[idx[k]].hint;
+			doublereal alpha = p[idx[k]].OUTA->alpha;
+			doublereal mach = kin[k].mach;
+
+			get_interp(data->NML, data->ml, data->NAL, data->al,
+				alpha, mach, &il[k], &il0[k], h ? h->lift : NULL);
+			get_interp(data->NMD, data->md, data->NAD, data->ad,
+				alpha, mach, &id[k], &id0[k], h ? h->drag : NULL);
+			get_interp(data->NMM, data->mm, data->NAM, data->am,
+				alpha, mach, &im[k], NULL, h ? h->moment : NULL);
+		}
+
+		/* coefficients */
+		for (k = 0; k < nk; k++) {
+			cl[k] = interp(data->al, &il[k]);
+			cl0[k] = interp(data->al, &il0[k]);
+		}
+
+		for (k = 0; k < nk; k++) {
+			cd[k] = interp(data->ad, &id[k]);
+			cd0[k] = interp(data->ad, &id0[k]);
+		}
+
+		for (k = 0; k < nk; k++) {
+			cm[k] = interp(data->am, &im[k]);
+		}
+
+		/* forces */
+		for (k = 0; k < nk; k++) {
+			c81_point *pp = &p[idx[k]];
+			doublereal dcla = get_dcla(data->NML, data->ml, data->stall,
+				kin[k].mach, pp->hint ? pp->hint->lift : NULL);
+
+			c81_steady_cl(&kin[k], &cl[k], cl0[k], &dcla);
+			c81_forces(&pp->VAM, &kin[k], cl[k], cd[k], cd0[k], cm[k],
+				dcla, pp->TNG, pp->OUTA);
+		}
+	}
 
 	return 0;
 }
 
 /*
- * trova un coefficiente dato l'angolo ed il numero di Mach
- *
- * il numero di Mach mach viene cercato nell'array m di lunghezza nm
- * ed interpolato linearmente; quindi il coefficiente alpha viene cercato
- * nella prima colonna della matrice a di dimensioni na x nm + 1 ed interpolato
- * linearmente; infine il coefficiente corrispondente alla combinazione di
- * mach e alpha viene restituito.
+ * cerca val in v come bisec_d(), partendo dall'intervallo
+ * dell'ultima ricerca (o da quelli adiacenti) se hint non e' NULL
  */
 static int
-get_coef(int nm, doublereal* m, int na, doublereal* a, doublereal alpha, doublereal mach,
-		doublereal* c, doublereal* c0)
+c81_search(doublereal* v, doublereal val, int n, int *hint)
+{
+	int i;
+
+	if (hint == NULL) {
+		return bisec_d(v, val, 0, n - 1);
+	}
+
+	i = *hint;
+	if (i >= 0 && i < n - 1) {
+		if (val < v[i]) {
+			if (i > 0 && val >= v[i - 1]) {
+				*hint = i - 1;
+				return i - 1;
+			}
+
+		} else if (val < v[i + 1]) {
+			return i;
+
+		} else if (i < n - 2 && val < v[i + 2]) {
+			*hint = i + 1;
+			return i + 1;
+		}
+
+	} else if (i == -1) {
+		if (val < v[0]) {
+			return -1;
+		}
+
+	} else if (i == n - 1) {
+		if (val > v[n - 1]) {
+			return n - 1;
+		}
+	}
+
+	i = bisec_d(v, val, 0, n - 1);
+	*hint = i;
+
+	return i;
+}
+
+/*
+ * il numero di Mach mach viene cercato nell'array m di lunghezza nm;
+ * l'angolo alpha viene cercato nella prima colonna della matrice a
+ * di dimensioni na x nm + 1; ip riceve le colonne, le righe ed i pesi
+ * per interpolare linearmente il coefficiente, ip0 (se non NULL)
+ * quelli per il coefficiente ad incidenza nulla.
+ * hint (se non NULL) contiene gli indici dell'ultima ricerca
+ * di mach, alpha e dell'incidenza nulla.
+ */
+static void
+get_interp(int nm, doublereal* m, int na, doublereal* a,
+		doublereal alpha, doublereal mach,
+		c81_interp *ip, c81_interp *ip0, int *hint)
 {
    	int im;
    	int ia, ia0 = -1;
@@ -655,120 +901,118 @@ get_coef(int nm, doublereal* m, int na, doublereal* a, doublereal alpha, doubler
 	 * im e' l'indice di m in cui si trova
 	 * l'approssimazione per difetto di mach
 	 */
-	im = bisec_d(m, mach, 0, nm - 1);
+	im = c81_search(m, mach, nm, hint ? &hint[0] : NULL);
 	
 	/*
 	 * ia e' l'indice della prima colonna di a in cui si trova
 	 * l'approssimazione per difetto di alpha
 	 */
-	if (c0 != NULL) {
-		ia0 = bisec_d(a, 0., 0, na - 1);
+	if (ip0 != NULL) {
+		ia0 = c81_search(a, 0., na, hint ? &hint[2] : NULL);
 	}
 
-	ia = bisec_d(a, alpha, 0, na - 1);
+	ia = c81_search(a, alpha, na, hint ? &hint[1] : NULL);
+
+	if (im == nm - 1 || im == -1) {
+		/* fuori dal campo di mach: usa la colonna estrema */
+		ip->clo = ip->chi = (im == -1) ? na : na*nm;
+		ip->d = 0.;
+
+		if (ip0 != NULL) {
+			ip0->clo = ip0->chi = ip->clo;
+			ip0->d = 0.;
 
-	if (im == nm - 1) {
-		if (c0 != NULL) {
 			if (ia0 == na - 1) {
-				*c0 = a[na*(nm + 1) - 1];
+				ip0->alo = ip0->ahi = na - 1;
+				ip0->da = 0.;
 
 			} else if (ia0 == -1) {
-				*c0 = a[na*nm];
+				ip0->alo = ip0->ahi = 0;
+				ip0->da = 0.;
 
 			} else {
-				doublereal da;
-
 				ia0++;
-				da = -a[ia0 - 1]/(a[ia0] - a[ia0 - 1]);
-				*c0 = (1. - da)*a[na*nm + ia0 - 1] + da*a[na*nm + ia0];
+				ip0->alo = ia0 - 1;
+				ip0->ahi = ia0;
+				ip0->da = -a[ia0 - 1]/(a[ia0] - a[ia0 - 1]);
 			}
 		}
-		
-		if (ia == na - 1) {
-			*c = a[na*(nm + 1) - 1];
-
-		} else if (ia == -1) {
-			*c = a[na*nm];
 
-		} else {
-			doublereal da;
-
-			ia++;
-			da = (alpha - a[ia - 1])/(a[ia] - a[ia - 1]);
-			*c = (1. - da)*a[na*nm + ia - 1] + da*a[na*nm + ia];
-		}
+	} else {
+		im++;
+		ip->clo = na*im;
+		ip->chi = na*(im + 1);
+		ip->d = (mach - m[im - 1])/(m[im] - m[im - 1]);
 
-	} else if (im == -1) {
-		if (c0 != NULL) {
-			if (ia0 == na - 1) {
-				*c0 = a[na*2 - 1];
+		if (ip0 != NULL) {
+			ip0->clo = ip->clo;
+			ip0->chi = ip->chi;
+			ip0->d = ip->d;
 
-			} else if (ia0 == -1) {
-				*c0 = a[na];
+			if (ia0 == na) {
+				ip0->alo = ip0->ahi = na - 1;
+				ip0->da = 0.;
 
 			} else {
-				doublereal da;
-
-				ia0++;
-				da = -a[ia0 - 1]/(a[ia0] - a[ia0 - 1]);
-				*c0 = (1. - da)*a[na + ia0 - 1] + da*a[na + ia0];
+				ip0->alo = ia0 - 1;
+				ip0->ahi = ia0;
+				ip0->da = -a[ia0 - 1]/(a[ia0] - a[ia0 - 1]);
 			}
 		}
-		
-		if (ia == na - 1) {
-			*c = a[na*2 - 1];
-
-		} else if (ia == -1) {
-			*c = a[na];
+	}
 
-		} else {
-			doublereal da;
+	if (ia == na - 1) {
+		ip->alo = ip->ahi = na - 1;
+		ip->da = 0.;
 
-			ia++;
-			da = (alpha - a[ia - 1])/(a[ia] - a[ia - 1]);
-			*c = (1. - da)*a[na + ia - 1] + da*a[na + ia];
-		}
+	} else if (ia == -1) {
+		ip->alo = ip->ahi = 0;
+		ip->da = 0.;
 
 	} else {
-		doublereal d;
-
-		im++;
-		d = (mach - m[im - 1])/(m[im] - m[im - 1]);
+		ia++;
+		ip->alo = ia - 1;
+		ip->ahi = ia;
+		ip->da = (alpha - a[ia - 1])/(a[ia] - a[ia - 1]);
+	}
+}
 
-		if (c0 != NULL) {
-			if (ia0 == na) {
-				*c0 = (1. - d)*a[na*(im + 1) - 1] + d*a[na*(im + 2) - 1];
-			} else {
-				doublereal a1, a2, da;
-				a1 = (1. - d)*a[na*im + ia0 - 1] + d*a[na*(im + 1) + ia0 - 1];
-				a2 = (1. - d)*a[na*im + ia0] + d*a[na*(im + 1) + ia0];
-				da = -a[ia0 - 1]/(a[ia0] - a[ia0 - 1]);
-				*c0 = (1. - da)*a1 + da*a2;
-			}
-		}
+static doublereal
+interp(const doublereal* a, const c81_interp *ip)
+{
+	doublereal a1 = (1. - ip->d)*a[ip->clo + ip->alo] + ip->d*a[ip->chi + ip->alo];
+	doublereal a2 = (1. - ip->d)*a[ip->clo + ip->ahi] + ip->d*a[ip->chi + ip->ahi];
 
-		if (ia == na - 1) {
-			*c = (1. - d)*a[na*(im + 1) - 1] + d*a[na*(im + 2) - 1];
+	return (1. - ip->da)*a1 + ip->da*a2;
+}
 
-		} else if (ia == -1) {
-			*c = (1. - d)*a[na*im] + d*a[na*(im + 1)];
+/*
+ * trova un coefficiente dato l'angolo ed il numero di Mach
+ *
+ * il numero di Mach mach viene cercato nell'array m di lunghezza nm
+ * ed interpolato linearmente; quindi il coefficiente alpha viene cercato
+ * nella prima colonna della matrice a di dimensioni na x nm + 1 ed interpolato
+ * linearmente; infine il coefficiente corrispondente alla combinazione di
+ * mach e alpha viene restituito.
+ */
+static int
+get_coef(int nm, doublereal* m, int na, doublereal* a, doublereal alpha, doublereal mach,
+		doublereal* c, doublereal* c0, int *hint)
+{
+	c81_interp ip, ip0;
 
-		} else {
-			doublereal a1, a2, da;
+	get_interp(nm, m, na, a, alpha, mach, &ip, c0 ? &ip0 : NULL, hint);
 
-			ia++;
-			a1 = (1. - d)*a[na*im + ia - 1] + d*a[na*(im + 1) + ia - 1];
-			a2 = (1. - d)*a[na*im + ia] + d*a[na*(im + 1) + ia];
-			da = (alpha - a[ia - 1])/(a[ia] - a[ia - 1]);
-			*c = (1. - da)*a1 + da*a2;
-		}
+	*c = interp(a, &ip);
+	if (c0 != NULL) {
+		*c0 = interp(a, &ip0);
 	}
 
 	return 0;
 }
 
 static doublereal
-get_dcla(int nm, doublereal* m, doublereal* s, doublereal mach)
+get_dcla(int nm, doublereal* m, doublereal* s, doublereal mach, int *hint)
 {
 	int im;
 	
@@ -778,7 +1022,7 @@ get_dcla(int nm, doublereal* m, doublereal* s, doublereal mach)
 	 * im e' l'indice di m in cui si trova l'approssimazione per eccesso
 	 * di mach
 	 */
-	im = bisec_d(m, mach, 0, nm - 1);
+	im = c81_search(m, mach, nm, hint);
 	
 	if (im == nm - 1) {
 		return s[3*nm - 1];
@@ -175,6 +175,40 @@ extern int
 c81_aerod2_u(const doublereal* W, const vam_t *VAM, doublereal* TNG, outa_t* OUTA, 
 		const c81_data* data, long unsteadyflag);
 
+/*
+ * brackets of a section in the lift, drag and moment tables
+ * (mach, alpha and zero alpha indices) found by the last evaluation;
+ * when the operating point of the section moves little between
+ * evaluations, they avoid the search in the tables.
+ * Initialize with c81_hint_init().
+ */
+typedef struct c81_hint {
+	int lift[3];
+	int drag[3];
+	int moment[3];
+} c81_hint;
+
+extern void
+c81_hint_init(c81_hint *hint);
+
+/* same as c81_aerod2_u(), using and updating the brackets in hint */
+extern int 
+c81_aerod2_u_hint(const doublereal* W, const vam_t *VAM, doublereal* TNG, outa_t* OUTA, 
+		const c81_data* data, long unsteadyflag, c81_hint *hint);
+
+/* a section for c81_aerod2_u_batch() */
+typedef struct c81_point {
+	const doublereal *W;
+	vam_t VAM;
+	doublereal *TNG;
+	outa_t *OUTA;
+	c81_hint *hint;		/* may be NULL */
+} c81_point;
+
+/* evaluates n sections that share the same data */
+extern int
+c81_aerod2_u_batch(int n, c81_point *p, const c81_data* data, long unsteadyflag);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -223,7 +223,7 @@ AirProperties::GetVelocity(const Vec3& X, Vec3& V) const
 	if (pRBK) {
 		// X is the position of the point in the relative frame
 		// Xabs is the position of the point in the absolute frame
-		Vec3 Xabs = pRBK->GetX();
+		Xabs = pRBK->GetX();
 		Xabs += pRBK->GetR()*X;
 
 	} else {
@@ -258,6 +258,41 @@ AirProperties::GetVelocity(const Vec3& X, Vec3& V) const
 	return true;
 }
 
+void
+AirProperties::GetVelocity(unsigned uNumPoints, const Vec3 *pX, Vec3 *pV) const
+{
+	// positions in the absolute frame
+	const Vec3 *pXabs = pX;
+	std::vector<Vec3> Xabs;
+	if (pRBK) {
+		// pX are the positions of the points in the relative frame
+		Xabs.resize(uNumPoints);
+		for (unsigned i = 0; i < uNumPoints; i++) {
+			Xabs[i] = pRBK->GetX() + pRBK->GetR()*pX[i];
+		}
+		pXabs = &Xabs[0];
+	}
+
+	for (unsigned i = 0; i < uNumPoints; i++) {
+		pV[i] = Velocity;
+	}
+
+	// each gust processes all the points at once
+	for (std::vector<const Gust *>::const_iterator i = gust.begin();
+		i != gust.end(); ++i)
+	{
+		(*i)->AddVelocity(uNumPoints, pXabs, pV);
+	}
+
+	if (pRBK) {
+		// see GetVelocity(const Vec3&, Vec3&)
+		for (unsigned i = 0; i < uNumPoints; i++) {
+			pV[i] = pRBK->GetR().MulTV(pV[i]) - pRBK->GetV()
+				- pRBK->GetW().Cross(pX[i]);
+		}
+	}
+}
+
 /* Dati privati */
 unsigned int
 AirProperties::iGetNumPrivData(void) const
@@ -733,6 +768,17 @@ AirPropOwner::fGetAirVelocity(Vec3& Velocity, const Vec3& X) const
 	Velocity = pAirProperties->GetVelocity(X);
 	return 1;
 }
+
+bool
+AirPropOwner::GetAirVelocity(unsigned uNumPoints, const Vec3 *pX, Vec3 *pV) const
+{
+	if (pAirProperties == NULL) {
+		return false;
+	}
+
+	pAirProperties->GetVelocity(uNumPoints, pX, pV);
+	return true;
+}
    
 doublereal
 AirPropOwner::dGetAirDensity(const Vec3& X) const
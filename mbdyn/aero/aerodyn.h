@@ -182,6 +182,10 @@ public:
 	GetAirProps(const Vec3& X, doublereal& rho, doublereal& c,
 			doublereal& p, doublereal& T) const = 0;
 
+	/* airstream velocity at uNumPoints points at once */
+	virtual void
+	GetVelocity(unsigned uNumPoints, const Vec3 *pX, Vec3 *pV) const;
+
 	/* *******PER IL SOLUTORE BLOCK JACOBI-BROYDEN******** */
 	/* Fornisce il tipo e la label dei nodi che sono connessi all'elemento
 	 * utile per l'assemblaggio della matrice di connessione fra i dofs */
@@ -230,6 +234,11 @@ public:
 	virtual bool
 	GetAirProps(const Vec3& X, doublereal& rho, doublereal& c,
 			doublereal& p, doublereal& T) const;
+
+	/* airstream velocity at uNumPoints points at once;
+	 * returns false if no air properties are defined */
+	virtual bool
+	GetAirVelocity(unsigned uNumPoints, const Vec3 *pX, Vec3 *pV) const;
 };
 
 /* AirPropOwner - end */
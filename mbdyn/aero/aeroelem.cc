@@ -172,6 +172,9 @@ Twist(pT),
 TipLoss(pTL),
 GDI(iN),
 OUTA(iNN*iN, outa_Zero),
+APnt(iNN*iN),
+XAir(iNN*iN),
+VAir(iNN*iN),
 bJacobian(bUseJacobian)
 {
 	DEBUGCOUTFNAME("Aerodynamic2DElem::Aerodynamic2DElem");
@@ -419,6 +422,20 @@ Aerodynamic2DElem<iNN>::AfterConvergence(
 	}
 }
 
+template <unsigned iNN>
+std::ostream&
+Aerodynamic2DElem<iNN>::Checkpoint(std::ostream& out) const
+{
+	return aerodata->Checkpoint(out);
+}
+
+template <unsigned iNN>
+std::istream&
+Aerodynamic2DElem<iNN>::Resume(std::istream& in)
+{
+	return aerodata->Resume(in);
+}
+
 /* Dimensioni del workspace */
 /* Workspace dimensions */
 template <unsigned iNN>
@@ -1105,9 +1122,6 @@ AerodynamicBody::AssVec(SubVectorHandler& WorkVec,
 {
 	DEBUGCOUTFNAME("AerodynamicBody::AssVec");
 
-	doublereal dTng[6];
-	doublereal dW[6];
-
 	/* Dati del nodo */
 	/* Node's data */
 	const Vec3& Xn(pNode->GetXCurr());
@@ -1172,21 +1186,49 @@ AerodynamicBody::AssVec(SubVectorHandler& WorkVec,
 		}
 	}
 
-	/* Ciclo sui punti di Gauss */
-	/* Loop over Gauss points */
+	/*
+	 * Velocita' del vento in tutti i punti di Gauss
+	 *
+	 * Airstream speed at all Gauss points
+	 */
 	PntWght PW = GDI.GetFirst();
 	int iPnt = 0;
 	do {
+		XAir[iPnt] = Xn + Rn*(f + Ra3*(dHalfSpan*PW.dGetPnt()));
+		iPnt++;
+	} while (GDI.fGetNext(PW));
+	const bool bAirVelocity = GetAirVelocity(iPnt, &XAir[0], &VAir[0]);
+
+	/*
+	 * Ciclo sui punti di Gauss: cinematica e coefficienti
+	 * (il calcolo dei coefficienti puo' essere differito
+	 * e fatto a blocchi da FlushForces())
+	 *
+	 * Loop over Gauss points: kinematics and coefficients
+	 * (the evaluation of the coefficients may be deferred
+	 * and performed in batches by FlushForces())
+	 */
+	PW = GDI.GetFirst();
+	iPnt = 0;
+	do {
+		AeroPoint& P = APnt[iPnt];
+
 		doublereal dCsi = PW.dGetPnt();
-		Vec3 Xb(Rn*(f + Ra3*(dHalfSpan*dCsi)));
-		Vec3 Xr = Xn + Xb;
-		Vec3 Vr(Vn + Wn.Cross(Xb));
+		P.dCsi = dCsi;
+		P.dWght = dHalfSpan*PW.dGetWght();
+
+		Vec3& Xb(P.Xb);
+		Vec3& Xr(P.Xr);
+		Vec3& Vr(P.Vr);
+		Xb = Rn*(f + Ra3*(dHalfSpan*dCsi));
+		Xr = Xn + Xb;
+		Vr = Vn + Wn.Cross(Xb);
+		P.Wr = Wn;
 
 		/* Contributo di velocita' del vento */
 		/* Airstream speed contribution */
-		Vec3 VTmp(Zero3);
-		if (fGetAirVelocity(VTmp, Xr)) {
-	 		Vr -= VTmp;
+		if (bAirVelocity) {
+	 		Vr -= VAir[iPnt];
 		}
 
 		/*
@@ -1222,7 +1264,7 @@ AerodynamicBody::AssVec(SubVectorHandler& WorkVec,
 		 * reference system to the global one
 		 *
 		 */
-		Mat3x3 RRloc;
+		Mat3x3& RRloc(P.RRloc);
 		if (dTw != 0.) {
 			doublereal dCosT = cos(dTw);
 			doublereal dSinT = sin(dTw);
@@ -1246,52 +1288,59 @@ AerodynamicBody::AssVec(SubVectorHandler& WorkVec,
 		 * the work vector dW
 		 *
 		 */
-		VTmp = RRloc.MulTV(Vr);
-		VTmp.PutTo(dW);
+		P.VTmp = RRloc.MulTV(Vr);
+		P.VTmp.PutTo(P.dW);
 
 		Vec3 WTmp = RRloc.MulTV(Wn);
-		WTmp.PutTo(&dW[3]);
+		WTmp.PutTo(&P.dW[3]);
 
 		/* Funzione di calcolo delle forze aerodinamiche */
 		/* Functions that calculates aerodynamic forces */
 		if (iNumDof) {
 			aerodata->AssRes(WorkVec, dCoef, XCurr, XPrimeCurr,
-                		iFirstEq, iFirstSubEq, iPnt, dW, dTng, OUTA[iPnt]);
+                		iFirstEq, iFirstSubEq, iPnt, P.dW, P.dTng, OUTA[iPnt]);
 
 			// first equation
 			iFirstEq += iNumDof;
 			iFirstSubEq += iNumDof;
 
 		} else {
-			aerodata->GetForces(iPnt, dW, dTng, OUTA[iPnt]);
+			aerodata->QueueForces(iPnt, P.dW, P.dTng, OUTA[iPnt]);
 		}
 
+		iPnt++;
+
+	} while (GDI.fGetNext(PW));
+
+	aerodata->FlushForces();
+
+	/* Ciclo sui punti di Gauss: forze */
+	/* Loop over Gauss points: forces */
+	for (iPnt = 0; iPnt < int(APnt.size()); iPnt++) {
+		AeroPoint& P = APnt[iPnt];
+
 		/* Dimensionalizza le forze */
 		/* Dimensionalize forces */
-		doublereal dWght = dHalfSpan*PW.dGetWght();
-		dTng[1] *= TipLoss.dGet(dCsi);
-		Vec3 FTmp(RRloc*(Vec3(&dTng[0])));
-		Vec3 MTmp(RRloc*(Vec3(&dTng[3])));
+		P.dTng[1] *= TipLoss.dGet(P.dCsi);
+		Vec3 FTmp(P.RRloc*(Vec3(&P.dTng[0])));
+		Vec3 MTmp(P.RRloc*(Vec3(&P.dTng[3])));
 
 		// Se e' definito il rotore, aggiungere il contributo alla trazione
 		// If a rotor is defined, adds the thrust contribution
-		AddSectionalForce_int(iPnt, FTmp, MTmp, dWght, Xr, RRloc, Vr, Wn);
+		AddSectionalForce_int(iPnt, FTmp, MTmp, P.dWght, P.Xr, P.RRloc, P.Vr, P.Wr);
 
 		// specific for Gauss points force output
 		if (bToBeOutput()) {
-			SetData(VTmp, dTng, Xr, RRloc, Vr, Wn, FTmp, MTmp);
+			SetData(P.VTmp, P.dTng, P.Xr, P.RRloc, P.Vr, P.Wr, FTmp, MTmp);
 		}
 
-		FTmp *= dWght;
-		MTmp *= dWght;
+		FTmp *= P.dWght;
+		MTmp *= P.dWght;
 
 		F += FTmp;
 		M += MTmp;
-		M += Xb.Cross(FTmp);
-
-		iPnt++;
-
-	} while (GDI.fGetNext(PW));
+		M += P.Xb.Cross(FTmp);
+	}
 
 	// Se e' definito il rotore, aggiungere il contributo alla trazione
 	// If a rotor is defined, adds the thrust contribution
@@ -2287,12 +2336,30 @@ AerodynamicBeam::AssVec(SubVectorHandler& WorkVec,
 		}
 	}
 
+	/*
+	 * Velocita' del vento in tutti i punti di Gauss
+	 *
+	 * Airstream speed at all Gauss points
+	 */
 	for (int iNode = 0; iNode < LASTNODE; iNode++) {
+		doublereal dsi = pdsi3[iNode];
+		doublereal dsf = pdsf3[iNode];
 
-		/* Resetta le forze */
-		/* Resets forces */
-		F[iNode].Reset();
-		M[iNode].Reset();
+		doublereal dsm = (dsf + dsi)/2.;
+		doublereal dsdCsi = (dsf - dsi)/2.;
+
+		PntWght PW = GDI.GetFirst();
+		do {
+			doublereal ds = dsm + dsdCsi*PW.dGetPnt();
+			XAir[iPnt] = X1Tmp*ShapeFunc3N(ds, 1) + X2Tmp*ShapeFunc3N(ds, 2)
+				+ X3Tmp*ShapeFunc3N(ds, 3);
+			iPnt++;
+		} while (GDI.fGetNext(PW));
+	}
+	const bool bAirVelocity = GetAirVelocity(iPnt, &XAir[0], &VAir[0]);
+
+	iPnt = 0;
+	for (int iNode = 0; iNode < LASTNODE; iNode++) {
 
 		doublereal dsi = pdsi3[iNode];
 		doublereal dsf = pdsf3[iNode];
@@ -2307,6 +2374,8 @@ AerodynamicBeam::AssVec(SubVectorHandler& WorkVec,
 		 */
 		PntWght PW = GDI.GetFirst();
 		do {
+			AeroPoint& P = APnt[iPnt];
+
 			doublereal dCsi = PW.dGetPnt();
 			doublereal ds = dsm + dsdCsi*dCsi;
 			doublereal dXds = DxDcsi3N(ds,
@@ -2316,15 +2385,17 @@ AerodynamicBeam::AssVec(SubVectorHandler& WorkVec,
 			doublereal dN2 = ShapeFunc3N(ds, 2);
 			doublereal dN3 = ShapeFunc3N(ds, 3);
 
-			Vec3 Xr(X1Tmp*dN1 + X2Tmp*dN2 + X3Tmp*dN3);
-			Vec3 Vr(V1Tmp*dN1 + V2Tmp*dN2 + V3Tmp*dN3);
-			Vec3 Wr(Wn1*dN1 + Wn2*dN2 + Wn3*dN3);
+			Vec3& Xr(P.Xr);
+			Vec3& Vr(P.Vr);
+			Vec3& Wr(P.Wr);
+			Xr = X1Tmp*dN1 + X2Tmp*dN2 + X3Tmp*dN3;
+			Vr = V1Tmp*dN1 + V2Tmp*dN2 + V3Tmp*dN3;
+			Wr = Wn1*dN1 + Wn2*dN2 + Wn3*dN3;
 
 			/* Contributo di velocita' del vento */
 			/* Airstream speed contribution */
-			Vec3 VTmp(Zero3);
-			if (fGetAirVelocity(VTmp, Xr)) {
-				Vr -= VTmp;
+			if (bAirVelocity) {
+				Vr -= VAir[iPnt];
 			}
 
 			/*
@@ -2364,7 +2435,8 @@ AerodynamicBeam::AssVec(SubVectorHandler& WorkVec,
 			 * reference system to the global one
 			 *
 			 */
-			Mat3x3 RRloc(RR2*Mat3x3(ER_Rot::MatR, g1*dN1 + g3*dN3));
+			Mat3x3& RRloc(P.RRloc);
+			RRloc = RR2*Mat3x3(ER_Rot::MatR, g1*dN1 + g3*dN3);
 			if (dTw != 0.) {
 				doublereal dCosT = cos(dTw);
 				doublereal dSinT = sin(dTw);
@@ -2393,54 +2465,75 @@ AerodynamicBeam::AssVec(SubVectorHandler& WorkVec,
 			 * the work vector dW
 			 *
 			 */
-			doublereal dW[6];
-			doublereal dTng[6];
-
-			VTmp = RRloc.MulTV(Vr);
-			VTmp.PutTo(&dW[0]);
+			P.VTmp = RRloc.MulTV(Vr);
+			P.VTmp.PutTo(P.dW);
 
 			Vec3 WTmp = RRloc.MulTV(Wr);
-			WTmp.PutTo(&dW[3]);
+			WTmp.PutTo(&P.dW[3]);
 
 			/* Funzione di calcolo delle forze aerodinamiche */
 			/* Functions that calculates aerodynamic forces */
 			if (iNumDof) {
 				aerodata->AssRes(WorkVec, dCoef, XCurr, XPrimeCurr,
-                			iFirstEq, iFirstSubEq, iPnt, dW, dTng, OUTA[iPnt]);
+                			iFirstEq, iFirstSubEq, iPnt, P.dW, P.dTng, OUTA[iPnt]);
 
 				// first equation
 				iFirstEq += iNumDof;
 				iFirstSubEq += iNumDof;
 
 			} else {
-				aerodata->GetForces(iPnt, dW, dTng, OUTA[iPnt]);
+				aerodata->QueueForces(iPnt, P.dW, P.dTng, OUTA[iPnt]);
 			}
 
+			/* Dati per l'assemblaggio delle forze */
+			/* Data for the assembly of the forces */
+			P.dCsi = dCsi;
+			P.dWght = dXds*dsdCsi*PW.dGetWght();
+			P.Xb = Xr - Xn[iNode];
+
+			iPnt++;
+
+		} while (GDI.fGetNext(PW));
+	}
+
+	aerodata->FlushForces();
+
+	/* Ciclo sui punti di Gauss: forze */
+	/* Loop over Gauss points: forces */
+	iPnt = 0;
+	for (int iNode = 0; iNode < LASTNODE; iNode++) {
+
+		/* Resetta le forze */
+		/* Resets forces */
+		F[iNode].Reset();
+		M[iNode].Reset();
+
+		for (integer iCnt = 0; iCnt < GDI.iGetNum(); iCnt++) {
+			AeroPoint& P = APnt[iPnt];
+
 			/* Dimensionalizza le forze */
 			/* Dimensionalizes forces */
-			doublereal dWght = dXds*dsdCsi*PW.dGetWght();
-			dTng[1] *= TipLoss.dGet(dCsi);
-			Vec3 FTmp(RRloc*(Vec3(&dTng[0])));
-			Vec3 MTmp(RRloc*(Vec3(&dTng[3])));
+			P.dTng[1] *= TipLoss.dGet(P.dCsi);
+			Vec3 FTmp(P.RRloc*(Vec3(&P.dTng[0])));
+			Vec3 MTmp(P.RRloc*(Vec3(&P.dTng[3])));
 
 			// Se e' definito il rotore, aggiungere il contributo alla trazione
 			// If a rotor is defined, adds the thrust contribution
-			AddSectionalForce_int(iPnt, FTmp, MTmp, dWght, Xr, RRloc, Vr, Wr);
+			AddSectionalForce_int(iPnt, FTmp, MTmp, P.dWght, P.Xr, P.RRloc, P.Vr, P.Wr);
 
 			// specific for Gauss points force output
 			if (bToBeOutput()) {
-				SetData(VTmp, dTng, Xr, RRloc, Vr, Wr, FTmp, MTmp);
+				SetData(P.VTmp, P.dTng, P.Xr, P.RRloc, P.Vr, P.Wr, FTmp, MTmp);
 			}
 
-			FTmp *= dWght;
-			MTmp *= dWght;
+			FTmp *= P.dWght;
+			MTmp *= P.dWght;
 			F[iNode] += FTmp;
 			M[iNode] += MTmp;
-			M[iNode] += (Xr - Xn[iNode]).Cross(FTmp);
+			M[iNode] += P.Xb.Cross(FTmp);
 
 			iPnt++;
-
-		} while (GDI.fGetNext(PW));
+		}
 
 		// Se e' definito il rotore, aggiungere il contributo alla trazione
 		// If a rotor is defined, adds the thrust contribution
@@ -3202,9 +3295,6 @@ AerodynamicBeam2::AssVec(SubVectorHandler& WorkVec,
 {
 	DEBUGCOUTFNAME("AerodynamicBeam2::AssVec");
 
-	doublereal dTng[6];
-	doublereal dW[6];
-
 	Vec3 Xn[LASTNODE];
 
 	/* Dati dei nodi */
@@ -3290,12 +3380,29 @@ AerodynamicBeam2::AssVec(SubVectorHandler& WorkVec,
 		}
 	}
 
+	/*
+	 * Velocita' del vento in tutti i punti di Gauss
+	 *
+	 * Airstream speed at all Gauss points
+	 */
 	for (int iNode = 0; iNode < LASTNODE; iNode++) {
+		doublereal dsi = pdsi2[iNode];
+		doublereal dsf = pdsf2[iNode];
 
-		/* Resetta i dati */
-		/* Resets forces */
-		F[iNode].Reset();
-		M[iNode].Reset();
+		doublereal dsm = (dsf + dsi)/2.;
+		doublereal dsdCsi = (dsf - dsi)/2.;
+
+		PntWght PW = GDI.GetFirst();
+		do {
+			doublereal ds = dsm + dsdCsi*PW.dGetPnt();
+			XAir[iPnt] = X1Tmp*ShapeFunc2N(ds, 1) + X2Tmp*ShapeFunc2N(ds, 2);
+			iPnt++;
+		} while (GDI.fGetNext(PW));
+	}
+	const bool bAirVelocity = GetAirVelocity(iPnt, &XAir[0], &VAir[0]);
+
+	iPnt = 0;
+	for (int iNode = 0; iNode < LASTNODE; iNode++) {
 
 		doublereal dsi = pdsi2[iNode];
 		doublereal dsf = pdsf2[iNode];
@@ -3307,6 +3414,8 @@ AerodynamicBeam2::AssVec(SubVectorHandler& WorkVec,
 		/* Loop over Gauss points  */
 		PntWght PW = GDI.GetFirst();
 		do {
+			AeroPoint& P = APnt[iPnt];
+
 			doublereal dCsi = PW.dGetPnt();
 			doublereal ds = dsm + dsdCsi*dCsi;
 			doublereal dXds = DxDcsi2N(ds, Xn[NODE1], Xn[NODE2]);
@@ -3314,16 +3423,18 @@ AerodynamicBeam2::AssVec(SubVectorHandler& WorkVec,
 			doublereal dN1 = ShapeFunc2N(ds, 1);
 			doublereal dN2 = ShapeFunc2N(ds, 2);
 
-			Vec3 Xr(X1Tmp*dN1 + X2Tmp*dN2);
-			Vec3 Vr(V1Tmp*dN1 + V2Tmp*dN2);
-			Vec3 Wr(Wn1*dN1 + Wn2*dN2);
+			Vec3& Xr(P.Xr);
+			Vec3& Vr(P.Vr);
+			Vec3& Wr(P.Wr);
+			Xr = X1Tmp*dN1 + X2Tmp*dN2;
+			Vr = V1Tmp*dN1 + V2Tmp*dN2;
+			Wr = Wn1*dN1 + Wn2*dN2;
 			Vec3 thetar(overline_theta*((1. + dN2 - dN1)/2.));
 
 			/* Contributo di velocita' del vento */
 			/* Airstream speed contribution */
-			Vec3 VTmp(Zero3);
-			if (fGetAirVelocity(VTmp, Xr)) {
-				Vr -= VTmp;
+			if (bAirVelocity) {
+				Vr -= VAir[iPnt];
 			}
 
 			/*
@@ -3362,7 +3473,8 @@ AerodynamicBeam2::AssVec(SubVectorHandler& WorkVec,
 			 * reference system to the global one
 			 *
 			 */
-			Mat3x3 RRloc(RR1*Mat3x3(ER_Rot::MatR, thetar));
+			Mat3x3& RRloc(P.RRloc);
+			RRloc = RR1*Mat3x3(ER_Rot::MatR, thetar);
 			if (dTw != 0.) {
 				doublereal dCosT = cos(dTw);
 				doublereal dSinT = sin(dTw);
@@ -3390,51 +3502,75 @@ AerodynamicBeam2::AssVec(SubVectorHandler& WorkVec,
 			 * the work vector dW
 			 *
 			 */
-			VTmp = RRloc.MulTV(Vr);
-			VTmp.PutTo(dW);
+			P.VTmp = RRloc.MulTV(Vr);
+			P.VTmp.PutTo(P.dW);
 
 			Vec3 WTmp = RRloc.MulTV(Wr);
-			WTmp.PutTo(&dW[3]);
+			WTmp.PutTo(&P.dW[3]);
 
 			/* Funzione di calcolo delle forze aerodinamiche */
 			/* Functions that calculates aerodynamic forces */
 			if (iNumDof) {
 				aerodata->AssRes(WorkVec, dCoef, XCurr, XPrimeCurr,
-                			iFirstEq, iFirstSubEq, iPnt, dW, dTng, OUTA[iPnt]);
+                			iFirstEq, iFirstSubEq, iPnt, P.dW, P.dTng, OUTA[iPnt]);
 
 				// first equation
 				iFirstEq += iNumDof;
 				iFirstSubEq += iNumDof;
 
 			} else {
-				aerodata->GetForces(iPnt, dW, dTng, OUTA[iPnt]);
+				aerodata->QueueForces(iPnt, P.dW, P.dTng, OUTA[iPnt]);
 			}
 
+			/* Dati per l'assemblaggio delle forze */
+			/* Data for the assembly of the forces */
+			P.dCsi = dCsi;
+			P.dWght = dXds*dsdCsi*PW.dGetWght();
+			P.Xb = Xr - Xn[iNode];
+
+			iPnt++;
+
+		} while (GDI.fGetNext(PW));
+	}
+
+	aerodata->FlushForces();
+
+	/* Ciclo sui punti di Gauss: forze */
+	/* Loop over Gauss points: forces */
+	iPnt = 0;
+	for (int iNode = 0; iNode < LASTNODE; iNode++) {
+
+		/* Resetta le forze */
+		/* Resets forces */
+		F[iNode].Reset();
+		M[iNode].Reset();
+
+		for (integer iCnt = 0; iCnt < GDI.iGetNum(); iCnt++) {
+			AeroPoint& P = APnt[iPnt];
+
 			/* Dimensionalizza le forze */
 			/* Dimensionalizes forces */
-			doublereal dWght = dXds*dsdCsi*PW.dGetWght();
-			dTng[1] *= TipLoss.dGet(dCsi);
-			Vec3 FTmp(RRloc*(Vec3(&dTng[0])));
-			Vec3 MTmp(RRloc*(Vec3(&dTng[3])));
+			P.dTng[1] *= TipLoss.dGet(P.dCsi);
+			Vec3 FTmp(P.RRloc*(Vec3(&P.dTng[0])));
+			Vec3 MTmp(P.RRloc*(Vec3(&P.dTng[3])));
 
 			// Se e' definito il rotore, aggiungere il contributo alla trazione
 			// If a rotor is defined, adds the thrust contribution
-			AddSectionalForce_int(iPnt, FTmp, MTmp, dWght, Xr, RRloc, Vr, Wr);
+			AddSectionalForce_int(iPnt, FTmp, MTmp, P.dWght, P.Xr, P.RRloc, P.Vr, P.Wr);
 
 			// specific for Gauss points force output
 			if (bToBeOutput()) {
-				SetData(VTmp, dTng, Xr, RRloc, Vr, Wr, FTmp, MTmp);
+				SetData(P.VTmp, P.dTng, P.Xr, P.RRloc, P.Vr, P.Wr, FTmp, MTmp);
 			}
 
-			FTmp *= dWght;
-			MTmp *= dWght;
+			FTmp *= P.dWght;
+			MTmp *= P.dWght;
 			F[iNode] += FTmp;
 			M[iNode] += MTmp;
-			M[iNode] += (Xr - Xn[iNode]).Cross(FTmp);
+			M[iNode] += P.Xb.Cross(FTmp);
 
 			iPnt++;
-
-		} while (GDI.fGetNext(PW));
+		}
 
 		// Se e' definito il rotore, aggiungere il contributo alla trazione
 		// If a rotor is defined, adds the thrust contribution
@@ -176,6 +176,37 @@ protected:
 	GaussDataIterator GDI;	/* Iteratore sui punti di Gauss / iterator over Gauss points*/
 	std::vector<outa_t> OUTA;
 
+	/*
+	 * Dati dei punti di Gauss, conservati tra il calcolo (eventualmente
+	 * a blocchi) dei coefficienti e l'assemblaggio delle forze
+	 *
+	 * Gauss point data, kept between the (possibly batched) evaluation
+	 * of the coefficients and the assembly of the forces
+	 */
+	struct AeroPoint {
+		doublereal dCsi;	/* ascissa / abscissa */
+		doublereal dWght;	/* peso / integration weight */
+		Vec3 Xr;		/* posizione / position */
+		Vec3 Xb;		/* braccio dal nodo / arm from the node */
+		Vec3 Vr;		/* velocita' relativa / relative velocity */
+		Vec3 Wr;		/* velocita' angolare / angular velocity */
+		Vec3 VTmp;		/* velocita' nel sistema aerodinamico / velocity in the aerodynamic frame */
+		Mat3x3 RRloc;		/* orientazione / aerodynamic frame orientation */
+		doublereal dW[6];
+		doublereal dTng[6];
+	};
+	std::vector<AeroPoint> APnt;
+
+	/*
+	 * Posizione dei punti di Gauss e velocita' del vento,
+	 * calcolata per tutti i punti con una sola chiamata
+	 *
+	 * Gauss point position and airstream speed,
+	 * evaluated for all the points with a single call
+	 */
+	std::vector<Vec3> XAir;
+	std::vector<Vec3> VAir;
+
 	// used for Jacobian with internal states
 	Mat3xN vx, wx, fq, cq;
 
@@ -242,6 +273,9 @@ public:
 	virtual void AfterConvergence(const VectorHandler& X,
 			const VectorHandler& XP);
 
+	virtual std::ostream& Checkpoint(std::ostream& out) const;
+	virtual std::istream& Resume(std::istream& in);
+
 	/* Dimensioni del workspace */
 	/* Workspace dimensions */
 	virtual void
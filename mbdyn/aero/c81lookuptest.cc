@@ -0,0 +1,629 @@
+/* $Header$ */
+/*
+ * MBDyn (C) is a multibody analysis code.
+ * http://www.mbdyn.org
+ *
+ * Copyright (C) 1996-2023
+ *
+ * Pierangelo Masarati	<pierangelo.masarati@polimi.it>
+ * Paolo Mantegazza	<paolo.mantegazza@polimi.it>
+ *
+ * Dipartimento di Ingegneria Aerospaziale - Politecnico di Milano
+ * via La Masa, 34 - 20156 Milano, Italy
+ * http://www.aero.polimi.it
+ *
+ * Changing this copyright notice is forbidden.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation (version 2 of the License).
+ *
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Compares the c81 table lookup with a copy of the original one
+ * (bisection search and explicit interpolation for each case),
+ * which is the reference, on a synthetic airfoil swept around the circle
+ * across and out of its mach range; the hinted and the batched
+ * evaluations are compared with the plain one.
+ * Results must be identical bit by bit.
+ *
+ * usage: c81lookuptest [-v] [-n <steps>] [-s <sections>]
+ */
+
+#include "mbconfig.h"           /* This goes first in every *.c,*.cc file */
+
+#include <cstring>
+#include <cmath>
+#include <stdlib.h>
+#include <unistd.h>
+#include "ac/getopt.h"
+
+#include <iostream>
+#include <vector>
+
+#include "ac/f2c.h"
+#include "bisec.h"
+#include "aerodc81.h"
+#include "c81data.h"
+
+static bool verbose = false;
+
+/* reference - begin */
+
+/* c81 lookup before brackets were cached (aerodc81.c) */
+static int
+ref_get_coef(int nm, doublereal* m, int na, doublereal* a, doublereal alpha, doublereal mach,
+		doublereal* c, doublereal* c0)
+{
+   	int im;
+   	int ia, ia0 = -1;
+
+	while (alpha < -180.) {
+		alpha += 360.;
+	}
+
+	while (alpha >= 180.) {
+		alpha -= 360.;
+	}
+
+	mach = fabs(mach);
+
+	im = bisec_d(m, mach, 0, nm - 1);
+
+	if (c0 != NULL) {
+		ia0 = bisec_d(a, 0., 0, na - 1);
+	}
+
+	ia = bisec_d(a, alpha, 0, na - 1);
+
+	if (im == nm - 1) {
+		if (c0 != NULL) {
+			if (ia0 == na - 1) {
+				*c0 = a[na*(nm + 1) - 1];
+
+			} else if (ia0 == -1) {
+				*c0 = a[na*nm];
+
+			} else {
+				doublereal da;
+
+				ia0++;
+				da = -a[ia0 - 1]/(a[ia0] - a[ia0 - 1]);
+				*c0 = (1. - da)*a[na*nm + ia0 - 1] + da*a[na*nm + ia0];
+			}
+		}
+
+		if (ia == na - 1) {
+			*c = a[na*(nm + 1) - 1];
+
+		} else if (ia == -1) {
+			*c = a[na*nm];
+
+		} else {
+			doublereal da;
+
+			ia++;
+			da = (alpha - a[ia - 1])/(a[ia] - a[ia - 1]);
+			*c = (1. - da)*a[na*nm + ia - 1] + da*a[na*nm + ia];
+		}
+
+	} else if (im == -1) {
+		if (c0 != NULL) {
+			if (ia0 == na - 1) {
+				*c0 = a[na*2 - 1];
+
+			} else if (ia0 == -1) {
+				*c0 = a[na];
+
+			} else {
+				doublereal da;
+
+				ia0++;
+				da = -a[ia0 - 1]/(a[ia0] - a[ia0 - 1]);
+				*c0 = (1. - da)*a[na + ia0 - 1] + da*a[na + ia0];
+			}
+		}
+
+		if (ia == na - 1) {
+			*c = a[na*2 - 1];
+
+		} else if (ia == -1) {
+			*c = a[na];
+
+		} else {
+			doublereal da;
+
+			ia++;
+			da = (alpha - a[ia - 1])/(a[ia] - a[ia - 1]);
+			*c = (1. - da)*a[na + ia - 1] + da*a[na + ia];
+		}
+
+	} else {
+		doublereal d;
+
+		im++;
+		d = (mach - m[im - 1])/(m[im] - m[im - 1]);
+
+		if (c0 != NULL) {
+			if (ia0 == na) {
+				*c0 = (1. - d)*a[na*(im + 1) - 1] + d*a[na*(im + 2) - 1];
+			} else {
+				doublereal a1, a2, da;
+				a1 = (1. - d)*a[na*im + ia0 - 1] + d*a[na*(im + 1) + ia0 - 1];
+				a2 = (1. - d)*a[na*im + ia0] + d*a[na*(im + 1) + ia0];
+				da = -a[ia0 - 1]/(a[ia0] - a[ia0 - 1]);
+				*c0 = (1. - da)*a1 + da*a2;
+			}
+		}
+
+		if (ia == na - 1) {
+			*c = (1. - d)*a[na*(im + 1) - 1] + d*a[na*(im + 2) - 1];
+
+		} else if (ia == -1) {
+			*c = (1. - d)*a[na*im] + d*a[na*(im + 1)];
+
+		} else {
+			doublereal a1, a2, da;
+
+			ia++;
+			a1 = (1. - d)*a[na*im + ia - 1] + d*a[na*(im + 1) + ia - 1];
+			a2 = (1. - d)*a[na*im + ia] + d*a[na*(im + 1) + ia];
+			da = (alpha - a[ia - 1])/(a[ia] - a[ia - 1]);
+			*c = (1. - da)*a1 + da*a2;
+		}
+	}
+
+	return 0;
+}
+
+static doublereal
+ref_get_dcla(int nm, doublereal* m, doublereal* s, doublereal mach)
+{
+	int im;
+
+	mach = fabs(mach);
+
+	im = bisec_d(m, mach, 0, nm - 1);
+
+	if (im == nm - 1) {
+		return s[3*nm - 1];
+
+	} else if (im == -1) {
+		return s[2*nm];
+
+	} else {
+		doublereal d;
+
+		im++;
+		d = (mach - m[im - 1])/(m[im] - m[im - 1]);
+
+		return (1. - d)*s[2*nm + im - 1] + d*s[2*nm + im];
+	}
+}
+
+/* steady c81_aerod2_u() before brackets were cached (aerodc81.c) */
+static int
+ref_aerod2_u(const doublereal* W, const vam_t *VAM, doublereal* TNG, outa_t* OUTA,
+		const c81_data* data)
+{
+   	doublereal v[3];
+   	doublereal vp, vp2, vtot;
+	doublereal rho = VAM->density;
+	doublereal cs = VAM->sound_celerity;
+	doublereal chord = VAM->chord;
+
+	doublereal cl = 0., cl0 = 0., cd = 0., cd0 = 0., cm = 0.;
+	doublereal alpha, gamma, cosgam, mach, q;
+	doublereal dcla = 0.;
+
+	doublereal ca = VAM->force_position;
+	doublereal c34 = VAM->bc_position;
+
+	const doublereal RAD2DEG = 180.*M_1_PI;
+	const doublereal M_PI_3 = M_PI/3.;
+
+	enum { V_X = 0, V_Y = 1, V_Z = 2, W_X = 3, W_Y = 4, W_Z = 5 };
+
+	v[V_X] = W[V_X];
+	v[V_Y] = W[V_Y] + c34*W[W_Z];
+	v[V_Z] = W[V_Z] - c34*W[W_Y];
+
+	vp2 = v[V_X]*v[V_X] + v[V_Y]*v[V_Y];
+	vp = sqrt(vp2);
+
+	vtot = sqrt(vp2 + v[V_Z]*v[V_Z]);
+
+	if (vp/cs < 1.e-6) {
+		TNG[V_X] = 0.;
+		TNG[V_Y] = 0.;
+		TNG[V_Z] = 0.;
+		TNG[W_X] = 0.;
+		TNG[W_Y] = 0.;
+		TNG[W_Z] = 0.;
+
+		OUTA->alpha = 0.;
+		OUTA->gamma = 0.;
+		OUTA->mach = 0.;
+		OUTA->cl = 0.;
+		OUTA->cd = 0.;
+		OUTA->cm = 0.;
+		OUTA->clalpha = 0.;
+
+		return 0;
+	}
+
+	alpha = atan2(-v[V_Y], v[V_X]);
+	OUTA->alpha = alpha*RAD2DEG;
+	gamma = atan2(-v[V_Z], fabs(v[V_X]));
+	OUTA->gamma = gamma*RAD2DEG;
+
+	if (fabs(gamma) > M_PI_3) {
+		gamma = M_PI_3;
+	}
+
+	cosgam = cos(gamma);
+	mach = (vtot*sqrt(cosgam))/cs;
+	OUTA->mach = mach;
+
+	if (mach > .99) {
+		mach = .99;
+	}
+
+	ref_get_coef(data->NML, data->ml, data->NAL, data->al,
+			OUTA->alpha, mach, &cl, &cl0);
+	ref_get_coef(data->NMD, data->md, data->NAD, data->ad,
+			OUTA->alpha, mach, &cd, &cd0);
+	ref_get_coef(data->NMM, data->mm, data->NAM, data->am,
+			OUTA->alpha, mach, &cm, NULL);
+
+	dcla = ref_get_dcla(data->NML, data->ml, data->stall, mach);
+
+	dcla *= RAD2DEG;
+	if (fabs(alpha) > 1.e-6) {
+		doublereal dclatmp = (cl - cl0)/(alpha*cosgam);
+		if (dclatmp < dcla) {
+			dcla = dclatmp;
+			cl = cl0 + dcla*alpha;
+		}
+	}
+
+	OUTA->cl = cl;
+	OUTA->cd = cd;
+	OUTA->cm = cm;
+	OUTA->clalpha = dcla;
+
+	q = .5*rho*chord*vp2;
+
+	TNG[V_X] = -q*(cl*v[V_Y] + cd*v[V_X])/vp;
+	TNG[V_Y] = q*(cl*v[V_X] - cd*v[V_Y])/vp;
+	TNG[V_Z] = -q*cd0*v[V_Z]/vp;
+	TNG[W_X] = 0.;
+	TNG[W_Y] = -ca*TNG[V_Z];
+	TNG[W_Z] = q*chord*cm + ca*TNG[V_Y];
+
+	return 0;
+}
+
+/* reference - end */
+
+/*
+ * synthetic airfoil: alpha from -180 to 180 deg, finer around zero,
+ * zero lift at a small negative incidence (not a table entry);
+ * mach from .2 to .8, so that sections go out of range on both sides
+ */
+static void
+make_table(int nm, int na, doublereal *&m, doublereal *&a, int type)
+{
+	m = new doublereal[nm];
+	a = new doublereal[na*(nm + 1)];
+
+	for (int j = 0; j < nm; j++) {
+		m[j] = .2 + .6*j/(nm - 1);
+	}
+
+	for (int i = 0; i < na; i++) {
+		/* -1 .. 1, cubic: denser around zero */
+		doublereal x = -1. + 2.*i/(na - 1);
+		a[i] = 180.*(.3*x + .7*x*x*x);
+		if (i > 0 && i < na - 1) {
+			a[i] += .01;
+		}
+	}
+
+	for (int j = 0; j < nm; j++) {
+		doublereal beta = sqrt(1. - m[j]*m[j]);
+		for (int i = 0; i < na; i++) {
+			doublereal r = (a[i] + 1.25)*M_PI/180.;
+			doublereal c;
+
+			switch (type) {
+			case 0:
+				/* lift: linear, then flat plate */
+				if (fabs(r) < .25) {
+					c = 2.*M_PI*r/beta;
+				} else {
+					c = (2.*M_PI*.25/beta)*sin(2.*r)/sin(.5);
+				}
+				break;
+
+			case 1:
+				/* drag */
+				c = .008 + .01*m[j] + 1.8*sin(r)*sin(r);
+				break;
+
+			default:
+				/* moment */
+				c = -.02 - .1*sin(r)*fabs(sin(r)) + .003*j;
+				break;
+			}
+
+			a[na*(j + 1) + i] = c;
+		}
+	}
+}
+
+static void
+make_data(c81_data *data)
+{
+	memset(data, 0, sizeof(c81_data));
+	strcpy(data->header, "c81lookuptest");
+
+	data->NML = 7;
+	data->NAL = 61;
+	make_table(data->NML, data->NAL, data->ml, data->al, 0);
+
+	data->NMD = 5;
+	data->NAD = 37;
+	make_table(data->NMD, data->NAD, data->md, data->ad, 1);
+
+	data->NMM = 4;
+	data->NAM = 45;
+	make_table(data->NMM, data->NAM, data->mm, data->am, 2);
+
+	c81_data_do_stall(data, 1e-2);
+}
+
+/* velocity of section s at step k: slowly sweeps alpha and mach */
+static void
+make_w(int s, int k, int n, doublereal *W, doublereal cs)
+{
+	doublereal t = doublereal(k)/n;
+	doublereal psi = 2.*M_PI*(3.*t + .37*s);
+	doublereal alpha = (.15 + .1*s)*sin(psi) + 2.*M_PI*t*(s%3);
+	doublereal V = cs*(.5 + .45*sin(M_PI*(t + .11*s)));
+
+	/* every so often jump, to exercise the search */
+	if (k%97 == 13) {
+		alpha += 2.5;
+		V *= .1;
+	}
+
+	W[0] = V*cos(alpha);
+	W[1] = -V*sin(alpha);
+	W[2] = .05*V*sin(3.*psi);
+	W[3] = 0.;
+	W[4] = .3*cos(psi);
+	W[5] = -.7*sin(psi);
+
+	/* exactly on the table, at times */
+	if (k%53 == 0) {
+		W[2] = 0.;
+		W[4] = 0.;
+		W[5] = 0.;
+	}
+}
+
+static int
+compare(const char *what, int s, int k, const doublereal *TNG, const outa_t *OUTA,
+	const doublereal *TNGref, const outa_t *OUTAref)
+{
+	if (memcmp(TNG, TNGref, 6*sizeof(doublereal)) != 0
+		|| memcmp(&OUTA->alpha, &OUTAref->alpha, sizeof(doublereal)) != 0
+		|| memcmp(&OUTA->mach, &OUTAref->mach, sizeof(doublereal)) != 0
+		|| memcmp(&OUTA->cl, &OUTAref->cl, sizeof(doublereal)) != 0
+		|| memcmp(&OUTA->cd, &OUTAref->cd, sizeof(doublereal)) != 0
+		|| memcmp(&OUTA->cm, &OUTAref->cm, sizeof(doublereal)) != 0
+		|| memcmp(&OUTA->clalpha, &OUTAref->clalpha, sizeof(doublereal)) != 0)
+	{
+		std::cerr.precision(17);
+		std::cerr << what << ": section " << s << " step " << k
+			<< " alpha=" << OUTAref->alpha << " mach=" << OUTAref->mach
+			<< " cl=" << OUTA->cl << " (" << OUTAref->cl << ")"
+			<< " cd=" << OUTA->cd << " (" << OUTAref->cd << ")"
+			<< " cm=" << OUTA->cm << " (" << OUTAref->cm << ")"
+			<< std::endl;
+		return 1;
+	}
+
+	return 0;
+}
+
+/* c81_data_get_coef() on a grid, including the table entries */
+static int
+check_coef(int nm, doublereal *m, int na, doublereal *a, const char *what)
+{
+	int iFail = 0, iCount = 0;
+
+	std::vector<doublereal> alphas, machs;
+	for (int i = 0; i < na; i++) {
+		alphas.push_back(a[i]);
+		if (i < na - 1) {
+			alphas.push_back((a[i] + a[i + 1])/2.);
+		}
+	}
+	alphas.push_back(0.);
+	alphas.push_back(-200.);
+	alphas.push_back(200.);
+	alphas.push_back(540.);
+
+	machs.push_back(0.);
+	machs.push_back(-.5);
+	machs.push_back(.95);
+	for (int j = 0; j < nm; j++) {
+		machs.push_back(m[j]);
+		if (j < nm - 1) {
+			machs.push_back(.3*m[j] + .7*m[j + 1]);
+		}
+	}
+
+	for (unsigned j = 0; j < machs.size(); j++) {
+		for (unsigned i = 0; i < alphas.size(); i++) {
+			doublereal c = c81_data_get_coef(nm, m, na, a, alphas[i], machs[j]);
+			doublereal cref;
+			ref_get_coef(nm, m, na, a, alphas[i], machs[j], &cref, NULL);
+
+			iCount++;
+			if (memcmp(&c, &cref, sizeof(doublereal)) != 0) {
+				std::cerr.precision(17);
+				std::cerr << what << ": alpha=" << alphas[i] << " mach=" << machs[j]
+					<< " c=" << c << " (" << cref << ")" << std::endl;
+				iFail++;
+			}
+		}
+	}
+
+	if (verbose || iFail) {
+		std::cout << what << ": " << iCount << " points, " << iFail << " failures" << std::endl;
+	}
+
+	return iFail;
+}
+
+static void
+usage(int rc)
+{
+	std::cerr << "usage: c81lookuptest [-v] [-n <steps>] [-s <sections>]" << std::endl;
+	exit(rc);
+}
+
+int
+main(int argc, char *argv[])
+{
+	int n = 2000;
+	int ns = 37;
+
+	while (1) {
+		int opt = getopt(argc, argv, "hn:s:v");
+
+		if (opt == EOF) {
+			break;
+		}
+
+		switch (opt) {
+		case 'n':
+			n = atoi(optarg);
+			if (n <= 0) {
+				usage(EXIT_FAILURE);
+			}
+			break;
+
+		case 's':
+			ns = atoi(optarg);
+			if (ns <= 0) {
+				usage(EXIT_FAILURE);
+			}
+			break;
+
+		case 'v':
+			verbose = true;
+			break;
+
+		case 'h':
+			usage(EXIT_SUCCESS);
+
+		default:
+			usage(EXIT_FAILURE);
+		}
+	}
+
+	c81_data data;
+	make_data(&data);
+
+	int iFail = 0;
+
+	iFail += check_coef(data.NML, data.ml, data.NAL, data.al, "lift");
+	iFail += check_coef(data.NMD, data.md, data.NAD, data.ad, "drag");
+	iFail += check_coef(data.NMM, data.mm, data.NAM, data.am, "moment");
+
+	vam_t VAM;
+	VAM.density = 1.225;
+	VAM.sound_celerity = 340.;
+	VAM.chord = .5;
+	VAM.force_position = .125;
+	VAM.bc_position = .25;
+	VAM.twist = 0.;
+
+	std::vector<doublereal> W(6*ns), TNGref(6*ns), TNG(6*ns), TNGh(6*ns), TNGb(6*ns);
+	std::vector<outa_t> OUTAref(ns), OUTA(ns), OUTAh(ns), OUTAb(ns);
+	std::vector<c81_hint> hint(ns), hintb(ns);
+	std::vector<c81_point> p(ns);
+
+	for (int s = 0; s < ns; s++) {
+		c81_hint_init(&hint[s]);
+		c81_hint_init(&hintb[s]);
+		OUTAref[s] = outa_Zero;
+		OUTA[s] = outa_Zero;
+		OUTAh[s] = outa_Zero;
+		OUTAb[s] = outa_Zero;
+
+		p[s].W = &W[6*s];
+		p[s].VAM = VAM;
+		p[s].TNG = &TNGb[6*s];
+		p[s].OUTA = &OUTAb[s];
+		/* half of the sections without hint */
+		p[s].hint = (s%2) ? &hintb[s] : NULL;
+	}
+
+	static const long flags[] = { 0, 2 };
+	for (unsigned f = 0; f < sizeof(flags)/sizeof(flags[0]); f++) {
+		long unsteadyflag = flags[f];
+		int iFlagFail = 0;
+
+		for (int k = 0; k <= n; k++) {
+			for (int s = 0; s < ns; s++) {
+				make_w(s, k, n, &W[6*s], VAM.sound_celerity);
+
+				if (unsteadyflag == 0) {
+					ref_aerod2_u(&W[6*s], &VAM, &TNGref[6*s], &OUTAref[s], &data);
+				}
+
+				c81_aerod2_u(&W[6*s], &VAM, &TNG[6*s], &OUTA[s], &data, unsteadyflag);
+				c81_aerod2_u_hint(&W[6*s], &VAM, &TNGh[6*s], &OUTAh[s], &data, unsteadyflag, &hint[s]);
+			}
+
+			c81_aerod2_u_batch(ns, &p[0], &data, unsteadyflag);
+
+			for (int s = 0; s < ns; s++) {
+				if (unsteadyflag == 0) {
+					iFlagFail += compare("reference", s, k, &TNG[6*s], &OUTA[s], &TNGref[6*s], &OUTAref[s]);
+				}
+				iFlagFail += compare("hint", s, k, &TNGh[6*s], &OUTAh[s], &TNG[6*s], &OUTA[s]);
+				iFlagFail += compare("batch", s, k, &TNGb[6*s], &OUTAb[s], &TNG[6*s], &OUTA[s]);
+			}
+		}
+
+		if (verbose || iFlagFail) {
+			std::cout << "unsteady flag " << unsteadyflag << ": "
+				<< ns << " sections, " << n + 1 << " steps, "
+				<< iFlagFail << " failures" << std::endl;
+		}
+
+		iFail += iFlagFail;
+	}
+
+	c81_data_destroy(&data);
+
+	std::cout << iFail << " failures" << std::endl;
+
+	return iFail ? EXIT_FAILURE : EXIT_SUCCESS;
+}
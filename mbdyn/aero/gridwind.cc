@@ -0,0 +1,505 @@
+/* $Header$ */
+/*
+ * MBDyn (C) is a multibody analysis code.
+ * http://www.mbdyn.org
+ *
+ * Copyright (C) 1996-2023
+ *
+ * Pierangelo Masarati	<pierangelo.masarati@polimi.it>
+ * Paolo Mantegazza	<paolo.mantegazza@polimi.it>
+ *
+ * Dipartimento di Ingegneria Aerospaziale - Politecnico di Milano
+ * via La Masa, 34 - 20156 Milano, Italy
+ * http://www.aero.polimi.it
+ *
+ * Changing this copyright notice is forbidden.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation (version 2 of the License).
+ *
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* gridded (turbulent) wind field */
+
+#include "mbconfig.h"           /* This goes first in every *.c,*.cc file */
+
+#include <cerrno>
+#include <cstring>
+#include <climits>
+#include <limits>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif /* HAVE_SYS_MMAN_H */
+
+#include "dataman.h"
+#include "mbpar.h"
+#include "drive_.h"
+
+#include "gridwind.h"
+
+/* number of slabs prefetched ahead of the current one */
+static const integer GRIDWIND_PREFETCH = 4;
+
+/* GriddedWindProfile - begin */
+
+static bool
+ReadAll(int fd, char *p, size_t n)
+{
+	while (n > 0) {
+		ssize_t rc = ::read(fd, p, n);
+		if (rc <= 0) {
+			if (rc == -1 && errno == EINTR) {
+				continue;
+			}
+			return false;
+		}
+		p += rc;
+		n -= rc;
+	}
+
+	return true;
+}
+
+/* index of the grid points that bracket d, and weight of the second one;
+ * points outside the grid take the value of the closest edge */
+static inline void
+Locate(doublereal d, doublereal d0, doublereal dd, integer n,
+	integer& i0, integer& i1, doublereal& w)
+{
+	doublereal s = (d - d0)/dd;
+
+	if (n == 1 || s <= 0.) {
+		i0 = i1 = 0;
+		w = 0.;
+
+	} else if (s >= n - 1) {
+		i0 = i1 = n - 1;
+		w = 0.;
+
+	} else {
+		i0 = integer(s);
+		i1 = i0 + 1;
+		w = s - i0;
+	}
+}
+
+GriddedWindProfile::GriddedWindProfile(
+	const Vec3& X0,
+	const Mat3x3& R0,
+	const std::string& sFileName,
+	const DriveCaller *pTime,
+	const doublereal dConvVel,
+	const doublereal dScale)
+: WindProfile(X0, R0),
+sFileName(sFileName),
+Time(pTime),
+dConvVel(dConvVel),
+dScale(dScale),
+pMap(0), uMapSize(0), pData(0),
+iResident(0),
+dMinSlabTime(-std::numeric_limits<doublereal>::max()),
+iMinSlab(-1)
+{
+	int fd = ::open(sFileName.c_str(), O_RDONLY);
+	if (fd == -1) {
+		int save_errno = errno;
+		silent_cerr("GriddedWindProfile: unable to open file \"" << sFileName << "\" "
+			"(" << save_errno << ": " << strerror(save_errno) << ")"
+			<< std::endl);
+		throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) == -1 || !ReadAll(fd, (char *)&Hdr, sizeof(Hdr))) {
+		(void)::close(fd);
+		silent_cerr("GriddedWindProfile: unable to read the header "
+			"of file \"" << sFileName << "\"" << std::endl);
+		throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+	}
+
+	const char *sErr = 0;
+	if (memcmp(Hdr.magic, GRIDWIND_MAGIC, sizeof(Hdr.magic)) != 0) {
+		sErr = "invalid signature";
+
+	} else if (Hdr.uByteOrder != GRIDWIND_BYTE_ORDER) {
+		sErr = "byte order does not match this machine's";
+
+	} else if (Hdr.uVersion == 0 || Hdr.uVersion > GRIDWIND_VERSION) {
+		sErr = "unsupported version";
+
+	} else if (Hdr.uNumY == 0 || Hdr.uNumZ == 0 || Hdr.uNumT == 0
+		|| uint64_t(Hdr.uNumY)*Hdr.uNumZ > INT_MAX/3
+		|| Hdr.uNumT > INT_MAX)
+	{
+		sErr = "invalid grid size";
+
+	} else if (!(Hdr.dDY > 0.) || !(Hdr.dDZ > 0.) || !(Hdr.dDT > 0.)) {
+		sErr = "invalid grid spacing";
+
+	} else if (Hdr.uDataOffset < sizeof(Hdr)
+		|| uint64_t(st.st_size) < Hdr.uDataOffset
+		|| (uint64_t(st.st_size) - Hdr.uDataOffset)/(3*sizeof(float))/Hdr.uNumY/Hdr.uNumZ < Hdr.uNumT)
+	{
+		sErr = "truncated file";
+	}
+
+	if (sErr != 0) {
+		(void)::close(fd);
+		silent_cerr("GriddedWindProfile: file \"" << sFileName << "\": "
+			<< sErr << std::endl);
+		throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+	}
+
+	const size_t uNumValues = 3*size_t(Hdr.uNumY)*Hdr.uNumZ*Hdr.uNumT;
+
+#ifdef HAVE_SYS_MMAN_H
+	uMapSize = Hdr.uDataOffset + uNumValues*sizeof(float);
+	void *p = mmap(0, uMapSize, PROT_READ, MAP_SHARED, fd, 0);
+	if (p != MAP_FAILED) {
+		pMap = (const char *)p;
+		pData = (const float *)(pMap + Hdr.uDataOffset);
+
+	} else {
+		uMapSize = 0;
+	}
+#endif /* HAVE_SYS_MMAN_H */
+
+	if (pMap == 0) {
+		/* no mmap(2): read the whole file */
+		Buf.resize(uNumValues);
+		if (lseek(fd, Hdr.uDataOffset, SEEK_SET) == (off_t)-1
+			|| !ReadAll(fd, (char *)&Buf[0], uNumValues*sizeof(float)))
+		{
+			(void)::close(fd);
+			silent_cerr("GriddedWindProfile: unable to read file "
+				"\"" << sFileName << "\"" << std::endl);
+			throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+		}
+		pData = &Buf[0];
+	}
+
+	(void)::close(fd);
+
+#ifdef USE_MULTITHREAD
+	pthread_mutex_init(&mutex, NULL);
+#endif /* USE_MULTITHREAD */
+}
+
+GriddedWindProfile::~GriddedWindProfile(void)
+{
+#ifdef USE_MULTITHREAD
+	pthread_mutex_destroy(&mutex);
+#endif /* USE_MULTITHREAD */
+
+#ifdef HAVE_SYS_MMAN_H
+	if (pMap != 0) {
+		(void)munmap((void *)pMap, uMapSize);
+	}
+#endif /* HAVE_SYS_MMAN_H */
+}
+
+const float *
+GriddedWindProfile::pGetSlab(integer iSlab) const
+{
+	return pData + 3*size_t(Hdr.uNumY)*Hdr.uNumZ*iSlab;
+}
+
+void
+GriddedWindProfile::Advise(integer iBegin, integer iEnd, int iAdvice) const
+{
+#ifdef HAVE_SYS_MMAN_H
+	const size_t uPageSize = sysconf(_SC_PAGESIZE);
+
+	size_t uBegin = (const char *)pGetSlab(iBegin) - pMap;
+	size_t uEnd = (const char *)pGetSlab(iEnd) - pMap;
+
+	uBegin -= uBegin % uPageSize;
+	uEnd = std::min<size_t>(((uEnd + uPageSize - 1)/uPageSize)*uPageSize, uMapSize);
+
+	(void)madvise((void *)(pMap + uBegin), uEnd - uBegin, iAdvice);
+#endif /* HAVE_SYS_MMAN_H */
+}
+
+void
+GriddedWindProfile::Advance(integer iSlab) const
+{
+	/* keep the previous slab, release the older ones */
+	integer iNewResident = std::max(iSlab - 1, integer(0));
+
+	if (iNewResident == iResident) {
+		return;
+	}
+
+#if defined(HAVE_SYS_MMAN_H) && defined(MADV_DONTNEED) && defined(MADV_WILLNEED)
+	if (pMap != 0) {
+		if (iNewResident > iResident) {
+			Advise(iResident, iNewResident, MADV_DONTNEED);
+		}
+
+		Advise(iSlab, std::min(iSlab + GRIDWIND_PREFETCH, integer(Hdr.uNumT)), MADV_WILLNEED);
+	}
+#endif /* HAVE_SYS_MMAN_H && MADV_DONTNEED && MADV_WILLNEED */
+
+	/* if time went back, the slabs are mapped again on demand */
+	iResident = iNewResident;
+}
+
+std::shared_ptr<const GriddedWindProfile::TimeSlab>
+GriddedWindProfile::GetTimeSlab(const doublereal& t) const
+{
+#ifdef USE_MULTITHREAD
+	pthread_mutex_lock(&mutex);
+#endif /* USE_MULTITHREAD */
+
+	if (!pSlab || pSlab->dTime != t) {
+		integer m0, m1;
+		doublereal wt;
+		Locate(t, Hdr.dT0, Hdr.dDT, Hdr.uNumT, m0, m1, wt);
+
+		const float *s0 = pGetSlab(m0);
+		const float *s1 = pGetSlab(m1);
+
+		std::shared_ptr<TimeSlab> p(new TimeSlab);
+		p->dTime = t;
+		p->V.resize(3*size_t(Hdr.uNumY)*Hdr.uNumZ);
+		for (size_t i = 0; i < p->V.size(); i++) {
+			p->V[i] = (1. - wt)*s0[i] + wt*s1[i];
+		}
+
+		Advance(m0);
+
+		pSlab = p;
+	}
+
+	std::shared_ptr<const TimeSlab> p(pSlab);
+
+#ifdef USE_MULTITHREAD
+	pthread_mutex_unlock(&mutex);
+#endif /* USE_MULTITHREAD */
+
+	return p;
+}
+
+bool
+GriddedWindProfile::GetVelocity(const Vec3& X, Vec3& V) const
+{
+	V = Zero3;
+	AddVelocity(1, &X, &V);
+
+	return true;
+}
+
+void
+GriddedWindProfile::AddVelocity(unsigned uNumPoints, const Vec3 *pX, Vec3 *pV) const
+{
+	const doublereal t = Time.dGet();
+	const integer iNumY = Hdr.uNumY;
+	const integer iNumZ = Hdr.uNumZ;
+
+	/* without convection all points share the same time slab */
+	std::shared_ptr<const TimeSlab> p;
+	if (dConvVel == 0.) {
+		p = GetTimeSlab(t);
+	}
+
+	integer iMinPointSlab = Hdr.uNumT;
+
+	for (unsigned i = 0; i < uNumPoints; i++) {
+		/* position in the reference frame of the gust */
+		Vec3 Xl(R0.MulTV(pX[i] - X0));
+
+		integer j0, j1, k0, k1;
+		doublereal wy, wz;
+		Locate(Xl(2), Hdr.dY0, Hdr.dDY, iNumY, j0, j1, wy);
+		Locate(Xl(3), Hdr.dZ0, Hdr.dDZ, iNumZ, k0, k1, wz);
+
+		const integer i00 = 3*(k0*iNumY + j0);
+		const integer i01 = 3*(k0*iNumY + j1);
+		const integer i10 = 3*(k1*iNumY + j0);
+		const integer i11 = 3*(k1*iNumY + j1);
+
+		const doublereal w00 = (1. - wy)*(1. - wz);
+		const doublereal w01 = wy*(1. - wz);
+		const doublereal w10 = (1. - wy)*wz;
+		const doublereal w11 = wy*wz;
+
+		doublereal v[3];
+
+		if (p) {
+			/* bilinear in space */
+			const doublereal *s = &p->V[0];
+			for (int c = 0; c < 3; c++) {
+				v[c] = w00*s[i00 + c] + w01*s[i01 + c]
+					+ w10*s[i10 + c] + w11*s[i11 + c];
+			}
+
+		} else {
+			/* trilinear in space and time; the field at a distance x
+			 * along the mean wind is the one at x = 0, delayed by x/U */
+			integer m0, m1;
+			doublereal wt;
+			Locate(t - Xl(1)/dConvVel, Hdr.dT0, Hdr.dDT, Hdr.uNumT, m0, m1, wt);
+			iMinPointSlab = std::min(iMinPointSlab, m0);
+
+			const float *s0 = pGetSlab(m0);
+			const float *s1 = pGetSlab(m1);
+			for (int c = 0; c < 3; c++) {
+				v[c] = (1. - wt)*(w00*s0[i00 + c] + w01*s0[i01 + c]
+						+ w10*s0[i10 + c] + w11*s0[i11 + c])
+					+ wt*(w00*s1[i00 + c] + w01*s1[i01 + c]
+						+ w10*s1[i10 + c] + w11*s1[i11 + c]);
+			}
+		}
+
+		pV[i] += R0*Vec3(v[0], v[1], v[2])*dScale;
+	}
+
+	if (!p && uNumPoints > 0) {
+#ifdef USE_MULTITHREAD
+		pthread_mutex_lock(&mutex);
+#endif /* USE_MULTITHREAD */
+
+		if (t != dMinSlabTime) {
+			/* the previous time is over */
+			if (iMinSlab >= 0) {
+				Advance(iMinSlab);
+			}
+
+			dMinSlabTime = t;
+			iMinSlab = iMinPointSlab;
+
+		} else {
+			iMinSlab = std::min(iMinSlab, iMinPointSlab);
+		}
+
+#ifdef USE_MULTITHREAD
+		pthread_mutex_unlock(&mutex);
+#endif /* USE_MULTITHREAD */
+	}
+}
+
+std::ostream&
+GriddedWindProfile::Restart(std::ostream& out) const
+{
+	return out << "gridded"
+		<< ", reference position, " << X0
+		<< ", reference orientation, " << R0
+		<< ", convection velocity, " << dConvVel
+		<< ", scale factor, " << dScale
+		<< ", \"" << sFileName << "\"";
+}
+
+GriddedWindGR::~GriddedWindGR(void)
+{
+	NO_OP;
+}
+
+Gust *
+GriddedWindGR::Read(const DataManager* pDM, MBDynParser& HP)
+{
+	Vec3 X0(Zero3);
+	bool bGotX0 = false;
+	Mat3x3 R0(Eye3);
+	bool bGotR0 = false;
+	doublereal dConvVel = 0.;
+	bool bGotConvVel = false;
+	doublereal dScale = 1.;
+	bool bGotScale = false;
+
+	while (HP.IsArg()) {
+		if (HP.IsKeyWord("reference" "position")) {
+			if (bGotX0) {
+				silent_cerr("GriddedWindProfile: "
+					"reference position provided twice "
+					"at line " << HP.GetLineData()
+					<< std::endl);
+				throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+			}
+
+			X0 = HP.GetVecAbs(::AbsRefFrame);
+			bGotX0 = true;
+
+		} else if (HP.IsKeyWord("reference" "orientation")) {
+			if (bGotR0) {
+				silent_cerr("GriddedWindProfile: "
+					"reference orientation provided twice "
+					"at line " << HP.GetLineData()
+					<< std::endl);
+				throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+			}
+
+			R0 = HP.GetRotAbs(::AbsRefFrame);
+			bGotR0 = true;
+
+		} else if (HP.IsKeyWord("convection" "velocity")) {
+			if (bGotConvVel) {
+				silent_cerr("GriddedWindProfile: "
+					"convection velocity provided twice "
+					"at line " << HP.GetLineData()
+					<< std::endl);
+				throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+			}
+
+			dConvVel = HP.GetReal();
+			if (dConvVel < 0.) {
+				silent_cerr("GriddedWindProfile: "
+					"invalid convection velocity " << dConvVel << " "
+					"at line " << HP.GetLineData()
+					<< std::endl);
+				throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+			}
+			bGotConvVel = true;
+
+		} else if (HP.IsKeyWord("scale" "factor")) {
+			if (bGotScale) {
+				silent_cerr("GriddedWindProfile: "
+					"scale factor provided twice "
+					"at line " << HP.GetLineData()
+					<< std::endl);
+				throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+			}
+
+			dScale = HP.GetReal();
+			bGotScale = true;
+
+		} else {
+			break;
+		}
+	}
+
+	const char *s = HP.GetFileName();
+	if (s == 0) {
+		silent_cerr("GriddedWindProfile: "
+			"unable to read file name "
+			"at line " << HP.GetLineData()
+			<< std::endl);
+		throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+	}
+
+	DriveCaller *pT = 0;
+	SAFENEWWITHCONSTRUCTOR(pT, TimeDriveCaller,
+			TimeDriveCaller(pDM->pGetDrvHdl()));
+
+	Gust *pG = 0;
+	SAFENEWWITHCONSTRUCTOR(pG, GriddedWindProfile,
+		GriddedWindProfile(X0, R0, s, pT, dConvVel, dScale));
+
+	return pG;
+}
+
+/* GriddedWindProfile - end */
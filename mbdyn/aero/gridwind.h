@@ -0,0 +1,142 @@
+/* $Header$ */
+/*
+ * MBDyn (C) is a multibody analysis code.
+ * http://www.mbdyn.org
+ *
+ * Copyright (C) 1996-2023
+ *
+ * Pierangelo Masarati	<pierangelo.masarati@polimi.it>
+ * Paolo Mantegazza	<paolo.mantegazza@polimi.it>
+ *
+ * Dipartimento di Ingegneria Aerospaziale - Politecnico di Milano
+ * via La Masa, 34 - 20156 Milano, Italy
+ * http://www.aero.polimi.it
+ *
+ * Changing this copyright notice is forbidden.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation (version 2 of the License).
+ *
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* gridded (turbulent) wind field */
+
+#ifndef GRIDWIND_H
+#define GRIDWIND_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <stdint.h>
+
+#include "windprof.h"
+
+/*
+ * The binary file (the "wind box") consists of a header followed,
+ * at uDataOffset, by uNumT time slabs; each slab contains the three
+ * components of the velocity at the uNumY x uNumZ points of the grid,
+ * as single precision numbers, with y running fastest:
+ *
+ *	v[t][z][y][3]
+ *
+ * in the byte order of the writer (checked by means of uByteOrder).
+ * Grid coordinates and velocity components refer to the reference
+ * frame of the gust; point (j, k) of slab m is located at
+ *
+ *	y = dY0 + j*dDY, z = dZ0 + k*dDZ, t = dT0 + m*dDT
+ */
+
+struct GriddedWindHeader {
+	char		magic[8];
+	uint32_t	uVersion;
+	uint32_t	uByteOrder;
+	uint32_t	uNumY;
+	uint32_t	uNumZ;
+	uint64_t	uNumT;
+	uint64_t	uDataOffset;
+	double		dY0;
+	double		dDY;
+	double		dZ0;
+	double		dDZ;
+	double		dT0;
+	double		dDT;
+};
+
+const char GRIDWIND_MAGIC[8] = { 'M', 'B', 'D', 'W', 'i', 'n', 'd', 'G' };
+const uint32_t GRIDWIND_VERSION = 1;
+const uint32_t GRIDWIND_BYTE_ORDER = 0x01020304U;
+
+/* GriddedWindProfile - begin */
+
+class GriddedWindProfile : public WindProfile {
+protected:
+	std::string sFileName;
+	GriddedWindHeader Hdr;
+
+	DriveOwner Time;
+
+	/* convection velocity along axis 1 (frozen turbulence); 0 if none */
+	const doublereal dConvVel;
+	const doublereal dScale;
+
+	const char *pMap;
+	size_t uMapSize;
+	std::vector<float> Buf;
+	const float *pData;
+
+	/* time slab interpolated at the current time, shared by all
+	 * the points (and all the elements) in a residual evaluation */
+	struct TimeSlab {
+		doublereal dTime;
+		std::vector<doublereal> V;
+	};
+	mutable std::shared_ptr<const TimeSlab> pSlab;
+
+	/* slabs before this one have been released */
+	mutable integer iResident;
+
+	/* with convection, the oldest slab used by any point
+	 * at time dMinSlabTime; slabs are released only when the time
+	 * changes, so that all elements and iterations are accounted for */
+	mutable doublereal dMinSlabTime;
+	mutable integer iMinSlab;
+
+#ifdef USE_MULTITHREAD
+	mutable pthread_mutex_t mutex;
+#endif /* USE_MULTITHREAD */
+
+	const float *pGetSlab(integer iSlab) const;
+	void Advise(integer iBegin, integer iEnd, int iAdvice) const;
+	void Advance(integer iSlab) const;
+	std::shared_ptr<const TimeSlab> GetTimeSlab(const doublereal& t) const;
+
+public:
+	GriddedWindProfile(const Vec3& X0, const Mat3x3& R0,
+		const std::string& sFileName, const DriveCaller *pTime,
+		const doublereal dConvVel, const doublereal dScale);
+	virtual ~GriddedWindProfile(void);
+	virtual bool GetVelocity(const Vec3& X, Vec3& V) const;
+	virtual void AddVelocity(unsigned uNumPoints, const Vec3 *pX, Vec3 *pV) const;
+	virtual std::ostream& Restart(std::ostream& out) const;
+};
+
+struct GriddedWindGR : public GustRead {
+public:
+	virtual ~GriddedWindGR(void);
+	virtual Gust *
+	Read(const DataManager* pDM, MBDynParser& HP);
+};
+
+/* GriddedWindProfile - end */
+
+#endif // GRIDWIND_H
@@ -36,6 +36,7 @@
 #include "drive_.h"
 
 #include "windprof.h"
+#include "gridwind.h"
 
 /* Gust - begin */
 
@@ -59,6 +60,17 @@ Gust::GetVelocity(const Vec3& X) const
 	return V;
 }
 
+void
+Gust::AddVelocity(unsigned uNumPoints, const Vec3 *pX, Vec3 *pV) const
+{
+	for (unsigned i = 0; i < uNumPoints; i++) {
+		Vec3 V;
+		if (GetVelocity(pX[i], V)) {
+			pV[i] += V;
+		}
+	}
+}
+
 GustRead::~GustRead(void)
 {
 	NO_OP;
@@ -219,6 +231,7 @@ InitGustData(void)
 	SetGustData("scalar" "function", new ScalarFuncGR);
 	SetGustData("power" "law", new PowerLawGR);
 	SetGustData("logarithmic", new LogarithmicGR);
+	SetGustData("gridded", new GriddedWindGR);
 
 	/* NOTE: add here initialization of new built-in drive callers;
 	 * alternative ways to register new custom gust models are:
@@ -50,6 +50,11 @@ public:
 	void SetAirProperties(const AirProperties *pap);
 	virtual Vec3 GetVelocity(const Vec3& X) const;
 	virtual bool GetVelocity(const Vec3& X, Vec3& V) const = 0;
+
+	/* adds the velocity at uNumPoints points to pV; the default
+	 * calls GetVelocity() point by point, gusts that benefit
+	 * from processing many points at once should override it */
+	virtual void AddVelocity(unsigned uNumPoints, const Vec3 *pX, Vec3 *pV) const;
 	virtual std::ostream& Restart(std::ostream& out) const = 0;
 };
 
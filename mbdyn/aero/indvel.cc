@@ -35,6 +35,7 @@
 
 #include <limits>
 #include <cmath>
+#include <algorithm>
 
 #ifdef USE_MPI
 #include "mysleep.h"
@@ -80,12 +81,6 @@ ppRes(ppres)
    		IndVelComm = MBDynComm.Dup();
 	}
 #endif /* USE_MPI */
-
-#if defined(USE_MULTITHREAD) && defined(MBDYN_X_MT_ASSRES)
-	pthread_mutex_init(&induced_velocity_mutex, NULL);
-	pthread_cond_init(&induced_velocity_cond, NULL);
-	pthread_mutex_init(&forces_mutex, NULL);
-#endif /* USE_MULTITHREAD && MBDYN_X_MT_ASSRES */
 }
 
 InducedVelocity::~InducedVelocity(void)
@@ -94,12 +89,6 @@ InducedVelocity::~InducedVelocity(void)
 	SAFEDELETEARR(pTmpVecR);
 	SAFEDELETEARR(pTmpVecS);
 #endif /* USE_MPI */
-
-#if defined(USE_MULTITHREAD) && defined(MBDYN_X_MT_ASSRES)
-	pthread_mutex_destroy(&induced_velocity_mutex);
-	pthread_cond_destroy(&induced_velocity_cond);
-	pthread_mutex_destroy(&forces_mutex);
-#endif /* USE_MULTITHREAD && MBDYN_X_MT_ASSRES */
 }
 
 bool
@@ -170,10 +159,7 @@ void
 InducedVelocity::AfterConvergence(const VectorHandler& /* X */ ,
 		const VectorHandler& /* XP */ )
 {
-#if defined(USE_MULTITHREAD) && defined(MBDYN_X_MT_ASSRES)
-	ASSERT(bDone);
-	bDone = false;
-#endif // USE_MULTITHREAD && MBDYN_X_MT_ASSRES
+	NO_OP;
 }
 
 /* assemblaggio jacobiano (nullo per tutti tranne che per il DynamicInflow) */
@@ -254,6 +240,15 @@ InducedVelocity::AddForce(const Elem *pEl, const StructNode *pNode,
 {
 	for (int i = 0; ppRes && ppRes[i]; i++) {
 		if (ppRes[i]->is_in(pEl->GetLabel())) {
+#if defined(USE_MULTITHREAD) && defined(MBDYN_X_MT_ASSRES)
+			if (uThread > 0) {
+				ASSERT(uThread <= TF.size());
+				ThreadForces& tf = TF[uThread - 1];
+				tf.SetF[i] += F;
+				tf.SetM[i] += M + (X - ppRes[i]->pRes->Pole()).Cross(F);
+				continue;
+			}
+#endif // USE_MULTITHREAD && MBDYN_X_MT_ASSRES
 			ppRes[i]->pRes->AddForces(F, M, X);
 		}
 	}
@@ -279,28 +274,70 @@ InducedVelocity::ResetForce(void)
 	for (int i = 0; ppRes && ppRes[i]; i++) {
 		ppRes[i]->pRes->Reset();
 	}
+
+#if defined(USE_MULTITHREAD) && defined(MBDYN_X_MT_ASSRES)
+	for (std::vector<ThreadForces>::iterator t = TF.begin(); t != TF.end(); ++t) {
+		t->F = Zero3;
+		t->M = Zero3;
+		std::fill(t->SetF.begin(), t->SetF.end(), Zero3);
+		std::fill(t->SetM.begin(), t->SetM.end(), Zero3);
+	}
+#endif // USE_MULTITHREAD && MBDYN_X_MT_ASSRES
+}
+
+bool
+InducedVelocity::bConcurrentForces(void) const
+{
+	return true;
 }
 
 #if defined(USE_MULTITHREAD) && defined(MBDYN_X_MT_ASSRES)
+thread_local unsigned InducedVelocity::uThread = 0;
+
+void
+InducedVelocity::SetThread(unsigned uT)
+{
+	uThread = uT;
+}
+
 void
-InducedVelocity::Wait(void) const
+InducedVelocity::SetNumThreads(unsigned nThreads)
 {
-	pthread_mutex_lock(&induced_velocity_mutex);
-	if (!bDone) {
-		pthread_cond_wait(&induced_velocity_cond,
-				&induced_velocity_mutex);
+	ASSERT(nThreads > 0);
+
+	unsigned nSets = 0;
+	while (ppRes && ppRes[nSets]) {
+		nSets++;
+	}
+
+	TF.resize(nThreads - 1);
+	for (std::vector<ThreadForces>::iterator t = TF.begin(); t != TF.end(); ++t) {
+		t->F = Zero3;
+		t->M = Zero3;
+		t->SetF.assign(nSets, Zero3);
+		t->SetM.assign(nSets, Zero3);
 	}
-	pthread_mutex_unlock(&induced_velocity_mutex);
 }
 
 void
-InducedVelocity::Done(void) const
+InducedVelocity::ReduceForces(void)
 {
-	pthread_mutex_lock(&induced_velocity_mutex);
-	ASSERT(!bDone);
-	bDone = true;
-	pthread_cond_broadcast(&induced_velocity_cond);
-	pthread_mutex_unlock(&induced_velocity_mutex);
+	ASSERT(uThread == 0);
+
+	for (std::vector<ThreadForces>::iterator t = TF.begin(); t != TF.end(); ++t) {
+		// moments are already referred to the poles
+		Res.AddForce(t->F);
+		Res.AddMoment(t->M);
+		t->F = Zero3;
+		t->M = Zero3;
+
+		for (int i = 0; ppRes && ppRes[i]; i++) {
+			ppRes[i]->pRes->AddForce(t->SetF[i]);
+			ppRes[i]->pRes->AddMoment(t->SetM[i]);
+			t->SetF[i] = Zero3;
+			t->SetM[i] = Zero3;
+		}
+	}
 }
 #endif // USE_MULTITHREAD && MBDYN_X_MT_ASSRES
 
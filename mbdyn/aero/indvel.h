@@ -33,6 +33,7 @@
 #define INDVEL_H
 
 #include <cfloat>
+#include <vector>
 
 #include "ac/pthread.h"
 #ifdef USE_MPI
@@ -98,14 +99,21 @@ protected:
 #endif // USE_MPI
 
 #if defined(USE_MULTITHREAD) && defined(MBDYN_X_MT_ASSRES)
-	mutable pthread_mutex_t forces_mutex;
-
-	mutable pthread_mutex_t induced_velocity_mutex;
-	mutable pthread_cond_t induced_velocity_cond;
-	mutable bool bDone;
+	// The inflow is computed by AssRes() before the other elements
+	// are assembled concurrently, so they can read it without waiting.
+	// The contributions of the helper threads are accumulated
+	// in per-thread slots, summed by ReduceForces() once per residual;
+	// the main thread (number 0) accumulates straight into Res.
+	struct ThreadForces {
+		Vec3 F;
+		Vec3 M;
+		std::vector<Vec3> SetF;
+		std::vector<Vec3> SetM;
+	};
+	std::vector<ThreadForces> TF;
 
-	void Wait(void) const;
-	void Done(void) const;
+	// number of the thread that is running
+	static thread_local unsigned uThread;
 #endif // USE_MULTITHREAD && MBDYN_X_MT_ASSRES
 
 	const StructNode* pCraft;
@@ -115,6 +123,31 @@ protected:
 	// extra forces
 	ResForceSet **ppRes;
 
+	// AddForce() helpers: accumulate into Res
+	inline void AddResForces(const Vec3& F, const Vec3& M, const Vec3& X) {
+#if defined(USE_MULTITHREAD) && defined(MBDYN_X_MT_ASSRES)
+		if (uThread > 0) {
+			ASSERT(uThread <= TF.size());
+			ThreadForces& tf = TF[uThread - 1];
+			tf.F += F;
+			tf.M += M + (X - Res.Pole()).Cross(F);
+			return;
+		}
+#endif // USE_MULTITHREAD && MBDYN_X_MT_ASSRES
+		Res.AddForces(F, M, X);
+	};
+
+	inline void AddResForce(const Vec3& F) {
+#if defined(USE_MULTITHREAD) && defined(MBDYN_X_MT_ASSRES)
+		if (uThread > 0) {
+			ASSERT(uThread <= TF.size());
+			TF[uThread - 1].F += F;
+			return;
+		}
+#endif // USE_MULTITHREAD && MBDYN_X_MT_ASSRES
+		Res.AddForce(F);
+	};
+
 public:
 	InducedVelocity(unsigned int uL,
 		const StructNode* pCraft,
@@ -161,16 +194,10 @@ public:
 	};
 
 	virtual inline const Vec3& GetForces(void) const {
-#if defined(USE_MULTITHREAD) && defined(MBDYN_X_MT_ASSRES)
-		Wait();
-#endif // USE_MULTITHREAD && MBDYN_X_MT_ASSRES
 		return Res.Force();
 	};
 
 	virtual inline const Vec3& GetMoments(void) const {
-#if defined(USE_MULTITHREAD) && defined(MBDYN_X_MT_ASSRES)
-		Wait();
-#endif // USE_MULTITHREAD && MBDYN_X_MT_ASSRES
 		return Res.Moment();
 	};
 
@@ -198,6 +225,23 @@ public:
 
 	virtual void ResetForce(void);
 
+	// Return "true" if AddForce(), AddSectionalForce()
+	// and GetInducedVelocity() can be called concurrently
+	// by elements assembled by different threads; implementations
+	// whose state depends on the order of the calls must return "false"
+	virtual bool bConcurrentForces(void) const;
+
+#if defined(USE_MULTITHREAD) && defined(MBDYN_X_MT_ASSRES)
+	// multithreaded residual assembly
+	static void SetThread(unsigned uT);
+	void SetNumThreads(unsigned nThreads);
+
+	// sums the contributions of the helper threads into Res
+	// and into the extra sets; called once per residual,
+	// after all the elements have been assembled
+	void ReduceForces(void);
+#endif // USE_MULTITHREAD && MBDYN_X_MT_ASSRES
+
 	// Restituisce ad un elemento la velocita' indotta
 	// in base alla posizione azimuthale
 	virtual Vec3 GetInducedVelocity(Elem::Type type,
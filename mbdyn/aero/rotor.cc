@@ -774,10 +774,6 @@ NoRotor::AssRes(SubVectorHandler& WorkVec,
 	ResetForce();
 	WorkVec.Resize(0);
 
-#if defined(USE_MULTITHREAD) && defined(MBDYN_X_MT_ASSRES)
-	Done();
-#endif // USE_MULTITHREAD && MBDYN_X_MT_ASSRES
-
 	return WorkVec;
 }
 
@@ -802,19 +798,10 @@ NoRotor::AddForce(const Elem *pEl, const StructNode *pNode,
 	}
 #endif // USE_MPI
 
-#if defined(USE_MULTITHREAD) && defined(MBDYN_X_MT_ASSRES)
-	pthread_mutex_lock(&forces_mutex);
-	Wait();
-#endif // USE_MULTITHREAD && MBDYN_X_MT_ASSRES
-
 	if (bToBeOutput()) {
-		Res.AddForces(F, M, X);
+		AddResForces(F, M, X);
 		InducedVelocity::AddForce(pEl, pNode, F, M, X);
 	}
-
-#if defined(USE_MULTITHREAD) && defined(MBDYN_X_MT_ASSRES)
-	pthread_mutex_unlock(&forces_mutex);
-#endif // USE_MULTITHREAD && MBDYN_X_MT_ASSRES
 }
 
 /* Restituisce ad un elemento la velocita' indotta in base alla posizione
@@ -971,10 +958,6 @@ UniformRotor::AssRes(SubVectorHandler& WorkVec,
 	/* Non tocca il residuo */
 	WorkVec.Resize(0);
 
-#if defined(USE_MULTITHREAD) && defined(MBDYN_X_MT_ASSRES)
-	Done();
-#endif // USE_MULTITHREAD && MBDYN_X_MT_ASSRES
-
 	return WorkVec;
 }
 
@@ -1000,22 +983,13 @@ UniformRotor::AddForce(const Elem *pEl, const StructNode *pNode,
 	}
 #endif /* USE_MPI */
 
-#if defined(USE_MULTITHREAD) && defined(MBDYN_X_MT_ASSRES)
-	pthread_mutex_lock(&forces_mutex);
-	Wait();
-#endif // USE_MULTITHREAD && MBDYN_X_MT_ASSRES
-
 	/* Solo se deve fare l'output calcola anche il momento */
 	if (bToBeOutput()) {
-		Res.AddForces(F, M, X);
+		AddResForces(F, M, X);
 		InducedVelocity::AddForce(pEl, pNode, F, M, X);
 	} else {
-		Res.AddForce(F);
+		AddResForce(F);
 	}
-
-#if defined(USE_MULTITHREAD) && defined(MBDYN_X_MT_ASSRES)
-	pthread_mutex_unlock(&forces_mutex);
-#endif /* USE_MULTITHREAD && MBDYN_X_MT_ASSRES */
 }
 
 /* Restituisce ad un elemento la velocita' indotta in base alla posizione
@@ -1024,10 +998,6 @@ Vec3
 UniformRotor::GetInducedVelocity(Elem::Type type,
 	unsigned uLabel, unsigned uPnt, const Vec3& X) const
 {
-#if defined(USE_MULTITHREAD) && defined(MBDYN_X_MT_ASSRES)
-	Wait();
-#endif /* USE_MULTITHREAD && MBDYN_X_MT_ASSRES */
-
 	return RRot3*dUMeanPrev;
 };
 
@@ -1087,25 +1057,16 @@ UniformRotor2::AddSectionalForce(Elem::Type type,
 	}
 #endif /* USE_MPI */
 
-#if defined(USE_MULTITHREAD) && defined(MBDYN_X_MT_ASSRES)
-	pthread_mutex_lock(&forces_mutex);
-	Wait();
-#endif // USE_MULTITHREAD && MBDYN_X_MT_ASSRES
-
 	/* Solo se deve fare l'output calcola anche il momento */
 	if (bToBeOutput()) {
 		Vec3 FTmp(F*dW);
 		Vec3 MTmp(M*dW);
-		Res.AddForces(FTmp, MTmp, X);
+		AddResForces(FTmp, MTmp, X);
 		InducedVelocity::AddForce(pEl, 0, FTmp, MTmp, X);
 
 	} else {
-		Res.AddForce(F*dW);
+		AddResForce(F*dW);
 	}
-
-#if defined(USE_MULTITHREAD) && defined(MBDYN_X_MT_ASSRES)
-	pthread_mutex_unlock(&forces_mutex);
-#endif /* USE_MULTITHREAD && MBDYN_X_MT_ASSRES */
 }
 
 /* UniformRotor - end */
@@ -1272,10 +1233,6 @@ GlauertRotor::AssRes(SubVectorHandler& WorkVec,
 	/* Non tocca il residuo */
 	WorkVec.Resize(0);
 
-#if defined(USE_MULTITHREAD) && defined(MBDYN_X_MT_ASSRES)
-	Done();
-#endif // USE_MULTITHREAD && MBDYN_X_MT_ASSRES
-
 	return WorkVec;
 }
 
@@ -1302,22 +1259,13 @@ GlauertRotor::AddForce(const Elem *pEl, const StructNode *pNode,
 	}
 #endif /* USE_MPI */
 
-#if defined(USE_MULTITHREAD) && defined(MBDYN_X_MT_ASSRES)
-	pthread_mutex_lock(&forces_mutex);
-	Wait();
-#endif /* USE_MULTITHREAD && MBDYN_X_MT_ASSRES */
-
 	/* Solo se deve fare l'output calcola anche il momento */
 	if (bToBeOutput()) {
-		Res.AddForces(F, M, X);
+		AddResForces(F, M, X);
 		InducedVelocity::AddForce(pEl, pNode, F, M, X);
 	} else {
-		Res.AddForce(F);
+		AddResForce(F);
 	}
-
-#if defined(USE_MULTITHREAD) && defined(MBDYN_X_MT_ASSRES)
-	pthread_mutex_unlock(&forces_mutex);
-#endif /* USE_MULTITHREAD && MBDYN_X_MT_ASSRES */
 }
 
 
@@ -1333,10 +1281,6 @@ GlauertRotor::GetInducedVelocity(Elem::Type type,
 		return Zero3;
 	}
 
-#if defined(USE_MULTITHREAD) && defined(MBDYN_X_MT_ASSRES)
-	Wait();
-#endif /* USE_MULTITHREAD && MBDYN_X_MT_ASSRES */
-
 	if (std::abs(dLambda) < 1.e-9) {
 		return RRot3*dUMeanPrev;
 	}
@@ -1577,10 +1521,6 @@ ManglerRotor::AssRes(SubVectorHandler& WorkVec,
 	/* Non tocca il residuo */
 	WorkVec.Resize(0);
 
-#if defined(USE_MULTITHREAD) && defined(MBDYN_X_MT_ASSRES)
-	Done();
-#endif // USE_MULTITHREAD && MBDYN_X_MT_ASSRES
-
 	return WorkVec;
 }
 
@@ -1606,22 +1546,13 @@ ManglerRotor::AddForce(const Elem *pEl, const StructNode *pNode,
 	}
 #endif /* USE_MPI */
 
-#if defined(USE_MULTITHREAD) && defined(MBDYN_X_MT_ASSRES)
-	pthread_mutex_lock(&forces_mutex);
-	Wait();
-#endif /* USE_MULTITHREAD && MBDYN_X_MT_ASSRES */
-
 	/* Solo se deve fare l'output calcola anche il momento */
 	if (bToBeOutput()) {
-		Res.AddForces(F, M, X);
+		AddResForces(F, M, X);
 		InducedVelocity::AddForce(pEl, pNode, F, M, X);
 	} else {
-		Res.AddForce(F);
+		AddResForce(F);
 	}
-
-#if defined(USE_MULTITHREAD) && defined(MBDYN_X_MT_ASSRES)
-	pthread_mutex_unlock(&forces_mutex);
-#endif /* USE_MULTITHREAD && MBDYN_X_MT_ASSRES */
 }
 
 
@@ -1635,10 +1566,6 @@ ManglerRotor::GetInducedVelocity(Elem::Type type,
 		return ::Zero3;
 	}
 
-#if defined(USE_MULTITHREAD) && defined(MBDYN_X_MT_ASSRES)
-	Wait();
-#endif /* USE_MULTITHREAD && MBDYN_X_MT_ASSRES */
-
 	doublereal dr, dp;
 	GetPos(X, dr, dp);
 
@@ -2211,10 +2138,6 @@ DynamicInflowRotor::AssRes(SubVectorHandler& WorkVec,
 	/* Ora la trazione non serve piu' */
 	ResetForce();
 
-#if defined(USE_MULTITHREAD) && defined(MBDYN_X_MT_ASSRES)
-	Done();
-#endif // USE_MULTITHREAD && MBDYN_X_MT_ASSRES
-
      	return WorkVec;
 }
 
@@ -2271,19 +2194,10 @@ DynamicInflowRotor::AddForce(const Elem *pEl, const StructNode *pNode,
 	}
 #endif /* USE_MPI */
 
-#if defined(USE_MULTITHREAD) && defined(MBDYN_X_MT_ASSRES)
-	pthread_mutex_lock(&forces_mutex);
-	Wait();
-#endif /* USE_MULTITHREAD && MBDYN_X_MT_ASSRES */
-
-	Res.AddForces(F, M, X);
+	AddResForces(F, M, X);
 	if (bToBeOutput()) {
 		InducedVelocity::AddForce(pEl, pNode, F, M, X);
 	}
-
-#if defined(USE_MULTITHREAD) && defined(MBDYN_X_MT_ASSRES)
-	pthread_mutex_unlock(&forces_mutex);
-#endif /* USE_MULTITHREAD && MBDYN_X_MT_ASSRES */
 }
 
 
@@ -2293,10 +2207,6 @@ Vec3
 DynamicInflowRotor::GetInducedVelocity(Elem::Type type,
 	unsigned uLabel, unsigned uPnt, const Vec3& X) const
 {
-#if defined(USE_MULTITHREAD) && defined(MBDYN_X_MT_ASSRES)
-	Wait();
-#endif /* USE_MULTITHREAD && MBDYN_X_MT_ASSRES */
-
 	doublereal dr, dpsi;
 	GetPos(X, dr, dpsi);
 
@@ -2814,10 +2724,6 @@ PetersHeRotor::AssRes(SubVectorHandler& WorkVec,
 	/* Ora la trazione non serve piu' */
 	ResetForce();
 
-#if defined(USE_MULTITHREAD) && defined(MBDYN_X_MT_ASSRES)
-	Done();
-#endif // USE_MULTITHREAD && MBDYN_X_MT_ASSRES
-
      	return WorkVec;
 }
 
@@ -2874,19 +2780,10 @@ PetersHeRotor::AddForce(const Elem *pEl, const StructNode *pNode,
 	}
 #endif /* USE_MPI */
 
-#if defined(USE_MULTITHREAD) && defined(MBDYN_X_MT_ASSRES)
-	pthread_mutex_lock(&forces_mutex);
-	Wait();
-#endif /* USE_MULTITHREAD && MBDYN_X_MT_ASSRES */
-
-	Res.AddForces(F, M, X);
+	AddResForces(F, M, X);
 	if (bToBeOutput()) {
 		InducedVelocity::AddForce(pEl, pNode, F, M, X);
 	}
-
-#if defined(USE_MULTITHREAD) && defined(MBDYN_X_MT_ASSRES)
-	pthread_mutex_unlock(&forces_mutex);
-#endif /* USE_MULTITHREAD && MBDYN_X_MT_ASSRES */
 }
 
 
@@ -2896,10 +2793,6 @@ Vec3
 PetersHeRotor::GetInducedVelocity(Elem::Type type,
 	unsigned uLabel, unsigned uPnt, const Vec3& X) const
 {
-#if defined(USE_MULTITHREAD) && defined(MBDYN_X_MT_ASSRES)
-	Wait();
-#endif /* USE_MULTITHREAD && MBDYN_X_MT_ASSRES */
-
 	doublereal dr, dp;
 	GetPos(X, dr, dp);
 
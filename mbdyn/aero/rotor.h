@@ -163,37 +163,22 @@ public:
 
 	// accesso a dati
 	virtual inline doublereal dGetOmega(void) const {
-#if defined(USE_MULTITHREAD) && defined(MBDYN_X_MT_ASSRES)
-		Wait();
-#endif // USE_MULTITHREAD && MBDYN_X_MT_ASSRES
 		return dOmega;
 	};
 
 	virtual inline doublereal dGetRadius(void) const {
-#if defined(USE_MULTITHREAD) && defined(MBDYN_X_MT_ASSRES)
-		Wait();
-#endif // USE_MULTITHREAD && MBDYN_X_MT_ASSRES
 		return dRadius;
 	};
 
 	virtual inline doublereal dGetMu(void) const {
-#if defined(USE_MULTITHREAD) && defined(MBDYN_X_MT_ASSRES)
-		Wait();
-#endif // USE_MULTITHREAD && MBDYN_X_MT_ASSRES
 		return dMu;
 	};
 
 	virtual inline const Vec3& GetForces(void) const {
-#if defined(USE_MULTITHREAD) && defined(MBDYN_X_MT_ASSRES)
-		Wait();
-#endif // USE_MULTITHREAD && MBDYN_X_MT_ASSRES
 		return Res.Force();
 	};
 
 	virtual inline const Vec3& GetMoments(void) const {
-#if defined(USE_MULTITHREAD) && defined(MBDYN_X_MT_ASSRES)
-		Wait();
-#endif // USE_MULTITHREAD && MBDYN_X_MT_ASSRES
 		return Res.Moment();
 	};
 
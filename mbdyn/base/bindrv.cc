@@ -0,0 +1,291 @@
+/*
+ * MBDyn (C) is a multibody analysis code.
+ * http://www.mbdyn.org
+ *
+ * Copyright (C) 1996-2023
+ *
+ * Pierangelo Masarati	<pierangelo.masarati@polimi.it>
+ * Paolo Mantegazza	<paolo.mantegazza@polimi.it>
+ *
+ * Dipartimento di Ingegneria Aerospaziale - Politecnico di Milano
+ * via La Masa, 34 - 20156 Milano, Italy
+ * http://www.aero.polimi.it
+ *
+ * Changing this copyright notice is forbidden.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation (version 2 of the License).
+ *
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* binary input file of the fixed/variable step file drivers */
+
+#include "mbconfig.h"           /* This goes first in every *.c,*.cc file */
+
+#include <cerrno>
+#include <cstring>
+#include <climits>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif /* HAVE_SYS_MMAN_H */
+
+#include "myassert.h"
+#include "except.h"
+#include "bindrv.h"
+
+/* size of the resident window, summed over all the columns */
+static const size_t BINDRV_WINDOW_BYTES = 16*1024*1024;
+
+/* BinDriveFile - begin */
+
+static bool
+ReadAll(int fd, char *p, size_t n)
+{
+	while (n > 0) {
+		ssize_t rc = ::read(fd, p, n);
+		if (rc <= 0) {
+			if (rc == -1 && errno == EINTR) {
+				continue;
+			}
+			return false;
+		}
+		p += rc;
+		n -= rc;
+	}
+
+	return true;
+}
+
+BinDriveFile::BinDriveFile(const std::string& sFileName)
+: sFileName(sFileName),
+pMap(0), uMapSize(0), pData(0),
+iWinSize(0), iWinBegin(0), iWinEnd(0)
+{
+	int fd = ::open(sFileName.c_str(), O_RDONLY);
+	if (fd == -1) {
+		int save_errno = errno;
+		silent_cerr("BinDriveFile: unable to open file \"" << sFileName << "\" "
+			"(" << save_errno << ": " << strerror(save_errno) << ")"
+			<< std::endl);
+		throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) == -1 || !ReadAll(fd, (char *)&Hdr, sizeof(Hdr))) {
+		(void)::close(fd);
+		silent_cerr("BinDriveFile: unable to read the header "
+			"of file \"" << sFileName << "\"" << std::endl);
+		throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+	}
+
+	const char *sErr = 0;
+	if (memcmp(Hdr.magic, BINDRV_MAGIC, sizeof(Hdr.magic)) != 0) {
+		sErr = "invalid signature";
+
+	} else if (Hdr.uByteOrder != BINDRV_BYTE_ORDER) {
+		sErr = "byte order does not match this machine's";
+
+	} else if (Hdr.uVersion == 0 || Hdr.uVersion > BINDRV_VERSION) {
+		sErr = "unsupported version";
+
+	} else if (Hdr.uNumColumns == 0 || Hdr.uNumColumns > INT_MAX
+		|| Hdr.uNumSteps == 0 || Hdr.uNumSteps > INT_MAX)
+	{
+		sErr = "invalid number of columns or steps";
+
+	} else if (Hdr.uDataOffset < sizeof(Hdr)
+		|| uint64_t(st.st_size) < Hdr.uDataOffset
+		|| (uint64_t(st.st_size) - Hdr.uDataOffset)/sizeof(double)/Hdr.uNumColumns < Hdr.uNumSteps)
+	{
+		sErr = "truncated file";
+
+	} else if (!(Hdr.uFlags & BINDRV_VARIABLE_STEP) && !(Hdr.dTimeStep > 0.)) {
+		sErr = "invalid time step";
+	}
+
+	if (sErr != 0) {
+		(void)::close(fd);
+		silent_cerr("BinDriveFile: file \"" << sFileName << "\": "
+			<< sErr << std::endl);
+		throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+	}
+
+	const size_t uNumValues = size_t(Hdr.uNumColumns)*Hdr.uNumSteps;
+
+#ifdef HAVE_SYS_MMAN_H
+	if (sizeof(doublereal) == sizeof(double)) {
+		uMapSize = Hdr.uDataOffset + uNumValues*sizeof(double);
+		void *p = mmap(0, uMapSize, PROT_READ, MAP_SHARED, fd, 0);
+		if (p != MAP_FAILED) {
+			pMap = (const char *)p;
+			pData = (const doublereal *)(pMap + Hdr.uDataOffset);
+
+		} else {
+			uMapSize = 0;
+		}
+	}
+#endif /* HAVE_SYS_MMAN_H */
+
+	if (pMap == 0) {
+		/* no mmap(2): read the whole file */
+		std::vector<double> Tmp(uNumValues);
+		if (lseek(fd, Hdr.uDataOffset, SEEK_SET) == (off_t)-1
+			|| !ReadAll(fd, (char *)&Tmp[0], uNumValues*sizeof(double)))
+		{
+			(void)::close(fd);
+			silent_cerr("BinDriveFile: unable to read file "
+				"\"" << sFileName << "\"" << std::endl);
+			throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+		}
+		Buf.assign(Tmp.begin(), Tmp.end());
+		pData = &Buf[0];
+	}
+
+	(void)::close(fd);
+
+	/* at least one page per column */
+	const integer iPageSteps = BINDRV_ALIGN/sizeof(double);
+	iWinSize = BINDRV_WINDOW_BYTES/sizeof(double)/Hdr.uNumColumns;
+	iWinSize = std::max((iWinSize/iPageSteps)*iPageSteps, 2*iPageSteps);
+}
+
+BinDriveFile::~BinDriveFile(void)
+{
+#ifdef HAVE_SYS_MMAN_H
+	if (pMap != 0) {
+		(void)munmap((void *)pMap, uMapSize);
+	}
+#endif /* HAVE_SYS_MMAN_H */
+}
+
+bool
+BinDriveFile::bIsBinary(const std::string& sFileName)
+{
+	char magic[sizeof(BINDRV_MAGIC)];
+
+	int fd = ::open(sFileName.c_str(), O_RDONLY);
+	if (fd == -1) {
+		return false;
+	}
+
+	bool bRet = ReadAll(fd, magic, sizeof(magic))
+		&& memcmp(magic, BINDRV_MAGIC, sizeof(magic)) == 0;
+
+	(void)::close(fd);
+
+	return bRet;
+}
+
+const std::string&
+BinDriveFile::sGetFileName(void) const
+{
+	return sFileName;
+}
+
+bool
+BinDriveFile::bIsVariableStep(void) const
+{
+	return (Hdr.uFlags & BINDRV_VARIABLE_STEP);
+}
+
+integer
+BinDriveFile::iGetNumColumns(void) const
+{
+	return Hdr.uNumColumns;
+}
+
+integer
+BinDriveFile::iGetNumSteps(void) const
+{
+	return Hdr.uNumSteps;
+}
+
+doublereal
+BinDriveFile::dGetInitialTime(void) const
+{
+	return Hdr.dInitialTime;
+}
+
+doublereal
+BinDriveFile::dGetTimeStep(void) const
+{
+	return Hdr.dTimeStep;
+}
+
+const doublereal *
+BinDriveFile::pGetColumn(integer i) const
+{
+	ASSERT(i >= 0 && i < iGetNumColumns());
+
+	return pData + size_t(i)*Hdr.uNumSteps;
+}
+
+void
+BinDriveFile::Advise(integer iBegin, integer iEnd, int iAdvice) const
+{
+#ifdef HAVE_SYS_MMAN_H
+	for (integer i = 0; i < iGetNumColumns(); i++) {
+		const doublereal *pCol = pGetColumn(i);
+		size_t uBegin = (const char *)&pCol[iBegin] - pMap;
+		size_t uEnd = (const char *)&pCol[iEnd] - pMap;
+
+		uBegin -= uBegin % BINDRV_ALIGN;
+		uEnd = std::min<size_t>(((uEnd + BINDRV_ALIGN - 1)/BINDRV_ALIGN)*BINDRV_ALIGN, uMapSize);
+
+		(void)madvise((void *)(pMap + uBegin), uEnd - uBegin, iAdvice);
+	}
+#endif /* HAVE_SYS_MMAN_H */
+}
+
+void
+BinDriveFile::MoveWindow(integer iStep)
+{
+	ASSERT(iStep >= 0 && iStep < iGetNumSteps());
+
+	/* time usually moves forward: keep a few steps behind */
+	integer iNewBegin = std::max(iStep - iWinSize/4, integer(0));
+	integer iNewEnd = std::min(iNewBegin + iWinSize, iGetNumSteps());
+
+#if defined(HAVE_SYS_MMAN_H) && defined(MADV_DONTNEED) && defined(MADV_WILLNEED)
+	if (pMap != 0) {
+		/* release the part of the old window
+		 * which is not covered by the new one */
+		if (iWinBegin < iWinEnd) {
+			if (iWinEnd <= iNewBegin || iNewEnd <= iWinBegin) {
+				Advise(iWinBegin, iWinEnd, MADV_DONTNEED);
+
+			} else {
+				if (iWinBegin < iNewBegin) {
+					Advise(iWinBegin, iNewBegin, MADV_DONTNEED);
+				}
+
+				if (iNewEnd < iWinEnd) {
+					Advise(iNewEnd, iWinEnd, MADV_DONTNEED);
+				}
+			}
+		}
+
+		Advise(iNewBegin, iNewEnd, MADV_WILLNEED);
+	}
+#endif /* HAVE_SYS_MMAN_H && MADV_DONTNEED && MADV_WILLNEED */
+
+	iWinBegin = iNewBegin;
+	iWinEnd = iNewEnd;
+}
+
+/* BinDriveFile - end */
@@ -0,0 +1,131 @@
+/* $Header$ */
+/*
+ * MBDyn (C) is a multibody analysis code.
+ * http://www.mbdyn.org
+ *
+ * Copyright (C) 1996-2023
+ *
+ * Pierangelo Masarati	<pierangelo.masarati@polimi.it>
+ * Paolo Mantegazza	<paolo.mantegazza@polimi.it>
+ *
+ * Dipartimento di Ingegneria Aerospaziale - Politecnico di Milano
+ * via La Masa, 34 - 20156 Milano, Italy
+ * http://www.aero.polimi.it
+ *
+ * Changing this copyright notice is forbidden.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation (version 2 of the License).
+ *
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* binary input file of the fixed/variable step file drivers */
+
+#ifndef BINDRV_H
+#define BINDRV_H
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#include "ac/f2c.h"
+
+/*
+ * The binary file consists of a header followed, at uDataOffset
+ * (a multiple of 4096), by uNumColumns contiguous columns
+ * of uNumSteps doubles each, in the byte order of the writer
+ * (checked by means of uByteOrder).  A variable step file stores
+ * the time in the first column, followed by the channels;
+ * a fixed step file only stores the channels, while initial time
+ * and time step are stored in the header.
+ *
+ * The file is mapped read-only; only a window of steps around
+ * the current time is kept resident, so the memory footprint
+ * does not depend on the length of the history.
+ *
+ * Files are generated from the textual format by the drv2bin utility.
+ */
+
+struct BinDriveHeader {
+	char		magic[8];
+	uint32_t	uVersion;
+	uint32_t	uFlags;
+	uint32_t	uByteOrder;
+	uint32_t	uNumColumns;
+	uint64_t	uNumSteps;
+	uint64_t	uDataOffset;
+	double		dInitialTime;
+	double		dTimeStep;
+};
+
+const char BINDRV_MAGIC[8] = { 'M', 'B', 'D', 'r', 'v', 'B', 'i', 'n' };
+const uint32_t BINDRV_VERSION = 1;
+const uint32_t BINDRV_BYTE_ORDER = 0x01020304U;
+const uint64_t BINDRV_ALIGN = 4096;
+
+/* uFlags */
+const uint32_t BINDRV_VARIABLE_STEP = 0x1U;
+
+/* BinDriveFile - begin */
+
+class BinDriveFile {
+private:
+	std::string sFileName;
+	BinDriveHeader Hdr;
+
+	const char *pMap;
+	size_t uMapSize;
+	std::vector<doublereal> Buf;
+	const doublereal *pData;
+
+	/* resident window of steps */
+	integer iWinSize;
+	integer iWinBegin;
+	integer iWinEnd;
+
+	void Advise(integer iBegin, integer iEnd, int iAdvice) const;
+
+public:
+	BinDriveFile(const std::string& sFileName);
+	~BinDriveFile(void);
+
+	/* true if the file starts with the signature of a binary drive file */
+	static bool bIsBinary(const std::string& sFileName);
+
+	const std::string& sGetFileName(void) const;
+	bool bIsVariableStep(void) const;
+	integer iGetNumColumns(void) const;
+	integer iGetNumSteps(void) const;
+	doublereal dGetInitialTime(void) const;
+	doublereal dGetTimeStep(void) const;
+
+	/* column i, 0-based */
+	const doublereal *pGetColumn(integer i) const;
+
+	/* makes sure step iStep lies within the resident window,
+	 * moving the window if needed */
+	inline void Touch(integer iStep);
+	void MoveWindow(integer iStep);
+};
+
+inline void
+BinDriveFile::Touch(integer iStep)
+{
+	if (iStep < iWinBegin || iStep >= iWinEnd) {
+		MoveWindow(iStep);
+	}
+}
+
+/* BinDriveFile - end */
+
+#endif /* BINDRV_H */
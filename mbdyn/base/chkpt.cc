@@ -0,0 +1,352 @@
+/* $Header$ */
+/*
+ * MBDyn (C) is a multibody analysis code.
+ * http://www.mbdyn.org
+ *
+ * Copyright (C) 1996-2023
+ *
+ * Pierangelo Masarati	<pierangelo.masarati@polimi.it>
+ * Paolo Mantegazza	<paolo.mantegazza@polimi.it>
+ *
+ * Dipartimento di Ingegneria Aerospaziale - Politecnico di Milano
+ * via La Masa, 34 - 20156 Milano, Italy
+ * http://www.aero.polimi.it
+ *
+ * Changing this copyright notice is forbidden.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation (version 2 of the License).
+ *
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* binary checkpoint I/O */
+
+#include "mbconfig.h"           /* This goes first in every *.c,*.cc file */
+
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif /* HAVE_SYS_MMAN_H */
+
+#include "except.h"
+#include "chkpt.h"
+
+/* CheckpointWriter - begin */
+
+CheckpointWriter::Buf::int_type
+CheckpointWriter::Buf::overflow(int_type c)
+{
+	if (traits_type::eq_int_type(c, traits_type::eof())) {
+		return traits_type::not_eof(c);
+	}
+
+	pStr->push_back(traits_type::to_char_type(c));
+
+	return c;
+}
+
+std::streamsize
+CheckpointWriter::Buf::xsputn(const char *s, std::streamsize n)
+{
+	pStr->append(s, n);
+
+	return n;
+}
+
+CheckpointWriter::CheckpointWriter(const std::string& sFileName)
+: sFileName(sFileName),
+pFill(&Images[0]),
+pWrite(0),
+FillStream(&FillBuf)
+#ifdef HAVE_THREADS
+, bStop(false)
+#endif /* HAVE_THREADS */
+{
+	FillBuf.Set(pFill);
+
+#ifdef HAVE_THREADS
+	IOThread = std::thread(&CheckpointWriter::IOThreadFunc, this);
+#endif /* HAVE_THREADS */
+}
+
+CheckpointWriter::~CheckpointWriter(void)
+{
+	try {
+		Flush();
+
+	} catch (...) {
+		silent_cerr("CheckpointWriter: unable to write checkpoint "
+			"\"" << sFileName << "\"" << std::endl);
+	}
+
+#ifdef HAVE_THREADS
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		bStop = true;
+	}
+	cond.notify_all();
+	IOThread.join();
+#endif /* HAVE_THREADS */
+}
+
+#ifdef HAVE_THREADS
+void
+CheckpointWriter::IOThreadFunc(void)
+{
+	std::unique_lock<std::mutex> lock(mtx);
+
+	while (true) {
+		cond.wait(lock, [this] { return pWrite != 0 || bStop; });
+		if (pWrite == 0) {
+			break;
+		}
+
+		std::string *pImage = pWrite;
+		lock.unlock();
+
+		try {
+			Write(sFileName, *pImage);
+
+		} catch (...) {
+			except = std::current_exception();
+		}
+
+		lock.lock();
+		pWrite = 0;
+		cond.notify_all();
+	}
+}
+#endif /* HAVE_THREADS */
+
+void
+CheckpointWriter::Write(const std::string& sFileName, const std::string& s)
+{
+	/* write a temporary file, then rename it, so that the previous
+	 * checkpoint is replaced only when the new one is complete */
+	std::string sTmpFileName(sFileName + ".tmp");
+	int fd = ::open(sTmpFileName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+	if (fd == -1) {
+		int save_errno = errno;
+		silent_cerr("CheckpointWriter: unable to open file "
+			"\"" << sTmpFileName << "\" "
+			"(" << save_errno << ": " << strerror(save_errno) << ")"
+			<< std::endl);
+		throw ErrFile(MBDYN_EXCEPT_ARGS);
+	}
+
+	const char *p = s.data();
+	size_t n = s.size();
+	while (n > 0) {
+		ssize_t rc = ::write(fd, p, n);
+		if (rc == -1) {
+			if (errno == EINTR) {
+				continue;
+			}
+			break;
+		}
+		p += rc;
+		n -= rc;
+	}
+
+	if (n > 0 || fsync(fd) == -1) {
+		int save_errno = errno;
+		(void)::close(fd);
+		silent_cerr("CheckpointWriter: unable to write file "
+			"\"" << sTmpFileName << "\" "
+			"(" << save_errno << ": " << strerror(save_errno) << ")"
+			<< std::endl);
+		throw ErrFile(MBDYN_EXCEPT_ARGS);
+	}
+
+	if (::close(fd) == -1) {
+		int save_errno = errno;
+		silent_cerr("CheckpointWriter: unable to close file "
+			"\"" << sTmpFileName << "\" "
+			"(" << save_errno << ": " << strerror(save_errno) << ")"
+			<< std::endl);
+		throw ErrFile(MBDYN_EXCEPT_ARGS);
+	}
+
+	if (rename(sTmpFileName.c_str(), sFileName.c_str()) != 0) {
+		int save_errno = errno;
+		silent_cerr("CheckpointWriter: unable to rename file "
+			"\"" << sTmpFileName << "\" "
+			"as \"" << sFileName << "\" "
+			"(" << save_errno << ": " << strerror(save_errno) << ")"
+			<< std::endl);
+		throw ErrFile(MBDYN_EXCEPT_ARGS);
+	}
+}
+
+void
+CheckpointWriter::Wait(void)
+{
+#ifdef HAVE_THREADS
+	std::unique_lock<std::mutex> lock(mtx);
+	cond.wait(lock, [this] { return pWrite == 0; });
+#endif /* HAVE_THREADS */
+
+	if (except) {
+		std::exception_ptr e = except;
+		except = nullptr;
+		std::rethrow_exception(e);
+	}
+}
+
+std::ostream&
+CheckpointWriter::Stream(void)
+{
+	pFill->clear();
+	FillStream.clear();
+
+	return FillStream;
+}
+
+void
+CheckpointWriter::Commit(void)
+{
+	/* wait for the previous checkpoint, then swap the images */
+	Wait();
+
+#ifdef HAVE_THREADS
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		pWrite = pFill;
+	}
+	cond.notify_all();
+#else /* ! HAVE_THREADS */
+	Write(sFileName, *pFill);
+#endif /* ! HAVE_THREADS */
+
+	pFill = (pFill == &Images[0]) ? &Images[1] : &Images[0];
+	FillBuf.Set(pFill);
+}
+
+void
+CheckpointWriter::Flush(void)
+{
+	Wait();
+}
+
+/* CheckpointWriter - end */
+
+/* CheckpointReader - begin */
+
+void
+CheckpointReader::Buf::Set(const char *p, size_t n)
+{
+	/* read only: the get area is never written through */
+	char *pc = const_cast<char *>(p);
+	setg(pc, pc, pc + n);
+}
+
+CheckpointReader::CheckpointReader(const std::string& sFileName)
+: sFileName(sFileName),
+pMap(0),
+uSize(0),
+uPos(0),
+WinStream(&WinBuf)
+{
+	int fd = ::open(sFileName.c_str(), O_RDONLY);
+	if (fd == -1) {
+		int save_errno = errno;
+		silent_cerr("CheckpointReader: unable to open file "
+			"\"" << sFileName << "\" "
+			"(" << save_errno << ": " << strerror(save_errno) << ")"
+			<< std::endl);
+		throw ErrFile(MBDYN_EXCEPT_ARGS);
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) == -1) {
+		int save_errno = errno;
+		(void)::close(fd);
+		silent_cerr("CheckpointReader: unable to stat file "
+			"\"" << sFileName << "\" "
+			"(" << save_errno << ": " << strerror(save_errno) << ")"
+			<< std::endl);
+		throw ErrFile(MBDYN_EXCEPT_ARGS);
+	}
+	uSize = st.st_size;
+
+#ifdef HAVE_SYS_MMAN_H
+	if (uSize > 0) {
+		void *p = mmap(0, uSize, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (p != MAP_FAILED) {
+			pMap = (const char *)p;
+		}
+	}
+#endif /* HAVE_SYS_MMAN_H */
+
+	if (pMap == 0) {
+		/* no mmap(2): read the whole file */
+		Tmp.resize(uSize);
+		size_t n = 0;
+		while (n < uSize) {
+			ssize_t rc = ::read(fd, &Tmp[n], uSize - n);
+			if (rc <= 0) {
+				if (rc == -1 && errno == EINTR) {
+					continue;
+				}
+				break;
+			}
+			n += rc;
+		}
+		uSize = n;
+	}
+
+	(void)::close(fd);
+}
+
+CheckpointReader::~CheckpointReader(void)
+{
+#ifdef HAVE_SYS_MMAN_H
+	if (pMap != 0) {
+		(void)munmap((void *)pMap, uSize);
+	}
+#endif /* HAVE_SYS_MMAN_H */
+}
+
+const char *
+CheckpointReader::pGet(size_t n)
+{
+	if (n > uSize - uPos) {
+		return 0;
+	}
+
+	const char *p = (pMap != 0 ? pMap : Tmp.data()) + uPos;
+	uPos += n;
+
+	return p;
+}
+
+std::istream *
+CheckpointReader::pGetStream(size_t n)
+{
+	const char *p = pGet(n);
+	if (p == 0) {
+		return 0;
+	}
+
+	WinBuf.Set(p, n);
+	WinStream.clear();
+
+	return &WinStream;
+}
+
+/* CheckpointReader - end */
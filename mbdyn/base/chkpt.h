@@ -0,0 +1,169 @@
+/* $Header$ */
+/*
+ * MBDyn (C) is a multibody analysis code.
+ * http://www.mbdyn.org
+ *
+ * Copyright (C) 1996-2023
+ *
+ * Pierangelo Masarati	<pierangelo.masarati@polimi.it>
+ * Paolo Mantegazza	<paolo.mantegazza@polimi.it>
+ *
+ * Dipartimento di Ingegneria Aerospaziale - Politecnico di Milano
+ * via La Masa, 34 - 20156 Milano, Italy
+ * http://www.aero.polimi.it
+ *
+ * Changing this copyright notice is forbidden.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation (version 2 of the License).
+ *
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* binary checkpoint I/O */
+
+#ifndef CHKPT_H
+#define CHKPT_H
+
+#include <cstring>
+#include <string>
+#include <streambuf>
+#include <istream>
+#include <ostream>
+#include <exception>
+#ifdef HAVE_THREADS
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#endif /* HAVE_THREADS */
+
+#include "myassert.h"
+
+/* CheckpointWriter - begin */
+
+/*
+ * The solver serializes the checkpoint in memory (see Stream());
+ * Commit() hands the image to a dedicated I/O thread (if available),
+ * which writes it to a temporary file and renames it over the previous
+ * checkpoint, so the file on disk is always complete.
+ * At most two images exist at a time, the one being filled
+ * and the one being written: when a new checkpoint is due
+ * while the previous one is still being written, the solver waits.
+ * Errors of the I/O thread are rethrown by the next Commit() or Flush().
+ */
+class CheckpointWriter {
+protected:
+	/* appends to a std::string, without the copy of std::ostringstream */
+	class Buf : public std::streambuf {
+	protected:
+		std::string *pStr;
+
+		virtual int_type overflow(int_type c);
+		virtual std::streamsize xsputn(const char *s, std::streamsize n);
+
+	public:
+		Buf(void) : pStr(0) { NO_OP; };
+		void Set(std::string *p) { pStr = p; };
+	};
+
+	std::string sFileName;
+
+	std::string Images[2];
+	/* being filled by the solver */
+	std::string *pFill;
+	/* being written by the I/O thread, or 0 */
+	std::string *pWrite;
+
+	Buf FillBuf;
+	std::ostream FillStream;
+
+	std::exception_ptr except;
+
+#ifdef HAVE_THREADS
+	std::thread IOThread;
+	std::mutex mtx;
+	std::condition_variable cond;
+	bool bStop;
+
+	void IOThreadFunc(void);
+#endif /* HAVE_THREADS */
+
+	static void Write(const std::string& sFileName, const std::string& s);
+
+	/* waits until the I/O thread is idle */
+	void Wait(void);
+
+public:
+	CheckpointWriter(const std::string& sFileName);
+	~CheckpointWriter(void);
+
+	/* empty stream the next checkpoint is serialized into */
+	std::ostream& Stream(void);
+
+	/* writes what was serialized into Stream() */
+	void Commit(void);
+
+	/* returns when the last checkpoint is on disk */
+	void Flush(void);
+};
+
+/* CheckpointWriter - end */
+
+/* CheckpointReader - begin */
+
+/*
+ * Maps a checkpoint file in memory (or reads it whole, without mmap(2));
+ * records are read in place through an std::istream
+ * over a window of the image.
+ */
+class CheckpointReader {
+protected:
+	class Buf : public std::streambuf {
+	public:
+		void Set(const char *p, size_t n);
+	};
+
+	std::string sFileName;
+	const char *pMap;
+	size_t uSize;
+	std::string Tmp;
+	size_t uPos;
+
+	Buf WinBuf;
+	std::istream WinStream;
+
+public:
+	CheckpointReader(const std::string& sFileName);
+	~CheckpointReader(void);
+
+	const std::string& sGetFileName(void) const { return sFileName; };
+
+	/* pointer to the next n bytes, which are skipped; 0 if truncated */
+	const char *pGet(size_t n);
+
+	/* stream over the next n bytes, which are skipped; 0 if truncated */
+	std::istream *pGetStream(size_t n);
+
+	template <class T>
+	bool Get(T& t) {
+		const char *p = pGet(sizeof(T));
+		if (p == 0) {
+			return false;
+		}
+		memcpy(&t, p, sizeof(T));
+		return true;
+	};
+};
+
+/* CheckpointReader - end */
+
+#endif /* CHKPT_H */
@@ -38,8 +38,15 @@ extern "C" {
 #include <time.h>
 }
 
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
 #include "dataman.h"
 #include "fdjac.h"
+#include "chkpt.h"
 #include "friction.h"
 
 #if defined(USE_RUNTIME_LOADING) && defined(HAVE_LTDL_H)
@@ -143,10 +150,20 @@ iCurrRestartIter(0),
 dLastRestartTime(dInitialTime),
 saveXSol(false),
 solArrFileName(0),
+CheckpointEvery(NEVER),
+iCheckpointIterations(0),
+dCheckpointTime(0.),
+iCurrCheckpointIter(0),
+dLastCheckpointTime(dInitialTime),
+pChkWriter(0),
+bResumed(false),
+dResumeTime(0.),
+dResumeTimeStep(0.),
 pOutputMeter(0),
 bOutputNextStep(false),
 iOutputCount(0),
 pFDJac(nullptr),
+pElemProf(nullptr),
 ResMode(RES_TEXT),
 #ifdef USE_NETCDF
 // NetCDF stuff
@@ -154,6 +171,7 @@ ResMode(RES_TEXT),
 NetCDF_Format(netCDF::NcFile::classic),
 bNetCDFsync(false),
 bNetCDFnoText(false),
+bNetCDFbuffered(false),
 #endif // USE_NETCDF
 od(EULER_123),
 
@@ -634,6 +652,24 @@ DataManager::~DataManager(void)
 		MakeRestart();
 	}
 
+	/* never throw from here: a failed checkpoint is only reported */
+	if (CheckpointEvery == ATEND) {
+		try {
+			MakeCheckpoint();
+
+		} catch (...) {
+			silent_cerr("DataManager::~DataManager(): "
+				"unable to make checkpoint "
+				"\"" << sCheckpointFileName << "\"" << std::endl);
+		}
+	}
+
+	if (pChkWriter) {
+		/* waits for the last checkpoint to be written */
+		SAFEDELETE(pChkWriter);
+		pChkWriter = 0;
+	}
+
 	if (sSimulationTitle != 0) {
 		SAFEDELETEARR(sSimulationTitle);
 		sSimulationTitle = 0;
@@ -654,6 +690,13 @@ DataManager::~DataManager(void)
 		pRBK = 0;
 	}
 
+	if (pElemProf) {
+		OutHdl.Open(OutputHandler::PROFILE);
+		pElemProf->Output(OutHdl.Profile());
+		SAFEDELETE(pElemProf);
+		pElemProf = nullptr;
+	}
+
 	ElemManagerDestructor();
 	NodeManagerDestructor();
 	DofManagerDestructor();
@@ -838,6 +881,240 @@ void DataManager::MakeRestart(void)
 	OutHdl.Close(OutputHandler::RESTART);
 }
 
+/*
+ * Binary checkpoint:
+ *
+ *	header (CheckpointHeader)
+ *	X, XP (iNumDofs doublereal each)
+ *	for each node, then each element with internal state,
+ *		record (CheckpointRecord) followed by uSize bytes
+ *	end record (iKind == CHECKPOINT_END)
+ *
+ * The file is native-endian; it is meant to resume a run
+ * on the same platform, with the same model.
+ */
+
+static const char sCheckpointTag[8] = { 'M', 'B', 'D', 'Y', 'N', 'C', 'H', 'K' };
+static const uint32_t uCheckpointVersion = 1;
+
+struct CheckpointHeader {
+	char sTag[8];
+	uint32_t uVersion;
+	uint32_t uSizeofReal;
+	int64_t iNumDofs;
+	int64_t iStep;
+	doublereal dTime;
+	doublereal dTimeStep;
+};
+
+enum {
+	CHECKPOINT_END = 0,
+	CHECKPOINT_NODE = 1,
+	CHECKPOINT_ELEM = 2
+};
+
+struct CheckpointRecord {
+	int32_t iKind;
+	int32_t iType;
+	uint32_t uLabel;
+	uint32_t uPad;
+	uint64_t uSize;
+};
+
+/* one record per entity with internal state */
+static void
+CheckpointEntity(std::ostream& out, std::ostringstream& buf,
+	int32_t iKind, int32_t iType, unsigned uLabel,
+	const SimulationEntity *pSE)
+{
+	buf.str(std::string());
+	buf.clear();
+	pSE->Checkpoint(buf);
+
+	const std::string& s(buf.str());
+	if (s.empty()) {
+		return;
+	}
+
+	CheckpointRecord r = { iKind, iType, uLabel, 0, s.size() };
+	CheckpointPut(out, r);
+	out.write(s.data(), s.size());
+}
+
+void
+DataManager::MakeCheckpoint(void) const
+{
+	ASSERT(pChkWriter != 0);
+
+	/* the checkpoint is serialized in memory by the solver,
+	 * then written by the I/O thread of the CheckpointWriter */
+	std::ostream& out = pChkWriter->Stream();
+
+	CheckpointHeader h;
+	memset(&h, 0, sizeof(h));
+	memcpy(h.sTag, sCheckpointTag, sizeof(h.sTag));
+	h.uVersion = uCheckpointVersion;
+	h.uSizeofReal = sizeof(doublereal);
+	h.iNumDofs = pXCurr->iGetSize();
+	h.iStep = DrvHdl.iGetStep();
+	h.dTime = DrvHdl.dGetTime();
+	h.dTimeStep = DrvHdl.dGetTimeStep();
+	CheckpointPut(out, h);
+
+	out.write((const char *)pXCurr->pdGetVec(), h.iNumDofs*sizeof(doublereal));
+	out.write((const char *)pXPrimeCurr->pdGetVec(), h.iNumDofs*sizeof(doublereal));
+
+	std::ostringstream buf;
+	for (NodeVecType::const_iterator n = Nodes.begin(); n != Nodes.end(); ++n) {
+		CheckpointEntity(out, buf, CHECKPOINT_NODE,
+			(*n)->GetNodeType(), (*n)->GetLabel(), *n);
+	}
+
+	for (ElemVecType::const_iterator e = Elems.begin(); e != Elems.end(); ++e) {
+		CheckpointEntity(out, buf, CHECKPOINT_ELEM,
+			(*e)->GetElemType(), (*e)->GetLabel(), *e);
+	}
+
+	CheckpointRecord r = { CHECKPOINT_END, 0, 0, 0, 0 };
+	CheckpointPut(out, r);
+
+	pChkWriter->Commit();
+}
+
+void
+DataManager::ResumeCheckpoint(VectorHandler& X, VectorHandler& XP)
+{
+	/* the file is mapped, and each record is read in place */
+	CheckpointReader in(sResumeFileName);
+
+	CheckpointHeader h;
+	if (!in.Get(h)
+		|| memcmp(h.sTag, sCheckpointTag, sizeof(h.sTag)) != 0
+		|| h.uVersion != uCheckpointVersion
+		|| h.uSizeofReal != sizeof(doublereal))
+	{
+		silent_cerr("DataManager::ResumeCheckpoint(): "
+			"file \"" << sResumeFileName << "\" "
+			"is not a valid checkpoint" << std::endl);
+		throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+	}
+
+	if (h.iNumDofs != X.iGetSize()) {
+		silent_cerr("DataManager::ResumeCheckpoint(): "
+			"checkpoint \"" << sResumeFileName << "\" "
+			"has " << h.iNumDofs << " dofs, "
+			"model has " << X.iGetSize() << std::endl);
+		throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+	}
+
+	const size_t uVecSize = h.iNumDofs*sizeof(doublereal);
+	const char *pX = in.pGet(uVecSize);
+	const char *pXP = in.pGet(uVecSize);
+	if (pX == 0 || pXP == 0) {
+		silent_cerr("DataManager::ResumeCheckpoint(): "
+			"checkpoint \"" << sResumeFileName << "\" "
+			"is truncated" << std::endl);
+		throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+	}
+	memcpy(X.pdGetVec(), pX, uVecSize);
+	memcpy(XP.pdGetVec(), pXP, uVecSize);
+
+	std::vector<Node *> ResumedNodes;
+	for (;;) {
+		CheckpointRecord r;
+		if (!in.Get(r)) {
+			silent_cerr("DataManager::ResumeCheckpoint(): "
+				"checkpoint \"" << sResumeFileName << "\" "
+				"is truncated" << std::endl);
+			throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+		}
+
+		if (r.iKind == CHECKPOINT_END) {
+			break;
+		}
+
+		SimulationEntity *pSE = 0;
+		const char *sName = 0;
+		switch (r.iKind) {
+		case CHECKPOINT_NODE:
+			if (r.iType >= 0 && r.iType < Node::LASTNODETYPE) {
+				Node *pNode = pFindNode(Node::Type(r.iType), r.uLabel);
+				if (pNode != 0) {
+					ResumedNodes.push_back(pNode);
+				}
+				pSE = pNode;
+				sName = psNodeNames[r.iType];
+			}
+			break;
+
+		case CHECKPOINT_ELEM:
+			if (r.iType >= 0 && r.iType < Elem::LASTELEMTYPE) {
+				pSE = pFindElem(Elem::Type(r.iType), r.uLabel);
+				sName = psElemNames[r.iType];
+			}
+			break;
+		}
+
+		if (pSE == 0) {
+			silent_cerr("DataManager::ResumeCheckpoint(): "
+				"checkpoint \"" << sResumeFileName << "\": ");
+			if (sName == 0) {
+				silent_cerr("invalid record" << std::endl);
+
+			} else {
+				silent_cerr(sName << "(" << r.uLabel << ") "
+					"not defined in model" << std::endl);
+			}
+			throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+		}
+
+		std::istream *pIs = in.pGetStream(r.uSize);
+		if (pIs == 0) {
+			silent_cerr("DataManager::ResumeCheckpoint(): "
+				"checkpoint \"" << sResumeFileName << "\" "
+				"is truncated" << std::endl);
+			throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+		}
+
+		pSE->Resume(*pIs);
+		if (!*pIs || pIs->peek() != std::istream::traits_type::eof()) {
+			silent_cerr("DataManager::ResumeCheckpoint(): "
+				"checkpoint \"" << sResumeFileName << "\": "
+				"state of " << sName << "(" << r.uLabel << ") "
+				"does not match" << std::endl);
+			throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+		}
+	}
+
+	/* nodes that keep their state outside X (e.g. the orientation
+	 * of structural nodes) re-derive their part of X and XP */
+	for (std::vector<Node *>::iterator n = ResumedNodes.begin();
+		n != ResumedNodes.end(); ++n)
+	{
+		(*n)->SetValue(this, X, XP);
+	}
+
+	bResumed = true;
+	dResumeTime = h.dTime;
+	dResumeTimeStep = h.dTimeStep;
+	dLastCheckpointTime = h.dTime;
+
+	silent_cout("Resuming from checkpoint \"" << sResumeFileName << "\" "
+		"at time " << h.dTime << " (step " << h.iStep << ", "
+		"time step " << h.dTimeStep << ")" << std::endl);
+}
+
+bool
+DataManager::bGetResumeTime(doublereal& dTime, doublereal& dTimeStep) const
+{
+	if (bResumed) {
+		dTime = dResumeTime;
+		dTimeStep = dResumeTimeStep;
+	}
+
+	return bResumed;
+}
+
 NamedValue *
 DataManager::InsertSym(const char* const s, const Real& v, int redefine)
 {
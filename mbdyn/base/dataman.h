@@ -54,6 +54,7 @@
 #include "veciter.h"
 
 #include "elem.h"      /* Classe di base di tutti gli elementi */
+#include "elemprof.h"
 #include "driven.h"
 #include "output.h"
 
@@ -79,6 +80,7 @@ struct LoadableCalls;
 class Solver;
 
 class FiniteDifferenceJacobianBase;
+class CheckpointWriter;
 #include "datamanforward.h"
 /* DataManager - begin */
 
@@ -176,6 +178,19 @@ protected:
 	bool saveXSol;
 	char * solArrFileName;
 
+	/* binary checkpoint stuff */
+	eRestart CheckpointEvery;
+	integer iCheckpointIterations;
+	doublereal dCheckpointTime;
+	mutable integer iCurrCheckpointIter;
+	mutable doublereal dLastCheckpointTime;
+	std::string sCheckpointFileName;
+	CheckpointWriter *pChkWriter;
+	std::string sResumeFileName;
+	bool bResumed;
+	doublereal dResumeTime;
+	doublereal dResumeTimeStep;
+
 	/* raw output stuff */
 	DriveCaller *pOutputMeter;
         mutable bool bOutputNextStep; // Save the last positive result from pOutputMeter->dGet()
@@ -184,8 +199,15 @@ protected:
 protected:
         FiniteDifferenceJacobianBase* pFDJac;
 
+	/* per-element profiling (optional) */
+	ElemProfiler *pElemProf;
+
 public:
-        void FDJacCheck(const NonlinearProblem* pNLP, const MatrixHandler* pJac);
+        void FDJacCheck(const NonlinearProblem* pNLP, MatrixHandler* pJac, doublereal dCoef);
+
+	/* contributions of a single element, e.g. for the finite difference Jacobian */
+	const SubVectorHandler& ElemAssRes(Elem* pEl, doublereal dCoef);
+	const VariableSubMatrixHandler& ElemAssJac(Elem* pEl, doublereal dCoef);
 	/* specialized output stuff */
 public:
 	enum ResType {
@@ -205,6 +227,8 @@ protected:
 	netCDF::NcFile::FileFormat NetCDF_Format;
 	bool bNetCDFsync;
 	bool bNetCDFnoText;
+	bool bNetCDFbuffered;
+	NcOutputBuffer::Params NetCDFBufParams;
 	MBDynNcVar Var_Step;
 	MBDynNcVar Var_Time;
 	MBDynNcVar Var_TimeStep;
@@ -413,6 +437,37 @@ protected:
 		SubVectorHandler& WorkVec);
 	// end of inverse dynamics
 
+	/* per-entity passes over the nodes and the elements
+	 * visited by the iterators */
+	void NodesBeforePredict(VecIter<Node *> &Iter,
+		VectorHandler& X, VectorHandler& XP,
+		std::deque<VectorHandler*>& qXPr,
+		std::deque<VectorHandler*>& qXPPr) const;
+	void ElemsBeforePredict(VecIter<Elem *> &Iter,
+		VectorHandler& X, VectorHandler& XP,
+		std::deque<VectorHandler*>& qXPr,
+		std::deque<VectorHandler*>& qXPPr) const;
+	void NodesAfterPredict(VecIter<Node *> &Iter) const;
+	void ElemsAfterPredict(VecIter<Elem *> &Iter) const;
+	void NodesUpdate(VecIter<Node *> &Iter) const;
+	void ElemsUpdate(VecIter<Elem *> &Iter) const;
+	void NodesAfterConvergence(VecIter<Node *> &Iter) const;
+	void ElemsAfterConvergence(VecIter<Elem *> &Iter) const;
+	void NodesDerivativesUpdate(VecIter<Node *> &Iter) const;
+	void ElemsDerivativesUpdate(VecIter<Elem *> &Iter) const;
+
+	/* reset any external convergence requirement */
+	void ConvergedReset(void) const;
+
+	/* conditional restart, after convergence */
+	void AfterConvergenceRestart(void) const;
+
+	/* conditional checkpoint, after convergence */
+	void AfterConvergenceCheckpoint(void) const;
+
+	/* reads the checkpoint in sResumeFileName, after SetValue() */
+	void ResumeCheckpoint(VectorHandler& X, VectorHandler& XP);
+
 protected:
 	typedef std::vector<Converged::State> Converged_t;
 	mutable Converged_t m_IsConverged;
@@ -482,8 +537,13 @@ public:
 	/* Prepara la soluzione con i valori iniziali */
 	void SetValue(VectorHandler& X, VectorHandler& XP);
 
+	/* true if resuming from a checkpoint;
+	 * dTime and dTimeStep are its time and time step */
+	bool bGetResumeTime(doublereal& dTime, doublereal& dTimeStep) const;
+
 	/* Funzioni di aggiornamento dati durante la simulazione */
 	virtual void MakeRestart(void);
+	virtual void MakeCheckpoint(void) const;
 	virtual void DerivativesUpdate(void) const;
 	virtual void BeforePredict(VectorHandler& X, VectorHandler& XP,
 		std::deque<VectorHandler*>& qXPr,
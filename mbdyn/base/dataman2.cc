@@ -1494,6 +1494,10 @@ DataManager::SetValue(VectorHandler& X, VectorHandler& XP)
 		SAFEDELETEARR(solArrFileName);
 		fp.close();
 	}
+
+	if (!sResumeFileName.empty()) {
+		ResumeCheckpoint(X, XP);
+	}
 } /* End of SetValue */
 
 
@@ -1521,6 +1525,15 @@ DataManager::OutputPrepare(void)
 
 	/* Dati degli elementi */
 	ElemOutputPrepare(OutHdl);
+
+#ifdef USE_NETCDF
+	/* static data are written; from now on records can be staged */
+	if (OutHdl.UseNetCDF(OutputHandler::NETCDF) && bNetCDFbuffered) {
+		NcOutputBuffer::Params params(NetCDFBufParams);
+		params.bSync = bNetCDFsync;
+		OutHdl.NetCDFSetBuffered(params);
+	}
+#endif /* USE_NETCDF */
 }
 
 /* Output setup for Eigenanalysis parameters */
@@ -2383,9 +2396,8 @@ DataManager::Output(long lStep,
 
 	OutHdl.IncCurrentStep();
 #ifdef USE_NETCDF
-	if (bNetCDFsync) {
-		OutHdl.pGetBinFile()->sync(); // only works with netcdf-cxx4 >= 4.3.0, check implemented in configure.ac (see also https://github.com/Unidata/netcdf-cxx4/commit/e013ab35f0219fff92ed8237d2f385e89fd1cf77#diff-59778321f93df82ff613be3e32d9a3ec)
-
+	if (OutHdl.UseNetCDF(OutputHandler::NETCDF)) {
+		OutHdl.NetCDFEndOfStep(bNetCDFsync);
 	}
 #endif /* USE_NETCDF */
 
@@ -2436,46 +2448,86 @@ DataManager::BeforePredict(VectorHandler& X, VectorHandler& XP,
 	std::deque<VectorHandler*>& qXPr,
 	std::deque<VectorHandler*>& qXPPr) const
 {
-	for (NodeVecType::const_iterator i = Nodes.begin(); i != Nodes.end(); ++i) {
-		(*i)->BeforePredict(X, XP, qXPr, qXPPr);
+	NodesBeforePredict(NodeIter, X, XP, qXPr, qXPPr);
+	ElemsBeforePredict(ElemIter, X, XP, qXPr, qXPPr);
+}
+
+void
+DataManager::NodesBeforePredict(VecIter<Node *> &Iter,
+	VectorHandler& X, VectorHandler& XP,
+	std::deque<VectorHandler*>& qXPr,
+	std::deque<VectorHandler*>& qXPPr) const
+{
+	Node* pNd = NULL;
+	if (Iter.bGetFirst(pNd)) {
+		do {
+			pNd->BeforePredict(X, XP, qXPr, qXPPr);
+		} while (Iter.bGetNext(pNd));
 	}
+}
 
-	/* Versione con iteratore: */
+void
+DataManager::ElemsBeforePredict(VecIter<Elem *> &Iter,
+	VectorHandler& X, VectorHandler& XP,
+	std::deque<VectorHandler*>& qXPr,
+	std::deque<VectorHandler*>& qXPPr) const
+{
 	Elem* pEl = NULL;
-	if (ElemIter.bGetFirst(pEl)) {
+	if (Iter.bGetFirst(pEl)) {
 		do {
 			pEl->BeforePredict(X, XP, qXPr, qXPPr);
-		} while (ElemIter.bGetNext(pEl));
+		} while (Iter.bGetNext(pEl));
 	}
 }
 
 void
-DataManager::AfterPredict(void) const
+DataManager::ConvergedReset(void) const
 {
-	/* reset any external convergence requirement before starting
-	 * a new step */
 	for (Converged_t::iterator i = m_IsConverged.begin();
 		i != m_IsConverged.end(); ++i)
 	{
 		*i = Converged::NOT_CONVERGED;
 	}
+}
 
-	for (NodeVecType::const_iterator i = Nodes.begin(); i != Nodes.end(); ++i) {
-		try {
-			(*i)->AfterPredict(*pXCurr, *pXPrimeCurr);
-		}
-		catch (Elem::ChangedEquationStructure& e) {
-			// ignore by now
-			silent_cerr("DataManager::AfterPredict: "
-				"warning, caught Elem::ChangedEquationStructure while processing "
-				<< psNodeNames[(*i)->GetNodeType()] << "(" << (*i)->GetLabel() << ")" << std::endl);
-		}
+void
+DataManager::AfterPredict(void) const
+{
+	/* reset any external convergence requirement before starting
+	 * a new step */
+	ConvergedReset();
+
+	NodesAfterPredict(NodeIter);
+	ElemsAfterPredict(ElemIter);
+}
+
+void
+DataManager::NodesAfterPredict(VecIter<Node *> &Iter) const
+{
+	Node* pNd = NULL;
+	if (Iter.bGetFirst(pNd)) {
+		do {
+			try {
+				pNd->AfterPredict(*pXCurr, *pXPrimeCurr);
+			}
+			catch (Elem::ChangedEquationStructure& e) {
+				// ignore by now
+				silent_cerr("DataManager::AfterPredict: "
+					"warning, caught Elem::ChangedEquationStructure while processing "
+					<< psNodeNames[pNd->GetNodeType()] << "(" << pNd->GetLabel() << ")" << std::endl);
+			}
+		} while (Iter.bGetNext(pNd));
 	}
+}
 
-	Elem* pEl = 0;
-	if (ElemIter.bGetFirst(pEl)) {
+void
+DataManager::ElemsAfterPredict(VecIter<Elem *> &Iter) const
+{
+	Elem* pEl = NULL;
+	if (Iter.bGetFirst(pEl)) {
 		do {
 			try {
+				ElemProfiler::Timer t(pElemProf, pEl, ElemProfiler::AFTERPREDICT);
 				pEl->AfterPredict(*pXCurr, *pXPrimeCurr);
 			}
 			catch (Elem::ChangedEquationStructure& e) {
@@ -2484,42 +2536,76 @@ DataManager::AfterPredict(void) const
 					"warning, caught Elem::ChangedEquationStructure while processing "
 					<< psElemNames[pEl->GetElemType()] << "(" << pEl->GetLabel() << ")" << std::endl);
 			}
-		} while (ElemIter.bGetNext(pEl));
+		} while (Iter.bGetNext(pEl));
 	}
 }
 
 void
 DataManager::Update(void) const
 {
-	for (NodeVecType::const_iterator i = Nodes.begin(); i != Nodes.end(); ++i) {
-		(*i)->Update(*pXCurr, *pXPrimeCurr);
+	NodesUpdate(NodeIter);
+	ElemsUpdate(ElemIter);
+}
+
+void
+DataManager::NodesUpdate(VecIter<Node *> &Iter) const
+{
+	Node* pNd = NULL;
+	if (Iter.bGetFirst(pNd)) {
+		do {
+			pNd->Update(*pXCurr, *pXPrimeCurr);
+		} while (Iter.bGetNext(pNd));
 	}
+}
 
-	/* Versione con iteratore: */
+void
+DataManager::ElemsUpdate(VecIter<Elem *> &Iter) const
+{
 	Elem* pEl = NULL;
-	if (ElemIter.bGetFirst(pEl)) {
+	if (Iter.bGetFirst(pEl)) {
 		do {
+			ElemProfiler::Timer t(pElemProf, pEl, ElemProfiler::UPDATE);
 			pEl->Update(*pXCurr, *pXPrimeCurr);
-		} while (ElemIter.bGetNext(pEl));
+		} while (Iter.bGetNext(pEl));
 	}
 }
 
 void
 DataManager::AfterConvergence(void) const
 {
-	for (NodeVecType::const_iterator i = Nodes.begin(); i != Nodes.end(); ++i) {
-		(*i)->AfterConvergence(*pXCurr, *pXPrimeCurr);
+	NodesAfterConvergence(NodeIter);
+	ElemsAfterConvergence(ElemIter);
+
+	AfterConvergenceRestart();
+	AfterConvergenceCheckpoint();
+}
+
+void
+DataManager::NodesAfterConvergence(VecIter<Node *> &Iter) const
+{
+	Node* pNd = NULL;
+	if (Iter.bGetFirst(pNd)) {
+		do {
+			pNd->AfterConvergence(*pXCurr, *pXPrimeCurr);
+		} while (Iter.bGetNext(pNd));
 	}
+}
 
-	/* Versione con iteratore: */
+void
+DataManager::ElemsAfterConvergence(VecIter<Elem *> &Iter) const
+{
 	Elem* pEl = NULL;
-	if (ElemIter.bGetFirst(pEl)) {
+	if (Iter.bGetFirst(pEl)) {
 		do {
 			pEl->AfterConvergence(*pXCurr,
 				*pXPrimeCurr);
-		} while (ElemIter.bGetNext(pEl));
+		} while (Iter.bGetNext(pEl));
 	}
+}
 
+void
+DataManager::AfterConvergenceRestart(void) const
+{
 	/* Restart condizionato */
 	switch (RestartEvery) {
 	case NEVER:
@@ -2563,20 +2649,58 @@ DataManager::AfterConvergence(void) const
 	}
 }
 
+void
+DataManager::AfterConvergenceCheckpoint(void) const
+{
+	/* Checkpoint condizionato */
+	switch (CheckpointEvery) {
+	case ITERATIONS:
+		if (++iCurrCheckpointIter == iCheckpointIterations) {
+			iCurrCheckpointIter = 0;
+			MakeCheckpoint();
+		}
+		break;
+
+	case TIME: {
+		doublereal dT = DrvHdl.dGetTime();
+		if (dT - dLastCheckpointTime >= dCheckpointTime) {
+			dLastCheckpointTime = dT;
+			MakeCheckpoint();
+		}
+		break;
+	}
+
+	default:
+		break;
+	}
+}
 
 void
 DataManager::DerivativesUpdate(void) const
 {
-	for (NodeVecType::const_iterator i = Nodes.begin(); i != Nodes.end(); ++i) {
-		(*i)->DerivativesUpdate(*pXCurr, *pXPrimeCurr);
+	NodesDerivativesUpdate(NodeIter);
+	ElemsDerivativesUpdate(ElemIter);
+}
+
+void
+DataManager::NodesDerivativesUpdate(VecIter<Node *> &Iter) const
+{
+	Node* pNd = NULL;
+	if (Iter.bGetFirst(pNd)) {
+		do {
+			pNd->DerivativesUpdate(*pXCurr, *pXPrimeCurr);
+		} while (Iter.bGetNext(pNd));
 	}
+}
 
-	/* Versione con iteratore: */
+void
+DataManager::ElemsDerivativesUpdate(VecIter<Elem *> &Iter) const
+{
 	Elem* pEl = NULL;
-	if (ElemIter.bGetFirst(pEl)) {
+	if (Iter.bGetFirst(pEl)) {
 		do {
 			pEl->DerivativesUpdate(*pXCurr, *pXPrimeCurr);
-		} while (ElemIter.bGetNext(pEl));
+		} while (Iter.bGetNext(pEl));
 	}
 }
 
@@ -2653,9 +2777,9 @@ DataManager::GetEqualityType(int i) const
 }
 
 void
-DataManager::FDJacCheck(const NonlinearProblem* pNLP, const MatrixHandler* pJac) {
+DataManager::FDJacCheck(const NonlinearProblem* pNLP, MatrixHandler* pJac, doublereal dCoef) {
      if (pFDJac) {
-          pFDJac->JacobianCheck(pNLP, pJac);
+          pFDJac->JacobianCheck(pNLP, pJac, dCoef);
      }
 }
 
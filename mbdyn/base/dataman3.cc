@@ -52,6 +52,7 @@
 #include "nodead.h"
 #include "elecnodead.h"
 #include "fdjac.h"
+#include "chkpt.h"
 #include "presnode.h"
 #include "presnodead.h"
 #include "j2p.h"
@@ -163,6 +164,9 @@ DataManager::ReadControl(MBDynParser& HP,
 		"finite" "difference" "jacobian" "meter",
                 "jacobian" "check",
 		"read" "solution" "array",
+		"make" "checkpoint" "file",
+		"resume" "from" "checkpoint",
+		"element" "profiling",
 
 		"select" "timeout",
 		"model",
@@ -262,6 +266,9 @@ DataManager::ReadControl(MBDynParser& HP,
                 JACOBIAN_CHECK,
 
 		READSOLUTIONARRAY,
+		MAKECHECKPOINTFILE,
+		RESUMEFROMCHECKPOINT,
+		ELEMENTPROFILING,
 
 		SELECTTIMEOUT,
 		MODEL,
@@ -1064,6 +1071,49 @@ EndOfUse:
 						bNetCDFnoText = true;
 #endif // USE_NETCDF
 					}
+					if (HP.IsKeyWord("buffered")) {
+#ifdef USE_NETCDF
+						bNetCDFbuffered = true;
+#endif // USE_NETCDF
+						while (true) {
+							if (HP.IsKeyWord("steps")) {
+								integer iSteps = HP.GetInt();
+								if (iSteps < 1) {
+									silent_cerr("NetCDF buffered output: invalid steps " << iSteps
+										<< " at line " << HP.GetLineData() << std::endl);
+									throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+								}
+#ifdef USE_NETCDF
+								NetCDFBufParams.uMaxSteps = iSteps;
+#endif // USE_NETCDF
+
+							} else if (HP.IsKeyWord("time")) {
+								doublereal dTime = HP.GetReal();
+								if (dTime < 0.) {
+									silent_cerr("NetCDF buffered output: invalid time " << dTime
+										<< " at line " << HP.GetLineData() << std::endl);
+									throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+								}
+#ifdef USE_NETCDF
+								NetCDFBufParams.dMaxTime = dTime;
+#endif // USE_NETCDF
+
+							} else if (HP.IsKeyWord("memory")) {
+								doublereal dMB = HP.GetReal();
+								if (dMB <= 0.) {
+									silent_cerr("NetCDF buffered output: invalid memory " << dMB
+										<< " at line " << HP.GetLineData() << std::endl);
+									throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+								}
+#ifdef USE_NETCDF
+								NetCDFBufParams.uMaxBytes = size_t(dMB*1024*1024);
+#endif // USE_NETCDF
+
+							} else {
+								break;
+							}
+						}
+					}
 #ifndef USE_NETCDF
 					silent_cerr("\"netcdf\" ignored; please rebuild with NetCDF output enabled"
 						" at line " << HP.GetLineData() << std::endl);
@@ -1358,6 +1408,28 @@ EndOfUse:
                              if (HP.IsKeyWord("order")) {
                                   eFDJacOrder = static_cast<FiniteDifferenceOrder>(HP.GetInt());
                              }
+
+                             if (HP.IsKeyWord("coloring")) {
+                                  oFDParam.bColoring = HP.GetYesNoOrBool();
+                             }
+
+                             if (HP.IsKeyWord("replace")) {
+                                  // the element blocks are built with the coloring
+                                  oFDParam.bReplace = HP.GetYesNoOrBool();
+                                  if (oFDParam.bReplace) {
+                                       oFDParam.bColoring = true;
+
+                                       if (HP.IsKeyWord("tolerance")) {
+                                            oFDParam.dReplaceTol = HP.GetReal();
+                                            if (oFDParam.dReplaceTol < 0.) {
+                                                 silent_cerr("finite difference jacobian meter: "
+                                                             "replace tolerance must be non-negative "
+                                                             "at line " << HP.GetLineData() << std::endl);
+                                                 throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+                                            }
+                                       }
+                                  }
+                             }
                         }
 
                         if (HP.IsKeyWord("output")) {
@@ -1392,6 +1464,31 @@ EndOfUse:
                         typedef FiniteDifferenceJacobian<3> FDJac2;
                         typedef FiniteDifferenceJacobian<5> FDJac4;
                         typedef FiniteDifferenceJacobian<7> FDJac6;
+                        typedef ColoredFiniteDifferenceJacobian<2> CFDJac1;
+                        typedef ColoredFiniteDifferenceJacobian<3> CFDJac2;
+                        typedef ColoredFiniteDifferenceJacobian<5> CFDJac4;
+                        typedef ColoredFiniteDifferenceJacobian<7> CFDJac6;
+
+                        if (oFDParam.bColoring) {
+                             switch (eFDJacOrder) {
+                             case FD_POLYNOMIAL_1:
+                                  SAFENEWWITHCONSTRUCTOR(pFDJac, CFDJac1, CFDJac1(this, std::move(oFDParam)));
+                                  break;
+                             case FD_POLYNOMIAL_2:
+                                  SAFENEWWITHCONSTRUCTOR(pFDJac, CFDJac2, CFDJac2(this, std::move(oFDParam)));
+                                  break;
+                             case FD_POLYNOMIAL_4:
+                                  SAFENEWWITHCONSTRUCTOR(pFDJac, CFDJac4, CFDJac4(this, std::move(oFDParam)));
+                                  break;
+                             case FD_POLYNOMIAL_6:
+                                  SAFENEWWITHCONSTRUCTOR(pFDJac, CFDJac6, CFDJac6(this, std::move(oFDParam)));
+                                  break;
+                             default:
+                                  silent_cerr("invalid order " << eFDJacOrder << " for finite difference operator at line " << HP.GetLineData() << "\n");
+                                  throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+                             }
+                             break;
+                        }
 
                         switch (eFDJacOrder) {
                         case FD_POLYNOMIAL_1:
@@ -1421,6 +1518,49 @@ EndOfUse:
 			snprintf(solArrFileName, len, "%s.X", sInputFileName);
 		} break;
 
+		case MAKECHECKPOINTFILE:
+			if (HP.IsKeyWord("iterations")) {
+				CheckpointEvery = ITERATIONS;
+				iCheckpointIterations = HP.GetInt(1, HighParser::range_gt<integer>(0));
+
+			} else if (HP.IsKeyWord("time")) {
+				CheckpointEvery = TIME;
+				dCheckpointTime = HP.GetReal(0., HighParser::range_gt<doublereal>(0.));
+
+			} else {
+				CheckpointEvery = ATEND;
+			}
+
+			if (HP.IsKeyWord("file" "name")) {
+				sCheckpointFileName = HP.GetFileName();
+
+			} else {
+				sCheckpointFileName = OutHdl._sPutExt(".chk");
+			}
+
+			if (pChkWriter != 0) {
+				SAFEDELETE(pChkWriter);
+			}
+			SAFENEWWITHCONSTRUCTOR(pChkWriter, CheckpointWriter,
+				CheckpointWriter(sCheckpointFileName));
+			break;
+
+		case RESUMEFROMCHECKPOINT:
+			sResumeFileName = HP.GetFileName();
+			break;
+
+		case ELEMENTPROFILING:
+			if (HP.GetYesNoOrBool()) {
+				if (pElemProf == nullptr) {
+					SAFENEW(pElemProf, ElemProfiler);
+				}
+
+			} else if (pElemProf != nullptr) {
+				SAFEDELETE(pElemProf);
+				pElemProf = nullptr;
+			}
+			break;
+
 		case SELECTTIMEOUT:
 #ifdef USE_SOCKET
 			if (HP.IsKeyWord("forever")) {
@@ -49,6 +49,9 @@
 
 /* include del programma */
 #include "mathp.h"
+#ifndef DO_NOT_USE_EE
+#include "evaluator_bc.h"
+#endif // DO_NOT_USE_EE
 #include "output.h"
 #include "withlab.h"
 
@@ -70,10 +73,13 @@ private:
 	class SharedExpr : public std::enable_shared_from_this<SharedExpr> {
 	private:
 		const ExpressionElement *m_expr;
+		// compiled form, if any; the tree is the reference
+		const EE_Bytecode *m_bc;
 	public:
-		SharedExpr(const ExpressionElement *expr) : m_expr(expr) {};
-		~SharedExpr(void) { delete m_expr; };
+		SharedExpr(const ExpressionElement *expr) : m_expr(expr), m_bc(EE_Bytecode::Compile(expr)) {};
+		~SharedExpr(void) { delete m_bc; delete m_expr; };
 		const ExpressionElement *Get(void) const { return m_expr; };
+		const EE_Bytecode *GetBytecode(void) const { return m_bc; };
         	std::shared_ptr<const SharedExpr> pCopy(void) const { return shared_from_this(); };
 	};
 
@@ -116,7 +122,10 @@ StringDriveCaller::dGet(void) const
 #ifndef DO_NOT_USE_EE
 	doublereal val;
 	try {
-		val = m_expr->Get()->Eval().GetReal();
+		const EE_Bytecode *bc = m_expr->GetBytecode();
+		if (bc == 0 || !bc->Eval(val)) {
+			val = m_expr->Get()->Eval().GetReal();
+		}
 	} catch (MBDynErrBase& e) {
 		silent_cerr("StringDriveCaller::dGet(): " << e.what() << std::endl);
 		throw e;
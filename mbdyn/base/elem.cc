@@ -85,6 +85,16 @@ Elem::bInverseDynamics(void) const
 	return false;
 }
 
+bool
+Elem::bIsOrderDependent(void) const
+{
+	/* drive callers, and the parser and variables of string drives,
+	 * are shared and not reentrant; elements, or their constitutive laws,
+	 * may evaluate them in any of these passes, so elements are processed
+	 * serially unless they are known not to */
+	return true;
+}
+
 void
 Elem::SetInverseDynamicsFlags(unsigned uIDF)
 {
@@ -236,6 +236,14 @@ public:
 		const VectorHandler& XPrimePrimeCurr,
 		InverseDynamics::Order iOrder = InverseDynamics::INVERSE_DYNAMICS);
 
+	/* elements whose BeforePredict(), AfterPredict(), Update(),
+	 * AfterConvergence() and DerivativesUpdate() depend on the order
+	 * of execution, or access data shared with other elements
+	 * (including drive callers), must return true; they are never
+	 * processed concurrently.  The default is true: only elements
+	 * whose passes have been checked may override it */
+	virtual bool bIsOrderDependent(void) const;
+
 	/* returns the number of connected nodes */
 	virtual inline int GetNumConnectedNodes(void) const;
 	virtual inline void GetConnectedNodes(std::vector<const Node *>& connectedNodes) const;
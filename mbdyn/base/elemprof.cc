@@ -0,0 +1,190 @@
+/* $Header$ */
+/*
+ * MBDyn (C) is a multibody analysis code.
+ * http://www.mbdyn.org
+ *
+ * Copyright (C) 1996-2023
+ *
+ * Pierangelo Masarati	<pierangelo.masarati@polimi.it>
+ * Paolo Mantegazza	<paolo.mantegazza@polimi.it>
+ *
+ * Dipartimento di Ingegneria Aerospaziale - Politecnico di Milano
+ * via La Masa, 34 - 20156 Milano, Italy
+ * http://www.aero.polimi.it
+ *
+ * Changing this copyright notice is forbidden.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation (version 2 of the License).
+ *
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* per-element profiling */
+
+#include "mbconfig.h"           /* This goes first in every *.c,*.cc file */
+
+#include <algorithm>
+#include <iomanip>
+
+#include "elemprof.h"
+
+/* ElemProfiler - begin */
+
+static const char *psPhaseNames[] = {
+	"AssRes",
+	"AssJac",
+	"Update",
+	"AfterPredict",
+	"Output",
+	0
+};
+
+ElemProfiler::Counters::Counters(void)
+: Time(0), uCalls(0), uEntries(0), uArenaPeak(0)
+{
+	NO_OP;
+}
+
+ElemProfiler::Counters&
+ElemProfiler::Counters::operator += (const Counters& c)
+{
+	Time += c.Time;
+	uCalls += c.uCalls;
+	uEntries += c.uEntries;
+	uArenaPeak = std::max(uArenaPeak, c.uArenaPeak);
+
+	return *this;
+}
+
+ElemProfiler::ElemProfiler(void)
+{
+	NO_OP;
+}
+
+ElemProfiler::~ElemProfiler(void)
+{
+	NO_OP;
+}
+
+integer
+ElemProfiler::iGetNumEntries(const VariableSubMatrixHandler& WM)
+{
+	switch (WM.GetStatus()) {
+	case VariableSubMatrixHandler::FULL: {
+		const FullSubMatrixHandler& WMF = WM.GetFull();
+		return WMF.iGetNumRows()*WMF.iGetNumCols();
+	}
+
+	case VariableSubMatrixHandler::SPARSE:
+		return WM.GetSparse().iGetNumRows();
+
+	case VariableSubMatrixHandler::SPARSE_GRADIENT:
+		return WM.GetSparseGradient().iGetNumItems();
+
+	default:
+		return 0;
+	}
+}
+
+void
+ElemProfiler::Init(const std::vector<Elem *>& Elems)
+{
+	/* the map points into Records, which must not be resized later */
+	Records.resize(Elems.size());
+	ElemMap.clear();
+	ElemMap.reserve(Elems.size());
+
+	for (std::vector<Elem *>::size_type i = 0; i < Elems.size(); i++) {
+		Records[i].pEl = Elems[i];
+		ElemMap[Elems[i]] = &Records[i];
+	}
+}
+
+std::ostream&
+ElemProfiler::Output(std::ostream& out) const
+{
+	typedef std::chrono::duration<double> DoubleSec;
+
+	/* per-type summary */
+	std::vector<Counters> TypeCounters(Elem::LASTELEMTYPE*LASTPHASE);
+	std::vector<unsigned> TypeCount(Elem::LASTELEMTYPE, 0);
+	for (std::vector<Record>::const_iterator r = Records.begin();
+		r != Records.end(); ++r)
+	{
+		Elem::Type t = r->pEl->GetElemType();
+		TypeCount[t]++;
+		for (int ph = 0; ph < LASTPHASE; ph++) {
+			TypeCounters[t*LASTPHASE + ph] += r->c[ph];
+		}
+	}
+
+	out << "# element profile" << std::endl
+		<< "# for each of";
+	for (int ph = 0; ph < LASTPHASE; ph++) {
+		out << " " << psPhaseNames[ph];
+	}
+	out << ": time [s], calls, assembled entries,"
+		" peak AD arena use [bytes]" << std::endl
+		<< "# type <type> <number of elements> ..." << std::endl
+		<< "# elem <type> <label> ..." << std::endl;
+
+	/* types sorted by decreasing total time */
+	typedef std::vector<std::pair<std::chrono::nanoseconds, unsigned> >
+		TypeOrderVec;
+	TypeOrderVec TypeOrder;
+	for (unsigned t = 0; t < Elem::LASTELEMTYPE; t++) {
+		if (TypeCount[t] == 0) {
+			continue;
+		}
+
+		std::chrono::nanoseconds Time(0);
+		for (int ph = 0; ph < LASTPHASE; ph++) {
+			Time += TypeCounters[t*LASTPHASE + ph].Time;
+		}
+		TypeOrder.push_back(std::make_pair(Time, t));
+	}
+	std::sort(TypeOrder.rbegin(), TypeOrder.rend());
+
+	for (TypeOrderVec::const_iterator i = TypeOrder.begin();
+		i != TypeOrder.end(); ++i)
+	{
+		unsigned t = i->second;
+		out << "type " << std::quoted(psElemNames[t]) << " " << TypeCount[t];
+		for (int ph = 0; ph < LASTPHASE; ph++) {
+			const Counters& c = TypeCounters[t*LASTPHASE + ph];
+			out << " " << DoubleSec(c.Time).count()
+				<< " " << c.uCalls
+				<< " " << c.uEntries
+				<< " " << c.uArenaPeak;
+		}
+		out << std::endl;
+	}
+
+	for (std::vector<Record>::const_iterator r = Records.begin();
+		r != Records.end(); ++r)
+	{
+		out << "elem " << std::quoted(psElemNames[r->pEl->GetElemType()])
+			<< " " << r->pEl->GetLabel();
+		for (int ph = 0; ph < LASTPHASE; ph++) {
+			out << " " << DoubleSec(r->c[ph].Time).count()
+				<< " " << r->c[ph].uCalls
+				<< " " << r->c[ph].uEntries
+				<< " " << r->c[ph].uArenaPeak;
+		}
+		out << std::endl;
+	}
+
+	return out;
+}
+
+/* ElemProfiler - end */
@@ -0,0 +1,148 @@
+/* $Header$ */
+/*
+ * MBDyn (C) is a multibody analysis code.
+ * http://www.mbdyn.org
+ *
+ * Copyright (C) 1996-2023
+ *
+ * Pierangelo Masarati	<pierangelo.masarati@polimi.it>
+ * Paolo Mantegazza	<paolo.mantegazza@polimi.it>
+ *
+ * Dipartimento di Ingegneria Aerospaziale - Politecnico di Milano
+ * via La Masa, 34 - 20156 Milano, Italy
+ * http://www.aero.polimi.it
+ *
+ * Changing this copyright notice is forbidden.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation (version 2 of the License).
+ *
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* per-element profiling */
+
+#ifndef ELEMPROF_H
+#define ELEMPROF_H
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <unordered_map>
+#include <vector>
+
+#include "elem.h"
+#include "sp_gradient_arena.h"
+
+/* ElemProfiler - begin */
+
+/*
+ * Collects, for each element, the cumulative wall time, the number
+ * of calls, the number of coefficients assembled by the main
+ * per-element operations and the peak number of bytes taken
+ * by a single call from the arena of temporary AD gradients.
+ * Counters are per element, and each element is processed
+ * by one thread at a time during a pass, so no locking is needed;
+ * the per-type summary is computed when the report is written.
+ */
+class ElemProfiler {
+public:
+	enum Phase {
+		ASSRES = 0,
+		ASSJAC,
+		UPDATE,
+		AFTERPREDICT,
+		OUTPUT,
+
+		LASTPHASE
+	};
+
+	struct Counters {
+		std::chrono::nanoseconds Time;
+		unsigned long uCalls;
+		unsigned long uEntries;
+		size_t uArenaPeak;
+
+		Counters(void);
+		Counters& operator += (const Counters& c);
+	};
+
+	/* samples one call of an element; does nothing if pProf is null */
+	class Timer {
+	private:
+		Counters *pC;
+		std::chrono::steady_clock::time_point tStart;
+
+	public:
+		Timer(ElemProfiler *pProf, const Elem *pEl, Phase ph) {
+			pC = pProf ? pProf->pGetCounters(pEl, ph) : 0;
+			if (pC) {
+				sp_grad::SpGradientArena::ResetPeak();
+				tStart = std::chrono::steady_clock::now();
+			}
+		};
+
+		~Timer(void) {
+			if (pC) {
+				pC->Time += std::chrono::steady_clock::now() - tStart;
+				pC->uCalls++;
+				pC->uArenaPeak = std::max(pC->uArenaPeak,
+					sp_grad::SpGradientArena::uGetPeak());
+			}
+		};
+
+		void AddEntries(const VariableSubMatrixHandler& WM) {
+			if (pC) {
+				pC->uEntries += ElemProfiler::iGetNumEntries(WM);
+			}
+		};
+
+		void AddEntries(const SubVectorHandler& WV) {
+			if (pC) {
+				pC->uEntries += WV.iGetSize();
+			}
+		};
+	};
+
+private:
+	struct Record {
+		const Elem *pEl;
+		Counters c[LASTPHASE];
+	};
+
+	std::vector<Record> Records;
+	std::unordered_map<const Elem *, Record *> ElemMap;
+
+	static integer iGetNumEntries(const VariableSubMatrixHandler& WM);
+
+public:
+	ElemProfiler(void);
+	~ElemProfiler(void);
+
+	/* sets up one record per element; call once all elements exist */
+	void Init(const std::vector<Elem *>& Elems);
+
+	Counters *pGetCounters(const Elem *pEl, Phase ph) {
+		std::unordered_map<const Elem *, Record *>::iterator i = ElemMap.find(pEl);
+		if (i == ElemMap.end()) {
+			return 0;
+		}
+		return &i->second->c[ph];
+	};
+
+	/* writes the per-type and per-element report */
+	std::ostream& Output(std::ostream& out) const;
+};
+
+/* ElemProfiler - end */
+
+#endif /* ELEMPROF_H */
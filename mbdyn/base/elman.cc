@@ -408,6 +408,10 @@ DataManager::ElemAssInit(void)
 
 	DEBUGCOUT("Creating working matrices:" << iMaxWorkNumRowsJac
 			<< " x " << iMaxWorkNumColsJac << std::endl);
+
+	if (pElemProf) {
+		pElemProf->Init(Elems);
+	}
 }
 
 /* Assemblaggio dello jacobiano.
@@ -479,8 +483,11 @@ DataManager::AssJac(MatrixHandler& JacHdl, doublereal dCoef,
 	if (Iter.bGetFirst(pTmpEl)) {
 		do {
 			try {
-				JacHdl += pTmpEl->AssJac(WorkMat, dCoef,
+				ElemProfiler::Timer t(pElemProf, pTmpEl, ElemProfiler::ASSJAC);
+				const VariableSubMatrixHandler& WM = pTmpEl->AssJac(WorkMat, dCoef,
 						*pXCurr, *pXPrimeCurr);
+				t.AddEntries(WM);
+				JacHdl += WM;
 			}
 			catch (ErrDivideByZero& e) {
 				silent_cerr("AssJac: divide by zero "
@@ -512,6 +519,7 @@ DataManager::AssJac(VectorHandler& JacY,
 	if (Iter.bGetFirst(pTmpEl)) {
 		do {
 			try {
+                             ElemProfiler::Timer t(pElemProf, pTmpEl, ElemProfiler::ASSJAC);
                              pTmpEl->AssJac(JacY, Y, dCoef, *pXCurr, *pXPrimeCurr, WorkMat);
 			}
 			catch (ErrDivideByZero& e) {
@@ -597,8 +605,11 @@ DataManager::AssRes(VectorHandler& ResHdl, doublereal dCoef,
 	if (Iter.bGetFirst(pTmpEl)) {
 		do {
 			try {
-				ResHdl += pTmpEl->AssRes(WorkVec, dCoef,
+				ElemProfiler::Timer t(pElemProf, pTmpEl, ElemProfiler::ASSRES);
+				const SubVectorHandler& WV = pTmpEl->AssRes(WorkVec, dCoef,
 					*pXCurr, *pXPrimeCurr);
+				t.AddEntries(WV);
+				ResHdl += WV;
 				if (pAbsResHdl) WorkVec.AddAbsValuesTo(*pAbsResHdl);
 			}
 			catch(Elem::ChangedEquationStructure& e) {
@@ -626,6 +637,28 @@ DataManager::AssRes(VectorHandler& ResHdl, doublereal dCoef,
 	}
 }
 
+/* Contributi di un singolo elemento, ad es. per lo jacobiano alle differenze finite */
+const SubVectorHandler&
+DataManager::ElemAssRes(Elem* pEl, doublereal dCoef)
+{
+	ASSERT(pWorkVec != NULL);
+
+	try {
+		return pEl->AssRes(*pWorkVec, dCoef, *pXCurr, *pXPrimeCurr);
+	}
+	catch (Elem::ChangedEquationStructure& e) {
+		return *pWorkVec;
+	}
+}
+
+const VariableSubMatrixHandler&
+DataManager::ElemAssJac(Elem* pEl, doublereal dCoef)
+{
+	ASSERT(pWorkMat != NULL);
+
+	return pEl->AssJac(*pWorkMat, dCoef, *pXCurr, *pXPrimeCurr);
+}
+
 void
 DataManager::SetElemDimensionIndices(std::map<OutputHandler::Dimensions, std::set<integer>>* pDimMap) {
 	Elem* pTmpEl = NULL;
@@ -743,6 +776,7 @@ DataManager::ElemOutput(OutputHandler& OH) const
 
 	if (ElemIter.bGetFirst(pTmpEl)) {
 		do {
+			ElemProfiler::Timer t(pElemProf, pTmpEl, ElemProfiler::OUTPUT);
 			pTmpEl->Output(OH);
 		} while (ElemIter.bGetNext(pTmpEl));
 	}
@@ -756,6 +790,7 @@ DataManager::ElemOutput( OutputHandler& OH, const VectorHandler& X,
 
 	if (ElemIter.bGetFirst(pTmpEl)) {
 		do {
+			ElemProfiler::Timer t(pElemProf, pTmpEl, ElemProfiler::OUTPUT);
 			pTmpEl->Output(OH, X, XP);
 		} while (ElemIter.bGetNext(pTmpEl));
 	}
@@ -400,6 +400,8 @@ ReadExtSocketHandler(DataManager* pDM,
 	unsigned short int port = (unsigned short int)-1;
 	std::string host;
 	std::string path;
+	std::string shm_name;
+	size_t shm_size = 0;
 
 	if (HP.IsKeyWord("create")) {
 		if (!HP.GetYesNo(bCreate)) {
@@ -434,14 +436,41 @@ ReadExtSocketHandler(DataManager* pDM,
 
 		path = m;
 #endif /* _WIN32 */
+
+	} else if (HP.IsKeyWord("shared" "memory")) {
+#ifdef MBDYN_SHM_SUPPORTED
+		const char *m = HP.GetStringWithDelims();
+
+		if (m == 0) {
+			silent_cerr("ExtSocketHandler"
+				"(" << uLabel << "): "
+				"unable to read shared memory name "
+				"at line " << HP.GetLineData()
+				<< std::endl);
+			throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+		}
+
+		shm_name = m;
+
+		if (HP.IsKeyWord("size")) {
+			shm_size = HP.GetInt(0, HighParser::range_gt<integer>(0));
+		}
+#else /* ! MBDYN_SHM_SUPPORTED */
+		silent_cerr("ExtSocketHandler"
+			"(" << uLabel << "): "
+			"shared memory is not supported on this platform "
+			"at line " << HP.GetLineData()
+			<< std::endl);
+		throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+#endif /* ! MBDYN_SHM_SUPPORTED */
 	}
 
 	if (HP.IsKeyWord("port")) {
-		if (!path.empty()) {
+		if (!path.empty() || !shm_name.empty()) {
 			silent_cerr("ExtSocketHandler"
 				"(" << uLabel << "): "
 				"cannot specify port "
-				"for a local socket "
+				"for a local socket or shared memory "
 				"at line " << HP.GetLineData()
 				<< std::endl);
 			throw ErrGeneric(MBDYN_EXCEPT_ARGS);
@@ -468,10 +497,10 @@ ReadExtSocketHandler(DataManager* pDM,
 	}
 
 	if (HP.IsKeyWord("host")) {
-		if (!path.empty()) {
+		if (!path.empty() || !shm_name.empty()) {
 			silent_cerr("ExtSocketHandler"
 				"(" << uLabel << "): "
-				"cannot specify host for a local socket "
+				"cannot specify host for a local socket or shared memory "
 				"at line " << HP.GetLineData()
 				<< std::endl);
 			throw ErrGeneric(MBDYN_EXCEPT_ARGS);
@@ -491,7 +520,7 @@ ReadExtSocketHandler(DataManager* pDM,
 
 		host = h;
 
-	} else if (path.empty() && !bCreate) {
+	} else if (path.empty() && shm_name.empty() && !bCreate) {
 		silent_cerr("ExtSocketHandler"
 			"(" << uLabel << "): "
 			"host undefined "
@@ -513,6 +542,13 @@ ReadExtSocketHandler(DataManager* pDM,
 		}
 	}
 
+	if ((socket_type == SOCK_DGRAM) && !shm_name.empty()) {
+		silent_cerr("ExtSocketHandler(" << uLabel << "\"): "
+			"socket type=udp incompatible with shared memory "
+			"at line " << HP.GetLineData() << std::endl);
+		throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+	}
+
 	if ((socket_type == SOCK_DGRAM) && !bCreate) {
 		silent_cerr("ExtSocketHandler(" << uLabel << "\"): "
 			"socket type=upd incompatible with create=no "
@@ -559,7 +595,12 @@ ReadExtSocketHandler(DataManager* pDM,
 	}
 
 	UseSocket *pUS = 0;
-	if (path.empty()) {
+	if (!shm_name.empty()) {
+#ifdef MBDYN_SHM_SUPPORTED
+		SAFENEWWITHCONSTRUCTOR(pUS, UseSharedMemory, UseSharedMemory(shm_name, shm_size, bCreate));
+#endif /* MBDYN_SHM_SUPPORTED */
+
+	} else if (path.empty()) {
 		if (port == (unsigned short int)(-1)) {
 			silent_cerr("ExtSocketHandler"
 				"(" << uLabel << "): "
@@ -577,7 +618,11 @@ ReadExtSocketHandler(DataManager* pDM,
 #endif /* _WIN32 */
 	}
     pedantic_cout("In ReadExtSocketHandler before if (bCreate)" << std::endl);
-	if (bCreate) {
+	if (!shm_name.empty()) {
+		// the peer attaches to the shared memory without handshaking
+		pUS->Connect();
+
+	} else if (bCreate) {
         pedantic_cout("In ReadExtSocketHandler bCreate true so RegisterSocketUser" << std::endl);
 		pDM->RegisterSocketUser(pUS);
 
@@ -44,6 +44,7 @@
 #include "dataman.h"
 #include "fdjac.h"
 #include "fullmh.h"
+#include "nestedelem.h"
 
 constexpr integer FiniteDifferenceOperator<2>::N;
 constexpr std::array<doublereal, 2> FiniteDifferenceOperator<2>::pertFD;
@@ -89,7 +90,7 @@ FiniteDifferenceJacobianBase::~FiniteDifferenceJacobianBase()
      }
 }
 
-void FiniteDifferenceJacobianBase::JacobianCheck(const NonlinearProblem* const pNLP, const MatrixHandler* const pJac)
+void FiniteDifferenceJacobianBase::JacobianCheck(const NonlinearProblem* const pNLP, MatrixHandler* const pJac, const doublereal dCoef)
 {
      // Finite difference check of Jacobian matrix
      // NOTE: might not be safe!
@@ -104,20 +105,31 @@ void FiniteDifferenceJacobianBase::JacobianCheck(const NonlinearProblem* const p
 
      ++iIterations;
 
-     if (pFDJacMeterStep->dGet() && pFDJacMeterIter->dGet(iIterations)) {
-          ++iJacobians;
+     const bool bCheck = pFDJacMeterStep->dGet() && pFDJacMeterIter->dGet(iIterations);
 
+     if (bCheck || bReplace) {
           Attach(pJac);
 
+          inc.Reset();
+     }
+
+     // the check only reads pJac
+     if (bCheck) {
+          ++iJacobians;
+
           if (pFDJac) {
                pFDJac->Reset();
           }
 
-          inc.Reset();
-
           JacobianCheckImpl(pNLP, pJac, oJacStatCurr);
      }
 
+     // the replaced elements are selected when the meters trigger,
+     // and replaced on every Jacobian matrix
+     if (bReplace) {
+          ReplaceJacobian(pNLP, pJac, dCoef, bCheck);
+     }
+
      dTimePrev = oJacStatCurr.dTimeSample;
 }
 
@@ -167,6 +179,12 @@ void FiniteDifferenceJacobianBase::Attach(const MatrixHandler* pJac)
      ASSERT(inc.iGetSize() == pJac->iGetNumCols());
 }
 
+void FiniteDifferenceJacobianBase::ReplaceJacobian(const NonlinearProblem* pNLP, MatrixHandler* pJac, doublereal dCoef, bool bSelect)
+{
+     silent_cerr("Finite difference Jacobian: replacement of the Jacobian matrix requires coloring\n");
+     throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+}
+
 template <integer N>
 FiniteDifferenceJacobian<N>::FiniteDifferenceJacobian(DataManager* const pDM, FiniteDifferenceJacobianParam&& oParam)
      :FiniteDifferenceJacobianBase(pDM, std::move(oParam))
@@ -268,6 +286,720 @@ class FiniteDifferenceJacobian<5>;
 template
 class FiniteDifferenceJacobian<7>;
 
+template <integer N>
+ColoredFiniteDifferenceJacobian<N>::ColoredFiniteDifferenceJacobian(DataManager* const pDM, FiniteDifferenceJacobianParam&& oParam)
+     :FiniteDifferenceJacobianBase(pDM, std::move(oParam))
+{
+}
+
+template <integer N>
+ColoredFiniteDifferenceJacobian<N>::~ColoredFiniteDifferenceJacobian()
+{
+}
+
+template <integer N>
+void ColoredFiniteDifferenceJacobian<N>::Attach(const MatrixHandler* pJac)
+{
+     FiniteDifferenceJacobianBase::Attach(pJac);
+
+     if (incsol[0].iGetSize() != pJac->iGetNumRows()) {
+          for (size_t k = 0; k < incsol.size(); ++k) {
+               incsol[k].Resize(pJac->iGetNumRows());
+          }
+     }
+
+     ASSERT(incsol[0].iGetSize() == pJac->iGetNumRows());
+
+     // The analytical Jacobian may grow new entries at any time
+     if (ColPtr.size() != static_cast<size_t>(pJac->iGetNumCols()) + 1 || !bPatternCovers(pJac)) {
+          PatternBuild(pJac);
+          PatternColor();
+     }
+}
+
+template <integer N>
+bool ColoredFiniteDifferenceJacobian<N>::bPatternCovers(const MatrixHandler* pJac) const
+{
+     bool bCovers = true;
+
+     pJac->EnumerateNz([this, &bCovers] (integer iRow, integer iCol, doublereal) {
+          if (bCovers) {
+               const auto pFirst = RowIdx.begin() + ColPtr[iCol - 1];
+               const auto pLast = RowIdx.begin() + ColPtr[iCol];
+
+               bCovers = std::binary_search(pFirst, pLast, iRow - 1);
+          }
+     });
+
+     return bCovers;
+}
+
+template <integer N>
+void ColoredFiniteDifferenceJacobian<N>::PatternBuild(const MatrixHandler* pJac)
+{
+     const integer iNumRows = pJac->iGetNumRows();
+     const integer iNumCols = pJac->iGetNumCols();
+
+     // the elements and their dofs do not change with the pattern
+     const bool bNewBlocks = ColPtr.size() != static_cast<size_t>(iNumCols) + 1;
+
+     if (bNewBlocks) {
+          ElemBlocks.clear();
+     }
+
+     std::vector<std::vector<integer> > Cols(iNumCols);
+
+     // the diagonal is always needed
+     for (integer j = 0; j < std::min(iNumRows, iNumCols); ++j) {
+          Cols[j].push_back(j);
+     }
+
+     auto AddBlock = [&Cols, iNumRows, iNumCols] (const std::vector<integer>& Idx) {
+          for (integer j: Idx) {
+               if (j >= iNumCols) {
+                    continue;
+               }
+               for (integer i: Idx) {
+                    if (i < iNumRows) {
+                         Cols[j].push_back(i);
+                    }
+               }
+          }
+     };
+
+     std::vector<integer> Idx;
+
+     // each node depends on its own dofs
+     for (int t = 0; t < Node::LASTNODETYPE; ++t) {
+          for (auto n = pDM->begin(Node::Type(t)); n != pDM->end(Node::Type(t)); ++n) {
+               const Node* pNode = n->second;
+
+               Idx.clear();
+               for (unsigned k = 0; k < pNode->iGetNumDof(); ++k) {
+                    Idx.push_back(pNode->iGetFirstIndex() + k);
+               }
+
+               AddBlock(Idx);
+          }
+     }
+
+     // each element couples its own dofs with those of its connected nodes
+     std::vector<const Node *> connectedNodes;
+
+     for (int t = 0; t < Elem::LASTELEMTYPE; ++t) {
+          for (auto e = pDM->begin(Elem::Type(t)); e != pDM->end(Elem::Type(t)); ++e) {
+               const Elem* pEl = e->second;
+
+               Idx.clear();
+
+               pEl->GetConnectedNodes(connectedNodes);
+
+               for (const Node* pNode: connectedNodes) {
+                    pNode = pNode->GetNode();
+                    for (unsigned k = 0; k < pNode->iGetNumDof(); ++k) {
+                         Idx.push_back(pNode->iGetFirstIndex() + k);
+                    }
+               }
+
+               const NestedElem* pNested = dynamic_cast<const NestedElem *>(pEl);
+               const ElemWithDofs* pElWithDofs = dynamic_cast<const ElemWithDofs *>(pNested ? pNested->pGetElem() : pEl);
+
+               if (pElWithDofs && pEl->iGetNumDof() > 0) {
+                    for (unsigned k = 0; k < pEl->iGetNumDof(); ++k) {
+                         Idx.push_back(pElWithDofs->iGetFirstIndex() + k);
+                    }
+               }
+
+               AddBlock(Idx);
+
+               if (bNewBlocks && bReplace) {
+                    ElemBlock oBlock;
+
+                    oBlock.pEl = e->second;
+                    for (integer i: Idx) {
+                         if (i < std::min(iNumRows, iNumCols)) {
+                              oBlock.Idx.push_back(i);
+                         }
+                    }
+                    std::sort(oBlock.Idx.begin(), oBlock.Idx.end());
+                    oBlock.Idx.erase(std::unique(oBlock.Idx.begin(), oBlock.Idx.end()), oBlock.Idx.end());
+                    oBlock.iResOffset = 0;
+                    oBlock.iJacOffset = 0;
+                    oBlock.bActive = false;
+                    oBlock.bComplete = true;
+                    oBlock.bReplaced = false;
+                    oBlock.bWarned = false;
+
+                    if (!oBlock.Idx.empty()) {
+                         ElemBlocks.emplace_back(std::move(oBlock));
+                    }
+               }
+          }
+     }
+
+     // entries provided by the analytical Jacobian
+     pJac->EnumerateNz([&Cols] (integer iRow, integer iCol, doublereal) {
+          Cols[iCol - 1].push_back(iRow - 1);
+     });
+
+     ColPtr.resize(iNumCols + 1);
+     RowIdx.clear();
+
+     ColPtr[0] = 0;
+
+     for (integer j = 0; j < iNumCols; ++j) {
+          std::sort(Cols[j].begin(), Cols[j].end());
+          Cols[j].erase(std::unique(Cols[j].begin(), Cols[j].end()), Cols[j].end());
+          RowIdx.insert(RowIdx.end(), Cols[j].begin(), Cols[j].end());
+          ColPtr[j + 1] = RowIdx.size();
+     }
+
+     JacFD.resize(RowIdx.size());
+     hCol.resize(iNumCols);
+
+     if (bNewBlocks && bReplace) {
+          integer iResSize = 0, iJacSize = 0;
+
+          ColElemPtr.assign(iNumCols + 1, 0);
+
+          for (ElemBlock& oBlock: ElemBlocks) {
+               const integer n = oBlock.Idx.size();
+
+               oBlock.iResOffset = iResSize;
+               oBlock.iJacOffset = iJacSize;
+               iResSize += n;
+               iJacSize += n * n;
+
+               for (integer j: oBlock.Idx) {
+                    ++ColElemPtr[j + 1];
+               }
+          }
+
+          for (integer j = 0; j < iNumCols; ++j) {
+               ColElemPtr[j + 1] += ColElemPtr[j];
+          }
+
+          std::vector<integer> ColElemPos(ColElemPtr.begin(), ColElemPtr.end() - 1);
+
+          ColElem.resize(ColElemPtr[iNumCols]);
+
+          for (size_t b = 0; b < ElemBlocks.size(); ++b) {
+               const std::vector<integer>& Idx = ElemBlocks[b].Idx;
+
+               for (size_t l = 0; l < Idx.size(); ++l) {
+                    ColElem[ColElemPos[Idx[l]]++] = std::make_pair(integer(b), integer(l));
+               }
+          }
+
+          for (size_t k = 0; k < ResElem.size(); ++k) {
+               ResElem[k].resize(iResSize);
+          }
+
+          JacElemFD.resize(iJacSize);
+          JacElemAn.resize(iJacSize);
+     }
+}
+
+template <integer N>
+void ColoredFiniteDifferenceJacobian<N>::PatternColor()
+{
+     const integer iNumCols = ColPtr.size() - 1;
+     const integer iNumRows = incsol[0].iGetSize();
+
+     // row-wise copy of the pattern
+     std::vector<integer> RowPtr(iNumRows + 1, 0);
+     std::vector<integer> ColIdx(RowIdx.size());
+
+     for (integer i: RowIdx) {
+          ++RowPtr[i + 1];
+     }
+
+     for (integer i = 0; i < iNumRows; ++i) {
+          RowPtr[i + 1] += RowPtr[i];
+     }
+
+     std::vector<integer> RowPos(RowPtr.begin(), RowPtr.end() - 1);
+
+     for (integer j = 0; j < iNumCols; ++j) {
+          for (integer p = ColPtr[j]; p < ColPtr[j + 1]; ++p) {
+               ColIdx[RowPos[RowIdx[p]]++] = j;
+          }
+     }
+
+     // greedy distance-2 coloring, largest columns first
+     std::vector<integer> Order(iNumCols);
+
+     for (integer j = 0; j < iNumCols; ++j) {
+          Order[j] = j;
+     }
+
+     std::stable_sort(Order.begin(), Order.end(), [this] (integer j1, integer j2) {
+          return ColPtr[j1 + 1] - ColPtr[j1] > ColPtr[j2 + 1] - ColPtr[j2];
+     });
+
+     std::vector<integer> Color(iNumCols, -1);
+     std::vector<integer> Forbidden(iNumCols, -1);
+     integer iNumColors = 0;
+
+     for (integer j: Order) {
+          for (integer p = ColPtr[j]; p < ColPtr[j + 1]; ++p) {
+               const integer i = RowIdx[p];
+
+               for (integer q = RowPtr[i]; q < RowPtr[i + 1]; ++q) {
+                    const integer c = Color[ColIdx[q]];
+
+                    if (c >= 0) {
+                         Forbidden[c] = j;
+                    }
+               }
+          }
+
+          integer c = 0;
+
+          while (Forbidden[c] == j) {
+               ++c;
+          }
+
+          Color[j] = c;
+          iNumColors = std::max(iNumColors, c + 1);
+     }
+
+     GroupPtr.assign(iNumColors + 1, 0);
+     GroupCol.resize(iNumCols);
+
+     for (integer j = 0; j < iNumCols; ++j) {
+          ++GroupPtr[Color[j] + 1];
+     }
+
+     for (integer c = 0; c < iNumColors; ++c) {
+          GroupPtr[c + 1] += GroupPtr[c];
+     }
+
+     std::vector<integer> GroupPos(GroupPtr.begin(), GroupPtr.end() - 1);
+
+     for (integer j = 0; j < iNumCols; ++j) {
+          GroupCol[GroupPos[Color[j]]++] = j;
+     }
+
+     silent_cout("Finite difference Jacobian: " << iNumCols << " columns, "
+                 << RowIdx.size() << " nonzeros, " << iNumColors << " colors\n");
+}
+
+template <integer N>
+void ColoredFiniteDifferenceJacobian<N>::JacobianCheckImpl(const NonlinearProblem* const pNLP, const MatrixHandler* const pJac, JacobianStat& oJacStatCurr)
+{
+     // Finite difference check of Jacobian matrix
+     // NOTE: might not be safe!
+
+     const integer iNumColors = GroupPtr.size() - 1;
+
+     ASSERT(incsol.size() >= idxFD.size());
+     static_assert(pertFD.size() >= idxFD.size(), "size mismatch");
+     static_assert(idxFD.size() >= coefFD.size(), "size mismatch");
+
+     for (integer c = 0; c < iNumColors; ++c) {
+          for (integer g = GroupPtr[c]; g < GroupPtr[c + 1]; ++g) {
+               const integer j = GroupCol[g] + 1;
+               const doublereal Xj = pDM->GetDofType(j) == DofOrder::DIFFERENTIAL ? pDM->GetpXPCurr()->dGetCoef(j) : pDM->GetpXCurr()->dGetCoef(j);
+
+               hCol[j - 1] = dFDJacCoef * (1. + fabs(Xj));
+
+               inc.PutCoef(j, pertFD[0] * hCol[j - 1]);
+          }
+
+          for (size_t k = 0; k < idxFD.size(); ++k) {
+               pNLP->Update(&inc);
+
+               incsol[idxFD[k]].Reset();
+               pNLP->Residual(&incsol[idxFD[k]]);
+
+               const doublereal dPertNext = (k + 1 < pertFD.size()) ? pertFD[k + 1] - pertFD[k] : 0.;
+
+               for (integer g = GroupPtr[c]; g < GroupPtr[c + 1]; ++g) {
+                    const integer j = GroupCol[g] + 1;
+
+                    inc.PutCoef(j, dPertNext * hCol[j - 1]);
+               }
+          }
+
+          // columns of the same color do not share any row
+          for (integer g = GroupPtr[c]; g < GroupPtr[c + 1]; ++g) {
+               const integer j = GroupCol[g];
+
+               for (integer p = ColPtr[j]; p < ColPtr[j + 1]; ++p) {
+                    const integer i = RowIdx[p] + 1;
+                    doublereal Jacij = 0.;
+
+                    for (size_t k = 0; k < coefFD.size(); ++k) {
+                         Jacij -= incsol[idxFD[k]](i) * coefFD[k];
+                    }
+
+                    JacFD[p] = Jacij / hCol[j];
+               }
+          }
+     }
+
+     for (integer j = 0; j < pJac->iGetNumCols(); ++j) {
+          doublereal normColj = 0.;
+
+          for (integer p = ColPtr[j]; p < ColPtr[j + 1]; ++p) {
+               normColj += JacFD[p] * JacFD[p];
+
+               if (pFDJac) {
+                    pFDJac->PutCoef(RowIdx[p] + 1, j + 1, JacFD[p]);
+               }
+          }
+
+          normColj = sqrt(normColj);
+
+          for (integer p = ColPtr[j]; p < ColPtr[j + 1]; ++p) {
+               const doublereal dCurrDiff = fabs(JacFD[p] - pJac->dGetCoef(RowIdx[p] + 1, j + 1)) / normColj;
+
+               if (dCurrDiff > oJacStatCurr.dMaxDiff) {
+                    oJacStatCurr.iRowMaxDiff = RowIdx[p] + 1;
+                    oJacStatCurr.iColMaxDiff = j + 1;
+                    oJacStatCurr.dMaxDiff = dCurrDiff;
+               }
+          }
+     }
+
+     Output(pJac, oJacStatCurr);
+}
+
+template <integer N>
+void ColoredFiniteDifferenceJacobian<N>::ReplaceJacobian(const NonlinearProblem* const pNLP, MatrixHandler* const pJac, const doublereal dCoef, const bool bSelect)
+{
+     // all the elements are checked when the meters trigger,
+     // otherwise only those already replaced are recomputed
+     bool bAny = false;
+
+     for (ElemBlock& oBlock: ElemBlocks) {
+          oBlock.bActive = bSelect || oBlock.bReplaced;
+          bAny = bAny || oBlock.bActive;
+     }
+
+     if (!bAny) {
+          return;
+     }
+
+     ElemJacobianFD(pNLP, dCoef);
+
+     for (ElemBlock& oBlock: ElemBlocks) {
+          if (!oBlock.bActive) {
+               continue;
+          }
+
+          const bool bComplete = bElemJacobianAnalytic(oBlock, dCoef) && oBlock.bComplete;
+          const bool bReplaced = bComplete && (bSelect ? bElemReplace(oBlock) : oBlock.bReplaced);
+
+          // once the matrix refused the replacement, stay quiet
+          if (bReplaced != oBlock.bReplaced && !oBlock.bWarned) {
+               silent_cout("Finite difference Jacobian: "
+                           << psElemNames[oBlock.pEl->GetElemType()]
+                           << "(" << oBlock.pEl->GetLabel() << "): "
+                           << (bReplaced ? "using the finite difference Jacobian\n" : "using the analytical Jacobian\n"));
+          }
+
+          oBlock.bReplaced = bReplaced;
+
+          if (oBlock.bReplaced && !bElemApply(oBlock, pJac)) {
+               oBlock.bReplaced = false;
+          }
+     }
+}
+
+template <integer N>
+void ColoredFiniteDifferenceJacobian<N>::ElemJacobianFD(const NonlinearProblem* const pNLP, const doublereal dCoef)
+{
+     // Same perturbations as JacobianCheckImpl, but only the residuals
+     // of the active elements are assembled, each one into its own block
+     const integer iNumColors = GroupPtr.size() - 1;
+
+     std::vector<integer> Hit;
+
+     for (ElemBlock& oBlock: ElemBlocks) {
+          if (oBlock.bActive) {
+               oBlock.bComplete = true;
+          }
+     }
+
+     for (integer c = 0; c < iNumColors; ++c) {
+          // a block has at most one column of each color
+          Hit.clear();
+
+          for (integer g = GroupPtr[c]; g < GroupPtr[c + 1]; ++g) {
+               const integer j = GroupCol[g];
+
+               for (integer q = ColElemPtr[j]; q < ColElemPtr[j + 1]; ++q) {
+                    if (ElemBlocks[ColElem[q].first].bActive) {
+                         Hit.push_back(q);
+                    }
+               }
+          }
+
+          if (Hit.empty()) {
+               continue;
+          }
+
+          for (integer g = GroupPtr[c]; g < GroupPtr[c + 1]; ++g) {
+               const integer j = GroupCol[g] + 1;
+               const doublereal Xj = pDM->GetDofType(j) == DofOrder::DIFFERENTIAL ? pDM->GetpXPCurr()->dGetCoef(j) : pDM->GetpXCurr()->dGetCoef(j);
+
+               hCol[j - 1] = dFDJacCoef * (1. + fabs(Xj));
+
+               inc.PutCoef(j, pertFD[0] * hCol[j - 1]);
+          }
+
+          for (size_t k = 0; k < idxFD.size(); ++k) {
+               pNLP->Update(&inc);
+
+               // the residual at the reference state is not needed
+               // by the centered operators
+               if (k < coefFD.size()) {
+                    std::vector<doublereal>& Res = ResElem[idxFD[k]];
+
+                    for (integer q: Hit) {
+                         ElemBlock& oBlock = ElemBlocks[ColElem[q].first];
+                         const auto pFirst = oBlock.Idx.begin();
+                         const auto pLast = oBlock.Idx.end();
+
+                         std::fill(Res.begin() + oBlock.iResOffset, Res.begin() + oBlock.iResOffset + oBlock.Idx.size(), 0.);
+
+                         const SubVectorHandler& WorkVec = pDM->ElemAssRes(oBlock.pEl, dCoef);
+
+                         for (integer r = 1; r <= WorkVec.iGetSize(); ++r) {
+                              const integer i = WorkVec.iGetRowIndex(r) - 1;
+                              const auto pIdx = std::lower_bound(pFirst, pLast, i);
+
+                              if (pIdx == pLast || *pIdx != i) {
+                                   if (WorkVec.dGetCoef(r) != 0.) {
+                                        oBlock.bComplete = false;
+                                   }
+                                   continue;
+                              }
+
+                              Res[oBlock.iResOffset + (pIdx - pFirst)] += WorkVec.dGetCoef(r);
+                         }
+                    }
+               }
+
+               const doublereal dPertNext = (k + 1 < pertFD.size()) ? pertFD[k + 1] - pertFD[k] : 0.;
+
+               for (integer g = GroupPtr[c]; g < GroupPtr[c + 1]; ++g) {
+                    const integer j = GroupCol[g] + 1;
+
+                    inc.PutCoef(j, dPertNext * hCol[j - 1]);
+               }
+          }
+
+          for (integer q: Hit) {
+               const ElemBlock& oBlock = ElemBlocks[ColElem[q].first];
+               const integer l = ColElem[q].second;
+               const integer n = oBlock.Idx.size();
+               const doublereal h = hCol[oBlock.Idx[l]];
+
+               for (integer r = 0; r < n; ++r) {
+                    doublereal Jacrl = 0.;
+
+                    for (size_t k = 0; k < coefFD.size(); ++k) {
+                         Jacrl -= ResElem[idxFD[k]][oBlock.iResOffset + r] * coefFD[k];
+                    }
+
+                    JacElemFD[oBlock.iJacOffset + l * n + r] = Jacrl / h;
+               }
+          }
+     }
+}
+
+namespace {
+     // Collects the contribution of a single element, addressed by global
+     // indices, into a dense block over the rows and columns in Idx
+     class ElemBlockMatrixHandler: public MatrixHandler {
+     public:
+          ElemBlockMatrixHandler(const std::vector<integer>& Idx, doublereal* pdBlock, integer iNumRows, integer iNumCols)
+               :Idx(Idx), pdBlock(pdBlock), iNumRows(iNumRows), iNumCols(iNumCols), bComplete(true), dDummy(0.) {
+               Reset();
+          }
+
+#ifdef DEBUG
+          virtual void IsValid(void) const override {
+               NO_OP;
+          }
+#endif /* DEBUG */
+
+          virtual void Resize(integer, integer) override {
+               throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+          }
+
+          virtual void Reset(void) override {
+               std::fill(pdBlock, pdBlock + Idx.size() * Idx.size(), 0.);
+          }
+
+          virtual void PutCoef(integer iRow, integer iCol, const doublereal& dCoef) override {
+               (*this)(iRow, iCol) = dCoef;
+          }
+
+          virtual void IncCoef(integer iRow, integer iCol, const doublereal& dCoef) override {
+               (*this)(iRow, iCol) += dCoef;
+          }
+
+          virtual void DecCoef(integer iRow, integer iCol, const doublereal& dCoef) override {
+               (*this)(iRow, iCol) -= dCoef;
+          }
+
+          virtual const doublereal& operator () (integer iRow, integer iCol) const override {
+               const integer p = iGetPos(iRow, iCol);
+
+               return p >= 0 ? pdBlock[p] : dZero;
+          }
+
+          virtual doublereal& operator () (integer iRow, integer iCol) override {
+               const integer p = iGetPos(iRow, iCol);
+
+               if (p < 0) {
+                    // entries outside of the block are not replaced
+                    bComplete = false;
+                    dDummy = 0.;
+
+                    return dDummy;
+               }
+
+               return pdBlock[p];
+          }
+
+          virtual integer iGetNumRows(void) const override {
+               return iNumRows;
+          }
+
+          virtual integer iGetNumCols(void) const override {
+               return iNumCols;
+          }
+
+          virtual MatrixHandler* Copy() const override {
+               throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+          }
+
+          bool bIsComplete(void) const {
+               return bComplete;
+          }
+
+     private:
+          integer iGetPos(integer iRow, integer iCol) const {
+               const auto pRow = std::lower_bound(Idx.begin(), Idx.end(), iRow - 1);
+               const auto pCol = std::lower_bound(Idx.begin(), Idx.end(), iCol - 1);
+
+               if (pRow == Idx.end() || *pRow != iRow - 1 || pCol == Idx.end() || *pCol != iCol - 1) {
+                    return -1;
+               }
+
+               return (pCol - Idx.begin()) * Idx.size() + (pRow - Idx.begin());
+          }
+
+          const std::vector<integer>& Idx;
+          doublereal* const pdBlock;
+          const integer iNumRows, iNumCols;
+          bool bComplete;
+          doublereal dDummy;
+          static const doublereal dZero;
+     };
+
+     const doublereal ElemBlockMatrixHandler::dZero = 0.;
+}
+
+template <integer N>
+bool ColoredFiniteDifferenceJacobian<N>::bElemJacobianAnalytic(ElemBlock& oBlock, const doublereal dCoef)
+{
+     const integer iNumDofs = inc.iGetSize();
+
+     ElemBlockMatrixHandler oBlockMH(oBlock.Idx, &JacElemAn[oBlock.iJacOffset], iNumDofs, iNumDofs);
+
+     oBlockMH += pDM->ElemAssJac(oBlock.pEl, dCoef);
+
+     return oBlockMH.bIsComplete();
+}
+
+template <integer N>
+bool ColoredFiniteDifferenceJacobian<N>::bElemReplace(const ElemBlock& oBlock) const
+{
+     const integer n = oBlock.Idx.size();
+
+     for (integer l = 0; l < n; ++l) {
+          const doublereal* const pFD = &JacElemFD[oBlock.iJacOffset + l * n];
+          const doublereal* const pAn = &JacElemAn[oBlock.iJacOffset + l * n];
+          doublereal dNormCol = 0.;
+
+          for (integer r = 0; r < n; ++r) {
+               dNormCol = std::max(dNormCol, std::max(fabs(pFD[r]), fabs(pAn[r])));
+          }
+
+          if (dNormCol == 0.) {
+               continue;
+          }
+
+          for (integer r = 0; r < n; ++r) {
+               if (fabs(pFD[r] - pAn[r]) > dReplaceTol * dNormCol) {
+                    return true;
+               }
+          }
+     }
+
+     return false;
+}
+
+template <integer N>
+bool ColoredFiniteDifferenceJacobian<N>::bElemApply(ElemBlock& oBlock, MatrixHandler* const pJac)
+{
+     // pJac already contains the analytical Jacobian of the element:
+     // add the difference, and restore it if a compact sparse matrix
+     // does not contain all the entries, since the solver is not
+     // asked to rebuild the matrix here
+     const integer n = oBlock.Idx.size();
+     integer iApplied = 0;
+
+     try {
+          for (integer p = 0; p < n * n; ++p, ++iApplied) {
+               const doublereal dDiff = JacElemFD[oBlock.iJacOffset + p] - JacElemAn[oBlock.iJacOffset + p];
+
+               if (dDiff != 0.) {
+                    pJac->IncCoef(oBlock.Idx[p % n] + 1, oBlock.Idx[p / n] + 1, dDiff);
+               }
+          }
+     } catch (MatrixHandler::ErrRebuildMatrix& e) {
+          for (integer p = 0; p < iApplied; ++p) {
+               const doublereal dDiff = JacElemFD[oBlock.iJacOffset + p] - JacElemAn[oBlock.iJacOffset + p];
+
+               if (dDiff != 0.) {
+                    pJac->DecCoef(oBlock.Idx[p % n] + 1, oBlock.Idx[p / n] + 1, dDiff);
+               }
+          }
+
+          if (!oBlock.bWarned) {
+               silent_cerr("Finite difference Jacobian: "
+                           << psElemNames[oBlock.pEl->GetElemType()]
+                           << "(" << oBlock.pEl->GetLabel() << "): "
+                           "the sparsity pattern of the Jacobian matrix does not allow the replacement; "
+                           "using the analytical Jacobian\n");
+               oBlock.bWarned = true;
+          }
+
+          return false;
+     }
+
+     return true;
+}
+
+template
+class ColoredFiniteDifferenceJacobian<2>;
+
+template
+class ColoredFiniteDifferenceJacobian<3>;
+
+template
+class ColoredFiniteDifferenceJacobian<5>;
+
+template
+class ColoredFiniteDifferenceJacobian<7>;
+
 AdForwardModeJacobian::AdForwardModeJacobian(DataManager* pDM, FiniteDifferenceJacobianParam&& oParam)
      :FiniteDifferenceJacobianBase(pDM, std::move(oParam)) {
 }
@@ -43,6 +43,7 @@
 
 #include <array>
 #include <memory>
+#include <vector>
 
 #include "vh.h"
 #include "mh.h"
@@ -95,20 +96,29 @@ struct FiniteDifferenceJacobianParam {
 
      FiniteDifferenceJacobianParam()
           :dFDJacCoef(1e-4),
-           uOutputFlags(FDJAC_OUTPUT_ALL) {
+           uOutputFlags(FDJAC_OUTPUT_ALL),
+           bColoring(false),
+           bReplace(false),
+           dReplaceTol(1e-2) {
      }
 
      FiniteDifferenceJacobianParam(FiniteDifferenceJacobianParam&& oParam)
           :pFDJacMeterStep(std::move(oParam.pFDJacMeterStep)),
            pFDJacMeterIter(std::move(oParam.pFDJacMeterIter)),
            dFDJacCoef(oParam.dFDJacCoef),
-           uOutputFlags(oParam.uOutputFlags) {
+           uOutputFlags(oParam.uOutputFlags),
+           bColoring(oParam.bColoring),
+           bReplace(oParam.bReplace),
+           dReplaceTol(oParam.dReplaceTol) {
      }
 
      std::unique_ptr<DriveCaller> pFDJacMeterStep;
      std::unique_ptr<DriveCaller> pFDJacMeterIter;
      doublereal dFDJacCoef;
      unsigned uOutputFlags;
+     bool bColoring; // perturb structurally orthogonal columns together
+     bool bReplace;  // use the finite difference Jacobian of the elements whose analytical one is wrong
+     doublereal dReplaceTol; // relative difference above which an element is replaced
 };
 
 class FiniteDifferenceJacobianBase: public FiniteDifferenceJacobianParam {
@@ -116,7 +126,7 @@ public:
      FiniteDifferenceJacobianBase(DataManager* pDM, FiniteDifferenceJacobianParam&& oParam);
      virtual ~FiniteDifferenceJacobianBase();
 
-     void JacobianCheck(const NonlinearProblem* pNLP, const MatrixHandler* pJac);
+     void JacobianCheck(const NonlinearProblem* pNLP, MatrixHandler* pJac, doublereal dCoef);
 
 protected:
      struct JacobianStat {
@@ -131,6 +141,11 @@ protected:
 
      virtual void Attach(const MatrixHandler* pJac);
 
+     // Replace, element by element, the contributions to pJac
+     // that differ from the finite difference ones;
+     // the elements to be replaced are selected only if bSelect
+     virtual void ReplaceJacobian(const NonlinearProblem* pNLP, MatrixHandler* pJac, doublereal dCoef, bool bSelect);
+
      void
      Output(const MatrixHandler* pJac,
             const JacobianStat& oJacStatCurr);
@@ -166,6 +181,77 @@ private:
      std::array<MyVectorHandler, N> incsol;
 };
 
+// Compressed (Curtis-Powell-Reid) finite difference Jacobian:
+// the columns of the sparsity pattern are grouped such that no two columns
+// of a group share a row, and all the columns of a group are perturbed at once.
+// The pattern is the union of the element connectivity and of the nonzero
+// structure of the analytical Jacobian.
+template <integer N>
+class ColoredFiniteDifferenceJacobian: public FiniteDifferenceJacobianBase, private FiniteDifferenceOperator<N> {
+public:
+     struct ElemBlock {
+          Elem* pEl;
+          std::vector<integer> Idx; // rows and columns, sorted, zero based
+          integer iResOffset;
+          integer iJacOffset;
+          bool bActive;     // finite difference Jacobian being computed
+          bool bComplete;   // no contribution outside of Idx
+          bool bReplaced;
+          bool bWarned;
+     };
+
+     ColoredFiniteDifferenceJacobian(DataManager* pDM, FiniteDifferenceJacobianParam&& oParam);
+     virtual ~ColoredFiniteDifferenceJacobian();
+
+private:
+     virtual void JacobianCheckImpl(const NonlinearProblem* pNLP, const MatrixHandler* pJac, JacobianStat& oJacStatCurr) override final;
+
+     virtual void Attach(const MatrixHandler* pJac) override final;
+
+     virtual void ReplaceJacobian(const NonlinearProblem* pNLP, MatrixHandler* pJac, doublereal dCoef, bool bSelect) override final;
+
+     void ElemJacobianFD(const NonlinearProblem* pNLP, doublereal dCoef);
+     bool bElemJacobianAnalytic(ElemBlock& rBlock, doublereal dCoef);
+     bool bElemReplace(const ElemBlock& rBlock) const;
+     bool bElemApply(ElemBlock& rBlock, MatrixHandler* pJac);
+
+     bool bPatternCovers(const MatrixHandler* pJac) const;
+     void PatternBuild(const MatrixHandler* pJac);
+     void PatternColor();
+
+     using FiniteDifferenceOperator<N>::pertFD;
+     using FiniteDifferenceOperator<N>::idxFD;
+     using FiniteDifferenceOperator<N>::coefFD;
+
+     std::array<MyVectorHandler, N> incsol;
+
+     // sparsity pattern, compressed column format, zero based
+     std::vector<integer> ColPtr;
+     std::vector<integer> RowIdx;
+
+     // columns of each color, zero based
+     std::vector<integer> GroupPtr;
+     std::vector<integer> GroupCol;
+
+     // finite difference Jacobian, same layout as RowIdx
+     std::vector<doublereal> JacFD;
+     std::vector<doublereal> hCol;
+
+     // elements whose Jacobian may be replaced; an element only writes
+     // rows and columns of its connected nodes and of its own dofs
+     std::vector<ElemBlock> ElemBlocks;
+
+     // elements connected to each column, with the local column index
+     std::vector<integer> ColElemPtr;
+     std::vector<std::pair<integer, integer> > ColElem;
+
+     // element residuals for each perturbation, and element Jacobians
+     // (dense, column major), at the offsets of ElemBlock
+     std::array<std::vector<doublereal>, N> ResElem;
+     std::vector<doublereal> JacElemFD;
+     std::vector<doublereal> JacElemAn;
+};
+
 // Allow us to validate if sp_grad::SpGradient and sp_grad:GpGradProd are consistent
 class AdForwardModeJacobian: public FiniteDifferenceJacobianBase {
 public:
@@ -38,6 +38,7 @@
 #include "dataman.h"
 #include "filedrv.h"
 #include "fixedstep.h"
+#include "bindrv.h"
 #include "solver.h"
 
 /* FixedStepFileDrive - begin */
@@ -53,12 +54,19 @@ FixedStepFileDrive::FixedStepFileDrive(unsigned int uL,
 		bool bl, bool pz, Drive::Bailout bo)
 : FileDrive(uL, pDH, sFileName, ind, v0),
 dT0(t0), dDT(dt), iNumSteps(ins),
-bLinear(bl), bPadZeroes(pz), boWhen(bo), pd(0), pvd(0)
+bLinear(bl), bPadZeroes(pz), boWhen(bo), pBin(0), pd(0), pvd(0)
 {
 	ASSERT(iNumDrives > 0);
 	ASSERT(sFileName != NULL);
 	ASSERT(dDT > 0.);
 
+	if (BinDriveFile::bIsBinary(sFileName)) {
+		OpenBinary(ins);
+
+		ServePending(pDH->dGetTime());
+		return;
+	}
+
 	std::ifstream in(sFileName);
 	if (!in) {
 		silent_cerr("FixedStepFileDrive(" << uL << "): "
@@ -170,7 +178,7 @@ bLinear(bl), bPadZeroes(pz), boWhen(bo), pd(0), pvd(0)
 	}
 
 	SAFENEWARR(pd, doublereal, iNumDrives*iNumSteps);
-	SAFENEWARR(pvd, doublereal*, iNumDrives + 1);
+	SAFENEWARR(pvd, const doublereal*, iNumDrives + 1);
 
 	/* Attenzione: il primo puntatore e' vuoto
 	 * (ne e' stato allocato uno in piu'),
@@ -181,7 +189,7 @@ bLinear(bl), bPadZeroes(pz), boWhen(bo), pd(0), pvd(0)
 
 	for (integer j = 0; j < iNumSteps; j++) {
 		for (integer i = 1; i <= iNumDrives; i++) {
-			in >> pvd[i][j];
+			in >> pd[(i - 1)*iNumSteps + j];
 			if (in.eof()) {
 				silent_cerr("unexpected end of file '"
 					<< sFileName << '\'' << std::endl);
@@ -219,10 +227,68 @@ bLinear(bl), bPadZeroes(pz), boWhen(bo), pd(0), pvd(0)
 
 FixedStepFileDrive::~FixedStepFileDrive(void)
 {
-	SAFEDELETEARR(pd);
+	if (pd != 0) {
+		SAFEDELETEARR(pd);
+	}
+
+	if (pBin != 0) {
+		SAFEDELETE(pBin);
+	}
+
 	SAFEDELETEARR(pvd);
 }
 
+void
+FixedStepFileDrive::OpenBinary(integer ins)
+{
+	SAFENEWWITHCONSTRUCTOR(pBin, BinDriveFile, BinDriveFile(sFileName));
+
+	if (pBin->bIsVariableStep()) {
+		silent_cerr("FixedStepFileDrive(" << GetLabel() << "): "
+			"file \"" << sFileName << "\" contains variable step data"
+			<< std::endl);
+		throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+	}
+
+	if (pBin->iGetNumColumns() != iNumDrives) {
+		silent_cerr("FixedStepFileDrive(" << GetLabel() << "): "
+			"file \"" << sFileName << "\" contains "
+			<< pBin->iGetNumColumns() << " channels, "
+			<< iNumDrives << " expected" << std::endl);
+		throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+	}
+
+	if (ins == -1) {
+		iNumSteps = pBin->iGetNumSteps();
+
+		silent_cout("FixedStepFileDrive(" << GetLabel() << "): "
+			"counted " << iNumSteps << " steps" << std::endl);
+
+	} else if (ins > pBin->iGetNumSteps()) {
+		silent_cerr("FixedStepFileDrive(" << GetLabel() << "): "
+			"file \"" << sFileName << "\" contains "
+			<< pBin->iGetNumSteps() << " steps, "
+			<< ins << " expected" << std::endl);
+		throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+	}
+
+	/* values provided in the input file override the header */
+	if (dT0 == dFromFile) {
+		dT0 = pBin->dGetInitialTime();
+	}
+
+	if (dDT == dFromFile) {
+		dDT = pBin->dGetTimeStep();
+	}
+
+	/* the channels are read in place from the mapped file */
+	SAFENEWARR(pvd, const doublereal*, iNumDrives + 1);
+	pvd[0] = 0;
+	for (integer i = 0; i < iNumDrives; i++) {
+		pvd[i + 1] = pBin->pGetColumn(i);
+	}
+}
+
 
 /* Scrive il contributo del DriveCaller al file di restart */
 std::ostream&
@@ -250,6 +316,10 @@ FixedStepFileDrive::ServePending(const doublereal& t)
 			}
 
 		} else {
+			if (pBin != 0) {
+				pBin->Touch(0);
+			}
+
 			for (int i = 1; i <= iNumDrives; i++) {
 				pdVal[i] = pvd[i][0];
 			}
@@ -268,6 +338,10 @@ FixedStepFileDrive::ServePending(const doublereal& t)
 			}
 
 		} else {
+			if (pBin != 0) {
+				pBin->Touch(iNumSteps - 1);
+			}
+
 			for (int i = 1; i <= iNumDrives; i++) {
 				pdVal[i] = pvd[i][iNumSteps - 1];
 			}
@@ -275,6 +349,10 @@ FixedStepFileDrive::ServePending(const doublereal& t)
 
 	} else {
 		integer j1 = integer(floor(tt/dDT));
+		if (pBin != 0) {
+			pBin->Touch(j1);
+		}
+
 		if (bLinear) {
 			if (j1 == iNumSteps - 1) {
 				for (int i = 1; i <= iNumDrives; i++) {
@@ -38,6 +38,8 @@
 
 /* FixedStepFileDrive - begin */
 
+class BinDriveFile;
+
 class FixedStepFileDrive : public FileDrive {
 protected:
 	doublereal dT0;
@@ -47,8 +49,13 @@ protected:
 	bool bPadZeroes;
 	Bailout boWhen;
 
+	/* binary input file, if any */
+	BinDriveFile* pBin;
+
 	doublereal* pd;
-	doublereal** pvd;
+	const doublereal** pvd;
+
+	void OpenBinary(integer ins);
 
 public:
 	FixedStepFileDrive(unsigned int uL, const DriveHandler* pDH,
@@ -0,0 +1,254 @@
+/*
+ * MBDyn (C) is a multibody analysis code.
+ * http://www.mbdyn.org
+ *
+ * Copyright (C) 1996-2023
+ *
+ * Pierangelo Masarati  <masarati@aero.polimi.it>
+ * Paolo Mantegazza     <mantegazza@aero.polimi.it>
+ *
+ * Dipartimento di Ingegneria Aerospaziale - Politecnico di Milano
+ * via La Masa, 34 - 20156 Milano, Italy
+ * http://www.aero.polimi.it
+ *
+ * Changing this copyright notice is forbidden.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation (version 2 of the License).
+ *
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Runs a rotor with a uniform inflow model, whose blades are made
+ * of aerodynamic bodies, once with the scalar DataManager and once
+ * with the MultiThreadDataManager, and compares at each time step
+ * the state of the hub and the forces and moments accumulated
+ * by the induced velocity element.
+ * When configured with --enable-multithread-assres (the default
+ * with --enable-multithread) the second run assembles the residual
+ * concurrently, with the inflow computed up front.
+ *
+ * usage: mtassrestest [<number of threads> [<output file name>]]
+ */
+
+#include "mbconfig.h"           /* This goes first in every *.c,*.cc file */
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include "myassert.h"
+#include "mynewmem.h"
+#include "except.h"
+#include "table.h"
+#include "mathp.h"
+#include "input.h"
+#include "mbpar.h"
+#include "solver.h"
+#include "dataman.h"
+#include "indvel.h"
+#ifdef USE_MULTITHREAD
+#include "mtdataman.h"
+#endif /* USE_MULTITHREAD */
+
+static const unsigned uNumBlades = 4;
+static const unsigned uNumSections = 10;
+static const unsigned uNumSteps = 20;
+static const double dOmega = 40.;
+static const double dRadius = 1.;
+
+static std::string
+RotorInput(void)
+{
+     std::ostringstream in;
+
+     in << "begin: initial value;\n"
+        << "     initial time: 0.;\n"
+        << "     final time: 1.;\n"
+        << "     time step: 1e-3;\n"
+        << "     method: ms, 0.6;\n"
+        << "     tolerance: 1e-10;\n"
+        << "     max iterations: 20;\n"
+        << "     linear solver: naive, colamd;\n"
+        << "     output: none;\n"
+        << "end: initial value;\n"
+        << "begin: control data;\n"
+        << "     structural nodes: 2;\n"
+        << "     rigid bodies: 1;\n"
+        << "     joints: 2;\n"
+        << "     aerodynamic elements: " << uNumBlades*uNumSections << ";\n"
+        << "     induced velocity elements: 1;\n"
+        << "     air properties;\n"
+        << "     default output: none;\n"
+        << "end: control data;\n"
+        << "begin: nodes;\n"
+        << "     structural: 1, static, null, eye, null, null;\n"
+        << "     structural: 2, dynamic, null, eye, null, 0., 0., " << dOmega << ";\n"
+        << "end: nodes;\n"
+        << "begin: elements;\n"
+        << "     joint: 1, clamp, 1, node, node;\n"
+        << "     joint: 2, revolute pin, 2, null, hinge, eye, null, hinge, eye;\n"
+        << "     body: 2, 2, 5., null, diag, 1., 1., 2.;\n"
+        << "     air properties: 1.225, 340., single, 0., 0., -1., const, 2.;\n"
+        << "     induced velocity: 99, rotor, 1, 2, induced velocity, uniform, " << dOmega << ", " << dRadius << ";\n";
+
+     for (unsigned uBlade = 0; uBlade < uNumBlades; ++uBlade) {
+          for (unsigned uSection = 0; uSection < uNumSections; ++uSection) {
+               const double r = dRadius*(uSection + .5)/uNumSections;
+
+               in << "     aerodynamic body: " << 100 + uBlade*uNumSections + uSection
+                  << ", 2, induced velocity, 99,\n"
+                  << "          reference, node, " << r << "*cos(" << uBlade << "*pi/2), "
+                  << r << "*sin(" << uBlade << "*pi/2), 0.,\n"
+                  << "          reference, node, 3, 0., 0., 1., 1, cos(" << uBlade << "*pi/2 - pi/2), "
+                  << "sin(" << uBlade << "*pi/2 - pi/2), 0.,\n"
+                  << "          " << dRadius/uNumSections << ", const, 0.1, const, 0., const, -0.025, const, 8.*deg2rad,\n"
+                  << "          1, naca0012;\n";
+          }
+     }
+
+     in << "end: elements;\n";
+
+     return in.str();
+}
+
+struct StepData {
+     std::vector<doublereal> X;
+     Vec3 F;
+     Vec3 M;
+};
+
+static bool
+Run(MathParser& MP, unsigned nThreads, const std::string& sOutputFileName, std::vector<StepData>& Steps)
+{
+     std::istringstream in(RotorInput());
+     InputStream In(in);
+     MBDynParser HP(MP, In, "mtassrestest");
+     Solver oSolver(HP, "mtassrestest", sOutputFileName, nThreads, false);
+
+     if (!oSolver.Prepare() || !oSolver.Start()) {
+          silent_cerr("mtassrestest: unable to start the simulation" << std::endl);
+          return false;
+     }
+
+     DataManager* const pDM = oSolver.pGetDataManager();
+
+#ifdef USE_MULTITHREAD
+     if (nThreads > 1 && dynamic_cast<MultiThreadDataManager*>(pDM) == 0) {
+          silent_cerr("mtassrestest: no multithread data manager" << std::endl);
+          return false;
+     }
+#endif /* USE_MULTITHREAD */
+
+     const InducedVelocity* const pIV = dynamic_cast<const InducedVelocity*>(pDM->pFindElem(Elem::INDUCEDVELOCITY, 99));
+
+     ASSERT(pIV != 0);
+
+     for (unsigned uStep = 0; uStep < uNumSteps; ++uStep) {
+          if (!oSolver.Advance()) {
+               silent_cerr("mtassrestest: simulation stopped at step " << uStep << std::endl);
+               return false;
+          }
+
+          StepData s;
+          const VectorHandler& X = *pDM->GetpXCurr();
+
+          for (integer i = 1; i <= X.iGetSize(); ++i) {
+               s.X.push_back(X(i));
+          }
+
+          s.F = pIV->GetForces();
+          s.M = pIV->GetMoments();
+
+          Steps.push_back(s);
+     }
+
+     return true;
+}
+
+int
+main(int argc, char* argv[])
+{
+     const unsigned nThreads = argc > 1 ? atoi(argv[1]) : 4;
+     const std::string sOutputFileName = argc > 2 ? argv[2] : "mtassrestest";
+     int rc = EXIT_SUCCESS;
+
+#ifndef USE_MULTITHREAD
+     silent_cerr("mtassrestest: configure with --enable-multithread "
+                 "to run threaded assembly" << std::endl);
+#endif /* ! USE_MULTITHREAD */
+
+#ifndef USE_AEROD2_F
+     silent_cerr("mtassrestest: the NACA 0012 airfoil data are not available" << std::endl);
+     return rc;
+#endif /* ! USE_AEROD2_F */
+
+     try {
+          // only one math parser per process
+          Table T(true);
+          MathParser MP(T);
+          std::vector<StepData> Serial, Threaded;
+
+          if (!Run(MP, 1, sOutputFileName + "_1", Serial)
+              || !Run(MP, nThreads, sOutputFileName + "_mt", Threaded))
+          {
+               return EXIT_FAILURE;
+          }
+
+          // only the summation order of the threads may differ
+          const doublereal dTol = 1e-10;
+          doublereal dMaxDiffX = 0., dMaxDiffF = 0.;
+
+          for (unsigned uStep = 0; uStep < uNumSteps; ++uStep) {
+               const StepData& s = Serial[uStep];
+               const StepData& t = Threaded[uStep];
+
+               ASSERT(s.X.size() == t.X.size());
+
+               for (std::vector<doublereal>::size_type i = 0; i < s.X.size(); ++i) {
+                    dMaxDiffX = std::max(dMaxDiffX, std::fabs(s.X[i] - t.X[i])/std::max(1., std::fabs(s.X[i])));
+               }
+
+               const doublereal dNormF = std::max(1., s.F.Norm());
+               const doublereal dNormM = std::max(1., s.M.Norm());
+
+               dMaxDiffF = std::max(dMaxDiffF, (s.F - t.F).Norm()/dNormF);
+               dMaxDiffF = std::max(dMaxDiffF, (s.M - t.M).Norm()/dNormM);
+          }
+
+          const StepData& s = Serial.back();
+
+          std::cout << "mtassrestest: " << uNumSteps << " steps with " << nThreads << " threads\n"
+                    << "rotor force: " << s.F << "\n"
+                    << "rotor moment: " << s.M << "\n"
+                    << "maximum difference of the state: " << dMaxDiffX << "\n"
+                    << "maximum difference of the rotor forces: " << dMaxDiffF << std::endl;
+
+          if (s.F.Norm() == 0.) {
+               silent_cerr("mtassrestest: no forces passed to the rotor" << std::endl);
+               rc = EXIT_FAILURE;
+          }
+
+          if (dMaxDiffX > dTol || dMaxDiffF > dTol) {
+               silent_cerr("mtassrestest: threaded residual check failed" << std::endl);
+               rc = EXIT_FAILURE;
+          }
+     } catch (const std::exception& err) {
+          silent_cerr("mtassrestest: an exception occurred: " << err.what() << std::endl);
+          rc = EXIT_FAILURE;
+     }
+
+     return rc;
+}
@@ -55,12 +55,17 @@ extern "C" {
 }
 
 #include <cerrno>
+#include <cstdlib>
+#include <cstdint>
+#include <algorithm>
 
 #include "mtdataman.h"
 #include "spmapmh.h"
 #include "task2cpu.h"
+#ifdef MBDYN_X_MT_ASSRES
+#include "indvel.h"
+#endif /* MBDYN_X_MT_ASSRES */
 
-#ifdef USE_NAIVE_MULTITHREAD
 static inline void
 do_lock(volatile AO_TS_t *p)
 {
@@ -73,6 +78,7 @@ do_unlock(AO_TS_t *p)
         AO_CLEAR(p);
 }
 
+#ifdef USE_NAIVE_MULTITHREAD
 static void
 naivepsad(doublereal **ga, integer **gri,
                 integer *gnzr, integer **gci, integer *gnzc, char **gnz,
@@ -115,6 +121,227 @@ naivepsad(doublereal **ga, integer **gri,
 }
 #endif
 
+/* same as naivepsad(), for the sparse storage: each thread owns
+ * a range of rows, so only the column lists need locking */
+static void
+spnaivpsad(spnaiv_mat *g, const spnaiv_mat *a,
+                integer from, integer to, AO_TS_t *lock)
+{
+        for (integer r = from; r < to; r++) {
+                const spnaiv_row *par = &a->row[r];
+
+                for (integer i = 0; i < par->nzc; i++) {
+                        integer c = par->ci[i];
+                        doublereal d = *spnaiv_get(a, r, c);
+                        doublereal *pg = spnaiv_get(g, r, c);
+
+                        if (pg) {
+                                *pg += d;
+                                continue;
+                        }
+
+                        pg = spnaiv_rowins(g, r, c);
+                        if (pg == 0) {
+                                throw std::bad_alloc();
+                        }
+                        *pg = d;
+
+                        do_lock(&lock[c]);
+                        int rc = spnaiv_colins(g, c, r);
+                        do_unlock(&lock[c]);
+
+                        if (rc) {
+                                throw std::bad_alloc();
+                        }
+                }
+        }
+}
+
+/* CCScatterMatrixHandler - begin */
+
+CCScatterMatrixHandler::CCScatterMatrixHandler(void)
+: pMH(0), pCache(0), iCurr(0), bDefer(false), bChanged(false)
+{
+        NO_OP;
+}
+
+CCScatterMatrixHandler::~CCScatterMatrixHandler(void)
+{
+        NO_OP;
+}
+
+#ifdef DEBUG
+void
+CCScatterMatrixHandler::IsValid(void) const
+{
+        ASSERT(pMH != 0);
+}
+#endif /* DEBUG */
+
+void
+CCScatterMatrixHandler::SetMatrix(CompactSparseMatrixHandler *p, bool bD)
+{
+        pMH = p;
+        pCache = 0;
+        iCurr = 0;
+        bDefer = bD;
+        Queue.clear();
+}
+
+bool
+CCScatterMatrixHandler::bGetChanged(void)
+{
+        bool b = bChanged;
+
+        bChanged = false;
+
+        return b;
+}
+
+void
+CCScatterMatrixHandler::Op(integer iRow, integer iCol, const doublereal& d, bool bPut)
+{
+        ASSERT(pMH != 0);
+        ASSERT(pCache != 0);
+
+        std::vector<Entry>& c = pCache->Entries;
+        const std::vector<Entry>::size_type n = c.size();
+        doublereal *pd;
+
+        /* usually, coefficients are assembled in the same order */
+        if (iCurr < n && c[iCurr].iRow == iRow && c[iCurr].iCol == iCol) {
+                pd = c[iCurr].pd;
+                iCurr++;
+
+        } else {
+                /* otherwise, bisect the row indices of the column;
+                 * throws ErrRebuildMatrix if not in the pattern */
+                pd = &(*pMH)(iRow, iCol);
+
+                std::vector<unsigned>& idx = pCache->Sorted;
+                std::vector<unsigned>::iterator i = std::lower_bound(idx.begin(), idx.end(), pd,
+                        [&c](unsigned k, const doublereal *p) { return c[k].pd < p; });
+
+                if (i != idx.end() && c[*i].pd == pd) {
+                        iCurr = *i + 1;
+
+                } else {
+                        Entry e;
+                        e.iRow = iRow;
+                        e.iCol = iCol;
+                        e.pd = pd;
+                        idx.insert(i, unsigned(n));
+                        c.push_back(e);
+                        iCurr = c.size();
+                        bChanged = true;
+
+                        if (bDefer) {
+                                Deferred q;
+                                q.pd = pd;
+                                q.d = d;
+                                q.bPut = bPut;
+                                Queue.push_back(q);
+                                return;
+                        }
+                }
+        }
+
+        if (bPut) {
+                *pd = d;
+
+        } else {
+                *pd += d;
+        }
+}
+
+void
+CCScatterMatrixHandler::ApplyDeferred(void)
+{
+        for (std::vector<Deferred>::const_iterator i = Queue.begin(); i != Queue.end(); ++i) {
+                if (i->bPut) {
+                        *i->pd = i->d;
+
+                } else {
+                        *i->pd += i->d;
+                }
+        }
+
+        Queue.clear();
+}
+
+void
+CCScatterMatrixHandler::Resize(integer, integer)
+{
+        silent_cerr("CCScatterMatrixHandler::Resize() not allowed" << std::endl);
+        throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+}
+
+void
+CCScatterMatrixHandler::Reset(void)
+{
+        silent_cerr("CCScatterMatrixHandler::Reset() not allowed" << std::endl);
+        throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+}
+
+void
+CCScatterMatrixHandler::PutCoef(integer iRow, integer iCol, const doublereal& dCoef)
+{
+        Op(iRow, iCol, dCoef, true);
+}
+
+void
+CCScatterMatrixHandler::IncCoef(integer iRow, integer iCol, const doublereal& dCoef)
+{
+        Op(iRow, iCol, dCoef, false);
+}
+
+void
+CCScatterMatrixHandler::DecCoef(integer iRow, integer iCol, const doublereal& dCoef)
+{
+        Op(iRow, iCol, -dCoef, false);
+}
+
+const doublereal&
+CCScatterMatrixHandler::operator () (integer iRow, integer iCol) const
+{
+        ASSERT(pMH != 0);
+
+        return static_cast<const MatrixHandler&>(*pMH)(iRow, iCol);
+}
+
+doublereal&
+CCScatterMatrixHandler::operator () (integer, integer)
+{
+        /* direct write access would bypass the cache */
+        silent_cerr("CCScatterMatrixHandler::operator() not allowed" << std::endl);
+        throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+}
+
+integer
+CCScatterMatrixHandler::iGetNumRows(void) const
+{
+        ASSERT(pMH != 0);
+
+        return pMH->iGetNumRows();
+}
+
+integer
+CCScatterMatrixHandler::iGetNumCols(void) const
+{
+        ASSERT(pMH != 0);
+
+        return pMH->iGetNumCols();
+}
+
+MatrixHandler*
+CCScatterMatrixHandler::Copy(void) const
+{
+        silent_cerr("CCScatterMatrixHandler::Copy() not allowed" << std::endl);
+        throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+}
+
+/* CCScatterMatrixHandler - end */
+
 /* MultiThreadDataManager - begin */
 
 
@@ -130,7 +357,8 @@ MultiThreadDataManager::MultiThreadDataManager(MBDynParser& HP,
                 const char* sOutputFileName,
                 const char* sInputFileName,
                 bool bAbortAfterInput,
-                unsigned nThreads)
+                unsigned nThreads,
+                bool bWorkStealing)
 :
 DataManager(HP, OF, pS, dInitialTime, sOutputFileName, sInputFileName, bAbortAfterInput),
 AssMode(ASS_UNKNOWN),
@@ -138,7 +366,20 @@ CCReady(CC_NO),
 thread_data(0),
 op(MultiThreadDataManager::OP_UNKNOWN),
 thread_count(0),
-propagate_ErrMatrixRebuild(AO_TS_INITIALIZER)
+propagate_ErrMatrixRebuild(AO_TS_INITIALIZER),
+ElemPartition(nThreads, bWorkStealing),
+#ifdef MBDYN_X_MT_ASSRES
+ResElemPartition(nThreads, bWorkStealing),
+pAssResAbsHdl(0),
+bSerialAssRes(false),
+#endif /* MBDYN_X_MT_ASSRES */
+pCurrNodeSeg(0),
+pCurrElemSeg(0),
+pCurrCCSeg(0),
+bCCColored(false),
+bCCRecolor(false),
+pCCMH(0),
+pdCCMat(0)
 {
         DataManager::nThreads = nThreads;
 
@@ -185,12 +426,21 @@ propagate_ErrMatrixRebuild(AO_TS_INITIALIZER)
                 throw ErrGeneric(MBDYN_EXCEPT_ARGS);
         }
 
+        ElemPartitionInit();
+#ifdef MBDYN_X_MT_ASSRES
+        ResElemPartitionInit();
+#endif /* MBDYN_X_MT_ASSRES */
+        SegmentsInit(Nodes, NodeSegments);
+        SegmentsInit(Elems, ElemSegments);
         ThreadSpawn();
 }
 
 MultiThreadDataManager::~MultiThreadDataManager(void)
 {
         ThreadDestroy();
+        SegmentsDestroy(NodeSegments);
+        SegmentsDestroy(ElemSegments);
+        CCScatterDestroy();
         pthread_mutex_destroy(&thread_mutex);
         pthread_cond_destroy(&thread_cond);
 }
@@ -218,6 +468,9 @@ void MultiThreadDataManager::ThreadDestroy(void)
         if (thread_data[0].lock) {
                 SAFEDELETEARR(thread_data[0].lock);
         }
+        if (thread_data[0].spnaive_lock) {
+                SAFEDELETEARR(thread_data[0].spnaive_lock);
+        }
         thread_cleanup(&thread_data[0]);
 
         SAFEDELETEARR(thread_data);
@@ -250,6 +503,11 @@ MultiThreadDataManager::thread(void *p)
 
         SetAffinity(*arg);
 
+#ifdef MBDYN_X_MT_ASSRES
+        /* selects the induced velocity force accumulators */
+        InducedVelocity::SetThread(arg->threadNumber);
+#endif /* MBDYN_X_MT_ASSRES */
+
         while (bKeepGoing) {
              /* stop here until told to start */
              /*
@@ -285,6 +543,26 @@ MultiThreadDataManager::thread(void *p)
                             throw;
                        }
                        break;
+
+                  case MultiThreadDataManager::OP_ASSJAC_SPMAP:
+                       arg->pDM->DataManager::AssJac(*arg->pSpMapJacHdl,
+                                                     arg->dCoef,
+                                                     arg->ElemIter,
+                                                     *arg->pWorkMat);
+                       break;
+
+                  case MultiThreadDataManager::OP_ASSJAC_CC_COLORED:
+                       try {
+                            arg->pDM->ThreadCCAssJac(*arg);
+
+                       } catch (MatrixHandler::ErrRebuildMatrix& e) {
+                            silent_cerr("thread " << arg->threadNumber
+                                        << " caught ErrRebuildMatrix"
+                                        << std::endl);
+
+                            mbdyn_test_and_set(&arg->pDM->propagate_ErrMatrixRebuild);
+                       }
+                       break;
 #ifdef USE_NAIVE_MULTITHREAD
                   case MultiThreadDataManager::OP_ASSJAC_NAIVE:
 #if 0
@@ -319,6 +597,26 @@ MultiThreadDataManager::thread(void *p)
                        break;
                   }
 #endif
+                  case MultiThreadDataManager::OP_ASSJAC_SPNAIVE:
+                       arg->pDM->DataManager::AssJac(*arg->ppSpNaiveJacHdl[arg->threadNumber],
+                                                     arg->dCoef,
+                                                     arg->ElemIter,
+                                                     *arg->pWorkMat);
+                       break;
+
+                  case MultiThreadDataManager::OP_SUM_SPNAIVE:
+                  {
+                       SpNaiveMatrixHandler* to = arg->ppSpNaiveJacHdl[0];
+                       integer nn = to->iGetNumRows();
+                       integer iFrom = (nn*(arg->threadNumber))/arg->pDM->nThreads;
+                       integer iTo = (nn*(arg->threadNumber + 1))/arg->pDM->nThreads;
+                       for (unsigned int matrix = 1; matrix < arg->pDM->nThreads; matrix++) {
+                            spnaivpsad(&to->m, &arg->ppSpNaiveJacHdl[matrix]->m,
+                                       iFrom, iTo, arg->spnaive_lock);
+                       }
+                       break;
+                  }
+
                   case MultiThreadDataManager::OP_ASSJAC_GRAD:
                   {
                        arg->pDM->DataManager::AssJac(arg->oGradJacHdl,
@@ -339,16 +637,30 @@ MultiThreadDataManager::thread(void *p)
                                                      *arg->pWorkMat);
                        break;
                   }
+                  case MultiThreadDataManager::OP_BEFOREPREDICT:
+                  case MultiThreadDataManager::OP_AFTERPREDICT:
+                  case MultiThreadDataManager::OP_UPDATE:
+                  case MultiThreadDataManager::OP_AFTERCONVERGENCE:
+                  case MultiThreadDataManager::OP_DERIVATIVESUPDATE:
+                       arg->pDM->ThreadEntityPass(*arg);
+                       break;
+
 #ifdef MBDYN_X_MT_ASSRES
                   case MultiThreadDataManager::OP_ASSRES:
+                  {
+                       VectorHandler *pAbsResHdl = 0;
+                       if (arg->pDM->pAssResAbsHdl) {
+                            pAbsResHdl = arg->pAbsResHdl;
+                            pAbsResHdl->Reset();
+                       }
                        arg->pResHdl->Reset();
-                       if (arg->pAbsResHdl) arg->pAbsResHdl->Reset();
                        arg->pDM->DataManager::AssRes(*arg->pResHdl,
                                                      arg->dCoef,
-                                                     arg->ElemIter,
+                                                     arg->ResElemIter,
                                                      *arg->pWorkVec,
-                                                     arg->pAbsResHdl);
+                                                     pAbsResHdl);
                        break;
+                  }
 #endif /* MBDYN_X_MT_ASSRES */
 
                   case MultiThreadDataManager::OP_EXIT:
@@ -383,11 +695,15 @@ MultiThreadDataManager::thread_cleanup(ThreadData *arg)
         SAFEDELETE(arg->pWorkMatA);
         SAFEDELETE(arg->pWorkMatB);
         SAFEDELETE(arg->pWorkVec);
+        SAFEDELETE(arg->pScatterHdl);
 
         if (arg->threadNumber > 0) {
                 if (arg->pJacHdl) {
                         SAFEDELETE(arg->pJacHdl);
                 }
+                if (arg->pSpMapJacHdl) {
+                        SAFEDELETE(arg->pSpMapJacHdl);
+                }
 #ifdef MBDYN_X_MT_ASSRES
                 SAFEDELETE(arg->pResHdl);
 #endif
@@ -397,6 +713,10 @@ MultiThreadDataManager::thread_cleanup(ThreadData *arg)
                         arg->ppNaiveJacHdl[arg->threadNumber] = nullptr;
                 }
 #endif
+                if (arg->ppSpNaiveJacHdl && arg->ppSpNaiveJacHdl[arg->threadNumber]) {
+                        SAFEDELETE(arg->ppSpNaiveJacHdl[arg->threadNumber]);
+                        arg->ppSpNaiveJacHdl[arg->threadNumber] = nullptr;
+                }
                 if (arg->pAbsResHdl) {
                      SAFEDELETE(arg->pAbsResHdl);
                 }
@@ -408,6 +728,11 @@ MultiThreadDataManager::thread_cleanup(ThreadData *arg)
                         arg->ppNaiveJacHdl = nullptr;
                 }
 #endif
+                if (arg->ppSpNaiveJacHdl) {
+                        // can be nonzero only when in sparse Naive form
+                        SAFEDELETEARR(arg->ppSpNaiveJacHdl);
+                        arg->ppSpNaiveJacHdl = nullptr;
+                }
         }
 
         if (arg->pJacProd) {
@@ -450,100 +775,415 @@ MultiThreadDataManager::EndOfOp(void)
         pthread_mutex_unlock(&thread_mutex);
 }
 
-/* starts the helper threads */
+/*
+ * Splits the elements in contiguous chunks of (roughly) the same cost,
+ * once for all; the cost of each element is estimated by the size
+ * of its Jacobian submatrix.  The same partition is reused
+ * by all the threaded assembly operations.
+ */
 void
-MultiThreadDataManager::ThreadSpawn(void)
+MultiThreadDataManager::ElemPartitionInit(void)
 {
-        ASSERT(nThreads > 1);
+        std::vector<unsigned> Weights(Elems.size());
 
-        SAFENEWARRNOFILL(thread_data, MultiThreadDataManager::ThreadData, nThreads);
+        for (unsigned i = 0; i < Elems.size(); i++) {
+                integer iNumRows = 0;
+                integer iNumCols = 0;
 
-        const Task2CPU& oCPUSet = Task2CPU::GetGlobalState();
-        int iCPUIndex = oCPUSet.iGetFirstCPU();
-        const unsigned uNumCPUs = oCPUSet.iGetCount();
+                Elems[i]->WorkSpaceDim(&iNumRows, &iNumCols);
 
-        for (unsigned i = 0; i < nThreads; i++) {
-                /* callback data */
-                thread_data[i].pDM = this;
-                sem_init(&thread_data[i].sem, 0, 0);
-                thread_data[i].threadNumber = i;
+                Weights[i] = std::abs(iNumRows)*iNumCols;
+        }
 
-                if (uNumCPUs >= nThreads) {
-                     thread_data[i].iCPUIndex = iCPUIndex;
-                     iCPUIndex = oCPUSet.iGetNextCPU(iCPUIndex);
-                } else {
-                     thread_data[i].iCPUIndex = -1;
+        ElemPartition.Partition(Weights);
+
+        silent_cout("MultiThreadDataManager: " << Elems.size() << " elements "
+                        "in " << ElemPartition.iGetNumChunks() << " chunks"
+                        << (ElemPartition.bGetSteal() ? " (work stealing)" : "")
+                        << std::endl);
+}
+
+#ifdef MBDYN_X_MT_ASSRES
+void
+MultiThreadDataManager::ResElemPartitionInit(void)
+{
+        std::vector<unsigned> Weights;
+
+        for (unsigned i = 0; i < Elems.size(); i++) {
+                /* loadable induced velocity elements are not
+                 * of type Elem::INDUCEDVELOCITY */
+                InducedVelocity *pIV = dynamic_cast<InducedVelocity *>(Elems[i]);
+                if (pIV != 0) {
+                        pIV->SetNumThreads(nThreads);
+                        IndVels.push_back(pIV);
+                        IndVelElems.push_back(Elems[i]);
+
+                        if (!pIV->bConcurrentForces()) {
+                                bSerialAssRes = true;
+                        }
+                        continue;
                 }
 
-                thread_data[i].ElemIter.Init(&Elems[0], Elems.size());
-                thread_data[i].lock = 0;
+                integer iNumRows = 0;
+                integer iNumCols = 0;
 
-                /* SubMatrixHandlers */
-                thread_data[i].pWorkMatA = 0;
-                thread_data[i].pWorkMatB = 0;
+                Elems[i]->WorkSpaceDim(&iNumRows, &iNumCols);
 
-                if (bUseAutoDiff()) {
-                     SAFENEWWITHCONSTRUCTOR(thread_data[i].pWorkMatA,
-                                            VariableSubMatrixHandlerAd,
-                                            VariableSubMatrixHandlerAd(iMaxWorkNumRowsJac,
-                                                                       iMaxWorkNumColsJac,
-                                                                       iMaxWorkNumItemsJac));
+                ResElems.push_back(Elems[i]);
+                Weights.push_back(std::abs(iNumRows)*iNumCols);
+        }
 
-                     SAFENEWWITHCONSTRUCTOR(thread_data[i].pWorkMatB,
-                                            VariableSubMatrixHandlerAd,
-                                            VariableSubMatrixHandlerAd(iMaxWorkNumRowsJac,
-                                                                       iMaxWorkNumColsJac,
-                                                                       iMaxWorkNumItemsJac));
-                } else {
-                     SAFENEWWITHCONSTRUCTOR(thread_data[i].pWorkMatA,
-                                            VariableSubMatrixHandlerNonAd,
-                                            VariableSubMatrixHandlerNonAd(iMaxWorkNumRowsJac,
-                                                                          iMaxWorkNumColsJac,
-                                                                          iMaxWorkNumItemsJac));
+        ResElemPartition.Partition(Weights);
 
-                     SAFENEWWITHCONSTRUCTOR(thread_data[i].pWorkMatB,
-                                            VariableSubMatrixHandlerNonAd,
-                                            VariableSubMatrixHandlerNonAd(iMaxWorkNumRowsJac,
-                                                                          iMaxWorkNumColsJac,
-                                                                          iMaxWorkNumItemsJac));
+        if (bSerialAssRes) {
+                silent_cout("MultiThreadDataManager: residual assembled serially "
+                        "because of induced velocity elements that do not support "
+                        "concurrent force accumulation" << std::endl);
+        }
+}
+#endif /* MBDYN_X_MT_ASSRES */
+
+template <class T>
+void
+MultiThreadDataManager::SegmentsInit(const std::vector<T *>& Entities,
+        std::vector<EntitySegment>& Segments)
+{
+        unsigned iNumConcurrent = 0;
+
+        Segments.clear();
+
+        for (unsigned i = 0; i < Entities.size(); ) {
+                EntitySegment seg;
+                bool bSerial = Entities[i]->bIsOrderDependent();
+
+                seg.iFirst = i;
+                seg.pPart = 0;
+                for (i++; i < Entities.size() && Entities[i]->bIsOrderDependent() == bSerial; i++) {
+                        NO_OP;
+                }
+                seg.iSize = i - seg.iFirst;
+
+                /* too short segments are not worth the synchronization */
+                if (!bSerial && seg.iSize >= nThreads) {
+                        SAFENEWWITHCONSTRUCTOR(seg.pPart, MT_VecPartition,
+                                MT_VecPartition(nThreads, ElemPartition.bGetSteal()));
+                        seg.pPart->Partition(std::vector<unsigned>(seg.iSize, 1));
+                        iNumConcurrent += seg.iSize;
                 }
-                
-                thread_data[i].pWorkMat = thread_data[i].pWorkMatA;
 
-                thread_data[i].pWorkVec = 0;
-                SAFENEWWITHCONSTRUCTOR(thread_data[i].pWorkVec,
-                                MySubVectorHandler,
-                                MySubVectorHandler(iMaxWorkNumRowsRes));
+                /* merge consecutive serial segments */
+                if (seg.pPart == 0 && !Segments.empty() && Segments.back().pPart == 0) {
+                        Segments.back().iSize += seg.iSize;
 
-                /* set by AssJac when in CC form */
-                thread_data[i].pJacHdl = 0;
-#ifdef USE_NAIVE_MULTITHREAD
-                /* set by AssJac when in Naive form */
-                thread_data[i].ppNaiveJacHdl = 0;
-#endif
-                thread_data[i].pY = thread_data[i].pJacProd = nullptr;
-                
-                if (i > 0) {
-                        SAFENEWWITHCONSTRUCTOR(thread_data[i].pJacProd,
-                                               MyVectorHandler,
-                                               MyVectorHandler(iTotDofs));
+                } else {
+                        Segments.push_back(seg);
                 }
-#ifdef MBDYN_X_MT_ASSRES
-                /* set below */
-                thread_data[i].pResHdl = 0;
-#endif
-                thread_data[i].pAbsResHdl = 0;
+        }
 
-                /* to be sure... */
-                thread_data[i].pMatA = 0;
-                thread_data[i].pMatB = 0;
+        DEBUGCERR("MultiThreadDataManager: " << Segments.size() << " segments, "
+                << iNumConcurrent << " of " << Entities.size()
+                << " entities processed concurrently" << std::endl);
+}
 
-                if (i == 0) {
-                        continue;
+void
+MultiThreadDataManager::SegmentsDestroy(std::vector<EntitySegment>& Segments)
+{
+        for (std::vector<EntitySegment>::iterator i = Segments.begin(); i != Segments.end(); ++i) {
+                if (i->pPart) {
+                        SAFEDELETE(i->pPart);
                 }
-#ifdef MBDYN_X_MT_ASSRES
-                SAFENEWWITHCONSTRUCTOR(thread_data[i].pResHdl,
-                                MyVectorHandler, MyVectorHandler(iTotDofs));
+        }
+
+        Segments.clear();
+}
+
+void
+MultiThreadDataManager::NodesPass(DataManagerOp o, VecIter<Node *>& Iter) const
+{
+        switch (o) {
+        case OP_BEFOREPREDICT:
+                NodesBeforePredict(Iter, *BeforePredictArgs.pX, *BeforePredictArgs.pXP,
+                        *BeforePredictArgs.pqXPr, *BeforePredictArgs.pqXPPr);
+                break;
+
+        case OP_AFTERPREDICT:
+                NodesAfterPredict(Iter);
+                break;
+
+        case OP_UPDATE:
+                NodesUpdate(Iter);
+                break;
+
+        case OP_AFTERCONVERGENCE:
+                NodesAfterConvergence(Iter);
+                break;
+
+        case OP_DERIVATIVESUPDATE:
+                NodesDerivativesUpdate(Iter);
+                break;
+
+        default:
+                throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+        }
+}
+
+void
+MultiThreadDataManager::ElemsPass(DataManagerOp o, VecIter<Elem *>& Iter) const
+{
+        switch (o) {
+        case OP_BEFOREPREDICT:
+                ElemsBeforePredict(Iter, *BeforePredictArgs.pX, *BeforePredictArgs.pXP,
+                        *BeforePredictArgs.pqXPr, *BeforePredictArgs.pqXPPr);
+                break;
+
+        case OP_AFTERPREDICT:
+                ElemsAfterPredict(Iter);
+                break;
+
+        case OP_UPDATE:
+                ElemsUpdate(Iter);
+                break;
+
+        case OP_AFTERCONVERGENCE:
+                ElemsAfterConvergence(Iter);
+                break;
+
+        case OP_DERIVATIVESUPDATE:
+                ElemsDerivativesUpdate(Iter);
+                break;
+
+        default:
+                throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+        }
+}
+
+/* executed by each thread on its share of the current segment */
+void
+MultiThreadDataManager::ThreadEntityPass(ThreadData& td) const
+{
+        if (pCurrNodeSeg) {
+                td.SegNodeIter.Init(&Nodes[pCurrNodeSeg->iFirst], pCurrNodeSeg->iSize,
+                        pCurrNodeSeg->pPart, td.threadNumber);
+                NodesPass(op, td.SegNodeIter);
+
+        } else {
+                ASSERT(pCurrElemSeg != 0);
+                td.SegElemIter.Init(&Elems[pCurrElemSeg->iFirst], pCurrElemSeg->iSize,
+                        pCurrElemSeg->pPart, td.threadNumber);
+                ElemsPass(op, td.SegElemIter);
+        }
+}
+
+void
+MultiThreadDataManager::EntityPass(DataManagerOp o) const
+{
+        ASSERT(thread_data != NULL);
+
+        MultiThreadDataManager *pDM = const_cast<MultiThreadDataManager *>(this);
+
+        for (unsigned s = 0; s < NodeSegments.size() + ElemSegments.size(); s++) {
+                const bool bNodes = (s < NodeSegments.size());
+                const EntitySegment& seg = bNodes ? NodeSegments[s] : ElemSegments[s - NodeSegments.size()];
+
+                if (seg.pPart == 0) {
+                        if (bNodes) {
+                                VecIter<Node *> Iter(&Nodes[seg.iFirst], seg.iSize);
+                                NodesPass(o, Iter);
+
+                        } else {
+                                VecIter<Elem *> Iter(&Elems[seg.iFirst], seg.iSize);
+                                ElemsPass(o, Iter);
+                        }
+                        continue;
+                }
+
+                pCurrNodeSeg = bNodes ? &seg : 0;
+                pCurrElemSeg = bNodes ? 0 : &seg;
+                seg.pPart->Reset();
+
+                pDM->op = o;
+                pDM->thread_count = nThreads - 1;
+
+                for (unsigned i = 0; i < nThreads; ++i) {
+                        thread_data[i].except = std::exception_ptr{};
+                }
+
+                for (unsigned i = 1; i < nThreads; i++) {
+                        sem_post(&thread_data[i].sem);
+                }
+
+                try {
+                        ThreadEntityPass(thread_data[0]);
+                } catch (...) {
+                        thread_data[0].except = std::current_exception();
+                }
+
+                pthread_mutex_lock(&pDM->thread_mutex);
+                while (thread_count > 0) {
+                        pthread_cond_wait(&pDM->thread_cond, &pDM->thread_mutex);
+                }
+                pthread_mutex_unlock(&pDM->thread_mutex);
+
+                pCurrNodeSeg = pCurrElemSeg = 0;
+
+                for (unsigned i = 0; i < nThreads; ++i) {
+                        if (thread_data[i].except) {
+                                std::rethrow_exception(thread_data[i].except);
+                        }
+                }
+        }
+}
+
+void
+MultiThreadDataManager::DerivativesUpdate(void) const
+{
+        EntityPass(OP_DERIVATIVESUPDATE);
+}
+
+void
+MultiThreadDataManager::BeforePredict(VectorHandler& X, VectorHandler& XP,
+        std::deque<VectorHandler*>& qXPr,
+        std::deque<VectorHandler*>& qXPPr) const
+{
+        BeforePredictArgs.pX = &X;
+        BeforePredictArgs.pXP = &XP;
+        BeforePredictArgs.pqXPr = &qXPr;
+        BeforePredictArgs.pqXPPr = &qXPPr;
+
+        EntityPass(OP_BEFOREPREDICT);
+
+        BeforePredictArgs.pX = BeforePredictArgs.pXP = 0;
+        BeforePredictArgs.pqXPr = BeforePredictArgs.pqXPPr = 0;
+}
+
+void
+MultiThreadDataManager::AfterPredict(void) const
+{
+        /* reset any external convergence requirement before starting
+         * a new step */
+        ConvergedReset();
+
+        EntityPass(OP_AFTERPREDICT);
+}
+
+void
+MultiThreadDataManager::Update(void) const
+{
+        EntityPass(OP_UPDATE);
+}
+
+void
+MultiThreadDataManager::AfterConvergence(void) const
+{
+        EntityPass(OP_AFTERCONVERGENCE);
+
+        AfterConvergenceRestart();
+        AfterConvergenceCheckpoint();
+}
+
+/* starts the helper threads */
+void
+MultiThreadDataManager::ThreadSpawn(void)
+{
+        ASSERT(nThreads > 1);
+
+        SAFENEWARRNOFILL(thread_data, MultiThreadDataManager::ThreadData, nThreads);
+
+        const Task2CPU& oCPUSet = Task2CPU::GetGlobalState();
+        int iCPUIndex = oCPUSet.iGetFirstCPU();
+        const unsigned uNumCPUs = oCPUSet.iGetCount();
+
+        for (unsigned i = 0; i < nThreads; i++) {
+                /* callback data */
+                thread_data[i].pDM = this;
+                sem_init(&thread_data[i].sem, 0, 0);
+                thread_data[i].threadNumber = i;
+
+                if (uNumCPUs >= nThreads) {
+                     thread_data[i].iCPUIndex = iCPUIndex;
+                     iCPUIndex = oCPUSet.iGetNextCPU(iCPUIndex);
+                } else {
+                     thread_data[i].iCPUIndex = -1;
+                }
+
+                thread_data[i].ElemIter.Init(&Elems[0], Elems.size(), &ElemPartition, i);
+#ifdef MBDYN_X_MT_ASSRES
+                thread_data[i].ResElemIter.Init(ResElems.data(), ResElems.size(), &ResElemPartition, i);
+#endif /* MBDYN_X_MT_ASSRES */
+                thread_data[i].lock = 0;
+                thread_data[i].spnaive_lock = 0;
+
+                /* SubMatrixHandlers */
+                thread_data[i].pWorkMatA = 0;
+                thread_data[i].pWorkMatB = 0;
+
+                if (bUseAutoDiff()) {
+                     SAFENEWWITHCONSTRUCTOR(thread_data[i].pWorkMatA,
+                                            VariableSubMatrixHandlerAd,
+                                            VariableSubMatrixHandlerAd(iMaxWorkNumRowsJac,
+                                                                       iMaxWorkNumColsJac,
+                                                                       iMaxWorkNumItemsJac));
+
+                     SAFENEWWITHCONSTRUCTOR(thread_data[i].pWorkMatB,
+                                            VariableSubMatrixHandlerAd,
+                                            VariableSubMatrixHandlerAd(iMaxWorkNumRowsJac,
+                                                                       iMaxWorkNumColsJac,
+                                                                       iMaxWorkNumItemsJac));
+                } else {
+                     SAFENEWWITHCONSTRUCTOR(thread_data[i].pWorkMatA,
+                                            VariableSubMatrixHandlerNonAd,
+                                            VariableSubMatrixHandlerNonAd(iMaxWorkNumRowsJac,
+                                                                          iMaxWorkNumColsJac,
+                                                                          iMaxWorkNumItemsJac));
+
+                     SAFENEWWITHCONSTRUCTOR(thread_data[i].pWorkMatB,
+                                            VariableSubMatrixHandlerNonAd,
+                                            VariableSubMatrixHandlerNonAd(iMaxWorkNumRowsJac,
+                                                                          iMaxWorkNumColsJac,
+                                                                          iMaxWorkNumItemsJac));
+                }
+                
+                thread_data[i].pWorkMat = thread_data[i].pWorkMatA;
+
+                thread_data[i].pWorkVec = 0;
+                SAFENEWWITHCONSTRUCTOR(thread_data[i].pWorkVec,
+                                MySubVectorHandler,
+                                MySubVectorHandler(iMaxWorkNumRowsRes));
+
+                /* set by AssJac when in CC form */
+                thread_data[i].pJacHdl = 0;
+                thread_data[i].pSpMapJacHdl = 0;
+                thread_data[i].pScatterHdl = 0;
+                SAFENEW(thread_data[i].pScatterHdl, CCScatterMatrixHandler);
+#ifdef USE_NAIVE_MULTITHREAD
+                /* set by AssJac when in Naive form */
+                thread_data[i].ppNaiveJacHdl = 0;
+#endif
+                /* set by AssJac when in sparse Naive form */
+                thread_data[i].ppSpNaiveJacHdl = 0;
+                thread_data[i].pY = thread_data[i].pJacProd = nullptr;
+                
+                if (i > 0) {
+                        SAFENEWWITHCONSTRUCTOR(thread_data[i].pJacProd,
+                                               MyVectorHandler,
+                                               MyVectorHandler(iTotDofs));
+                }
+#ifdef MBDYN_X_MT_ASSRES
+                /* set below */
+                thread_data[i].pResHdl = 0;
+#endif
+                thread_data[i].pAbsResHdl = 0;
+
+                /* to be sure... */
+                thread_data[i].pMatA = 0;
+                thread_data[i].pMatB = 0;
+
+                if (i == 0) {
+                        continue;
+                }
+#ifdef MBDYN_X_MT_ASSRES
+                SAFENEWWITHCONSTRUCTOR(thread_data[i].pResHdl,
+                                MyVectorHandler, MyVectorHandler(iTotDofs));
 
                 SAFENEWWITHCONSTRUCTOR(thread_data[i].pAbsResHdl,
                                 MyVectorHandler, MyVectorHandler(iTotDofs));
@@ -566,6 +1206,7 @@ void
 MultiThreadDataManager::AssJac(MatrixHandler& JacHdl, doublereal dCoef)
 {
         SpGradientSparseMatrixHandler* pGradJacHdl = nullptr;
+        SpNaiveMatrixHandler* pSpNaiveJacHdl = nullptr;
 #ifdef USE_NAIVE_MULTITHREAD
         NaiveMatrixHandler* pNaiveJacHdl = nullptr;
 #endif
@@ -582,6 +1223,9 @@ MultiThreadDataManager::AssJac(MatrixHandler& JacHdl, doublereal dCoef)
                 AssMode = ASS_NAIVE;
                 NaiveAssJacInit(*pNaiveJacHdl, dCoef);
 #endif
+        } else if ((pSpNaiveJacHdl = dynamic_cast<SpNaiveMatrixHandler*>(&JacHdl))) {
+                AssMode = ASS_SPNAIVE;
+                SpNaiveAssJacInit(*pSpNaiveJacHdl, dCoef);
         } else {
                 AssMode = ASS_DEFAULT;
                 // Single threaded assembly needed for eigenanalysis using lapack
@@ -662,6 +1306,7 @@ MultiThreadDataManager::CCAssJac(MatrixHandler& JacHdl, doublereal dCoef)
         while (false) {
 retry:;
                 CCReady = CC_NO;
+                CCScatterDestroy();
                 for (unsigned i = 1; i < nThreads; i++) {
                         if (thread_data[i].pJacHdl) {
                                 SAFEDELETE(thread_data[i].pJacHdl);
@@ -671,15 +1316,25 @@ retry:;
         }
 
         switch (CCReady) {
-        case CC_NO:
+        case CC_NO: {
                 DEBUGCERR("CC_NO => CC_FIRST" << std::endl);
 
-                ASSERT(dynamic_cast<SpMapMatrixHandler *>(&JacHdl) != 0);
+                /* the sparsity pattern is discovered by the CC solution
+                 * managers, which hand out a SpMapMatrixHandler until
+                 * they have compressed it; this pass only occurs
+                 * after the pattern changes, and the scatter positions
+                 * are recorded at the next one, on the CC storage */
+                auto *pSpMH = dynamic_cast<SpMapMatrixHandler *>(&JacHdl);
+                if (pSpMH) {
+                        SpMapAssJac(*pSpMH, dCoef);
 
-                DataManager::AssJac(JacHdl, dCoef, ElemIter, *pWorkMat);
+                } else {
+                        DataManager::AssJac(JacHdl, dCoef, ElemIter, *pWorkMat);
+                }
                 CCReady = CC_FIRST;
 
                 return;
+        }
 
         case CC_FIRST:
                 if (pMH == 0) {
@@ -688,13 +1343,26 @@ retry:;
 
                 DEBUGCERR("CC_FIRST => CC_YES" << std::endl);
 
-                for (unsigned i = 1; i < nThreads; i++) {
-                        thread_data[i].pJacHdl = pMH->Copy();
+                /* symbolic assembly: caches the positions and colors
+                 * the elements, while assembling the matrix */
+                try {
+                        CCScatterInit(*pMH, dCoef);
+
+                } catch (MatrixHandler::ErrRebuildMatrix& e) {
+                        CCScatterDestroy();
+                        CCReady = CC_NO;
+                        throw;
+                }
+
+                if (!bCCColored) {
+                        for (unsigned i = 1; i < nThreads; i++) {
+                                thread_data[i].pJacHdl = pMH->Copy();
+                        }
                 }
 
                 CCReady = CC_YES;
 
-                break;
+                return;
 
         case CC_YES:
                 if (pMH == 0) {
@@ -703,6 +1371,34 @@ retry:;
 
                 DEBUGCERR("CC_YES" << std::endl);
 
+                if (bCCColored) {
+                        if (pMH != pCCMH || pMH->pdGetMat() != pdCCMat) {
+                                /* the cached positions are no longer valid */
+                                CCScatterDestroy();
+                                CCReady = CC_FIRST;
+                                CCAssJac(JacHdl, dCoef);
+                                return;
+                        }
+
+                        if (bCCRecolor) {
+                                /* some elements contributed new coefficients */
+                                bCCRecolor = false;
+                                if (!CCColorInit(*pMH)) {
+                                        /* no longer worth it:
+                                         * back to per-thread matrices */
+                                        CCScatterDestroy();
+                                        for (unsigned i = 1; i < nThreads; i++) {
+                                                thread_data[i].pJacHdl = pMH->Copy();
+                                        }
+                                }
+                        }
+                }
+
+                if (bCCColored) {
+                        CCColoredAssJac(*pMH, dCoef);
+                        return;
+                }
+
                 break;
 
         default:
@@ -768,6 +1464,388 @@ retry:;
         }
 }
 
+/*
+ * Assembly of the map the CC solution managers use while the sparsity
+ * pattern is not known yet: each thread assembles its elements
+ * into its own map, which is then added to JacHdl; the maps
+ * are only needed once per pattern, so they are released afterwards.
+ */
+void
+MultiThreadDataManager::SpMapAssJac(SpMapMatrixHandler& JacHdl, doublereal dCoef)
+{
+        for (unsigned i = 1; i < nThreads; i++) {
+                ASSERT(thread_data[i].pSpMapJacHdl == 0);
+                SAFENEWWITHCONSTRUCTOR(thread_data[i].pSpMapJacHdl,
+                        SpMapMatrixHandler,
+                        SpMapMatrixHandler(JacHdl.iGetNumRows(), JacHdl.iGetNumCols()));
+        }
+
+        thread_data[0].ElemIter.ResetAccessData();
+        op = MultiThreadDataManager::OP_ASSJAC_SPMAP;
+        thread_count = nThreads - 1;
+
+        for (unsigned i = 0; i < nThreads; ++i) {
+             thread_data[i].except = std::exception_ptr{};
+        }
+
+        for (unsigned i = 1; i < nThreads; i++) {
+                thread_data[i].dCoef = dCoef;
+
+                sem_post(&thread_data[i].sem);
+        }
+
+        try {
+                DataManager::AssJac(JacHdl, dCoef, thread_data[0].ElemIter,
+                                    *thread_data[0].pWorkMat);
+        } catch (...) {
+             thread_data[0].except = std::current_exception();
+        }
+
+        pthread_mutex_lock(&thread_mutex);
+        if (thread_count > 0) {
+                pthread_cond_wait(&thread_cond, &thread_mutex);
+        }
+        pthread_mutex_unlock(&thread_mutex);
+
+        for (unsigned i = 0; i < nThreads; ++i) {
+             if (thread_data[i].except) {
+                  SpMapDestroy();
+                  std::rethrow_exception(thread_data[i].except);
+             }
+        }
+
+        for (unsigned i = 1; i < nThreads; i++) {
+                thread_data[i].pSpMapJacHdl->EnumerateNz([&JacHdl](integer iRow, integer iCol, doublereal d) {
+                        JacHdl.IncCoef(iRow, iCol, d);
+                });
+        }
+
+        SpMapDestroy();
+}
+
+void
+MultiThreadDataManager::SpMapDestroy(void)
+{
+        for (unsigned i = 1; i < nThreads; i++) {
+                if (thread_data[i].pSpMapJacHdl) {
+                        SAFEDELETE(thread_data[i].pSpMapJacHdl);
+                        thread_data[i].pSpMapJacHdl = 0;
+                }
+        }
+}
+
+/*
+ * Serial symbolic assembly: each element is assembled straight
+ * into the matrix, caching the position of each coefficient
+ * in the CC storage; then the elements are colored.
+ */
+void
+MultiThreadDataManager::CCScatterInit(CompactSparseMatrixHandler& MH, doublereal dCoef)
+{
+        CCScatterDestroy();
+
+        CCScatter.resize(Elems.size());
+        pCCMH = &MH;
+        pdCCMat = MH.pdGetMat();
+
+        CCScatterMatrixHandler& SH = *thread_data[0].pScatterHdl;
+        SH.SetMatrix(&MH, false);
+
+        MH.Reset();
+
+        if (!Elems.empty()) {
+                std::vector<unsigned> All(Elems.size());
+                for (unsigned i = 0; i < All.size(); i++) {
+                        All[i] = i;
+                }
+
+                VecIter<unsigned> Iter(&All[0], All.size());
+                CCScatterAssJac(SH, dCoef, Iter, *thread_data[0].pWorkMat);
+        }
+
+        SH.bGetChanged();
+
+        bCCColored = CCColorInit(MH);
+        bCCRecolor = false;
+
+        if (!bCCColored) {
+                CCScatterDestroy();
+        }
+}
+
+/*
+ * Greedy coloring: each element takes the lowest color not used
+ * by the elements that share any of its positions in the CC storage.
+ * Colors are tracked by a bit mask for each position, so at most
+ * 64 colors are used; elements that need more, and those whose color
+ * has less elements than threads, are assembled serially.
+ * Returns false when the serial share is too large to be worth it,
+ * unless the per-thread matrices used instead would be too large.
+ */
+bool
+MultiThreadDataManager::CCColorInit(const CompactSparseMatrixHandler& MH)
+{
+        typedef uint_least64_t ColorMask;
+        const unsigned iMaxColors = 64;
+        const unsigned iSerial = iMaxColors;
+
+        const doublereal *pdBase = MH.pdGetMat();
+        std::vector<ColorMask> Mask(MH.Nz(), 0);
+        std::vector<unsigned> Color(Elems.size());
+        std::vector<unsigned> ColorSize(iMaxColors + 1, 0);
+
+        for (unsigned e = 0; e < Elems.size(); e++) {
+                const std::vector<CCScatterMatrixHandler::Entry>& c = CCScatter[e].Entries;
+                ColorMask m = 0;
+
+                for (std::vector<CCScatterMatrixHandler::Entry>::const_iterator i = c.begin(); i != c.end(); ++i) {
+                        m |= Mask[i->pd - pdBase];
+                }
+
+                unsigned iColor = 0;
+                while (iColor < iMaxColors && (m & (ColorMask(1) << iColor))) {
+                        iColor++;
+                }
+
+                Color[e] = iColor;
+                ColorSize[iColor]++;
+
+                if (iColor == iSerial) {
+                        continue;
+                }
+
+                for (std::vector<CCScatterMatrixHandler::Entry>::const_iterator i = c.begin(); i != c.end(); ++i) {
+                        Mask[i->pd - pdBase] |= ColorMask(1) << iColor;
+                }
+        }
+
+        /* too small colors are not worth the synchronization */
+        for (unsigned iColor = 0; iColor < iMaxColors; iColor++) {
+                if (ColorSize[iColor] > 0 && ColorSize[iColor] < nThreads) {
+                        ColorSize[iSerial] += ColorSize[iColor];
+                        ColorSize[iColor] = 0;
+                }
+        }
+
+        for (unsigned e = 0; e < Elems.size(); e++) {
+                if (ColorSize[Color[e]] == 0) {
+                        Color[e] = iSerial;
+                }
+        }
+
+        /* elements sorted by color, serial ones last */
+        std::vector<unsigned> ColorFirst(iMaxColors + 2, 0);
+        for (unsigned iColor = 0; iColor <= iMaxColors; iColor++) {
+                ColorFirst[iColor + 1] = ColorFirst[iColor] + ColorSize[iColor];
+        }
+
+        CCElemOrder.resize(Elems.size());
+        std::vector<unsigned> Next(ColorFirst.begin(), ColorFirst.end() - 1);
+        for (unsigned e = 0; e < Elems.size(); e++) {
+                CCElemOrder[Next[Color[e]]++] = e;
+        }
+
+        SegmentsDestroy(CCSegments);
+
+        unsigned long iTotWeight = 0;
+        unsigned long iSerialWeight = 0;
+        unsigned iNumColors = 0;
+        for (unsigned iColor = 0; iColor <= iMaxColors; iColor++) {
+                if (ColorSize[iColor] == 0) {
+                        continue;
+                }
+
+                EntitySegment seg;
+                seg.iFirst = ColorFirst[iColor];
+                seg.iSize = ColorSize[iColor];
+                seg.pPart = 0;
+
+                /* the cost of each element is estimated
+                 * by the number of its coefficients */
+                std::vector<unsigned> Weights(seg.iSize);
+                for (unsigned i = 0; i < seg.iSize; i++) {
+                        Weights[i] = CCScatter[CCElemOrder[seg.iFirst + i]].Entries.size() + 1;
+                        iTotWeight += Weights[i];
+                        if (iColor == iSerial) {
+                                iSerialWeight += Weights[i];
+                        }
+                }
+
+                if (iColor != iSerial) {
+                        SAFENEWWITHCONSTRUCTOR(seg.pPart, MT_VecPartition,
+                                MT_VecPartition(nThreads, ElemPartition.bGetSteal()));
+                        seg.pPart->Partition(Weights);
+                        iNumColors++;
+                }
+
+                CCSegments.push_back(seg);
+        }
+
+        bool bWorth = (iSerialWeight*nThreads <= iTotWeight);
+        const char *sHow = "colored assembly";
+        if (!bWorth) {
+                /* each thread but the first needs a copy of the matrix */
+                if (MH.Nz()*(nThreads - 1) > CC_MAX_COPY_NZ) {
+                        bWorth = true;
+                        sHow = "colored assembly (per-thread matrices are too large)";
+
+                } else {
+                        sHow = "per-thread matrices";
+                }
+        }
+
+        silent_cout("MultiThreadDataManager: " << Elems.size() << " elements "
+                "in " << iNumColors << " colors, "
+                << ColorSize[iSerial] << " assembled serially; "
+                "using " << sHow << std::endl);
+
+        return bWorth;
+}
+
+void
+MultiThreadDataManager::CCScatterDestroy(void)
+{
+        CCScatter.clear();
+        CCElemOrder.clear();
+        SegmentsDestroy(CCSegments);
+        bCCColored = false;
+        bCCRecolor = false;
+        pCCMH = 0;
+        pdCCMat = 0;
+}
+
+void
+MultiThreadDataManager::CCScatterAssJac(CCScatterMatrixHandler& SH, doublereal dCoef,
+        VecIter<unsigned>& Iter, VariableSubMatrixHandler& WorkMat)
+{
+        unsigned iElem;
+        for (bool bGot = Iter.bGetFirst(iElem); bGot; bGot = Iter.bGetNext(iElem)) {
+                Elem *pEl = Elems[iElem];
+
+                SH.Begin(CCScatter[iElem]);
+
+                try {
+                        ElemProfiler::Timer t(pElemProf, pEl, ElemProfiler::ASSJAC);
+                        const VariableSubMatrixHandler& WM = pEl->AssJac(WorkMat, dCoef, *pXCurr, *pXPrimeCurr);
+                        t.AddEntries(WM);
+                        SH += WM;
+                }
+                catch (ErrDivideByZero& e) {
+                        silent_cerr("AssJac: divide by zero "
+                                "in " << psElemNames[pEl->GetElemType()]
+                                << "(" << pEl->GetLabel() << ")"
+                                << std::endl);
+                        throw ErrDivideByZero(MBDYN_EXCEPT_ARGS);
+                }
+        }
+}
+
+/* executed by each thread on its share of the current color */
+void
+MultiThreadDataManager::ThreadCCAssJac(ThreadData& td)
+{
+        ASSERT(pCurrCCSeg != 0);
+
+        td.CCIter.Init(&CCElemOrder[pCurrCCSeg->iFirst], pCurrCCSeg->iSize,
+                pCurrCCSeg->pPart, td.threadNumber);
+        CCScatterAssJac(*td.pScatterHdl, td.dCoef, td.CCIter, *td.pWorkMat);
+}
+
+void
+MultiThreadDataManager::CCColoredAssJac(CompactSparseMatrixHandler& MH, doublereal dCoef)
+{
+        ASSERT(!bCCRecolor);
+
+        MH.Reset();
+
+        for (unsigned i = 0; i < nThreads; i++) {
+                thread_data[i].pScatterHdl->SetMatrix(&MH, true);
+                thread_data[i].dCoef = dCoef;
+        }
+
+        for (std::vector<EntitySegment>::const_iterator s = CCSegments.begin(); s != CCSegments.end(); ++s) {
+                if (s->pPart == 0) {
+                        continue;
+                }
+
+                pCurrCCSeg = &(*s);
+                s->pPart->Reset();
+
+                op = MultiThreadDataManager::OP_ASSJAC_CC_COLORED;
+                thread_count = nThreads - 1;
+
+                for (unsigned i = 0; i < nThreads; ++i) {
+                        thread_data[i].except = std::exception_ptr{};
+                }
+
+                for (unsigned i = 1; i < nThreads; i++) {
+                        sem_post(&thread_data[i].sem);
+                }
+
+                try {
+                        ThreadCCAssJac(thread_data[0]);
+
+                } catch (MatrixHandler::ErrRebuildMatrix& e) {
+                        silent_cerr("thread " << thread_data[0].threadNumber
+                                        << " caught ErrRebuildMatrix"
+                                        << std::endl);
+
+                        mbdyn_test_and_set(&propagate_ErrMatrixRebuild);
+                } catch (...) {
+                        thread_data[0].except = std::current_exception();
+                }
+
+                pthread_mutex_lock(&thread_mutex);
+                while (thread_count > 0) {
+                        pthread_cond_wait(&thread_cond, &thread_mutex);
+                }
+                pthread_mutex_unlock(&thread_mutex);
+
+                pCurrCCSeg = 0;
+
+                if (propagate_ErrMatrixRebuild == AO_TS_SET) {
+                        CCScatterDestroy();
+                        CCReady = CC_NO;
+
+                        throw MatrixHandler::ErrRebuildMatrix(MBDYN_EXCEPT_ARGS);
+                }
+
+                for (unsigned i = 0; i < nThreads; ++i) {
+                        if (thread_data[i].except) {
+                                std::rethrow_exception(thread_data[i].except);
+                        }
+                }
+        }
+
+        /* coefficients at new positions, then uncolored elements */
+        for (unsigned i = 0; i < nThreads; i++) {
+                thread_data[i].pScatterHdl->ApplyDeferred();
+        }
+
+        if (!CCSegments.empty() && CCSegments.back().pPart == 0) {
+                const EntitySegment& seg = CCSegments.back();
+                CCScatterMatrixHandler& SH = *thread_data[0].pScatterHdl;
+
+                SH.SetMatrix(&MH, false);
+
+                VecIter<unsigned> Iter(&CCElemOrder[seg.iFirst], seg.iSize);
+                try {
+                        CCScatterAssJac(SH, dCoef, Iter, *thread_data[0].pWorkMat);
+
+                } catch (MatrixHandler::ErrRebuildMatrix& e) {
+                        CCScatterDestroy();
+                        CCReady = CC_NO;
+                        throw;
+                }
+        }
+
+        for (unsigned i = 0; i < nThreads; i++) {
+                if (thread_data[i].pScatterHdl->bGetChanged()) {
+                        bCCRecolor = true;
+                }
+        }
+}
+
 #ifdef USE_NAIVE_MULTITHREAD
 void MultiThreadDataManager::NaiveAssJacInit(NaiveMatrixHandler& JacHdl, doublereal dCoef)
 {
@@ -929,6 +2007,133 @@ MultiThreadDataManager::NaiveAssJac(NaiveMatrixHandler& JacHdl, doublereal dCoef
 }
 #endif
 
+void
+MultiThreadDataManager::SpNaiveAssJacInit(SpNaiveMatrixHandler& JacHdl, doublereal dCoef)
+{
+        /* JacHdl changes any time Solver::SetupSolmans() is called;
+         * the per-thread copies must also refer to its permutation */
+        if (thread_data[0].ppSpNaiveJacHdl
+                && &JacHdl == thread_data[0].ppSpNaiveJacHdl[0]
+                && JacHdl.pGetPerm() == thread_data[0].ppSpNaiveJacHdl[1]->pGetPerm())
+        {
+                SpNaiveAssJac(JacHdl, dCoef);
+                return;
+        }
+
+        if (thread_data[0].ppSpNaiveJacHdl) {
+                for (unsigned i = 1; i < nThreads; i++) {
+                        if (thread_data[0].ppSpNaiveJacHdl[i]) {
+                                SAFEDELETE(thread_data[0].ppSpNaiveJacHdl[i]);
+                        }
+                }
+
+                SAFEDELETEARR(thread_data[0].ppSpNaiveJacHdl);
+                thread_data[0].ppSpNaiveJacHdl = 0;
+        }
+
+        if (thread_data[0].spnaive_lock) {
+                SAFEDELETEARR(thread_data[0].spnaive_lock);
+                thread_data[0].spnaive_lock = 0;
+        }
+
+        /* as in NaiveAssJacInit(): JacHdl is the matrix of the first thread,
+         * the others get an empty copy that only holds what they assemble */
+        SAFENEWARR(thread_data[0].spnaive_lock, AO_TS_t, JacHdl.iGetNumRows());
+
+        for (integer i = 0; i < JacHdl.iGetNumRows(); i++) {
+                thread_data[0].spnaive_lock[i] = AO_TS_INITIALIZER;
+        }
+
+        SAFENEWARR(thread_data[0].ppSpNaiveJacHdl,
+                   SpNaiveMatrixHandler*, nThreads);
+        thread_data[0].ppSpNaiveJacHdl[0] = &JacHdl;
+
+        for (unsigned i = 1; i < nThreads; i++) {
+                thread_data[i].spnaive_lock = thread_data[0].spnaive_lock;
+                thread_data[i].ppSpNaiveJacHdl = thread_data[0].ppSpNaiveJacHdl;
+                thread_data[0].ppSpNaiveJacHdl[i] = 0;
+
+                SAFENEWWITHCONSTRUCTOR(thread_data[0].ppSpNaiveJacHdl[i],
+                                       SpNaiveMatrixHandler,
+                                       SpNaiveMatrixHandler(JacHdl.iGetNumRows(),
+                                                            JacHdl.pGetPerm(),
+                                                            JacHdl.pGetInvPerm()));
+        }
+
+        SpNaiveAssJac(JacHdl, dCoef);
+}
+
+void
+MultiThreadDataManager::SpNaiveAssJac(SpNaiveMatrixHandler& JacHdl, doublereal dCoef)
+{
+        ASSERT(thread_data != NULL);
+
+        /* Assemble per-thread matrix */
+        thread_data[0].ElemIter.ResetAccessData();
+        op = MultiThreadDataManager::OP_ASSJAC_SPNAIVE;
+        thread_count = nThreads - 1;
+
+        for (unsigned i = 0; i < nThreads; ++i) {
+             thread_data[i].except = std::exception_ptr{};
+        }
+
+        for (unsigned i = 1; i < nThreads; i++) {
+                thread_data[i].dCoef = dCoef;
+
+                sem_post(&thread_data[i].sem);
+        }
+
+        try {
+             DataManager::AssJac(JacHdl,
+                                 dCoef,
+                                 thread_data[0].ElemIter,
+                                 *thread_data[0].pWorkMat);
+        } catch (...) {
+             thread_data[0].except = std::current_exception();
+        }
+
+        pthread_mutex_lock(&thread_mutex);
+        if (thread_count > 0) {
+                pthread_cond_wait(&thread_cond, &thread_mutex);
+        }
+        pthread_mutex_unlock(&thread_mutex);
+
+        for (unsigned i = 0; i < nThreads; ++i) {
+             if (thread_data[i].except) {
+                  std::rethrow_exception(thread_data[i].except);
+             }
+        }
+
+        /* Sum per-thread matrices */
+        op = MultiThreadDataManager::OP_SUM_SPNAIVE;
+        thread_count = nThreads - 1;
+        for (unsigned i = 1; i < nThreads; i++) {
+                sem_post(&thread_data[i].sem);
+        }
+
+        integer nn = JacHdl.iGetNumRows();
+        try {
+             for (unsigned matrix = 1; matrix < nThreads; matrix++) {
+                     spnaivpsad(&JacHdl.m, &thread_data[0].ppSpNaiveJacHdl[matrix]->m,
+                                0, nn/nThreads, thread_data[0].spnaive_lock);
+             }
+        } catch (...) {
+             thread_data[0].except = std::current_exception();
+        }
+
+        pthread_mutex_lock(&thread_mutex);
+        if (thread_count > 0) {
+                pthread_cond_wait(&thread_cond, &thread_mutex);
+        }
+        pthread_mutex_unlock(&thread_mutex);
+
+        for (unsigned i = 0; i < nThreads; ++i) {
+             if (thread_data[i].except) {
+                  std::rethrow_exception(thread_data[i].except);
+             }
+        }
+}
+
 void
 MultiThreadDataManager::GradAssJac(SpGradientSparseMatrixHandler& JacHdl, doublereal dCoef)
 {
@@ -995,23 +2200,52 @@ void MultiThreadDataManager::SetAffinity(const ThreadData& oThread)
 
 #ifdef MBDYN_X_MT_ASSRES
 void
-MultiThreadDataManager::AssRes(VectorHandler& ResHdl, doublereal dCoef, const VectorHandler* pAbsResHdl)
+MultiThreadDataManager::AssRes(VectorHandler& ResHdl, doublereal dCoef, VectorHandler*const pAbsResHdl)
         /*throw(ChangedEquationStructure)*/
 {
         ASSERT(thread_data != NULL);
 
-        thread_data[0].ElemIter.ResetAccessData();
+        if (bSerialAssRes) {
+                DataManager::AssRes(ResHdl, dCoef, pAbsResHdl);
+                return;
+        }
+
+        bool bChangedEqStructure = false;
+
+        /* the inflow is computed up front, so the aerodynamic elements
+         * need not wait for it while being assembled concurrently */
+        if (!IndVelElems.empty()) {
+                VecIter<Elem *> IndVelIter(&IndVelElems[0], IndVelElems.size());
+
+                try {
+                        DataManager::AssRes(ResHdl, dCoef, IndVelIter,
+                                *thread_data[0].pWorkVec, pAbsResHdl);
+                } catch (ChangedEquationStructure& e) {
+                        bChangedEqStructure = true;
+                }
+        }
+
+        thread_data[0].ResElemIter.ResetAccessData();
         op = MultiThreadDataManager::OP_ASSRES;
+        pAssResAbsHdl = pAbsResHdl;
         thread_count = nThreads - 1;
 
+        for (unsigned i = 0; i < nThreads; ++i) {
+                thread_data[i].except = std::exception_ptr{};
+        }
+
         for (unsigned i = 1; i < nThreads; i++) {
                 thread_data[i].dCoef = dCoef;
 
                 sem_post(&thread_data[i].sem);
         }
 
-        DataManager::AssRes(ResHdl, dCoef, thread_data[0].ElemIter,
-                        *thread_data[0].pWorkVec, *thread_data[0].pAbsResHdl);
+        try {
+                DataManager::AssRes(ResHdl, dCoef, thread_data[0].ResElemIter,
+                        *thread_data[0].pWorkVec, pAbsResHdl);
+        } catch (...) {
+                thread_data[0].except = std::current_exception();
+        }
 
         pthread_mutex_lock(&thread_mutex);
         if (thread_count > 0) {
@@ -1019,14 +2253,36 @@ MultiThreadDataManager::AssRes(VectorHandler& ResHdl, doublereal dCoef, const Ve
         }
         pthread_mutex_unlock(&thread_mutex);
 
+        pAssResAbsHdl = 0;
+
+        for (std::vector<InducedVelocity *>::iterator i = IndVels.begin();
+                i != IndVels.end(); ++i)
+        {
+                (*i)->ReduceForces();
+        }
+
+        for (unsigned i = 0; i < nThreads; ++i) {
+                if (thread_data[i].except) {
+                        try {
+                                std::rethrow_exception(thread_data[i].except);
+                        } catch (ChangedEquationStructure& e) {
+                                bChangedEqStructure = true;
+                        }
+                }
+        }
+
         for (unsigned i = 1; i < nThreads; i++) {
                 ResHdl += *thread_data[i].pResHdl;
         }
         if (pAbsResHdl) {
                 for (unsigned i = 1; i < nThreads; i++) {
-                        *thread_data[i].pAbsResHdl.AddAbsValuesTo(ResHdl);
+                        *pAbsResHdl += *thread_data[i].pAbsResHdl;
                 }
         }
+
+        if (bChangedEqStructure) {
+                throw ChangedEquationStructure(MBDYN_EXCEPT_ARGS);
+        }
 }
 #endif /* MBDYN_X_MT_ASSRES */
 
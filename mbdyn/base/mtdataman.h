@@ -44,10 +44,84 @@
 #ifdef USE_NAIVE_MULTITHREAD
 #include "naivemh.h"
 #endif
+#include "spnaivemh.h"
 
 #include "sp_gradient_spmh.h"
 
 class Solver;
+class SpMapMatrixHandler;
+
+/*
+ * MatrixHandler used by the colored CC assembly: the position
+ * in the CC storage of each coefficient an element contributes
+ * is looked up once and cached, in the order the element assembles it;
+ * later assemblies reduce to indexed operations on the storage.
+ * Positions that are not in the element's cache yet might be shared
+ * with elements assembled concurrently, so when deferring they are
+ * queued and applied serially by ApplyDeferred().
+ */
+class CCScatterMatrixHandler : public MatrixHandler {
+public:
+        struct Entry {
+                integer iRow;
+                integer iCol;
+                doublereal *pd;
+        };
+        struct Cache {
+                /* in assembly order */
+                std::vector<Entry> Entries;
+                /* indices of Entries, sorted by position */
+                std::vector<unsigned> Sorted;
+
+                void clear(void) { Entries.clear(); Sorted.clear(); };
+        };
+
+protected:
+        CompactSparseMatrixHandler *pMH;
+        Cache *pCache;
+        std::vector<Entry>::size_type iCurr;
+        bool bDefer;
+        bool bChanged;
+
+        struct Deferred {
+                doublereal *pd;
+                doublereal d;
+                bool bPut;
+        };
+        std::vector<Deferred> Queue;
+
+        void Op(integer iRow, integer iCol, const doublereal& d, bool bPut);
+
+public:
+        CCScatterMatrixHandler(void);
+        virtual ~CCScatterMatrixHandler(void);
+
+#ifdef DEBUG
+        virtual void IsValid(void) const override;
+#endif /* DEBUG */
+
+        void SetMatrix(CompactSparseMatrixHandler *p, bool bD);
+        void Begin(Cache& c) { pCache = &c; iCurr = 0; };
+
+        /* true if any cache grew since last call */
+        bool bGetChanged(void);
+        void ApplyDeferred(void);
+
+        virtual void Resize(integer, integer) override;
+        virtual void Reset(void) override;
+
+        virtual void PutCoef(integer iRow, integer iCol, const doublereal& dCoef) override;
+        virtual void IncCoef(integer iRow, integer iCol, const doublereal& dCoef) override;
+        virtual void DecCoef(integer iRow, integer iCol, const doublereal& dCoef) override;
+
+        virtual const doublereal& operator () (integer iRow, integer iCol) const override;
+        virtual doublereal& operator () (integer iRow, integer iCol) override;
+
+        virtual integer iGetNumRows(void) const override;
+        virtual integer iGetNumCols(void) const override;
+
+        virtual MatrixHandler* Copy(void) const override;
+};
 
 /* MultiThreadDataManager - begin */
 
@@ -61,6 +135,7 @@ protected:
 #ifdef USE_NAIVE_MULTITHREAD
                 ASS_NAIVE,		/* use native H-P sparse solver */
 #endif
+                ASS_SPNAIVE,		/* same, with sparse storage */
                 ASS_GRAD,
                 ASS_GRAD_PROD,
 
@@ -83,7 +158,15 @@ protected:
                 pthread_t thread;
                 sem_t sem;
                 std::exception_ptr except;
-                mutable MT_VecIter<Elem *> ElemIter;
+                mutable MT_PartVecIter<Elem *> ElemIter;
+#ifdef MBDYN_X_MT_ASSRES
+                /* for residual assembly (all but induced velocity) */
+                mutable MT_PartVecIter<Elem *> ResElemIter;
+#endif
+
+                /* for per-entity passes */
+                mutable MT_PartVecIter<Node *> SegNodeIter;
+                mutable MT_PartVecIter<Elem *> SegElemIter;
 
                 VariableSubMatrixHandler *pWorkMatA;	/* Working SubMatrix */
                 VariableSubMatrixHandler *pWorkMatB;
@@ -92,10 +175,17 @@ protected:
 
                 /* for CC assembly */
                 CompactSparseMatrixHandler* pJacHdl;
+                /* before the CC pattern is known */
+                SpMapMatrixHandler* pSpMapJacHdl;
+                CCScatterMatrixHandler* pScatterHdl;
+                mutable MT_PartVecIter<unsigned> CCIter;
 #ifdef USE_NAIVE_MULTITHREAD
                 /* for Naive assembly */
                 NaiveMatrixHandler** ppNaiveJacHdl;
 #endif
+                /* for sparse Naive assembly */
+                SpNaiveMatrixHandler** ppSpNaiveJacHdl;
+                AO_TS_t* spnaive_lock;
                 SpGradientSparseMatrixWrapper oGradJacHdl;
                 const VectorHandler* pY;
                 VectorHandler* pJacProd;
@@ -114,21 +204,29 @@ protected:
                 OP_UNKNOWN = -1,
 
                 OP_ASSJAC_CC,
+                OP_ASSJAC_CC_COLORED,
+                OP_ASSJAC_SPMAP,
 #ifdef USE_NAIVE_MULTITHREAD
                 OP_ASSJAC_NAIVE,
                 OP_SUM_NAIVE,
 #endif
+                OP_ASSJAC_SPNAIVE,
+                OP_SUM_SPNAIVE,
                 OP_ASSJAC_GRAD,
                 OP_ASSJAC_PROD,
 
                 /* used only #ifdef MBDYN_X_MT_ASSRES */
                 OP_ASSRES,
 
-                /* not used yet */
-                OP_ASSMATS,
+                /* per-entity passes */
                 OP_BEFOREPREDICT,
                 OP_AFTERPREDICT,
+                OP_UPDATE,
                 OP_AFTERCONVERGENCE,
+                OP_DERIVATIVESUPDATE,
+
+                /* not used yet */
+                OP_ASSMATS,
                 /* end of not used yet */
 
                 OP_EXIT,
@@ -146,6 +244,98 @@ protected:
         /* this is used to propagate ErrMatrixRebuild ... */
         AO_TS_t	propagate_ErrMatrixRebuild;
 
+        /* cost-weighted element chunks, shared by all threads */
+        MT_VecPartition ElemPartition;
+        void ElemPartitionInit(void);
+
+#ifdef MBDYN_X_MT_ASSRES
+        /*
+         * Residual assembly: the induced velocity elements compute
+         * the inflow serially, before all the other elements
+         * are assembled concurrently; the forces the aerodynamic
+         * elements pass them are accumulated per thread,
+         * and reduced once the residual is complete.
+         */
+        std::vector<Elem *> IndVelElems;
+        std::vector<InducedVelocity *> IndVels;
+        std::vector<Elem *> ResElems;
+        MT_VecPartition ResElemPartition;
+        VectorHandler *pAssResAbsHdl;
+        /* some induced velocity element keeps order-dependent state */
+        bool bSerialAssRes;
+        void ResElemPartitionInit(void);
+#endif /* MBDYN_X_MT_ASSRES */
+
+        /*
+         * Per-entity passes (BeforePredict, AfterPredict, Update,
+         * AfterConvergence, DerivativesUpdate): nodes and elements
+         * are split in contiguous segments; order-independent segments
+         * are processed concurrently, order-dependent ones serially,
+         * so the original order among segments is preserved.
+         */
+        struct EntitySegment {
+                unsigned iFirst;
+                unsigned iSize;
+                MT_VecPartition *pPart;		/* 0 when serial */
+        };
+        std::vector<EntitySegment> NodeSegments;
+        std::vector<EntitySegment> ElemSegments;
+
+        /* segment being processed concurrently */
+        mutable const EntitySegment *pCurrNodeSeg;
+        mutable const EntitySegment *pCurrElemSeg;
+
+        /* BeforePredict() arguments */
+        mutable struct {
+                VectorHandler* pX;
+                VectorHandler* pXP;
+                std::deque<VectorHandler*>* pqXPr;
+                std::deque<VectorHandler*>* pqXPPr;
+        } BeforePredictArgs;
+
+        template <class T>
+        void SegmentsInit(const std::vector<T *>& Entities,
+                std::vector<EntitySegment>& Segments);
+        void SegmentsDestroy(std::vector<EntitySegment>& Segments);
+
+        void NodesPass(DataManagerOp o, VecIter<Node *>& Iter) const;
+        void ElemsPass(DataManagerOp o, VecIter<Elem *>& Iter) const;
+        void ThreadEntityPass(ThreadData& td) const;
+        void EntityPass(DataManagerOp o) const;
+
+        /*
+         * Colored CC assembly: elements are colored so that no two
+         * elements of the same color share a position in the CC storage;
+         * the elements of each color are assembled concurrently
+         * straight into the matrix through their cached positions.
+         * Colors that are too small, and the elements that cannot
+         * be colored, are assembled serially afterwards.
+         */
+        std::vector<CCScatterMatrixHandler::Cache> CCScatter;	/* by element */
+        std::vector<unsigned> CCElemOrder;			/* by color */
+        std::vector<EntitySegment> CCSegments;			/* one per color */
+        const EntitySegment *pCurrCCSeg;
+        bool bCCColored;
+        bool bCCRecolor;
+
+        /* matrix the cached positions refer to */
+        const CompactSparseMatrixHandler *pCCMH;
+        const doublereal *pdCCMat;
+
+        void CCScatterInit(CompactSparseMatrixHandler& MH, doublereal dCoef);
+        bool CCColorInit(const CompactSparseMatrixHandler& MH);
+        void CCScatterDestroy(void);
+        void CCScatterAssJac(CCScatterMatrixHandler& SH, doublereal dCoef,
+                VecIter<unsigned>& Iter, VariableSubMatrixHandler& WorkMat);
+        void ThreadCCAssJac(ThreadData& td);
+        void CCColoredAssJac(CompactSparseMatrixHandler& MH, doublereal dCoef);
+        void SpMapAssJac(SpMapMatrixHandler& JacHdl, doublereal dCoef);
+        void SpMapDestroy(void);
+
+        /* per-thread copies of the CC matrix take at most
+         * this many coefficients overall */
+        enum { CC_MAX_COPY_NZ = 1 << 22 };
+
         void EndOfOp(void);
 
         /* thread function */
@@ -162,6 +352,8 @@ protected:
         virtual void NaiveAssJac(NaiveMatrixHandler& JacHdl, doublereal dCoef);
         virtual void NaiveAssJacInit(NaiveMatrixHandler& JacHdl, doublereal dCoef);
 #endif
+        virtual void SpNaiveAssJac(SpNaiveMatrixHandler& JacHdl, doublereal dCoef);
+        virtual void SpNaiveAssJacInit(SpNaiveMatrixHandler& JacHdl, doublereal dCoef);
         void GradAssJac(SpGradientSparseMatrixHandler& JacHdl, doublereal dCoef);
         void GradAssJacProd(VectorHandler& JacY, const VectorHandler& Y, doublereal dCoef);
         virtual void AssJac(VectorHandler& JacY, const VectorHandler& Y, doublereal dCoef) override;
@@ -176,7 +368,8 @@ public:
                         const char* sOutputFileName,
                         const char* sInputFileName,
                         bool bAbortAfterInput,
-                        unsigned nt);
+                        unsigned nt,
+                        bool bWorkStealing = true);
 
         /* distruttore */
         virtual ~MultiThreadDataManager(void);
@@ -184,6 +377,15 @@ public:
         /* Assembla lo jacobiano */
         virtual void AssJac(MatrixHandler& JacHdl, doublereal dCoef) override;
 
+        /* Funzioni di aggiornamento dati durante la simulazione */
+        virtual void DerivativesUpdate(void) const override;
+        virtual void BeforePredict(VectorHandler& X, VectorHandler& XP,
+                std::deque<VectorHandler*>& qXPr,
+                std::deque<VectorHandler*>& qXPPr) const override;
+        virtual void AfterPredict(void) const override;
+        virtual void Update(void) const override;
+        virtual void AfterConvergence(void) const override;
+
 #ifdef MBDYN_X_MT_ASSRES
         /* Assembla il residuo */
         virtual void AssRes(VectorHandler &ResHdl, doublereal dCoef, VectorHandler*const pAbsResHdl = 0)
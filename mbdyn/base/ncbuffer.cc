@@ -0,0 +1,302 @@
+/* $Header$ */
+/*
+ * MBDyn (C) is a multibody analysis code.
+ * http://www.mbdyn.org
+ *
+ * Copyright (C) 1996-2023
+ *
+ * Pierangelo Masarati	<pierangelo.masarati@polimi.it>
+ * Paolo Mantegazza	<paolo.mantegazza@polimi.it>
+ *
+ * Dipartimento di Ingegneria Aerospaziale - Politecnico di Milano
+ * via La Masa, 34 - 20156 Milano, Italy
+ * http://www.aero.polimi.it
+ *
+ * Changing this copyright notice is forbidden.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation (version 2 of the License).
+ *
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* buffered NetCDF output */
+
+#include "mbconfig.h"           /* This goes first in every *.c,*.cc file */
+
+#ifdef USE_NETCDF
+
+#include <algorithm>
+
+#include "ncbuffer.h"
+
+/* NcOutputBuffer - begin */
+
+void
+NcOutputBuffer::Buffer::Clear(void)
+{
+	vars.clear();
+	idx.clear();
+	uBytes = 0;
+	uSteps = 0;
+}
+
+NcOutputBuffer::NcOutputBuffer(netCDF::NcFile *pFile, const Params& params)
+: pFile(pFile),
+params(params),
+pFill(&Buffers[0]),
+pFlush(0),
+tLastFlush(std::chrono::steady_clock::now())
+#ifdef HAVE_THREADS
+, bStop(false)
+#endif /* HAVE_THREADS */
+{
+	ASSERT(pFile != 0);
+
+#ifdef HAVE_THREADS
+	IOThread = std::thread(&NcOutputBuffer::IOThreadFunc, this);
+#endif /* HAVE_THREADS */
+}
+
+NcOutputBuffer::~NcOutputBuffer(void)
+{
+	try {
+		Flush();
+
+	} catch (...) {
+		silent_cerr("NcOutputBuffer: unable to write buffered NetCDF output"
+			<< std::endl);
+	}
+
+#ifdef HAVE_THREADS
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		bStop = true;
+	}
+	cond.notify_all();
+	IOThread.join();
+#endif /* HAVE_THREADS */
+}
+
+#ifdef HAVE_THREADS
+void
+NcOutputBuffer::IOThreadFunc(void)
+{
+	std::unique_lock<std::mutex> lock(mtx);
+
+	while (true) {
+		cond.wait(lock, [this] { return pFlush != 0 || bStop; });
+		if (pFlush == 0) {
+			break;
+		}
+
+		Buffer *pBuf = pFlush;
+		lock.unlock();
+
+		try {
+			Write(*pBuf, pFile, params.bSync);
+
+		} catch (...) {
+			except = std::current_exception();
+		}
+		pBuf->Clear();
+
+		lock.lock();
+		pFlush = 0;
+		cond.notify_all();
+	}
+}
+#endif /* HAVE_THREADS */
+
+void
+NcOutputBuffer::Write(Buffer& b, netCDF::NcFile *pFile, bool bSync)
+{
+	for (std::vector<VarRuns>::const_iterator v = b.vars.begin(); v != b.vars.end(); ++v) {
+		for (std::vector<Run>::const_iterator r = v->runs.begin(); r != v->runs.end(); ++r) {
+			switch (r->type) {
+			case NCB_INT:
+				v->var.putVar(r->start, r->count, reinterpret_cast<const int *>(&r->data[0]));
+				break;
+
+			case NCB_UINT:
+				v->var.putVar(r->start, r->count, reinterpret_cast<const unsigned int *>(&r->data[0]));
+				break;
+
+			case NCB_LONG:
+				v->var.putVar(r->start, r->count, reinterpret_cast<const long *>(&r->data[0]));
+				break;
+
+			case NCB_DOUBLE:
+				v->var.putVar(r->start, r->count, reinterpret_cast<const doublereal *>(&r->data[0]));
+				break;
+			}
+		}
+	}
+
+	if (bSync) {
+		pFile->sync();
+	}
+}
+
+void
+NcOutputBuffer::Append(const netCDF::NcVar& var, DataType type,
+	const std::vector<size_t>& start,
+	const std::vector<size_t>& count,
+	const void *p, size_t uSize)
+{
+	ASSERT(start.size() == count.size());
+
+	for (std::vector<size_t>::const_iterator i = count.begin(); i != count.end(); ++i) {
+		uSize *= *i;
+	}
+
+	std::unordered_map<int, size_t>::const_iterator i = pFill->idx.find(var.getId());
+	if (i == pFill->idx.end()) {
+		i = pFill->idx.insert(std::make_pair(var.getId(), pFill->vars.size())).first;
+		pFill->vars.push_back(VarRuns());
+		pFill->vars.back().var = var;
+	}
+
+	std::vector<Run>& runs = pFill->vars[i->second].runs;
+
+	/* extend the last run along the first (time) dimension if possible */
+	bool bMerge = false;
+	if (!runs.empty()) {
+		const Run& r = runs.back();
+
+		bMerge = (r.type == type
+			&& !start.empty()
+			&& r.start.size() == start.size()
+			&& r.start[0] + r.count[0] == start[0]
+			&& std::equal(start.begin() + 1, start.end(), r.start.begin() + 1)
+			&& std::equal(count.begin() + 1, count.end(), r.count.begin() + 1));
+	}
+
+	if (!bMerge) {
+		runs.push_back(Run());
+		runs.back().type = type;
+		runs.back().start = start;
+		runs.back().count = count;
+		if (!count.empty()) {
+			runs.back().count[0] = 0;
+		}
+	}
+
+	Run& r = runs.back();
+	if (!count.empty()) {
+		r.count[0] += count[0];
+	}
+
+	const char *pc = static_cast<const char *>(p);
+	r.data.insert(r.data.end(), pc, pc + uSize);
+	pFill->uBytes += uSize;
+}
+
+void
+NcOutputBuffer::Put(const netCDF::NcVar& var,
+	const std::vector<size_t>& start, const std::vector<size_t>& count,
+	const int *p)
+{
+	Append(var, NCB_INT, start, count, p, sizeof(int));
+}
+
+void
+NcOutputBuffer::Put(const netCDF::NcVar& var,
+	const std::vector<size_t>& start, const std::vector<size_t>& count,
+	const unsigned int *p)
+{
+	Append(var, NCB_UINT, start, count, p, sizeof(unsigned int));
+}
+
+void
+NcOutputBuffer::Put(const netCDF::NcVar& var,
+	const std::vector<size_t>& start, const std::vector<size_t>& count,
+	const long *p)
+{
+	Append(var, NCB_LONG, start, count, p, sizeof(long));
+}
+
+void
+NcOutputBuffer::Put(const netCDF::NcVar& var,
+	const std::vector<size_t>& start, const std::vector<size_t>& count,
+	const doublereal *p)
+{
+	Append(var, NCB_DOUBLE, start, count, p, sizeof(doublereal));
+}
+
+void
+NcOutputBuffer::Handoff(void)
+{
+	Wait();
+
+	if (pFill->bEmpty()) {
+		return;
+	}
+
+	tLastFlush = std::chrono::steady_clock::now();
+
+#ifdef HAVE_THREADS
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		pFlush = pFill;
+		pFill = (pFill == &Buffers[0]) ? &Buffers[1] : &Buffers[0];
+	}
+	cond.notify_all();
+#else /* ! HAVE_THREADS */
+	Write(*pFill, pFile, params.bSync);
+	pFill->Clear();
+#endif /* ! HAVE_THREADS */
+}
+
+void
+NcOutputBuffer::Wait(void)
+{
+#ifdef HAVE_THREADS
+	std::unique_lock<std::mutex> lock(mtx);
+	cond.wait(lock, [this] { return pFlush == 0; });
+#endif /* HAVE_THREADS */
+
+	if (except) {
+		std::exception_ptr e = except;
+		except = std::exception_ptr();
+		std::rethrow_exception(e);
+	}
+}
+
+void
+NcOutputBuffer::EndOfStep(void)
+{
+	pFill->uSteps++;
+
+	bool bFlush = (pFill->uSteps >= params.uMaxSteps
+		|| pFill->uBytes >= params.uMaxBytes);
+
+	if (!bFlush && params.dMaxTime > 0.) {
+		std::chrono::duration<doublereal> dt = std::chrono::steady_clock::now() - tLastFlush;
+		bFlush = (dt.count() >= params.dMaxTime);
+	}
+
+	if (bFlush) {
+		Handoff();
+	}
+}
+
+void
+NcOutputBuffer::Flush(void)
+{
+	Handoff();
+	Wait();
+}
+
+/* NcOutputBuffer - end */
+
+#endif /* USE_NETCDF */
@@ -0,0 +1,182 @@
+/* $Header$ */
+/*
+ * MBDyn (C) is a multibody analysis code.
+ * http://www.mbdyn.org
+ *
+ * Copyright (C) 1996-2023
+ *
+ * Pierangelo Masarati	<pierangelo.masarati@polimi.it>
+ * Paolo Mantegazza	<paolo.mantegazza@polimi.it>
+ *
+ * Dipartimento di Ingegneria Aerospaziale - Politecnico di Milano
+ * via La Masa, 34 - 20156 Milano, Italy
+ * http://www.aero.polimi.it
+ *
+ * Changing this copyright notice is forbidden.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation (version 2 of the License).
+ *
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* buffered NetCDF output */
+
+#ifndef NCBUFFER_H
+#define NCBUFFER_H
+
+#ifdef USE_NETCDF
+
+#include <vector>
+#include <unordered_map>
+#include <chrono>
+#include <exception>
+#ifdef HAVE_THREADS
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#endif /* HAVE_THREADS */
+
+#include <netcdf>
+
+#include "ac/f2c.h"
+#include "myassert.h"
+
+/* NcOutputBuffer - begin */
+
+/*
+ * Stages the records written through OutputHandler::WriteNcVar()
+ * in memory, and writes them in chunks of several output steps.
+ * Records of the same variable at consecutive steps are merged
+ * in a single hyperslab, so each variable is written with one call
+ * per chunk instead of one call per step.
+ * Chunks are written by a dedicated I/O thread (if available);
+ * at most two buffers exist at a time, the one being filled
+ * and the one being written, so memory use is bounded:
+ * when the I/O thread lags behind, the solver waits.
+ *
+ * NOTE: the NetCDF library is not thread-safe; any direct access
+ * to the file must be preceded by a call to Flush().
+ */
+class NcOutputBuffer {
+public:
+	struct Params {
+		/* flush after this many output steps */
+		unsigned uMaxSteps;
+		/* flush after this many seconds (wall clock); <= 0 to disable */
+		doublereal dMaxTime;
+		/* flush when the staged data exceed this many bytes */
+		size_t uMaxBytes;
+		/* sync the file after each flush */
+		bool bSync;
+
+		Params(void)
+		: uMaxSteps(100), dMaxTime(10.), uMaxBytes(64*1024*1024), bSync(false)
+		{ NO_OP; };
+	};
+
+protected:
+	enum DataType {
+		NCB_INT,
+		NCB_UINT,
+		NCB_LONG,
+		NCB_DOUBLE
+	};
+
+	/* contiguous hyperslab of a variable */
+	struct Run {
+		DataType type;
+		std::vector<size_t> start;
+		std::vector<size_t> count;
+		std::vector<char> data;
+	};
+
+	struct VarRuns {
+		netCDF::NcVar var;
+		std::vector<Run> runs;
+	};
+
+	struct Buffer {
+		std::vector<VarRuns> vars;
+		std::unordered_map<int, size_t> idx;
+		size_t uBytes;
+		unsigned uSteps;
+
+		Buffer(void) : uBytes(0), uSteps(0) { NO_OP; };
+		bool bEmpty(void) const { return vars.empty(); };
+		void Clear(void);
+	};
+
+	netCDF::NcFile *pFile;
+	Params params;
+
+	Buffer Buffers[2];
+	/* being filled by the solver */
+	Buffer *pFill;
+	/* being written by the I/O thread, or 0 */
+	Buffer *pFlush;
+
+	std::chrono::steady_clock::time_point tLastFlush;
+
+	std::exception_ptr except;
+
+#ifdef HAVE_THREADS
+	std::thread IOThread;
+	std::mutex mtx;
+	std::condition_variable cond;
+	bool bStop;
+
+	void IOThreadFunc(void);
+#endif /* HAVE_THREADS */
+
+	static void Write(Buffer& b, netCDF::NcFile *pFile, bool bSync);
+
+	void Append(const netCDF::NcVar& var, DataType type,
+		const std::vector<size_t>& start,
+		const std::vector<size_t>& count,
+		const void *p, size_t uSize);
+
+	/* hands the buffer being filled to the I/O thread */
+	void Handoff(void);
+
+	/* waits until the I/O thread is idle */
+	void Wait(void);
+
+public:
+	NcOutputBuffer(netCDF::NcFile *pFile, const Params& params);
+	~NcOutputBuffer(void);
+
+	void Put(const netCDF::NcVar& var,
+		const std::vector<size_t>& start, const std::vector<size_t>& count,
+		const int *p);
+	void Put(const netCDF::NcVar& var,
+		const std::vector<size_t>& start, const std::vector<size_t>& count,
+		const unsigned int *p);
+	void Put(const netCDF::NcVar& var,
+		const std::vector<size_t>& start, const std::vector<size_t>& count,
+		const long *p);
+	void Put(const netCDF::NcVar& var,
+		const std::vector<size_t>& start, const std::vector<size_t>& count,
+		const doublereal *p);
+
+	/* to be called at the end of each output step; may trigger a flush */
+	void EndOfStep(void);
+
+	/* writes all staged data; returns when the file is idle */
+	void Flush(void);
+};
+
+/* NcOutputBuffer - end */
+
+#endif /* USE_NETCDF */
+
+#endif /* NCBUFFER_H */
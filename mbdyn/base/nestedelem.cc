@@ -95,6 +95,13 @@ NestedElem::GetElemType(void) const
 	return pElem->GetElemType(); 
 }
 
+bool
+NestedElem::bIsOrderDependent(void) const
+{
+	ASSERT(pElem != NULL);
+	return pElem->bIsOrderDependent();
+}
+
 /* ritorna il numero di Dofs per gli elementi che sono anche DofOwners */
 unsigned int
 NestedElem::iGetNumDof(void) const
@@ -270,6 +277,20 @@ NestedElem::dGetPrivData(unsigned int i) const
 	return pElem->dGetPrivData(i);
 }
 
+std::ostream&
+NestedElem::Checkpoint(std::ostream& out) const
+{
+	ASSERT(pElem != NULL);
+	return pElem->Checkpoint(out);
+}
+
+std::istream&
+NestedElem::Resume(std::istream& in)
+{
+	ASSERT(pElem != NULL);
+	return pElem->Resume(in);
+}
+
 /* *******PER IL SOLUTORE PARALLELO******** *
  * Fornisce il tipo e la label dei nodi che sono connessi all'elemento
  * utile per l'assemblaggio della matrice di connessione fra i dofs
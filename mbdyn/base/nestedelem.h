@@ -67,6 +67,8 @@ public:
 	/* Tipo dell'elemento (usato solo per debug ecc.) */
 	virtual Elem::Type GetElemType(void) const;
 
+	virtual bool bIsOrderDependent(void) const;
+
 	/* funzioni di servizio */
 
 	/*
@@ -168,6 +170,10 @@ public:
 	 */
 	virtual doublereal dGetPrivData(unsigned int i) const;
 
+	/* binary checkpoint of the internal state */
+	virtual std::ostream& Checkpoint(std::ostream& out) const;
+	virtual std::istream& Resume(std::istream& in);
+
 	/* *******PER IL SOLUTORE PARALLELO********
 	 * Fornisce il tipo e la label dei nodi che sono connessi all'elemento
 	 * utile per l'assemblaggio della matrice di connessione fra i dofs
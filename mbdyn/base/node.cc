@@ -111,5 +111,11 @@ void Node::UpdateJac(const VectorHandler& Y, doublereal dCoef)
 {
 }
 
+bool
+Node::bIsOrderDependent(void) const
+{
+	return false;
+}
+
 /* Node - end */
 
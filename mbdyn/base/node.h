@@ -213,6 +213,14 @@ public:
          * Called on each node before assembly of the Jacobian vector product Jac * Y 
          */
         virtual void UpdateJac(const VectorHandler& Y, doublereal dCoef);
+
+	/*
+	 * Nodes whose BeforePredict(), AfterPredict(), Update(),
+	 * AfterConvergence() and DerivativesUpdate() depend on the state
+	 * of other nodes must return true; they are never processed
+	 * concurrently
+	 */
+	virtual bool bIsOrderDependent(void) const;
 };
 
 Node::Type str2nodetype(const char *const s);
@@ -304,12 +304,20 @@ struct CommonNonlinearSolverParam
                                 bool bKeepJac = false)
           :uFlags(uFlags),
            iIterationsBeforeAssembly(iIterBeforeAss),
-           bKeepJacAcrossSteps(bKeepJac) {
+           bKeepJacAcrossSteps(bKeepJac),
+           dMaxContraction(0.),
+           dJacCoefTol(0.) {
      }
 
      unsigned uFlags;
      integer iIterationsBeforeAssembly;
      bool bKeepJacAcrossSteps;     
+     // adaptive reuse of the Jacobian matrix (if dMaxContraction > 0):
+     // rebuild when the residual is not reduced at least by dMaxContraction
+     // per iteration, or when the relative change of the coefficient
+     // of the Jacobian matrix exceeds dJacCoefTol
+     doublereal dMaxContraction;
+     doublereal dJacCoefTol;
 };
 
 class NonlinearSolver : public SolverDiagnostics, protected NonlinearSolverTestOptions
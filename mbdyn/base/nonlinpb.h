@@ -40,6 +40,8 @@
 #ifndef NONLINPB_H
 #define NONLINPB_H
 
+#include <limits>
+
 #include <solman.h>
 
 class NonlinearSolverTest;
@@ -58,6 +60,14 @@ public:
 
 	virtual void Update(const VectorHandler* pSol) const = 0;
 
+	/* coefficient the Jacobian matrix is assembled with;
+	 * used to decide whether a Jacobian matrix can be reused.
+	 * NaN if the Jacobian matrix does not depend on a single
+	 * coefficient: the adaptive reuse is then disabled */
+	virtual doublereal dGetJacobianCoef(void) const {
+		return std::numeric_limits<doublereal>::quiet_NaN();
+	};
+
 	/* scale factor for tests */
 	virtual doublereal TestScale(const NonlinearSolverTest *pTest,
 								 doublereal& dAlgebraicEquations) const = 0;
@@ -57,6 +57,8 @@
 NewtonRaphsonSolver::NewtonRaphsonSolver(const bool bTNR,
                                          const bool bKJ, 
                                          const integer IterBfAss,
+                                         const doublereal dMaxContr,
+                                         const doublereal dCoefTol,
                                          const NonlinearSolverTestOptions& options)
 : NonlinearSolver(options), pRes(NULL),pAbsRes(NULL),
 pSol(NULL),
@@ -64,7 +66,12 @@ bTrueNewtonRaphson(bTNR),
 IterationBeforeAssembly(IterBfAss),
 bKeepJac(bKJ),
 iPerformedIterations(0),
-pPrevNLP(0)
+pPrevNLP(0),
+dMaxContraction(dMaxContr),
+dJacCoefTol(dCoefTol),
+dJacCoef(0.),
+bJacValid(false),
+bJacStale(false)
 {
 	NO_OP;
 }
@@ -74,6 +81,35 @@ NewtonRaphsonSolver::~NewtonRaphsonSolver(void)
 	NO_OP;
 }
 
+bool
+NewtonRaphsonSolver::bRebuildJac(const NonlinearProblem *pNLP, bool bForce) const
+{
+	if (bTrueNewtonRaphson || bForce) {
+		return true;
+	}
+
+	if (dMaxContraction > 0.) {
+		/* adaptive: keep the factorization as long as it is
+		 * consistent with the current coefficient and
+		 * the residual keeps contracting */
+		if (!bJacValid || bJacStale) {
+			return true;
+		}
+
+		doublereal dCoef = pNLP->dGetJacobianCoef();
+
+		/* no coefficient tells whether the factorization
+		 * is still consistent */
+		if (std::isnan(dCoef)) {
+			return true;
+		}
+
+		return std::abs(dCoef - dJacCoef) > dJacCoefTol*std::abs(dJacCoef);
+	}
+
+	return (iPerformedIterations%IterationBeforeAssembly == 0);
+}
+
 void
 NewtonRaphsonSolver::Solve(const NonlinearProblem *pNLP,
 		Solver *pS,
@@ -90,6 +126,7 @@ NewtonRaphsonSolver::Solve(const NonlinearProblem *pNLP,
 	iIterCnt = 0;
 	if ((!bKeepJac) || (pNLP != pPrevNLP)) {
 		iPerformedIterations = 0;
+		bJacValid = false;
 	}
 
         if (pNLP != pPrevNLP) {
@@ -148,6 +185,11 @@ NewtonRaphsonSolver::Solve(const NonlinearProblem *pNLP,
 
 		if (iIterCnt > 0) {
 			dErrFactor *= dErr/dOldErr;
+
+			/* convergence with the current Jacobian matrix degraded */
+			if (dMaxContraction > 0. && dErr > dMaxContraction*dOldErr) {
+				bJacStale = true;
+			}
 		}
 		dOldErr = dErr;
 
@@ -201,6 +243,7 @@ NewtonRaphsonSolver::Solve(const NonlinearProblem *pNLP,
 			if (outputBailout()) {
 				pS->PrintResidual(*pRes, iIterCnt);
 			}
+			bJacStale = true;
 			throw NoConvergence(MBDYN_EXCEPT_ARGS);
 		}
           
@@ -210,10 +253,8 @@ NewtonRaphsonSolver::Solve(const NonlinearProblem *pNLP,
         
       	bJacBuilt = false;
 
-		if (bTrueNewtonRaphson
-			|| (iPerformedIterations%IterationBeforeAssembly == 0)
-			|| forceJacobian)
-		{
+		if (bRebuildJac(pNLP, forceJacobian)) {
+			bJacValid = false;
       			pSM->MatrReset();
 rebuild_matrix:;
 			try {
@@ -234,6 +275,10 @@ rebuild_matrix:;
 
 			TotJac++;
 			bJacBuilt = true;
+
+			dJacCoef = pNLP->dGetJacobianCoef();
+			bJacValid = true;
+			bJacStale = false;
 		}
 
 		iPerformedIterations++;
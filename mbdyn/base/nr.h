@@ -55,10 +55,21 @@ class NewtonRaphsonSolver : public NonlinearSolver
 	integer iPerformedIterations;
 	const NonlinearProblem* pPrevNLP;	
 
+	/* adaptive reuse of the Jacobian matrix */
+	doublereal dMaxContraction;
+	doublereal dJacCoefTol;
+	doublereal dJacCoef;
+	bool bJacValid;
+	bool bJacStale;
+
+	bool bRebuildJac(const NonlinearProblem *pNLP, bool bForce) const;
+
 public:
 	NewtonRaphsonSolver(const bool bTNR,
 			const bool bKJ, 
 			const integer IterBfAss,
+			const doublereal dMaxContr,
+			const doublereal dCoefTol,
 			const NonlinearSolverTestOptions& options);
 	
 	~NewtonRaphsonSolver(void);
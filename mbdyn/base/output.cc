@@ -84,8 +84,9 @@ const char* psExt[] = {
 	".trc",
         ".sol",
         ".prl",
+	".prf",
 	".m",		// NOTE: ALWAYS LAST!
-	NULL		// 35
+	NULL		// 36
 };
 
 const std::unordered_map<const OutputHandler::Dimensions, const std::string> DimensionNames ({
@@ -146,6 +147,7 @@ OutputHandler::OutputHandler(void)
 : FileName(NULL),
 #ifdef USE_NETCDF
 m_pBinFile(0),
+m_pNcBuf(0),
 #endif /* USE_NETCDF */
 iCurrWidth(iDefaultWidth),
 iCurrPrecision(iDefaultPrecision),
@@ -168,6 +170,7 @@ OutputHandler::OutputHandler(const char* sFName, int iExtNum)
 : FileName(sFName, iExtNum),
 #ifdef USE_NETCDF
 m_pBinFile(0),
+m_pNcBuf(0),
 #endif /* USE_NETCDF */
 iCurrWidth(iDefaultWidth),
 iCurrPrecision(iDefaultPrecision),
@@ -535,7 +538,10 @@ OutputHandler::OutputHandler_int(void)
              | OUTPUT_MAY_USE_TEXT | OUTPUT_USE_TEXT;
 
         OutData[SURFACE_LOADS].pof = &ofSurfaceLoads;
-        
+
+	OutData[PROFILE].flags = OUTPUT_MAY_USE_TEXT | OUTPUT_USE_TEXT;
+	OutData[PROFILE].pof = &ofProfile;
+
 	OutData[EIGENANALYSIS].flags = OUTPUT_USE_DEFAULT_PRECISION | OUTPUT_USE_SCIENTIFIC
 			| OUTPUT_MAY_USE_TEXT | OUTPUT_USE_TEXT;
 	OutData[EIGENANALYSIS].pof = &ofEigenanalysis;
@@ -568,6 +574,10 @@ OutputHandler::~OutputHandler(void)
 		if (IsOpen(iCnt)) {
 #ifdef USE_NETCDF
 			if (iCnt == NETCDF) {
+				if (m_pNcBuf != 0) {
+					SAFEDELETE(m_pNcBuf);
+				}
+
 				if (m_pBinFile != 0) {
 					delete m_pBinFile;
 				}
@@ -638,6 +648,43 @@ OutputHandler::NetCDFOpen(const OutputHandler::OutFiles out, const netCDF::NcFil
 
 	return;
 }
+
+void
+OutputHandler::NetCDFSetBuffered(const NcOutputBuffer::Params& params)
+{
+	ASSERT(IsOpen(NETCDF));
+
+	if (m_pNcBuf == 0) {
+		SAFENEWWITHCONSTRUCTOR(m_pNcBuf, NcOutputBuffer,
+			NcOutputBuffer(m_pBinFile, params));
+	}
+}
+
+bool
+OutputHandler::NetCDFIsBuffered(void) const
+{
+	return m_pNcBuf != 0;
+}
+
+void
+OutputHandler::NetCDFEndOfStep(bool bSync)
+{
+	if (m_pNcBuf) {
+		/* the buffer syncs after each flush, if requested */
+		m_pNcBuf->EndOfStep();
+
+	} else if (bSync) {
+		m_pBinFile->sync(); // only works with netcdf-cxx4 >= 4.3.0, check implemented in configure.ac (see also https://github.com/Unidata/netcdf-cxx4/commit/e013ab35f0219fff92ed8237d2f385e89fd1cf77#diff-59778321f93df82ff613be3e32d9a3ec)
+	}
+}
+
+void
+OutputHandler::NetCDFFlush(void)
+{
+	if (m_pNcBuf) {
+		m_pNcBuf->Flush();
+	}
+}
 #endif /* USE_NETCDF */
 
 void
@@ -835,6 +882,9 @@ OutputHandler::Close(const OutputHandler::OutFiles out)
 
 #ifdef USE_NETCDF
 	if (out == NETCDF) {
+		if (m_pNcBuf) {
+			SAFEDELETE(m_pNcBuf);
+		}
 		m_pBinFile->close();
 
 	} else
@@ -984,6 +1034,8 @@ OutputHandler::CreateDim(const std::string& name, integer size)
 {
 	ASSERT(m_pBinFile != 0);
 
+	NetCDFFlush();
+
 	MBDynNcDim dim;
 	if (size == -1) {
 		dim = m_pBinFile->addDim(name);  // .c_str is useless here
@@ -999,6 +1051,8 @@ OutputHandler::GetDim(const std::string& name) const
 {
 	ASSERT(m_pBinFile != 0);
 
+	const_cast<OutputHandler *>(this)->NetCDFFlush();
+
 	return m_pBinFile->getDim(name);
 }
 
@@ -1010,6 +1064,10 @@ OutputHandler::GetDim(const std::string& name) const
 /// would slow down the execution
 void
 OutputHandler::WriteNcVar(const MBDynNcVar& Var_Var, const Mat3x3& pGetVar) {
+	if (m_pNcBuf) {
+		m_pNcBuf->Put(Var_Var, ncStart1x3x3, ncCount1x3x3, pGetVar.pGetMat());
+		return;
+	}
 	Var_Var.putVar(ncStart1x3x3, ncCount1x3x3, pGetVar.pGetMat());
 }
 void
@@ -1018,10 +1076,18 @@ OutputHandler::WriteNcVar(const MBDynNcVar& Var_Var, const Mat3x3& pGetVar,
 {
 	std::vector<size_t> ncStart1x3x3Tmp = ncStart1x3x3;
 	ncStart1x3x3Tmp[0] = ncStart;
+	if (m_pNcBuf) {
+		m_pNcBuf->Put(Var_Var, ncStart1x3x3Tmp, ncCount1x3x3, pGetVar.pGetMat());
+		return;
+	}
 	Var_Var.putVar(ncStart1x3x3Tmp, ncCount1x3x3, pGetVar.pGetMat());
 }
 void
 OutputHandler::WriteNcVar(const MBDynNcVar& Var_Var, const Vec3& pGetVar) {
+	if (m_pNcBuf) {
+		m_pNcBuf->Put(Var_Var, ncStart1x3, ncCount1x3, pGetVar.pGetVec());
+		return;
+	}
 	Var_Var.putVar(ncStart1x3, ncCount1x3, pGetVar.pGetVec());
 }
 void
@@ -1030,11 +1096,19 @@ OutputHandler::WriteNcVar(const MBDynNcVar& Var_Var, const Vec3& pGetVar,
 {
 	std::vector<size_t> ncStart1x3Tmp = ncStart1x3;
 	ncStart1x3Tmp[0] = ncStart;
+	if (m_pNcBuf) {
+		m_pNcBuf->Put(Var_Var, ncStart1x3Tmp, ncCount1x3, pGetVar.pGetVec());
+		return;
+	}
 	Var_Var.putVar(ncStart1x3Tmp, ncCount1x3, pGetVar.pGetVec());
 }
 template <class Tvar>
 void
 OutputHandler::WriteNcVar(const MBDynNcVar& Var_Var, const Tvar& pGetVar) {
+	if (m_pNcBuf) {
+		m_pNcBuf->Put(Var_Var, ncStart1, ncCount1, &pGetVar);
+		return;
+	}
 	Var_Var.putVar(ncStart1, ncCount1, &pGetVar);
 }
 template <class Tvar, class Tstart>
@@ -1042,6 +1116,10 @@ void
 OutputHandler::WriteNcVar(const MBDynNcVar& Var_Var, const Tvar& pGetVar, 
 		const Tstart& ncStart) 
 {
+	if (m_pNcBuf) {
+		m_pNcBuf->Put(Var_Var, std::vector<size_t>(1, ncStart), ncCount1, &pGetVar);
+		return;
+	}
 	Var_Var.putVar(std::vector<size_t>(1,ncStart), ncCount1, &pGetVar);
 }
 template <class Tvar, class Tstart>
@@ -1050,6 +1128,10 @@ OutputHandler::WriteNcVar(const MBDynNcVar& Var_Var, const Tvar& pGetVar,
 		const std::vector<Tstart>& ncStart,
 		const std::vector<size_t>& count) 
 {
+	if (m_pNcBuf) {
+		m_pNcBuf->Put(Var_Var, std::vector<size_t>(ncStart.begin(), ncStart.end()), count, &pGetVar);
+		return;
+	}
 	Var_Var.putVar(ncStart, count, &pGetVar);
 }
 
@@ -1074,6 +1156,8 @@ OutputHandler::CreateVar(const std::string& name, const MBDynNcType& type,
 {
 	MBDynNcVar var;
 
+	NetCDFFlush();
+
 	var = m_pBinFile->addVar(name, type, dims);
 	for (AttrValVec::const_iterator i = attrs.begin(); i != attrs.end(); ++i) {
 		var.putAtt(i->attr, i->val);
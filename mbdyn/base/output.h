@@ -60,6 +60,7 @@ typedef netCDF::NcType MBDynNcType;
 #define MbNcInt MBDynNcType(MBDynNcInt) /**< creates a NcType object for a int, makes the notation simpler */
 #define MbNcDouble MBDynNcType(MBDynNcDouble) /**< creates a NcType object for a double, makes the notation simpler */
 #define MbNcChar MBDynNcType(MBDynNcChar) /**< makes the notation simpler */
+#include "ncbuffer.h"
 #endif
 
 #include "myassert.h"
@@ -110,8 +111,9 @@ public:
 		TRACES,
                 SOLIDS,
                 SURFACE_LOADS,
+		PROFILE,
 		EIGENANALYSIS,			// NOTE: ALWAYS LAST!
-		LASTFILE			// 35
+		LASTFILE			// 36
 	};
 	enum struct Dimensions {
 		Dimensionless,
@@ -213,6 +215,7 @@ private:
 	MBDynNcDim m_DimV1;
 	MBDynNcDim m_DimV3;
 	MBDynNcFile *m_pBinFile;   /* ! one ! binary NetCDF data file */
+	NcOutputBuffer *m_pNcBuf;  /* staging buffer, if buffered output */
 #endif /* USE_NETCDF */
 
 	/* handlers to streams */
@@ -249,6 +252,7 @@ private:
 	std::ofstream ofTraces;
         std::ofstream ofSolids;
         std::ofstream ofSurfaceLoads;
+	std::ofstream ofProfile;
 	std::ofstream ofEigenanalysis;
 
 	int iCurrWidth;
@@ -283,6 +287,14 @@ public:
 	void Open(const OutputHandler::OutFiles out);
 #ifdef USE_NETCDF
 	void NetCDFOpen(const OutputHandler::OutFiles out, const netCDF::NcFile::FileFormat NetCDF_Format);
+
+	/* stage NetCDF records in memory and write them in chunks */
+	void NetCDFSetBuffered(const NcOutputBuffer::Params& params);
+	bool NetCDFIsBuffered(void) const;
+	/* to be called at the end of each output step */
+	void NetCDFEndOfStep(bool bSync);
+	/* writes any staged record; needed before accessing the file directly */
+	void NetCDFFlush(void);
 #endif
 
 	/* Overload for eigenanalysis text output */
@@ -343,6 +355,7 @@ public:
 	inline std::ostream& DofStats(void) const;
 	inline std::ostream& DriveCallers(void) const;
 	inline std::ostream& Traces(void) const;
+	inline std::ostream& Profile(void) const;
         inline std::ostream& Solids(void) const;
         inline std::ostream& SurfaceLoads(void) const;
 	inline std::ostream& Eigenanalysis(void) const;
@@ -745,6 +758,13 @@ OutputHandler::Traces(void) const
 	return const_cast<std::ostream &>(dynamic_cast<const std::ostream &>(ofTraces));
 }
 
+inline std::ostream&
+OutputHandler::Profile(void) const
+{
+	ASSERT(IsOpen(PROFILE));
+	return const_cast<std::ostream &>(dynamic_cast<const std::ostream &>(ofProfile));
+}
+
 inline std::ostream&
 OutputHandler::Eigenanalysis(void) const
 {
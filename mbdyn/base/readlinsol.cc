@@ -44,6 +44,7 @@ ReadLinSol(LinSol& cs, HighParser &HP, bool bAllowEmpty)
 		::solver[LinSol::HARWELL_SOLVER].s_name,
 		::solver[LinSol::LAPACK_SOLVER].s_name,
 		::solver[LinSol::NAIVE_SOLVER].s_name,
+		::solver[LinSol::SPNAIVE_SOLVER].s_name,
 		::solver[LinSol::SUPERLU_SOLVER].s_name,
 		::solver[LinSol::TAUCS_SOLVER].s_name,
 		::solver[LinSol::UMFPACK_SOLVER].s_name,
@@ -69,6 +70,7 @@ ReadLinSol(LinSol& cs, HighParser &HP, bool bAllowEmpty)
 		HARWELL,
 		LAPACK,
 		NAIVE,
+		SPNAIVE,
 		SUPERLU,
 		TAUCS,
 		UMFPACK,
@@ -130,6 +132,11 @@ ReadLinSol(LinSol& cs, HighParser &HP, bool bAllowEmpty)
 		bGotIt = true;
 		break;
 
+	case SPNAIVE:
+		cs.SetSolver(LinSol::SPNAIVE_SOLVER);
+		bGotIt = true;
+		break;
+
 	case SUPERLU:
 		/*
 		 * FIXME: use CC as default???
@@ -845,6 +852,12 @@ ReadLinSol(LinSol& cs, HighParser &HP, bool bAllowEmpty)
 		}
 		break;
 
+	case LinSol::SPNAIVE_SOLVER:
+		if (!(cs.GetSolverFlags() & LinSol::SOLVER_FLAGS_ALLOWS_COLAMD)) {
+			silent_cout("warning: \"sparse naive\" solver should be used with \"colamd\"" << std::endl);
+		}
+		break;
+
 	// add more warnings...
 
 	default:
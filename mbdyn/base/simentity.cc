@@ -195,5 +195,17 @@ void SimulationEntity::ReadInitialState(MBDynParser& HP)
 	NO_OP;
 }
 
+std::ostream&
+SimulationEntity::Checkpoint(std::ostream& out) const
+{
+	return out;
+}
+
+std::istream&
+SimulationEntity::Resume(std::istream& in)
+{
+	return in;
+}
+
 /* SimulationEntity - end */
 
@@ -68,6 +68,10 @@
  *	Update()		: use converged solution
  *	AfterConvergence()	: account for conveged state
  *	dGetPrivData()		: get an internal state
+ *
+ * checkpoint:
+ *	Checkpoint()		: save the internal state not in X, XP
+ *	Resume()		: restore it
  */
 
 class MBDynParser;
@@ -224,8 +228,32 @@ public:
 
 	virtual void ReadInitialState(MBDynParser& HP);
 
+	/*
+	 * Binary checkpoint of the internal state that is not stored
+	 * in the solution vectors (e.g. memory of unsteady aerodynamics,
+	 * friction status); Resume() must read back exactly what
+	 * Checkpoint() wrote, on the same platform.
+	 * As default there is no internal state
+	 */
+	virtual std::ostream& Checkpoint(std::ostream& out) const;
+	virtual std::istream& Resume(std::istream& in);
 };
 
+/* helpers for the binary checkpoint of plain data */
+template <class T>
+inline std::ostream&
+CheckpointPut(std::ostream& out, const T& t)
+{
+	return out.write(reinterpret_cast<const char *>(&t), sizeof(T));
+}
+
+template <class T>
+inline std::istream&
+CheckpointGet(std::istream& in, T& t)
+{
+	return in.read(reinterpret_cast<char *>(&t), sizeof(T));
+}
+
 /* SimulationEntity - end */
 
 #endif /* SIMENTITY_H */
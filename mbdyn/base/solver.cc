@@ -61,6 +61,13 @@
 #include <cmath>
 #include <vector>
 #include <algorithm>
+#include <complex>
+#include <functional>
+#include <random>
+#ifdef HAVE_THREADS
+#include <thread>
+#include <atomic>
+#endif // HAVE_THREADS
 #include "ac/sys_sysinfo.h"
 
 #include "solver.h"
@@ -321,6 +328,7 @@ Solver::Solver(MBDynParser& HPar,
 :
 #ifdef USE_MULTITHREAD
 nThreads(nThreads),
+bThreadWorkStealing(true),
 #endif /* USE_MULTITHREAD */
 pTSC(0),
 dCurrTimeStep(0.),
@@ -415,6 +423,8 @@ pDM(0),
 iNumDofs(0),
 pSM(0),
 pNLS(0),
+iTotSymbolicFact(0),
+iTotNumericFact(0),
 eStatus(SOLVER_STATUS_UNINITIALIZED),
 bOutputCounter(false),
 outputCounterPrefix(),
@@ -538,7 +548,8 @@ Solver::Prepare(void)
 						sOutputFileName.c_str(),
 						sInputFileName.c_str(),
 						eAbortAfter == AFTER_INPUT,
-						nThreads));
+						nThreads,
+						bThreadWorkStealing));
 
 		} else
 #endif /* USE_MULTITHREAD */
@@ -820,6 +831,21 @@ Solver::Prepare(void)
 
 	pDM->SetValue(*pX, *pXPrime);
 
+	/* when resuming from a checkpoint, continue from its time,
+	 * with its time step */
+	doublereal dResumeTime, dResumeTimeStep;
+	if (pDM->bGetResumeTime(dResumeTime, dResumeTimeStep)) {
+		if (dResumeTime >= dFinalTime) {
+			silent_cerr("checkpoint time " << dResumeTime
+				<< " is not less than final time " << dFinalTime
+				<< std::endl);
+			throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+		}
+		dInitialTime = dResumeTime;
+		if (dResumeTimeStep > 0.) {
+			dInitialTimeStep = std::max(dResumeTimeStep, dMinTimeStep);
+		}
+	}
 
 	/*
 	 * Prepare output
@@ -1728,6 +1754,8 @@ IfFirstStepIsToBeRepeated:
 				<< "output in file \"" << sOutputFileName << "\"" << std::endl
 				<< "total iterations: " << iTotIter << std::endl
 				<< "total Jacobian matrices: " << pNLS->TotalAssembledJacobian() << std::endl
+				<< "total factorizations: " << TotalNumericFactorizations()
+					<< " (symbolic: " << TotalSymbolicFactorizations() << ")" << std::endl
 				<< "total error: " << dTotErr << std::endl);
 
 			if (pRTSolver) {
@@ -1744,6 +1772,8 @@ IfFirstStepIsToBeRepeated:
 				<< lStep << " steps;" << std::endl
 				<< "total iterations: " << iTotIter << std::endl
 				<< "total Jacobian matrices: " << pNLS->TotalAssembledJacobian() << std::endl
+				<< "total factorizations: " << TotalNumericFactorizations()
+					<< " (symbolic: " << TotalSymbolicFactorizations() << ")" << std::endl
 				<< "total error: " << dTotErr << std::endl);
 			pRTSolver->Log();
 			return false;
@@ -1765,6 +1795,8 @@ IfFirstStepIsToBeRepeated:
 				<< lStep << " steps;" << std::endl
 				<< "total iterations: " << iTotIter << std::endl
 				<< "total Jacobian matrices: " << pNLS->TotalAssembledJacobian() << std::endl
+				<< "total factorizations: " << TotalNumericFactorizations()
+					<< " (symbolic: " << TotalSymbolicFactorizations() << ")" << std::endl
 				<< "total error: " << dTotErr << std::endl);
 
 			if (pRTSolver) {
@@ -1889,6 +1921,8 @@ IfFirstStepIsToBeRepeated:
 				<< lStep << " steps;" << std::endl
 				<< "total iterations: " << iTotIter << std::endl
 				<< "total Jacobian matrices: " << pNLS->TotalAssembledJacobian() << std::endl
+				<< "total factorizations: " << TotalNumericFactorizations()
+					<< " (symbolic: " << TotalSymbolicFactorizations() << ")" << std::endl
 				<< "total error: " << dTotErr << std::endl);
 
 			if (pRTSolver) {
@@ -1977,6 +2011,8 @@ IfFirstStepIsToBeRepeated:
 				<< "output in file \"" << sOutputFileName << "\"" << std::endl
 				<< "total iterations: " << iTotIter << std::endl
 				<< "total Jacobian matrices: " << pNLS->TotalAssembledJacobian() << std::endl
+				<< "total factorizations: " << TotalNumericFactorizations()
+					<< " (symbolic: " << TotalSymbolicFactorizations() << ")" << std::endl
 				<< "total error: " << dTotErr << std::endl);
 
 			if (pRTSolver) {
@@ -1993,6 +2029,8 @@ IfFirstStepIsToBeRepeated:
 				<< lStep << " steps;" << std::endl
 				<< "total iterations: " << iTotIter << std::endl
 				<< "total Jacobian matrices: " << pNLS->TotalAssembledJacobian() << std::endl
+				<< "total factorizations: " << TotalNumericFactorizations()
+					<< " (symbolic: " << TotalSymbolicFactorizations() << ")" << std::endl
 				<< "total error: " << dTotErr << std::endl);
 			pRTSolver->Log();
 			return false;
@@ -2014,6 +2052,8 @@ IfFirstStepIsToBeRepeated:
 				<< lStep << " steps;" << std::endl
 				<< "total iterations: " << iTotIter << std::endl
 				<< "total Jacobian matrices: " << pNLS->TotalAssembledJacobian() << std::endl
+				<< "total factorizations: " << TotalNumericFactorizations()
+					<< " (symbolic: " << TotalSymbolicFactorizations() << ")" << std::endl
 				<< "total error: " << dTotErr << std::endl);
 
 			if (pRTSolver) {
@@ -2141,6 +2181,8 @@ IfFirstStepIsToBeRepeated:
 				<< lStep << " steps;" << std::endl
 				<< "total iterations: " << iTotIter << std::endl
 				<< "total Jacobian matrices: " << pNLS->TotalAssembledJacobian() << std::endl
+				<< "total factorizations: " << TotalNumericFactorizations()
+					<< " (symbolic: " << TotalSymbolicFactorizations() << ")" << std::endl
 				<< "total error: " << dTotErr << std::endl);
 
 			if (pRTSolver) {
@@ -2252,6 +2294,8 @@ Solver::Advance(void)
 			<< "output in file \"" << sOutputFileName << "\"" << std::endl
 			<< "total iterations: " << iTotIter << std::endl
 			<< "total Jacobian matrices: " << pNLS->TotalAssembledJacobian() << std::endl
+			<< "total factorizations: " << TotalNumericFactorizations()
+				<< " (symbolic: " << TotalSymbolicFactorizations() << ")" << std::endl
 			<< "total error: " << dTotErr << std::endl);
 
 		if (pRTSolver) {
@@ -2268,6 +2312,8 @@ Solver::Advance(void)
 			<< lStep << " steps;" << std::endl
 			<< "total iterations: " << iTotIter << std::endl
 			<< "total Jacobian matrices: " << pNLS->TotalAssembledJacobian() << std::endl
+			<< "total factorizations: " << TotalNumericFactorizations()
+				<< " (symbolic: " << TotalSymbolicFactorizations() << ")" << std::endl
 			<< "total error: " << dTotErr << std::endl);
 		pRTSolver->Log();
 		return false;
@@ -2289,6 +2335,8 @@ Solver::Advance(void)
 			<< lStep << " steps;" << std::endl
 			<< "total iterations: " << iTotIter << std::endl
 			<< "total Jacobian matrices: " << pNLS->TotalAssembledJacobian() << std::endl
+			<< "total factorizations: " << TotalNumericFactorizations()
+				<< " (symbolic: " << TotalSymbolicFactorizations() << ")" << std::endl
 			<< "total error: " << dTotErr << std::endl);
 
 		if (pRTSolver) {
@@ -2415,6 +2463,8 @@ IfStepIsToBeRepeated:
 			<< lStep << " steps;" << std::endl
 			<< "total iterations: " << iTotIter << std::endl
 			<< "total Jacobian matrices: " << pNLS->TotalAssembledJacobian() << std::endl
+			<< "total factorizations: " << TotalNumericFactorizations()
+				<< " (symbolic: " << TotalSymbolicFactorizations() << ")" << std::endl
 			<< "total error: " << dTotErr << std::endl);
 
 		if (pRTSolver) {
@@ -2776,7 +2826,15 @@ Solver::Restart(std::ostream& out,DataManager::eRestart type) const
 	case NonlinearSolver::NEWTONRAPHSON:
 	default :
 		out << "  nonlinear solver: newton raphson";
-		if (!bTrueNewtonRaphson) {
+		if (!bTrueNewtonRaphson && oLineSearchParam.dMaxContraction > 0.) {
+			out << ", modified, adaptive"
+				<< ", contraction, " << oLineSearchParam.dMaxContraction
+				<< ", coefficient tolerance, " << oLineSearchParam.dJacCoefTol;
+			if (bHonorJacRequest) {
+				out << ", honor element requests";
+			}
+
+		} else if (!bTrueNewtonRaphson) {
                         out << ", modified, " << oLineSearchParam.iIterationsBeforeAssembly;
                         if (oLineSearchParam.bKeepJacAcrossSteps) {
 				out << ", keep jacobian matrix";
@@ -4370,6 +4428,90 @@ Solver::ReadData(MBDynParser& HP)
 						<< std::endl);
 					throw ErrGeneric(MBDYN_EXCEPT_ARGS);
 #endif // !USE_JDQZ
+
+				} else if (HP.IsKeyWord("use" "block" "shift" "invert")) {
+					if (EigAn.uFlags & EigenAnalysis::EIG_USE_MASK) {
+						silent_cerr("eigenanalysis routine already selected "
+							"at line " << HP.GetLineData()
+							<< std::endl);
+						throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+					}
+#ifdef USE_LAPACK
+					EigAn.uFlags |= EigenAnalysis::EIG_USE_BSI;
+
+					EigAn.bsi.iNEV = HP.GetInt();
+					if (EigAn.bsi.iNEV <= 0) {
+						silent_cerr("invalid number of eigenvalues "
+							"at line " << HP.GetLineData()
+							<< std::endl);
+						throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+					}
+
+					EigAn.bsi.iBlockSize = HP.GetInt();
+					if (EigAn.bsi.iBlockSize <= 0) {
+						silent_cerr("invalid block size "
+							"at line " << HP.GetLineData()
+							<< std::endl);
+						throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+					}
+
+					EigAn.bsi.iNumBlocks = HP.GetInt();
+					if (EigAn.bsi.iNumBlocks <= 0
+						|| EigAn.bsi.iBlockSize*EigAn.bsi.iNumBlocks <= EigAn.bsi.iNEV)
+					{
+						silent_cerr("invalid number of Krylov blocks "
+							"(block size times number of blocks must be > NEV) "
+							"at line " << HP.GetLineData()
+							<< std::endl);
+						throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+					}
+
+					EigAn.bsi.dTOL = HP.GetReal();
+					if (EigAn.bsi.dTOL <= 0.) {
+						silent_cerr("tolerance must be positive "
+							"at line " << HP.GetLineData()
+							<< std::endl);
+						EigAn.bsi.dTOL = std::sqrt(std::numeric_limits<doublereal>::epsilon());
+					}
+
+					if (!HP.IsKeyWord("shifts")) {
+						silent_cerr("\"shifts\" expected "
+							"at line " << HP.GetLineData()
+							<< std::endl);
+						throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+					}
+
+					int iNumShifts = HP.GetInt();
+					if (iNumShifts <= 0) {
+						silent_cerr("invalid number of shifts "
+							"at line " << HP.GetLineData()
+							<< std::endl);
+						throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+					}
+
+					EigAn.bsi.Shifts.resize(iNumShifts);
+					for (std::vector<doublereal>::iterator i = EigAn.bsi.Shifts.begin();
+						i != EigAn.bsi.Shifts.end(); ++i)
+					{
+						*i = HP.GetReal();
+						if (*i < 0.) {
+							silent_cerr("shift frequencies must be non-negative "
+								"at line " << HP.GetLineData()
+								<< std::endl);
+							throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+						}
+					}
+
+					if (HP.IsKeyWord("threads")) {
+						EigAn.bsi.uThreads = HP.GetInt(0, HighParser::range_ge<integer>(0));
+					}
+#else // !USE_LAPACK
+					silent_cerr("\"use block shift invert\" "
+						"needs to configure --with-lapack "
+						"at line " << HP.GetLineData()
+						<< std::endl);
+					throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+#endif // !USE_LAPACK
                                 } else if (HP.IsKeyWord("use" "external")) {
                                         EigAn.uFlags |= EigenAnalysis::EIG_USE_EXTERNAL;
 				} else if (HP.IsKeyWord("balance")) {
@@ -4519,6 +4661,19 @@ Solver::ReadData(MBDynParser& HP)
 					EigAn.uFlags |= EigenAnalysis::EIG_OUTPUT_SPARSE_MATRICES;
 				}
 				break;
+
+			case EigenAnalysis::EIG_USE_BSI:
+				if (EigAn.uFlags & EigenAnalysis::EIG_OUTPUT_FULL_MATRICES) {
+					silent_cerr("full matrices output "
+						"incompatible with block shift invert "
+						"at line " << HP.GetLineData()
+						<< std::endl);
+					throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+				}
+				if (EigAn.uFlags & EigenAnalysis::EIG_OUTPUT_MATRICES) {
+					EigAn.uFlags |= EigenAnalysis::EIG_OUTPUT_SPARSE_MATRICES;
+				}
+				break;
                         case EigenAnalysis::EIG_USE_EXTERNAL:
                                 if (!(EigAn.uFlags & EigenAnalysis::EIG_OUTPUT_MATRICES_MASK)) {
                                         silent_cerr("external eigenanalysis is not possible without output of matrices" << std::endl);
@@ -4658,15 +4813,41 @@ Solver::ReadData(MBDynParser& HP)
 
 				if (HP.IsKeyWord("modified")) {
 					bTrueNewtonRaphson = false;
-                                        oLineSearchParam.iIterationsBeforeAssembly = HP.GetInt();
 
-					if (HP.IsKeyWord("keep" "jacobian")) {
-						pedantic_cout("Use of deprecated \"keep jacobian\" "
-							"at line " << HP.GetLineData() << std::endl);
+					if (NonlinearSolverType == NonlinearSolver::NEWTONRAPHSON && HP.IsKeyWord("adaptive")) {
+						// the Jacobian matrix is kept across iterations and steps
+						// as long as the residual contracts fast enough
                                                 oLineSearchParam.bKeepJacAcrossSteps = true;
+                                                oLineSearchParam.dMaxContraction = 0.5;
+                                                oLineSearchParam.dJacCoefTol = 1e-6;
 
-					} else if (HP.IsKeyWord("keep" "jacobian" "matrix")) {
-                                                oLineSearchParam.bKeepJacAcrossSteps = true;
+						if (HP.IsKeyWord("contraction")) {
+                                                        oLineSearchParam.dMaxContraction = HP.GetReal();
+                                                        if (oLineSearchParam.dMaxContraction <= 0. || oLineSearchParam.dMaxContraction >= 1.) {
+								silent_cerr("contraction must be between 0 and 1 at line " << HP.GetLineData() << std::endl);
+								throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+							}
+						}
+
+						if (HP.IsKeyWord("coefficient" "tolerance")) {
+                                                        oLineSearchParam.dJacCoefTol = HP.GetReal();
+                                                        if (oLineSearchParam.dJacCoefTol < 0.) {
+								silent_cerr("coefficient tolerance must be greater than or equal to zero at line " << HP.GetLineData() << std::endl);
+								throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+							}
+						}
+
+					} else {
+						oLineSearchParam.iIterationsBeforeAssembly = HP.GetInt();
+
+						if (HP.IsKeyWord("keep" "jacobian")) {
+							pedantic_cout("Use of deprecated \"keep jacobian\" "
+								"at line " << HP.GetLineData() << std::endl);
+							oLineSearchParam.bKeepJacAcrossSteps = true;
+
+						} else if (HP.IsKeyWord("keep" "jacobian" "matrix")) {
+							oLineSearchParam.bKeepJacAcrossSteps = true;
+						}
 					}
 
 					DEBUGLCOUT(MYDEBUG_INPUT, "modified "
@@ -5391,7 +5572,16 @@ Solver::ReadData(MBDynParser& HP)
 					bSolverThreads = true;
 					nSolverThreads = nt;
 				}
-#else /* ! USE_MULTITHREAD */
+#endif // USE_MULTITHREAD
+
+				if (HP.IsKeyWord("work" "stealing")) {
+#ifdef USE_MULTITHREAD
+					bThreadWorkStealing =
+#endif // USE_MULTITHREAD
+					HP.GetYesNoOrBool();
+				}
+
+#ifndef USE_MULTITHREAD
 				silent_cerr("configure with "
 						"--enable-multithread "
 						"for multithreaded assembly"
@@ -6496,6 +6686,610 @@ eig_lapack(const MatrixHandler* pMatA, const MatrixHandler* pMatB,
 }
 #endif // USE_LAPACK
 
+#ifdef USE_LAPACK
+namespace {
+typedef std::complex<doublereal> bsi_complex;
+
+struct BSITriplet {
+	integer iRow;
+	integer iCol;
+	doublereal dCoef;
+
+	BSITriplet(integer iRow, integer iCol, doublereal dCoef)
+	: iRow(iRow), iCol(iCol), dCoef(dCoef) { NO_OP; };
+};
+
+// Eigenpairs found around a single shift
+struct BSIShiftResult {
+	bsi_complex Sigma;
+	integer iNumSolves;
+	std::vector<bsi_complex> Lambda;
+	std::vector<doublereal> Residual;
+	// iSize x Lambda.size(), column-major
+	std::vector<bsi_complex> X;
+	std::string sError;
+
+	BSIShiftResult(void) : iNumSolves(0) { NO_OP; };
+};
+
+// Block Arnoldi on OP = (A - sigma B)^-1 B, in complex arithmetic.
+// The shifted matrix is factored once by the solution manager
+// and reused for all the right-hand sides of the Krylov blocks;
+// complex shifts are solved in real form,
+//
+//	[ A - sr B     si B   ] [ Re z ]   [ Re w ]
+//	[  -si B    A - sr B  ] [ Im z ] = [ Im w ]
+//
+// while real shifts solve real and imaginary parts separately.
+class BSIShiftSolver {
+private:
+	const std::vector<BSITriplet>& A;
+	const std::vector<BSITriplet>& B;
+	const integer iSize;
+	const Solver::EigenAnalysis::BSI& bsi;
+	SolutionManager *const pSM;
+	const bool bComplexSystem;
+	std::vector<bsi_complex> w;
+
+	std::mt19937 Gen;
+	std::uniform_real_distribution<doublereal> Dist;
+
+	void Assemble(const bsi_complex& Sigma);
+	void ApplyOp(const bsi_complex *pIn, integer iNumCols,
+		bsi_complex *pOut, integer& iNumSolves);
+	doublereal Orthogonalize(bsi_complex *pQ, integer iCol,
+		bsi_complex *pH) const;
+	void RandomColumn(bsi_complex *pq);
+
+public:
+	BSIShiftSolver(const std::vector<BSITriplet>& A,
+		const std::vector<BSITriplet>& B,
+		integer iSize,
+		const Solver::EigenAnalysis::BSI& bsi,
+		SolutionManager *pSM,
+		bool bComplexSystem);
+
+	void Run(const bsi_complex& Sigma, unsigned uSeed, BSIShiftResult& Res);
+};
+
+BSIShiftSolver::BSIShiftSolver(const std::vector<BSITriplet>& A,
+	const std::vector<BSITriplet>& B,
+	integer iSize,
+	const Solver::EigenAnalysis::BSI& bsi,
+	SolutionManager *pSM,
+	bool bComplexSystem)
+: A(A), B(B), iSize(iSize), bsi(bsi), pSM(pSM),
+bComplexSystem(bComplexSystem), w(iSize), Dist(-1., 1.)
+{
+	NO_OP;
+}
+
+void
+BSIShiftSolver::Assemble(const bsi_complex& Sigma)
+{
+	const doublereal sr = Sigma.real();
+	const doublereal si = Sigma.imag();
+	bool bInitMat = false;
+
+	pSM->MatrReset();
+
+	while (true) {
+		try {
+			MatrixHandler& M = *pSM->pMatHdl();
+
+			M.Reset();
+
+			for (const auto& t : A) {
+				M.IncCoef(t.iRow, t.iCol, t.dCoef);
+				if (bComplexSystem) {
+					M.IncCoef(t.iRow + iSize, t.iCol + iSize, t.dCoef);
+				}
+			}
+
+			for (const auto& t : B) {
+				M.IncCoef(t.iRow, t.iCol, -sr*t.dCoef);
+				if (bComplexSystem) {
+					M.IncCoef(t.iRow + iSize, t.iCol + iSize, -sr*t.dCoef);
+					M.IncCoef(t.iRow, t.iCol + iSize, si*t.dCoef);
+					M.IncCoef(t.iRow + iSize, t.iCol, -si*t.dCoef);
+				}
+			}
+
+		} catch (const MatrixHandler::ErrRebuildMatrix&) {
+			if (bInitMat) {
+				throw;
+			}
+
+			/* need to rebuild the matrix... */
+			pSM->MatrInitialize();
+			bInitMat = true;
+			continue;
+		}
+		break;
+	}
+
+	pSM->pMatHdl()->PacMat();
+}
+
+void
+BSIShiftSolver::ApplyOp(const bsi_complex *pIn, integer iNumCols,
+	bsi_complex *pOut, integer& iNumSolves)
+{
+	VectorHandler& Rhs = *pSM->pResHdl();
+	VectorHandler& Sol = *pSM->pSolHdl();
+
+	for (integer c = 0; c < iNumCols; c++) {
+		const bsi_complex *const x = pIn + iSize*c;
+		bsi_complex *const z = pOut + iSize*c;
+
+		std::fill(w.begin(), w.end(), bsi_complex(0.));
+		for (const auto& t : B) {
+			w[t.iRow - 1] += t.dCoef*x[t.iCol - 1];
+		}
+
+		// the first Solve() after Assemble() factors the matrix,
+		// the following ones only perform the back-substitution
+		if (bComplexSystem) {
+			for (integer i = 0; i < iSize; i++) {
+				Rhs.PutCoef(i + 1, w[i].real());
+				Rhs.PutCoef(i + 1 + iSize, w[i].imag());
+			}
+			pSM->Solve();
+			iNumSolves++;
+			for (integer i = 0; i < iSize; i++) {
+				z[i] = bsi_complex(Sol.dGetCoef(i + 1), Sol.dGetCoef(i + 1 + iSize));
+			}
+
+		} else {
+			for (integer i = 0; i < iSize; i++) {
+				Rhs.PutCoef(i + 1, w[i].real());
+			}
+			pSM->Solve();
+			iNumSolves++;
+			for (integer i = 0; i < iSize; i++) {
+				z[i] = Sol.dGetCoef(i + 1);
+			}
+
+			for (integer i = 0; i < iSize; i++) {
+				Rhs.PutCoef(i + 1, w[i].imag());
+			}
+			pSM->Solve();
+			iNumSolves++;
+			for (integer i = 0; i < iSize; i++) {
+				z[i] += bsi_complex(0., Sol.dGetCoef(i + 1));
+			}
+		}
+	}
+}
+
+// Orthogonalizes column iCol of pQ against the previous ones
+// (modified Gram-Schmidt with one reorthogonalization pass),
+// accumulating the projections in pH if not null;
+// returns the norm before normalization, or 0 in case of breakdown
+doublereal
+BSIShiftSolver::Orthogonalize(bsi_complex *pQ, integer iCol, bsi_complex *pH) const
+{
+	bsi_complex *const q = pQ + iSize*iCol;
+
+	doublereal dNorm0 = 0.;
+	for (integer i = 0; i < iSize; i++) {
+		dNorm0 += std::norm(q[i]);
+	}
+	dNorm0 = std::sqrt(dNorm0);
+
+	for (int iPass = 0; iPass < 2; iPass++) {
+		for (integer l = 0; l < iCol; l++) {
+			const bsi_complex *const ql = pQ + iSize*l;
+
+			bsi_complex d(0.);
+			for (integer i = 0; i < iSize; i++) {
+				d += std::conj(ql[i])*q[i];
+			}
+
+			for (integer i = 0; i < iSize; i++) {
+				q[i] -= d*ql[i];
+			}
+
+			if (pH) {
+				pH[l] += d;
+			}
+		}
+	}
+
+	doublereal dNorm = 0.;
+	for (integer i = 0; i < iSize; i++) {
+		dNorm += std::norm(q[i]);
+	}
+	dNorm = std::sqrt(dNorm);
+
+	if (dNorm <= std::numeric_limits<doublereal>::epsilon()*dNorm0 || dNorm == 0.) {
+		return 0.;
+	}
+
+	for (integer i = 0; i < iSize; i++) {
+		q[i] /= dNorm;
+	}
+
+	return dNorm;
+}
+
+void
+BSIShiftSolver::RandomColumn(bsi_complex *pq)
+{
+	for (integer i = 0; i < iSize; i++) {
+		pq[i] = bsi_complex(Dist(Gen), Dist(Gen));
+	}
+}
+
+void
+BSIShiftSolver::Run(const bsi_complex& Sigma, unsigned uSeed, BSIShiftResult& Res)
+{
+	const integer N = iSize;
+	const integer p = bsi.iBlockSize;
+	const integer K = p*bsi.iNumBlocks;
+	const integer KP = K + p;
+
+	Res.Sigma = Sigma;
+	Gen.seed(uSeed);
+
+	Assemble(Sigma);
+
+	// Krylov basis, N x (K + p), and band Hessenberg matrix, (K + p) x K
+	std::vector<bsi_complex> Q(N*KP);
+	std::vector<bsi_complex> H(KP*K, bsi_complex(0.));
+
+	// starting block
+	for (integer c = 0; c < p; c++) {
+		do {
+			RandomColumn(&Q[N*c]);
+		} while (Orthogonalize(&Q[0], c, 0) == 0.);
+	}
+
+	for (integer j = 0; j < bsi.iNumBlocks; j++) {
+		// one factorization, p right-hand sides
+		ApplyOp(&Q[N*j*p], p, &Q[N*(j + 1)*p], Res.iNumSolves);
+
+		for (integer i = 0; i < p; i++) {
+			const integer k = j*p + i;
+			const integer c = k + p;
+			bsi_complex *const pHk = &H[KP*k];
+
+			doublereal dBeta = Orthogonalize(&Q[0], c, pHk);
+			if (dBeta == 0.) {
+				// invariant subspace; continue with a random direction
+				do {
+					RandomColumn(&Q[N*c]);
+				} while (Orthogonalize(&Q[0], c, 0) == 0.);
+			}
+			pHk[c] = dBeta;
+		}
+	}
+
+	// Ritz values of the projected K x K problem
+	std::vector<bsi_complex> HK(K*K);
+	for (integer c = 0; c < K; c++) {
+		std::copy(&H[KP*c], &H[KP*c] + K, &HK[K*c]);
+	}
+
+	std::vector<bsi_complex> Nu(K), Y(K*K);
+	std::vector<doublereal> RWork(2*K);
+	integer iInfo = 0;
+	integer iLWork = -1;
+	bsi_complex WV;
+	integer iDmy = 1;
+
+	__FC_DECL__(zgeev)("N", "V", &K,
+		reinterpret_cast<doublecomplex *>(&HK[0]), &K,
+		reinterpret_cast<doublecomplex *>(&Nu[0]),
+		0, &iDmy,
+		reinterpret_cast<doublecomplex *>(&Y[0]), &K,
+		reinterpret_cast<doublecomplex *>(&WV), &iLWork,
+		&RWork[0], &iInfo);
+
+	iLWork = std::max(integer(WV.real()), 2*K);
+	std::vector<bsi_complex> Work(iLWork);
+
+	__FC_DECL__(zgeev)("N", "V", &K,
+		reinterpret_cast<doublecomplex *>(&HK[0]), &K,
+		reinterpret_cast<doublecomplex *>(&Nu[0]),
+		0, &iDmy,
+		reinterpret_cast<doublecomplex *>(&Y[0]), &K,
+		reinterpret_cast<doublecomplex *>(&Work[0]), &iLWork,
+		&RWork[0], &iInfo);
+
+	if (iInfo != 0) {
+		std::ostringstream os;
+		os << "zgeev() failed, INFO=" << iInfo;
+		Res.sError = os.str();
+		return;
+	}
+
+	// the largest |nu| are the eigenvalues closest to the shift
+	std::vector<integer> Order(K);
+	for (integer l = 0; l < K; l++) {
+		Order[l] = l;
+	}
+	std::sort(Order.begin(), Order.end(), [&Nu](integer l1, integer l2) {
+		return std::abs(Nu[l1]) > std::abs(Nu[l2]);
+	});
+
+	std::vector<bsi_complex> x(N);
+	for (integer n = 0; n < std::min(bsi.iNEV, K); n++) {
+		const integer l = Order[n];
+		const doublereal dAbsNu = std::abs(Nu[l]);
+		if (dAbsNu == 0.) {
+			break;
+		}
+
+		// ||OP x - nu x|| = ||H(K:K+p, K-p:K) y(K-p:K)||
+		const bsi_complex *const y = &Y[K*l];
+		doublereal dRes = 0.;
+		for (integer r = K; r < KP; r++) {
+			bsi_complex d(0.);
+			for (integer c = K - p; c < K; c++) {
+				d += H[KP*c + r]*y[c];
+			}
+			dRes += std::norm(d);
+		}
+		dRes = std::sqrt(dRes);
+
+		if (dRes > bsi.dTOL*dAbsNu) {
+			continue;
+		}
+
+		// Ritz vector, scaled to unit largest component
+		std::fill(x.begin(), x.end(), bsi_complex(0.));
+		for (integer c = 0; c < K; c++) {
+			const bsi_complex *const qc = &Q[N*c];
+			for (integer i = 0; i < N; i++) {
+				x[i] += qc[i]*y[c];
+			}
+		}
+
+		integer iMax = 0;
+		for (integer i = 1; i < N; i++) {
+			if (std::abs(x[i]) > std::abs(x[iMax])) {
+				iMax = i;
+			}
+		}
+		const bsi_complex dScale = 1./x[iMax];
+
+		bsi_complex Lambda = Sigma + 1./Nu[l];
+		const bool bConj = (Lambda.imag() < 0.);
+		if (bConj) {
+			Lambda = std::conj(Lambda);
+		}
+
+		Res.Lambda.push_back(Lambda);
+		Res.Residual.push_back(dRes/dAbsNu);
+		for (integer i = 0; i < N; i++) {
+			const bsi_complex xi = x[i]*dScale;
+			Res.X.push_back(bConj ? std::conj(xi) : xi);
+		}
+	}
+}
+} // end of anonymous namespace
+
+// Computes eigenvalues and eigenvectors close to a set of shifts
+// using a block shift-invert Arnoldi iteration; shifts are processed
+// concurrently, each thread using its own solution manager
+static void
+eig_bsi(const MatrixHandler* pMatA, const MatrixHandler* pMatB,
+	DataManager *pDM, Solver::EigenAnalysis *pEA,
+	bool bNewLine, const unsigned uCurr,
+	const std::function<SolutionManager *(integer)>& AllocSolman)
+{
+	const Solver::EigenAnalysis::BSI& bsi = pEA->bsi;
+	const integer iSize = pMatA->iGetNumRows();
+	const doublereal h = pEA->dParam;
+
+	std::vector<BSITriplet> A, B;
+	pMatA->EnumerateNz([&A](integer iRow, integer iCol, doublereal dCoef) {
+		A.emplace_back(iRow, iCol, dCoef);
+	});
+	pMatB->EnumerateNz([&B](integer iRow, integer iCol, doublereal dCoef) {
+		B.emplace_back(iRow, iCol, dCoef);
+	});
+
+	// s = j*2*pi*f is mapped into the pencil's eigenvalue
+	// lambda = (1 + s*h/2)/(1 - s*h/2)
+	const integer iNumShifts = bsi.Shifts.size();
+	std::vector<bsi_complex> Sigma(iNumShifts);
+	bool bComplexSystem = false;
+	for (integer i = 0; i < iNumShifts; i++) {
+		const bsi_complex s(0., 2.*M_PI*bsi.Shifts[i]);
+		Sigma[i] = (1. + s*h/2.)/(1. - s*h/2.);
+		if (Sigma[i].imag() != 0.) {
+			bComplexSystem = true;
+		}
+	}
+	const integer iSysSize = bComplexSystem ? 2*iSize : iSize;
+
+	unsigned uThreads = bsi.uThreads;
+#ifdef HAVE_THREADS
+	if (uThreads == 0) {
+		uThreads = std::thread::hardware_concurrency();
+	}
+#else // !HAVE_THREADS
+	uThreads = 1;
+#endif // !HAVE_THREADS
+	uThreads = std::max(1u, std::min(uThreads, unsigned(iNumShifts)));
+
+	std::vector<SolutionManager *> SM(uThreads, nullptr);
+	for (unsigned t = 0; t < uThreads; t++) {
+		SM[t] = AllocSolman(iSysSize);
+	}
+
+	std::vector<BSIShiftResult> Results(iNumShifts);
+
+#ifdef HAVE_THREADS
+	std::atomic<integer> iNextShift(0);
+#else // !HAVE_THREADS
+	integer iNextShift = 0;
+#endif // !HAVE_THREADS
+
+	auto Worker = [&](unsigned uThread) {
+		BSIShiftSolver ShiftSolver(A, B, iSize, bsi, SM[uThread], bComplexSystem);
+
+		for (integer i = iNextShift++; i < iNumShifts; i = iNextShift++) {
+			try {
+				ShiftSolver.Run(Sigma[i], i + 1, Results[i]);
+
+			} catch (const std::exception& e) {
+				Results[i].sError = e.what();
+
+			} catch (...) {
+				Results[i].sError = "unknown error";
+			}
+		}
+	};
+
+#ifdef HAVE_THREADS
+	std::vector<std::thread> Threads;
+	Threads.reserve(uThreads - 1);
+	for (unsigned t = 1; t < uThreads; t++) {
+		Threads.emplace_back(Worker, t);
+	}
+#endif // HAVE_THREADS
+
+	Worker(0);
+
+#ifdef HAVE_THREADS
+	for (auto& t : Threads) {
+		t.join();
+	}
+#endif // HAVE_THREADS
+
+	for (unsigned t = 0; t < uThreads; t++) {
+		SAFEDELETE(SM[t]);
+	}
+
+	std::ostream& Out = pDM->GetOutFile();
+	Out << "Block shift-invert: " << iNumShifts << " shift(s), "
+		"block size " << bsi.iBlockSize << ", "
+		<< bsi.iNumBlocks << " block(s), "
+		<< uThreads << " thread(s)" << std::endl;
+
+	for (integer i = 0; i < iNumShifts; i++) {
+		const BSIShiftResult& r = Results[i];
+
+		Out << "Shift #" << i + 1 << ": f=" << bsi.Shifts[i] << " Hz, "
+			"sigma=" << Sigma[i].real()
+			<< (Sigma[i].imag() >= 0. ? " + " : " - ")
+			<< std::fabs(Sigma[i].imag()) << " j, "
+			"solves=" << r.iNumSolves << ", "
+			"converged=" << r.Lambda.size() << "/" << bsi.iNEV;
+		if (!r.sError.empty()) {
+			Out << ", failed: " << r.sError;
+
+			if (bNewLine && silent_err) {
+				silent_cerr(std::endl);
+				bNewLine = false;
+			}
+			silent_cerr("block shift-invert: shift #" << i + 1
+				<< " (" << bsi.Shifts[i] << " Hz) failed: "
+				<< r.sError << std::endl);
+		}
+		Out << std::endl;
+	}
+
+	// merge eigenvalues found by more than one shift,
+	// keeping the one with the smallest residual
+	struct Pair {
+		integer iShift;
+		integer iIdx;
+		bsi_complex s;
+	};
+	std::vector<Pair> Pairs;
+	const doublereal dMergeTol = std::min(std::sqrt(bsi.dTOL), 1e-3);
+	for (integer i = 0; i < iNumShifts; i++) {
+		const BSIShiftResult& r = Results[i];
+		for (integer l = 0; l < integer(r.Lambda.size()); l++) {
+			const bsi_complex s = (2./h)*(r.Lambda[l] - 1.)/(r.Lambda[l] + 1.);
+
+			bool bFound = false;
+			for (auto& pp : Pairs) {
+				const doublereal dRef = std::max(std::max(std::abs(s), std::abs(pp.s)), 1.);
+				if (std::abs(s - pp.s) <= dMergeTol*dRef) {
+					if (r.Residual[l] < Results[pp.iShift].Residual[pp.iIdx]) {
+						pp.iShift = i;
+						pp.iIdx = l;
+						pp.s = s;
+					}
+					bFound = true;
+					break;
+				}
+			}
+
+			if (!bFound) {
+				Pairs.push_back(Pair{i, l, s});
+			}
+		}
+	}
+
+	// real eigenvalues use one column, complex conjugate pairs two
+	integer iNVec = 0;
+	std::vector<bool> vReal(Pairs.size());
+	for (unsigned n = 0; n < Pairs.size(); n++) {
+		const bsi_complex& l = Results[Pairs[n].iShift].Lambda[Pairs[n].iIdx];
+		vReal[n] = (std::fabs(l.imag()) <= bsi.dTOL*std::abs(l));
+		iNVec += vReal[n] ? 1 : 2;
+	}
+
+	if (iNVec == 0) {
+		if (bNewLine && silent_err) {
+			silent_cerr(std::endl);
+			bNewLine = false;
+		}
+		silent_cerr("no converged Ritz values" << std::endl);
+		return;
+	}
+
+	MyVectorHandler AlphaR(iNVec);
+	MyVectorHandler AlphaI(iNVec);
+	FullMatrixHandler VR(iSize, iNVec);
+
+	integer iCol = 1;
+	for (unsigned n = 0; n < Pairs.size(); n++) {
+		const BSIShiftResult& r = Results[Pairs[n].iShift];
+		const bsi_complex& l = r.Lambda[Pairs[n].iIdx];
+		const bsi_complex *const x = &r.X[iSize*Pairs[n].iIdx];
+
+		if (vReal[n]) {
+			AlphaR(iCol) = l.real();
+			AlphaI(iCol) = 0.;
+			for (integer i = 0; i < iSize; i++) {
+				VR(i + 1, iCol) = x[i].real();
+			}
+			iCol++;
+
+		} else {
+			AlphaR(iCol) = l.real();
+			AlphaI(iCol) = l.imag();
+			AlphaR(iCol + 1) = l.real();
+			AlphaI(iCol + 1) = -l.imag();
+			for (integer i = 0; i < iSize; i++) {
+				VR(i + 1, iCol) = x[i].real();
+				VR(i + 1, iCol + 1) = x[i].imag();
+			}
+			iCol += 2;
+		}
+	}
+
+	std::vector<bool> vOut(iNVec);
+	output_eigenvalues(0, AlphaR, AlphaI, 0., pDM, pEA, 1, iNVec, vOut);
+
+	if (pEA->uFlags & Solver::EigenAnalysis::EIG_OUTPUT_GEOMETRY) {
+		pDM->OutputEigGeometry(uCurr, pEA->iResultsPrecision);
+	}
+
+	if (pEA->uFlags & Solver::EigenAnalysis::EIG_OUTPUT_EIGENVECTORS) {
+		pDM->OutputEigenvectors(0, AlphaR, AlphaI, 0.,
+			0, VR, vOut, uCurr, pEA->iResultsPrecision);
+	}
+}
+#endif // USE_LAPACK
+
 #ifdef USE_ARPACK
 // Computes eigenvalues and eigenvectors using ARPACK's
 // canonical non-symmetric eigenanalysis
@@ -7024,6 +7818,18 @@ Solver::Eig(bool bNewLine)
 		SAFENEWWITHCONSTRUCTOR(pMatB, NaiveMatrixHandler,
 			NaiveMatrixHandler(iSize));
 
+	} else if (EigAn.uFlags & EigenAnalysis::EIG_USE_BSI) {
+		if (bParallel) {
+			silent_cerr("\"use block shift invert\" "
+				"is not supported by the parallel solver" << std::endl);
+			throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+		}
+
+		SAFENEWWITHCONSTRUCTOR(pMatA, SpMapMatrixHandler,
+			SpMapMatrixHandler(iSize));
+		SAFENEWWITHCONSTRUCTOR(pMatB, SpMapMatrixHandler,
+			SpMapMatrixHandler(iSize));
+
 	} else if (EigAn.uFlags & EigenAnalysis::EIG_OUTPUT_SPARSE_MATRICES) {
 		SAFENEWWITHCONSTRUCTOR(pMatA, SpMapMatrixHandler,
 			SpMapMatrixHandler(iSize));
@@ -7125,6 +7931,21 @@ Solver::Eig(bool bNewLine)
 		eig_jdqz(pMatA, pMatB, pDM, &EigAn, bNewLine, uCurr);
 		break;
 #endif // USE_JDQZ
+
+#ifdef USE_LAPACK
+	case EigenAnalysis::EIG_USE_BSI: {
+		// the shifted matrices have twice the size in case of complex shifts
+		const integer iWorkSpaceSize = CurrLinearSolver.iGetWorkSpaceSize();
+		eig_bsi(pMatA, pMatB, pDM, &EigAn, bNewLine, uCurr,
+			[this, iWorkSpaceSize](integer iSysSize) {
+				integer iLWS = iWorkSpaceSize;
+				if (iSysSize > iNumDofs) {
+					iLWS *= 4;
+				}
+				return AllocateSolman(iSysSize, iLWS);
+			});
+		} break;
+#endif // USE_LAPACK
         case EigenAnalysis::EIG_USE_EXTERNAL:
                 if (EigAn.uFlags & Solver::EigenAnalysis::EIG_OUTPUT_GEOMETRY) {
                     pDM->OutputEigGeometry(uCurr, EigAn.iResultsPrecision);
@@ -7215,6 +8036,7 @@ Solver::AllocateSchurSolman(integer iStates)
 	switch (CurrIntSolver.GetSolver()) {
 	case LinSol::LAPACK_SOLVER:
 	case LinSol::NAIVE_SOLVER:
+	case LinSol::SPNAIVE_SOLVER:
 	case LinSol::UMFPACK_SOLVER:
 	case LinSol::Y12_SOLVER:
 		break;
@@ -7291,6 +8113,8 @@ Solver::AllocateNonlinearSolver()
 				NewtonRaphsonSolver(bTrueNewtonRaphson,
                                         oLineSearchParam.bKeepJacAcrossSteps,
                                         oLineSearchParam.iIterationsBeforeAssembly,
+                                        oLineSearchParam.dMaxContraction,
+                                        oLineSearchParam.dJacCoefTol,
 					*this));
 		break;
 	case NonlinearSolver::LINESEARCH:
@@ -7426,6 +8250,10 @@ Solver::SetupSolmans(integer iStates, bool bCanBeParallel)
 		"\n\tnumdofs = " << iNumDofs
 		<< "\n\tnumstates = " << iStates << std::endl);
 
+	/* keep track of the factorizations of the previous solmans */
+	iTotSymbolicFact = TotalSymbolicFactorizations();
+	iTotNumericFact = TotalNumericFactorizations();
+
 	/* delete previous solmans */
 	if (pSM != 0) {
 		SAFEDELETE(pSM);
@@ -7471,6 +8299,25 @@ Solver::SetupSolmans(integer iStates, bool bCanBeParallel)
 	}
 }
 
+integer
+Solver::TotalSymbolicFactorizations(void) const
+{
+	/* in the parallel case, the local solman does the job */
+	const SolutionManager *pCurrSM = pLocalSM ? pLocalSM : pSM;
+	const LinearSolver *pLS = pCurrSM ? pCurrSM->pGetLinearSolver() : 0;
+
+	return iTotSymbolicFact + (pLS ? pLS->iGetNumSymbolicFact() : 0);
+}
+
+integer
+Solver::TotalNumericFactorizations(void) const
+{
+	const SolutionManager *pCurrSM = pLocalSM ? pLocalSM : pSM;
+	const LinearSolver *pLS = pCurrSM ? pCurrSM->pGetLinearSolver() : 0;
+
+	return iTotNumericFact + (pLS ? pLS->iGetNumNumericFact() : 0);
+}
+
 clock_t
 Solver::GetCPUTime(void) const
 {
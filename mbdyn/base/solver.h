@@ -105,6 +105,7 @@ public:
 protected:
 #ifdef USE_MULTITHREAD
 	unsigned nThreads;
+	bool bThreadWorkStealing;
 
 	void ThreadPrepare(void);
 #endif /* USE_MULTITHREAD */
@@ -150,7 +151,8 @@ public:
 			EIG_USE_ARPACK			= 0x2000U,
 			EIG_USE_JDQZ			= 0x4000U,
                         EIG_USE_EXTERNAL                = 0x8000U,
-			EIG_USE_MASK			= (EIG_USE_LAPACK|EIG_USE_ARPACK|EIG_USE_JDQZ|EIG_USE_EXTERNAL),
+			EIG_USE_BSI			= 0x10000U,
+			EIG_USE_MASK			= (EIG_USE_LAPACK|EIG_USE_ARPACK|EIG_USE_JDQZ|EIG_USE_EXTERNAL|EIG_USE_BSI),
 
 			EIG_LAST
 		};
@@ -219,6 +221,21 @@ public:
 			{ NO_OP; };
 		} jdqz;
 
+		// block shift-invert specific
+		struct BSI {
+			integer iNEV;		// eigenvalues per shift
+			integer iBlockSize;	// vectors per Krylov block
+			integer iNumBlocks;	// Krylov blocks
+			doublereal dTOL;
+			std::vector<doublereal> Shifts;	// frequencies, Hz
+			unsigned uThreads;	// 0: automatic
+
+			BSI(void)
+			: iNEV(0), iBlockSize(0), iNumBlocks(0), dTOL(0.),
+			uThreads(0)
+			{ NO_OP; };
+		} bsi;
+
 		EigenAnalysis(void)
 		: bAnalysis(false),
 		uFlags(EIG_NONE),
@@ -400,6 +417,11 @@ protected:
 	SolutionManager *pSM;
 	NonlinearSolver* pNLS;
 
+	/* factorizations performed by the solution managers
+	 * that have already been destroyed */
+	integer iTotSymbolicFact;
+	integer iTotNumericFact;
+
 	/* corregge i puntatori per un nuovo passo */
    	inline void Flip(void);
 
@@ -415,6 +437,10 @@ protected:
 	/* Alloca tutti i solman*/
 	void SetupSolmans(integer iStates, bool bCanBeParallel = false);
 
+	/* factorizations performed so far by the linear solvers */
+	integer TotalSymbolicFactorizations(void) const;
+	integer TotalNumericFactorizations(void) const;
+
 	/* Workaround: call this function instead of MaxTimeStep.dGet()
 	 * until all postponed drive callers have been instantiated */
 	doublereal dGetInitialMaxTimeStep() const;
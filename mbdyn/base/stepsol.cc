@@ -472,6 +472,11 @@ doublereal DerivativeSolver::dGetCoef(unsigned int iDof) const
      return dCoef;
 }
 
+doublereal DerivativeSolver::dGetJacobianCoef(void) const
+{
+     return dCoef;
+}
+
 /* scale factor for tests */
 doublereal
 DerivativeSolver::TestScale(const NonlinearSolverTest *pTest, doublereal& dAlgebraicEqu) const
@@ -517,7 +522,7 @@ StepNIntegrator::Jacobian(MatrixHandler* pJac) const
      // Finite difference check of Jacobian matrix
      // Enable by means of a "finite difference jacobian meter" whenever you need to debug your new Jacobian
      // NOTE: might not be safe!
-     pDM->FDJacCheck(this, pJac);
+     pDM->FDJacCheck(this, pJac, db0Differential);
 }
 
 void StepNIntegrator::Jacobian(VectorHandler* pJac, const VectorHandler* pY) const
@@ -559,6 +564,11 @@ StepNIntegrator::Update(const VectorHandler* pSol) const
 	pDM->Update();
 }
 
+doublereal StepNIntegrator::dGetJacobianCoef(void) const
+{
+     return db0Differential;
+}
+
 doublereal StepNIntegrator::dGetCoef(unsigned int iDof) const
 {
      ASSERT(iDof > 0);
@@ -1012,4 +1022,9 @@ doublereal InverseDynamicsStepSolver::dGetCoef(unsigned int) const
      throw ErrNotImplementedYet(MBDYN_EXCEPT_ARGS);
 }
 
+doublereal InverseDynamicsStepSolver::dGetJacobianCoef(void) const
+{
+     return NonlinearProblem::dGetJacobianCoef();
+}
+
 /* Inverse Dynamics - End */
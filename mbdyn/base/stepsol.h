@@ -228,6 +228,8 @@ public:
 	void Update(const VectorHandler* pSol) const override;
 
 	virtual doublereal dGetCoef(unsigned int iDof) const override;
+
+	virtual doublereal dGetJacobianCoef(void) const override;
      
 	/* scale factor for tests */
 	virtual doublereal TestScale(const NonlinearSolverTest *pTest, doublereal& dAlgebraicEqu) const override;
@@ -284,6 +286,8 @@ public:
 	virtual void Update(const VectorHandler* pSol) const override;
 
 	virtual doublereal dGetCoef(unsigned int iDof) const override;
+
+	virtual doublereal dGetJacobianCoef(void) const override;
      
 	virtual doublereal TestScale(const NonlinearSolverTest *pTest, doublereal& dAlgebraicEqu) const override;
 
@@ -375,6 +379,9 @@ public:
 	void Update(const VectorHandler* pSol) const override;
 
         virtual doublereal dGetCoef(unsigned int iDof) const override;
+
+	/* the Jacobian matrix depends on the order, not on a coefficient */
+	virtual doublereal dGetJacobianCoef(void) const override;
      
 	void SetOrder(InverseDynamics::Order iOrder);
 
@@ -638,6 +638,18 @@ doublereal HybridStepIntegrator::dGetCoef(unsigned int iDof) const
      return rgIntegPtr[eInteg]->dGetCoef(iDof);
 }
 
+doublereal HybridStepIntegrator::dGetJacobianCoef(void) const
+{
+     ASSERT(pDefaultInteg != nullptr);
+
+     if (rgIntegItems.size() > 1) {
+          // each integrator contributes with its own coefficient
+          return NonlinearProblem::dGetJacobianCoef();
+     }
+
+     return pDefaultInteg->dGetJacobianCoef();
+}
+
 doublereal
 HybridStepIntegrator::Advance(Solver* pS,
                               const doublereal TStep,
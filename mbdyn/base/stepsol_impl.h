@@ -263,6 +263,9 @@ public:
      virtual doublereal
      dGetCoef(unsigned int iDof) const override;
 
+     virtual doublereal
+     dGetJacobianCoef(void) const override;
+
      virtual doublereal
      Advance(Solver* pS,
              const doublereal TStep,
@@ -197,54 +197,69 @@ UseSocket::PostConnect(void)
 	}
 }
 
-void
-UseSocket::Connect(void)
+bool
+UseSocket::TryConnect(void)
 {
-	if (socket_type != SOCK_STREAM) {
-		return;
+	int rc = connect(sock, GetSockaddr(), GetSocklen());
+
+	if (rc == SOCKET_ERROR) {
+
+		int save_errno = WSAGetLastError();
+
+		switch (save_errno) {
+#ifdef _WIN32
+		case WSAECONNREFUSED: // winsock inet
+#else
+		case ECONNREFUSED:	// inet
+		case ENOENT:		// unix
+#endif // _WIN32
+			/* Socket does not exist yet; retry */
+			return false;
+		}
+
+		/* Connect failed */
+		char *msg = strerror(save_errno);
+		silent_cerr("UseSocket::Connect: connect() failed "
+			"(" << save_errno << ": " << msg << ")"
+			<< std::endl);
+		throw ErrGeneric(MBDYN_EXCEPT_ARGS);
 	}
 
+	return true;
+}
+
+void
+UseSocket::RetryConnect(void)
+{
 	// FIXME: retry strategy should be configurable
 	int count = 600;
 	mbsleep_t timeout;
 	mbsleep_real2sleep(0.1, &timeout);
 
 	for ( ; count > 0; count--) {
-		int rc = connect(sock, GetSockaddr(), GetSocklen());
-
-		if (rc == SOCKET_ERROR) {
-
-			int save_errno = WSAGetLastError();
+		if (TryConnect()) {
+			/* Success */
+			connected = true;
+			return;
+		}
 
-			switch (save_errno) {
-#ifdef _WIN32
-			case WSAECONNREFUSED: // winsock inet
-#else
-			case ECONNREFUSED:	// inet
-			case ENOENT:		// unix
-#endif // _WIN32
-				/* Socket does not exist yet; retry */
-				mbsleep(&timeout);
-				continue;
-			}
+		mbsleep(&timeout);
+	}
 
-			/* Connect failed */
-			char *msg = strerror(save_errno);
-			silent_cerr("UseSocket::Connect: connect() failed "
-				"(" << save_errno << ": " << msg << ")"
-				<< std::endl);
-			throw ErrGeneric(MBDYN_EXCEPT_ARGS);
-		}
+	silent_cerr("UseSocket(" << GetSockaddrStr() << "): "
+		"connection timed out" << std::endl);
+	throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+}
 
-		/* Success */
-		connected = true;
-		PostConnect();
+void
+UseSocket::Connect(void)
+{
+	if (socket_type != SOCK_STREAM) {
 		return;
 	}
 
-	silent_cerr("UseSocket(): connection timed out"
-		<< std::endl);
-	throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+	RetryConnect();
+	PostConnect();
 }
 
 void
@@ -716,6 +731,117 @@ UseLocalSocket::GetSockaddrStr (void) const
     return s;
 }
 
+#ifdef MBDYN_SHM_SUPPORTED
+UseSharedMemory::UseSharedMemory(const std::string& n, size_t s, bool c)
+: UseSocket(c), name(n), size(s)
+{
+	ASSERT(!name.empty());
+
+	if (create) {
+		int save_errno;
+
+		sock = mbdyn_shm_create(name.c_str(), size, &save_errno);
+		if (sock == -1) {
+			silent_cerr("UseSharedMemory(\"" << name << "\"): "
+				"mbdyn_shm_create() failed "
+				"(" << save_errno << ": " << strerror(save_errno) << ")"
+				<< std::endl);
+			throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+		}
+
+		// the peer attaches to the channel without handshaking
+		connected = true;
+	}
+}
+
+UseSharedMemory::~UseSharedMemory(void)
+{
+	if (sock != -1) {
+		mbdyn_shm_close(sock);
+
+		// nothing left for ~UseSocket() to close
+		sock = -1;
+	}
+}
+
+std::ostream&
+UseSharedMemory::Restart(std::ostream& out) const
+{
+	if (create) {
+		out << ", create, yes";
+	}
+
+	out << ", shared memory, \"" << name << "\"";
+	if (size != 0) {
+		out << ", size, " << size;
+	}
+
+	return out;
+}
+
+bool
+UseSharedMemory::TryConnect(void)
+{
+	int save_errno;
+
+	sock = mbdyn_shm_open(name.c_str(), &save_errno);
+	if (sock == -1) {
+		switch (save_errno) {
+		case ENOENT:
+		case EAGAIN:
+			/* Channel does not exist yet; retry */
+			return false;
+		}
+
+		silent_cerr("UseSharedMemory(\"" << name << "\"): "
+			"mbdyn_shm_open() failed "
+			"(" << save_errno << ": " << strerror(save_errno) << ")"
+			<< std::endl);
+		throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+	}
+
+	return true;
+}
+
+void
+UseSharedMemory::Connect(void)
+{
+	if (connected) {
+		return;
+	}
+
+	pedantic_cout("attaching to shared memory \"" << name << "\" ..."
+		<< std::endl);
+
+	RetryConnect();
+}
+
+void
+UseSharedMemory::ConnectSock(int s)
+{
+	// shared memory channels are never accept()ed
+	ASSERT(0);
+	throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+}
+
+struct sockaddr *
+UseSharedMemory::GetSockaddr(void) const
+{
+	return 0;
+}
+
+std::string
+UseSharedMemory::GetSockaddrStr(void) const
+{
+	std::string s;
+
+	s = "Shared memory, name: ";
+	s += name;
+
+	return s;
+}
+#endif /* MBDYN_SHM_SUPPORTED */
+
 #endif /* !_WIN32 */
 
 #endif // USE_SOCKET
@@ -48,6 +48,7 @@
 #endif
 
 #include "sock.h"
+#include "shm.h"
 
 class UseSocket {
 protected:
@@ -62,6 +63,12 @@ protected:
 
 	void PostConnect(void);
 
+	/* one connection attempt; returns false if the peer
+	 * is not there yet, throws on any other error */
+	virtual bool TryConnect(void);
+	/* calls TryConnect() until it succeeds or times out */
+	void RetryConnect(void);
+
 public:
 	UseSocket(bool c);
 	UseSocket(int t, bool c);
@@ -128,6 +135,30 @@ public:
 	struct sockaddr *GetSockaddr(void) const;
 	std::string GetSockaddrStr(void) const;
 };
+
+#ifdef MBDYN_SHM_SUPPORTED
+/* Shared memory channel (see shm.h); behaves like a connected stream
+ * socket, since recvn()/sendn() recognize its descriptor.
+ * The creator does not need to accept() the peer */
+class UseSharedMemory : public UseSocket {
+protected:
+	std::string name;
+	size_t size;
+
+	bool TryConnect(void);
+
+public:
+	UseSharedMemory(const std::string& n, size_t s, bool c);
+	virtual ~UseSharedMemory(void);
+
+	std::ostream& Restart(std::ostream& out) const;
+
+	void Connect(void);
+	void ConnectSock(int s);
+	struct sockaddr *GetSockaddr(void) const;
+	std::string GetSockaddrStr(void) const;
+};
+#endif /* MBDYN_SHM_SUPPORTED */
 #endif /* _WIN32 */
 
 #endif
@@ -38,6 +38,7 @@
 #include "dataman.h"
 #include "filedrv.h"
 #include "varstep.h"
+#include "bindrv.h"
 #include "solver.h"
 #include "bisec.h"
 
@@ -51,11 +52,18 @@ VariableStepFileDrive::VariableStepFileDrive(unsigned int uL,
 		integer ind, bool bl, bool pz, Drive::Bailout bo)
 : FileDrive(uL, pDH, sFileName, ind, v0),
 iNumSteps(-1), iCurrStep(-1),
-bLinear(bl), bPadZeroes(pz), boWhen(bo), pd(0), pvd(0)
+bLinear(bl), bPadZeroes(pz), boWhen(bo), pBin(0), pd(0), pvd(0)
 {
 	ASSERT(iNumDrives > 0);
 	ASSERT(sFileName != NULL);
 
+	if (BinDriveFile::bIsBinary(sFileName)) {
+		OpenBinary();
+
+		ServePending(pDH->dGetTime());
+		return;
+	}
+
 	std::ifstream in(sFileName);
 	if (!in) {
 		silent_cerr("can't open file \""
@@ -100,7 +108,7 @@ bLinear(bl), bPadZeroes(pz), boWhen(bo), pd(0), pvd(0)
 	}
 
 	SAFENEWARR(pd, doublereal, (1 + iNumDrives)*iNumSteps);
-	SAFENEWARR(pvd, doublereal*, 1 + iNumDrives);
+	SAFENEWARR(pvd, const doublereal*, 1 + iNumDrives);
 
 	for (integer i = iNumDrives + 1; i-- > 0; ) {
 		pvd[i] = pd + i*iNumSteps;
@@ -109,7 +117,7 @@ bLinear(bl), bPadZeroes(pz), boWhen(bo), pd(0), pvd(0)
 	for (integer j = 0; j < iNumSteps; j++) {
 		// 0 -> iNumDrives to account for time
 		for (integer i = 0; i <= iNumDrives; i++) {
-			in >> pvd[i][j];
+			in >> pd[i*iNumSteps + j];
 			if (in.eof()) {
 				silent_cerr("unexpected end of file '"
 					<< sFileName << '\'' << std::endl);
@@ -153,22 +161,99 @@ bLinear(bl), bPadZeroes(pz), boWhen(bo), pd(0), pvd(0)
 	}
 
 	// All data is available, so initialize the buffer accordingly
-	// use bisection to initialize iCurrStep
-	doublereal dTime = pDH->dGetTime();
-	iCurrStep = bisec(pvd[0], dTime, 0, iNumSteps - 1);
-	if (iCurrStep < 0) {
-		iCurrStep++;
-	}
-
-	ServePending(dTime);
+	ServePending(pDH->dGetTime());
 }
 
 VariableStepFileDrive::~VariableStepFileDrive(void)
 {
-	SAFEDELETEARR(pd);
+	if (pd != 0) {
+		SAFEDELETEARR(pd);
+	}
+
+	if (pBin != 0) {
+		SAFEDELETE(pBin);
+	}
+
 	SAFEDELETEARR(pvd);
 }
 
+void
+VariableStepFileDrive::OpenBinary(void)
+{
+	SAFENEWWITHCONSTRUCTOR(pBin, BinDriveFile, BinDriveFile(sFileName));
+
+	if (!pBin->bIsVariableStep()) {
+		silent_cerr("VariableStepFileDrive(" << GetLabel() << "): "
+			"file \"" << sFileName << "\" contains fixed step data"
+			<< std::endl);
+		throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+	}
+
+	if (pBin->iGetNumColumns() != iNumDrives + 1) {
+		silent_cerr("VariableStepFileDrive(" << GetLabel() << "): "
+			"file \"" << sFileName << "\" contains "
+			<< pBin->iGetNumColumns() - 1 << " channels, "
+			<< iNumDrives << " expected" << std::endl);
+		throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+	}
+
+	iNumSteps = pBin->iGetNumSteps();
+
+	silent_cout("VariableStepFileDrive(" << GetLabel() << "): "
+		"counted " << iNumSteps << " steps" << std::endl);
+
+	/* time and channels are read in place from the mapped file;
+	 * time monotonicity is checked by the converter */
+	SAFENEWARR(pvd, const doublereal*, 1 + iNumDrives);
+	for (integer i = 0; i <= iNumDrives; i++) {
+		pvd[i] = pBin->pGetColumn(i);
+	}
+}
+
+void
+VariableStepFileDrive::FindStep(const doublereal& t)
+{
+	const doublereal *pt = pvd[0];
+
+	ASSERT(t > pt[0]);
+	ASSERT(t < pt[iNumSteps - 1]);
+
+	// time usually moves by a few records at most between calls,
+	// so look around the cached step first; since t is strictly
+	// within the bounds, there is no need to check for under/overflow
+	if (iCurrStep >= 0) {
+		for (int iCnt = 0; iCnt < 4; iCnt++) {
+			if (pt[iCurrStep] > t) {
+				iCurrStep--;
+
+			} else if (pt[iCurrStep + 1] <= t) {
+				iCurrStep++;
+
+			} else {
+				return;
+			}
+		}
+	}
+
+	// otherwise (first call, restart, large time step)
+	// bisect the side of the cached step that contains t
+	integer lb = 0;
+	integer ub = iNumSteps - 1;
+	if (iCurrStep >= 0) {
+		if (pt[iCurrStep] > t) {
+			ub = iCurrStep;
+
+		} else {
+			lb = iCurrStep;
+		}
+	}
+
+	iCurrStep = bisec(pt, t, lb, ub);
+
+	ASSERT(iCurrStep >= 0);
+	ASSERT(iCurrStep < iNumSteps - 1);
+}
+
 
 /* Scrive il contributo del DriveCaller al file di restart */
 std::ostream&
@@ -194,6 +279,10 @@ VariableStepFileDrive::ServePending(const doublereal& t)
 			}
 
 		} else {
+			if (pBin != 0) {
+				pBin->Touch(0);
+			}
+
 			for (int i = 1; i <= iNumDrives; i++) {
 				pdVal[i] = pvd[i][0];
 			}
@@ -212,6 +301,10 @@ VariableStepFileDrive::ServePending(const doublereal& t)
 			}
 
 		} else {
+			if (pBin != 0) {
+				pBin->Touch(iNumSteps - 1);
+			}
+
 			for (int i = 1; i <= iNumDrives; i++) {
 				pdVal[i] = pvd[i][iNumSteps - 1];
 			}
@@ -219,19 +312,11 @@ VariableStepFileDrive::ServePending(const doublereal& t)
 
 	} else {
 		// look for step exactly before
-		// note: use linear search, under the assumption
-		// that we always start from a relatively close guess
-		while (pvd[0][iCurrStep] > t) {
-			iCurrStep--;
-		}
-
-		// no need to check for under/uverflow
-		ASSERT(iCurrStep >= 0);
+		FindStep(t);
 
-		while (pvd[0][iCurrStep + 1] <= t) {
-			iCurrStep++;
+		if (pBin != 0) {
+			pBin->Touch(iCurrStep);
 		}
-		ASSERT(iCurrStep < iNumSteps);
 
 		integer j1 = iCurrStep;
 		if (bLinear) {
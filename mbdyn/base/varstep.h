@@ -38,6 +38,8 @@
 
 /* VariableStepFileDrive - begin */
 
+class BinDriveFile;
+
 class VariableStepFileDrive : public FileDrive {
 protected:
 	integer iNumSteps;
@@ -46,8 +48,17 @@ protected:
 	bool bPadZeroes;
 	Bailout boWhen;
 
+	/* binary input file, if any */
+	BinDriveFile* pBin;
+
 	doublereal* pd;
-	doublereal** pvd;
+	const doublereal** pvd;
+
+	void OpenBinary(void);
+
+	/* updates iCurrStep so that time[iCurrStep] <= t < time[iCurrStep + 1];
+	 * requires time[0] < t < time[iNumSteps - 1] */
+	void FindStep(const doublereal& t);
 
 public:
 	VariableStepFileDrive(unsigned int uL, const DriveHandler* pDH,
@@ -442,6 +442,19 @@ Pipe::AfterConvergence(const VectorHandler& X, const VectorHandler& XP)
 #endif /* HYDR_DEVEL */
    }
 }
+
+std::ostream&
+Pipe::Checkpoint(std::ostream& out) const
+{
+   /* laminar/turbulent flag, for the transition hysteresis */
+   return CheckpointPut(out, turbulent);
+}
+
+std::istream&
+Pipe::Resume(std::istream& in)
+{
+   return CheckpointGet(in, turbulent);
+}
    
 void Pipe::Output(OutputHandler& OH) const
 {
@@ -995,6 +1008,19 @@ Dynamic_pipe::AfterConvergence(const VectorHandler& X, const VectorHandler& XP)
 #endif /* HYDR_DEVEL */
 }
 
+std::ostream&
+Dynamic_pipe::Checkpoint(std::ostream& out) const
+{
+   /* laminar/turbulent flag, for the transition hysteresis */
+   return CheckpointPut(out, turbulent);
+}
+
+std::istream&
+Dynamic_pipe::Resume(std::istream& in)
+{
+   return CheckpointGet(in, turbulent);
+}
+
 void Dynamic_pipe::Output(OutputHandler& OH) const
 {
    if (bToBeOutput() && OH.UseText(OutputHandler::HYDRAULIC)) { 
@@ -1436,6 +1462,19 @@ DynamicPipe::AfterConvergence(const VectorHandler& X, const VectorHandler& XP)
 #endif /* HYDR_DEVEL */
 }
 
+std::ostream&
+DynamicPipe::Checkpoint(std::ostream& out) const
+{
+   /* laminar/turbulent flag, for the transition hysteresis */
+   return CheckpointPut(out, turbulent);
+}
+
+std::istream&
+DynamicPipe::Resume(std::istream& in)
+{
+   return CheckpointGet(in, turbulent);
+}
+
 void DynamicPipe::Output(OutputHandler& OH) const
 {
    if (bToBeOutput() && OH.UseText(OutputHandler::HYDRAULIC)) {
@@ -92,6 +92,10 @@ class Pipe : virtual public Elem, public HydraulicElem {
    
    virtual void AfterConvergence(const VectorHandler& X, 
 		   const VectorHandler& XP);
+   
+   virtual std::ostream& Checkpoint(std::ostream& out) const;
+   virtual std::istream& Resume(std::istream& in);
+   
    virtual void Output(OutputHandler& OH) const;
    
    virtual void SetValue(DataManager *pDM,
@@ -183,6 +187,10 @@ class Dynamic_pipe : virtual public Elem, public HydraulicElem {
    
    virtual void AfterConvergence(const VectorHandler& X, 
 		   const VectorHandler& XP);
+   
+   virtual std::ostream& Checkpoint(std::ostream& out) const;
+   virtual std::istream& Resume(std::istream& in);
+   
    virtual void Output(OutputHandler& OH) const;
    
    virtual void SetValue(DataManager *pDM,
@@ -282,6 +290,10 @@ class DynamicPipe : virtual public Elem, public HydraulicElem {
    
    virtual void AfterConvergence(const VectorHandler& X, 
 		   const VectorHandler& XP);
+   
+   virtual std::ostream& Checkpoint(std::ostream& out) const;
+   virtual std::istream& Resume(std::istream& in);
+   
    virtual void Output(OutputHandler& OH) const;
    
    virtual void SetValue(DataManager *pDM,
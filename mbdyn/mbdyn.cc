@@ -36,6 +36,7 @@
 
 #include <cerrno>
 #include <fstream>
+#include <memory>
 
 #include "ac/getopt.h"
 #include "task2cpu.h"
@@ -127,6 +128,7 @@ const char sDefaultOutputFileName[] = "MBDyn";
 #include "legalese.h"
 
 #include "cleanup.h"
+#include "parscache.h"
 
 enum InputFormat {
 	MBDYN,
@@ -143,13 +145,14 @@ enum InputSource {
 struct mbdyn_proc_t {
 	int iSleepTime;
 	bool bShowSymbolTable;
-	std::ifstream FileStreamIn;
+	InputFileStream FileStreamIn;
 	std::istream* pIn;
 	std::string sInputFileName;
 	std::string sOutputFileName;
 	bool bException;
 	bool bRedefine;
 	bool bTable;
+	bool bModelCache;
 	Table* pT;
 	MathParser* pMP;
 	InputFormat CurrInputFormat;
@@ -237,6 +240,8 @@ mbdyn_usage(const char *sShortOpts)
 		<< "  -h, --help                prints this message" << std::endl
 		<< "  -H, --show-table          print symbol table and exit" << std::endl
 		<< "  -l, --license             prints the licensing terms" << std::endl
+		<< "  -m, --model-cache         reads the model from '{file}.cache'" << std::endl
+		<< "                            when its input files did not change" << std::endl
 		/*
 		<< "  -N, --threads             number of threads (need multithread support)" << std::endl
 		 */
@@ -291,7 +296,7 @@ mbdyn_welcome(void)
 }
 
 /* Dati di getopt */
-static char sShortOpts[] = "C:d:eE::f:hHlN:o:pPrRsS:tTvwW:a:";
+static char sShortOpts[] = "C:d:eE::f:hHlmN:o:pPrRsS:tTvwW:a:";
 
 #ifdef HAVE_GETOPT_LONG
 static struct option LongOpts[] = {
@@ -303,6 +308,7 @@ static struct option LongOpts[] = {
 	{ "help",           no_argument,       NULL,           int('h') },
 	{ "show-table",     no_argument,       NULL,           int('H') },
 	{ "license",        no_argument,       NULL,           int('l') },
+	{ "model-cache",    no_argument,       NULL,           int('m') },
 	{ "threads",	    required_argument, NULL,	       int('N') },
 	{ "output-file",    required_argument, NULL,           int('o') },
 	{ "parallel",	    no_argument,       NULL,           int('p') },
@@ -484,6 +490,10 @@ mbdyn_parse_arguments(mbdyn_proc_t& mbp, int argc, char *argv[], int& currarg)
 			mbdyn_license();
 			throw NoErr(MBDYN_EXCEPT_ARGS);
 
+		case int('m'):
+			mbp.bModelCache = true;
+			break;
+
 		case int('N'):
 			if (strcmp(optarg, "auto") == 0) {
 				mbp.nThreads = 0;
@@ -934,10 +944,38 @@ mbdyn_program(mbdyn_proc_t& mbp, int argc, char *argv[], int& currarg)
 			std::string sOutputFileName = mbp.sOutputFileName;
 			mbdyn_prepare_files(mbp.sInputFileName, sOutputFileName);
 
+			/* must outlive the parser, which uses it until closed */
+			std::unique_ptr<ParserCache> pCache;
+			if (mbp.bModelCache) {
+				if (mbp.CurrInputSource == MBFILE_STDIN) {
+					silent_cerr("warning: the model cache cannot be used "
+						"when reading from standard input" << std::endl);
+
+				} else if (mbp.using_mpi) {
+					silent_cerr("warning: the model cache cannot be used "
+						"in parallel runs" << std::endl);
+
+				} else {
+					/* mbdyn_prepare_files() changed to the input file's folder */
+					std::string sCacheInput(mbp.sInputFileName);
+#ifdef HAVE_CHDIR
+					std::string::size_type pos = sCacheInput.rfind(DIR_SEP);
+					if (pos != std::string::npos) {
+						sCacheInput.erase(0, pos + 1);
+					}
+#endif // HAVE_CHDIR
+					pCache.reset(new ParserCache(sOutputFileName + ".cache",
+						sCacheInput, *mbp.pT));
+				}
+			}
+
 			/* stream in ingresso */
 			InputStream In(*mbp.pIn);
 			MBDynParser HP(*mbp.pMP, In,
 				mbp.sInputFileName == sDefaultInputFileName ? "initial file" : mbp.sInputFileName.c_str());
+			if (pCache) {
+				HP.SetCache(pCache.get());
+			}
 
 			pSolv = RunMBDyn(HP, mbp.sInputFileName,
 				sOutputFileName,
@@ -1054,6 +1092,7 @@ main(int argc, char* argv[])
        	mbp.bException = false;
        	mbp.bRedefine = false;
        	mbp.bTable = false;
+	mbp.bModelCache = false;
 	mbp.pT = 0;
 	mbp.pMP = 0;
        	mbp.bShowSymbolTable = false;
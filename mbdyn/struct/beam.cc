@@ -1089,6 +1089,14 @@ Beam::AfterPredict(VectorHandler& /* X */ ,
 	bFirstRes = true;
 }
 
+bool
+Beam::bIsOrderDependent(void) const
+{
+	/* the constitutive laws updated here are updated by AssRes()
+	 * as well, which the multithread data manager runs concurrently */
+	return false;
+}
+
 void
 Beam::OutputPrepare(OutputHandler &OH)
 {
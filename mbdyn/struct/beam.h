@@ -339,6 +339,9 @@ protected:
     virtual void
     AfterPredict(VectorHandler& /* X */ , VectorHandler& /* XP */ );
 
+    /* AfterPredict() and AfterConvergence() only touch its own sections */
+    virtual bool bIsOrderDependent(void) const;
+
     /* assemblaggio residuo */
     virtual SubVectorHandler&
     AssRes(SubVectorHandler& WorkVec,
@@ -611,6 +611,14 @@ Beam2::AfterPredict(VectorHandler& /* X */ , VectorHandler& /* XP */ )
 	bFirstRes = true;
 }
 
+bool
+Beam2::bIsOrderDependent(void) const
+{
+	/* the constitutive law updated here is updated by AssRes()
+	 * as well, which the multithread data manager runs concurrently */
+	return false;
+}
+
 
 void
 Beam2::OutputPrepare(OutputHandler &OH)
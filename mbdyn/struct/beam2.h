@@ -238,6 +238,9 @@ class Beam2
     virtual void
     AfterPredict(VectorHandler& /* X */ , VectorHandler& /* XP */ );
 
+    /* AfterPredict() and AfterConvergence() only touch its own section */
+    virtual bool bIsOrderDependent(void) const;
+
     /* assemblaggio residuo */
     virtual SubVectorHandler&
     AssRes(SubVectorHandler& WorkVec,
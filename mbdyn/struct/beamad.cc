@@ -72,8 +72,8 @@ BeamAd::~BeamAd()
 
 void BeamAd::WorkSpaceDim(integer* piNumRows, integer* piNumCols) const
 {
-     *piNumRows = 18;
-     *piNumCols = 0;
+     *piNumRows = iNumDof;
+     *piNumCols = iNumDof;
 }
 
 void
@@ -91,6 +91,48 @@ BeamAd::AddInternalForces(sp_grad::SpColVector<sp_grad::GpGradProd, 6>& AzLoc, u
 {
 }
 
+void
+BeamAd::AddInternalForces(sp_grad::SpColVector<sp_grad::SpDenseGradient<iNumDof>, 6>& AzLoc, unsigned int iSez)
+{
+}
+
+template <typename T>
+inline void
+BeamAd::UpdateConstLaw(unsigned int iSez,
+                       const sp_grad::SpColVector<T, 6>& DefLoc,
+                       sp_grad::SpColVector<T, 6>& AzLoc)
+{
+     pD[iSez]->pGetConstLaw()->Update(DefLoc, AzLoc);
+}
+
+// Constitutive laws are virtual and evaluate SpGradient only:
+// derivatives are computed with respect to the strains
+// and mapped back to the element's dofs by the chain rule.
+template <sp_grad::index_type N_SIZE>
+inline void
+BeamAd::UpdateConstLaw(unsigned int iSez,
+                       const sp_grad::SpColVector<sp_grad::SpDenseGradient<N_SIZE>, 6>& DefLoc,
+                       sp_grad::SpColVector<sp_grad::SpDenseGradient<N_SIZE>, 6>& AzLoc)
+{
+     using namespace sp_grad;
+
+     SpColVector<SpGradient, 6> DefLocTmp(6, 1), AzLocTmp(6, 6);
+
+     for (index_type i = 1; i <= 6; ++i) {
+          DefLocTmp(i).Reset(DefLoc(i).dGetValue(), i, 1.);
+     }
+
+     pD[iSez]->pGetConstLaw()->Update(DefLocTmp, AzLocTmp);
+
+     for (index_type i = 1; i <= 6; ++i) {
+          AzLoc(i).Reset(AzLocTmp(i).dGetValue());
+
+          for (index_type j = 1; j <= 6; ++j) {
+               DefLoc(j).InsertDeriv(AzLoc(i), AzLocTmp(i).dGetDeriv(j));
+          }
+     }
+}
+
 template <typename T>
 void
 BeamAd::InterpState(const sp_grad::SpColVector<T, 3>& v1,
@@ -316,7 +358,7 @@ BeamAd::UnivAssRes(sp_grad::SpGradientAssVec<T>& WorkVec,
           DEBUGCERR("BeamAd(" << GetLabel() << "): DefLoc[" << iSez << "]=" << DefLoc[iSez] << "\n");
 
           /* Calcola le azioni interne */
-          pD[iSez]->pGetConstLaw()->Update(DefLoc[iSez], AzLoc[iSez]);
+          UpdateConstLaw(iSez, DefLoc[iSez], AzLoc[iSez]);
 
           /* corregge le azioni interne locali (piezo, ecc) */
           AddInternalForces(AzLoc[iSez], iSez);
@@ -353,12 +395,12 @@ BeamAd::AssJac(VariableSubMatrixHandler& WorkMat,
 {
      DEBUGCOUTFNAME("BeamAd::AssJac");
 
-     sp_grad::SpGradientAssVec<sp_grad::SpGradient>::AssJac(this,
-                                                            WorkMat.SetSparseGradient(),
-                                                            dCoef,
-                                                            XCurr,
-                                                            XPrimeCurr,
-                                                            sp_grad::SpFunctionCall::REGULAR_JAC);
+     sp_grad::SpGradientAssVec<sp_grad::SpDenseGradient<iNumDof> >::AssJac(this,
+                                                                           WorkMat,
+                                                                           dCoef,
+                                                                           XCurr,
+                                                                           XPrimeCurr,
+                                                                           sp_grad::SpFunctionCall::REGULAR_JAC);
      return WorkMat;
 }
 
@@ -498,6 +540,44 @@ ViscoElasticBeamAd::InitialAssRes(sp_grad::SpGradientAssVec<T>& WorkVec,
      UnivAssRes(WorkVec, 1., XCurr, func);
 }
 
+template <typename T>
+inline void
+ViscoElasticBeamAd::UpdateConstLaw(unsigned int iSez,
+                                   const sp_grad::SpColVector<T, 6>& DefLoc,
+                                   const sp_grad::SpColVector<T, 6>& DefPrimeLoc,
+                                   sp_grad::SpColVector<T, 6>& AzLoc)
+{
+     pD[iSez]->pGetConstLaw()->Update(DefLoc, DefPrimeLoc, AzLoc);
+}
+
+template <sp_grad::index_type N_SIZE>
+inline void
+ViscoElasticBeamAd::UpdateConstLaw(unsigned int iSez,
+                                   const sp_grad::SpColVector<sp_grad::SpDenseGradient<N_SIZE>, 6>& DefLoc,
+                                   const sp_grad::SpColVector<sp_grad::SpDenseGradient<N_SIZE>, 6>& DefPrimeLoc,
+                                   sp_grad::SpColVector<sp_grad::SpDenseGradient<N_SIZE>, 6>& AzLoc)
+{
+     using namespace sp_grad;
+
+     SpColVector<SpGradient, 6> DefLocTmp(6, 1), DefPrimeLocTmp(6, 1), AzLocTmp(6, 12);
+
+     for (index_type i = 1; i <= 6; ++i) {
+          DefLocTmp(i).Reset(DefLoc(i).dGetValue(), i, 1.);
+          DefPrimeLocTmp(i).Reset(DefPrimeLoc(i).dGetValue(), i + 6, 1.);
+     }
+
+     pD[iSez]->pGetConstLaw()->Update(DefLocTmp, DefPrimeLocTmp, AzLocTmp);
+
+     for (index_type i = 1; i <= 6; ++i) {
+          AzLoc(i).Reset(AzLocTmp(i).dGetValue());
+
+          for (index_type j = 1; j <= 6; ++j) {
+               DefLoc(j).InsertDeriv(AzLoc(i), AzLocTmp(i).dGetDeriv(j));
+               DefPrimeLoc(j).InsertDeriv(AzLoc(i), AzLocTmp(i).dGetDeriv(j + 6));
+          }
+     }
+}
+
 template <typename T>
 inline void
 ViscoElasticBeamAd::UnivAssRes(sp_grad::SpGradientAssVec<T>& WorkVec,
@@ -658,7 +738,7 @@ ViscoElasticBeamAd::UnivAssRes(sp_grad::SpGradientAssVec<T>& WorkVec,
           DEBUGCERR("ViscoElasticBeamAd(" << GetLabel() << "): DefPrimeLoc[" << iSez << "]=" << DefPrimeLoc[iSez] << "\n");
 
           /* Calcola le azioni interne */
-          pD[iSez]->pGetConstLaw()->Update(DefLoc[iSez], DefPrimeLoc[iSez], AzLoc[iSez]);
+          UpdateConstLaw(iSez, DefLoc[iSez], DefPrimeLoc[iSez], AzLoc[iSez]);
 
           /* corregge le azioni interne locali (piezo, ecc) */
           AddInternalForces(AzLoc[iSez], iSez);
@@ -703,12 +783,12 @@ ViscoElasticBeamAd::AssJac(VariableSubMatrixHandler& WorkMat,
 {
      DEBUGCOUTFNAME("ViscoElasticBeamAd::AssJac");
 
-     sp_grad::SpGradientAssVec<sp_grad::SpGradient>::AssJac(this,
-                                                            WorkMat.SetSparseGradient(),
-                                                            dCoef,
-                                                            XCurr,
-                                                            XPrimeCurr,
-                                                            sp_grad::SpFunctionCall::REGULAR_JAC);
+     sp_grad::SpGradientAssVec<sp_grad::SpDenseGradient<iNumDof> >::AssJac(this,
+                                                                           WorkMat,
+                                                                           dCoef,
+                                                                           XCurr,
+                                                                           XPrimeCurr,
+                                                                           sp_grad::SpFunctionCall::REGULAR_JAC);
 
      return WorkMat;
 }
@@ -60,6 +60,9 @@ public:
 
      virtual ~BeamAd();
 
+     // three nodes with three displacements and three rotations each
+     static constexpr sp_grad::index_type iNumDof = 6 * NUMNODES;
+
      using Beam::AddInternalForces;
 
      virtual void WorkSpaceDim(integer* piNumRows, integer* piNumCols) const override;
@@ -121,6 +124,21 @@ protected:
      virtual void
      AddInternalForces(sp_grad::SpColVector<sp_grad::GpGradProd, 6>& AzLoc, unsigned int iSez);
 
+     virtual void
+     AddInternalForces(sp_grad::SpColVector<sp_grad::SpDenseGradient<iNumDof>, 6>& AzLoc, unsigned int iSez);
+
+     template <typename T>
+     inline void
+     UpdateConstLaw(unsigned int iSez,
+                    const sp_grad::SpColVector<T, 6>& DefLoc,
+                    sp_grad::SpColVector<T, 6>& AzLoc);
+
+     template <sp_grad::index_type N_SIZE>
+     inline void
+     UpdateConstLaw(unsigned int iSez,
+                    const sp_grad::SpColVector<sp_grad::SpDenseGradient<N_SIZE>, 6>& DefLoc,
+                    sp_grad::SpColVector<sp_grad::SpDenseGradient<N_SIZE>, 6>& AzLoc);
+
      template <typename T>
      inline void
      AssReactionForce(sp_grad::SpGradientAssVec<T>& WorkVec,
@@ -174,6 +192,15 @@ protected:
                  const std::array<sp_grad::SpColVectorA<sp_grad::GpGradProd, 6>, NUMSEZ>& Az,
                  const std::array<sp_grad::SpColVectorA<sp_grad::GpGradProd, 6>, NUMSEZ>& AzLoc) {}
 
+     inline void
+     UpdateState(const std::array<sp_grad::SpMatrixA<sp_grad::SpDenseGradient<iNumDof>, 3, 3>, NUMSEZ>& R,
+                 const std::array<sp_grad::SpColVectorA<sp_grad::SpDenseGradient<iNumDof>, 3>, NUMSEZ>& p,
+                 const std::array<sp_grad::SpColVectorA<sp_grad::SpDenseGradient<iNumDof>, 3>, NUMSEZ>& g,
+                 const std::array<sp_grad::SpColVectorA<sp_grad::SpDenseGradient<iNumDof>, 3>, NUMSEZ>& L,
+                 const std::array<sp_grad::SpColVectorA<sp_grad::SpDenseGradient<iNumDof>, 6>, NUMSEZ>& DefLoc,
+                 const std::array<sp_grad::SpColVectorA<sp_grad::SpDenseGradient<iNumDof>, 6>, NUMSEZ>& Az,
+                 const std::array<sp_grad::SpColVectorA<sp_grad::SpDenseGradient<iNumDof>, 6>, NUMSEZ>& AzLoc) {}
+
 protected:
      const std::array<const StructNodeAd*, NUMNODES> pNode;
 };
@@ -247,6 +274,20 @@ protected:
                 const sp_grad::SpGradientVectorHandler<T>& XCurr,
                 enum sp_grad::SpFunctionCall func);
 
+     template <typename T>
+     inline void
+     UpdateConstLaw(unsigned int iSez,
+                    const sp_grad::SpColVector<T, 6>& DefLoc,
+                    const sp_grad::SpColVector<T, 6>& DefPrimeLoc,
+                    sp_grad::SpColVector<T, 6>& AzLoc);
+
+     template <sp_grad::index_type N_SIZE>
+     inline void
+     UpdateConstLaw(unsigned int iSez,
+                    const sp_grad::SpColVector<sp_grad::SpDenseGradient<N_SIZE>, 6>& DefLoc,
+                    const sp_grad::SpColVector<sp_grad::SpDenseGradient<N_SIZE>, 6>& DefPrimeLoc,
+                    sp_grad::SpColVector<sp_grad::SpDenseGradient<N_SIZE>, 6>& AzLoc);
+
      inline void
      UpdateState(const std::array<sp_grad::SpMatrixA<doublereal, 3, 3>, NUMSEZ>& R,
                  const std::array<sp_grad::SpColVectorA<doublereal, 3>, NUMSEZ>& p,
@@ -273,6 +314,19 @@ protected:
                  const std::array<sp_grad::SpColVectorA<sp_grad::SpGradient, 6>, NUMSEZ>& Az,
                  const std::array<sp_grad::SpColVectorA<sp_grad::SpGradient, 6>, NUMSEZ>& AzLoc) {}
 
+     inline void
+     UpdateState(const std::array<sp_grad::SpMatrixA<sp_grad::SpDenseGradient<iNumDof>, 3, 3>, NUMSEZ>& R,
+                 const std::array<sp_grad::SpColVectorA<sp_grad::SpDenseGradient<iNumDof>, 3>, NUMSEZ>& p,
+                 const std::array<sp_grad::SpColVectorA<sp_grad::SpDenseGradient<iNumDof>, 3>, NUMSEZ>& g,
+                 const std::array<sp_grad::SpColVectorA<sp_grad::SpDenseGradient<iNumDof>, 3>, NUMSEZ>& gPrime,
+                 const std::array<sp_grad::SpColVectorA<sp_grad::SpDenseGradient<iNumDof>, 3>, NUMSEZ>& Omega,
+                 const std::array<sp_grad::SpColVectorA<sp_grad::SpDenseGradient<iNumDof>, 3>, NUMSEZ>& L,
+                 const std::array<sp_grad::SpColVectorA<sp_grad::SpDenseGradient<iNumDof>, 3>, NUMSEZ>& LPrime,
+                 const std::array<sp_grad::SpColVectorA<sp_grad::SpDenseGradient<iNumDof>, 6>, NUMSEZ>& DefLoc,
+                 const std::array<sp_grad::SpColVectorA<sp_grad::SpDenseGradient<iNumDof>, 6>, NUMSEZ>& DefPrimeLoc,
+                 const std::array<sp_grad::SpColVectorA<sp_grad::SpDenseGradient<iNumDof>, 6>, NUMSEZ>& Az,
+                 const std::array<sp_grad::SpColVectorA<sp_grad::SpDenseGradient<iNumDof>, 6>, NUMSEZ>& AzLoc) {}
+
      inline void
      UpdateState(const std::array<sp_grad::SpMatrixA<sp_grad::GpGradProd, 3, 3>, NUMSEZ>& R,
                  const std::array<sp_grad::SpColVectorA<sp_grad::GpGradProd, 3>, NUMSEZ>& p,
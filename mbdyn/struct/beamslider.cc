@@ -946,6 +946,28 @@ BeamSliderJoint::AfterConvergence(const VectorHandler& X,
 	}
 }
 
+std::ostream&
+BeamSliderJoint::Checkpoint(std::ostream& out) const
+{
+	CheckpointPut(out, iCurrBeam);
+	if (fc) {
+		fc->Checkpoint(out);
+	}
+
+	return out;
+}
+
+std::istream&
+BeamSliderJoint::Resume(std::istream& in)
+{
+	CheckpointGet(in, iCurrBeam);
+	if (fc) {
+		fc->Resume(in);
+	}
+
+	return in;
+}
+
 /* Contributo allo jacobiano durante l'assemblaggio iniziale */
 VariableSubMatrixHandler &
 BeamSliderJoint::InitialAssJac(
@@ -276,6 +276,9 @@ public:
 	virtual void AfterConvergence(const VectorHandler& X,
 		const VectorHandler& XP);
 
+	virtual std::ostream& Checkpoint(std::ostream& out) const;
+	virtual std::istream& Resume(std::istream& in);
+
 	/* describes the dimension of components of equation */
    virtual std::ostream& DescribeEq(std::ostream& out,
 		  const char *prefix = "",
@@ -795,6 +795,12 @@ Body::AfterPredict(VectorHandler& /* X */ , VectorHandler& /* XP */ )
 	JTmp = R*J0.MulMT(R);
 }
 
+bool
+Body::bIsOrderDependent(void) const
+{
+	return false;
+}
+
 /* massa totale */
 doublereal
 Body::dGetM(void) const
@@ -340,6 +340,9 @@ public:
 
         virtual void AfterPredict(VectorHandler& X, VectorHandler& XP);
 
+        /* AfterPredict() only reads its own node */
+        virtual bool bIsOrderDependent(void) const;
+
         /* Accesso ai dati privati */
         virtual unsigned int iGetNumPrivData(void) const;
         virtual unsigned int iGetPrivDataIdx(const char *s) const;
@@ -136,7 +136,7 @@ void
 DynamicBodyAd::WorkSpaceDim(integer* piNumRows, integer* piNumCols) const
 {
      *piNumRows = 12;
-     *piNumCols = 0;
+     *piNumCols = iNumDof;
 }
 
 VariableSubMatrixHandler&
@@ -149,12 +149,12 @@ DynamicBodyAd::AssJac(VariableSubMatrixHandler& WorkMat,
 
      using namespace sp_grad;
 
-     SpGradientAssVec<SpGradient>::AssJac(this,
-                                          WorkMat.SetSparseGradient(),
-                                          dCoef,
-                                          XCurr,
-                                          XPrimeCurr,
-                                          SpFunctionCall::REGULAR_JAC);
+     SpGradientAssVec<SpDenseGradient<iNumDof> >::AssJac(this,
+                                                         WorkMat,
+                                                         dCoef,
+                                                         XCurr,
+                                                         XPrimeCurr,
+                                                         SpFunctionCall::REGULAR_JAC);
 
      return WorkMat;
 }
@@ -302,7 +302,7 @@ void
 StaticBodyAd::WorkSpaceDim(integer* piNumRows, integer* piNumCols) const
 {
      *piNumRows = 12;
-     *piNumCols = 0;
+     *piNumCols = iNumDof;
 }
 
 VariableSubMatrixHandler&
@@ -315,12 +315,12 @@ StaticBodyAd::AssJac(VariableSubMatrixHandler& WorkMat,
 
      using namespace sp_grad;
 
-     SpGradientAssVec<SpGradient>::AssJac(this,
-                                          WorkMat.SetSparseGradient(),
-                                          dCoef,
-                                          XCurr,
-                                          XPrimeCurr,
-                                          SpFunctionCall::REGULAR_JAC);
+     SpGradientAssVec<SpDenseGradient<iNumDof> >::AssJac(this,
+                                                         WorkMat,
+                                                         dCoef,
+                                                         XCurr,
+                                                         XPrimeCurr,
+                                                         SpFunctionCall::REGULAR_JAC);
      return WorkMat;
 }
 
@@ -452,7 +452,7 @@ void
 ModalBodyAd::WorkSpaceDim(integer* piNumRows, integer* piNumCols) const
 {
      *piNumRows = 6;
-     *piNumCols = 0;
+     *piNumCols = iNumDof;
 }
 
 VariableSubMatrixHandler&
@@ -463,12 +463,12 @@ ModalBodyAd::AssJac(VariableSubMatrixHandler& WorkMat,
 {
      DEBUGCOUTFNAME("ModalBodyAd::AssJac");
 
-     sp_grad::SpGradientAssVec<sp_grad::SpGradient>::AssJac(this,
-                                                            WorkMat.SetSparseGradient(),
-                                                            dCoef,
-                                                            XCurr,
-                                                            XPrimeCurr,
-                                                            sp_grad::SpFunctionCall::REGULAR_JAC);
+     sp_grad::SpGradientAssVec<sp_grad::SpDenseGradient<iNumDof> >::AssJac(this,
+                                                                           WorkMat,
+                                                                           dCoef,
+                                                                           XCurr,
+                                                                           XPrimeCurr,
+                                                                           sp_grad::SpFunctionCall::REGULAR_JAC);
 
      return WorkMat;
 }
@@ -78,6 +78,11 @@ protected:
      void
      UpdateInertia(const sp_grad::SpColVector<sp_grad::GpGradProd, 3>& STmp,
                    const sp_grad::SpMatrix<sp_grad::GpGradProd, 3, 3>& JTmp) const {}
+
+     template <sp_grad::index_type N_SIZE>
+     void
+     UpdateInertia(const sp_grad::SpColVector<sp_grad::SpDenseGradient<N_SIZE>, 3>& STmp,
+                   const sp_grad::SpMatrix<sp_grad::SpDenseGradient<N_SIZE>, 3, 3>& JTmp) const {}
 private:
      const StructNodeAd* const pNode;
 };
@@ -90,6 +95,9 @@ public:
 
      virtual ~DynamicBodyAd();
 
+     // position and rotation of the node
+     static constexpr sp_grad::index_type iNumDof = 6;
+
      virtual void WorkSpaceDim(integer* piNumRows, integer* piNumCols) const override;
 
      virtual VariableSubMatrixHandler&
@@ -138,6 +146,9 @@ public:
 
      virtual ~StaticBodyAd();
 
+     // position and rotation of the node
+     static constexpr sp_grad::index_type iNumDof = 6;
+
      virtual void WorkSpaceDim(integer* piNumRows, integer* piNumCols) const override;
 
      virtual VariableSubMatrixHandler&
@@ -179,6 +190,9 @@ public:
 
      virtual ~ModalBodyAd();
 
+     // rotation, linear and angular acceleration of the node
+     static constexpr sp_grad::index_type iNumDof = 9;
+
      virtual void WorkSpaceDim(integer* piNumRows, integer* piNumCols) const override;
 
      virtual VariableSubMatrixHandler&
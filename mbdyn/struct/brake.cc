@@ -113,6 +113,28 @@ Brake::AfterConvergence(const VectorHandler& X,
 	fc->AfterConvergence(modF, v, X, XP, iGetFirstIndex() + NumSelfDof);
 }
 
+std::ostream&
+Brake::Checkpoint(std::ostream& out) const
+{
+	CheckpointPut(out, dTheta);
+	if (fc) {
+		fc->Checkpoint(out);
+	}
+
+	return out;
+}
+
+std::istream&
+Brake::Resume(std::istream& in)
+{
+	CheckpointGet(in, dTheta);
+	if (fc) {
+		fc->Resume(in);
+	}
+
+	return in;
+}
+
 
 /* Contributo al file di restart */
 std::ostream& Brake::Restart(std::ostream& out) const
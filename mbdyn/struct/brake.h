@@ -128,6 +128,9 @@ class Brake : virtual public Elem, public Joint {
    virtual void AfterConvergence(const VectorHandler& X, 
 			const VectorHandler& XP);
 
+   virtual std::ostream& Checkpoint(std::ostream& out) const;
+   virtual std::istream& Resume(std::istream& in);
+
    void WorkSpaceDim(integer* piNumRows, integer* piNumCols) const { 
       *piNumRows = NumDof;
       *piNumCols = NumDof;
@@ -385,6 +385,36 @@ void DiscreteCoulombFriction::AfterConvergence(
 //* 	std::cerr << "CONVERGENZA; v = " << v << "; f = " << f << std::endl;
 };
 
+std::ostream& DiscreteCoulombFriction::Checkpoint(std::ostream& out) const {
+	/* stick/slip status as of the last converged step;
+	 * transition_type, first_iter and first_switch are reset
+	 * by AfterConvergence() */
+	CheckpointPut(out, status);
+	CheckpointPut(out, converged_v);
+	CheckpointPut(out, previous_switch_v);
+	CheckpointPut(out, current_velocity);
+	CheckpointPut(out, saved_sliding_velocity);
+	CheckpointPut(out, saved_sliding_friction);
+	CheckpointPut(out, current_friction_force);
+	CheckpointPut(out, f);
+	return out;
+};
+
+std::istream& DiscreteCoulombFriction::Resume(std::istream& in) {
+	CheckpointGet(in, status);
+	CheckpointGet(in, converged_v);
+	CheckpointGet(in, previous_switch_v);
+	CheckpointGet(in, current_velocity);
+	CheckpointGet(in, saved_sliding_velocity);
+	CheckpointGet(in, saved_sliding_friction);
+	CheckpointGet(in, current_friction_force);
+	CheckpointGet(in, f);
+	transition_type = null;
+	first_iter = true;
+	first_switch = true;
+	return in;
+};
+
 
 void DiscreteCoulombFriction::AssRes(
 	SubVectorHandler& WorkVec,
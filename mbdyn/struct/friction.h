@@ -271,6 +271,8 @@ public:
 		const VectorHandler&X, 
 		const VectorHandler&XP,
 		const unsigned int solution_startdof);
+	std::ostream& Checkpoint(std::ostream& out) const;
+	std::istream& Resume(std::istream& in);
 	void AssRes(
 		SubVectorHandler& WorkVec,
 		const unsigned int startdof,
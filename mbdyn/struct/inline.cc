@@ -355,6 +355,26 @@ void InLineJoint::Output(OutputHandler& OH) const
 		}
    }
 }
+
+std::ostream&
+InLineJoint::Checkpoint(std::ostream& out) const
+{
+	if (fc) {
+		fc->Checkpoint(out);
+	}
+
+	return out;
+}
+
+std::istream&
+InLineJoint::Resume(std::istream& in)
+{
+	if (fc) {
+		fc->Resume(in);
+	}
+
+	return in;
+}
  
 
 /* Contributo allo jacobiano durante l'assemblaggio iniziale */
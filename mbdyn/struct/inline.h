@@ -112,6 +112,9 @@ class InLineJoint : virtual public Elem, public Joint {
 	void OutputPrepare(OutputHandler &OH);
    virtual void Output(OutputHandler& OH) const;
 
+   virtual std::ostream& Checkpoint(std::ostream& out) const;
+   virtual std::istream& Resume(std::istream& in);
+
    
    /* funzioni usate nell'assemblaggio iniziale */
    
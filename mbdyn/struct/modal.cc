@@ -117,15 +117,163 @@
 
 #include "modal.h"
 #include "modalad.h"
+#include "modalbin.h"
 #include "dataman.h"
 #include "Rot.hh"
 #include "hint_impl.h"
+#include "ac/lapack.h"
 
 Modal::StrNodeData::StrNodeData()
      :pNode(nullptr), pNodeAd(nullptr), bOut(false)
 {
 }
 
+/*
+ * Kernels used by Modal::AssRes() and Modal::AssJac(); matrices are stored
+ * by columns (Fortran style) unless otherwise stated.  When BLAS are
+ * available, the NModes x NModes products are delegated to them.
+ */
+
+/* y = alpha*A*x + beta*y, A m x n */
+static void
+ModalGemv(integer m, integer n, doublereal alpha,
+	const doublereal *A, integer lda, const doublereal *x,
+	doublereal beta, doublereal *y)
+{
+#if defined HAVE_BLAS
+#if defined HAVE_CBLAS
+	cblas_dgemv(CblasColMajor, CblasNoTrans, m, n, alpha, A, lda,
+		x, 1, beta, y, 1);
+#else /* ! HAVE_CBLAS */
+	const integer inc = 1;
+	__FC_DECL__(dgemv)("N", &m, &n, &alpha, A, &lda,
+		x, &inc, &beta, y, &inc);
+#endif /* ! HAVE_CBLAS */
+#else /* ! HAVE_BLAS */
+	if (beta == 0.) {
+		std::fill(y, y + m, 0.);
+
+	} else if (beta != 1.) {
+		for (integer i = 0; i < m; i++) {
+			y[i] *= beta;
+		}
+	}
+
+	for (integer j = 0; j < n; j++) {
+		const doublereal *Aj = A + j*lda;
+		doublereal d = alpha*x[j];
+
+		for (integer i = 0; i < m; i++) {
+			y[i] += Aj[i]*d;
+		}
+	}
+#endif /* ! HAVE_BLAS */
+}
+
+/* C = A*B, A m x k, B k x n */
+static void
+ModalGemm(integer m, integer n, integer k,
+	const doublereal *A, integer lda,
+	const doublereal *B, integer ldb,
+	doublereal *C, integer ldc)
+{
+#if defined HAVE_BLAS
+	const doublereal alpha = 1.;
+	const doublereal beta = 0.;
+#if defined HAVE_CBLAS
+	cblas_dgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, m, n, k,
+		alpha, A, lda, B, ldb, beta, C, ldc);
+#else /* ! HAVE_CBLAS */
+	__FC_DECL__(dgemm)("N", "N", &m, &n, &k, &alpha, A, &lda,
+		B, &ldb, &beta, C, &ldc);
+#endif /* ! HAVE_CBLAS */
+#else /* ! HAVE_BLAS */
+	for (integer j = 0; j < n; j++) {
+		ModalGemv(m, k, 1., A, lda, B + j*ldb, 0., C + j*ldc);
+	}
+#endif /* ! HAVE_BLAS */
+}
+
+/* the three rows of a row-major 3 x n matrix times x */
+static Vec3
+ModalMult(const doublereal *pm, integer n, const doublereal *x)
+{
+	doublereal d[3] = { 0., 0., 0. };
+	for (integer j = 0; j < n; j++) {
+		d[0] += pm[j]*x[j];
+		d[1] += pm[n + j]*x[j];
+		d[2] += pm[2*n + j]*x[j];
+	}
+
+	return Vec3(d);
+}
+
+/* y += alpha*m^T*v, m row-major 3 x n with rows pm1, pm2, pm3 */
+static void
+ModalMulTAdd(const doublereal *pm1, const doublereal *pm2,
+	const doublereal *pm3, integer n,
+	const Vec3& v, doublereal alpha, doublereal *y)
+{
+	doublereal d1 = alpha*v(1);
+	doublereal d2 = alpha*v(2);
+	doublereal d3 = alpha*v(3);
+
+	for (integer j = 0; j < n; j++) {
+		y[j] += pm1[j]*d1 + pm2[j]*d2 + pm3[j]*d3;
+	}
+}
+
+static void
+ModalMulTAdd(const Mat3xN& m, const Vec3& v, doublereal alpha, doublereal *y)
+{
+	ModalMulTAdd(m.pGetRow(1), m.pGetRow(2), m.pGetRow(3),
+		m.iGetNumCols(), v, alpha, y);
+}
+
+/* sum_j x_j*m_j, m_j the j-th 3x3 block of columns of m */
+static Mat3x3
+ModalBlockSum(const Mat3xN& m, const VecN& x)
+{
+	integer n = x.iGetNumRows();
+	const doublereal *px = x.pGetVec();
+
+	Mat3x3 s;
+	for (int r = 1; r <= 3; r++) {
+		const doublereal *pm = m.pGetRow(r);
+		doublereal d[3] = { 0., 0., 0. };
+
+		for (integer j = 0; j < n; j++) {
+			d[0] += pm[3*j]*px[j];
+			d[1] += pm[3*j + 1]*px[j];
+			d[2] += pm[3*j + 2]*px[j];
+		}
+
+		s(r, 1) = d[0];
+		s(r, 2) = d[1];
+		s(r, 3) = d[2];
+	}
+
+	return s;
+}
+
+/* y_j += alpha*u^T*m_j*u, m_j the j-th 3x3 block of columns of m */
+static void
+ModalBlockQuadAdd(const Mat3xN& m, const Vec3& u, doublereal alpha, doublereal *y)
+{
+	integer n = m.iGetNumCols()/3;
+
+	for (int r = 1; r <= 3; r++) {
+		const doublereal *pm = m.pGetRow(r);
+		doublereal d1 = alpha*u(r)*u(1);
+		doublereal d2 = alpha*u(r)*u(2);
+		doublereal d3 = alpha*u(r)*u(3);
+
+		for (integer j = 0; j < n; j++) {
+			y[j] += pm[3*j]*d1 + pm[3*j + 1]*d2 + pm[3*j + 2]*d3;
+		}
+	}
+}
+
 Modal::Modal(unsigned int uL,
 	const ModalNode* pR,
 	const Vec3& x0,
@@ -168,8 +316,10 @@ RT(R0.Transpose()),
 NModes(NM),
 NStrNodes(NI),
 NFEMNodes(NF),
-IdFEMNodes(std::move(IdFEMNodes)),
-oXYZFEMNodes(std::move(oN)),
+pFEMData(ShareFEMData(std::move(IdFEMNodes), std::move(oN),
+	std::move(oModeShapest), std::move(oModeShapesr))),
+IdFEMNodes(pFEMData->IdFEMNodes),
+oXYZFEMNodes(pFEMData->oXYZFEMNodes),
 dMass(dMassTmp),
 Inv2(STmp),
 Inv7(JTmp),
@@ -179,8 +329,8 @@ oModalStiff(std::move(oGenStiff)),
 oModalDamp(std::move(oGenDamp)),
 oPHIt(std::move(oPHItStrNode)),
 oPHIr(std::move(oPHIrStrNode)),
-oModeShapest(std::move(oModeShapest)),
-oModeShapesr(std::move(oModeShapesr)),
+oModeShapest(pFEMData->oModeShapest),
+oModeShapesr(pFEMData->oModeShapesr),
 oCurrXYZ{},
 oCurrXYZVel{},
 oInv3(std::move(oInv3)),
@@ -202,10 +352,89 @@ a(aa), a0(aa),
 aPrime(NModes, 0.), aPrime0(bb),
 b(bb),
 bPrime(NModes, 0.),
+PHItNode(3*NModes*NStrNodes),
+PHIrNode(3*NModes*NStrNodes),
+fModal(NModes, 0.),
+abModal(4*NModes),
+Inv9jkak(this->oInv9.iGetNumCols() ? 9*NModes : 0),
 SND(std::move(snd))
 {
      ASSERT(NStrNodes == SND.size());
      ASSERT(pModalNode == nullptr || pModalNode->GetStructNodeType() == StructNode::MODAL);
+
+     /* the mode shapes of each interface node are gathered once for all,
+      * so that AssRes() and AssJac() access them contiguously */
+     for (unsigned int iStrNodem1 = 0; iStrNodem1 < NStrNodes; iStrNodem1++) {
+          doublereal *pt = &PHItNode[3*NModes*iStrNodem1];
+          doublereal *pr = &PHIrNode[3*NModes*iStrNodem1];
+
+          for (unsigned int jModem1 = 0; jModem1 < NModes; jModem1++) {
+               integer iOffset = jModem1*NStrNodes + iStrNodem1 + 1;
+
+               for (int r = 1; r <= 3; r++) {
+                    pt[(r - 1)*NModes + jModem1] = oPHIt(r, iOffset);
+                    pr[(r - 1)*NModes + jModem1] = oPHIr(r, iOffset);
+               }
+          }
+     }
+}
+
+static bool
+bIsSame(const Mat3xN& A, const Mat3xN& B)
+{
+	if (A.iGetNumCols() != B.iGetNumCols()) {
+		return false;
+	}
+
+	for (int r = 1; r <= 3; r++) {
+		if (!std::equal(A.pGetRow(r), A.pGetRow(r) + A.iGetNumCols(), B.pGetRow(r))) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/*
+ * Elements that read the same database usually get the same FEM node
+ * data, by far the largest part of it: a single copy is kept as long
+ * as any of them exists.  Identical data are found by comparison,
+ * so that mode selection, origin and the like need not be tracked.
+ */
+std::shared_ptr<const Modal::FEMData>
+Modal::ShareFEMData(std::vector<std::string>&& IdFEMNodes, Mat3xN&& oXYZFEMNodes,
+	Mat3xN&& oModeShapest, Mat3xN&& oModeShapesr)
+{
+	/* the registry does not own the data */
+	typedef std::vector<std::weak_ptr<const FEMData> > FEMDataList;
+	static FEMDataList Shared;
+
+	for (FEMDataList::iterator i = Shared.begin(); i != Shared.end(); ) {
+		std::shared_ptr<const FEMData> pData(i->lock());
+		if (!pData) {
+			i = Shared.erase(i);
+			continue;
+		}
+
+		if (pData->IdFEMNodes == IdFEMNodes
+			&& bIsSame(pData->oXYZFEMNodes, oXYZFEMNodes)
+			&& bIsSame(pData->oModeShapest, oModeShapest)
+			&& bIsSame(pData->oModeShapesr, oModeShapesr))
+		{
+			return pData;
+		}
+
+		++i;
+	}
+
+	std::shared_ptr<FEMData> pData(new FEMData);
+	pData->IdFEMNodes = std::move(IdFEMNodes);
+	pData->oXYZFEMNodes = std::move(oXYZFEMNodes);
+	pData->oModeShapest = std::move(oModeShapest);
+	pData->oModeShapesr = std::move(oModeShapesr);
+	Shared.push_back(pData);
+
+	return pData;
 }
 
 Modal::~Modal(void)
@@ -602,14 +831,22 @@ Modal::AssJac(VariableSubMatrixHandler& WorkMat,
 
 		WM.PutCoef(iiCnt, iiCnt, 1.);
 		WM.PutCoef(iiCnt, iiCnt + NModes, -dCoef);
-		for (unsigned int jCnt = 1; jCnt <= NModes; jCnt++) {
-			unsigned int jjCnt = iRigidOffset + jCnt;
+	}
+
+	/* K, C and M are stored by columns, like the work matrix */
+	for (unsigned int jCnt = 1; jCnt <= NModes; jCnt++) {
+		unsigned int jjCnt = iRigidOffset + jCnt;
+		const doublereal *pK = oModalStiff.begin() + (jCnt - 1)*NModes;
+		const doublereal *pC = oModalDamp.begin() + (jCnt - 1)*NModes;
+		const doublereal *pM = oModalMass.begin() + (jCnt - 1)*NModes;
+
+		for (unsigned int iCnt = 1; iCnt <= NModes; iCnt++) {
+			unsigned int iiCnt = iRigidOffset + iCnt;
 
 			WM.PutCoef(iiCnt + NModes, jjCnt,
-					dCoef*oModalStiff.dGet(iCnt, jCnt));
+					dCoef*pK[iCnt - 1]);
 			WM.PutCoef(iiCnt + NModes, jjCnt + NModes,
-					oModalMass.dGet(iCnt, jCnt)
-					+ dCoef*oModalDamp.dGet(iCnt, jCnt));
+					pM[iCnt - 1] + dCoef*pC[iCnt - 1]);
 		}
 	}
 
@@ -728,11 +965,11 @@ Modal::AssJac(VariableSubMatrixHandler& WorkMat,
 
 		/* recupero le forme modali del nodo vincolato */
 		Mat3xN PHIt(NModes), PHIr(NModes);
-		for (unsigned int jMode = 1; jMode <= NModes; jMode++) {
-			integer iOffset = (jMode - 1)*NStrNodes + iStrNode;
-
-			PHIt.PutVec(jMode, oPHIt.GetVec(iOffset));
-			PHIr.PutVec(jMode, oPHIr.GetVec(iOffset));
+		const doublereal *pPHIt = &PHItNode[3*NModes*iStrNodem1];
+		const doublereal *pPHIr = &PHIrNode[3*NModes*iStrNodem1];
+		for (int r = 1; r <= 3; r++) {
+			std::copy(pPHIt + (r - 1)*NModes, pPHIt + r*NModes, PHIt.pGetRow(r));
+			std::copy(pPHIr + (r - 1)*NModes, pPHIr + r*NModes, PHIr.pGetRow(r));
 		}
 
 		MatNx3 PHItT(NModes), PHIrT(NModes);
@@ -918,14 +1155,17 @@ Modal::AssRes(SubVectorHandler& WorkVec,
 	b.Copy(XCurr, iModalIndex + NModes + 1);
 	bPrime.Copy(XPrimeCurr, iModalIndex + NModes + 1);
 
-	VecN Ka(NModes), CaP(NModes), MaPP(NModes);
-
 	/*
 	 * aggiornamento invarianti
 	 */
-	Ka.Mult(oModalStiff, a);
-	CaP.Mult(oModalDamp, b);
-	MaPP.Mult(oModalMass, bPrime);
+
+	/* fModal = K*a + C*b + M*bP */
+	ModalGemv(NModes, NModes, 1., oModalStiff.begin(), NModes,
+		a.pGetVec(), 0., fModal.pGetVec());
+	ModalGemv(NModes, NModes, 1., oModalDamp.begin(), NModes,
+		b.pGetVec(), 1., fModal.pGetVec());
+	ModalGemv(NModes, NModes, 1., oModalMass.begin(), NModes,
+		bPrime.pGetVec(), 1., fModal.pGetVec());
 
 #if 0
 	std::cerr << "### Stiff" << std::endl;
@@ -981,80 +1221,79 @@ Modal::AssRes(SubVectorHandler& WorkVec,
 	}
 
 	/* invarianti rotazionali */
-	if (oInv8.iGetNumCols()) {
-		Inv8jaj.Reset();
-		Inv8jaPj.Reset();
-	}
 	if (oInv5.iGetNumCols()) {
-		Inv5jaj.Reset(0.);
-		Inv5jaPj.Reset(0.);
-	}
+		/*
+		 * ogni riga di Inv5 e' una matrice NModes x NModes
+		 * (per colonne, il modo j indica la colonna):
+		 * [Inv5jaj Inv5jaPj] = Inv5*[a b], riga per riga
+		 */
+		doublereal *pab = &abModal[0];
+		doublereal *pInv5ab = &abModal[2*NModes];
 
-	// Mat3x3 MatTmp1(::Zero3x3), MatTmp2(::Zero3x3);
+		std::copy(a.pGetVec(), a.pGetVec() + NModes, pab);
+		std::copy(b.pGetVec(), b.pGetVec() + NModes, pab + NModes);
+
+		for (int r = 1; r <= 3; r++) {
+			ModalGemm(NModes, 2, NModes, oInv5.pGetRow(r), NModes,
+				pab, NModes, pInv5ab, NModes);
+
+			std::copy(pInv5ab, pInv5ab + NModes, Inv5jaj.pGetRow(r));
+			std::copy(pInv5ab + NModes, pInv5ab + 2*NModes, Inv5jaPj.pGetRow(r));
+		}
+	}
 
 	if (oInv9.iGetNumCols()) {
 		Inv9jkajak.Reset();
 		Inv9jkajaPk.Reset();
 	}
-	Mat3x3 Inv10jaPj(::Zero3x3);
 
-	if (oInv5.iGetNumCols() || oInv8.iGetNumCols() || oInv9.iGetNumCols() || oInv10.iGetNumCols()) {
-		for (unsigned int jMode = 1; jMode <= NModes; jMode++)  {
-			doublereal a_jMode = a(jMode);
-			doublereal aP_jMode = b(jMode);
-
-			if (oInv5.iGetNumCols()) {
-				for (unsigned int kMode = 1; kMode <= NModes; kMode++) {
-					Vec3 v = oInv5.GetVec((jMode - 1)*NModes + kMode);
-
-					Inv5jaj.AddVec(kMode, v*a_jMode);
-					Inv5jaPj.AddVec(kMode, v*aP_jMode);
-				}
-			}
-
-			if (oInv8.iGetNumCols()) {
-				Mat3x3 Inv8jajTmp;
-
-				for (unsigned int jCnt = 1; jCnt <= 3; jCnt++) {
-					unsigned int iMjC = (jMode - 1)*3 + jCnt;
-
-					Inv8jajTmp.PutVec(jCnt, oInv8.GetVec(iMjC));
-				}
+	if (oInv8.iGetNumCols()) {
+		Inv8jaj = ModalBlockSum(oInv8, a);
+		Inv8jaPj = ModalBlockSum(oInv8, b);
 
-				Inv8jaj += Inv8jajTmp * a_jMode;
-				Inv8jaPj += Inv8jajTmp * aP_jMode;
+		if (oInv9.iGetNumCols()) {
+			/*
+			 * questi termini si possono commentare perche' sono
+			 * (sempre ?) piccoli (termini del tipo a*a o a*b)
+			 * eventualmente dare all'utente la possibilita'
+			 * di scegliere se trascurarli o no
+			 *
+			 * sum_k Inv9jk*a_k is kept for the modal forces;
+			 * Inv9 is swept only once, for both a and b
+			 */
+			const doublereal *pa = a.pGetVec();
+			const doublereal *pb = b.pGetVec();
+			for (unsigned int jModem1 = 0; jModem1 < NModes; jModem1++) {
+				doublereal *pY = &Inv9jkak[9*jModem1];
+
+				for (int r = 1; r <= 3; r++) {
+					const doublereal *pm = oInv9.pGetRow(r) + 3*NModes*jModem1;
+					doublereal ya[3] = { 0., 0., 0. };
+					doublereal yb[3] = { 0., 0., 0. };
 
-				if (oInv9.iGetNumCols()) {
-					/*
-					 * questi termini si possono commentare perche' sono
-					 * (sempre ?) piccoli (termini del tipo a*a o a*b)
-					 * eventualmente dare all'utente la possibilita'
-					 * di scegliere se trascurarli o no
-					 */
-					for (unsigned int kMode = 1; kMode <= NModes; kMode++) {
-						doublereal a_kMode = a(kMode);
-						doublereal aP_kMode = b(kMode);
-						unsigned int iOffset = (jMode - 1)*3*NModes + (kMode - 1)*3 + 1;
-						Inv9jkajak += oInv9.GetMat3x3ScalarMult(iOffset, a_jMode*a_kMode);
-						Inv9jkajaPk += oInv9.GetMat3x3ScalarMult(iOffset, a_jMode*aP_kMode);
+					for (unsigned int kModem1 = 0; kModem1 < NModes; kModem1++) {
+						ya[0] += pm[3*kModem1]*pa[kModem1];
+						ya[1] += pm[3*kModem1 + 1]*pa[kModem1];
+						ya[2] += pm[3*kModem1 + 2]*pa[kModem1];
+						yb[0] += pm[3*kModem1]*pb[kModem1];
+						yb[1] += pm[3*kModem1 + 1]*pb[kModem1];
+						yb[2] += pm[3*kModem1 + 2]*pb[kModem1];
 					}
-				}
-			}
 
-			if (oInv10.iGetNumCols()) {
-				Mat3x3 Inv10jaPjTmp;
-
-				for (unsigned int jCnt = 1; jCnt <= 3; jCnt++) {
-					unsigned int iMjC = (jMode - 1)*3 + jCnt;
-
-					Inv10jaPjTmp.PutVec(jCnt, oInv10.GetVec(iMjC)*aP_jMode);
+					for (int c = 0; c < 3; c++) {
+						pY[3*(r - 1) + c] = ya[c];
+						Inv9jkajak(r, c + 1) += pa[jModem1]*ya[c];
+						Inv9jkajaPk(r, c + 1) += pa[jModem1]*yb[c];
+					}
 				}
-
-
-				Inv10jaPj += Inv10jaPjTmp;
 			}
 		}
-	} /* fine ciclo sui modi */
+	}
+
+	Mat3x3 Inv10jaPj(::Zero3x3);
+	if (oInv10.iGetNumCols()) {
+		Inv10jaPj = ModalBlockSum(oInv10, b);
+	}
 
 #ifdef MODAL_USE_GRAVITY
 	/* forza di gravita' (decidere come inserire g) */
@@ -1124,14 +1363,10 @@ Modal::AssRes(SubVectorHandler& WorkVec,
 
 		Vec3 MTmp = S.Cross(vP) + J*wP + w.Cross(J*w);
 		if (oInv4.iGetNumCols()) {
-			Mat3xN Inv4Curr(NModes, 0);
-			Inv4Curr.LeftMult(R, oInv4);
-			MTmp += Inv4Curr*bPrime;
+			MTmp += R*(oInv4*bPrime);
 		}
 		if (oInv5.iGetNumCols()) {
-			Mat3xN Inv5jajCurr(NModes, 0);
-			Inv5jajCurr.LeftMult(R, Inv5jaj);
-			MTmp += Inv5jajCurr*bPrime;
+			MTmp += R*(Inv5jaj*bPrime);
 		}
 		if (oInv8.iGetNumCols()) {
 			Mat3x3 Tmp = Inv8jaPj;
@@ -1164,73 +1399,60 @@ Modal::AssRes(SubVectorHandler& WorkVec,
 			- Mat3x3(CGR_Rot::MatR, g)*wr);
 	}
 
-	/* forze modali */
-	for (unsigned int jMode = 1; jMode <= NModes; jMode++) {
-		unsigned int jOffset = (jMode - 1)*3 + 1;
-		doublereal d = - MaPP(jMode) - CaP(jMode) - Ka(jMode);
-
-		if (oInv3.iGetNumCols()) {
-			Vec3 Inv3j = oInv3.GetVec(jMode);
+	/*
+	 * forze modali; i contributi dei modi sono accumulati in fModal,
+	 * che contiene gia' K*a + C*b + M*bP, e assemblati alla fine
+	 */
+	doublereal *pf = fModal.pGetVec();
+	for (unsigned int jModem1 = 0; jModem1 < NModes; jModem1++) {
+		pf[jModem1] = -pf[jModem1];
+	}
 
-			d -= (R*Inv3j).Dot(vP);
+	if (oInv3.iGetNumCols()) {
+		/* -(R*Inv3j).Dot(vP) */
+		ModalMulTAdd(oInv3, RT*vP, -1., pf);
 
 #ifdef MODAL_USE_GRAVITY
-			/* forza di gravita': */
-			if (bGravity) {
-				WorkVec.IncCoef(iRigidOffset + NModes + jMode,
-						(R*Inv3j).Dot(GravityAcceleration));
-			}
-#endif /* MODAL_USE_GRAVITY */
+		/* forza di gravita': */
+		if (bGravity) {
+			ModalMulTAdd(oInv3, RT*GravityAcceleration, 1., pf);
 		}
+#endif /* MODAL_USE_GRAVITY */
+	}
 
-		if (oInv4.iGetNumCols()) {
-			Vec3 Inv4j = oInv4.GetVec(jMode);
-			if (oInv5.iGetNumCols()) {
-				Inv4j += Inv5jaj.GetVec(jMode);
-
-				d -= ((R*Inv5jaPj.GetVec(jMode)).Dot(w))*2.;
-			}
+	if (oInv4.iGetNumCols()) {
+		/* -(R*(Inv4j + Inv5jaj)).Dot(wP) - 2*(R*Inv5jaPj).Dot(w) */
+		Vec3 RTwP(RT*wP);
 
-			d -= (R*Inv4j).Dot(wP);
+		ModalMulTAdd(oInv4, RTwP, -1., pf);
+		if (oInv5.iGetNumCols()) {
+			ModalMulTAdd(Inv5jaj, RTwP, -1., pf);
+			ModalMulTAdd(Inv5jaPj, RTw, -2., pf);
 		}
+	}
 
-		if (oInv8.iGetNumCols() || oInv9.iGetNumCols() || oInv10.iGetNumCols()) {
-			Mat3x3 MTmp(::Zero3x3);
-
-			if (oInv8.iGetNumCols()) {
-				MTmp += oInv8.GetMat3x3(jOffset).Transpose();
-				if (oInv9.iGetNumCols()) {
-					for (unsigned int kModem1 = 0; kModem1 < NModes; kModem1++) {
-						doublereal a_kMode = a(kModem1 + 1);
-						integer kOffset = (jMode - 1)*3*NModes + kModem1*3 + 1;
+	/* w.Dot(R*((Inv8jT - Inv9jkak + Inv10j)*RTw)) */
+	if (oInv8.iGetNumCols()) {
+		ModalBlockQuadAdd(oInv8, RTw, 1., pf);
 
-						MTmp -= oInv9.GetMat3x3ScalarMult(kOffset, a_kMode);
-					}
+		if (oInv9.iGetNumCols()) {
+			for (unsigned int jModem1 = 0; jModem1 < NModes; jModem1++) {
+				const doublereal *pY = &Inv9jkak[9*jModem1];
+				doublereal d = 0.;
+
+				for (int r = 1; r <= 3; r++) {
+					d += RTw(r)*(pY[3*(r - 1)]*RTw(1)
+						+ pY[3*(r - 1) + 1]*RTw(2)
+						+ pY[3*(r - 1) + 2]*RTw(3));
 				}
-			}
 
-			if (oInv10.iGetNumCols()) {
-				MTmp += oInv10.GetMat3x3(jOffset);
+				pf[jModem1] -= d;
 			}
-
-			d += w.Dot(R*(MTmp*RTw));
 		}
+	}
 
-		WorkVec.IncCoef(iRigidOffset + NModes + jMode, d);
-
-#if 0
-		std::cerr << "(R*Inv3j).Dot(vP)=" << (R*Inv3j).Dot(vP)
-			<< std::endl
-			<< "(R*(Inv4j + VInv5jaj)).Dot(wP)="
-			<< (R*(Inv4j + VInv5jaj)).Dot(wP) << std::endl
-			<< "w.Dot(R*((Inv8jTranspose + Inv10j)*RTw))"
-			<< w.Dot(R*((Inv8jTranspose + Inv10j)*RTw)) << std::endl
-			<< " -(R*VInv5jaPj).Dot(w)*2."
-			<< -(R*VInv5jaPj).Dot(w)*2.<< std::endl
-			<< " -CaP.dGet(jMode)" << -CaP.dGet(jMode)<< std::endl
-			<< "-Ka.dGet(jMode) "
-			<< -CaP.dGet(jMode) - Ka.dGet(jMode) << std::endl;
-#endif
+	if (oInv10.iGetNumCols()) {
+		ModalBlockQuadAdd(oInv10, RTw, 1., pf);
 	}
 
 	/* equazioni per abbassare di grado il sistema */
@@ -1244,22 +1466,19 @@ Modal::AssRes(SubVectorHandler& WorkVec,
 		integer iReactionIndex = iRigidOffset + 2*NModes + 6*iStrNodem1;
 		integer iStrNodeIndex = iReactionIndex + 6*NStrNodes;
 
-		/* recupero le forme modali del nodo vincolato */
-		/* FIXME: what about using Blitz++ ? :) */
-		Mat3xN PHIt(NModes), PHIr(NModes);
-		for (unsigned int jMode = 1; jMode <= NModes; jMode++) {
-			integer iOffset = (jMode - 1)*NStrNodes + iStrNode;
-			PHIt.PutVec(jMode, oPHIt.GetVec(iOffset));
-			PHIr.PutVec(jMode, oPHIr.GetVec(iOffset));
-		}
+		/* forme modali del nodo vincolato */
+		const doublereal *pPHIt = &PHItNode[3*NModes*iStrNodem1];
+		const doublereal *pPHIr = &PHIrNode[3*NModes*iStrNodem1];
 
 		/*
 		 * aggiorno d1 e R con il contributo dovuto
 		 * alla flessibilita':
 		 * d1tot = R*[d1 + PHIt*a], R1tot = R*[I + (PHIr*a)/\]
 		 */
-		SND[iStrNodem1].d1tot = R*(SND[iStrNodem1].OffsetFEM + PHIt*a);
-		SND[iStrNodem1].R1tot = R*Mat3x3(1., PHIr*a);
+		SND[iStrNodem1].d1tot = R*(SND[iStrNodem1].OffsetFEM
+			+ ModalMult(pPHIt, NModes, a.pGetVec()));
+		SND[iStrNodem1].R1tot = R*Mat3x3(1.,
+			ModalMult(pPHIr, NModes, a.pGetVec()));
 
 		/* constraint reaction (force) */
 		SND[iStrNodem1].F = Vec3(XCurr,
@@ -1282,11 +1501,8 @@ Modal::AssRes(SubVectorHandler& WorkVec,
 		/* termine aggiuntivo dovuto alla deformabilita':
 		 * -PHItiT*RT*F */
 		Vec3 vtemp = RT*SND[iStrNodem1].F;
-		for (unsigned int jMode = 1; jMode <= NModes; jMode++) {
-			/* PHItTranspose(jMode) * vtemp */
-			WorkVec.DecCoef(iRigidOffset + NModes + jMode,
-					PHIt.GetVec(jMode)*vtemp);
-		}
+		ModalMulTAdd(pPHIt, pPHIt + NModes, pPHIt + 2*NModes, NModes,
+			vtemp, -1., pf);
 
 		/* Eq. d'equilibrio, nodo 2 */
 		WorkVec.Add(iStrNodeIndex + 1, SND[iStrNodem1].F);
@@ -1314,11 +1530,8 @@ Modal::AssRes(SubVectorHandler& WorkVec,
 
 		/* Contributo dovuto alla flessibilita' :-PHIrT*RtotT*M */
 		vtemp = RT*MTmp;
-		for (unsigned int jMode = 1; jMode <= NModes; jMode++) {
-			/* PHIrTranspose(jMode) * vtemp */
-			WorkVec.DecCoef(iRigidOffset + NModes + jMode,
-					PHIr.GetVec(jMode)*vtemp);
-		}
+		ModalMulTAdd(pPHIr, pPHIr + NModes, pPHIr + 2*NModes, NModes,
+			vtemp, -1., pf);
 
 		/* Modifica: divido le equazioni di vincolo per dCoef */
 		ASSERT(dCoef != 0.);
@@ -1326,6 +1539,10 @@ Modal::AssRes(SubVectorHandler& WorkVec,
 		WorkVec.Sub(iReactionIndex + 3 + 1, ThetaCurr/dCoef);
 	}
 
+	for (unsigned int jMode = 1; jMode <= NModes; jMode++) {
+		WorkVec.IncCoef(iRigidOffset + NModes + jMode, pf[jMode - 1]);
+	}
+
 #if 0
 	std::cerr << "###" << std::endl;
 	for (int i = 1; i <= WorkVec.iGetSize(); i++) {
@@ -2144,6 +2361,12 @@ Modal::SetValue(DataManager *pDM,
 	}
 }
 
+bool
+Modal::bIsOrderDependent(void) const
+{
+	return false;
+}
+
 #if 0
 /* Aggiorna dati durante l'iterazione fittizia iniziale */
 void
@@ -3115,6 +3338,7 @@ ReadModal(DataManager* pDM,
 
 	/* stuff for binary FEM file handling */
 	std::string	sBinFileFEM;
+	std::shared_ptr<const ModalBinImage> pBinImage;
 	struct stat	stFEM, stBIN;
 	bool		bReadFEM = true,
 			bWriteBIN = false,
@@ -3161,8 +3385,27 @@ ReadModal(DataManager* pDM,
 	}
 
 	if (bUseBinary && bCheckBIN) {
-		/* if timestamp of binary is later than of ASCII use binary */
-		if (stBIN.st_mtime > stFEM.st_mtime) {
+		bool bCurrent;
+
+		/* the image is shared by all elements using the same file */
+		pBinImage = ModalBinImage::Get(sBinFileFEM, stBIN);
+		if (pBinImage->bHasHeader()) {
+			/* use binary if generated from this very ASCII file */
+			bCurrent = pBinImage->bMatches(stFEM);
+			if (bCurrent && !pBinImage->bChecksumOK()) {
+				silent_cerr("Modal(" << uLabel << "): "
+						"warning, binary database file \"" << sBinFileFEM << "\" "
+						"checksum mismatch"
+						<< std::endl);
+				bCurrent = false;
+			}
+
+		} else {
+			/* if timestamp of binary is later than of ASCII use binary */
+			bCurrent = (stBIN.st_mtime > stFEM.st_mtime);
+		}
+
+		if (bCurrent) {
 			bReadFEM = false;
 
 		/* otherwise, if requested, update binary */
@@ -3172,14 +3415,14 @@ ReadModal(DataManager* pDM,
 
 				silent_cout("Modal(" << uLabel << "): "
 						"binary database file \"" << sBinFileFEM << "\" "
-						"older than text database file \"" << sFileFEM << "\"; "
+						"out of date with respect to text database file \"" << sFileFEM << "\"; "
 						"updating"
 						<< std::endl);
 
 			} else {
 				silent_cerr("Modal(" << uLabel << "): "
 						"warning, binary database file \"" << sBinFileFEM << "\" "
-						"older than text database file \"" << sFileFEM << "\"; "
+						"out of date with respect to text database file \"" << sFileFEM << "\"; "
 						"using text database file "
 						"(enable \"update binary\" to refresh binary database file)"
 						<< std::endl);
@@ -3220,12 +3463,13 @@ ReadModal(DataManager* pDM,
 		MODAL_VERSION_4 = 4, // after making sizes portable
 		MODAL_VERSION_5 = 5, // after adding Inv3, Inv4 and Inv8 from modal element data for AVL-EXCITE (https://www.avl.com/excite)
                 MODAL_VERSION_6 = 6, // after adding record 19
+		MODAL_VERSION_7 = 7, // after adding the header page (see modalbin.h)
 		MODAL_VERSION_LAST
 	};
 
 	/* NOTE: increment this each time the binary format changes! */
 	const char	magic[5] = "bmod";
-	const uint32_t	BinVersion = MODAL_VERSION_6;
+	const uint32_t	BinVersion = MODAL_VERSION_7;
 
 	uint32_t	currBinVersion = MODAL_VERSION_UNKNOWN;
 	char		checkPoint;
@@ -3292,22 +3536,18 @@ ReadModal(DataManager* pDM,
 			throw DataManager::ErrGeneric(MBDYN_EXCEPT_ARGS);
 		}
 
-		/* don't leave behind a corrupted .bin file */
-		try {
-
-		std::ofstream fbin;
+		/* the .bin file is written to a temporary file,
+		 * which is removed if create/update fails */
+		ModalBinWriter fbin;
 		if (bWriteBIN) {
-			fbin.open(sBinFileFEM.c_str(), std::ios::binary | std::ios::trunc);
+			currBinVersion = BinVersion;
+			fbin.open(sBinFileFEM, currBinVersion, stFEM);
 			if (!fbin) {
 				silent_cerr("Modal(" << uLabel << "): "
 					"unable to open file \"" << sBinFileFEM << "\""
 					"at line " << HP.GetLineData() << std::endl);
 				throw DataManager::ErrGeneric(MBDYN_EXCEPT_ARGS);
 			}
-
-			fbin.write(&magic[0], sizeof(4));
-			currBinVersion = BinVersion;
-			fbin.write((const char *)&currBinVersion, sizeof(currBinVersion));
 		}
 
 		/* carica i dati relativi a coordinate nodali, massa, momenti statici
@@ -4375,20 +4615,10 @@ ReadModal(DataManager* pDM,
 			fbin.close();
 		}
 
-		/* unlink binary file if create/update failed */
-		} catch (...) {
-			if (bWriteBIN) {
-				// NOTE: might be worth leaving in place
-				// for debugging purposes
-				(void)unlink(sBinFileFEM.c_str());
-			}
-			throw;
-		}
-
 		fname = sFileFEM;
 
 	} else {
-		std::ifstream fbin(sBinFileFEM.c_str(), std::ios::binary);
+		ModalBinReader fbin(pBinImage);
 		if (!fbin) {
 			silent_cerr("Modal(" << uLabel << "): "
 				"unable to open file \"" << sBinFileFEM << "\""
@@ -4422,6 +4652,8 @@ ReadModal(DataManager* pDM,
 		//	- record 13, generalized damping matrix
 		// 4: December 2012; incompatible with previous ones
 		//	- bin file portable (fixed size types, magic signature)
+		// 7: header page with payload checksum and identity
+		//	of the ASCII file; the records follow the header page
 		char currMagic[5] = { 0 };
 		fbin.read((char *)&currMagic, sizeof(4));
 		if (memcmp(magic, currMagic, 4) != 0) {
@@ -4448,6 +4680,10 @@ ReadModal(DataManager* pDM,
 		pedantic_cout("Modal(" << uLabel << "): "
 			"binary version " << currBinVersion << std::endl);
 
+		if (currBinVersion >= MODAL_VERSION_7) {
+			fbin.SeekPayload();
+		}
+
 		// NOTE: the binary file is expected to be in order;
 		// however, if generated from a non-ordered textual file
 		// it will be out of order...  perhaps also the textual
@@ -48,6 +48,7 @@
 
 #include <array>
 #include <fstream>
+#include <memory>
 #include <joint.h>
 
 #if 0
@@ -79,8 +80,22 @@ protected:
 	const unsigned int NStrNodes;
 
 	const unsigned int NFEMNodes; // number of FEM nodes, common
-	const std::vector<std::string> IdFEMNodes; // ID of FEM nodes, common
-	const Mat3xN oXYZFEMNodes; // local position of FEM nodes, common
+
+	/* FEM node data, shared by all the modal elements
+	 * that read the same data, e.g. from the same database */
+	struct FEMData {
+		std::vector<std::string> IdFEMNodes;
+		Mat3xN oXYZFEMNodes;
+		Mat3xN oModeShapest;
+		Mat3xN oModeShapesr;
+	};
+	const std::shared_ptr<const FEMData> pFEMData;
+	static std::shared_ptr<const FEMData>
+	ShareFEMData(std::vector<std::string>&& IdFEMNodes, Mat3xN&& oXYZFEMNodes,
+		Mat3xN&& oModeShapest, Mat3xN&& oModeShapesr);
+
+	const std::vector<std::string>& IdFEMNodes; // ID of FEM nodes, common
+	const Mat3xN& oXYZFEMNodes; // local position of FEM nodes, common
 	const doublereal dMass; // mass, common
 	const Vec3 Inv2; // undeformed static moment, common
 	const Mat3x3 Inv7; // undeformed inertia moment, common
@@ -92,8 +107,8 @@ protected:
 	const Mat3xN oPHIt;
 	const Mat3xN oPHIr;
    
-	const Mat3xN oModeShapest;
-	const Mat3xN oModeShapesr;
+	const Mat3xN& oModeShapest;
+	const Mat3xN& oModeShapesr;
 
 	Mat3xN oCurrXYZ;
 	Mat3xN oCurrXYZVel;
@@ -123,6 +138,16 @@ protected:
 	VecN b;
 	VecN bPrime;
 
+	/* mode shapes at the interface nodes, node by node;
+	 * each node holds a row-major 3 x NModes block */
+	std::vector<doublereal> PHItNode;
+	std::vector<doublereal> PHIrNode;
+
+	/* AssRes() workspace */
+	VecN fModal;				/* modal forces */
+	std::vector<doublereal> abModal;	/* [a b], then Inv5*[a b] */
+	std::vector<doublereal> Inv9jkak;	/* sum_k Inv9jk*a_k, 3x3 by rows */
+
 public:
         template <unsigned N>
         class StressStiffIndex {
@@ -324,6 +349,9 @@ public:
 		const VectorHandler& XP);
 #endif
 
+	/* it has no per-step passes of its own */
+	virtual bool bIsOrderDependent(void) const;
+
 	/* Dati privati */
 	virtual unsigned int iGetNumPrivData(void) const;
 	virtual unsigned int iGetPrivDataIdx(const char *s) const;
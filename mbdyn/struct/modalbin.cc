@@ -0,0 +1,426 @@
+/* $Header$ */
+/*
+ * MBDyn (C) is a multibody analysis code.
+ * http://www.mbdyn.org
+ *
+ * Copyright (C) 1996-2023
+ *
+ * Pierangelo Masarati	<pierangelo.masarati@polimi.it>
+ * Paolo Mantegazza	<paolo.mantegazza@polimi.it>
+ *
+ * Dipartimento di Ingegneria Aerospaziale - Politecnico di Milano
+ * via La Masa, 34 - 20156 Milano, Italy
+ * http://www.aero.polimi.it
+ *
+ * Changing this copyright notice is forbidden.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation (version 2 of the License).
+ *
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* binary FEM database of the modal element */
+
+#include "mbconfig.h"           /* This goes first in every *.c,*.cc file */
+
+#include <cerrno>
+#include <cstring>
+#include <cstdio>
+#include <map>
+#include <sstream>
+#include <fcntl.h>
+#include <unistd.h>
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif /* HAVE_SYS_MMAN_H */
+
+#include "mbdyn.h"
+#include "myassert.h"
+#include "except.h"
+#include "modalbin.h"
+
+uint64_t
+ModalBinChecksum(uint64_t h, const char *p, size_t n)
+{
+	const unsigned char *pu = (const unsigned char *)p;
+	for (size_t i = 0; i < n; i++) {
+		h ^= pu[i];
+		h *= 0x100000001b3ULL;
+	}
+
+	return h;
+}
+
+static size_t
+ModalBinPageSize(void)
+{
+	size_t uPage = 4096;
+#ifdef _SC_PAGESIZE
+	long l = sysconf(_SC_PAGESIZE);
+	if (l > 0 && size_t(l) > uPage) {
+		uPage = size_t(l);
+	}
+#endif /* _SC_PAGESIZE */
+	return uPage;
+}
+
+/* ModalBinWriter - begin */
+
+ModalBinWriter::ModalBinWriter(void)
+: bOpen(false)
+{
+	memset(&Hdr, 0, sizeof(Hdr));
+}
+
+ModalBinWriter::~ModalBinWriter(void)
+{
+	if (bOpen) {
+		/* don't leave behind a corrupted file */
+		out.close();
+		(void)unlink(sTmpFileName.c_str());
+	}
+}
+
+void
+ModalBinWriter::open(const std::string& sFileName, uint32_t uVersion,
+	const struct stat& stSrc)
+{
+	ASSERT(!bOpen);
+
+	this->sFileName = sFileName;
+
+	std::ostringstream os;
+	os << sFileName << ".tmp." << getpid();
+	sTmpFileName = os.str();
+
+	out.open(sTmpFileName.c_str(), std::ios::binary | std::ios::trunc);
+	if (!out) {
+		return;
+	}
+	bOpen = true;
+
+	memcpy(Hdr.magic, "bmod", sizeof(Hdr.magic));
+	Hdr.uVersion = uVersion;
+	Hdr.uPayloadOffset = ModalBinPageSize();
+	Hdr.uChecksum = MODALBIN_CHECKSUM_INIT;
+	Hdr.uSrcSize = stSrc.st_size;
+	Hdr.iSrcMTime = stSrc.st_mtime;
+
+	/* reserve the header page; filled by close() */
+	std::vector<char> page(Hdr.uPayloadOffset, 0);
+	out.write(&page[0], page.size());
+}
+
+bool
+ModalBinWriter::operator ! (void) const
+{
+	return !bOpen || !out;
+}
+
+ModalBinWriter&
+ModalBinWriter::write(const char *p, size_t n)
+{
+	out.write(p, n);
+	Hdr.uChecksum = ModalBinChecksum(Hdr.uChecksum, p, n);
+	Hdr.uPayloadSize += n;
+
+	return *this;
+}
+
+void
+ModalBinWriter::close(void)
+{
+	ASSERT(bOpen);
+
+	out.seekp(0);
+	out.write((const char *)&Hdr, sizeof(Hdr));
+	out.close();
+	if (!out) {
+		silent_cerr("unable to write file \"" << sTmpFileName << "\""
+			<< std::endl);
+		throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+	}
+
+	if (rename(sTmpFileName.c_str(), sFileName.c_str()) == -1) {
+		int save_errno = errno;
+		silent_cerr("unable to rename \"" << sTmpFileName << "\" "
+			"as \"" << sFileName << "\" "
+			"(" << save_errno << ": " << strerror(save_errno) << ")"
+			<< std::endl);
+		throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+	}
+
+	bOpen = false;
+}
+
+/* ModalBinWriter - end */
+
+/* ModalBinImage - begin */
+
+ModalBinImage::ModalBinImage(const std::string& sFileName, const struct stat& st)
+: sFileName(sFileName),
+dev(st.st_dev), ino(st.st_ino), size(st.st_size), mtime(st.st_mtime),
+pData(0), uSize(0), bMapped(false),
+uVersion(0),
+iChecksumOK(-1)
+{
+	memset(&Hdr, 0, sizeof(Hdr));
+
+	int fd = ::open(sFileName.c_str(), O_RDONLY);
+	if (fd == -1) {
+		int save_errno = errno;
+		silent_cerr("unable to open file \"" << sFileName << "\" "
+			"(" << save_errno << ": " << strerror(save_errno) << ")"
+			<< std::endl);
+		throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+	}
+
+	uSize = st.st_size;
+
+#ifdef HAVE_SYS_MMAN_H
+	if (uSize > 0) {
+		void *p = mmap(0, uSize, PROT_READ, MAP_SHARED, fd, 0);
+		if (p != MAP_FAILED) {
+			pData = (const char *)p;
+			bMapped = true;
+		}
+	}
+#endif /* HAVE_SYS_MMAN_H */
+
+	if (!bMapped && uSize > 0) {
+		/* no mmap(2): read the whole file */
+		Buf.resize(uSize);
+		size_t uRead = 0;
+		while (uRead < uSize) {
+			ssize_t rc = ::read(fd, &Buf[uRead], uSize - uRead);
+			if (rc <= 0) {
+				if (rc == -1 && errno == EINTR) {
+					continue;
+				}
+				break;
+			}
+			uRead += rc;
+		}
+		uSize = uRead;
+		pData = &Buf[0];
+	}
+
+	(void)::close(fd);
+
+	if (uSize >= sizeof(Hdr)) {
+		memcpy(&Hdr, pData, sizeof(Hdr));
+		if (memcmp(Hdr.magic, "bmod", sizeof(Hdr.magic)) == 0
+			&& Hdr.uVersion >= MODALBIN_HEADER_VERSION)
+		{
+			uVersion = Hdr.uVersion;
+		}
+	}
+}
+
+ModalBinImage::~ModalBinImage(void)
+{
+#ifdef HAVE_SYS_MMAN_H
+	if (bMapped) {
+		(void)munmap((void *)pData, uSize);
+	}
+#endif /* HAVE_SYS_MMAN_H */
+}
+
+bool
+ModalBinImage::bIsIntact(void) const
+{
+	return bHasHeader()
+		&& Hdr.uPayloadOffset >= sizeof(Hdr)
+		&& Hdr.uPayloadOffset <= uSize
+		&& Hdr.uPayloadSize == uSize - Hdr.uPayloadOffset;
+}
+
+bool
+ModalBinImage::bIsSame(const struct stat& st) const
+{
+	return dev == st.st_dev && ino == st.st_ino
+		&& size == st.st_size && mtime == st.st_mtime;
+}
+
+bool
+ModalBinImage::bIsSame(const Entry& e) const
+{
+	return dev == e.dev && ino == e.ino
+		&& size == e.size && mtime == e.mtime;
+}
+
+ModalBinImage::ImageMap&
+ModalBinImage::Images(void)
+{
+	static ImageMap M;
+
+	return M;
+}
+
+std::shared_ptr<const ModalBinImage>
+ModalBinImage::Get(const std::string& sFileName, const struct stat& st)
+{
+	ImageMap& M = Images();
+
+	ImageMap::iterator i = M.find(sFileName);
+	if (i != M.end()) {
+		std::shared_ptr<const ModalBinImage> pImg(i->second.pImg.lock());
+		if (pImg && pImg->bIsSame(st)) {
+			return pImg;
+		}
+	}
+
+	std::shared_ptr<ModalBinImage> pImg(new ModalBinImage(sFileName, st));
+
+	Entry& e = M[sFileName];
+	if (i != M.end() && pImg->bIsSame(e)) {
+		/* same file, verified by a previous image */
+		pImg->iChecksumOK = e.iChecksumOK;
+
+	} else {
+		e.dev = st.st_dev;
+		e.ino = st.st_ino;
+		e.size = st.st_size;
+		e.mtime = st.st_mtime;
+		e.iChecksumOK = -1;
+	}
+	e.pImg = pImg;
+
+	return pImg;
+}
+
+const std::string&
+ModalBinImage::sGetFileName(void) const
+{
+	return sFileName;
+}
+
+const char *
+ModalBinImage::pGetData(void) const
+{
+	return pData;
+}
+
+size_t
+ModalBinImage::uGetSize(void) const
+{
+	return uSize;
+}
+
+bool
+ModalBinImage::bHasHeader(void) const
+{
+	return uVersion != 0;
+}
+
+size_t
+ModalBinImage::uGetPayloadOffset(void) const
+{
+	return bHasHeader() ? Hdr.uPayloadOffset : 0;
+}
+
+bool
+ModalBinImage::bMatches(const struct stat& stSrc) const
+{
+	return bIsIntact()
+		&& Hdr.uSrcSize == uint64_t(stSrc.st_size)
+		&& Hdr.iSrcMTime == int64_t(stSrc.st_mtime);
+}
+
+bool
+ModalBinImage::bChecksumOK(void) const
+{
+	if (!bIsIntact()) {
+		return false;
+	}
+
+	if (iChecksumOK == -1) {
+		uint64_t h = ModalBinChecksum(MODALBIN_CHECKSUM_INIT,
+			pData + Hdr.uPayloadOffset, Hdr.uPayloadSize);
+		iChecksumOK = (h == Hdr.uChecksum);
+
+		ImageMap::iterator i = Images().find(sFileName);
+		if (i != Images().end() && bIsSame(i->second)) {
+			i->second.iChecksumOK = iChecksumOK;
+		}
+	}
+
+	return iChecksumOK;
+}
+
+void
+ModalBinImage::Release(void) const
+{
+#if defined(HAVE_SYS_MMAN_H) && defined(MADV_DONTNEED)
+	if (bMapped) {
+		(void)madvise((void *)pData, uSize, MADV_DONTNEED);
+	}
+#endif /* HAVE_SYS_MMAN_H && MADV_DONTNEED */
+}
+
+/* ModalBinImage - end */
+
+/* ModalBinReader - begin */
+
+ModalBinReader::ModalBinReader(const std::shared_ptr<const ModalBinImage>& pImg)
+: pImg(pImg), uPos(0)
+{
+	NO_OP;
+}
+
+ModalBinReader::~ModalBinReader(void)
+{
+	NO_OP;
+}
+
+bool
+ModalBinReader::operator ! (void) const
+{
+	return !pImg;
+}
+
+ModalBinReader&
+ModalBinReader::read(char *p, size_t n)
+{
+	ASSERT(pImg);
+
+	if (n > pImg->uGetSize() - uPos) {
+		silent_cerr("file \"" << pImg->sGetFileName() << "\" "
+			"looks broken (unexpected end of file)" << std::endl);
+		throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+	}
+
+	memcpy(p, pImg->pGetData() + uPos, n);
+	uPos += n;
+
+	return *this;
+}
+
+void
+ModalBinReader::SeekPayload(void)
+{
+	ASSERT(pImg);
+
+	uPos = pImg->uGetPayloadOffset();
+}
+
+void
+ModalBinReader::close(void)
+{
+	if (pImg) {
+		pImg->Release();
+		pImg.reset();
+	}
+}
+
+/* ModalBinReader - end */
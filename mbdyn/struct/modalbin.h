@@ -0,0 +1,201 @@
+/* $Header$ */
+/*
+ * MBDyn (C) is a multibody analysis code.
+ * http://www.mbdyn.org
+ *
+ * Copyright (C) 1996-2023
+ *
+ * Pierangelo Masarati	<pierangelo.masarati@polimi.it>
+ * Paolo Mantegazza	<paolo.mantegazza@polimi.it>
+ *
+ * Dipartimento di Ingegneria Aerospaziale - Politecnico di Milano
+ * via La Masa, 34 - 20156 Milano, Italy
+ * http://www.aero.polimi.it
+ *
+ * Changing this copyright notice is forbidden.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation (version 2 of the License).
+ *
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* binary FEM database of the modal element */
+
+#ifndef MODALBIN_H
+#define MODALBIN_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <fstream>
+#include <memory>
+#include <stdint.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+/*
+ * Starting with version 7, the binary database consists of a header page
+ * followed by the record stream (the payload).  The first 8 bytes
+ * of the header (signature and version) are laid out as in previous
+ * versions.  The header records the size and the checksum of the payload,
+ * and the size and modification time of the textual database the file
+ * was generated from; the latter, rather than the timestamp of the binary
+ * file, is used to decide whether the binary file is up to date.
+ *
+ * The file is written to a temporary file and renamed into place only
+ * when complete, so concurrent processes never see a partial database;
+ * it is read through a read-only shared mapping, which is shared among
+ * all the modal elements that use the same database.
+ */
+
+struct ModalBinHeader {
+	char		magic[4];
+	uint32_t	uVersion;
+	uint32_t	uPayloadOffset;
+	uint32_t	uReserved;
+	uint64_t	uPayloadSize;
+	uint64_t	uChecksum;
+	uint64_t	uSrcSize;
+	int64_t		iSrcMTime;
+};
+
+/* first version with the header page */
+const uint32_t MODALBIN_HEADER_VERSION = 7;
+
+/* 64 bit FNV-1a hash, used as payload checksum */
+const uint64_t MODALBIN_CHECKSUM_INIT = 0xcbf29ce484222325ULL;
+extern uint64_t ModalBinChecksum(uint64_t h, const char *p, size_t n);
+
+/* ModalBinWriter - begin */
+
+class ModalBinWriter {
+private:
+	std::string sFileName;
+	std::string sTmpFileName;
+	std::ofstream out;
+	ModalBinHeader Hdr;
+	bool bOpen;
+
+public:
+	ModalBinWriter(void);
+	~ModalBinWriter(void);
+
+	/* opens a temporary file next to sFileName and reserves the header */
+	void open(const std::string& sFileName, uint32_t uVersion,
+		const struct stat& stSrc);
+	bool operator ! (void) const;
+
+	ModalBinWriter& write(const char *p, size_t n);
+
+	/* completes the header and renames the file into place;
+	 * if not called, the temporary file is removed on destruction */
+	void close(void);
+};
+
+/* ModalBinWriter - end */
+
+/* ModalBinImage - begin */
+
+class ModalBinImage {
+private:
+	std::string sFileName;
+
+	/* identity of the binary file */
+	dev_t dev;
+	ino_t ino;
+	off_t size;
+	time_t mtime;
+
+	const char *pData;
+	size_t uSize;
+	bool bMapped;
+	std::vector<char> Buf;
+
+	/* zero if the file has no header page (version < 7) */
+	uint32_t uVersion;
+	ModalBinHeader Hdr;
+
+	mutable int iChecksumOK;
+
+	/* the registry does not own the images: a file is unmapped
+	 * when the last element reading it releases its image;
+	 * the outcome of the checksum outlives the image */
+	struct Entry {
+		std::weak_ptr<const ModalBinImage> pImg;
+		dev_t dev;
+		ino_t ino;
+		off_t size;
+		time_t mtime;
+		int iChecksumOK;
+	};
+	typedef std::map<std::string, Entry> ImageMap;
+	static ImageMap& Images(void);
+
+	ModalBinImage(const std::string& sFileName, const struct stat& st);
+
+	bool bIsSame(const struct stat& st) const;
+	bool bIsSame(const Entry& e) const;
+	bool bIsIntact(void) const;
+
+public:
+	~ModalBinImage(void);
+
+	/* returns the image of the file, shared with the other users
+	 * of the same file as long as any of them holds it */
+	static std::shared_ptr<const ModalBinImage>
+	Get(const std::string& sFileName, const struct stat& st);
+
+	const std::string& sGetFileName(void) const;
+	const char *pGetData(void) const;
+	size_t uGetSize(void) const;
+
+	bool bHasHeader(void) const;
+	size_t uGetPayloadOffset(void) const;
+
+	/* true if generated from a file with the same size and mtime */
+	bool bMatches(const struct stat& stSrc) const;
+
+	/* true if the payload checksum matches (computed only once) */
+	bool bChecksumOK(void) const;
+
+	/* hints the kernel that the pages are no longer needed */
+	void Release(void) const;
+};
+
+/* ModalBinImage - end */
+
+/* ModalBinReader - begin */
+
+class ModalBinReader {
+private:
+	std::shared_ptr<const ModalBinImage> pImg;
+	size_t uPos;
+
+public:
+	ModalBinReader(const std::shared_ptr<const ModalBinImage>& pImg);
+	~ModalBinReader(void);
+
+	bool operator ! (void) const;
+
+	/* throws if reading past the end of the file */
+	ModalBinReader& read(char *p, size_t n);
+
+	/* moves to the beginning of the record stream */
+	void SeekPayload(void);
+
+	void close(void);
+};
+
+/* ModalBinReader - end */
+
+#endif /* MODALBIN_H */
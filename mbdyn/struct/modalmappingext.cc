@@ -31,11 +31,18 @@
 
 #include "mbconfig.h"           /* This goes first in every *.c,*.cc file */
 
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <sys/stat.h>
+
 #include "dataman.h"
 #include "extedge.h"
 #include "extsocket.h"
 #include "modaledge.h"
 #include "modalmappingext.h"
+#include "modalbin.h"
+#include "spmapmh.h"
 
 /* ModalMappingExt - begin */
 
@@ -44,7 +51,7 @@ ModalMappingExt::ModalMappingExt(unsigned int uL,
 	DataManager *pDM,
 	const StructNode *pRefNode,
 	std::vector<const StructNode *>& n,
-	SpMapMatrixHandler *pH,
+	CSRMatrix *pH,
 	bool bOutputAccelerations,
 	ExtFileHandlerBase *pEFH,
 	ExtModalForceBase* pEMF,
@@ -399,39 +406,11 @@ ModalMappingExt::GetConnectedNodes(std::vector<const Node *>& connectedNodes) co
 	}
 }
 
-SpMapMatrixHandler *
-ReadSparseMappingMatrix(MBDynParser& HP, integer& nRows, integer& nCols)
+/* reads the mapping matrix from a textual file */
+static SpMapMatrixHandler *
+ReadMappingFile(MBDynParser& HP, const char *sFileName, bool bSparse,
+	doublereal dThreshold, integer& nRows, integer& nCols)
 {
-	bool bSparse;
-	if (HP.IsKeyWord("full" "mapping" "file")) {
-		bSparse = false;
-
-	} else if (HP.IsKeyWord("sparse" "mapping" "file")) {
-		bSparse = true;
-
-	} else {
-		silent_cerr("mapping file expected "
-			"at line " << HP.GetLineData() << std::endl);
-		throw ErrGeneric(MBDYN_EXCEPT_ARGS);
-	}
-
-	doublereal dThreshold = 0.;
-	if (HP.IsKeyWord("threshold")) {
-		dThreshold = HP.GetReal();
-		if (dThreshold < 0.) {
-			silent_cerr("invalid threshold " << dThreshold
-				<< " at line " << HP.GetLineData() << std::endl);
-			throw ErrGeneric(MBDYN_EXCEPT_ARGS);
-		}
-	}
-	
-	const char *sFileName = HP.GetFileName();
-	if (sFileName == 0) {
-		silent_cerr("unable to read mapping file name "
-			"at line " << HP.GetLineData() << std::endl);
-		throw ErrGeneric(MBDYN_EXCEPT_ARGS);
-	}
-
 	std::ifstream in(sFileName);
 	if (!in) {
 		silent_cerr("unable to open mapping file "
@@ -581,6 +560,266 @@ ReadSparseMappingMatrix(MBDynParser& HP, integer& nRows, integer& nCols)
 	return pH;
 }
 
+/*
+ * payload of the binary version of a mapping file; the matrix is stored
+ * in compressed row form after applying the threshold, and the file
+ * is used only if generated from the same textual file with the same
+ * threshold and size
+ */
+static const char MAPPINGBIN_TAG[4] = { 'b', 'm', 'a', 'p' };
+static const uint32_t MAPPINGBIN_VERSION = 1;
+
+struct MappingBinHeader {
+	char tag[4];
+	uint32_t uVersion;
+	uint32_t uSparse;
+	uint32_t uReserved;
+	doublereal dThreshold;
+	int64_t iNumRows;
+	int64_t iNumCols;
+	int64_t iNz;
+};
+
+static bool
+ReadMappingBin(const std::shared_ptr<const ModalBinImage>& pBinImage,
+	bool bSparse, doublereal dThreshold, integer& nRows, integer& nCols,
+	CSRMatrix *pH)
+{
+	ModalBinReader fbin(pBinImage);
+	fbin.SeekPayload();
+
+	MappingBinHeader Hdr;
+	fbin.read((char *)&Hdr, sizeof(Hdr));
+	if (memcmp(Hdr.tag, MAPPINGBIN_TAG, sizeof(Hdr.tag)) != 0
+		|| Hdr.uVersion != MAPPINGBIN_VERSION
+		|| Hdr.uSparse != uint32_t(bSparse)
+		|| Hdr.dThreshold != dThreshold
+		|| (nRows >= 0 && Hdr.iNumRows != nRows)
+		|| (nCols >= 0 && Hdr.iNumCols != nCols)
+		|| Hdr.iNz < 0 || Hdr.iNz > std::numeric_limits<int32_t>::max())
+	{
+		return false;
+	}
+
+	std::vector<int32_t> Ap(Hdr.iNumRows + 1), Ai(Hdr.iNz);
+	std::vector<doublereal> Ax(Hdr.iNz);
+	fbin.read((char *)&Ap[0], sizeof(int32_t)*Ap.size());
+	if (Hdr.iNz > 0) {
+		fbin.read((char *)&Ai[0], sizeof(int32_t)*Ai.size());
+		fbin.read((char *)&Ax[0], sizeof(doublereal)*Ax.size());
+	}
+	fbin.close();
+
+	if (Ap[0] != 0 || Ap[Hdr.iNumRows] != Hdr.iNz) {
+		return false;
+	}
+
+	for (int64_t r = 0; r < Hdr.iNumRows; r++) {
+		if (Ap[r + 1] < Ap[r]) {
+			return false;
+		}
+	}
+
+	for (int64_t k = 0; k < Hdr.iNz; k++) {
+		if (Ai[k] < 0 || Ai[k] >= Hdr.iNumCols) {
+			return false;
+		}
+	}
+
+	nRows = Hdr.iNumRows;
+	nCols = Hdr.iNumCols;
+	pH->Set(nRows, nCols, Ap, Ai, Ax);
+
+	return true;
+}
+
+static void
+WriteMappingBin(const std::string& sBinFileName, const struct stat& stSrc,
+	bool bSparse, doublereal dThreshold, const CSRMatrix *pH)
+{
+	/* the .bin file is written to a temporary file,
+	 * which is removed if writing fails */
+	ModalBinWriter fbin;
+	fbin.open(sBinFileName, MODALBIN_HEADER_VERSION, stSrc);
+	if (!fbin) {
+		silent_cerr("ReadSparseMappingMatrix(\"" << sBinFileName << "\"): "
+			"warning, unable to open file for writing" << std::endl);
+		return;
+	}
+
+	MappingBinHeader Hdr;
+	memset(&Hdr, 0, sizeof(Hdr));
+	memcpy(Hdr.tag, MAPPINGBIN_TAG, sizeof(Hdr.tag));
+	Hdr.uVersion = MAPPINGBIN_VERSION;
+	Hdr.uSparse = bSparse;
+	Hdr.dThreshold = dThreshold;
+	Hdr.iNumRows = pH->iGetNumRows();
+	Hdr.iNumCols = pH->iGetNumCols();
+	Hdr.iNz = pH->Nz();
+
+	fbin.write((const char *)&Hdr, sizeof(Hdr));
+	fbin.write((const char *)&pH->GetRowPtr()[0], sizeof(int32_t)*pH->GetRowPtr().size());
+	if (Hdr.iNz > 0) {
+		fbin.write((const char *)&pH->GetColIdx()[0], sizeof(int32_t)*pH->GetColIdx().size());
+		fbin.write((const char *)&pH->GetValues()[0], sizeof(doublereal)*pH->GetValues().size());
+	}
+
+	if (!fbin) {
+		silent_cerr("ReadSparseMappingMatrix(\"" << sBinFileName << "\"): "
+			"warning, unable to write file" << std::endl);
+		return;
+	}
+
+	fbin.close();
+}
+
+CSRMatrix *
+ReadSparseMappingMatrix(MBDynParser& HP, integer& nRows, integer& nCols)
+{
+	bool bSparse;
+	if (HP.IsKeyWord("full" "mapping" "file")) {
+		bSparse = false;
+
+	} else if (HP.IsKeyWord("sparse" "mapping" "file")) {
+		bSparse = true;
+
+	} else {
+		silent_cerr("mapping file expected "
+			"at line " << HP.GetLineData() << std::endl);
+		throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+	}
+
+	doublereal dThreshold = 0.;
+	if (HP.IsKeyWord("threshold")) {
+		dThreshold = HP.GetReal();
+		if (dThreshold < 0.) {
+			silent_cerr("invalid threshold " << dThreshold
+				<< " at line " << HP.GetLineData() << std::endl);
+			throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+		}
+	}
+	
+	const char *sFileName = HP.GetFileName();
+	if (sFileName == 0) {
+		silent_cerr("unable to read mapping file name "
+			"at line " << HP.GetLineData() << std::endl);
+		throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+	}
+
+	std::string sFile(sFileName);
+
+	/* loop for binary keywords */
+	bool bCreateBinary = false;
+	bool bUseBinary = false;
+	bool bUpdateBinary = false;
+	while (true) {
+		if (HP.IsKeyWord("create" "binary")) {
+			bCreateBinary = true;
+
+		} else if (HP.IsKeyWord("use" "binary")) {
+			bUseBinary = true;
+
+		} else if (HP.IsKeyWord("update" "binary")) {
+			bUpdateBinary = true;
+
+		} else {
+			break;
+		}
+	}
+
+	unsigned uThreads = 0;
+	if (HP.IsKeyWord("threads")) {
+		int i = HP.GetInt();
+		if (i <= 0) {
+			silent_cerr("invalid threads number " << i
+				<< " at line " << HP.GetLineData() << std::endl);
+			throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+		}
+		uThreads = i;
+	}
+
+	CSRMatrix *pH = 0;
+
+	/* stuff for binary mapping file handling */
+	std::string sBinFile;
+	struct stat stFile, stBin;
+	bool bReadFile = true,
+		bWriteBin = false;
+
+	if (bUseBinary || bCreateBinary || bUpdateBinary) {
+		if (stat(sFile.c_str(), &stFile) == -1) {
+			int save_errno = errno;
+			silent_cerr("ReadSparseMappingMatrix(\"" << sFile << "\"): "
+				"unable to stat file "
+				"(" << save_errno << ": " << strerror(save_errno) << ")"
+				<< std::endl);
+			throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+		}
+
+		sBinFile = sFile + ".bin";
+
+		if (bUseBinary && stat(sBinFile.c_str(), &stBin) == 0) {
+			std::shared_ptr<const ModalBinImage> pBinImage = ModalBinImage::Get(sBinFile, stBin);
+
+			/* use binary if generated from this very file */
+			if (pBinImage->bHasHeader()
+				&& pBinImage->bMatches(stFile)
+				&& pBinImage->bChecksumOK())
+			{
+				SAFENEW(pH, CSRMatrix);
+				if (!ReadMappingBin(pBinImage, bSparse, dThreshold, nRows, nCols, pH)) {
+					SAFEDELETE(pH);
+					pH = 0;
+				}
+			}
+
+			if (pH != 0) {
+				bReadFile = false;
+
+				silent_cout("ReadSparseMappingMatrix(\"" << sFile << "\"): "
+					"using binary file \"" << sBinFile << "\" "
+					"(rows=" << nRows << " cols=" << nCols << " nonzeros=" << pH->Nz() << ")"
+					<< std::endl);
+
+			/* otherwise, if requested, update binary */
+			} else if (bUpdateBinary) {
+				bWriteBin = true;
+
+				silent_cout("ReadSparseMappingMatrix(\"" << sFile << "\"): "
+					"binary file \"" << sBinFile << "\" "
+					"out of date; updating" << std::endl);
+
+			} else {
+				silent_cerr("ReadSparseMappingMatrix(\"" << sFile << "\"): "
+					"warning, binary file \"" << sBinFile << "\" "
+					"out of date; using text file "
+					"(enable \"update binary\" to refresh binary file)"
+					<< std::endl);
+			}
+
+		} else if (bCreateBinary || bUpdateBinary) {
+			bWriteBin = true;
+		}
+	}
+
+	if (bReadFile) {
+		SpMapMatrixHandler *pM = ReadMappingFile(HP, sFile.c_str(),
+			bSparse, dThreshold, nRows, nCols);
+
+		/* the map is only used while reading */
+		SAFENEWWITHCONSTRUCTOR(pH, CSRMatrix, CSRMatrix(*pM));
+		SAFEDELETE(pM);
+
+		if (bWriteBin) {
+			WriteMappingBin(sBinFile, stFile, bSparse, dThreshold, pH);
+		}
+	}
+
+	pH->SetThreads(uThreads);
+
+	return pH;
+}
+
 Elem*
 ReadModalMappingExtForce(DataManager* pDM,
 	MBDynParser& HP,
@@ -715,7 +954,7 @@ ReadModalMappingExtForce(DataManager* pDM,
 	}
 
 	integer nCols = 6*nNodes;
-	SpMapMatrixHandler *pH = ReadSparseMappingMatrix(HP, nModes, nCols);
+	CSRMatrix *pH = ReadSparseMappingMatrix(HP, nModes, nCols);
 	ASSERT(nCols == 6*nNodes);
 
 	flag fOut = pDM->fReadOutput(HP, Elem::FORCE);
@@ -38,7 +38,7 @@
 #include <string>
 
 #include "modalext.h"
-#include "spmapmh.h"
+#include "csrmat.h"
 #include "stlvh.h"
 
 /* ModalMappingExt - begin */
@@ -54,7 +54,7 @@ protected:
 	const StructNode *pRefNode;
 
 	// Moore-Penrose Generalized Inverse of MSD nodes to modes mapping
-	SpMapMatrixHandler *pH;
+	CSRMatrix *pH;
 
 	// Mapped nodes data
 	struct NodeData {
@@ -90,7 +90,7 @@ public:
 		DataManager *pDM,
 		const StructNode *pRefNode,
 		std::vector<const StructNode *>& n,
-		SpMapMatrixHandler *pH,
+		CSRMatrix *pH,
 		bool bOutputAccelerations,
 		ExtFileHandlerBase *pEFH,
 		ExtModalForceBase *pEMF,
@@ -128,7 +128,7 @@ public:
 class DataManager;
 class MBDynParser;
 
-extern SpMapMatrixHandler *
+extern CSRMatrix *
 ReadSparseMappingMatrix(MBDynParser& HP, integer& nRows, integer& nCols);
 
 extern Elem*
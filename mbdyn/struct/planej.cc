@@ -499,6 +499,32 @@ PlaneHingeJoint::AfterConvergence(const VectorHandler& X,
 	}
 }
 
+std::ostream&
+PlaneHingeJoint::Checkpoint(std::ostream& out) const
+{
+	CheckpointPut(out, NTheta);
+	CheckpointPut(out, dTheta);
+	CheckpointPut(out, dThetaWrapped);
+	if (fc) {
+		fc->Checkpoint(out);
+	}
+
+	return out;
+}
+
+std::istream&
+PlaneHingeJoint::Resume(std::istream& in)
+{
+	CheckpointGet(in, NTheta);
+	CheckpointGet(in, dTheta);
+	CheckpointGet(in, dThetaWrapped);
+	if (fc) {
+		fc->Resume(in);
+	}
+
+	return in;
+}
+
 /* Funzione che legge lo stato iniziale dal file di input */
 void
 PlaneHingeJoint::ReadInitialState(MBDynParser& HP)
@@ -1813,6 +1839,26 @@ PlaneRotationJoint::AfterConvergence(const VectorHandler& X,
 	dTheta = 2*M_PI*NTheta + dThetaWrapped;
 }
 
+std::ostream&
+PlaneRotationJoint::Checkpoint(std::ostream& out) const
+{
+	CheckpointPut(out, NTheta);
+	CheckpointPut(out, dTheta);
+	CheckpointPut(out, dThetaWrapped);
+
+	return out;
+}
+
+std::istream&
+PlaneRotationJoint::Resume(std::istream& in)
+{
+	CheckpointGet(in, NTheta);
+	CheckpointGet(in, dTheta);
+	CheckpointGet(in, dThetaWrapped);
+
+	return in;
+}
+
 
 /* Contributo al file di restart */
 std::ostream& PlaneRotationJoint::Restart(std::ostream& out) const
@@ -3016,6 +3062,32 @@ AxialRotationJoint::AfterConvergence(const VectorHandler& X,
 	}
 }
 
+std::ostream&
+AxialRotationJoint::Checkpoint(std::ostream& out) const
+{
+	CheckpointPut(out, NTheta);
+	CheckpointPut(out, dTheta);
+	CheckpointPut(out, dThetaWrapped);
+	if (fc) {
+		fc->Checkpoint(out);
+	}
+
+	return out;
+}
+
+std::istream&
+AxialRotationJoint::Resume(std::istream& in)
+{
+	CheckpointGet(in, NTheta);
+	CheckpointGet(in, dTheta);
+	CheckpointGet(in, dThetaWrapped);
+	if (fc) {
+		fc->Resume(in);
+	}
+
+	return in;
+}
+
 
 /* Contributo al file di restart */
 std::ostream& AxialRotationJoint::Restart(std::ostream& out) const
@@ -4380,6 +4452,26 @@ PlanePinJoint::AfterConvergence(const VectorHandler& X,
 
 }
 
+std::ostream&
+PlanePinJoint::Checkpoint(std::ostream& out) const
+{
+	CheckpointPut(out, NTheta);
+	CheckpointPut(out, dTheta);
+	CheckpointPut(out, dThetaWrapped);
+
+	return out;
+}
+
+std::istream&
+PlanePinJoint::Resume(std::istream& in)
+{
+	CheckpointGet(in, NTheta);
+	CheckpointGet(in, dTheta);
+	CheckpointGet(in, dThetaWrapped);
+
+	return in;
+}
+
 void
 PlanePinJoint::ReadInitialState(MBDynParser& HP)
 {
@@ -139,6 +139,9 @@ class PlaneHingeJoint : virtual public Elem, public Joint {
    virtual void AfterConvergence(const VectorHandler& X, 
 			const VectorHandler& XP);
 
+   virtual std::ostream& Checkpoint(std::ostream& out) const;
+   virtual std::istream& Resume(std::istream& in);
+
    void WorkSpaceDim(integer* piNumRows, integer* piNumCols) const { 
       *piNumRows = NumDof;
       *piNumCols = NumDof;
@@ -284,6 +287,9 @@ class PlaneRotationJoint : virtual public Elem, public Joint {
 	virtual void AfterConvergence(const VectorHandler& X, 
 			const VectorHandler& XP);
 
+	virtual std::ostream& Checkpoint(std::ostream& out) const;
+	virtual std::istream& Resume(std::istream& in);
+
    void WorkSpaceDim(integer* piNumRows, integer* piNumCols) const { 
       *piNumRows = 3+3+2;
       *piNumCols = 3+3+2; 
@@ -458,6 +464,9 @@ public Joint, public DriveOwner {
 	virtual void AfterConvergence(const VectorHandler& X, 
 			const VectorHandler& XP);
 
+	virtual std::ostream& Checkpoint(std::ostream& out) const;
+	virtual std::istream& Resume(std::istream& in);
+
    void WorkSpaceDim(integer* piNumRows, integer* piNumCols) const { 
       *piNumRows = NumDof;
       *piNumCols = NumDof;
@@ -598,6 +607,9 @@ class PlanePinJoint : virtual public Elem, public Joint {
 	virtual void AfterConvergence(const VectorHandler& X, 
 			const VectorHandler& XP);
 
+	virtual std::ostream& Checkpoint(std::ostream& out) const;
+	virtual std::istream& Resume(std::istream& in);
+
    virtual void WorkSpaceDim(integer* piNumRows, integer* piNumCols) const { 
       *piNumRows = 11; 
       *piNumCols = 11;
@@ -278,6 +278,34 @@ ScrewJoint::AfterConvergence(const VectorHandler& X,
 	}
 }
 
+std::ostream&
+ScrewJoint::Checkpoint(std::ostream& out) const
+{
+	CheckpointPut(out, nTheta);
+	CheckpointPut(out, dThetaPrev);
+	CheckpointPut(out, dThetaCurr);
+	CheckpointPut(out, dTheta);
+	if (fc) {
+		fc->Checkpoint(out);
+	}
+
+	return out;
+}
+
+std::istream&
+ScrewJoint::Resume(std::istream& in)
+{
+	CheckpointGet(in, nTheta);
+	CheckpointGet(in, dThetaPrev);
+	CheckpointGet(in, dThetaCurr);
+	CheckpointGet(in, dTheta);
+	if (fc) {
+		fc->Resume(in);
+	}
+
+	return in;
+}
+
 // Hint * //TODO
 // ScrewJoint::ParseHint(DataManager *pDM, const char *s) const
 // {
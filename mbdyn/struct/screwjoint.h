@@ -126,6 +126,9 @@ public:
 	virtual void AfterConvergence(const VectorHandler& X, 
 		const VectorHandler& XP);
 
+	virtual std::ostream& Checkpoint(std::ostream& out) const;
+	virtual std::istream& Resume(std::istream& in);
+
 // 	virtual Hint *
 // 	ParseHint(DataManager *pDM, const char *s) const;
 	         
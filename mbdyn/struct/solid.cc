@@ -106,6 +106,64 @@ protected:
           pConstLaw->Update(eps, epsP, sigma);
      }
 
+     // Constitutive laws are virtual and evaluate SpGradient only:
+     // derivatives are computed with respect to the strains
+     // and mapped back to the element's dofs by the chain rule.
+     template <sp_grad::index_type N_SIZE>
+     void
+     UpdateElastic(const sp_grad::SpMatrix<sp_grad::SpDenseGradient<N_SIZE>, 3, 3>& G, sp_grad::SpColVector<sp_grad::SpDenseGradient<N_SIZE>, 6>& sigma) {
+          using namespace sp_grad;
+
+          ASSERT(pConstLaw.get() != nullptr);
+
+          const SpColVector<SpDenseGradient<N_SIZE>, 6> eps{G(1, 1), G(2, 2), G(3, 3), 2. * G(1, 2), 2. * G(2, 3), 2. * G(3, 1)};
+
+          SpColVector<SpGradient, 6> epsLocal(6, 1), sigmaLocal(6, 6);
+
+          for (index_type i = 1; i <= 6; ++i) {
+               epsLocal(i).Reset(eps(i).dGetValue(), i, 1.);
+          }
+
+          pConstLaw->Update(epsLocal, sigmaLocal);
+
+          for (index_type i = 1; i <= 6; ++i) {
+               sigma(i).Reset(sigmaLocal(i).dGetValue());
+
+               for (index_type j = 1; j <= 6; ++j) {
+                    eps(j).InsertDeriv(sigma(i), sigmaLocal(i).dGetDeriv(j));
+               }
+          }
+     }
+
+     template <sp_grad::index_type N_SIZE>
+     void
+     UpdateViscoElastic(const sp_grad::SpMatrix<sp_grad::SpDenseGradient<N_SIZE>, 3, 3>& G, const sp_grad::SpMatrix<sp_grad::SpDenseGradient<N_SIZE>, 3, 3>& GP, sp_grad::SpColVector<sp_grad::SpDenseGradient<N_SIZE>, 6>& sigma) {
+          using namespace sp_grad;
+
+          ASSERT(pConstLaw.get() != nullptr);
+
+          const SpColVector<SpDenseGradient<N_SIZE>, 6> eps{G(1, 1), G(2, 2), G(3, 3), 2. * G(1, 2), 2. * G(2, 3), 2. * G(3, 1)};
+          const SpColVector<SpDenseGradient<N_SIZE>, 6> epsP{GP(1, 1), GP(2, 2), GP(3, 3), 2. * GP(1, 2), 2. * GP(2, 3), 2. * GP(3, 1)};
+
+          SpColVector<SpGradient, 6> epsLocal(6, 1), epsPLocal(6, 1), sigmaLocal(6, 12);
+
+          for (index_type i = 1; i <= 6; ++i) {
+               epsLocal(i).Reset(eps(i).dGetValue(), i, 1.);
+               epsPLocal(i).Reset(epsP(i).dGetValue(), i + 6, 1.);
+          }
+
+          pConstLaw->Update(epsLocal, epsPLocal, sigmaLocal);
+
+          for (index_type i = 1; i <= 6; ++i) {
+               sigma(i).Reset(sigmaLocal(i).dGetValue());
+
+               for (index_type j = 1; j <= 6; ++j) {
+                    eps(j).InsertDeriv(sigma(i), sigmaLocal(i).dGetDeriv(j));
+                    epsP(j).InsertDeriv(sigma(i), sigmaLocal(i).dGetDeriv(j + 6));
+               }
+          }
+     }
+
 private:
      std::unique_ptr<ConstitutiveLaw6D> pConstLaw;
 };
@@ -461,6 +519,14 @@ protected:
                              const SolidElemStatic* pElem) {
           }
 
+          template <sp_grad::index_type N_SIZE>
+          inline void
+          UpdateStressStrain(const sp_grad::SpMatrix<sp_grad::SpDenseGradient<N_SIZE>, 3, 3>& G,
+                             const sp_grad::SpColVector<sp_grad::SpDenseGradient<N_SIZE>, 6>& sigma,
+                             const sp_grad::SpMatrix<sp_grad::SpDenseGradient<N_SIZE>, 3, 3>& F,
+                             const SolidElemStatic* pElem) {
+          }
+
           SolidCSLType oMaterialData;
           sp_grad::SpColVectorA<doublereal, iNumNodes> h;
           sp_grad::SpMatrixA<doublereal, iNumNodes, 3> h0d;
@@ -826,7 +892,7 @@ template <typename ElementType, typename CollocationType, typename SolidCSLType,
 void SolidElemStatic<ElementType, CollocationType, SolidCSLType, StructNodeType>::WorkSpaceDim(integer* piNumRows, integer* piNumCols) const
 {
      *piNumRows = iNumDof;
-     *piNumCols = 0;
+     *piNumCols = iNumDof;
 }
 
 template <typename ElementType, typename CollocationType, typename SolidCSLType, typename StructNodeType>
@@ -1156,12 +1222,15 @@ SolidElemStatic<ElementType, CollocationType, SolidCSLType, StructNodeType>::Ass
 {
      DEBUGCOUTFNAME("SolidElemStatic::AssJac");
 
-     sp_grad::SpGradientAssVec<sp_grad::SpGradient>::AssJac(this,
-                                                            WorkMat.SetSparseGradient(),
-                                                            dCoef,
-                                                            XCurr,
-                                                            XPrimeCurr,
-                                                            sp_grad::SpFunctionCall::REGULAR_JAC);
+     // The number of dofs is known at compile time, so the derivatives are
+     // stored in fixed size arrays; SpGradientAssVec activates the thread local
+     // SpDenseDofMap which maps the global dofs to the slots of those arrays
+     sp_grad::SpGradientAssVec<sp_grad::SpDenseGradient<iNumDof> >::AssJac(this,
+                                                                           WorkMat,
+                                                                           dCoef,
+                                                                           XCurr,
+                                                                           XPrimeCurr,
+                                                                           sp_grad::SpFunctionCall::REGULAR_JAC);
      return WorkMat;
 }
 
@@ -1874,7 +1943,7 @@ template <typename ElementType, typename CollocationType, typename SolidCSLType,
 void SolidElemDynamic<ElementType, CollocationType, SolidCSLType, eMassMatrix>::WorkSpaceDim(integer* piNumRows, integer* piNumCols) const
 {
      *piNumRows = 2 * iNumDof;
-     *piNumCols = 0;
+     *piNumCols = iNumDof;
 }
 
 template <typename ElementType, typename CollocationType, typename SolidCSLType, MassMatrixType eMassMatrix>
@@ -2065,12 +2134,15 @@ SolidElemDynamic<ElementType, CollocationType, SolidCSLType, eMassMatrix>::AssJa
 {
      DEBUGCOUTFNAME("SolidElemDynamic::AssJac");
 
-     sp_grad::SpGradientAssVec<sp_grad::SpGradient>::AssJac(this,
-                                                            WorkMat.SetSparseGradient(),
-                                                            dCoef,
-                                                            XCurr,
-                                                            XPrimeCurr,
-                                                            sp_grad::SpFunctionCall::REGULAR_JAC);
+     // The number of dofs is known at compile time, so the derivatives are
+     // stored in fixed size arrays; SpGradientAssVec activates the thread local
+     // SpDenseDofMap which maps the global dofs to the slots of those arrays
+     sp_grad::SpGradientAssVec<sp_grad::SpDenseGradient<iNumDof> >::AssJac(this,
+                                                                           WorkMat,
+                                                                           dCoef,
+                                                                           XCurr,
+                                                                           XPrimeCurr,
+                                                                           sp_grad::SpFunctionCall::REGULAR_JAC);
      return WorkMat;
 }
 
@@ -0,0 +1,274 @@
+/*
+ * MBDyn (C) is a multibody analysis code.
+ * http://www.mbdyn.org
+ *
+ * Copyright (C) 1996-2023
+ *
+ * Pierangelo Masarati  <masarati@aero.polimi.it>
+ * Paolo Mantegazza     <mantegazza@aero.polimi.it>
+ *
+ * Dipartimento di Ingegneria Aerospaziale - Politecnico di Milano
+ * via La Masa, 34 - 20156 Milano, Italy
+ * http://www.aero.polimi.it
+ *
+ * Changing this copyright notice is forbidden.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation (version 2 of the License).
+ *
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Checks the Jacobian matrix of a dynamic hexahedron8 element,
+ * which is assembled by means of SpDenseGradient, against
+ * - the Jacobian vector products of the forward mode (GpGradProd)
+ * - central finite differences of the residual.
+ * The model is advanced by a few time steps before the check,
+ * so that the element is deformed and moving.
+ *
+ * usage: solidjactest [<output file name>]
+ */
+
+#include "mbconfig.h"           /* This goes first in every *.c,*.cc file */
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include "myassert.h"
+#include "mynewmem.h"
+#include "except.h"
+#include "table.h"
+#include "mathp.h"
+#include "input.h"
+#include "mbpar.h"
+#include "solver.h"
+#include "dataman.h"
+#include "fullmh.h"
+#include "submat.h"
+
+/*
+ * the "data" block is parsed by mbdyn.cc before the solver is created
+ */
+static const char sInput[] =
+     "begin: initial value;\n"
+     "     initial time: 0.;\n"
+     "     final time: 1.;\n"
+     "     time step: 1e-3;\n"
+     "     method: ms, 0.6;\n"
+     "     tolerance: 1e-10;\n"
+     "     max iterations: 20;\n"
+     "     derivatives tolerance: 1e-4;\n"
+     "     derivatives max iterations: 10;\n"
+     "     derivatives coefficient: auto;\n"
+     "     linear solver: naive, colamd;\n"
+     "     output: none;\n"
+     "end: initial value;\n"
+     "begin: control data;\n"
+     "     use automatic differentiation;\n"
+     "     default output: none;\n"
+     "     structural nodes: 8;\n"
+     "     solids: 1;\n"
+     "end: control data;\n"
+     "begin: nodes;\n"
+     "     structural: 1, dynamic displacement, position, 0.5, 0.5, 0.5, velocity, 3., -1., 2.;\n"
+     "     structural: 2, dynamic displacement, position, -0.5, 0.5, 0.5, velocity, -2., 1., 0.;\n"
+     "     structural: 3, dynamic displacement, position, -0.5, -0.5, 0.5, velocity, 0., 4., -1.;\n"
+     "     structural: 4, dynamic displacement, position, 0.5, -0.5, 0.5, velocity, 1., 0., 3.;\n"
+     "     structural: 5, dynamic displacement, position, 0.5, 0.5, -0.5, velocity, -1., -3., 0.;\n"
+     "     structural: 6, dynamic displacement, position, -0.5, 0.5, -0.5, velocity, 2., 2., -2.;\n"
+     "     structural: 7, dynamic displacement, position, -0.5, -0.5, -0.5, velocity, 0., -1., 4.;\n"
+     "     structural: 8, dynamic displacement, position, 0.5, -0.5, -0.5, velocity, -3., 0., 1.;\n"
+     "end: nodes;\n"
+     "begin: elements;\n"
+     "     hexahedron8: 1, 1, 2, 3, 4, 5, 6, 7, 8,\n"
+     "          1000., 1000., 1000., 1000., 1000., 1000., 1000., 1000.,\n"
+     "          linear viscoelastic isotropic, 1e6, 0.3, 1e-2,\n"
+     "          same, same, same, same, same, same, same;\n"
+     "end: elements;\n";
+
+static const unsigned uNumNodes = 8;
+static const unsigned uNumSteps = 10;
+
+static void
+UpdateNodes(DataManager* pDM, const VectorHandler& X, const VectorHandler& XP)
+{
+     for (unsigned uLabel = 1; uLabel <= uNumNodes; ++uLabel) {
+          pDM->pFindNode(Node::STRUCTURAL, uLabel)->Update(X, XP);
+     }
+}
+
+/*
+ * the nodes must be prepared the same way DataManager::AssJac() does
+ */
+static void
+UpdateJac(DataManager* pDM, doublereal dCoef)
+{
+     for (unsigned uLabel = 1; uLabel <= uNumNodes; ++uLabel) {
+          pDM->pFindNode(Node::STRUCTURAL, uLabel)->UpdateJac(dCoef);
+     }
+}
+
+static void
+UpdateJac(DataManager* pDM, const VectorHandler& Y, doublereal dCoef)
+{
+     for (unsigned uLabel = 1; uLabel <= uNumNodes; ++uLabel) {
+          pDM->pFindNode(Node::STRUCTURAL, uLabel)->UpdateJac(Y, dCoef);
+     }
+}
+
+static void
+AssRes(DataManager* pDM,
+       Elem* pEl,
+       MySubVectorHandler& WorkVec,
+       doublereal dCoef,
+       const VectorHandler& X,
+       const VectorHandler& XP,
+       MyVectorHandler& Res)
+{
+     UpdateNodes(pDM, X, XP);
+
+     Res.Reset();
+     pEl->AssRes(WorkVec, dCoef, X, XP).AddTo(Res);
+}
+
+int
+main(int argc, char* argv[])
+{
+     const char* sOutputFileName = argc > 1 ? argv[1] : "solidjactest";
+     int rc = EXIT_SUCCESS;
+
+     try {
+          Table T(true);
+          MathParser MP(T);
+          std::istringstream in(sInput);
+          InputStream In(in);
+          MBDynParser HP(MP, In, "solidjactest");
+          Solver oSolver(HP, "solidjactest", sOutputFileName, 1, false);
+
+          if (!oSolver.Prepare() || !oSolver.Start()) {
+               silent_cerr("solidjactest: unable to start the simulation" << std::endl);
+               return EXIT_FAILURE;
+          }
+
+          for (unsigned uStep = 0; uStep < uNumSteps; ++uStep) {
+               if (!oSolver.Advance()) {
+                    silent_cerr("solidjactest: simulation stopped at step " << uStep << std::endl);
+                    return EXIT_FAILURE;
+               }
+          }
+
+          DataManager* const pDM = oSolver.pGetDataManager();
+          Elem* const pEl = pDM->pFindElem(Elem::SOLID, 1);
+
+          ASSERT(pEl != 0);
+
+          const integer iNumDofs = pDM->iGetNumDofs();
+          const doublereal dCoef = 0.6e-3;
+
+          integer iNumRows, iNumCols;
+
+          pEl->WorkSpaceDim(&iNumRows, &iNumCols);
+
+          VariableSubMatrixHandlerNonAd WorkMat(iNumRows, iNumCols);
+          MySubVectorHandler WorkVec(iNumRows);
+          FullMatrixHandler Jac(iNumDofs, iNumDofs);
+
+          // the state at the end of the last step
+          MyVectorHandler X(iNumDofs), XP(iNumDofs);
+
+          X = *pDM->GetpXCurr();
+          XP = *pDM->GetpXPCurr();
+
+          UpdateJac(pDM, dCoef);
+
+          Jac += pEl->AssJac(WorkMat, dCoef, X, XP);
+
+          if (!WorkMat.bIsFull()) {
+               silent_cerr("solidjactest: no dense Jacobian matrix" << std::endl);
+               return EXIT_FAILURE;
+          }
+
+          std::vector<integer> rgDofs;
+          const FullSubMatrixHandler& JacEl = WorkMat.GetFull();
+
+          for (integer j = 1; j <= JacEl.iGetNumCols(); ++j) {
+               rgDofs.push_back(JacEl.iGetColIndex(j));
+          }
+
+          MyVectorHandler Y(iNumDofs), JacY(iNumDofs), X1(iNumDofs), XP1(iNumDofs), Res1(iNumDofs), Res2(iNumDofs);
+
+          const doublereal dTolAD = 1e-10;
+          const doublereal dTolFD = 1e-5;
+          const doublereal dPert = 1e-6;
+          doublereal dMaxDiffAD = 0., dMaxDiffFD = 0.;
+
+          for (integer j: rgDofs) {
+               doublereal dNormCol = 0.;
+
+               for (integer i = 1; i <= iNumDofs; ++i) {
+                    dNormCol += std::pow(Jac.dGetCoef(i, j), 2);
+               }
+
+               dNormCol = std::max(1., std::sqrt(dNormCol));
+
+               // forward mode
+               Y.Reset();
+               Y(j) = 1.;
+               JacY.Reset();
+
+               UpdateNodes(pDM, X, XP);
+               UpdateJac(pDM, Y, dCoef);
+
+               pEl->AssJac(JacY, Y, dCoef, X, XP, WorkMat);
+
+               // the residual depends on X with dCoef and on XP with 1
+               X1 = X;
+               XP1 = XP;
+               X1(j) += dCoef * dPert;
+               XP1(j) += dPert;
+
+               AssRes(pDM, pEl, WorkVec, dCoef, X1, XP1, Res1);
+
+               X1(j) = X(j) - dCoef * dPert;
+               XP1(j) = XP(j) - dPert;
+
+               AssRes(pDM, pEl, WorkVec, dCoef, X1, XP1, Res2);
+
+               for (integer i = 1; i <= iNumDofs; ++i) {
+                    const doublereal dJacFD = -(Res1(i) - Res2(i)) / (2. * dPert);
+
+                    dMaxDiffAD = std::max(dMaxDiffAD, std::fabs(JacY(i) - Jac.dGetCoef(i, j)) / dNormCol);
+                    dMaxDiffFD = std::max(dMaxDiffFD, std::fabs(dJacFD - Jac.dGetCoef(i, j)) / dNormCol);
+               }
+          }
+
+          UpdateNodes(pDM, X, XP);
+
+          std::cout << "solidjactest: " << rgDofs.size() << " columns checked\n"
+                    << "maximum difference to forward mode: " << dMaxDiffAD << "\n"
+                    << "maximum difference to finite differences: " << dMaxDiffFD << std::endl;
+
+          if (dMaxDiffAD > dTolAD || dMaxDiffFD > dTolFD) {
+               silent_cerr("solidjactest: Jacobian matrix check failed" << std::endl);
+               rc = EXIT_FAILURE;
+          }
+     } catch (const std::exception& err) {
+          silent_cerr("solidjactest: an exception occurred: " << err.what() << std::endl);
+          rc = EXIT_FAILURE;
+     }
+
+     return rc;
+}
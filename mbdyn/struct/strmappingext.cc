@@ -52,7 +52,7 @@ StructMappingExtForce::StructMappingExtForce(unsigned int uL,
 	std::vector<const StructDispNode *>& nodes,
 	std::vector<Vec3>& offsets,
 	std::vector<unsigned>& labels,
-	SpMapMatrixHandler *pH,
+	CSRMatrix *pH,
 	std::vector<uint32_t>& mappedlabels,
 	bool bLabels,
 	bool bOutputAccelerations,
@@ -222,7 +222,9 @@ m_p(3*uMappedPoints)
 
 StructMappingExtForce::~StructMappingExtForce(void)
 {
-	NO_OP;
+	if (pH) {
+		SAFEDELETE(pH);
+	}
 }
 
 void
@@ -736,14 +738,15 @@ StructMappingExtForce::SendToFileDes(int outfd, ExtFileHandlerBase::SendWhen whe
 	}
 
 	if (pH) {
-		pH->MatVecMul(m_q, m_x);
-		pH->MatVecMul(m_qP, m_xP);
+		// map all the kinematics in a single pass over the matrix
+		doublereal *ppq[] = { &m_q[0], &m_qP[0], bOutputAccelerations ? &m_qPP[0] : 0 };
+		const doublereal *ppx[] = { &m_x[0], &m_xP[0], bOutputAccelerations ? &m_xPP[0] : 0 };
+		pH->MatVecMul(ppq, ppx, bOutputAccelerations ? 3 : 2);
 
 		sendn(outfd, (const char *)&m_q[0], sizeof(double)*m_q.size(), 0);
 		sendn(outfd, (const char *)&m_qP[0], sizeof(double)*m_qP.size(), 0);
 
 		if (bOutputAccelerations) {
-			pH->MatVecMul(m_qPP, m_xPP);
 			sendn(outfd, (const char *)&m_qPP[0], sizeof(double)*m_qPP.size(), 0);
 		}
 
@@ -1155,7 +1158,7 @@ StructMembraneMappingExtForce::StructMembraneMappingExtForce(unsigned int uL,
 	std::vector<Vec3>& offsets,
 	std::vector<unsigned>& labels,
 	std::vector<NodeConnData>& nodesConn,
-	SpMapMatrixHandler *pH,
+	CSRMatrix *pH,
 	std::vector<uint32_t>& mappedlabels,
 	bool bLabels,
 	bool bOutputAccelerations,
@@ -1546,14 +1549,15 @@ StructMembraneMappingExtForce::SendToFileDes(int outfd, ExtFileHandlerBase::Send
 	}
 
 	if (pH) {
-		pH->MatVecMul(m_q, m_x);
-		pH->MatVecMul(m_qP, m_xP);
+		// map all the kinematics in a single pass over the matrix
+		doublereal *ppq[] = { &m_q[0], &m_qP[0], bOutputAccelerations ? &m_qPP[0] : 0 };
+		const doublereal *ppx[] = { &m_x[0], &m_xP[0], bOutputAccelerations ? &m_xPP[0] : 0 };
+		pH->MatVecMul(ppq, ppx, bOutputAccelerations ? 3 : 2);
 
 		sendn(outfd, (const char *)&m_q[0], sizeof(double)*m_q.size(), 0);
 		sendn(outfd, (const char *)&m_qP[0], sizeof(double)*m_qP.size(), 0);
 
 		if (bOutputAccelerations) {
-			pH->MatVecMul(m_qPP, m_xPP);
 			sendn(outfd, (const char *)&m_qPP[0], sizeof(double)*m_qPP.size(), 0);
 		}
 
@@ -2323,7 +2327,7 @@ ReadStructMappingExtForce(DataManager* pDM,
 		}
 	}
 
-	SpMapMatrixHandler *pH = 0;
+	CSRMatrix *pH = 0;
 	std::vector<uint32_t> MappedLabels;
 	if (HP.IsKeyWord("mapped" "points" "number")) {
 		int nMappedPoints = 0;
@@ -38,7 +38,7 @@
 #include <string>
 
 #include "extforce.h"
-#include "spmapmh.h"
+#include "csrmat.h"
 #include "stlvh.h"
 
 /* StructMappingExtForce - begin */
@@ -53,7 +53,7 @@ protected:
 	Vec3 F2, M2;
 
 	// Mapping matrix
-	SpMapMatrixHandler *pH;
+	CSRMatrix *pH;
 
 	struct OffsetData {
 		unsigned uLabel;
@@ -110,7 +110,7 @@ public:
 		std::vector<const StructDispNode *>& Nodes,
 		std::vector<Vec3>& Offsets,
 		std::vector<unsigned>& Labels,
-		SpMapMatrixHandler *pH,
+		CSRMatrix *pH,
 		std::vector<uint32_t>& MappedLabels,
 		bool bLabels,
 		bool bOutputAccelerations,
@@ -175,7 +175,7 @@ public:
 		std::vector<Vec3>& Offsets,
 		std::vector<unsigned>& Labels,
 		std::vector<NodeConnData>& NodesConn,
-		SpMapMatrixHandler *pH,
+		CSRMatrix *pH,
 		std::vector<uint32_t>& MappedLabels,
 		bool bLabels,
 		bool bOutputAccelerations,
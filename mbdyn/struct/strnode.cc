@@ -795,6 +795,26 @@ StructDispNode::AfterConvergence(const VectorHandler& X,
 	XPPPrev = XPPCurr;
 }
 
+std::ostream&
+StructDispNode::Checkpoint(std::ostream& out) const
+{
+	CheckpointPut(out, XCurr);
+	CheckpointPut(out, VCurr);
+	CheckpointPut(out, XPPCurr);
+
+	return out;
+}
+
+std::istream&
+StructDispNode::Resume(std::istream& in)
+{
+	CheckpointGet(in, XCurr);
+	CheckpointGet(in, VCurr);
+	CheckpointGet(in, XPPCurr);
+
+	return in;
+}
+
 /*
  * Metodi per l'estrazione di dati "privati".
  * Si suppone che l'estrattore li sappia interpretare.
@@ -2468,6 +2488,30 @@ StructNode::AfterConvergence(const VectorHandler& X,
 	WPPrev = WPCurr;
 }
 
+std::ostream&
+StructNode::Checkpoint(std::ostream& out) const
+{
+	StructDispNode::Checkpoint(out);
+
+	CheckpointPut(out, RCurr);
+	CheckpointPut(out, WCurr);
+	CheckpointPut(out, WPCurr);
+
+	return out;
+}
+
+std::istream&
+StructNode::Resume(std::istream& in)
+{
+	StructDispNode::Resume(in);
+
+	CheckpointGet(in, RCurr);
+	CheckpointGet(in, WCurr);
+	CheckpointGet(in, WPCurr);
+
+	return in;
+}
+
 /*
  * Metodi per l'estrazione di dati "privati".
  * Si suppone che l'estrattore li sappia interpretare.
@@ -3667,6 +3711,18 @@ DummyStructNode::SetValue(DataManager *pDM,
 	Update(X, XP);
 }
 
+std::ostream&
+DummyStructNode::Checkpoint(std::ostream& out) const
+{
+	return out;
+}
+
+std::istream&
+DummyStructNode::Resume(std::istream& in)
+{
+	return in;
+}
+
 
 /* Elaborazione vettori e dati prima e dopo la predizione
  * per MultiStepIntegrator */
@@ -3686,6 +3742,12 @@ DummyStructNode::AfterPredict(VectorHandler& X, VectorHandler& XP)
 	Update(X, XP);
 }
 
+bool
+DummyStructNode::bIsOrderDependent(void) const
+{
+	return true;
+}
+
 bool
 DummyStructNode::ComputeAccelerations(bool b)
 {
@@ -255,6 +255,11 @@ public:
 			const VectorHandler& XP, 
 			const VectorHandler& XPP) override;
 
+	/* binary dump/restore of the kinematics; after Resume(),
+	 * SetValue() re-derives the contribution to X and XP */
+	virtual std::ostream& Checkpoint(std::ostream& out) const override;
+	virtual std::istream& Resume(std::istream& in) override;
+
 	/* Metodi per l'estrazione di dati "privati".
 	 * Si suppone che l'estrattore li sappia interpretare.
 	 * Come default non ci sono dati privati estraibili */
@@ -779,6 +784,9 @@ public:
 			const VectorHandler& XP, 
 			const VectorHandler& XPP);
 
+	virtual std::ostream& Checkpoint(std::ostream& out) const;
+	virtual std::istream& Resume(std::istream& in);
+
 	/*
 	 * Metodi per l'estrazione di dati "privati".
 	 * Si suppone che l'estrattore li sappia interpretare.
@@ -1257,6 +1265,14 @@ public:
 		std::deque<VectorHandler*>& /* qXPPr */ ) const override;
 	virtual void AfterPredict(VectorHandler& X, VectorHandler& XP) override;
 
+	/* depends on the state of the underlying node(s) */
+	virtual bool bIsOrderDependent(void) const override;
+
+	/* nothing to checkpoint: the kinematics is recomputed
+	 * from that of the underlying node(s) */
+	virtual std::ostream& Checkpoint(std::ostream& out) const override;
+	virtual std::istream& Resume(std::istream& in) override;
+
 	virtual inline bool bComputeAccelerations(void) const override;
 	virtual bool ComputeAccelerations(bool b) override;
 };
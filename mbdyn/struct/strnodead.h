@@ -94,6 +94,18 @@ public:
               doublereal dCoef,
               sp_grad::SpFunctionCall func) const;
 
+     template <sp_grad::index_type N_SIZE>
+     inline void
+     GetXCurr(sp_grad::SpColVector<sp_grad::SpDenseGradient<N_SIZE>, 3>& X,
+              doublereal dCoef,
+              sp_grad::SpFunctionCall func) const;
+
+     template <sp_grad::index_type N_SIZE>
+     inline void
+     GetVCurr(sp_grad::SpColVector<sp_grad::SpDenseGradient<N_SIZE>, 3>& V,
+              doublereal dCoef,
+              sp_grad::SpFunctionCall func) const;
+
      virtual void
      UpdateJac(const VectorHandler& Y, doublereal dCoef) override;
 
@@ -191,6 +203,20 @@ public:
 
      inline void GetWCurr(sp_grad::SpColVector<sp_grad::GpGradProd, 3>& W, doublereal dCoef, sp_grad::SpFunctionCall func) const;
 
+     template <sp_grad::index_type N_SIZE>
+     inline void GetgCurr(sp_grad::SpColVector<sp_grad::SpDenseGradient<N_SIZE>, 3>& g, doublereal dCoef, sp_grad::SpFunctionCall func) const;
+
+     template <sp_grad::index_type N_SIZE>
+     inline void GetgPCurr(sp_grad::SpColVector<sp_grad::SpDenseGradient<N_SIZE>, 3>& gP, doublereal dCoef, sp_grad::SpFunctionCall func) const;
+
+     // The dense rotation is copied from the sparse one computed in UpdateJac;
+     // it depends only on the three rotation dofs of the node.
+     template <sp_grad::index_type N_SIZE>
+     inline void GetRCurr(sp_grad::SpMatrix<sp_grad::SpDenseGradient<N_SIZE>, 3, 3>& R, doublereal dCoef, sp_grad::SpFunctionCall func) const;
+
+     template <sp_grad::index_type N_SIZE>
+     inline void GetWCurr(sp_grad::SpColVector<sp_grad::SpDenseGradient<N_SIZE>, 3>& W, doublereal dCoef, sp_grad::SpFunctionCall func) const;
+
      virtual void Update(const VectorHandler& X, const VectorHandler& XP) override;
      virtual void InitialUpdate(const VectorHandler& X) override;
      virtual void DerivativesUpdate(const VectorHandler& X, const VectorHandler& XP) override;
@@ -331,6 +357,14 @@ public:
      inline void
      GetWPCurr(sp_grad::SpColVector<sp_grad::GpGradProd, 3>& WP, doublereal dCoef, sp_grad::SpFunctionCall func) const;
 
+     template <sp_grad::index_type N_SIZE>
+     inline void
+     GetXPPCurr(sp_grad::SpColVector<sp_grad::SpDenseGradient<N_SIZE>, 3>& XPP, doublereal dCoef, sp_grad::SpFunctionCall func) const;
+
+     template <sp_grad::index_type N_SIZE>
+     inline void
+     GetWPCurr(sp_grad::SpColVector<sp_grad::SpDenseGradient<N_SIZE>, 3>& WP, doublereal dCoef, sp_grad::SpFunctionCall func) const;
+
      virtual void UpdateJac(const VectorHandler& Y, doublereal dCoef) override;
 
 protected:
@@ -426,6 +460,62 @@ inline void StructDispNodeAd::GetVCurr(sp_grad::SpColVector<sp_grad::GpGradProd,
      }
 }
 
+template <sp_grad::index_type N_SIZE>
+inline void StructDispNodeAd::GetXCurr(sp_grad::SpColVector<sp_grad::SpDenseGradient<N_SIZE>, 3>& X, doublereal dCoef, sp_grad::SpFunctionCall func) const
+{
+     sp_grad::index_type iFirstDofIndex = -1;
+
+     switch (func) {
+     case sp_grad::SpFunctionCall::INITIAL_ASS_JAC:
+          SP_GRAD_ASSERT(dCoef == 1.);
+          [[fallthrough]];
+     case sp_grad::SpFunctionCall::INITIAL_DER_JAC:
+     case sp_grad::SpFunctionCall::REGULAR_JAC:
+          iFirstDofIndex = StructDispNode::iGetFirstIndex();
+          break;
+
+     default:
+          SP_GRAD_ASSERT(false);
+     }
+
+     X.ResizeReset(3, 1);
+
+     const Vec3& XCurr = StructDispNode::GetXCurr();
+
+     for (sp_grad::index_type i = 1; i <= 3; ++i) {
+          X(i).Reset(XCurr(i), iFirstDofIndex + i, -dCoef);
+     }
+}
+
+template <sp_grad::index_type N_SIZE>
+inline void StructDispNodeAd::GetVCurr(sp_grad::SpColVector<sp_grad::SpDenseGradient<N_SIZE>, 3>& V, doublereal dCoef, sp_grad::SpFunctionCall func) const
+{
+     sp_grad::index_type iFirstDofIndex = -1;
+
+     switch (func) {
+     case sp_grad::SpFunctionCall::INITIAL_ASS_JAC:
+          SP_GRAD_ASSERT(dCoef == 1.);
+          iFirstDofIndex = iGetInitialFirstIndexPrime();
+          break;
+
+     case sp_grad::SpFunctionCall::INITIAL_DER_JAC:
+     case sp_grad::SpFunctionCall::REGULAR_JAC:
+          iFirstDofIndex = iGetFirstIndex();
+          break;
+
+     default:
+          SP_GRAD_ASSERT(false);
+     }
+
+     V.ResizeReset(3, 1);
+
+     const Vec3& VCurr = StructDispNode::GetVCurr();
+
+     for (sp_grad::index_type i = 1; i <= 3; ++i) {
+          V(i).Reset(VCurr(i), iFirstDofIndex + i, -1.);
+     }
+}
+
 inline void StructNodeAd::GetgCurr(sp_grad::SpColVector<doublereal, 3>& g, doublereal dCoef, sp_grad::SpFunctionCall func) const
 {
      g = gCurr;
@@ -548,6 +638,87 @@ inline void StructNodeAd::GetWCurr(sp_grad::SpColVector<sp_grad::SpGradient, 3>&
      W = WCurr_grad;
 }
 
+template <sp_grad::index_type N_SIZE>
+inline void StructNodeAd::GetgCurr(sp_grad::SpColVector<sp_grad::SpDenseGradient<N_SIZE>, 3>& g, doublereal dCoef, sp_grad::SpFunctionCall func) const
+{
+     sp_grad::index_type iFirstDofIndex = -1;
+
+     switch (func) {
+     case sp_grad::SpFunctionCall::INITIAL_ASS_JAC:
+          SP_GRAD_ASSERT(dCoef == 1.);
+          [[fallthrough]];
+     case sp_grad::SpFunctionCall::INITIAL_DER_JAC:
+     case sp_grad::SpFunctionCall::REGULAR_JAC:
+          iFirstDofIndex = iGetFirstIndex();
+          break;
+
+     default:
+          SP_GRAD_ASSERT(false);
+     }
+
+     g.ResizeReset(3, 1);
+
+     for (sp_grad::index_type i = 1; i <= 3; ++i) {
+          g(i).Reset(gCurr(i), iFirstDofIndex + i + 3, -dCoef);
+     }
+}
+
+template <sp_grad::index_type N_SIZE>
+inline void StructNodeAd::GetgPCurr(sp_grad::SpColVector<sp_grad::SpDenseGradient<N_SIZE>, 3>& gP, doublereal dCoef, sp_grad::SpFunctionCall func) const
+{
+     sp_grad::index_type iFirstDofIndex = -1;
+
+     gP.ResizeReset(3, 1);
+
+     switch (func) {
+     case sp_grad::SpFunctionCall::INITIAL_ASS_JAC:
+          for (sp_grad::index_type i = 1; i <= 3; ++i) {
+               gP(i).Reset(gPCurr(i));
+          }
+          return;
+
+     case sp_grad::SpFunctionCall::INITIAL_DER_JAC:
+     case sp_grad::SpFunctionCall::REGULAR_JAC:
+          iFirstDofIndex = iGetFirstIndex() + 3;
+          break;
+
+     default:
+          SP_GRAD_ASSERT(false);
+     }
+
+     for (sp_grad::index_type i = 1; i <= 3; ++i) {
+          gP(i).Reset(gPCurr(i), iFirstDofIndex + i, -1.);
+     }
+}
+
+template <sp_grad::index_type N_SIZE>
+inline void StructNodeAd::GetRCurr(sp_grad::SpMatrix<sp_grad::SpDenseGradient<N_SIZE>, 3, 3>& R, doublereal dCoef, sp_grad::SpFunctionCall func) const
+{
+     SP_GRAD_ASSERT(bNeedRotation);
+     SP_GRAD_ASSERT(!bUpdateRotation);
+
+     R.ResizeReset(3, 3, 1);
+
+     for (sp_grad::index_type j = 1; j <= 3; ++j) {
+          for (sp_grad::index_type i = 1; i <= 3; ++i) {
+               R(i, j).Reset(RCurr_grad(i, j));
+          }
+     }
+}
+
+template <sp_grad::index_type N_SIZE>
+inline void StructNodeAd::GetWCurr(sp_grad::SpColVector<sp_grad::SpDenseGradient<N_SIZE>, 3>& W, doublereal dCoef, sp_grad::SpFunctionCall func) const
+{
+     SP_GRAD_ASSERT(bNeedRotation);
+     SP_GRAD_ASSERT(!bUpdateRotation);
+
+     W.ResizeReset(3, 1);
+
+     for (sp_grad::index_type i = 1; i <= 3; ++i) {
+          W(i).Reset(WCurr_grad(i));
+     }
+}
+
 inline void
 ModalNodeAd::GetXPPCurr(sp_grad::SpColVector<doublereal, 3>& XPP, doublereal dCoef, sp_grad::SpFunctionCall func) const
 {
@@ -620,4 +791,50 @@ ModalNodeAd::GetWPCurr(sp_grad::SpColVector<sp_grad::GpGradProd, 3>& WP, doubler
      }
 }
 
+template <sp_grad::index_type N_SIZE>
+inline void
+ModalNodeAd::GetXPPCurr(sp_grad::SpColVector<sp_grad::SpDenseGradient<N_SIZE>, 3>& XPP, doublereal dCoef, sp_grad::SpFunctionCall func) const
+{
+     sp_grad::index_type iFirstDofIndex = -1;
+
+     switch (func) {
+     case sp_grad::SpFunctionCall::INITIAL_DER_JAC:
+     case sp_grad::SpFunctionCall::REGULAR_JAC:
+          iFirstDofIndex = iGetFirstIndex();
+          break;
+
+     default:
+          SP_GRAD_ASSERT(false);
+     }
+
+     XPP.ResizeReset(3, 1);
+
+     for (sp_grad::index_type i = 1; i <= 3; ++i) {
+          XPP(i).Reset(XPPCurr(i), iFirstDofIndex + i + 6, -1.);
+     }
+}
+
+template <sp_grad::index_type N_SIZE>
+inline void
+ModalNodeAd::GetWPCurr(sp_grad::SpColVector<sp_grad::SpDenseGradient<N_SIZE>, 3>& WP, doublereal dCoef, sp_grad::SpFunctionCall func) const
+{
+     sp_grad::index_type iFirstDofIndex = -1;
+
+     switch (func) {
+     case sp_grad::SpFunctionCall::INITIAL_DER_JAC:
+     case sp_grad::SpFunctionCall::REGULAR_JAC:
+          iFirstDofIndex = iGetFirstIndex();
+          break;
+
+     default:
+          SP_GRAD_ASSERT(false);
+     }
+
+     WP.ResizeReset(3, 1);
+
+     for (sp_grad::index_type i = 1; i <= 3; ++i) {
+          WP(i).Reset(WPCurr(i), iFirstDofIndex + i + 9, -1.);
+     }
+}
+
 #endif
@@ -431,6 +431,8 @@ public:
 	// induced velocity specific calls
 	virtual InducedVelocity::Type GetInducedVelocityType(void) const;
 	virtual bool bSectionalForces(void) const;
+	// sectional data are matched to the elements by call order
+	virtual bool bConcurrentForces(void) const;
 	virtual Vec3 GetInducedVelocity(Elem::Type type,
 		unsigned uLabel, unsigned uPnt, const Vec3&) const;
 	virtual void AddSectionalForce(Elem::Type type,
@@ -974,6 +976,12 @@ ModuleCHARM::bSectionalForces(void) const
 	return true;
 }
 
+bool
+ModuleCHARM::bConcurrentForces(void) const
+{
+	return false;
+}
+
 void
 ModuleCHARM::Init_int(void)
 {
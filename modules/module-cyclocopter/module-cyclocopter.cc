@@ -526,7 +526,7 @@ CyclocopterNoInflow::AddForce(const Elem *pEl, const StructNode *pNode, const Ve
 {
 	/* Sole se deve fare l'output calcola anche il momento */
 	if (bToBeOutput()) {
-		Res.AddForces(F, M, X);
+		AddResForces(F, M, X);
 		InducedVelocity::AddForce(pEl, pNode, F, M, X);
 	}
 }
@@ -599,6 +599,9 @@ public:
 	virtual void
 	AddForce(const Elem *pEl, const StructNode *pNode, const Vec3& F, const Vec3& M, const Vec3& X);
 
+	// the azimuth is taken from the first blade that adds its force
+	virtual bool bConcurrentForces(void) const;
+
 	// Restituisce ad un elemento la velocita' indotta
 	// in base alla posizione azimuthale
 	virtual Vec3 GetInducedVelocity(Elem::Type type,
@@ -815,6 +818,12 @@ CyclocopterUniform1D::AssRes(SubVectorHandler& WorkVec,
 	return WorkVec;
 }
 
+bool
+CyclocopterUniform1D::bConcurrentForces(void) const
+{
+	return false;
+}
+
 void
 CyclocopterUniform1D::AddForce(const Elem *pEl, const StructNode *pNode, const Vec3& F, const Vec3& M, const Vec3& X)
 {
@@ -831,11 +840,11 @@ CyclocopterUniform1D::AddForce(const Elem *pEl, const StructNode *pNode, const V
 
 	/* Sole se deve fare l'output calcola anche il momento */
 	if (bToBeOutput()) {
-		Res.AddForces(F, M, X);
+		AddResForces(F, M, X);
 		InducedVelocity::AddForce(pEl, pNode, F, M, X);
 
 	} else {
-		Res.AddForce(F);
+		AddResForce(F);
 	}
 }
 
@@ -902,6 +911,9 @@ public:
 	virtual void
 	AddForce(const Elem *pEl, const StructNode *pNode, const Vec3& F, const Vec3& M, const Vec3& X);
 
+	// the azimuth is taken from the first blade that adds its force
+	virtual bool bConcurrentForces(void) const;
+
 	// Restituisce ad un elemento la velocita' indotta
 	// in base alla posizione azimuthale
 	virtual Vec3 GetInducedVelocity(Elem::Type type,
@@ -1167,6 +1179,12 @@ CyclocopterUniform2D::AssRes(SubVectorHandler& WorkVec,
 	return WorkVec;
 }
 
+bool
+CyclocopterUniform2D::bConcurrentForces(void) const
+{
+	return false;
+}
+
 void
 CyclocopterUniform2D::AddForce(const Elem *pEl, const StructNode *pNode, const Vec3& F, const Vec3& M, const Vec3& X)
 {
@@ -1182,11 +1200,11 @@ CyclocopterUniform2D::AddForce(const Elem *pEl, const StructNode *pNode, const V
 
 	/* Sole se deve fare l'output calcola anche il momento */
 	if (bToBeOutput()) {
-		Res.AddForces(F, M, X);
+		AddResForces(F, M, X);
 		InducedVelocity::AddForce(pEl, pNode, F, M, X);
 
 	} else {
-		Res.AddForce(F);
+		AddResForce(F);
 	}
 }
 
@@ -1269,6 +1287,9 @@ public:
 	virtual void
 	AddForce(const Elem *pEl, const StructNode *pNode, const Vec3& F, const Vec3& M, const Vec3& X);
 
+	// the azimuth is taken from the first blade that adds its force
+	virtual bool bConcurrentForces(void) const;
+
 	// Restituisce ad un elemento la velocita' indotta
 	// in base alla posizione azimuthale
 	virtual Vec3 GetInducedVelocity(Elem::Type type,
@@ -1512,6 +1533,12 @@ CyclocopterPolimi::AssRes(SubVectorHandler& WorkVec,
 	return WorkVec;
 }
 
+bool
+CyclocopterPolimi::bConcurrentForces(void) const
+{
+	return false;
+}
+
 void
 CyclocopterPolimi::AddForce(const Elem *pEl, const StructNode *pNode, const Vec3& F, const Vec3& M, const Vec3& X)
 {
@@ -1526,11 +1553,11 @@ CyclocopterPolimi::AddForce(const Elem *pEl, const StructNode *pNode, const Vec3
 
 	/* Sole se deve fare l'output calcola anche il momento */
 	if (bToBeOutput()) {
-		Res.AddForces(F,M,X);
+		AddResForces(F,M,X);
 		InducedVelocity::AddForce(pEl, pNode, F, M, X);
 
 	} else {
-		Res.AddForce(F);
+		AddResForce(F);
 	}
 }
 
@@ -71,6 +71,8 @@ public:
 	// induced velocity specific calls
 	virtual InducedVelocity::Type GetInducedVelocityType(void) const;
 	virtual bool bSectionalForces(void) const;
+	// sectional data are matched to the elements by call order
+	virtual bool bConcurrentForces(void) const;
 	virtual Vec3 GetInducedVelocity(Elem::Type type,
 		unsigned uLabel, unsigned uPnt, const Vec3&) const;
 	virtual void AddSectionalForce(Elem::Type type,
@@ -167,6 +169,12 @@ ModuleIndVel::bSectionalForces(void) const
 	return true;
 }
 
+bool
+ModuleIndVel::bConcurrentForces(void) const
+{
+	return false;
+}
+
 Vec3
 ModuleIndVel::GetInducedVelocity(Elem::Type type,
 		unsigned uLabel, unsigned uPnt, const Vec3& X) const
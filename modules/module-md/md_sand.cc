@@ -1,4 +1,7 @@
 // The units in this program are second, centimeter, gram.
+#include "mbconfig.h"           /* This goes first in every *.c,*.cc file */
+
+#include <algorithm>
 #include <cmath>
 #include <cstdlib>
 #include <ctime>
@@ -6,6 +9,9 @@
 #include <string>
 #include <sstream>
 #include <cassert>
+#ifdef HAVE_THREADS
+#include <thread>
+#endif
 #include "md_sand.h"
 #include "md_shape.h"
 #include "md_utility.h"
@@ -13,7 +19,6 @@
 
 using namespace std;
 const double math_pi = 3.1415926535897932384626433832795;
-const int nnbr[][MD_DIM] = MD_OFFSET_VALS;
 const RealVec gravity_vector(0, 0, -double (GRAVITY));
 
 struct MDDisk
@@ -65,72 +70,36 @@ MDRegion::RegionSplit()
     int npar_per_region = n_par_ / n_subregion_;
 }
 
+// the copy gets no worker threads until Init() is called on it
+
 MDSand::MDSand(const MDSand &T)
 {
-    radius_min_ = T.radius_min_;
-    radius_max_ = T.radius_max_;
-    mass_min_ = T.mass_min_;
-    mass_max_ = T.mass_max_;
-    bip_ratio_ = T.bip_ratio_;
-    kn_ = T.kn_;
-    kt_ = T.kt_;
-    gn_ = T.gn_;
-    gs_ = T.gs_;
-    mu_pp_ = T.mu_pp_;
-    mu_bp_ = T.mu_bp_;
-    cell_length_ = T.cell_length_;
-    cell_num_x_ = T.cell_num_x_;
-    cell_num_y_ = T.cell_num_y_;
-    cell_num_z_ = T.cell_num_z_;
-    sys_step_ = T.sys_step_;
-    sys_time_ = T.sys_time_;
-    step_tau_ = T.step_tau_;
-    sav_intval_ = T.sav_intval_;
-    sav_intval_step_ = T.sav_intval_step_;
-
-    if_output_ = T.if_output_;
-    boundary_para_ = T.boundary_para_;
-    sys_energy_ = T.sys_energy_;
-    sys_potential_Energy_ = T.sys_potential_Energy_;
-    sys_kinematic_energy_ = T.sys_kinematic_energy_;
-    sys_dissip_energy_ = T.sys_dissip_energy_;
-    sand_array_ = new MDDisk[num_particles_];
-    box_cell_ = new MDCell *[cell_num_x_ * cell_num_y_ * cell_num_z_];
-    slip_array_ = new MDSlip *[num_particles_];
-    md_cell_nbr_ = new IntVec [MD_N_NBR];
-    max_contact_n_ = T.max_contact_n_;
-    int i, j;
-    for (i = 0; i < MD_N_NBR; i++)
-    {
-        md_cell_nbr_[i].x = nnbr[i][0];
-        md_cell_nbr_[i].y = nnbr[i][1];
-        md_cell_nbr_[i].z = nnbr[i][2];
-    }
-    for (i = 0; i < num_particles_; i++)
-    {
-        slip_array_[i] = new MDSlip[max_contact_n_];
-        for (j = 0; j < max_contact_n_; j++)
-        {
-            slip_array_[i][j].ref_num = 0;
-            slip_array_[i][j].next = NULL;
-        }
-    }
-    for (i = 0; i < cell_num_x_ * cell_num_z_ * cell_num_y_; i++)
-    {
-        box_cell_[i] = NULL;
-    }
-    for (i = 0; i < cell_num_x_ * cell_num_z_ * cell_num_y_; i++)
-    {
-        if (box_cell_[i] != NULL)
-        {
-            cout << i << "\t" << box_cell_[i] << endl;
-            assert(0);
-        }
-    }
+    *this = T;
 }
 
 MDSand& MDSand::operator=(const MDSand &T)
 {
+    id_ = T.id_;
+    slot_ = T.slot_;
+    pos_ = T.pos_;
+    v_ = T.v_;
+    F_ = T.F_;
+    r_ = T.r_;
+    m_ = T.m_;
+    abF_ = T.abF_;
+    remove_ = T.remove_;
+    cell_start_ = T.cell_start_;
+    nbr_start_ = T.nbr_start_;
+    nbr_list_ = T.nbr_list_;
+    pos_build_ = T.pos_build_;
+    skin_ = T.skin_;
+    nbr_builds_ = T.nbr_builds_;
+    n_threads_ = T.n_threads_;
+    ext_shape_ = NULL;
+    box_length_x_ = T.box_length_x_;
+    box_length_y_ = T.box_length_y_;
+    box_length_z_ = T.box_length_z_;
+    num_particles_ = T.num_particles_;
     radius_min_ = T.radius_min_;
     radius_max_ = T.radius_max_;
     mass_min_ = T.mass_min_;
@@ -158,40 +127,6 @@ MDSand& MDSand::operator=(const MDSand &T)
     sys_potential_Energy_ = T.sys_potential_Energy_;
     sys_kinematic_energy_ = T.sys_kinematic_energy_;
     sys_dissip_energy_ = T.sys_dissip_energy_;
-    sand_array_ = new MDDisk[num_particles_];
-    box_cell_ = new MDCell *[cell_num_x_ * cell_num_y_ * cell_num_z_];
-    slip_array_ = new MDSlip *[num_particles_];
-    md_cell_nbr_ = new IntVec [MD_N_NBR];
-    max_contact_n_ = T.max_contact_n_;
-    int i, j;
-
-    for (i = 0; i < MD_N_NBR; i++)
-    {
-        md_cell_nbr_[i].x = nnbr[i][0];
-        md_cell_nbr_[i].y = nnbr[i][1];
-        md_cell_nbr_[i].z = nnbr[i][2];
-    }
-    for (i = 0; i < num_particles_; i++)
-    {
-        slip_array_[i] = new MDSlip[max_contact_n_];
-        for (j = 0; j < max_contact_n_; j++)
-        {
-            slip_array_[i][j].ref_num = 0;
-            slip_array_[i][j].next = NULL;
-        }
-    }
-    for (i = 0; i < cell_num_x_ * cell_num_z_ * cell_num_y_; i++)
-    {
-        box_cell_[i] = NULL;
-    }
-    for (i = 0; i < cell_num_x_ * cell_num_z_ * cell_num_y_; i++)
-    {
-        if (box_cell_[i] != NULL)
-        {
-            cout << i << "\t" << box_cell_[i] << endl;
-            assert(0);
-        }
-    }
     return *this;
 }
 
@@ -212,11 +147,13 @@ num_particles_(numberparticles)
     gs_ = 0;
     mu_pp_ = 0.1;
     mu_bp_ = 0.27;
+    // neighbour list skin; 0 threads means one per available core
+    skin_ = 0.1 * radius_max_;
+    nbr_builds_ = 0;
+    n_threads_ = 0;
+    ext_shape_ = NULL;
     // region geometry
-    cell_length_ = 2 * radius_max_;
-    cell_num_x_ = box_length_x_ / cell_length_ + 2;
-    cell_num_y_ = box_length_y_ / cell_length_ + 2;
-    cell_num_z_ = box_length_z_ / cell_length_ + 2;
+    InitCellGeometry();
     // initial system time and time step, time step length
     sys_step_ = 0;
     sys_time_ = 0;
@@ -230,37 +167,19 @@ num_particles_(numberparticles)
     sys_potential_Energy_ = 0;
     sys_kinematic_energy_ = 0;
     sys_dissip_energy_ = 0;
-    sand_array_ = new MDDisk[num_particles_];
-    box_cell_ = new MDCell *[cell_num_x_ * cell_num_y_ * cell_num_z_];
-    slip_array_ = new MDSlip *[num_particles_];
-    md_cell_nbr_ = new IntVec [MD_N_NBR];
-    max_contact_n_ = 15 * 0;
-    int i, j;
-    for (i = 0; i < MD_N_NBR; i++)
-    {
-        md_cell_nbr_[i].x = nnbr[i][0];
-        md_cell_nbr_[i].y = nnbr[i][1];
-        md_cell_nbr_[i].z = nnbr[i][2];
-    }
-    for (i = 0; i < num_particles_; i++)
-    {
-        slip_array_[i] = new MDSlip[max_contact_n_];
-        for (j = 0; j < max_contact_n_; j++)
-        {
-            slip_array_[i][j].ref_num = 0;
-            slip_array_[i][j].next = NULL;
-        }
-    }
-    for (i = 0; i < cell_num_x_ * cell_num_z_ * cell_num_y_; i++)
-    {
-        box_cell_[i] = NULL;
-    }
-    for (i = 0; i < cell_num_x_ * cell_num_z_ * cell_num_y_; i++)
+    id_.resize(num_particles_);
+    slot_.resize(num_particles_);
+    pos_.resize(num_particles_, RealVec(0, 0, 0));
+    v_.resize(num_particles_, RealVec(0, 0, 0));
+    F_.resize(num_particles_, RealVec(0, 0, 0));
+    r_.resize(num_particles_, 0);
+    m_.resize(num_particles_, 0);
+    abF_.resize(num_particles_, 0);
+    remove_.resize(num_particles_, 0);
+    for (int i = 0; i < num_particles_; i++)
     {
-        if (box_cell_[i] != NULL)
-        {
-            cout << i << "\t" << box_cell_[i] << endl;
-        }
+        id_[i] = i;
+        slot_[i] = i;
     }
     sand_file_.open("san.dat", ios::out | ios::binary);
     if (sand_file_.fail())
@@ -274,9 +193,36 @@ num_particles_(numberparticles)
     }
 }
 
+// cells are large enough to contain all the neighbours within the skin
+// of any particle in the adjacent cells
+
+void
+MDSand::InitCellGeometry()
+{
+    cell_length_ = 2 * radius_max_ + skin_;
+    cell_num_x_ = box_length_x_ / cell_length_ + 2;
+    cell_num_y_ = box_length_y_ / cell_length_ + 2;
+    cell_num_z_ = box_length_z_ / cell_length_ + 2;
+}
+
+void
+MDSand::SetThreads(int n)
+{
+    assert(n >= 0);
+    n_threads_ = n;
+}
+
+void
+MDSand::SetSkin(double skin)
+{
+    assert(skin >= 0);
+    skin_ = skin;
+    InitCellGeometry();
+}
+
 /*
  * void MDSand::Init(int ibatch) { int i; for (i = ibatch * 100; i < ibatch * 100 + 100; i++) { IntVec vecint;
- * PositionToCell(sand_array_[i].pos, vecint); if (vecint.out()) cout << "wrong at Init() add" << endl; InitCell(i, vecint); } }
+ * PositionToCell(pos_[i], vecint); if (vecint.out()) cout << "wrong at Init() add" << endl; InitCell(i, vecint); } }
  */
 
 bool
@@ -318,42 +264,44 @@ MDSand::Init()
 {
 
     int i;
-    int tempcounter = 0;
-    MDCell *temppair;
 
-    for (i = 0; i < num_particles_; i++)
+    if (n_threads_ == 0)
     {
-        IntVec vecint;
-        PositionToCell(sand_array_[i].pos, vecint);
-        if (RegionOut(vecint))
-            cout << "wrong at Init() add" << endl;
-        InitCell(i, vecint);
-    }
-    for (i = 0; i < cell_num_x_ * cell_num_z_ * cell_num_y_; i++)
-    {
-        temppair = box_cell_[i];
-        while (temppair != NULL)
-        {
-            temppair = (*temppair).next;
-            tempcounter++;
-        }
+#ifdef HAVE_THREADS
+        n_threads_ = std::max(1U, std::thread::hardware_concurrency());
+#else
+        n_threads_ = 1;
+#endif
     }
-    assert(tempcounter == num_particles_ && tempcounter);
-    cout << "total of " << tempcounter << " sand particles loaded" << endl;
+#ifndef HAVE_THREADS
+    n_threads_ = 1;
+#endif
+    thr_nbr_.resize(n_threads_);
+    thr_force_.resize(n_threads_);
+    thr_moment_.resize(n_threads_);
+    thr_inside_.resize(n_threads_);
+    pool_.SetWorkers(n_threads_ - 1);
+
+    BuildNeighbourList();
+    assert(cell_start_.back() == num_particles_ && num_particles_);
+    cout << "total of " << num_particles_ << " sand particles loaded" << endl;
     cout << "current box dimension is " << box_length_x_ << "x" << box_length_y_
         << "x" << box_length_z_ << " cm" << endl;
+    cout << "neighbour list skin " << skin_ << " cm, "
+        << double (nbr_list_.size()) / num_particles_ << " neighbours per particle, "
+        << n_threads_ << " threads" << endl;
 
     for (i = 0; i < num_particles_; i++)
     {
         sys_kinematic_energy_ =
-            sys_kinematic_energy_ + 0.5 * sand_array_[i].m * (sand_array_[i].v * sand_array_[i].v);
+            sys_kinematic_energy_ + 0.5 * m_[i] * (v_[i] * v_[i]);
         sys_potential_Energy_ =
-            sys_potential_Energy_ + sand_array_[i].m * GRAVITY * sand_array_[i].pos.z;
+            sys_potential_Energy_ + m_[i] * GRAVITY * pos_[i].z;
     }
 }
 
 void
-MDSand::PositionToCell(class RealVec & sand_position, class IntVec & cell_position)
+MDSand::PositionToCell(const class RealVec & sand_position, class IntVec & cell_position)
 {
 
     cell_position.x = (int) (sand_position.x / cell_length_);
@@ -362,113 +310,171 @@ MDSand::PositionToCell(class RealVec & sand_position, class IntVec & cell_positi
     if (RegionOut(cell_position))
     {
         cout << "error! out of cell boundary" << endl;
+        // keep the particle in the boundary cells
+        cell_position.x = max(0, min(cell_position.x, cell_num_x_ - 1));
+        cell_position.y = max(0, min(cell_position.y, cell_num_y_ - 1));
+        cell_position.z = max(0, min(cell_position.z, cell_num_z_ - 1));
     }
 }
 
-int
-MDSand::TransCell(int i, const class IntVec & vec1, const class IntVec & vec2)
+// split the particles in contiguous chunks, one per thread, and call
+// (this->*f)(first, last, thread) on each chunk; chunk 0 runs on the
+// caller, the others on the worker threads sized by Init()
+
+void
+MDSand::ParallelFor(int n, void (MDSand::*f)(int, int, int))
 {
-    MDCell *pointa, *pointb;
+    int n_chunks = min(int (pool_.uGetWorkers()) + 1, n);
 
-    // let us keep the error check part.
-    if (RegionOut(vec1) || RegionOut(vec2))
+    if (n_chunks > 1)
     {
-        cout << "" << endl;
-        cout << vec1.x << "\t" << vec2.x << endl;
-        cout << vec1.y << "\t" << vec2.y << endl;
-        cout << vec1.z << "\t" << vec2.z << endl;
-        exit(0);
+        pool_.Run(n_chunks, [this, f, n, n_chunks] (unsigned c)
+        {
+            (this->*f)(int ((long (n) * c) / n_chunks),
+                int ((long (n) * (c + 1)) / n_chunks), c);
+        });
+        return;
     }
-    // ------------------------------------------
+    (this->*f)(0, n, 0);
+}
+
+// reorder the particles by cell (counting sort), so that particles close
+// in space are also close in memory, and fill the cell list
 
-    pointa = RemovefromCell(i, vec1);
-    if (pointa == NULL)
+void
+MDSand::SortByCell()
+{
+    int n_cell = cell_num_x_ * cell_num_y_ * cell_num_z_;
+    vector<int> cell(num_particles_);
+    vector<int> next;
+    IntVec ci;
+    int i;
+
+    cell_start_.assign(n_cell + 1, 0);
+    for (i = 0; i < num_particles_; i++)
     {
-        cout << "error! Cannot find the particle in cell." << endl;
-        return -1;
+        PositionToCell(pos_[i], ci);
+        cell[i] = CellIndexToDimOne(ci);
+        cell_start_[cell[i] + 1]++;
     }
-    pointb = box_cell_[CellIndexToDimOne(vec2)];
-    if (pointb == NULL)
+    for (i = 0; i < n_cell; i++)
     {
-        box_cell_[CellIndexToDimOne(vec2)] = pointa;
-        return 1;
+        cell_start_[i + 1] += cell_start_[i];
     }
-    else
+
+    next.assign(cell_start_.begin(), cell_start_.end() - 1);
+    vector<int> order(num_particles_);
+    for (i = 0; i < num_particles_; i++)
+    {
+        order[next[cell[i]]++] = i;
+    }
+
+    vector<int> id(num_particles_);
+    vector<RealVec> pos(num_particles_), v(num_particles_);
+    vector<double> r(num_particles_), m(num_particles_);
+    vector<char> remove(num_particles_);
+    for (i = 0; i < num_particles_; i++)
     {
-        while ((*pointb).next != NULL)
-            pointb = (*pointb).next;
-        (*pointb).next = pointa;
+        int k = order[i];
+        id[i] = id_[k];
+        pos[i] = pos_[k];
+        v[i] = v_[k];
+        r[i] = r_[k];
+        m[i] = m_[k];
+        remove[i] = remove_[k];
+        slot_[id[i]] = i;
     }
-    return 0;
+    id_.swap(id);
+    pos_.swap(pos);
+    v_.swap(v);
+    r_.swap(r);
+    m_.swap(m);
+    remove_.swap(remove);
 }
 
-// remove an atom from a specific cell and return the pointer to the freed cell
+// collect the neighbours of particles first to last - 1 within the skin;
+// each thread writes its own list, and the counts of its own particles
 
-struct MDCell *
-MDSand::RemovefromCell(int i, const class IntVec & vector)
+void
+MDSand::NeighbourChunk(int first, int last, int t)
 {
-    struct MDCell *p, *pnext;
+    vector<int> & nbr = thr_nbr_[t];
+    IntVec ci, cu;
 
-    // need to make sure this atom i belong to the vector specified by vector
-    p = box_cell_[CellIndexToDimOne(vector)];
-    assert(p && "cell is empty");
-    if ((*p).ref_num == i)
-    {
-        box_cell_[CellIndexToDimOne(vector)] = (*p).next;
-        (*p).next = NULL;
-        return p;
-    }
-    else
+    nbr.clear();
+    for (int i = first; i < last; i++)
     {
-        pnext = (*p).next;
-        while ((*pnext).ref_num != i && (*pnext).next != NULL)
+        int n = 0;
+
+        PositionToCell(pos_[i], ci);
+        for (cu.z = ci.z - 1; cu.z <= ci.z + 1; cu.z++)
         {
-            p = pnext;
-            pnext = (*pnext).next;
+            for (cu.y = ci.y - 1; cu.y <= ci.y + 1; cu.y++)
+            {
+                for (cu.x = ci.x - 1; cu.x <= ci.x + 1; cu.x++)
+                {
+                    // jump when it is out of boundary
+                    if (RegionOut(cu))
+                        continue;
+                    int c = CellIndexToDimOne(cu);
+                    for (int j = cell_start_[c]; j < cell_start_[c + 1]; j++)
+                    {
+                        double d = r_[i] + r_[j] + skin_;
+                        if (j != i && rsquare(pos_[j] - pos_[i]) < d * d)
+                        {
+                            nbr.push_back(j);
+                            n++;
+                        }
+                    }
+                }
+            }
         }
-        assert((*pnext).ref_num == i && "not found in the cell");
-        (*p).next = (*pnext).next;
-        (*pnext).next = NULL;
-        return pnext;
+        nbr_start_[i + 1] = n;
     }
 }
 
-// Add ith ball to the cell it should belong to.
-// IntVec should be calculated by PositionToCell to avoid error.
+// both particles of a pair have each other in their list, so that
+// each thread only updates the forces of its own particles
 
 void
-MDSand::InitCell(int i, const class IntVec & vec)
+MDSand::BuildNeighbourList()
 {
+    int i, t;
 
-    struct MDCell *p, *n;
+    SortByCell();
 
-    // I am not sure what is this for atm
-    if (RegionOut(vec))
+    nbr_start_.resize(num_particles_ + 1);
+    nbr_start_[0] = 0;
+    ParallelFor(num_particles_, &MDSand::NeighbourChunk);
+    for (i = 0; i < num_particles_; i++)
     {
-        cout << i << endl;
-        cout << sand_array_[i].pos.x << '\t' << sand_array_[i].pos.y << '\t' << sand_array_[i].
-            pos.z << endl;
-        cout << vec.x << '\t' << vec.y << '\t' << vec.z << endl;
-        cout << "error: Cell number is  is two small" << endl;
+        nbr_start_[i + 1] += nbr_start_[i];
     }
-    // after allocating memory remember to keep all of them under track
-    // to avoid memory leak
-    n = (struct MDCell *) malloc(sizeof (struct MDCell));
-    (*n).ref_num = i;
-    (*n).next = NULL;
-    p = box_cell_[CellIndexToDimOne(vec)];
-
-    if (p != NULL)
+
+    nbr_list_.resize(nbr_start_[num_particles_]);
+    vector<int>::iterator dst = nbr_list_.begin();
+    for (t = 0; t < n_threads_; t++)
     {
-        while ((*p).next != NULL)
-            p = (*p).next;
-        (*p).next = n;
+        dst = copy(thr_nbr_[t].begin(), thr_nbr_[t].end(), dst);
     }
-    else
+    assert(dst == nbr_list_.end());
+
+    pos_build_ = pos_;
+    nbr_builds_++;
+}
+
+// no pair can come into contact before a particle moved by half the skin
+
+bool
+MDSand::NeedNeighbourList() const
+{
+    double max_dr2 = 0;
+
+    for (int i = 0; i < num_particles_; i++)
     {
-        box_cell_[CellIndexToDimOne(vec)] = n;
+        max_dr2 = max(max_dr2, rsquare(pos_[i] - pos_build_[i]));
     }
-
+    return 4 * max_dr2 >= skin_ * skin_;
 }
 
 // load previously saved sand into the system. The counterpart is generate new
@@ -490,26 +496,28 @@ MDSand::LoadSand(const char *filename)
     for (i = 0; i < num_particles_; i++)
     {
         float temp;
+        id_[i] = i;
+        slot_[i] = i;
         sand.read(reinterpret_cast<char *> (&temp), sizeof (float));
-        sand_array_[i].r = temp;
+        r_[i] = temp;
         sand.read(reinterpret_cast<char *> (&temp), sizeof (float));
-        sand_array_[i].pos.x = temp;
+        pos_[i].x = temp;
         sand.read(reinterpret_cast<char *> (&temp), sizeof (float));
-        sand_array_[i].pos.y = temp;
+        pos_[i].y = temp;
         sand.read(reinterpret_cast<char *> (&temp), sizeof (float));
-        sand_array_[i].pos.z = temp;
-        if (tmp_z < sand_array_[i].pos.z + sand_array_[i].r)
+        pos_[i].z = temp;
+        if (tmp_z < pos_[i].z + r_[i])
         {
-            tmp_z = sand_array_[i].pos.z + sand_array_[i].r;
+            tmp_z = pos_[i].z + r_[i];
         }
-        sand_array_[i].m = pow((sand_array_[i].r / radius_min_), 3) * mass_min_;
+        m_[i] = pow((r_[i] / radius_min_), 3) * mass_min_;
         /*
         sand.read(reinterpret_cast<char *> (&temp), sizeof (float));
-        sand_array_[i].v.x = temp;
+        v_[i].x = temp;
         sand.read(reinterpret_cast<char *> (&temp), sizeof (float));
-        sand_array_[i].v.y = temp;
+        v_[i].y = temp;
         sand.read(reinterpret_cast<char *> (&temp), sizeof (float));
-        sand_array_[i].v.z = temp;
+        v_[i].z = temp;
         */
     }
     cout << "max height of sand surface is " << tmp_z << endl;
@@ -533,32 +541,34 @@ MDSand::GenerateSand()
 
     for (i = 0; i < num_particles_; i++)
     {
+        id_[i] = i;
+        slot_[i] = i;
         m = rand();
-        sand_array_[i].r =
+        r_[i] =
             radius_min_ + (radius_max_ - radius_min_) * static_cast<double> (m) / RAND_MAX;
-        sand_array_[i].m = pow((sand_array_[i].r / radius_min_), 3) * mass_min_;
+        m_[i] = pow((r_[i] / radius_min_), 3) * mass_min_;
         m = rand();
-        sand_array_[i].pos.x =
-            lastx + sand_array_[i].r * (1 + 0.1 * static_cast<double> (m) / RAND_MAX);
-        if (sand_array_[i].pos.x + sand_array_[i].r > inner_x_ub)
+        pos_[i].x =
+            lastx + r_[i] * (1 + 0.1 * static_cast<double> (m) / RAND_MAX);
+        if (pos_[i].x + r_[i] > inner_x_ub)
         {
-            sand_array_[i].pos.x =
-                inner_x_lb + sand_array_[i].r * (1 + 0.1 * static_cast<double> (m) / RAND_MAX);
+            pos_[i].x =
+                inner_x_lb + r_[i] * (1 + 0.1 * static_cast<double> (m) / RAND_MAX);
             lastx = inner_x_lb;
             y_row = y_row + 2 * radius_max_;
             if (y_row + 2 * radius_max_ > inner_y_ub)
             {
                 m = rand();
                 y_row =
-                    inner_y_lb + sand_array_[i].r * (1 + 0.1 * static_cast<
+                    inner_y_lb + r_[i] * (1 + 0.1 * static_cast<
                     double> (m) / RAND_MAX);
                 z_row += 2 * radius_max_;
             }
         }
-        lastx = sand_array_[i].pos.x + sand_array_[i].r;
-        sand_array_[i].pos.y = y_row + sand_array_[i].r;
-        sand_array_[i].pos.z = z_row + sand_array_[i].r;
-        sand_array_[i].v = 0;
+        lastx = pos_[i].x + r_[i];
+        pos_[i].y = y_row + r_[i];
+        pos_[i].z = z_row + r_[i];
+        v_[i] = 0;
     }
 }
 
@@ -570,19 +580,19 @@ MDSand::InteractVirtualBall(int j,
     RealVec & shapeVel,
     RealVec & shapeForce, double shapeRadius, double shapeMass)
 {
-    RealVec dr = sand_array_[j].pos - shapePos;
+    RealVec dr = pos_[j] - shapePos;
 
-    if (rsquare(dr) < (shapeRadius + sand_array_[j].r) * (shapeRadius + sand_array_[j].r))
+    if (rsquare(dr) < (shapeRadius + r_[j]) * (shapeRadius + r_[j]))
     {
         RealVec dv, vn, vs, Fn, Fs, vs_direction, normal_direction;
         double scl_vn, abs_vs, abs_Fn, abs_Fs;
         double mr, abs_dr, overlap;
 
-        mr = 1 / (1 / shapeMass + 1 / sand_array_[j].m);
+        mr = 1 / (1 / shapeMass + 1 / m_[j]);
         abs_dr = sqrt(rsquare(dr));
-        overlap = shapeRadius + sand_array_[j].r - abs_dr;
-        normal_direction = (sand_array_[j].pos - shapePos) / abs_dr;
-        dv = sand_array_[j].v - shapeVel;
+        overlap = shapeRadius + r_[j] - abs_dr;
+        normal_direction = (pos_[j] - shapePos) / abs_dr;
+        dv = v_[j] - shapeVel;
         scl_vn = dv * normal_direction;
         vn = scl_vn * normal_direction;
         vs = dv - vn;
@@ -601,7 +611,7 @@ MDSand::InteractVirtualBall(int j,
         Fn = -abs_Fn * normal_direction;
         Fs = abs_Fs * vs_direction;
         shapeForce = Fn + Fs;
-        sand_array_[j].F = sand_array_[j].F - Fn - Fs;
+        F_[j] = F_[j] - Fn - Fs;
     }
     else
     {
@@ -609,12 +619,11 @@ MDSand::InteractVirtualBall(int j,
     }
 }
 
-// let a pair of balls interact, adding the force between them to each one's
-// total force
-// always use i<j in order to correctly calculate the slip term
+// let a pair of balls interact, adding the force of ball j on ball i
+// to F and abF; the force of ball i on ball j is exactly the opposite
 
 void
-MDSand::Interact(int i, int j)
+MDSand::Interact(int i, int j, RealVec & F, double & abF) const
 {
 
     bool if_overlap = false, if_found = false, if_voc = false;
@@ -622,11 +631,11 @@ MDSand::Interact(int i, int j)
     RealVec dr_ji, dv_ji, vn, vs, Fn, Fs, vs_direction, normal_direction;
     double abs_vn, abs_vs, abs_Fn, abs_Fs, abs_Fss, mr, abs_dr, overlap;
 
-    dr_ji = sand_array_[j].pos - sand_array_[i].pos;
-    mr = 1 / (1 / sand_array_[i].m + 1 / sand_array_[j].m);
+    dr_ji = pos_[j] - pos_[i];
+    mr = 1 / (1 / m_[i] + 1 / m_[j]);
     if_overlap =
         bool (rsquare(dr_ji) <
-        (sand_array_[i].r + sand_array_[j].r) * (sand_array_[i].r + sand_array_[j].r));
+        (r_[i] + r_[j]) * (r_[i] + r_[j]));
     /*
     int k = 0;
     for (; k < max_contact_n_; k++)
@@ -682,13 +691,13 @@ MDSand::Interact(int i, int j)
     if (if_overlap)
     {
         abs_dr = sqrt(rsquare(dr_ji));
-        overlap = sand_array_[i].r + sand_array_[j].r - abs_dr;
-        normal_direction = (sand_array_[j].pos - sand_array_[i].pos) / abs_dr;
+        overlap = r_[i] + r_[j] - abs_dr;
+        normal_direction = (pos_[j] - pos_[i]) / abs_dr;
         dv_ji =
-            sand_array_[j].v - sand_array_[i].v;// +
-            // CrossProduct(sand_array_[j].omega,
-            // -1.0 * dr_ji * sand_array_[j].r / abs_dr) -
-            // CrossProduct(sand_array_[i].omega, 1.0 * dr_ji * sand_array_[i].r / abs_dr);
+            v_[j] - v_[i];// +
+            // CrossProduct(omega_[j],
+            // -1.0 * dr_ji * r_[j] / abs_dr) -
+            // CrossProduct(omega_[i], 1.0 * dr_ji * r_[i] / abs_dr);
         abs_vn = dv_ji * normal_direction;
         vn = abs_vn * normal_direction;
         vs = dv_ji - vn;
@@ -772,18 +781,14 @@ MDSand::Interact(int i, int j)
         abs_Fs = mu_pp_ * abs_Fn;
         Fn = -abs_Fn * normal_direction;
         Fs = abs_Fs * vs_direction;
-        sand_array_[i].F = sand_array_[i].F + Fn + Fs;
-        sand_array_[i].abF = sand_array_[i].abF + abs(abs_Fn);
-        //sand_array_[i].moment =
-        //    sand_array_[i].moment + CrossProduct(dr_ji * sand_array_[i].r / abs_dr, Fs);
-        sand_array_[j].F = sand_array_[j].F - Fn - Fs;
-        sand_array_[j].abF = sand_array_[j].abF + abs(abs_Fn);
-        //sand_array_[j].moment =
-        //    sand_array_[j].moment + CrossProduct(dr_ji * sand_array_[j].r / abs_dr, Fs);
+        F = F + Fn + Fs;
+        abF = abF + abs(abs_Fn);
+        //moment_[i] =
+        //    moment_[i] + CrossProduct(dr_ji * r_[i] / abs_dr, Fs);
         if (isnan(abs_Fn))
         {
-            cout << sand_array_[i].pos.x << "\t" << sand_array_[i].pos.y << "\t" << sand_array_[i].pos.z << "\n";
-            cout << sand_array_[j].pos.x << "\t" << sand_array_[j].pos.y << "\t" << sand_array_[j].pos.z << "\n";
+            cout << pos_[i].x << "\t" << pos_[i].y << "\t" << pos_[i].z << "\n";
+            cout << pos_[j].x << "\t" << pos_[j].y << "\t" << pos_[j].z << "\n";
             assert(!isnan(abs_Fn) && "Large Overlap");
         }
     }
@@ -814,32 +819,35 @@ MDSand::OutputState()
     para_file_.write(reinterpret_cast<char *> (&temp), sizeof (float));
     int count = 0;
 
-    for (int i = 0; i < num_particles_; i++)
+    // in the original order of the particles
+    for (int k = 0; k < num_particles_; k++)
     {
-        if (sand_array_[i].remove == 1)
+        int i = slot_[k];
+
+        if (remove_[i] == 1)
         {
             count++;
             continue;
         }
-        temp = (sand_array_[i].pos.x);
+        temp = (pos_[i].x);
         para_file_.write(reinterpret_cast<char *> (&temp), sizeof (double));
 
-        temp = (sand_array_[i].pos.y);
+        temp = (pos_[i].y);
         para_file_.write(reinterpret_cast<char *> (&temp), sizeof (double));
 
-        temp = (sand_array_[i].pos.z);
+        temp = (pos_[i].z);
         para_file_.write(reinterpret_cast<char *> (&temp), sizeof (double));
 
-        temp = (sand_array_[i].r);
+        temp = (r_[i]);
         para_file_.write(reinterpret_cast<char *> (&temp), sizeof (double));
 
-        temp = (sand_array_[i].v.x);
+        temp = (v_[i].x);
         para_file_.write(reinterpret_cast<char *> (&temp), sizeof (double));
 
-        temp = (sand_array_[i].v.y);
+        temp = (v_[i].y);
         para_file_.write(reinterpret_cast<char *> (&temp), sizeof (double));
 
-        temp = (sand_array_[i].v.z);
+        temp = (v_[i].z);
         para_file_.write(reinterpret_cast<char *> (&temp), sizeof (double));
     }
     para_file_.close();
@@ -857,23 +865,26 @@ MDSand::OutputFile()
         sand_file_.write(reinterpret_cast<char *> (&temp), sizeof (float));
         int count = 0;
 
-        for (int i = 0; i < num_particles_; i++)
+        // in the original order of the particles
+        for (int k = 0; k < num_particles_; k++)
         {
-            if (sand_array_[i].remove == 1)
+            int i = slot_[k];
+
+            if (remove_[i] == 1)
             {
                 count++;
                 continue;
             }
-            temp = float (sand_array_[i].r);
+            temp = float (r_[i]);
             sand_file_.write(reinterpret_cast<char *> (&temp), sizeof (float));
-            temp = float (sand_array_[i].pos.x);
+            temp = float (pos_[i].x);
             sand_file_.write(reinterpret_cast<char *> (&temp), sizeof (float));
-            temp = float (sand_array_[i].pos.y);
+            temp = float (pos_[i].y);
             sand_file_.write(reinterpret_cast<char *> (&temp), sizeof (float));
-            temp = float (sand_array_[i].pos.z);
+            temp = float (pos_[i].z);
             sand_file_.write(reinterpret_cast<char *> (&temp), sizeof (float));
-            //temp = float (sqrt(sand_array_[i].v * sand_array_[i].v));
-            //temp = float (sand_array_[i].abF);
+            //temp = float (sqrt(v_[i] * v_[i]));
+            //temp = float (abF_[i]);
             //sand_file_.write(reinterpret_cast<char *> (&temp), sizeof (float));
         }
         sand_file_.flush();
@@ -889,71 +900,105 @@ MDSand::OutputFile()
     }
 }
 
+// interaction of particles first to last - 1 with the current shape;
+// each thread accumulates its own share of the shape force and moment
+
 void
-MDSand::InteractExt(const MDShapeParser & shape_parser)
+MDSand::InteractExtChunk(int first, int last, int t)
 {
     bool collision;
     RealVec shape_force, shape_moment, virtual_pos, virtual_vel;
-    RealVec tmp_force, tmp_pos, tmp_moment;
-    double shape_mass, virtual_radius;
+    RealVec tmp_force, tmp_moment;
+    double virtual_radius;
+
+    shape_force = 0;
+    shape_moment = 0;
+    thr_inside_[t] = 0;
+    for (int i = first; i < last; i++)
+    {
+        bool if_inside = 0;
+
+        collision =
+            ext_shape_->GetSurfGeo(pos_[i],
+            r_[i],
+            virtual_pos,
+            virtual_vel, virtual_radius, if_inside);
+        if (if_inside == 1)
+        {
+            // some particles inside the shape
+#if MD_GEN_SAND == 1
+            remove_[i] = 1;
+#else
+            thr_inside_[t] = 1;
+#endif
+        }
+        if (if_inside == 0 && collision)
+        {
+            tmp_force = 0;
+            InteractVirtualBall(i, virtual_pos, virtual_vel, tmp_force,
+                virtual_radius, ext_mass_);
+            shape_force = shape_force + tmp_force;
+            tmp_moment = CrossProduct(virtual_pos - ext_pos_, tmp_force);
+            shape_moment = shape_moment + tmp_moment;
+            /*
+             * if (sqrt(tmp_force * tmp_force) > 1e5) { cout << r_[i] << endl; cout << pos_[i].x
+             * <<"\t"<< pos_[i].y <<"\t"<< pos_[i].z << endl; cout << v_[i].x <<"\t"<<
+             * v_[i].y <<"\t"<< v_[i].z << endl; cout << virtual_pos.x <<"\t"<< virtual_pos.y <<"\t"<<
+             * virtual_pos.z << endl; cout << virtual_vel.x <<"\t"<< virtual_vel.y <<"\t"<< virtual_vel.z << endl; cout <<
+             * ext_pos_.x <<"\t"<< ext_pos_.y <<"\t"<< ext_pos_.z << endl; exit(0); }
+             */
+#if MD_GEN_SAND == 1
+            if (sqrt(tmp_force * tmp_force) > 1e-8)
+            {
+                remove_[i] = 1;
+            }
+#endif
+        }
+    }
+    thr_force_[t] = shape_force;
+    thr_moment_[t] = shape_moment;
+}
+
+void
+MDSand::InteractExt(const MDShapeParser & shape_parser)
+{
+    RealVec shape_force, shape_moment;
 
     for (int inode = 0; inode < shape_parser.n; inode++)
     {
-        shape_parser.pshape[inode]->GetNodeMass(shape_mass);
-        shape_parser.pshape[inode]->GetNodePosition(tmp_pos);
+        ext_shape_ = shape_parser.pshape[inode];
+        ext_shape_->GetNodeMass(ext_mass_);
+        ext_shape_->GetNodePosition(ext_pos_);
+        for (int t = 0; t < n_threads_; t++)
+        {
+            thr_force_[t] = 0;
+            thr_moment_[t] = 0;
+            thr_inside_[t] = 0;
+        }
+        ParallelFor(num_particles_, &MDSand::InteractExtChunk);
+        // sum in thread order, so that the result does not depend on timing
         shape_force = 0;
         shape_moment = 0;
-        for (int i = 0; i < num_particles_; i++)
+        for (int t = 0; t < n_threads_; t++)
         {
-            bool if_inside = 0;
-
-            collision =
-                shape_parser.pshape[inode]->GetSurfGeo(sand_array_[i].pos,
-                sand_array_[i].r,
-                virtual_pos,
-                virtual_vel, virtual_radius, if_inside);
-            if (if_inside == 1)
+            if (thr_inside_[t])
             {
-                // some particles inside the shape
-#if MD_GEN_SAND == 1
-                sand_array_[i].remove = 1;
-#else
                 OutputState();
                 assert(0 && (cout << "particles inside shape!" << endl));
-#endif
-            }
-            if (if_inside == 0 && collision)
-            {
-                tmp_force = 0;
-                InteractVirtualBall(i, virtual_pos, virtual_vel, tmp_force,
-                    virtual_radius, shape_mass);
-                shape_force = shape_force + tmp_force;
-                tmp_moment = CrossProduct(virtual_pos - tmp_pos, tmp_force);
-                shape_moment = shape_moment + tmp_moment;
-                /*
-                 * if (sqrt(tmp_force * tmp_force) > 1e5) { cout << sand_array_[i].r << endl; cout << sand_array_[i].pos.x
-                 * <<"\t"<< sand_array_[i].pos.y <<"\t"<< sand_array_[i].pos.z << endl; cout << sand_array_[i].v.x <<"\t"<<
-                 * sand_array_[i].v.y <<"\t"<< sand_array_[i].v.z << endl; cout << virtual_pos.x <<"\t"<< virtual_pos.y <<"\t"<<
-                 * virtual_pos.z << endl; cout << virtual_vel.x <<"\t"<< virtual_vel.y <<"\t"<< virtual_vel.z << endl; cout <<
-                 * tmp_pos.x <<"\t"<< tmp_pos.y <<"\t"<< tmp_pos.z << endl; exit(0); }
-                 */
-#if MD_GEN_SAND == 1
-                if (sqrt(tmp_force * tmp_force) > 1e-8)
-                {
-                    sand_array_[i].remove = 1;
-                }
-#endif
             }
+            shape_force = shape_force + thr_force_[t];
+            shape_moment = shape_moment + thr_moment_[t];
         }
         // if(shape_force.y!=0) {
         // cout << shape_force.y << endl;
         // cout << sys_step_ << endl;
-        // cout << tmp_pos.y << endl;
+        // cout << ext_pos_.y << endl;
         // assert(0);
         // }
-        shape_parser.pshape[inode]->SetNodeForce(shape_force);
-        shape_parser.pshape[inode]->SetNodeMoment(shape_moment);
+        ext_shape_->SetNodeForce(shape_force);
+        ext_shape_->SetNodeMoment(shape_moment);
     }
+    ext_shape_ = NULL;
 }
 
 void
@@ -975,76 +1020,41 @@ MDSand::ExForce()
     //    }
 }
 
-/*
- * run the system for one time step , update the force on each sand ball
- */
+// sum the forces of the neighbours on particles first to last - 1;
+// each thread only writes the forces of its own particles
+
 void
-MDSand::RunOneStep()
+MDSand::ForceChunk(int first, int last, int t)
 {
-
-    int i, k;
-    IntVec ci, cu;
-    MDCell *pair1, *pair2;
-
-    // this part is to calculate the transition of particles between cells
-    for (i = 0; i < cell_num_x_ * cell_num_y_ * cell_num_z_; i++)
+    for (int i = first; i < last; i++)
     {
-        pair1 = box_cell_[i];
-        CellIndexToDim23(i, ci);
-        while (pair1 != NULL)
-        {
-            int tempnum;
+        RealVec F = F_[i];
+        double abF = abF_[i];
 
-            tempnum = (*pair1).ref_num;
-            PositionToCell(sand_array_[tempnum].pos, cu);
-            if (!equal(ci, cu))
-            {
-                TransCell(tempnum, ci, cu);
-                pair1 = box_cell_[i];
-                continue;
-            }
-            pair1 = (*pair1).next;
+        for (int k = nbr_start_[i]; k < nbr_start_[i + 1]; k++)
+        {
+            Interact(i, nbr_list_[k], F, abF);
         }
+        F_[i] = F;
+        abF_[i] = abF;
     }
+}
 
-    // now calculate the interaction pairs
-    for (i = 0; i < cell_num_x_ * cell_num_y_ * cell_num_z_; i++)
-        // for (ci = 0; !BoundaryEnd(ci); ++ci)
+/*
+ * run the system for one time step , update the force on each sand ball
+ */
+void
+MDSand::RunOneStep()
+{
+    // re-sort the particles and rebuild the neighbour list
+    // only when some particle might have moved out of the skin
+    if (NeedNeighbourList())
     {
-        pair1 = box_cell_[i];
-        CellIndexToDim23(i, ci);
-        while (pair1 != NULL)
-        {
-            for (k = 0; k < MD_N_NBR; k++)
-            {
-                cu = ci + md_cell_nbr_[k];
-                // jump when it is out of boundary
-                if (RegionOut(cu))
-                    continue;
-                pair2 = box_cell_[CellIndexToDimOne(cu)];
-                while (pair2 != NULL)
-                {
-                    // k==0 means the original cell(same cell) so we want
-                    // pnumB > pnumA to avoid repeated pair
-                    if ((k == 0 && (*pair1).ref_num < (*pair2).ref_num) || k != 0)
-                    {
-                        if ((*pair1).ref_num < (*pair2).ref_num)
-                        {
-                            Interact((*pair1).ref_num, (*pair2).ref_num);
-                        }
-                        else
-                        {
-                            Interact((*pair2).ref_num, (*pair1).ref_num);
-                        }
-                    }
-                    pair2 = (*pair2).next;
-                }
-            }
-            pair1 = (*pair1).next;
-        }
-
+        BuildNeighbourList();
     }
 
+    // now calculate the interaction pairs
+    ParallelFor(num_particles_, &MDSand::ForceChunk);
 }
 
 void
@@ -1091,137 +1101,137 @@ MDSand::BoundaryCondition(unsigned int controlnumber)
             // sandDisk[i].Fy += Fn;
             // }
             // "sticky" wall condition:
-            if (sand_array_[i].pos.x + sand_array_[i].r > box_length_x_)
+            if (pos_[i].x + r_[i] > box_length_x_)
             {
-                sand_array_[i].pos.x = box_length_x_ - sand_array_[i].r;
+                pos_[i].x = box_length_x_ - r_[i];
                 sys_dissip_energy_ =
                     sys_dissip_energy_ +
-                    0.5 * sand_array_[i].m * (sand_array_[i].v.x * sand_array_[i].v.x);
-                sand_array_[i].v.x = 0;
+                    0.5 * m_[i] * (v_[i].x * v_[i].x);
+                v_[i].x = 0;
             }
-            if (sand_array_[i].pos.x - sand_array_[i].r < 0)
+            if (pos_[i].x - r_[i] < 0)
             {
-                sand_array_[i].pos.x = sand_array_[i].r;
+                pos_[i].x = r_[i];
                 sys_dissip_energy_ =
                     sys_dissip_energy_ +
-                    0.5 * sand_array_[i].m * (sand_array_[i].v.x * sand_array_[i].v.x);
-                sand_array_[i].v.x = 0;
+                    0.5 * m_[i] * (v_[i].x * v_[i].x);
+                v_[i].x = 0;
             }
-            if (sand_array_[i].pos.y - sand_array_[i].r < 0)
+            if (pos_[i].y - r_[i] < 0)
             {
-                sand_array_[i].pos.y = sand_array_[i].r;
+                pos_[i].y = r_[i];
                 sys_dissip_energy_ =
                     sys_dissip_energy_ +
-                    0.5 * sand_array_[i].m * (sand_array_[i].v.y * sand_array_[i].v.y);
-                sand_array_[i].v.y = 0;
+                    0.5 * m_[i] * (v_[i].y * v_[i].y);
+                v_[i].y = 0;
             }
-            if (sand_array_[i].pos.y + sand_array_[i].r > box_length_y_)
+            if (pos_[i].y + r_[i] > box_length_y_)
             {
-                sand_array_[i].pos.y = box_length_y_ - sand_array_[i].r;
+                pos_[i].y = box_length_y_ - r_[i];
                 sys_dissip_energy_ =
                     sys_dissip_energy_ +
-                    0.5 * sand_array_[i].m * (sand_array_[i].v.y * sand_array_[i].v.y);
-                sand_array_[i].v.y = 0;
+                    0.5 * m_[i] * (v_[i].y * v_[i].y);
+                v_[i].y = 0;
             }
-            if (sand_array_[i].pos.z - sand_array_[i].r < 0)
+            if (pos_[i].z - r_[i] < 0)
             {
-                sand_array_[i].pos.z = sand_array_[i].r;
+                pos_[i].z = r_[i];
                 sys_dissip_energy_ =
                     sys_dissip_energy_ +
-                    0.5 * sand_array_[i].m * (sand_array_[i].v.z * sand_array_[i].v.z);
-                sand_array_[i].v.z = 0;
+                    0.5 * m_[i] * (v_[i].z * v_[i].z);
+                v_[i].z = 0;
             }
-            if (sand_array_[i].pos.z + sand_array_[i].r > box_length_z_)
+            if (pos_[i].z + r_[i] > box_length_z_)
             {
-                sand_array_[i].pos.z = box_length_z_ - sand_array_[i].r;
+                pos_[i].z = box_length_z_ - r_[i];
                 sys_dissip_energy_ =
                     sys_dissip_energy_ +
-                    0.5 * sand_array_[i].m * (sand_array_[i].v.z * sand_array_[i].v.z);
-                sand_array_[i].v.z = 0;
+                    0.5 * m_[i] * (v_[i].z * v_[i].z);
+                v_[i].z = 0;
             }
             sys_kinematic_energy_ =
                 sys_kinematic_energy_ +
-                0.5 * sand_array_[i].m * (sand_array_[i].v * sand_array_[i].v);
+                0.5 * m_[i] * (v_[i] * v_[i]);
             sys_potential_Energy_ =
-                sys_potential_Energy_ + sand_array_[i].m * GRAVITY * sand_array_[i].pos.z;
+                sys_potential_Energy_ + m_[i] * GRAVITY * pos_[i].z;
         }
     }
     //    if (controlnumber == 1)
     //    {
     //        for (i = 0; i < num_particles_; i++)
     //        {
-    //            if (sand_array_[i].pos.z - sand_array_[i].r < 0)
+    //            if (pos_[i].z - r_[i] < 0)
     //            {
-    //                sand_array_[i].pos.z = sand_array_[i].r;
-    //                sand_array_[i].v.z = 0;
+    //                pos_[i].z = r_[i];
+    //                v_[i].z = 0;
     //            }
-    //            if (sand_array_[i].pos.z + sand_array_[i].r > box_length_z_)
+    //            if (pos_[i].z + r_[i] > box_length_z_)
     //            {
-    //                sand_array_[i].pos.z = box_length_z_ - sand_array_[i].r;
-    //                sand_array_[i].v.z = 0;
+    //                pos_[i].z = box_length_z_ - r_[i];
+    //                v_[i].z = 0;
     //            }
     //            double
     //                rho =
-    //                sqrt ((sand_array_[i].pos.x -
-    //                       3) * (sand_array_[i].pos.x - 3) +
-    //                      (sand_array_[i].pos.y - 3) * (sand_array_[i].pos.y - 3));
+    //                sqrt ((pos_[i].x -
+    //                       3) * (pos_[i].x - 3) +
+    //                      (pos_[i].y - 3) * (pos_[i].y - 3));
     //            RealVec dr;
     //
-    //            if (rho + sand_array_[i].r > 3)
+    //            if (rho + r_[i] > 3)
     //            {
-    //                sand_array_[i].pos.x =
-    //                    3 + (sand_array_[i].pos.x - 3) * (3 - sand_array_[i].r) / rho;
-    //                sand_array_[i].pos.y =
-    //                    3 + (sand_array_[i].pos.y - 3) * (3 - sand_array_[i].r) / rho;
-    //                dr.x = sand_array_[i].pos.x - 3;
+    //                pos_[i].x =
+    //                    3 + (pos_[i].x - 3) * (3 - r_[i]) / rho;
+    //                pos_[i].y =
+    //                    3 + (pos_[i].y - 3) * (3 - r_[i]) / rho;
+    //                dr.x = pos_[i].x - 3;
     //                dr.z = 0;
-    //                dr.y = sand_array_[i].pos.y - 3;
-    //                sand_array_[i].v = sand_array_[i].v - dr * (sand_array_[i].v * dr) / (rho * rho);
+    //                dr.y = pos_[i].y - 3;
+    //                v_[i] = v_[i] - dr * (v_[i] * dr) / (rho * rho);
     //            }
-    //            if (sand_array_[i].pos.z > 3.5 && sand_array_[i].pos.z < 6 + 0.4142 * sand_array_[i].r)
+    //            if (pos_[i].z > 3.5 && pos_[i].z < 6 + 0.4142 * r_[i])
     //            {
-    //                double tmpr = sand_array_[i].pos.z - 3;
+    //                double tmpr = pos_[i].z - 3;
     //
     //                if (rho < tmpr)
     //                {
-    //                    if (rho + sand_array_[i].r * 1.4142 > tmpr)
+    //                    if (rho + r_[i] * 1.4142 > tmpr)
     //                    {
-    //                        sand_array_[i].pos.x =
-    //                            3 + (sand_array_[i].pos.x - 3) * (tmpr -
-    //                                                              1.4142 * sand_array_[i].r) / rho;
-    //                        sand_array_[i].pos.y =
-    //                            3 + (sand_array_[i].pos.y - 3) * (tmpr -
-    //                                                              1.4142 * sand_array_[i].r) / rho;
-    //                        dr.x = sand_array_[i].pos.x - 3;
-    //                        dr.z = -(tmpr - 1.4142 * sand_array_[i].r);
-    //                        dr.y = sand_array_[i].pos.y - 3;
-    //                        sand_array_[i].v =
-    //                            sand_array_[i].v - dr * (sand_array_[i].v * dr) / (rho * rho * 2);
+    //                        pos_[i].x =
+    //                            3 + (pos_[i].x - 3) * (tmpr -
+    //                                                              1.4142 * r_[i]) / rho;
+    //                        pos_[i].y =
+    //                            3 + (pos_[i].y - 3) * (tmpr -
+    //                                                              1.4142 * r_[i]) / rho;
+    //                        dr.x = pos_[i].x - 3;
+    //                        dr.z = -(tmpr - 1.4142 * r_[i]);
+    //                        dr.y = pos_[i].y - 3;
+    //                        v_[i] =
+    //                            v_[i] - dr * (v_[i] * dr) / (rho * rho * 2);
     //                    }
     //                }
     //                else
     //                {
-    //                    if (rho - sand_array_[i].r * 1.4142 < tmpr)
+    //                    if (rho - r_[i] * 1.4142 < tmpr)
     //                    {
-    //                        sand_array_[i].pos.x =
-    //                            3 + (sand_array_[i].pos.x - 3) * (tmpr +
-    //                                                              1.4142 * sand_array_[i].r) / rho;
-    //                        sand_array_[i].pos.y =
-    //                            3 + (sand_array_[i].pos.y - 3) * (tmpr +
-    //                                                              1.4142 * sand_array_[i].r) / rho;
-    //                        dr.x = sand_array_[i].pos.x - 3;
-    //                        dr.z = -(tmpr + 1.4142 * sand_array_[i].r);
-    //                        dr.y = sand_array_[i].pos.y - 3;
-    //                        sand_array_[i].v =
-    //                            sand_array_[i].v - dr * (sand_array_[i].v * dr) / (rho * rho * 2);
+    //                        pos_[i].x =
+    //                            3 + (pos_[i].x - 3) * (tmpr +
+    //                                                              1.4142 * r_[i]) / rho;
+    //                        pos_[i].y =
+    //                            3 + (pos_[i].y - 3) * (tmpr +
+    //                                                              1.4142 * r_[i]) / rho;
+    //                        dr.x = pos_[i].x - 3;
+    //                        dr.z = -(tmpr + 1.4142 * r_[i]);
+    //                        dr.y = pos_[i].y - 3;
+    //                        v_[i] =
+    //                            v_[i] - dr * (v_[i] * dr) / (rho * rho * 2);
     //                    }
     //                }
     //            }
     //            sys_kinematic_energy_ =
     //                sys_kinematic_energy_ +
-    //                0.5 * sand_array_[i].m * (sand_array_[i].v * sand_array_[i].v);
+    //                0.5 * m_[i] * (v_[i] * v_[i]);
     //            sys_potential_Energy_ =
-    //                sys_potential_Energy_ + sand_array_[i].m * GRAVITY * sand_array_[i].pos.z;
+    //                sys_potential_Energy_ + m_[i] * GRAVITY * pos_[i].z;
     //        }
     //    }
 }
@@ -1229,17 +1239,7 @@ MDSand::BoundaryCondition(unsigned int controlnumber)
 void
 MDSand::Integration()
 {
-    int i = 0;
-
-    for (i = 0; i < num_particles_; i++)
-    {
-        //sand_array_[i].omega = sand_array_[i].omega + step_tau_
-        //    * sand_array_[i].moment / (0.4 * sand_array_[i].m *
-        //    sand_array_[i].r * sand_array_[i].r);
-        sand_array_[i].F = sand_array_[i].F + sand_array_[i].m * gravity_vector;
-        sand_array_[i].v = sand_array_[i].v + step_tau_ * sand_array_[i].F / sand_array_[i].m;
-        sand_array_[i].pos = sand_array_[i].pos + sand_array_[i].v * step_tau_;
-    }
+    ParallelFor(num_particles_, &MDSand::IntegrationChunk);
     /*
      * MDSlipDisp* pslip, *previous; for (i = 0; i < MD_CELL_NUM_X * MD_CELL_NUM_Y * MD_CELL_NUM_Z; i++) { pslip =
      * slip_array_[i]; previous = pslip; while (pslip != NULL) { pslip->disp = pslip->disp + pslip->ddisp * step_tau_; previous =
@@ -1247,6 +1247,20 @@ MDSand::Integration()
      */
 }
 
+void
+MDSand::IntegrationChunk(int first, int last, int t)
+{
+    for (int i = first; i < last; i++)
+    {
+        //omega_[i] = omega_[i] + step_tau_
+        //    * moment_[i] / (0.4 * m_[i] *
+        //    r_[i] * r_[i]);
+        F_[i] = F_[i] + m_[i] * gravity_vector;
+        v_[i] = v_[i] + step_tau_ * F_[i] / m_[i];
+        pos_[i] = pos_[i] + v_[i] * step_tau_;
+    }
+}
+
 void
 MDSand::Run(int timeSteps, const MDShapeParser & shape_parser, bool flag)
 {
@@ -1260,9 +1274,8 @@ MDSand::Run(int timeSteps, const MDShapeParser & shape_parser, bool flag)
         // clear the force on all the sand objects, to re-calculate
         for (i = 0; i < num_particles_; i++)
         {
-            sand_array_[i].F = 0;
-            sand_array_[i].moment = 0;
-            sand_array_[i].abF = 0;
+            F_[i] = 0;
+            abF_[i] = 0;
         }
         /*
          * run the system for one time step tau, update the force on each sand ball; If flag is set to true, also update the
@@ -1296,23 +1309,4 @@ MDSand::Run(int timeSteps, const MDShapeParser & shape_parser, bool flag)
 
 MDSand::~MDSand()
 {
-    MDCell *pointa, *pointb;
-
-    for (int i = 0; i < cell_num_x_ * cell_num_y_ * cell_num_z_; i++)
-    {
-        pointa = box_cell_[i];
-        while (pointa != NULL)
-        {
-            pointb = (*pointa).next;
-            free(pointa);
-            pointa = pointb;
-        }
-    }
-    delete[]sand_array_;
-    delete[]box_cell_;
-    delete[]md_cell_nbr_;
-    for (int i = 0; i < num_particles_; i++) {
-	    delete slip_array_[i];
-    }
-    delete[]slip_array_;
 }
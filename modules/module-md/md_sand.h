@@ -5,29 +5,17 @@
  * Created on January 14, 2011, 1:42 PM
  */
 #include "md_header.h"
+#include "md_vec.h"
 #include <vector>
 #include <iostream>
 #include <fstream>
+#include "workerpool.h"
 
 #ifndef _MDSAND_H
 #define	_MDSAND_H
 
 
-#if MD_DIM == 2
-#define MD_OFFSET_VALS                                          \
-   {{0,0}, {1,0}, {1,1}, {0,1}, {-1,1}}
-#define MD_N_NBR  5
-#endif
-
-#define MD_OFFSET_VALS                                          \
-   { {0,0,0}, {1,0,0}, {1,1,0}, {0,1,0}, {-1,1,0},              \
-     {0,0,1}, {1,0,1}, {1,1,1}, {0,1,1}, {-1,1,1}, {-1,0,1},    \
-     {-1,-1,1}, {0,-1,1}, {1,-1,1}                              \
-   }
-#define MD_N_NBR 14
-
 struct MDDisk;
-struct MDSlip;
 
 struct MDShapeParser
 {
@@ -35,14 +23,6 @@ struct MDShapeParser
     int n;
 };
 
-//the cell, a chain structure, ref_num stores which ball is in this cell
-
-struct MDCell
-{
-    int ref_num;
-    MDCell *next;
-};
-
 class MDRegion
 {
 private:
@@ -64,9 +44,41 @@ class MDSand
 {
 private:
     int n_boulder_;
-    MDDisk *sand_array_;
-    MDSlip **slip_array_;
-    MDCell **box_cell_;
+    // particle data, stored as one array per field in cell order;
+    // id_[i] is the original index of the particle in slot i,
+    // slot_[k] the slot of the particle with original index k
+    std::vector<int> id_;
+    std::vector<int> slot_;
+    std::vector<RealVec> pos_;
+    std::vector<RealVec> v_;
+    std::vector<RealVec> F_;
+    std::vector<double> r_;
+    std::vector<double> m_;
+    std::vector<double> abF_;
+    std::vector<char> remove_;
+    // cell list: the particles in cell c are in slots
+    // cell_start_[c] to cell_start_[c + 1] - 1
+    std::vector<int> cell_start_;
+    // Verlet list: the neighbours of the particle in slot i are
+    // nbr_list_[nbr_start_[i]] to nbr_list_[nbr_start_[i + 1] - 1];
+    // the list is rebuilt when a particle moved by more than half the skin
+    std::vector<int> nbr_start_;
+    std::vector<int> nbr_list_;
+    std::vector<RealVec> pos_build_;
+    double skin_;
+    int nbr_builds_;
+    // threads and their scratch data
+    int n_threads_;
+    std::vector<std::vector<int> > thr_nbr_;
+    std::vector<RealVec> thr_force_;
+    std::vector<RealVec> thr_moment_;
+    std::vector<char> thr_inside_;
+    // worker t runs chunk t + 1 of the current job, the caller chunk 0;
+    // Init() sets the number of workers, the first job starts them
+    WorkerPool pool_;
+    class MDShape *ext_shape_;
+    double ext_mass_;
+    RealVec ext_pos_;
     double sys_energy_;
     double sys_kinematic_energy_;
     double sys_potential_Energy_;
@@ -98,7 +110,6 @@ private:
     //---------------------
     bool if_output_;
     int boundary_para_;
-    int max_contact_n_;
     int num_particles_;
     int cell_num_x_;
     int cell_num_y_;
@@ -106,24 +117,31 @@ private:
     std::ofstream sand_file_;
     std::ofstream para_file_;
     std::ofstream energy_file_;
-    class IntVec * md_cell_nbr_;
+    void InitCellGeometry();
+    void ParallelFor(int, void (MDSand::*)(int, int, int));
+    void SortByCell();
+    void BuildNeighbourList();
+    bool NeedNeighbourList() const;
+    void NeighbourChunk(int, int, int);
+    void ForceChunk(int, int, int);
+    void InteractExtChunk(int, int, int);
+    void IntegrationChunk(int, int, int);
 public:
     MDSand(const MDSand&);
     MDSand(double, double, double, int);
     ~MDSand();
     MDSand& operator=(const MDSand&);
+    void SetThreads(int);
+    void SetSkin(double);
     void Init();
-    void Interact(int, int);
+    void Interact(int, int, class RealVec &, double &) const;
     void Run(int, const MDShapeParser &, bool);
-    int TransCell(int, const class IntVec &, const class IntVec &);
-    MDCell *RemovefromCell(int, const class IntVec &);
-    void InitCell(int, const class IntVec &);
     void LoadSand();
     void LoadSand(const char *);
     void InteractVirtualBall(int, class RealVec &, class RealVec &, class RealVec &, double,
                              double);
     void InteractExt(const MDShapeParser &);
-    void PositionToCell(class RealVec &, class IntVec &);
+    void PositionToCell(const class RealVec &, class IntVec &);
     void GenerateSand();
     void ExForce();
     void RunOneStep();
@@ -340,6 +340,28 @@ m_iCouplingCounter(0)
 		m_data.m_fileBallName = "force.txt";
 	}
 
+	if (HP.IsKeyWord("threads")) {
+		// 0: one per available core
+		int iThreads = HP.GetInt();
+		if (iThreads < 0) {
+			silent_cerr("MBDynMD(" << uLabel << "): invalid threads number " << iThreads
+				<< " at line " << HP.GetLineData() << std::endl);
+			throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+		}
+		m_data.m_sandbox.SetThreads(iThreads);
+	}
+
+	if (HP.IsKeyWord("skin")) {
+		// neighbour list skin distance
+		doublereal dSkin = HP.GetReal();
+		if (dSkin < 0.) {
+			silent_cerr("MBDynMD(" << uLabel << "): invalid skin " << dSkin
+				<< " at line " << HP.GetLineData() << std::endl);
+			throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+		}
+		m_data.m_sandbox.SetSkin(dSkin);
+	}
+
 	int n = HP.GetInt();
 	if (n <= 0) {
 		silent_cerr("MBDynMD(" << uLabel << "): invalid node number " << n
@@ -38,9 +38,11 @@
   in the GNU Public License version 2.1
 */
 
+#include <algorithm>
 #include <array>
 #include <functional>
 #include <limits>
+#include <map>
 #include <memory>
 #include <unordered_map>
 #include <utility>
@@ -134,6 +136,49 @@ private:
      sp_grad::SpColVectorA<doublereal, 2> zPrev, zCurr, zPPrev, zPCurr;
 };
 
+// Bounding volume hierarchy of the bounding spheres of the target faces,
+// in the reference frame of the target node. Since the target mesh is rigid,
+// it is built once, and it is shared by all elements of the same model
+// with the same mesh.
+class TriangularContactSearchTree
+{
+public:
+     TriangularContactSearchTree(std::vector<Vec3>&& rgCenter,
+				 std::vector<doublereal>&& rgRadius);
+
+     // Append the indices of all faces whose bounding sphere
+     // is closer than dRadius to X
+     void Query(const Vec3& X, doublereal dRadius, std::vector<integer>& rgFaces) const;
+
+     static std::shared_ptr<const TriangularContactSearchTree>
+     Get(const DataManager* pDM, std::vector<Vec3>&& rgCenter, std::vector<doublereal>&& rgRadius);
+
+     // Drop the trees of pDM no longer used by any element
+     static void Release(const DataManager* pDM);
+
+private:
+     struct TreeNode {
+	  Vec3 xmin, xmax;
+	  integer iFirst, iLast;
+	  integer iLeft, iRight;
+     };
+
+     integer Build(integer iFirst, integer iLast);
+
+     static constexpr integer iMaxLeafSize = 4;
+     static constexpr integer iMaxDepth = 64;
+
+     const std::vector<Vec3> rgCenter;
+     const std::vector<doublereal> rgRadius;
+     std::vector<integer> rgFaceIdx;
+     std::vector<TreeNode> rgTree;
+
+     typedef std::vector<std::weak_ptr<const TriangularContactSearchTree> > SharedTrees;
+
+     // one registry for each DataManager, removed with its last element
+     static std::map<const DataManager*, SharedTrees> rgShared;
+};
+
 class TriangularContact: virtual public Elem, public UserDefinedElem
 {
 public:
@@ -263,10 +308,19 @@ private:
 	  const std::vector<ContactVertex> rgVertices;
 	  std::unique_ptr<DriveCaller> dr;
 	  std::unordered_map<TargetFace*, ContactPair> rgContCurr, rgContPrev;
+
+	  // candidate faces, valid as long as no vertex moved
+	  // by more than dSearchSkin since they were collected
+	  std::vector<integer> rgCandidates;
+	  std::vector<Vec3> rgSearchPos;
+	  std::vector<doublereal> rgSearchRad;
+	  bool bCandidatesValid;
      };
 
      void ContactSearch();
 
+     void UpdateCandidates(ContactNode& rNode, const std::vector<Vec3>& rgPos, const std::vector<doublereal>& rgRad);
+
      doublereal GetContactForce(doublereal dz) const;
 
      sp_grad::SpGradient GetContactForce(const sp_grad::SpGradient& dz) const;
@@ -284,6 +338,8 @@ private:
      std::vector<ContactNode> rgContactMesh;
      const StructNodeAd* pTargetNode;
      doublereal dSearchRadius;
+     doublereal dSearchSkin;
+     std::shared_ptr<const TriangularContactSearchTree> pSearchTree;
      const DifferentiableScalarFunction* pCL;
      const DataManager* const pDM;
      doublereal tCurr, tPrev;
@@ -495,6 +551,172 @@ void LugreState::SaveStictionState(const sp_grad::SpColVector<doublereal, 2>& z,
      zPCurr = zP;
 }
 
+std::map<const DataManager*, TriangularContactSearchTree::SharedTrees> TriangularContactSearchTree::rgShared;
+
+TriangularContactSearchTree::TriangularContactSearchTree(std::vector<Vec3>&& rgCenterTmp,
+							 std::vector<doublereal>&& rgRadiusTmp)
+     :rgCenter(std::move(rgCenterTmp)),
+      rgRadius(std::move(rgRadiusTmp)),
+      rgFaceIdx(rgCenter.size())
+{
+     ASSERT(rgCenter.size() == rgRadius.size());
+
+     for (std::size_t i = 0; i < rgFaceIdx.size(); ++i) {
+	  rgFaceIdx[i] = i;
+     }
+
+     rgTree.reserve(2 * rgFaceIdx.size() / iMaxLeafSize + 1);
+
+     Build(0, rgFaceIdx.size());
+}
+
+integer TriangularContactSearchTree::Build(const integer iFirst, const integer iLast)
+{
+     ASSERT(iLast > iFirst);
+
+     const integer iNode = rgTree.size();
+
+     rgTree.emplace_back();
+
+     const doublereal dMax = std::numeric_limits<doublereal>::max();
+     Vec3 xmin(dMax, dMax, dMax);
+     Vec3 xmax(-dMax, -dMax, -dMax);
+     Vec3 cmin(xmin), cmax(xmax);
+
+     for (integer k = iFirst; k < iLast; ++k) {
+	  const integer iFace = rgFaceIdx[k];
+
+	  for (integer i = 1; i <= 3; ++i) {
+	       const doublereal ci = rgCenter[iFace](i);
+	       xmin(i) = std::min(xmin(i), ci - rgRadius[iFace]);
+	       xmax(i) = std::max(xmax(i), ci + rgRadius[iFace]);
+	       cmin(i) = std::min(cmin(i), ci);
+	       cmax(i) = std::max(cmax(i), ci);
+	  }
+     }
+
+     integer iLeft = -1, iRight = -1;
+
+     if (iLast - iFirst > iMaxLeafSize) {
+	  // median split of the centers along the longest axis
+	  integer iAxis = 1;
+
+	  for (integer i = 2; i <= 3; ++i) {
+	       if (cmax(i) - cmin(i) > cmax(iAxis) - cmin(iAxis)) {
+		    iAxis = i;
+	       }
+	  }
+
+	  const integer iMid = (iFirst + iLast) / 2;
+
+	  std::nth_element(rgFaceIdx.begin() + iFirst,
+			   rgFaceIdx.begin() + iMid,
+			   rgFaceIdx.begin() + iLast,
+			   [this, iAxis] (integer i, integer j) {
+				return rgCenter[i](iAxis) < rgCenter[j](iAxis);
+			   });
+
+	  iLeft = Build(iFirst, iMid);
+	  iRight = Build(iMid, iLast);
+     }
+
+     TreeNode& oNode = rgTree[iNode];
+
+     oNode.xmin = xmin;
+     oNode.xmax = xmax;
+     oNode.iFirst = iFirst;
+     oNode.iLast = iLast;
+     oNode.iLeft = iLeft;
+     oNode.iRight = iRight;
+
+     return iNode;
+}
+
+void TriangularContactSearchTree::Query(const Vec3& X, const doublereal dRadius, std::vector<integer>& rgFaces) const
+{
+     std::array<integer, iMaxDepth> rgStack;
+     integer iTop = 0;
+
+     rgStack[iTop++] = 0;
+
+     while (iTop > 0) {
+	  const TreeNode& oNode = rgTree[rgStack[--iTop]];
+
+	  doublereal d2 = 0.;
+
+	  for (integer i = 1; i <= 3; ++i) {
+	       const doublereal di = std::max(0., std::max(oNode.xmin(i) - X(i), X(i) - oNode.xmax(i)));
+	       d2 += di * di;
+	  }
+
+	  if (d2 > dRadius * dRadius) {
+	       continue;
+	  }
+
+	  if (oNode.iLeft < 0) {
+	       for (integer k = oNode.iFirst; k < oNode.iLast; ++k) {
+		    const integer iFace = rgFaceIdx[k];
+
+		    if ((X - rgCenter[iFace]).Norm() <= dRadius + rgRadius[iFace]) {
+			 rgFaces.push_back(iFace);
+		    }
+	       }
+	  } else {
+	       ASSERT(iTop + 2 <= iMaxDepth);
+	       rgStack[iTop++] = oNode.iLeft;
+	       rgStack[iTop++] = oNode.iRight;
+	  }
+     }
+}
+
+std::shared_ptr<const TriangularContactSearchTree>
+TriangularContactSearchTree::Get(const DataManager* pDM, std::vector<Vec3>&& rgCenter, std::vector<doublereal>&& rgRadius)
+{
+     SharedTrees& rgTrees = rgShared[pDM];
+
+     for (auto it = rgTrees.begin(); it != rgTrees.end(); ) {
+	  std::shared_ptr<const TriangularContactSearchTree> pTree = it->lock();
+
+	  if (!pTree) {
+	       it = rgTrees.erase(it);
+	       continue;
+	  }
+
+	  if (pTree->rgRadius == rgRadius
+	      && std::equal(rgCenter.begin(), rgCenter.end(), pTree->rgCenter.begin(),
+			    [] (const Vec3& a, const Vec3& b) { return a.IsExactlySame(b); })) {
+	       return pTree;
+	  }
+
+	  ++it;
+     }
+
+     std::shared_ptr<const TriangularContactSearchTree> pTree = std::make_shared<const TriangularContactSearchTree>(std::move(rgCenter), std::move(rgRadius));
+
+     rgTrees.emplace_back(pTree);
+
+     return pTree;
+}
+
+void TriangularContactSearchTree::Release(const DataManager* pDM)
+{
+     auto itDM = rgShared.find(pDM);
+
+     if (itDM == rgShared.end()) {
+	  return;
+     }
+
+     SharedTrees& rgTrees = itDM->second;
+
+     rgTrees.erase(std::remove_if(rgTrees.begin(), rgTrees.end(),
+				  [] (const std::weak_ptr<const TriangularContactSearchTree>& p) { return p.expired(); }),
+		   rgTrees.end());
+
+     if (rgTrees.empty()) {
+	  rgShared.erase(itDM);
+     }
+}
+
 TriangularContact::TargetFace::TargetFace(const DataManager* pDM)
      :oc(::Zero3),
       r(0.),
@@ -509,7 +731,8 @@ TriangularContact::ContactNode::ContactNode(const StructNodeAd* pNode,
 					    integer iNumFaces)
      :pContNode(pNode),
       rgVertices(std::move(rgVert)),
-      dr(std::move(dr))
+      dr(std::move(dr)),
+      bCandidatesValid(false)
 {
      rgContCurr.reserve(iNumFaces);
      rgContPrev.reserve(iNumFaces);
@@ -521,6 +744,7 @@ TriangularContact::TriangularContact(unsigned uLabel, const DofOwner *pDO,
       UserDefinedElem(uLabel, pDO),
       pTargetNode(nullptr),
       dSearchRadius(std::numeric_limits<doublereal>::max()),
+      dSearchSkin(0.),
       pCL(nullptr),
       pDM(pDM),
       eFrictionModel(FrictionModel::None)
@@ -538,7 +762,8 @@ TriangularContact::TriangularContact(unsigned uLabel, const DofOwner *pDO,
 		      "triangular contact,\n"
 		      "  target node, (label) <node_id_target>,\n"
 		      "  penalty function, (DifferentiableScalarFunction) <function>,\n"
-		      "  [search radius, (real) <radius>,]\n"
+		      "  [search radius, (real) <radius>,\n"
+		      "    [search skin, (real) <skin>,]]\n"
 		      "  [friction model, {lugre | none},\n"
 		      "    [method, {implicit euler | trapezoidal rule},]\n"
 		      "    coulomb friction coefficient, (real) <mu>,\n"
@@ -610,6 +835,23 @@ TriangularContact::TriangularContact(unsigned uLabel, const DofOwner *pDO,
 	  throw ErrGeneric(MBDYN_EXCEPT_ARGS);
      }
 
+     // Candidate faces are collected with this margin,
+     // so that they can be reused for several iterations;
+     // by default, half the search radius
+     bool bSearchSkin = false;
+
+     if (HP.IsKeyWord("search" "skin")) {
+	  dSearchSkin = HP.GetReal();
+	  bSearchSkin = true;
+
+	  if (dSearchSkin < 0.) {
+	       silent_cerr("triangular contact(" << uLabel
+			   << "): invalid value for search skin at line "
+			   << HP.GetLineData() << std::endl);
+	       throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+	  }
+     }
+
      TargetFace oCurrFace(pDM);
 
      if (HP.IsKeyWord("friction" "model")) {
@@ -827,12 +1069,41 @@ TriangularContact::TriangularContact(unsigned uLabel, const DofOwner *pDO,
 	  rgContactMesh.emplace_back(pContNode, std::move(rgVertices), std::move(dr), iNumFaces);
      }
 
+     if (dSearchRadius < std::numeric_limits<doublereal>::max()) {
+	  if (rgTargetMesh.empty()) {
+	       silent_cerr("triangular contact(" << uLabel
+			   << "): the search radius requires a non empty target mesh at line "
+			   << HP.GetLineData() << std::endl);
+	       throw ErrGeneric(MBDYN_EXCEPT_ARGS);
+	  }
+
+	  if (!bSearchSkin) {
+	       dSearchSkin = 0.5 * dSearchRadius;
+	  }
+
+	  std::vector<Vec3> rgCenter;
+	  std::vector<doublereal> rgRadius;
+
+	  rgCenter.reserve(rgTargetMesh.size());
+	  rgRadius.reserve(rgTargetMesh.size());
+
+	  for (const auto& rFace: rgTargetMesh) {
+	       rgCenter.push_back(rFace.oc);
+	       rgRadius.push_back(rFace.r);
+	  }
+
+	  pSearchTree = TriangularContactSearchTree::Get(pDM, std::move(rgCenter), std::move(rgRadius));
+     }
+
      SetOutputFlag(pDM->fReadOutput(HP, Elem::LOADABLE));
 }
 
 TriangularContact::~TriangularContact(void)
 {
-
+     if (pSearchTree) {
+	  pSearchTree.reset();
+	  TriangularContactSearchTree::Release(pDM);
+     }
 }
 
 doublereal TriangularContact::GetContactForce(doublereal dz) const {
@@ -921,18 +1192,19 @@ void TriangularContact::ContactSearch()
      const Vec3& X2P = pTargetNode->GetVCurr();
      const Vec3& omega2 = pTargetNode->GetWCurr();
 
+     std::vector<Vec3> rgPos;
+     std::vector<doublereal> rgRad;
+
      for (auto& rNode: rgContactMesh) {
 	  rNode.rgContCurr.clear();
-     }
 
-     for (auto& rFace: rgTargetMesh) {
-	  for (auto& rNode: rgContactMesh) {
-	       const doublereal dr = rNode.dr->dGet();
-	       const Vec3& X1 = rNode.pContNode->GetXCurr();
-	       const Mat3x3& R1 = rNode.pContNode->GetRCurr();
-	       const Vec3& X1P = rNode.pContNode->GetVCurr();
-	       const Vec3& omega1 = rNode.pContNode->GetWCurr();
+	  const doublereal dr = rNode.dr->dGet();
+	  const Vec3& X1 = rNode.pContNode->GetXCurr();
+	  const Mat3x3& R1 = rNode.pContNode->GetRCurr();
+	  const Vec3& X1P = rNode.pContNode->GetVCurr();
+	  const Vec3& omega1 = rNode.pContNode->GetWCurr();
 
+	  auto ContactSearchFace = [&] (TargetFace& rFace) {
 	       for (std::size_t iVertex = 0; iVertex < rNode.rgVertices.size(); ++iVertex) {
 		    const Vec3& o1 = rNode.rgVertices[iVertex].o1;
 		    const doublereal r1 = rNode.rgVertices[iVertex].r1 + dr;
@@ -975,6 +1247,31 @@ void TriangularContact::ContactSearch()
 			 rNode.rgContCurr.emplace(&rFace, ContactPair{&rFace.oFrictData, iVertex, vy});
 		    }
 	       }
+	  };
+
+	  if (!pSearchTree) {
+	       for (auto& rFace: rgTargetMesh) {
+		    ContactSearchFace(rFace);
+	       }
+
+	       continue;
+	  }
+
+	  // Broad phase in the reference frame of the target node
+	  rgPos.clear();
+	  rgRad.clear();
+
+	  for (const auto& rVertex: rNode.rgVertices) {
+	       rgPos.push_back(R2.MulTV(X1 + R1 * rVertex.o1 - X2));
+	       rgRad.push_back(rVertex.r1 + dr);
+	  }
+
+	  UpdateCandidates(rNode, rgPos, rgRad);
+
+	  // Candidates are sorted, so that contact pairs are inserted
+	  // in the same order as for the exhaustive search
+	  for (integer iFace: rNode.rgCandidates) {
+	       ContactSearchFace(rgTargetMesh[iFace]);
 	  }
      }
 
@@ -1023,6 +1320,50 @@ void TriangularContact::ContactSearch()
      }
 }
 
+void TriangularContact::UpdateCandidates(ContactNode& rNode,
+					 const std::vector<Vec3>& rgPos,
+					 const std::vector<doublereal>& rgRad)
+{
+     ASSERT(pSearchTree);
+     ASSERT(rgPos.size() == rgRad.size());
+
+     if (rNode.bCandidatesValid) {
+	  ASSERT(rNode.rgSearchPos.size() == rgPos.size());
+
+	  for (std::size_t i = 0; i < rgPos.size(); ++i) {
+	       const doublereal dMove = (rgPos[i] - rNode.rgSearchPos[i]).Norm()
+		    + std::max(0., rgRad[i] - rNode.rgSearchRad[i]);
+
+	       if (!(dMove <= dSearchSkin)) {
+		    rNode.bCandidatesValid = false;
+		    break;
+	       }
+	  }
+     }
+
+     if (rNode.bCandidatesValid) {
+	  return;
+     }
+
+     rNode.rgCandidates.clear();
+
+     for (std::size_t i = 0; i < rgPos.size(); ++i) {
+	  // Allow for roundoff, since the exact test is performed in the global frame
+	  const doublereal dRadius = rgRad[i] + dSearchRadius + dSearchSkin;
+	  const doublereal dTol = std::sqrt(std::numeric_limits<doublereal>::epsilon()) * (rgPos[i].Norm() + dRadius);
+
+	  pSearchTree->Query(rgPos[i], dRadius + dTol, rNode.rgCandidates);
+     }
+
+     std::sort(rNode.rgCandidates.begin(), rNode.rgCandidates.end());
+     rNode.rgCandidates.erase(std::unique(rNode.rgCandidates.begin(), rNode.rgCandidates.end()),
+			      rNode.rgCandidates.end());
+
+     rNode.rgSearchPos = rgPos;
+     rNode.rgSearchRad = rgRad;
+     rNode.bCandidatesValid = true;
+}
+
 template <typename T>
 inline void
 TriangularContact::AssRes(sp_grad::SpGradientAssVec<T>& WorkVec,
@@ -0,0 +1,345 @@
+/* $Header$ */
+/*
+ * MBDyn (C) is a multibody analysis code.
+ * http://www.mbdyn.org
+ *
+ * Copyright (C) 1996-2023
+ *
+ * Pierangelo Masarati	<pierangelo.masarati@polimi.it>
+ * Paolo Mantegazza	<paolo.mantegazza@polimi.it>
+ *
+ * Dipartimento di Ingegneria Aerospaziale - Politecnico di Milano
+ * via La Masa, 34 - 20156 Milano, Italy
+ * http://www.aero.polimi.it
+ *
+ * Changing this copyright notice is forbidden.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation (version 2 of the License).
+ *
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * converts the textual input of the fixed step and variable step
+ * file drivers into the binary format described in "bindrv.h"
+ */
+
+#include "mbconfig.h"           /* This goes first in every *.c,*.cc file */
+
+#include <cstdlib>
+#include <cstring>
+#include <cctype>
+#include <cstdio>
+#include <climits>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <fstream>
+#include "ac/getopt.h"
+
+#include "bindrv.h"
+
+/* size of the block of records transposed in memory */
+static const size_t BLOCK_BYTES = 32*1024*1024;
+
+static void
+usage(int rc)
+{
+	std::cerr <<
+"usage: drv2bin [-hv] [-n <channels>] [-t <initial_time>] [-d <time_step>]\n"
+"               <input_file> <output_file>\n"
+"\n"
+"    -h                 print this message\n"
+"    -v                 variable step data (the first column is the time)\n"
+"    -n <channels>      number of channels (default: from the first record)\n"
+"    -t <initial_time>  initial time of fixed step data\n"
+"    -d <time_step>     time step of fixed step data\n"
+"\n"
+"    unless given on the command line, initial time and time step\n"
+"    of fixed step data are taken from the \"# initial time:\"\n"
+"    and \"# time step:\" comment lines of the input file\n"
+"\n"
+"part of MBDyn package (Copyright (C) Pierangelo Masarati, 1996)\n"
+		<< std::endl;
+	exit(rc);
+}
+
+static bool
+bIsComment(const std::string& s)
+{
+	std::string::size_type i = s.find_first_not_of(" \t\r");
+	return i == std::string::npos || s[i] == '#';
+}
+
+static bool
+bGetHeaderValue(const std::string& s, const char *sKey, double& d)
+{
+	std::string::size_type i = s.find_first_not_of("# \t");
+	if (i == std::string::npos || strncasecmp(&s[i], sKey, strlen(sKey)) != 0) {
+		return false;
+	}
+
+	return sscanf(&s[i + strlen(sKey)], "%le", &d) == 1;
+}
+
+/* parses a record; returns the number of values, or -1 on error */
+static int
+ParseRecord(const std::string& s, std::vector<double>& v, int iMaxValues)
+{
+	const char *p = s.c_str();
+	int iCnt = 0;
+
+	v.resize(0);
+	for (;;) {
+		while (isspace(*p)) {
+			p++;
+		}
+
+		if (*p == '\0') {
+			break;
+		}
+
+		if (iCnt == iMaxValues) {
+			return -1;
+		}
+
+		char *pEnd;
+		double d = strtod(p, &pEnd);
+		if (pEnd == p) {
+			return -1;
+		}
+
+		v.push_back(d);
+		iCnt++;
+		p = pEnd;
+	}
+
+	return iCnt;
+}
+
+int
+main(int argc, char *argv[])
+{
+	bool bVariableStep = false;
+	int iNumChannels = -1;
+	double dInitialTime = 0.;
+	double dTimeStep = 0.;
+	bool bInitialTime = false;
+	bool bTimeStep = false;
+
+	for (;;) {
+		int opt = getopt(argc, argv, "hvn:t:d:");
+		if (opt == EOF) {
+			break;
+		}
+
+		char *next;
+		switch (opt) {
+		case 'h':
+			usage(EXIT_SUCCESS);
+			break;
+
+		case 'v':
+			bVariableStep = true;
+			break;
+
+		case 'n':
+			iNumChannels = strtol(optarg, &next, 10);
+			if (next == optarg || *next != '\0' || iNumChannels <= 0) {
+				std::cerr << "drv2bin: invalid number of channels \"" << optarg << "\"" << std::endl;
+				usage(EXIT_FAILURE);
+			}
+			break;
+
+		case 't':
+			dInitialTime = strtod(optarg, &next);
+			if (next == optarg || *next != '\0') {
+				std::cerr << "drv2bin: invalid initial time \"" << optarg << "\"" << std::endl;
+				usage(EXIT_FAILURE);
+			}
+			bInitialTime = true;
+			break;
+
+		case 'd':
+			dTimeStep = strtod(optarg, &next);
+			if (next == optarg || *next != '\0' || !(dTimeStep > 0.)) {
+				std::cerr << "drv2bin: invalid time step \"" << optarg << "\"" << std::endl;
+				usage(EXIT_FAILURE);
+			}
+			bTimeStep = true;
+			break;
+
+		default:
+			usage(EXIT_FAILURE);
+		}
+	}
+
+	if (argc - optind != 2) {
+		usage(EXIT_FAILURE);
+	}
+
+	const char *sInName = argv[optind];
+	const char *sOutName = argv[optind + 1];
+
+	std::ifstream in(sInName);
+	if (!in) {
+		std::cerr << "drv2bin: unable to open file \"" << sInName << "\"" << std::endl;
+		exit(EXIT_FAILURE);
+	}
+
+	/* first pass: count the records and parse the header lines */
+	std::string s;
+	std::vector<double> v;
+	int iNumColumns = bVariableStep ? 1 + iNumChannels : iNumChannels;
+	uint64_t uNumSteps = 0;
+	unsigned long uLineNo = 0;
+
+	while (std::getline(in, s)) {
+		uLineNo++;
+
+		if (bIsComment(s)) {
+			double d;
+			if (!bInitialTime && bGetHeaderValue(s, "initial time:", d)) {
+				dInitialTime = d;
+				bInitialTime = true;
+
+			} else if (!bTimeStep && bGetHeaderValue(s, "time step:", d)) {
+				dTimeStep = d;
+				bTimeStep = true;
+			}
+			continue;
+		}
+
+		if (uNumSteps == 0 && iNumChannels == -1) {
+			iNumColumns = ParseRecord(s, v, INT_MAX);
+			iNumChannels = bVariableStep ? iNumColumns - 1 : iNumColumns;
+			if (iNumChannels <= 0) {
+				std::cerr << "drv2bin: unable to parse line " << uLineNo
+					<< " of file \"" << sInName << "\"" << std::endl;
+				exit(EXIT_FAILURE);
+			}
+		}
+
+		uNumSteps++;
+	}
+
+	if (uNumSteps == 0) {
+		std::cerr << "drv2bin: no records in file \"" << sInName << "\"" << std::endl;
+		exit(EXIT_FAILURE);
+	}
+
+	if (!bVariableStep && (!bInitialTime || !bTimeStep || !(dTimeStep > 0.))) {
+		std::cerr << "drv2bin: initial time and time step of file \"" << sInName << "\" "
+			"are missing or invalid; use -t and -d" << std::endl;
+		exit(EXIT_FAILURE);
+	}
+
+	BinDriveHeader Hdr;
+	memset(&Hdr, 0, sizeof(Hdr));
+	memcpy(Hdr.magic, BINDRV_MAGIC, sizeof(Hdr.magic));
+	Hdr.uVersion = BINDRV_VERSION;
+	Hdr.uFlags = bVariableStep ? BINDRV_VARIABLE_STEP : 0;
+	Hdr.uByteOrder = BINDRV_BYTE_ORDER;
+	Hdr.uNumColumns = iNumColumns;
+	Hdr.uNumSteps = uNumSteps;
+	Hdr.uDataOffset = BINDRV_ALIGN;
+	Hdr.dInitialTime = bVariableStep ? 0. : dInitialTime;
+	Hdr.dTimeStep = bVariableStep ? 0. : dTimeStep;
+
+	std::string sTmpName = std::string(sOutName) + ".tmp";
+	std::ofstream out(sTmpName.c_str(), std::ios::binary | std::ios::trunc);
+	if (!out) {
+		std::cerr << "drv2bin: unable to open file \"" << sTmpName << "\"" << std::endl;
+		exit(EXIT_FAILURE);
+	}
+
+	out.write((const char *)&Hdr, sizeof(Hdr));
+
+	/* second pass: transpose blocks of records into the columns */
+	in.clear();
+	in.seekg(0);
+	uLineNo = 0;
+
+	const uint64_t uBlockSteps = std::max(BLOCK_BYTES/sizeof(double)/iNumColumns, size_t(1));
+	std::vector<double> Block(uBlockSteps*iNumColumns);
+	std::vector<double> Col(uBlockSteps);
+	uint64_t uStep = 0;
+	uint64_t uBlockBegin = 0;
+	double dLastTime = 0.;
+
+	while (uStep < uNumSteps) {
+		if (!std::getline(in, s)) {
+			std::cerr << "drv2bin: unexpected end of file \"" << sInName << "\"" << std::endl;
+			exit(EXIT_FAILURE);
+		}
+		uLineNo++;
+
+		if (bIsComment(s)) {
+			continue;
+		}
+
+		if (ParseRecord(s, v, iNumColumns) != iNumColumns) {
+			std::cerr << "drv2bin: line " << uLineNo << " of file \"" << sInName << "\" "
+				"does not contain " << iNumColumns << " values" << std::endl;
+			exit(EXIT_FAILURE);
+		}
+
+		if (bVariableStep) {
+			if (uStep > 0 && v[0] <= dLastTime) {
+				std::cerr << "drv2bin: time=" << v[0] << " at line " << uLineNo
+					<< " of file \"" << sInName << "\" "
+					"is not greater than the previous one (" << dLastTime << ")" << std::endl;
+				exit(EXIT_FAILURE);
+			}
+			dLastTime = v[0];
+		}
+
+		std::copy(v.begin(), v.end(), Block.begin() + (uStep - uBlockBegin)*iNumColumns);
+		uStep++;
+
+		if (uStep - uBlockBegin == uBlockSteps || uStep == uNumSteps) {
+			const uint64_t uCnt = uStep - uBlockBegin;
+
+			for (int c = 0; c < iNumColumns; c++) {
+				for (uint64_t j = 0; j < uCnt; j++) {
+					Col[j] = Block[j*iNumColumns + c];
+				}
+
+				out.seekp(Hdr.uDataOffset + (c*uNumSteps + uBlockBegin)*sizeof(double));
+				out.write((const char *)&Col[0], uCnt*sizeof(double));
+			}
+
+			uBlockBegin = uStep;
+		}
+	}
+
+	out.close();
+	if (!out) {
+		std::cerr << "drv2bin: unable to write file \"" << sTmpName << "\"" << std::endl;
+		(void)remove(sTmpName.c_str());
+		exit(EXIT_FAILURE);
+	}
+
+	if (rename(sTmpName.c_str(), sOutName) != 0) {
+		std::cerr << "drv2bin: unable to rename file \"" << sTmpName << "\" "
+			"as \"" << sOutName << "\"" << std::endl;
+		(void)remove(sTmpName.c_str());
+		exit(EXIT_FAILURE);
+	}
+
+	std::cout << "drv2bin: " << uNumSteps << " records, "
+		<< iNumChannels << " channels written to \"" << sOutName << "\"" << std::endl;
+
+	return EXIT_SUCCESS;
+}